@@ -15,5 +15,6 @@
 #define DEBUG_CAL            0
 #define DEBUG_SX1302         0
 #define DEBUG_FTIME          0
+#define DEBUG_SHADOW         0
 
 #endif
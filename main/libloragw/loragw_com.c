@@ -299,7 +299,7 @@ int lgw_com_set_write_mode(lgw_com_write_mode_t write_mode) {
 
     switch (_lgw_com_type) {
         case LGW_COM_SPI:
-            /* Do nothing: only single mode is supported on SPI */
+            com_stat = lgw_spi_set_write_mode((spi_device_handle_t *)_lgw_com_target, write_mode);
             break;
         case LGW_COM_USB:
             com_stat = lgw_usb_set_write_mode(write_mode);
@@ -320,7 +320,7 @@ int lgw_com_flush(void) {
 
     switch (_lgw_com_type) {
         case LGW_COM_SPI:
-            /* Do nothing: only single mode is supported on SPI */
+            com_stat = lgw_spi_flush((spi_device_handle_t *)_lgw_com_target);
             break;
         case LGW_COM_USB:
             com_stat = lgw_usb_flush(_lgw_com_target);
@@ -336,6 +336,17 @@ int lgw_com_flush(void) {
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
+uint32_t lgw_com_get_bulk_saved(void) {
+    switch (_lgw_com_type) {
+        case LGW_COM_SPI:
+            return lgw_spi_get_bulk_saved();
+        default:
+            return 0;
+    }
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
 uint16_t lgw_com_chunk_size(void) {
     switch (_lgw_com_type) {
         case LGW_COM_SPI:
@@ -98,6 +98,11 @@ int lgw_com_set_write_mode(lgw_com_write_mode_t write_mode);
 */
 int lgw_com_flush(void);
 
+/**
+ * Number of bus transactions saved by merging writes in bulk mode (SPI only)
+*/
+uint32_t lgw_com_get_bulk_saved(void);
+
 /**
  *
 */
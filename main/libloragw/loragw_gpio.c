@@ -7,13 +7,18 @@
   (C)2019 Semtech
 
 Description:
-    Functions to reset LoRa concentrator from GPIO Pins.
+    Functions to reset LoRa concentrator from GPIO Pins, and to be notified
+    of received packets through the SX1302 RX toggle output (GPIO_4).
 
 License: Revised BSD License, see LICENSE.TXT file include in the project
 */
 
+#include "esp_attr.h"
+#include "esp_timer.h"
+
 #include "loragw_gpio.h"
 #include "loragw_aux.h"
+#include "loragw_reg.h"
 
 
 void lgw_reset(void)
@@ -33,4 +38,99 @@ void lgw_reset(void)
     wait_ms(100);
     gpio_set_level(SX1302_RESET_PIN, 0);
     wait_ms(100);
+
+    /* registers are back to their reset values */
+    lgw_reg_shadow_invalidate();
+}
+
+/* -------------------------------------------------------------------------- */
+/* --- RX INTERRUPT --------------------------------------------------------- */
+
+static TaskHandle_t rx_irq_task = NULL; /* task notified on each RX edge */
+static volatile int64_t rx_irq_time = 0; /* time of the oldest unconsumed edge, 0 if none */
+static portMUX_TYPE rx_irq_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static void IRAM_ATTR rx_irq_handler(void *arg)
+{
+    BaseType_t woken = pdFALSE;
+
+    (void)arg;
+    portENTER_CRITICAL_ISR(&rx_irq_mux);
+    if (rx_irq_time == 0) {
+        rx_irq_time = esp_timer_get_time();
+    }
+    portEXIT_CRITICAL_ISR(&rx_irq_mux);
+    vTaskNotifyGiveFromISR(rx_irq_task, &woken);
+    if (woken == pdTRUE) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+int lgw_gpio_rx_irq_start(TaskHandle_t task)
+{
+    gpio_config_t gpio_conf;
+    gpio_num_t pin = SX1302_RX_IRQ_PIN;
+    esp_err_t err;
+
+    if ((pin == GPIO_NUM_NC) || (task == NULL)) {
+        return -1;
+    }
+    if (rx_irq_task != NULL) {
+        lgw_gpio_rx_irq_stop();
+    }
+
+    gpio_conf.intr_type = GPIO_INTR_ANYEDGE; /* GPIO_4 toggles, it does not pulse */
+    gpio_conf.mode = GPIO_MODE_INPUT;
+    gpio_conf.pin_bit_mask = 1ULL << pin;
+    gpio_conf.pull_down_en = 0;
+    gpio_conf.pull_up_en = 0;
+    if (gpio_config(&gpio_conf) != ESP_OK) {
+        return -1;
+    }
+
+    err = gpio_install_isr_service(0);
+    if ((err != ESP_OK) && (err != ESP_ERR_INVALID_STATE)) { /* INVALID_STATE: already installed */
+        return -1;
+    }
+    rx_irq_task = task;
+    rx_irq_time = 0;
+    if (gpio_isr_handler_add(pin, rx_irq_handler, NULL) != ESP_OK) {
+        rx_irq_task = NULL;
+        return -1;
+    }
+
+    return 0;
+}
+
+void lgw_gpio_rx_irq_stop(void)
+{
+    if (rx_irq_task == NULL) {
+        return;
+    }
+    gpio_isr_handler_remove(SX1302_RX_IRQ_PIN);
+    gpio_set_intr_type(SX1302_RX_IRQ_PIN, GPIO_INTR_DISABLE);
+    rx_irq_task = NULL;
+    rx_irq_time = 0;
+}
+
+bool lgw_gpio_rx_irq_enabled(void)
+{
+    return (rx_irq_task != NULL);
+}
+
+bool lgw_gpio_rx_irq_wait(uint32_t timeout_ms)
+{
+    return (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout_ms)) > 0);
+}
+
+int64_t lgw_gpio_rx_irq_time(void)
+{
+    int64_t t;
+
+    portENTER_CRITICAL(&rx_irq_mux);
+    t = rx_irq_time;
+    rx_irq_time = 0;
+    portEXIT_CRITICAL(&rx_irq_mux);
+
+    return t;
 }
@@ -7,7 +7,8 @@
   (C)2019 Semtech
 
 Description:
-    Functions to reset LoRa concentrator from GPIO Pins.
+    Functions to reset LoRa concentrator from GPIO Pins, and to be notified
+    of received packets through the SX1302 RX toggle output (GPIO_4).
 
 License: Revised BSD License, see LICENSE.TXT file include in the project
 */
@@ -16,7 +17,12 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 #define _LORAGW_GPIO_H
 
 
+#include <stdint.h>     /* C99 types */
+#include <stdbool.h>    /* bool type */
+
 #include "driver/gpio.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 
 #ifndef SX1302_RESET_PIN
 #define SX1302_RESET_PIN          2
@@ -26,9 +32,29 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 #define SX1302_POWER_EN_PIN       4
 #endif
 
+/* ESP32 pin wired to SX1302 GPIO_4 (toggles on each received packet), board specific */
+#ifndef SX1302_RX_IRQ_PIN
+#define SX1302_RX_IRQ_PIN         GPIO_NUM_NC
+#endif
+
 #define SX1302_GPIO_PIN_SEL       ((1 << SX1302_RESET_PIN) | (1 << SX1302_POWER_EN_PIN))
 
 // reset the gateway using RESET and POWER_EN GPIO Pins.
 void lgw_reset(void);
 
+// enable the RX interrupt, each edge notifies the given task. Fails if SX1302_RX_IRQ_PIN is not wired.
+int lgw_gpio_rx_irq_start(TaskHandle_t task);
+
+// disable the RX interrupt.
+void lgw_gpio_rx_irq_stop(void);
+
+// true if the RX interrupt is enabled.
+bool lgw_gpio_rx_irq_enabled(void);
+
+// wait for an RX edge notification, at most timeout_ms. Returns true if an edge was notified.
+bool lgw_gpio_rx_irq_wait(uint32_t timeout_ms);
+
+// time (esp_timer, us) of the first edge not yet consumed by lgw_gpio_rx_irq_time(), 0 if none.
+int64_t lgw_gpio_rx_irq_time(void);
+
 #endif
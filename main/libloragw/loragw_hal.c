@@ -23,7 +23,7 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
     #define _XOPEN_SOURCE 500
 #endif
 
-#include <stdlib.h>     /* qsort_r */
+#include <stdlib.h>     /* abs */
 #include <stdint.h>     /* C99 types */
 #include <stdbool.h>    /* bool type */
 #include <stdio.h>      /* printf fprintf */
@@ -31,8 +31,14 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 #include <unistd.h>     /* symlink, unlink */
 #include <inttypes.h>
 
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+
 #include "loragw_reg.h"
 #include "loragw_hal.h"
+#include "loragw_hal_merge.h"
 #include "loragw_aux.h"
 #include "loragw_com.h"
 #include "loragw_i2c.h"
@@ -42,6 +48,7 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 #include "loragw_sx1261.h"
 #include "loragw_sx1302.h"
 #include "loragw_sx1302_timestamp.h"
+#include "loragw_rxpool.h"
 #include "loragw_stts751.h"
 #include "loragw_ad5338r.h"
 #include "loragw_debug.h"
@@ -78,8 +85,14 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 #define CONTEXT_TX_GAIN_LUT     lgw_context.tx_gain_lut
 #define CONTEXT_FINE_TIMESTAMP  lgw_context.ftime_cfg
 #define CONTEXT_SX1261          lgw_context.sx1261_cfg
+#define CONTEXT_TEMP            lgw_context.temp_cfg
 #define CONTEXT_DEBUG           lgw_context.debug_cfg
 
+/* fields of a packet (struct lgw_pkt_rx_s or lgw_pkt_rx_desc_s) used to find duplicates */
+#define MERGE_KEY_SET(k, pkt)   { (k).count_us = (pkt).count_us; (k).datarate = (pkt).datarate; (k).payload = (pkt).payload; \
+                                  (k).size = (pkt).size; (k).if_chain = (pkt).if_chain; (k).status = (pkt).status; \
+                                  (k).ftime_received = (pkt).ftime_received; }
+
 /* -------------------------------------------------------------------------- */
 /* --- PRIVATE CONSTANTS & TYPES -------------------------------------------- */
 
@@ -88,6 +101,20 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 #define FW_VERSION_AGC_SX125X   6  /* Expected version of AGC firmware for sx1255/sx1257 based gateway */
 #define FW_VERSION_ARB          2  /* Expected version of arbiter firmware */
 
+/* Duplicated packets generated by double demodulation (see lgw_merge_packets) */
+#define MERGE_TMST_WINDOW_US    24  /* max count_us difference between duplicates (3 samples) */
+#define MERGE_TABLE_SIZE        512 /* hash table slots, at least twice the max number of packets */
+
+typedef struct {
+    uint32_t count_us;
+    uint32_t datarate;
+    const uint8_t * payload;
+    uint16_t size;
+    uint8_t if_chain;
+    uint8_t status;
+    bool ftime_received;
+} merge_key_t;
+
 /* Useful bandwidth of SX125x radios to consider depending on channel bandwidth */
 /* Note: the below values come from lab measurements. For any question, please contact Semtech support */
 #define LGW_RF_RX_BANDWIDTH_125KHZ  1600000     /* for 125KHz channels */
@@ -187,6 +214,11 @@ static lgw_context_t lgw_context = {
             .channels = {{ 0 }}
         }
     },
+    .temp_cfg = {
+        .enable = true,
+        .period_ms = 1000,
+        .max_age_ms = 10000
+    },
     .debug_cfg = {
         .nb_ref_payload = 0,
     }
@@ -198,15 +230,45 @@ FILE * log_file = NULL;
 /* I2C temperature sensor handles */
 static uint8_t ts_addr = 0xFF;
 
+/* Background temperature sampler.
+   Samples are published in two slots: the writer fills the slot the readers
+   of temp_seq are not using, then increments temp_seq. A reader never waits
+   for the writer (which may be preempted by it), it retries whenever temp_seq
+   changed while it was copying a slot: the sample after the next one goes to
+   that same slot. temp_seq == 0 means no sample.
+   The sensor itself is read under temp_mx, by the sampler or by a reader
+   falling back to it, never by both at once. */
+#define TEMP_TASK_STACK_SIZE    2048
+#define TEMP_TASK_PRIORITY      2
+
+typedef struct {
+    float temperature;
+    int64_t time_us;
+} temp_sample_t;
+
+static TaskHandle_t volatile temp_task = NULL;
+static volatile bool temp_task_run = false;
+static temp_sample_t volatile temp_slot[2];
+static uint32_t temp_seq = 0;
+static SemaphoreHandle_t temp_mx = NULL;
+
 /* -------------------------------------------------------------------------- */
 /* --- PRIVATE FUNCTIONS DECLARATION ---------------------------------------- */
 
 int32_t lgw_sf_getval(int x);
 int32_t lgw_bw_getval(int x);
 
-static bool is_same_pkt(struct lgw_pkt_rx_s *p1, struct lgw_pkt_rx_s *p2);
-static int remove_pkt(struct lgw_pkt_rx_s * p, uint8_t * nb_pkt, uint8_t pkt_index);
-static int merge_packets(struct lgw_pkt_rx_s * p, uint8_t * nb_pkt);
+static uint32_t pkt_hash(const merge_key_t * p);
+static bool is_same_pkt(const merge_key_t *p1, const merge_key_t *p2);
+static bool is_better_pkt(const merge_key_t * dup, const merge_key_t * kept);
+static int merge_select(const merge_key_t * key, uint8_t cpt, uint8_t * out);
+static int merge_compact(void * array, size_t elem_size, uint8_t cpt, const uint8_t * out, int nb_out);
+
+static int temp_read(float * temperature);
+static void temp_publish(float temperature, int64_t time_us);
+static void temp_sampler(void * arg);
+static int temp_sampler_start(void);
+static void temp_sampler_stop(void);
 
 /* -------------------------------------------------------------------------- */
 /* --- PRIVATE FUNCTIONS DEFINITION ----------------------------------------- */
@@ -238,81 +300,172 @@ int32_t lgw_sf_getval(int x) {
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
-static bool is_same_pkt(struct lgw_pkt_rx_s *p1, struct lgw_pkt_rx_s *p2) {
-    if ((p1 != NULL) && (p2 != NULL)) {
-        /* Criterias to determine if packets are identical:
-            -- count_us should be equal or can have up to 24µs of difference (3 samples)
-            -- channel should be same
-            -- datarate should be same
-            -- payload should be same
-        */
-        if ((abs(p1->count_us - p2->count_us) <= 24) &&
-            (p1->if_chain == p2->if_chain) &&
-            (p1->datarate == p2->datarate) &&
-            (p1->size == p2->size) &&
-            (memcmp(p1->payload, p2->payload, p1->size) == 0)) {
+/* Hash of the fields two duplicated packets have in common. Only the first and last 4 payload bytes
+   are taken: the last ones are the MIC of LoRaWAN frames. is_same_pkt() compares the whole payload. */
+static uint32_t pkt_hash(const merge_key_t * p) {
+    uint32_t h = 2166136261u;
+    uint16_t i;
 
-            return true;
-        }
+    h = (h ^ p->if_chain) * 16777619u;
+    h = (h ^ (uint8_t)p->datarate) * 16777619u;
+    h = (h ^ (uint8_t)p->size) * 16777619u;
+    for (i = 0; (i < 4) && (i < p->size); i++) {
+        h = (h ^ p->payload[i]) * 16777619u;
+        h = (h ^ p->payload[p->size - 1 - i]) * 16777619u;
     }
 
-    return false;
+    return h;
 }
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
-static int remove_pkt(struct lgw_pkt_rx_s * p, uint8_t * nb_pkt, uint8_t pkt_index) {
-    /* Check input parameters */
-    CHECK_NULL(p);
-    CHECK_NULL(nb_pkt);
-    if (pkt_index > ((*nb_pkt) - 1)) {
-        printf("ERROR: failed to remove packet index %u\n", pkt_index);
-        return -1;
+static bool is_same_pkt(const merge_key_t *p1, const merge_key_t *p2) {
+    /* Criterias to determine if packets are identical:
+        -- count_us should be equal or can have up to 24µs of difference (3 samples)
+        -- channel should be same
+        -- datarate should be same
+        -- payload should be same
+    */
+    return ((abs((int32_t)(p1->count_us - p2->count_us)) <= MERGE_TMST_WINDOW_US) &&
+            (p1->if_chain == p2->if_chain) &&
+            (p1->datarate == p2->datarate) &&
+            (p1->size == p2->size) &&
+            (memcmp(p1->payload, p2->payload, p1->size) == 0));
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+/* true if dup should be kept instead of kept, its duplicate received before it (at the same
+   count_us, earlier in the RX buffer): as the former pairwise search did, the CRC checked one
+   is kept, then the first one if it has a fine timestamp, the second one otherwise */
+static bool is_better_pkt(const merge_key_t * dup, const merge_key_t * kept) {
+    /* We keep the packet which has CRC checked */
+    if ((kept->status == STAT_CRC_OK) && (dup->status == STAT_CRC_BAD)) {
+        return false;
+    } else if ((kept->status == STAT_CRC_BAD) && (dup->status == STAT_CRC_OK)) {
+        return true;
     }
 
-    /* Remove pkt from array, by replacing it with last packet of array */
-    if (pkt_index == ((*nb_pkt) - 1)) {
-        /* If we remove last element, just decrement nb packet counter */
-        /* Do nothing */
-    } else {
-        /* Copy last packet onto the packet to be removed */
-        memcpy(p + pkt_index, p + (*nb_pkt) - 1, sizeof(struct lgw_pkt_rx_s));
+    /* we keep the packet which has a fine timestamp */
+    if (kept->ftime_received == dup->ftime_received) {
+        DEBUG_MSG("WARNING: both duplicates have fine timestamps, or none has ? TBC\n");
     }
+    return (kept->ftime_received == false);
+}
 
-    *nb_pkt -= 1;
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
-    return 0;
+/* Select the packets to keep: out[] gets their indexes by ascending count_us, 0xFF for dropped entries.
+   Packets with the same count_us keep their RX buffer order (the former qsort() left it unspecified). */
+static int merge_select(const merge_key_t * key, uint8_t cpt, uint8_t * out) {
+    int i, j, k, m = 0;
+    uint8_t order[256];         /* packet indexes, by ascending count_us */
+    uint32_t hash[256];         /* hash of each packet */
+    uint8_t table[MERGE_TABLE_SIZE]; /* hash table: 1 + position in out[] of the latest packet kept per key */
+    uint16_t mask;
+    int nb_out;
+
+    /* Sort packet indexes by ascending count_us, across counter wrap (insertion sort: the RX buffer is almost in order) */
+    for (i = 0; i < cpt; i++) {
+        for (j = i; (j > 0) && ((int32_t)(key[order[j - 1]].count_us - key[i].count_us) > 0); j--) {
+            order[j] = order[j - 1];
+        }
+        order[j] = i;
+        hash[i] = pkt_hash(&key[i]);
+    }
+
+    /* Single pass: duplicates are within MERGE_TMST_WINDOW_US, so a packet can only duplicate
+       the latest packet kept with the same (channel, datarate, payload) key */
+    for (mask = 16; mask < (2 * cpt); mask <<= 1);
+    mask -= 1;
+    memset(table, 0, (mask + 1) * sizeof table[0]);
+    nb_out = 0;
+    for (i = 0; i < cpt; i++) {
+        k = order[i];
+        for (j = hash[k] & mask; table[j] != 0; j = (j + 1) & mask) {
+            m = out[table[j] - 1];
+            if ((hash[m] == hash[k]) && (key[m].if_chain == key[k].if_chain) && (key[m].datarate == key[k].datarate) && (key[m].size == key[k].size)) {
+                break; /* same key, m is the latest packet kept for it */
+            }
+        }
+        if ((table[j] != 0) && is_same_pkt(&key[m], &key[k])) {
+            DEBUG_PRINTF("duplicate found %d:%d\n", m, k);
+            if (is_better_pkt(&key[k], &key[m]) == false) {
+                continue; /* drop k */
+            }
+            out[table[j] - 1] = 0xFF; /* drop m, k goes at the end to keep the order */
+        }
+        out[nb_out] = k;
+        nb_out += 1;
+        table[j] = nb_out;
+    }
+
+    return nb_out;
 }
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
-int compare_pkt_tmst(const void *a, const void *b, void *arg)
-{
-    struct lgw_pkt_rx_s *p = (struct lgw_pkt_rx_s *)a;
-    struct lgw_pkt_rx_s *q = (struct lgw_pkt_rx_s *)b;
-    int *counter = (int *)arg;
-    int p_count, q_count;
-
-    p_count = p->count_us;
-    q_count = q->count_us;
+/* Move the packets selected by merge_select() to the front of the array, in order, and return their number */
+static int merge_compact(void * array, size_t elem_size, uint8_t cpt, const uint8_t * out, int nb_out) {
+    uint8_t * p = (uint8_t *)array;
+    int i, j, k;
+    uint8_t at[256], loc[256];  /* packet at each position / position of each packet, while moving them */
+    uint8_t tmp[sizeof(struct lgw_pkt_rx_s)];
 
-    if (p_count > q_count) {
-        *counter = *counter + 1;
+    for (j = 0, k = -1; j < nb_out; j++) {
+        if (out[j] != 0xFF) {
+            if (out[j] < k) {
+                break;
+            }
+            k = out[j];
+        }
+    }
+    i = 0;
+    if (j == nb_out) {
+        /* already in order (the usual case): each packet is copied at most once */
+        for (j = 0; j < nb_out; j++) {
+            if (out[j] == 0xFF) {
+                continue;
+            }
+            if (out[j] != i) {
+                memcpy(p + i * elem_size, p + out[j] * elem_size, elem_size);
+            }
+            i += 1;
+        }
+    } else {
+        for (k = 0; k < cpt; k++) {
+            at[k] = k;
+            loc[k] = k;
+        }
+        for (j = 0; j < nb_out; j++) {
+            if (out[j] == 0xFF) {
+                continue;
+            }
+            k = loc[out[j]];
+            if (k != i) {
+                memcpy(tmp, p + i * elem_size, elem_size);
+                memcpy(p + i * elem_size, p + k * elem_size, elem_size);
+                memcpy(p + k * elem_size, tmp, elem_size);
+                loc[at[i]] = k;
+                at[k] = at[i];
+                at[i] = out[j];
+                loc[out[j]] = i;
+            }
+            i += 1;
+        }
     }
 
-    return (p_count - q_count);
+    return i;
 }
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
-static int merge_packets(struct lgw_pkt_rx_s * p, uint8_t * nb_pkt) {
+int lgw_merge_packets(struct lgw_pkt_rx_s * p, uint8_t * nb_pkt) {
     uint8_t cpt;
-    int j, k, pkt_dup_idx, x;
-#if DEBUG_HAL == 1
-    int pkt_idx;
-#endif
-    bool dup_restart = false;
-    int counter_qsort_swap = 0;
+    int j;
+    merge_key_t key[256];
+    uint8_t out[256];           /* packets kept, by ascending count_us */
+    int nb_out;
 
     /* Check input parameters */
     CHECK_NULL(p);
@@ -320,12 +473,13 @@ static int merge_packets(struct lgw_pkt_rx_s * p, uint8_t * nb_pkt) {
 
     /* Init number of packets in array before merge */
     cpt = *nb_pkt;
+    if (cpt < 2) {
+        return 0;
+    }
 
     /* --------------------------------------------- */
     /* ---------- For Debug only - START ----------- */
-    if (cpt > 0) {
-        DEBUG_MSG("<----- Searching for DUPLICATEs ------\n");
-    }
+    DEBUG_MSG("<----- Searching for DUPLICATEs ------\n");
     for (j = 0; j < cpt; j++) {
         DEBUG_PRINTF("  %d: tmst=%u SF=%u CRC_status=%d freq=%u chan=%u", j, p[j].count_us, p[j].datarate, p[j].status, p[j].freq_hz, p[j].if_chain);
         if (p[j].ftime_received == true) {
@@ -337,83 +491,15 @@ static int merge_packets(struct lgw_pkt_rx_s * p, uint8_t * nb_pkt) {
     /* ---------- For Debug only - END ------------- */
     /* --------------------------------------------- */
 
-    /* Remove duplicates */
-    j = 0;
-    while (j < cpt) {
-        for (k = (j+1); k < cpt; k++) {
-            /* Searching for duplicated packets:
-                -- count_us should be equal or can have up to 24µs of difference (3 samples)
-                -- channel should be same
-                -- datarate should be same
-                -- payload should be same
-            */
-            if (is_same_pkt( &p[j], &p[k])) {
-                /* We keep the packet which has CRC checked */
-                if ((p[j].status == STAT_CRC_OK) && (p[k].status == STAT_CRC_BAD)) {
-                    pkt_dup_idx = k;
-#if DEBUG_HAL == 1
-                    pkt_idx = j;
-#endif
-                } else if ((p[j].status == STAT_CRC_BAD) && (p[k].status == STAT_CRC_OK)) {
-                    pkt_dup_idx = j;
-#if DEBUG_HAL == 1
-                    pkt_idx = k;
-#endif
-                } else {
-                    /* we keep the packet which has a fine timestamp */
-                    if (p[j].ftime_received == true) {
-                        pkt_dup_idx = k;
-#if DEBUG_HAL == 1
-                        pkt_idx = j;
-#endif
-                    } else {
-                        pkt_dup_idx = j;
-#if DEBUG_HAL == 1
-                        pkt_idx = k;
-#endif
-                    }
-                    /* sanity check */
-                    if (((p[j].ftime_received == true) && (p[k].ftime_received == true)) ||
-                        ((p[j].ftime_received == false) && (p[k].ftime_received == false))) {
-                        DEBUG_MSG("WARNING: both duplicates have fine timestamps, or none has ? TBC\n");
-                    }
-                }
-                /* pkt_dup_idx contains the index to be deleted */
-                DEBUG_PRINTF("duplicate found %d:%d, deleting %d\n", pkt_idx, pkt_dup_idx, pkt_dup_idx);
-                /* Remove duplicated packet from packet array */
-                x = remove_pkt(p, &cpt, pkt_dup_idx);
-                if (x != 0) {
-                    printf("ERROR: failed to remove packet from array (%d)\n", x);
-                }
-                dup_restart = true;
-                break;
-            }
-        }
-        if (dup_restart == true) {
-            /* Duplicate found, restart searching for duplicate from first element */
-            j = 0;
-            dup_restart = false;
-#if 0
-            printf( "restarting search for duplicate\n" ); /* Too verbose */
-#endif
-        } else {
-            /* No duplicate found, continue... */
-            j += 1;
-#if 0
-            printf( "no duplicate found\n" ); /* Too verbose */
-#endif
-        }
+    for (j = 0; j < cpt; j++) {
+        MERGE_KEY_SET(key[j], p[j]);
     }
-
-    /* Sort the packet array by ascending counter_us value */
-    qsort_r(p, cpt, sizeof(p[0]), compare_pkt_tmst, &counter_qsort_swap);
-    DEBUG_PRINTF("%d elements swapped during sorting...\n", counter_qsort_swap);
+    nb_out = merge_select(key, cpt, out);
+    cpt = merge_compact(p, sizeof p[0], cpt, out, nb_out);
 
     /* --------------------------------------------- */
     /* ---------- For Debug only - START ----------- */
-    if (cpt > 0) {
-        DEBUG_MSG("--\n");
-    }
+    DEBUG_MSG("--\n");
     for (j = 0; j < cpt; j++) {
         DEBUG_PRINTF("  %d: tmst=%u SF=%d CRC_status=%d freq=%u chan=%u", j, p[j].count_us, p[j].datarate, p[j].status, p[j].freq_hz, p[j].if_chain);
         if (p[j].ftime_received == true) {
@@ -422,9 +508,7 @@ static int merge_packets(struct lgw_pkt_rx_s * p, uint8_t * nb_pkt) {
             DEBUG_MSG   (" ftime=NONE\n");
         }
     }
-    if (cpt > 0) {
-        DEBUG_MSG( " ------------------------------------>\n\n" );
-    }
+    DEBUG_MSG( " ------------------------------------>\n\n" );
     /* ---------- For Debug only - END ------------- */
     /* --------------------------------------------- */
 
@@ -434,6 +518,146 @@ static int merge_packets(struct lgw_pkt_rx_s * p, uint8_t * nb_pkt) {
     return 0;
 }
 
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+int lgw_merge_packets_desc(struct lgw_pkt_rx_desc_s * p, uint8_t * nb_pkt) {
+    uint8_t cpt;
+    int j;
+    merge_key_t key[256];
+    uint8_t out[256];           /* packets kept, by ascending count_us */
+    bool kept[256];
+    int nb_out;
+
+    /* Check input parameters */
+    CHECK_NULL(p);
+    CHECK_NULL(nb_pkt);
+
+    cpt = *nb_pkt;
+    if (cpt < 2) {
+        return 0;
+    }
+
+    for (j = 0; j < cpt; j++) {
+        MERGE_KEY_SET(key[j], p[j]);
+        kept[j] = false;
+    }
+    nb_out = merge_select(key, cpt, out);
+
+    /* release the payloads of the duplicates dropped */
+    for (j = 0; j < nb_out; j++) {
+        if (out[j] != 0xFF) {
+            kept[out[j]] = true;
+        }
+    }
+    for (j = 0; j < cpt; j++) {
+        if (kept[j] == false) {
+            lgw_rx_desc_release(&p[j]);
+        }
+    }
+    *nb_pkt = merge_compact(p, sizeof p[0], cpt, out, nb_out);
+
+    return 0;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+static int temp_read(float * temperature) {
+    int err;
+
+    /* no lock before the sampler is first started, nobody else reads the sensor then */
+    if (temp_mx != NULL) {
+        xSemaphoreTake(temp_mx, portMAX_DELAY);
+    }
+    err = stts751_get_temperature(ts_addr, temperature);
+    if (temp_mx != NULL) {
+        xSemaphoreGive(temp_mx);
+    }
+
+    return err;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+static void temp_publish(float temperature, int64_t time_us) {
+    uint32_t seq = __atomic_load_n(&temp_seq, __ATOMIC_RELAXED);
+
+    /* single writer: fill the slot readers are not using, then switch to it. It is the slot of
+       seq - 1: the fence orders the store of seq before the slot writes, for its readers to retry */
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    temp_slot[(seq + 1) & 1].temperature = temperature;
+    temp_slot[(seq + 1) & 1].time_us = time_us;
+    __atomic_store_n(&temp_seq, seq + 1, __ATOMIC_RELEASE);
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+static void temp_sampler(void * arg) {
+    float temperature;
+
+    (void)arg;
+
+    while (temp_task_run == true) {
+        if (temp_read(&temperature) == LGW_I2C_SUCCESS) {
+            temp_publish(temperature, esp_timer_get_time());
+        }
+        /* woken up early by temp_sampler_stop() */
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(CONTEXT_TEMP.period_ms));
+    }
+
+    temp_task = NULL;
+    vTaskDelete(NULL);
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+static int temp_sampler_start(void) {
+    float temperature;
+    TaskHandle_t task;
+
+    if (temp_task != NULL) {
+        return LGW_HAL_SUCCESS;
+    }
+    if (temp_mx == NULL) {
+        temp_mx = xSemaphoreCreateMutex();
+        if (temp_mx == NULL) {
+            return LGW_HAL_ERROR;
+        }
+    }
+
+    /* first sample before returning, so that the first packets are compensated with it */
+    __atomic_store_n(&temp_seq, 0, __ATOMIC_RELAXED);
+    if (temp_read(&temperature) == LGW_I2C_SUCCESS) {
+        temp_publish(temperature, esp_timer_get_time());
+    }
+
+    temp_task_run = true;
+    if (xTaskCreate(temp_sampler, "temp_sampler", TEMP_TASK_STACK_SIZE, NULL, TEMP_TASK_PRIORITY, &task) != pdPASS) {
+        temp_task_run = false;
+        __atomic_store_n(&temp_seq, 0, __ATOMIC_RELAXED);
+        return LGW_HAL_ERROR;
+    }
+    temp_task = task;
+
+    return LGW_HAL_SUCCESS;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+static void temp_sampler_stop(void) {
+    TaskHandle_t task = temp_task;
+
+    if (task == NULL) {
+        return;
+    }
+
+    temp_task_run = false;
+    xTaskNotifyGive(task);
+    while (temp_task != NULL) {
+        vTaskDelay(1); /* wait for an I2C read in progress */
+    }
+    __atomic_store_n(&temp_seq, 0, __ATOMIC_RELEASE);
+}
+
 /* -------------------------------------------------------------------------- */
 /* --- PUBLIC FUNCTIONS DEFINITION ------------------------------------------ */
 
@@ -774,6 +998,29 @@ int lgw_ftime_setconf(struct lgw_conf_ftime_s * conf) {
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
+int lgw_temp_setconf(struct lgw_conf_temp_s * conf) {
+    CHECK_NULL(conf);
+
+    /* check if the concentrator is running */
+    if (CONTEXT_STARTED == true) {
+        printf("ERROR: CONCENTRATOR IS RUNNING, STOP IT BEFORE TOUCHING CONFIGURATION\n");
+        return LGW_HAL_ERROR;
+    }
+
+    if ((conf->enable == true) && (conf->period_ms == 0)) {
+        printf("ERROR: temperature sampling period must be greater than 0\n");
+        return LGW_HAL_ERROR;
+    }
+
+    CONTEXT_TEMP.enable = conf->enable;
+    CONTEXT_TEMP.period_ms = conf->period_ms;
+    CONTEXT_TEMP.max_age_ms = conf->max_age_ms;
+
+    return LGW_HAL_SUCCESS;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
 int lgw_sx1261_setconf(struct lgw_conf_sx1261_s * conf) {
     int i;
 
@@ -931,23 +1178,26 @@ int lgw_start(void) {
         return LGW_HAL_ERROR;
     }
 
+    /* Modems configuration is write-only: record it and send it in a few bursts */
+    lgw_com_set_write_mode(LGW_COM_WRITE_MODE_BULK);
+
     /* Configure the Channelizer */
     err = sx1302_channelizer_configure(CONTEXT_IF_CHAIN, false);
     if (err != LGW_REG_SUCCESS) {
         printf("ERROR: failed to configure SX1302 channelizer\n");
-        return LGW_HAL_ERROR;
+        goto fail_bulk;
     }
 
     /* configure LoRa 'multi-sf' modems */
     err = sx1302_lora_correlator_configure(CONTEXT_IF_CHAIN, &(CONTEXT_DEMOD));
     if (err != LGW_REG_SUCCESS) {
         printf("ERROR: failed to configure SX1302 LoRa modem correlators\n");
-        return LGW_HAL_ERROR;
+        goto fail_bulk;
     }
     err = sx1302_lora_modem_configure(CONTEXT_RF_CHAIN[0].freq_hz);
     if (err != LGW_REG_SUCCESS) {
         printf("ERROR: failed to configure SX1302 LoRa modems\n");
-        return LGW_HAL_ERROR;
+        goto fail_bulk;
     }
 
     /* configure LoRa 'single-sf' modem */
@@ -955,12 +1205,12 @@ int lgw_start(void) {
         err = sx1302_lora_service_correlator_configure(&(CONTEXT_LORA_SERVICE));
         if (err != LGW_REG_SUCCESS) {
             printf("ERROR: failed to configure SX1302 LoRa Service modem correlators\n");
-            return LGW_HAL_ERROR;
+            goto fail_bulk;
         }
         err = sx1302_lora_service_modem_configure(&(CONTEXT_LORA_SERVICE), CONTEXT_RF_CHAIN[0].freq_hz);
         if (err != LGW_REG_SUCCESS) {
             printf("ERROR: failed to configure SX1302 LoRa Service modem\n");
-            return LGW_HAL_ERROR;
+            goto fail_bulk;
         }
     }
 
@@ -969,7 +1219,7 @@ int lgw_start(void) {
         err = sx1302_fsk_configure(&(CONTEXT_FSK));
         if (err != LGW_REG_SUCCESS) {
             printf("ERROR: failed to configure SX1302 FSK modem\n");
-            return LGW_HAL_ERROR;
+            goto fail_bulk;
         }
     }
 
@@ -977,15 +1227,22 @@ int lgw_start(void) {
     err = sx1302_lora_syncword(CONTEXT_LWAN_PUBLIC, CONTEXT_LORA_SERVICE.datarate);
     if (err != LGW_REG_SUCCESS) {
         printf("ERROR: failed to configure SX1302 LoRa syncword\n");
-        return LGW_HAL_ERROR;
+        goto fail_bulk;
     }
 
     /* enable demodulators - to be done before starting AGC/ARB */
     err = sx1302_modem_enable();
     if (err != LGW_REG_SUCCESS) {
         printf("ERROR: failed to enable SX1302 modems\n");
+        goto fail_bulk;
+    }
+
+    err = lgw_com_flush();
+    if (err != LGW_COM_SUCCESS) {
+        printf("ERROR: failed to write SX1302 modems configuration\n");
         return LGW_HAL_ERROR;
     }
+    DEBUG_PRINTF("Note: %u SPI transactions saved by bulk writes\n", lgw_com_get_bulk_saved());
 
     /* Load AGC firmware */
     switch (CONTEXT_RF_CHAIN[CONTEXT_BOARD.clksrc].type) {
@@ -1069,6 +1326,11 @@ int lgw_start(void) {
         if (i == sizeof I2C_PORT_TEMP_SENSOR) {
             printf("WARNING: no temperature sensor found.\n");
             //return LGW_HAL_ERROR;
+        } else if (CONTEXT_TEMP.enable == true) {
+            /* I2C is not shared with the concentrator SPI, sample in the background */
+            if (temp_sampler_start() != LGW_HAL_SUCCESS) {
+                printf("WARNING: failed to start temperature sampler, reading the sensor on demand\n");
+            }
         }
 
         /* Configure ADC AD338R for full duplex (CN490 reference design) */
@@ -1130,6 +1392,11 @@ int lgw_start(void) {
     DEBUG_PRINTF(" --- %s\n", "OUT");
 
     return LGW_HAL_SUCCESS;
+
+fail_bulk:
+    /* do not leave the com layer in bulk mode, with writes pending */
+    lgw_com_flush();
+    return LGW_HAL_ERROR;
 }
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
@@ -1160,6 +1427,9 @@ int lgw_stop(void) {
         log_file = NULL;
     }
 
+    /* Stop the temperature sampler before closing I2C */
+    temp_sampler_stop();
+
     DEBUG_MSG("INFO: Disconnecting\n");
     x = lgw_disconnect();
     if (x != LGW_HAL_SUCCESS) {
@@ -1190,6 +1460,7 @@ int lgw_receive(uint8_t max_pkt, struct lgw_pkt_rx_s *pkt_data) {
     uint8_t nb_pkt_found = 0;
     uint8_t nb_pkt_left = 0;
     float current_temperature = 0.0, rssi_temperature_offset = 0.0;
+    uint32_t temperature_age_ms = 0;
     /* performances variables */
     struct timeval tm;
 
@@ -1222,10 +1493,13 @@ int lgw_receive(uint8_t max_pkt, struct lgw_pkt_rx_s *pkt_data) {
         printf("WARNING: not enough space allocated, fetched %d packet(s), %d will be left in RX buffer\n", nb_pkt_fetched, nb_pkt_left);
     }
 
-    /* Apply RSSI temperature compensation */
-    res = lgw_get_temperature(&current_temperature);
-    if (res != LGW_I2C_SUCCESS) {
-        printf("ERROR: failed to get current temperature\n");
+    /* Apply RSSI temperature compensation, with the sampled temperature unless it is too old */
+    res = lgw_get_temperature_cached(&current_temperature, &temperature_age_ms);
+    if ((res != LGW_HAL_SUCCESS) || (temperature_age_ms > CONTEXT_TEMP.max_age_ms)) {
+        res = lgw_get_temperature(&current_temperature);
+        if (res != LGW_I2C_SUCCESS) {
+            printf("ERROR: failed to get current temperature\n");
+        }
     }
 
     /* Iterate on the RX buffer to get parsed packets */
@@ -1233,8 +1507,9 @@ int lgw_receive(uint8_t max_pkt, struct lgw_pkt_rx_s *pkt_data) {
         /* Get packet and move to next one */
         res = sx1302_parse(&lgw_context, &pkt_data[nb_pkt_found]);
         if (res == LGW_REG_WARNING) {
-            printf("WARNING: parsing error on packet %d, discarding fetched packets\n", nb_pkt_found);
-            return LGW_HAL_SUCCESS;
+            /* the corrupted packet was dropped, the next ones are counted again and left for the next call */
+            printf("WARNING: parsing error on packet %d, packet discarded\n", nb_pkt_found);
+            break;
         } else if (res == LGW_REG_ERROR) {
             printf("ERROR: fatal parsing error on packet %d, aborting...\n", nb_pkt_found);
             return LGW_HAL_ERROR;
@@ -1254,7 +1529,7 @@ int lgw_receive(uint8_t max_pkt, struct lgw_pkt_rx_s *pkt_data) {
 
     /* Remove duplicated packets generated by double demod when precision timestamp is enabled */
     if ((nb_pkt_found > 0) && (CONTEXT_FINE_TIMESTAMP.enable == true)) {
-        res = merge_packets(pkt_data, &nb_pkt_found);
+        res = lgw_merge_packets(pkt_data, &nb_pkt_found);
         if (res != 0) {
             printf("WARNING: failed to remove duplicated packets\n");
         }
@@ -1271,6 +1546,111 @@ int lgw_receive(uint8_t max_pkt, struct lgw_pkt_rx_s *pkt_data) {
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
+int lgw_receive_desc(uint8_t max_pkt, struct lgw_pkt_rx_desc_s *pkt_desc) {
+    int res;
+    uint8_t nb_pkt_fetched = 0;
+    uint8_t nb_pkt_found = 0;
+    float current_temperature = 0.0, rssi_temperature_offset = 0.0;
+    uint32_t temperature_age_ms = 0;
+    struct lgw_pkt_rx_desc_s *p;
+    /* performances variables */
+    struct timeval tm;
+
+    DEBUG_PRINTF(" --- %s\n", "IN");
+
+    CHECK_NULL(pkt_desc);
+
+    /* Record function start time */
+    _meas_time_start(&tm);
+
+    /* Get packets from SX1302, if any */
+    res = sx1302_fetch(&nb_pkt_fetched);
+    if (res != LGW_REG_SUCCESS) {
+        printf("ERROR: failed to fetch packets from SX1302\n");
+        return LGW_HAL_ERROR;
+    }
+
+    /* Update internal counter */
+    /* WARNING: this needs to be called regularly by the upper layer */
+    res = sx1302_update();
+    if (res != LGW_REG_SUCCESS) {
+        return LGW_HAL_ERROR;
+    }
+
+    /* Exit now if no packet fetched */
+    if (nb_pkt_fetched == 0) {
+        _meas_time_stop(1, tm, __FUNCTION__);
+        return 0;
+    }
+
+    /* Apply RSSI temperature compensation, with the sampled temperature unless it is too old */
+    res = lgw_get_temperature_cached(&current_temperature, &temperature_age_ms);
+    if ((res != LGW_HAL_SUCCESS) || (temperature_age_ms > CONTEXT_TEMP.max_age_ms)) {
+        res = lgw_get_temperature(&current_temperature);
+        if (res != LGW_I2C_SUCCESS) {
+            printf("ERROR: failed to get current temperature\n");
+        }
+    }
+
+    /* Iterate on the RX buffer to get parsed packets, the ones left stay in the RX buffer */
+    for (nb_pkt_found = 0; nb_pkt_found < ((nb_pkt_fetched <= max_pkt) ? nb_pkt_fetched : max_pkt); nb_pkt_found++) {
+        p = &pkt_desc[nb_pkt_found];
+        res = sx1302_parse_desc(&lgw_context, p);
+        if (res == LGW_REG_WARNING) {
+            /* corrupted packet dropped, or payload pool full: the next packets are left for the next call */
+            break;
+        } else if (res == LGW_REG_ERROR) {
+            printf("ERROR: fatal parsing error on packet %d, aborting...\n", nb_pkt_found);
+            while (nb_pkt_found > 0) {
+                nb_pkt_found -= 1;
+                lgw_rx_desc_release(&pkt_desc[nb_pkt_found]);
+            }
+            return LGW_HAL_ERROR;
+        }
+
+        /* Appli RSSI offset calibrated for the board */
+        p->rssic += CONTEXT_RF_CHAIN[p->rf_chain].rssi_offset;
+        p->rssis += CONTEXT_RF_CHAIN[p->rf_chain].rssi_offset;
+
+        rssi_temperature_offset = sx1302_rssi_get_temperature_offset(&CONTEXT_RF_CHAIN[p->rf_chain].rssi_tcomp, current_temperature);
+        p->rssic += rssi_temperature_offset;
+        p->rssis += rssi_temperature_offset;
+    }
+
+    /* Remove duplicated packets generated by double demod when precision timestamp is enabled */
+    if ((nb_pkt_found > 0) && (CONTEXT_FINE_TIMESTAMP.enable == true)) {
+        res = lgw_merge_packets_desc(pkt_desc, &nb_pkt_found);
+        if (res != 0) {
+            printf("WARNING: failed to remove duplicated packets\n");
+        }
+    }
+
+    _meas_time_stop(1, tm, __FUNCTION__);
+
+    DEBUG_PRINTF(" --- %s\n", "OUT");
+
+    return nb_pkt_found;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+void lgw_rx_desc_ref(const struct lgw_pkt_rx_desc_s * pkt_desc) {
+    if (pkt_desc != NULL) {
+        rxpool_ref(pkt_desc->payload);
+    }
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+void lgw_rx_desc_release(struct lgw_pkt_rx_desc_s * pkt_desc) {
+    if (pkt_desc != NULL) {
+        rxpool_unref(pkt_desc->payload);
+        pkt_desc->payload = NULL;
+    }
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
 int lgw_send(struct lgw_pkt_tx_s * pkt_data) {
     int err;
     bool lbt_tx_allowed;
@@ -1523,6 +1903,16 @@ int lgw_get_eui(uint64_t* eui) {
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
+int lgw_get_rx_resync_bytes(uint32_t * nb_bytes) {
+    CHECK_NULL(nb_bytes);
+
+    *nb_bytes = sx1302_rx_resync_bytes();
+
+    return LGW_HAL_SUCCESS;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
 int lgw_get_temperature(float* temperature) {
     int err = LGW_HAL_ERROR;
 
@@ -1532,7 +1922,7 @@ int lgw_get_temperature(float* temperature) {
 
     switch (CONTEXT_COM_TYPE) {
         case LGW_COM_SPI:
-            err = stts751_get_temperature(ts_addr, temperature);
+            err = temp_read(temperature); /* the sampler may be reading it */
             break;
         case LGW_COM_USB:
             err = lgw_com_get_temperature(temperature);
@@ -1549,6 +1939,34 @@ int lgw_get_temperature(float* temperature) {
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
+int lgw_get_temperature_cached(float * temperature, uint32_t * age_ms) {
+    uint32_t seq;
+    temp_sample_t sample;
+    int64_t age_us;
+
+    CHECK_NULL(temperature);
+
+    do {
+        seq = __atomic_load_n(&temp_seq, __ATOMIC_ACQUIRE);
+        if (seq == 0) {
+            return LGW_HAL_ERROR;
+        }
+        sample.temperature = temp_slot[seq & 1].temperature;
+        sample.time_us = temp_slot[seq & 1].time_us;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while (__atomic_load_n(&temp_seq, __ATOMIC_RELAXED) != seq); /* slot may have been overwritten while copying it */
+
+    *temperature = sample.temperature;
+    if (age_ms != NULL) {
+        age_us = esp_timer_get_time() - sample.time_us;
+        *age_ms = (age_us < (int64_t)UINT32_MAX * 1000) ? (uint32_t)(age_us / 1000) : UINT32_MAX;
+    }
+
+    return LGW_HAL_SUCCESS;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
 const char* lgw_version_info() {
     return lgw_version_string;
 }
@@ -242,6 +242,35 @@ struct lgw_pkt_rx_s {
     uint32_t    ftime;          /*!> packet fine timestamp (nanoseconds since last PPS) */
 };
 
+/**
+@struct lgw_pkt_rx_desc_s
+@brief Structure containing the metadata of a packet that was received, its payload being in the RX payload pool
+The payload must be released with lgw_rx_desc_release() once it is not used anymore.
+*/
+struct lgw_pkt_rx_desc_s {
+    uint32_t    freq_hz;        /*!> central frequency of the IF chain */
+    int32_t     freq_offset;
+    uint8_t     if_chain;       /*!> by which IF chain was packet received */
+    uint8_t     status;         /*!> status of the received packet */
+    uint32_t    count_us;       /*!> internal concentrator counter for timestamping, 1 microsecond resolution */
+    uint8_t     rf_chain;       /*!> through which RF chain the packet was received */
+    uint8_t     modem_id;
+    uint8_t     modulation;     /*!> modulation used by the packet */
+    uint8_t     bandwidth;      /*!> modulation bandwidth (LoRa only) */
+    uint32_t    datarate;       /*!> RX datarate of the packet (SF for LoRa) */
+    uint8_t     coderate;       /*!> error-correcting code of the packet (LoRa only) */
+    float       rssic;          /*!> average RSSI of the channel in dB */
+    float       rssis;          /*!> average RSSI of the signal in dB */
+    float       snr;            /*!> average packet SNR, in dB (LoRa only) */
+    float       snr_min;        /*!> minimum packet SNR, in dB (LoRa only) */
+    float       snr_max;        /*!> maximum packet SNR, in dB (LoRa only) */
+    uint16_t    crc;            /*!> CRC that was received in the payload */
+    uint16_t    size;           /*!> payload size in bytes */
+    uint8_t *   payload;        /*!> payload, in the RX payload pool */
+    bool        ftime_received; /*!> a fine timestamp has been received */
+    uint32_t    ftime;          /*!> packet fine timestamp (nanoseconds since last PPS) */
+};
+
 /**
 @struct lgw_pkt_tx_s
 @brief Structure containing the configuration of a packet to send and a pointer to the payload
@@ -323,6 +352,16 @@ struct lgw_conf_ftime_s {
     lgw_ftime_mode_t mode;    /*!> Fine timestamping mode */
 };
 
+/**
+@struct lgw_conf_temp_s
+@brief Configuration structure for the background temperature sampler
+*/
+struct lgw_conf_temp_s {
+    bool enable;            /*!> Enable / Disable background sampling of the board temperature sensor */
+    uint32_t period_ms;     /*!> Sampling period, in milliseconds */
+    uint32_t max_age_ms;    /*!> Oldest sample lgw_receive will use for RSSI compensation before reading the sensor itself */
+};
+
 /**
 @enum lgw_lbt_scan_time_t
 @brief Radio types that can be found on the LoRa Gateway
@@ -383,6 +422,7 @@ typedef struct lgw_context_s {
     /* Misc */
     struct lgw_conf_ftime_s     ftime_cfg;
     struct lgw_conf_sx1261_s    sx1261_cfg;
+    struct lgw_conf_temp_s      temp_cfg;
     /* Debug */
     struct lgw_conf_debug_s     debug_cfg;
 } lgw_context_t;
@@ -453,6 +493,13 @@ int lgw_ftime_setconf(struct lgw_conf_ftime_s * conf);
 */
 int lgw_sx1261_setconf(struct lgw_conf_sx1261_s * conf);
 
+/**
+@brief Configure the background temperature sampler
+@param conf structure containing the configuration parameters
+@return LGW_HAL_ERROR id the operation failed, LGW_HAL_SUCCESS else
+*/
+int lgw_temp_setconf(struct lgw_conf_temp_s * conf);
+
 /**
 @brief Configure the debug context
 @param conf pointer to structure defining the config to be applied
@@ -480,6 +527,28 @@ int lgw_stop(void);
 */
 int lgw_receive(uint8_t max_pkt, struct lgw_pkt_rx_s * pkt_data);
 
+/**
+@brief Same as lgw_receive(), returning descriptors with the payloads in the RX payload pool
+Payloads are copied only once, from the SX1302 RX buffer to the pool. When the pool is
+full, the remaining packets are left in the RX buffer for the next call.
+@param max_pkt maximum number of packets to return
+@param pkt_desc pointer to an array of descriptors
+@return LGW_HAL_ERROR id the operation failed, else the number of packets retrieved
+*/
+int lgw_receive_desc(uint8_t max_pkt, struct lgw_pkt_rx_desc_s * pkt_desc);
+
+/**
+@brief Add a reference to the payload of a descriptor, to keep it after lgw_rx_desc_release()
+@param pkt_desc pointer to the descriptor
+*/
+void lgw_rx_desc_ref(const struct lgw_pkt_rx_desc_s * pkt_desc);
+
+/**
+@brief Release the payload of a descriptor returned by lgw_receive_desc()
+@param pkt_desc pointer to the descriptor, its payload pointer is cleared
+*/
+void lgw_rx_desc_release(struct lgw_pkt_rx_desc_s * pkt_desc);
+
 /**
 @brief Schedule a packet to be send immediately or after a delay depending on tx_mode
 @param pkt_data structure containing the data and metadata for the packet to send
@@ -542,12 +611,27 @@ int lgw_get_instcnt(uint32_t * inst_cnt_us);
 int lgw_get_eui(uint64_t * eui);
 
 /**
-@brief Return the temperature measured by the LoRa concentrator sensor
+@brief Return the number of bytes dropped from the SX1302 RX buffer to re-sync on a packet syncword, a sign of corrupted fetches
+@param nb_bytes pointer to receive the number of bytes dropped since lgw_start()
+@return LGW_HAL_ERROR id the operation failed, LGW_HAL_SUCCESS else
+*/
+int lgw_get_rx_resync_bytes(uint32_t * nb_bytes);
+
+/**
+@brief Return the temperature measured by the LoRa concentrator sensor, waiting for a read of the background sampler in progress
 @param temperature The temperature measured, in degree celcius
 @return LGW_HAL_ERROR id the operation failed, LGW_HAL_SUCCESS else
 */
 int lgw_get_temperature(float * temperature);
 
+/**
+@brief Return the last temperature published by the background sampler, without accessing the sensor
+@param temperature The temperature measured, in degree celcius
+@param age_ms Age of the sample, in milliseconds (can be NULL)
+@return LGW_HAL_ERROR if the sampler is not running or has no sample yet, LGW_HAL_SUCCESS else
+*/
+int lgw_get_temperature_cached(float * temperature, uint32_t * age_ms);
+
 /**
 @brief Allow user to check the version/options of the library once compiled
 @return pointer on a human-readable null terminated string
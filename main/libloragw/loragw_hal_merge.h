@@ -0,0 +1,50 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    Removal of the duplicates generated by double demodulation, internal to
+    the HAL (used by lgw_receive() and lgw_receive_desc(), and by tests).
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+
+#ifndef _LORAGW_HAL_MERGE_H
+#define _LORAGW_HAL_MERGE_H
+
+/* -------------------------------------------------------------------------- */
+/* --- DEPENDANCIES --------------------------------------------------------- */
+
+#include <stdint.h>     /* C99 types*/
+
+#include "loragw_hal.h"
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS PROTOTYPES ------------------------------------------ */
+
+/**
+@brief Remove the duplicates generated by double demodulation and sort packets by ascending count_us, as lgw_receive() does
+Of two duplicates, the one with a valid CRC is kept, else the first one if it has a fine timestamp, the second one otherwise.
+Packets with the same count_us keep their order.
+@param p pointer to an array of packets
+@param nb_pkt number of packets in the array, updated
+@return LGW_HAL_ERROR id the operation failed, LGW_HAL_SUCCESS else
+*/
+int lgw_merge_packets(struct lgw_pkt_rx_s * p, uint8_t * nb_pkt);
+
+/**
+@brief Same as lgw_merge_packets(), on descriptors; the payloads of the removed duplicates are released
+@param p pointer to an array of descriptors
+@param nb_pkt number of descriptors in the array, updated
+@return LGW_HAL_ERROR id the operation failed, LGW_HAL_SUCCESS else
+*/
+int lgw_merge_packets_desc(struct lgw_pkt_rx_desc_s * p, uint8_t * nb_pkt);
+
+#endif
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -22,6 +22,7 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 #include <stdint.h>     /* C99 types */
 #include <stdbool.h>    /* bool type */
 #include <stdio.h>      /* printf fprintf */
+#include <string.h>     /* memset */
 
 #include "loragw_reg.h"
 
@@ -1110,27 +1111,192 @@ const struct lgw_reg_s loregs[LGW_TOTALREGS+1] = {
 /* -------------------------------------------------------------------------- */
 /* --- PRIVATE VARIABLES ---------------------------------------------------- */
 
+/* Write-through shadow of the SX1302 registers, from TX_TOP_A to RX_TOP_LORA_SERVICE_FSK.
+   The blocks above (capture RAM, ARB MCU, timestamp, OTP) are all volatile. */
+#define SHADOW_ADDR_START   SX1302_REG_TX_TOP_A_BASE_ADDR
+#define SHADOW_ADDR_END     SX1302_REG_CAPTURE_RAM_BASE_ADDR
+#define SHADOW_SIZE         (SHADOW_ADDR_END - SHADOW_ADDR_START)
+
+#define SHADOW_BIT_GET(map, i)  ((map[(i) / 8] >> ((i) % 8)) & 0x01)
+#define SHADOW_BIT_SET(map, i)  (map[(i) / 8] |= (1 << ((i) % 8)))
+
+/* Blocks updated by the chip or its MCUs behind the host's back */
+static const struct {
+    uint16_t start;
+    uint16_t end;
+} shadow_volatile[] = {
+    {SX1302_REG_GPIO_BASE_ADDR, SX1302_REG_RADIO_FE_BASE_ADDR},     /* GPIO inputs, IRQ flags, MBIST */
+    {SX1302_REG_AGC_MCU_BASE_ADDR, SX1302_REG_CLK_CTRL_BASE_ADDR}   /* AGC MCU control and mailbox */
+};
+
+static uint8_t shadow_data[SHADOW_SIZE];
+static uint8_t shadow_cacheable[SHADOW_SIZE / 8];  /* built once from loregs[] */
+static uint8_t shadow_valid[SHADOW_SIZE / 8];      /* cleared on reset */
+static bool shadow_setup_done = false;
+
 /* -------------------------------------------------------------------------- */
 /* --- PRIVATE FUNCTIONS ---------------------------------------------------- */
 
-int reg_w(uint8_t spi_mux_target, struct lgw_reg_s r, int32_t reg_value) {
+/* A register byte can be cached if none of its fields is read-only, self-clearing,
+   or in a volatile block */
+static void shadow_setup(void) {
+    int i, j;
+    uint8_t volat[SHADOW_SIZE / 8];
+    uint8_t used[SHADOW_SIZE / 8];
+
+    memset(volat, 0, sizeof volat);
+    memset(used, 0, sizeof used);
+    for (i = 0; i < LGW_TOTALREGS; i++) {
+        if ((loregs[i].addr < SHADOW_ADDR_START) || (loregs[i].addr >= SHADOW_ADDR_END)) {
+            continue;
+        }
+        j = loregs[i].addr - SHADOW_ADDR_START;
+        SHADOW_BIT_SET(used, j);
+        if ((loregs[i].rdon == 1) || (loregs[i].chck == 0)) {
+            SHADOW_BIT_SET(volat, j);
+        }
+    }
+    for (i = 0; i < (int)ARRAY_SIZE(shadow_volatile); i++) {
+        for (j = shadow_volatile[i].start; j < shadow_volatile[i].end; j++) {
+            SHADOW_BIT_SET(volat, j - SHADOW_ADDR_START);
+        }
+    }
+
+    for (i = 0; i < (int)sizeof shadow_cacheable; i++) {
+        shadow_cacheable[i] = used[i] & ~volat[i];
+    }
+    memset(shadow_valid, 0, sizeof shadow_valid);
+    shadow_setup_done = true;
+}
+
+static bool shadow_is_cacheable(uint8_t spi_mux_target, uint16_t addr) {
+    if ((spi_mux_target != LGW_SPI_MUX_TARGET_SX1302) || (addr < SHADOW_ADDR_START) || (addr >= SHADOW_ADDR_END)) {
+        return false;
+    }
+    if (shadow_setup_done == false) {
+        shadow_setup();
+    }
+    return SHADOW_BIT_GET(shadow_cacheable, addr - SHADOW_ADDR_START);
+}
+
+/* Get a register byte from the shadow, if cached */
+static bool shadow_get(uint8_t spi_mux_target, uint16_t addr, uint8_t *data) {
+    if ((shadow_is_cacheable(spi_mux_target, addr) == false) || (SHADOW_BIT_GET(shadow_valid, addr - SHADOW_ADDR_START) == 0)) {
+        return false;
+    }
+    *data = shadow_data[addr - SHADOW_ADDR_START];
+
+#if DEBUG_SHADOW == 1
+    {
+        /* cross-check against the chip, and trust the chip */
+        uint8_t u;
+        if (lgw_com_r(spi_mux_target, addr, &u) == LGW_COM_SUCCESS) {
+            if (u != *data) {
+                printf("WARNING: register shadow mismatch @ 0x%04X: shadow 0x%02X, chip 0x%02X\n", addr, *data, u);
+                shadow_data[addr - SHADOW_ADDR_START] = u;
+                *data = u;
+            }
+        }
+    }
+#endif
+
+    return true;
+}
+
+/* Record the value of a register byte written to, or read from, the chip */
+static void shadow_set(uint8_t spi_mux_target, uint16_t addr, uint8_t data) {
+    if (shadow_is_cacheable(spi_mux_target, addr) == false) {
+        return;
+    }
+    shadow_data[addr - SHADOW_ADDR_START] = data;
+    SHADOW_BIT_SET(shadow_valid, addr - SHADOW_ADDR_START);
+}
+
+static void shadow_set_burst(uint8_t spi_mux_target, uint16_t addr, const uint8_t *data, uint16_t size) {
+    uint16_t i;
+
+    for (i = 0; i < size; i++) {
+        shadow_set(spi_mux_target, addr + i, data[i]);
+    }
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+/* Write the bits selected by mask in a register byte, the other bits are preserved */
+static int reg_w_bits(uint8_t spi_mux_target, uint16_t addr, uint8_t mask, uint8_t bits) {
     int com_stat = LGW_REG_SUCCESS;
+    uint8_t u;
+    uint8_t offs, leng;
 
-    if ((r.leng == 8) && (r.offs == 0)) {
+    if (mask == 0xFF) {
         /* direct write */
-        com_stat = lgw_com_w(spi_mux_target, r.addr, (uint8_t)reg_value);
-        DEBUG_PRINTF("==> DIRECT WRITE @ 0x%04X\n", r.addr);
-    } else if ((r.offs + r.leng) <= 8) {
-        /* read-modify-write */
-        com_stat = lgw_com_rmw(spi_mux_target, r.addr, r.offs, r.leng, (uint8_t)reg_value);
-        DEBUG_PRINTF("==> READ MODIFY WRITE @ 0x%04X (offs:%u leng:%u)\n", r.addr, r.offs, r.leng);
+        u = bits;
+        com_stat = lgw_com_w(spi_mux_target, addr, u);
+        DEBUG_PRINTF("==> DIRECT WRITE @ 0x%04X\n", addr);
+    } else if (shadow_is_cacheable(spi_mux_target, addr)) {
+        /* modify-write from the shadow, the chip is read only the first time */
+        if (shadow_get(spi_mux_target, addr, &u) == false) {
+            com_stat = lgw_com_r(spi_mux_target, addr, &u);
+            if (com_stat != LGW_COM_SUCCESS) {
+                return com_stat;
+            }
+        }
+        u = (u & ~mask) | (bits & mask);
+        com_stat = lgw_com_w(spi_mux_target, addr, u);
+        DEBUG_PRINTF("==> SHADOW MODIFY WRITE @ 0x%04X (mask:0x%02X)\n", addr, mask);
     } else {
+        /* read-modify-write, a single field (contiguous mask) is left to the com layer */
+        offs = __builtin_ctz(mask);
+        leng = __builtin_popcount(mask);
+        if ((mask >> offs) == ((1 << leng) - 1)) {
+            com_stat = lgw_com_rmw(spi_mux_target, addr, offs, leng, bits >> offs);
+        } else {
+            com_stat = lgw_com_r(spi_mux_target, addr, &u);
+            if (com_stat == LGW_COM_SUCCESS) {
+                com_stat = lgw_com_w(spi_mux_target, addr, (u & ~mask) | (bits & mask));
+            }
+        }
+        DEBUG_PRINTF("==> READ MODIFY WRITE @ 0x%04X (mask:0x%02X)\n", addr, mask);
+        return com_stat;
+    }
+
+    /* keep the shadow in line with the chip (no-op for volatile registers) */
+    if (com_stat == LGW_COM_SUCCESS) {
+        shadow_set(spi_mux_target, addr, u);
+    }
+
+    return com_stat;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+/* Read a register byte, from the shadow when cached */
+static int reg_r_byte(uint8_t spi_mux_target, uint16_t addr, uint8_t *data) {
+    int com_stat = LGW_COM_SUCCESS;
+
+    if (shadow_get(spi_mux_target, addr, data) == false) {
+        com_stat = lgw_com_r(spi_mux_target, addr, data);
+        if (com_stat == LGW_COM_SUCCESS) {
+            shadow_set(spi_mux_target, addr, *data);
+        }
+    }
+
+    return com_stat;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+int reg_w(uint8_t spi_mux_target, struct lgw_reg_s r, int32_t reg_value) {
+    uint8_t mask;
+
+    if ((r.offs + r.leng) > 8) {
         /* register spanning multiple memory bytes but with an offset */
         DEBUG_MSG("ERROR: REGISTER SIZE AND OFFSET ARE NOT SUPPORTED\n");
         return LGW_REG_ERROR;
     }
 
-    return com_stat;
+    mask = ((1 << r.leng) - 1) << r.offs;
+    return reg_w_bits(spi_mux_target, r.addr, mask, ((uint8_t)reg_value << r.offs) & mask);
 }
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
@@ -1142,7 +1308,7 @@ int reg_r(uint8_t spi_mux_target, struct lgw_reg_s r, int32_t *reg_value) {
 
     if ((r.offs + r.leng) <= 8) {
         /* read one byte, then shift and mask bits to get reg value with sign extension if needed */
-        com_stat = lgw_com_r(spi_mux_target, r.addr, &bufu[0]);
+        com_stat = reg_r_byte(spi_mux_target, r.addr, &bufu[0]);
         bufu[1] = bufu[0] << (8 - r.leng - r.offs); /* left-align the data */
         if (r.sign == true) {
             bufs[2] = bufs[1] >> (8 - r.leng); /* right align the data with sign extension (ARITHMETIC right shift) */
@@ -1174,6 +1340,9 @@ int lgw_connect(const lgw_com_type_t com_type, const char * com_path) {
         return LGW_REG_ERROR;
     }
 
+    /* the chip may have been reset since last time */
+    lgw_reg_shadow_invalidate();
+
     /* open the COM link */
     com_stat = lgw_com_open(com_type, com_path);
     if (com_stat != LGW_COM_SUCCESS) {
@@ -1199,6 +1368,8 @@ int lgw_connect(const lgw_com_type_t com_type, const char * com_path) {
 int lgw_disconnect(void) {
     int com_stat;
 
+    lgw_reg_shadow_invalidate();
+
     com_stat = lgw_com_close();
     if (com_stat == LGW_COM_SUCCESS) {
         DEBUG_MSG("Note: success disconnecting the concentrator\n");
@@ -1270,6 +1441,34 @@ int lgw_reg_r(uint16_t register_id, int32_t *reg_value) {
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
+/* Accessors behind the compile-time register macros of loragw_reg_inline.h */
+int lgw_reg_w_byte(uint16_t addr, uint8_t data) {
+    if (lgw_com_w(LGW_SPI_MUX_TARGET_SX1302, addr, data) != LGW_COM_SUCCESS) {
+        DEBUG_MSG("ERROR: COM ERROR DURING REGISTER WRITE\n");
+        return LGW_REG_ERROR;
+    }
+    shadow_set(LGW_SPI_MUX_TARGET_SX1302, addr, data);
+    return LGW_REG_SUCCESS;
+}
+
+int lgw_reg_w_bits(uint16_t addr, uint8_t mask, uint8_t bits) {
+    if (reg_w_bits(LGW_SPI_MUX_TARGET_SX1302, addr, mask, bits) != LGW_COM_SUCCESS) {
+        DEBUG_MSG("ERROR: COM ERROR DURING REGISTER WRITE\n");
+        return LGW_REG_ERROR;
+    }
+    return LGW_REG_SUCCESS;
+}
+
+int lgw_reg_r_byte(uint16_t addr, uint8_t *data) {
+    if (reg_r_byte(LGW_SPI_MUX_TARGET_SX1302, addr, data) != LGW_COM_SUCCESS) {
+        DEBUG_MSG("ERROR: COM ERROR DURING REGISTER READ\n");
+        return LGW_REG_ERROR;
+    }
+    return LGW_REG_SUCCESS;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
 /* Point to a register by name and do a burst write */
 int lgw_reg_wb(uint16_t register_id, uint8_t *data, uint16_t size) {
     int com_stat = LGW_COM_SUCCESS;
@@ -1297,6 +1496,9 @@ int lgw_reg_wb(uint16_t register_id, uint8_t *data, uint16_t size) {
 
     /* do the burst write */
     com_stat = lgw_com_wb(LGW_SPI_MUX_TARGET_SX1302, r.addr, data, size);
+    if (com_stat == LGW_COM_SUCCESS) {
+        shadow_set_burst(LGW_SPI_MUX_TARGET_SX1302, r.addr, data, size);
+    }
 
     if (com_stat != LGW_COM_SUCCESS) {
         DEBUG_MSG("ERROR: COM ERROR DURING REGISTER BURST WRITE\n");
@@ -1329,6 +1531,9 @@ int lgw_reg_rb(uint16_t register_id, uint8_t *data, uint16_t size) {
 
     /* do the burst read */
     com_stat = lgw_com_rb(LGW_SPI_MUX_TARGET_SX1302, r.addr, data, size);
+    if (com_stat == LGW_COM_SUCCESS) {
+        shadow_set_burst(LGW_SPI_MUX_TARGET_SX1302, r.addr, data, size);
+    }
 
     if (com_stat != LGW_COM_SUCCESS) {
         DEBUG_MSG("ERROR: COM ERROR DURING REGISTER BURST READ\n");
@@ -1340,6 +1545,12 @@ int lgw_reg_rb(uint16_t register_id, uint8_t *data, uint16_t size) {
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
+void lgw_reg_shadow_invalidate(void) {
+    memset(shadow_valid, 0, sizeof shadow_valid);
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
 int lgw_mem_wb(uint16_t mem_addr, const uint8_t *data, uint16_t size) {
     int com_stat = LGW_COM_SUCCESS;
     int chunk_cnt = 0;
@@ -1362,6 +1573,9 @@ int lgw_mem_wb(uint16_t mem_addr, const uint8_t *data, uint16_t size) {
 
         /* do the burst write */
         com_stat = lgw_com_wb(LGW_SPI_MUX_TARGET_SX1302, addr, &data[chunk_cnt * CHUNK_SIZE_MAX], chunk_size);
+        if (com_stat == LGW_COM_SUCCESS) {
+            shadow_set_burst(LGW_SPI_MUX_TARGET_SX1302, addr, &data[chunk_cnt * CHUNK_SIZE_MAX], chunk_size);
+        }
 
         /* prepare for next write */
         addr += chunk_size;
@@ -1385,7 +1599,9 @@ int lgw_mem_rb(uint16_t mem_addr, uint8_t *data, uint16_t size, bool fifo_mode)
     uint16_t addr = mem_addr;
     uint16_t sz_todo = size;
     uint16_t chunk_size;
-    const uint16_t CHUNK_SIZE_MAX = lgw_com_chunk_size();
+    /* A FIFO is read at a fixed address: on SPI the whole burst is handed over at
+       once, the SPI layer splits it in chunks and keeps several of them in flight */
+    const uint16_t CHUNK_SIZE_MAX = ((fifo_mode == true) && (lgw_com_type() == LGW_COM_SPI)) ? size : lgw_com_chunk_size();
 
     /* check input parameters */
     CHECK_NULL(data);
@@ -1404,6 +1620,9 @@ int lgw_mem_rb(uint16_t mem_addr, uint8_t *data, uint16_t size, bool fifo_mode)
 
         /* do not increment the address when the target memory is in FIFO mode (auto-increment) */
         if (fifo_mode == false) {
+            if (com_stat == LGW_COM_SUCCESS) {
+                shadow_set_burst(LGW_SPI_MUX_TARGET_SX1302, addr, &data[chunk_cnt * CHUNK_SIZE_MAX], chunk_size);
+            }
             addr += chunk_size;
         }
 
@@ -1459,6 +1459,31 @@ int lgw_reg_w(uint16_t register_id, int32_t reg_value);
 */
 int lgw_reg_r(uint16_t register_id, int32_t *reg_value);
 
+/**
+@brief LoRa concentrator register byte write, by address (see loragw_reg_inline.h)
+@param addr register address
+@param data value of the whole byte
+@return status of register operation (LGW_REG_SUCCESS/LGW_REG_ERROR)
+*/
+int lgw_reg_w_byte(uint16_t addr, uint8_t data);
+
+/**
+@brief LoRa concentrator register bits write, by address (see loragw_reg_inline.h)
+@param addr register address
+@param mask bits to be modified, the other ones are preserved
+@param bits new value of the bits selected by mask, in place
+@return status of register operation (LGW_REG_SUCCESS/LGW_REG_ERROR)
+*/
+int lgw_reg_w_bits(uint16_t addr, uint8_t mask, uint8_t bits);
+
+/**
+@brief LoRa concentrator register byte read, by address (see loragw_reg_inline.h)
+@param addr register address
+@param data pointer to the byte read
+@return status of register operation (LGW_REG_SUCCESS/LGW_REG_ERROR)
+*/
+int lgw_reg_r_byte(uint16_t addr, uint8_t *data);
+
 /**
 @brief LoRa concentrator register burst write
 @param register_id register number in the data structure describing registers
@@ -1496,6 +1521,12 @@ int lgw_mem_wb(uint16_t mem_addr, const uint8_t *data, uint16_t size);
 */
 int lgw_mem_rb(uint16_t mem_addr, uint8_t *data, uint16_t size, bool fifo_mode);
 
+/**
+@brief Forget the register values known by the shadow, to be called when the chip
+has been reset. Cached registers are read again from the chip on next access.
+*/
+void lgw_reg_shadow_invalidate(void);
+
 #endif
 
 /* --- EOF ------------------------------------------------------------------ */
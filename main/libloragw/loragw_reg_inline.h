@@ -0,0 +1,1154 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2019 Semtech
+
+Description:
+    Compile-time register accessors, generated from loragw_reg.c by
+    scripts/gen_reg_inline.py. DO NOT EDIT.
+
+    LGW_REG_W(reg, value) / LGW_REG_R(reg, &value) take a register name
+    without its SX1302_REG_ prefix. Address, mask and sign are constants,
+    so the choice between a direct write and a masked write is made by the
+    compiler. LGW_REG_W2/3/4() write fields sharing one byte at once.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+
+#ifndef _LORAGW_REG_INLINE_H
+#define _LORAGW_REG_INLINE_H
+
+/* -------------------------------------------------------------------------- */
+/* --- DEPENDANCIES --------------------------------------------------------- */
+
+#include <stdint.h>     /* C99 types */
+#include <stdbool.h>    /* bool type */
+
+#include "loragw_reg.h"
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC MACROS -------------------------------------------------------- */
+
+/* descriptor fields: address, offset, length, sign, read-only */
+#define LGW_REGI_ADDR(reg)          LGW_REGI_ADDR_(LGW_REGI_##reg)
+#define LGW_REGI_OFFS(reg)          LGW_REGI_OFFS_(LGW_REGI_##reg)
+#define LGW_REGI_LENG(reg)          LGW_REGI_LENG_(LGW_REGI_##reg)
+#define LGW_REGI_RDON(reg)          LGW_REGI_RDON_(LGW_REGI_##reg)
+#define LGW_REGI_MASK(reg)          ((uint8_t)(((1 << LGW_REGI_LENG(reg)) - 1) << LGW_REGI_OFFS(reg)))
+#define LGW_REGI_FIELD(reg, val)    ((uint8_t)(((uint8_t)(val) << LGW_REGI_OFFS(reg)) & LGW_REGI_MASK(reg)))
+
+#define LGW_REGI_ADDR_(...)         LGW_REGI_ADDR__(__VA_ARGS__)
+#define LGW_REGI_OFFS_(...)         LGW_REGI_OFFS__(__VA_ARGS__)
+#define LGW_REGI_LENG_(...)         LGW_REGI_LENG__(__VA_ARGS__)
+#define LGW_REGI_RDON_(...)         LGW_REGI_RDON__(__VA_ARGS__)
+#define LGW_REGI_ADDR__(a, o, l, s, r)  (a)
+#define LGW_REGI_OFFS__(a, o, l, s, r)  (o)
+#define LGW_REGI_LENG__(a, o, l, s, r)  (l)
+#define LGW_REGI_RDON__(a, o, l, s, r)  (r)
+
+/* compilation fails on a write to a read-only register, or on grouped fields not sharing a byte */
+#define LGW_REGI_WRITABLE(reg)      ((void)sizeof(char[LGW_REGI_RDON(reg) ? -1 : 1]))
+#define LGW_REGI_SAME_BYTE(r1, r2)  ((void)sizeof(char[(LGW_REGI_ADDR(r1) == LGW_REGI_ADDR(r2)) ? 1 : -1]))
+
+/* write/read a register */
+#define LGW_REG_W(reg, val) \
+    (LGW_REGI_WRITABLE(reg), lgw_reg_wi(LGW_REGI_ADDR(reg), LGW_REGI_MASK(reg), LGW_REGI_FIELD(reg, val)))
+#define LGW_REG_R(reg, val) \
+    lgw_reg_ri(LGW_REGI_##reg, val)
+
+/* write 2 to 4 fields sharing the same byte, as a single register access */
+#define LGW_REG_W2(r1, v1, r2, v2) \
+    (LGW_REGI_WRITABLE(r1), LGW_REGI_WRITABLE(r2), LGW_REGI_SAME_BYTE(r1, r2), \
+     lgw_reg_wi(LGW_REGI_ADDR(r1), LGW_REGI_MASK(r1) | LGW_REGI_MASK(r2), \
+                LGW_REGI_FIELD(r1, v1) | LGW_REGI_FIELD(r2, v2)))
+#define LGW_REG_W3(r1, v1, r2, v2, r3, v3) \
+    (LGW_REGI_WRITABLE(r1), LGW_REGI_WRITABLE(r2), LGW_REGI_WRITABLE(r3), \
+     LGW_REGI_SAME_BYTE(r1, r2), LGW_REGI_SAME_BYTE(r1, r3), \
+     lgw_reg_wi(LGW_REGI_ADDR(r1), LGW_REGI_MASK(r1) | LGW_REGI_MASK(r2) | LGW_REGI_MASK(r3), \
+                LGW_REGI_FIELD(r1, v1) | LGW_REGI_FIELD(r2, v2) | LGW_REGI_FIELD(r3, v3)))
+#define LGW_REG_W4(r1, v1, r2, v2, r3, v3, r4, v4) \
+    (LGW_REGI_WRITABLE(r1), LGW_REGI_WRITABLE(r2), LGW_REGI_WRITABLE(r3), LGW_REGI_WRITABLE(r4), \
+     LGW_REGI_SAME_BYTE(r1, r2), LGW_REGI_SAME_BYTE(r1, r3), LGW_REGI_SAME_BYTE(r1, r4), \
+     lgw_reg_wi(LGW_REGI_ADDR(r1), LGW_REGI_MASK(r1) | LGW_REGI_MASK(r2) | LGW_REGI_MASK(r3) | LGW_REGI_MASK(r4), \
+                LGW_REGI_FIELD(r1, v1) | LGW_REGI_FIELD(r2, v2) | LGW_REGI_FIELD(r3, v3) | LGW_REGI_FIELD(r4, v4)))
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS ----------------------------------------------------- */
+
+static inline int lgw_reg_wi(uint16_t addr, uint8_t mask, uint8_t bits) {
+    if (mask == 0xFF) {
+        return lgw_reg_w_byte(addr, bits);
+    } else {
+        return lgw_reg_w_bits(addr, mask, bits);
+    }
+}
+
+static inline int lgw_reg_ri(uint16_t addr, uint8_t offs, uint8_t leng, bool sign, bool rdon, int32_t *reg_value) {
+    int err;
+    uint8_t u = 0;
+
+    (void)rdon;
+    err = lgw_reg_r_byte(addr, &u);
+    if (sign == true) {
+        *reg_value = (int32_t)((int8_t)(u << (8 - leng - offs)) >> (8 - leng));
+    } else {
+        *reg_value = (int32_t)((u >> offs) & ((1 << leng) - 1));
+    }
+    return err;
+}
+
+/* -------------------------------------------------------------------------- */
+/* --- REGISTER DESCRIPTORS ------------------------------------------------- */
+
+#define LGW_REGI_COMMON_PAGE_PAGE 0x5600, 0, 2, 0, 0
+#define LGW_REGI_COMMON_CTRL0_CLK32_RIF_CTRL 0x5601, 4, 1, 0, 0
+#define LGW_REGI_COMMON_CTRL0_HOST_RADIO_CTRL 0x5601, 3, 1, 0, 0
+#define LGW_REGI_COMMON_CTRL0_RADIO_MISC_EN 0x5601, 2, 1, 0, 0
+#define LGW_REGI_COMMON_CTRL0_SX1261_MODE_RADIO_B 0x5601, 1, 1, 0, 0
+#define LGW_REGI_COMMON_CTRL0_SX1261_MODE_RADIO_A 0x5601, 0, 1, 0, 0
+#define LGW_REGI_COMMON_CTRL1_SWAP_IQ_RADIO_B 0x5602, 3, 1, 0, 0
+#define LGW_REGI_COMMON_CTRL1_SAMPLING_EDGE_RADIO_B 0x5602, 2, 1, 0, 0
+#define LGW_REGI_COMMON_CTRL1_SWAP_IQ_RADIO_A 0x5602, 1, 1, 0, 0
+#define LGW_REGI_COMMON_CTRL1_SAMPLING_EDGE_RADIO_A 0x5602, 0, 1, 0, 0
+#define LGW_REGI_COMMON_SPI_DIV_RATIO_SPI_HALF_PERIOD 0x5603, 0, 8, 0, 0
+#define LGW_REGI_COMMON_RADIO_SELECT_RADIO_SELECT 0x5604, 0, 8, 0, 0
+#define LGW_REGI_COMMON_GEN_GLOBAL_EN 0x5605, 3, 1, 0, 0
+#define LGW_REGI_COMMON_GEN_FSK_MODEM_ENABLE 0x5605, 2, 1, 0, 0
+#define LGW_REGI_COMMON_GEN_CONCENTRATOR_MODEM_ENABLE 0x5605, 1, 1, 0, 0
+#define LGW_REGI_COMMON_GEN_MBWSSF_MODEM_ENABLE 0x5605, 0, 1, 0, 0
+#define LGW_REGI_COMMON_VERSION_VERSION 0x5606, 0, 8, 0, 1
+#define LGW_REGI_COMMON_DUMMY_DUMMY 0x5607, 0, 1, 0, 1
+#define LGW_REGI_AGC_MCU_CTRL_CLK_EN 0x5780, 4, 1, 0, 0
+#define LGW_REGI_AGC_MCU_CTRL_FORCE_HOST_FE_CTRL 0x5780, 3, 1, 0, 0
+#define LGW_REGI_AGC_MCU_CTRL_MCU_CLEAR 0x5780, 2, 1, 0, 0
+#define LGW_REGI_AGC_MCU_CTRL_HOST_PROG 0x5780, 1, 1, 0, 0
+#define LGW_REGI_AGC_MCU_CTRL_PARITY_ERROR 0x5780, 0, 1, 0, 1
+#define LGW_REGI_AGC_MCU_MCU_AGC_STATUS_MCU_AGC_STATUS 0x5781, 0, 8, 0, 1
+#define LGW_REGI_AGC_MCU_PA_GAIN_PA_B_GAIN 0x5782, 2, 2, 0, 0
+#define LGW_REGI_AGC_MCU_PA_GAIN_PA_A_GAIN 0x5782, 0, 2, 0, 0
+#define LGW_REGI_AGC_MCU_RF_EN_A_RADIO_RST 0x5783, 3, 1, 0, 0
+#define LGW_REGI_AGC_MCU_RF_EN_A_RADIO_EN 0x5783, 2, 1, 0, 0
+#define LGW_REGI_AGC_MCU_RF_EN_A_PA_EN 0x5783, 1, 1, 0, 0
+#define LGW_REGI_AGC_MCU_RF_EN_A_LNA_EN 0x5783, 0, 1, 0, 0
+#define LGW_REGI_AGC_MCU_RF_EN_B_RADIO_RST 0x5784, 3, 1, 0, 0
+#define LGW_REGI_AGC_MCU_RF_EN_B_RADIO_EN 0x5784, 2, 1, 0, 0
+#define LGW_REGI_AGC_MCU_RF_EN_B_PA_EN 0x5784, 1, 1, 0, 0
+#define LGW_REGI_AGC_MCU_RF_EN_B_LNA_EN 0x5784, 0, 1, 0, 0
+#define LGW_REGI_AGC_MCU_LUT_TABLE_A_PA_LUT 0x5785, 4, 4, 0, 0
+#define LGW_REGI_AGC_MCU_LUT_TABLE_A_LNA_LUT 0x5785, 0, 4, 0, 0
+#define LGW_REGI_AGC_MCU_LUT_TABLE_B_PA_LUT 0x5786, 4, 4, 0, 0
+#define LGW_REGI_AGC_MCU_LUT_TABLE_B_LNA_LUT 0x5786, 0, 4, 0, 0
+#define LGW_REGI_AGC_MCU_UART_CFG_MSBF 0x5787, 5, 1, 0, 0
+#define LGW_REGI_AGC_MCU_UART_CFG_PAR_EN 0x5787, 4, 1, 0, 0
+#define LGW_REGI_AGC_MCU_UART_CFG_PAR_MODE 0x5787, 3, 1, 0, 0
+#define LGW_REGI_AGC_MCU_UART_CFG_START_LEN 0x5787, 2, 1, 0, 0
+#define LGW_REGI_AGC_MCU_UART_CFG_STOP_LEN 0x5787, 1, 1, 0, 0
+#define LGW_REGI_AGC_MCU_UART_CFG_WORD_LEN 0x5787, 0, 1, 0, 0
+#define LGW_REGI_AGC_MCU_UART_CFG2_BIT_RATE 0x5788, 0, 8, 0, 0
+#define LGW_REGI_AGC_MCU_MCU_MAIL_BOX_WR_DATA_BYTE3_MCU_MAIL_BOX_WR_DATA 0x5789, 0, 8, 0, 0
+#define LGW_REGI_AGC_MCU_MCU_MAIL_BOX_WR_DATA_BYTE2_MCU_MAIL_BOX_WR_DATA 0x578A, 0, 8, 0, 0
+#define LGW_REGI_AGC_MCU_MCU_MAIL_BOX_WR_DATA_BYTE1_MCU_MAIL_BOX_WR_DATA 0x578B, 0, 8, 0, 0
+#define LGW_REGI_AGC_MCU_MCU_MAIL_BOX_WR_DATA_BYTE0_MCU_MAIL_BOX_WR_DATA 0x578C, 0, 8, 0, 0
+#define LGW_REGI_AGC_MCU_MCU_MAIL_BOX_RD_DATA_BYTE3_MCU_MAIL_BOX_RD_DATA 0x578D, 0, 8, 0, 1
+#define LGW_REGI_AGC_MCU_MCU_MAIL_BOX_RD_DATA_BYTE2_MCU_MAIL_BOX_RD_DATA 0x578E, 0, 8, 0, 1
+#define LGW_REGI_AGC_MCU_MCU_MAIL_BOX_RD_DATA_BYTE1_MCU_MAIL_BOX_RD_DATA 0x578F, 0, 8, 0, 1
+#define LGW_REGI_AGC_MCU_MCU_MAIL_BOX_RD_DATA_BYTE0_MCU_MAIL_BOX_RD_DATA 0x5790, 0, 8, 0, 1
+#define LGW_REGI_AGC_MCU_DUMMY_DUMMY3 0x5791, 0, 1, 0, 1
+#define LGW_REGI_CLK_CTRL_CLK_SEL_CLKDIV_EN 0x57C0, 2, 1, 0, 0
+#define LGW_REGI_CLK_CTRL_CLK_SEL_CLK_RADIO_B_SEL 0x57C0, 1, 1, 0, 0
+#define LGW_REGI_CLK_CTRL_CLK_SEL_CLK_RADIO_A_SEL 0x57C0, 0, 1, 0, 0
+#define LGW_REGI_CLK_CTRL_DUMMY_DUMMY 0x57C1, 3, 1, 0, 1
+#define LGW_REGI_TX_TOP_A_TX_TRIG_TX_FSM_CLR 0x5200, 3, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_TRIG_TX_TRIG_GPS 0x5200, 2, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_TRIG_TX_TRIG_DELAYED 0x5200, 1, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_TRIG_TX_TRIG_IMMEDIATE 0x5200, 0, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TIMER_TRIG_BYTE3_TIMER_DELAYED_TRIG 0x5201, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_TIMER_TRIG_BYTE2_TIMER_DELAYED_TRIG 0x5202, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_TIMER_TRIG_BYTE1_TIMER_DELAYED_TRIG 0x5203, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_TIMER_TRIG_BYTE0_TIMER_DELAYED_TRIG 0x5204, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_START_DELAY_MSB_TX_START_DELAY 0x5205, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_START_DELAY_LSB_TX_START_DELAY 0x5206, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_CTRL_WRITE_BUFFER 0x5207, 0, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_RAMP_DURATION_TX_RAMP_DURATION 0x5208, 0, 3, 0, 0
+#define LGW_REGI_TX_TOP_A_GEN_CFG_0_MODULATION_TYPE 0x5209, 0, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TEST_0_TX_ACTIVE_CTRL 0x520A, 1, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TEST_0_TX_ACTIVE_SEL 0x520A, 0, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_FLAG_TX_TIMEOUT 0x520B, 1, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_FLAG_PKT_DONE 0x520B, 0, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_AGC_TX_BW_AGC_TX_BW 0x520C, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_AGC_TX_PWR_AGC_TX_PWR 0x520D, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_TIMEOUT_CNT_BYTE_2_TIMEOUT_CNT 0x520E, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_TIMEOUT_CNT_BYTE_1_TIMEOUT_CNT 0x520F, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_TIMEOUT_CNT_BYTE_0_TIMEOUT_CNT 0x5210, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_FSM_STATUS_TX_STATUS 0x5211, 0, 8, 0, 1
+#define LGW_REGI_TX_TOP_A_DUMMY_CONTROL_DUMMY 0x5212, 3, 1, 0, 1
+#define LGW_REGI_TX_TOP_A_TX_RFFE_IF_CTRL_PLL_DIV_CTRL 0x5220, 5, 3, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_RFFE_IF_CTRL_TX_CLK_EDGE 0x5220, 4, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_RFFE_IF_CTRL_TX_MODE 0x5220, 3, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_RFFE_IF_CTRL_TX_IF_DST 0x5220, 2, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_RFFE_IF_CTRL_TX_IF_SRC 0x5220, 0, 2, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_RFFE_IF_CTRL2_SX125X_IQ_INVERT 0x5221, 1, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_RFFE_IF_CTRL2_PLL_DIV_CTRL_AGC 0x5221, 0, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_RFFE_IF_IQ_GAIN_IQ_GAIN 0x5222, 0, 2, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_RFFE_IF_I_OFFSET_I_OFFSET 0x5223, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_RFFE_IF_Q_OFFSET_Q_OFFSET 0x5224, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_RFFE_IF_FREQ_RF_H_FREQ_RF 0x5225, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_RFFE_IF_FREQ_RF_M_FREQ_RF 0x5226, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_RFFE_IF_FREQ_RF_L_FREQ_RF 0x5227, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_RFFE_IF_FREQ_DEV_H_FREQ_DEV 0x5228, 0, 4, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_RFFE_IF_FREQ_DEV_L_FREQ_DEV 0x5229, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_RFFE_IF_TEST_MOD_FREQ 0x522A, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_DUMMY_MODULATOR_DUMMY 0x522B, 3, 1, 0, 1
+#define LGW_REGI_TX_TOP_A_FSK_PKT_LEN_PKT_LENGTH 0x5240, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_FSK_CFG_0_TX_CONT 0x5241, 5, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_FSK_CFG_0_CRC_IBM 0x5241, 4, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_FSK_CFG_0_DCFREE_ENC 0x5241, 2, 2, 0, 0
+#define LGW_REGI_TX_TOP_A_FSK_CFG_0_CRC_EN 0x5241, 1, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_FSK_CFG_0_PKT_MODE 0x5241, 0, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_FSK_PREAMBLE_SIZE_MSB_PREAMBLE_SIZE 0x5242, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_FSK_PREAMBLE_SIZE_LSB_PREAMBLE_SIZE 0x5243, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_FSK_BIT_RATE_MSB_BIT_RATE 0x5244, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_FSK_BIT_RATE_LSB_BIT_RATE 0x5245, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_FSK_MOD_FSK_REF_PATTERN_SIZE 0x5246, 5, 3, 0, 0
+#define LGW_REGI_TX_TOP_A_FSK_MOD_FSK_PREAMBLE_SEQ 0x5246, 4, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_FSK_MOD_FSK_REF_PATTERN_EN 0x5246, 3, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_FSK_MOD_FSK_GAUSSIAN_SELECT_BT 0x5246, 1, 2, 0, 0
+#define LGW_REGI_TX_TOP_A_FSK_MOD_FSK_GAUSSIAN_EN 0x5246, 0, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_FSK_REF_PATTERN_BYTE7_FSK_REF_PATTERN 0x5247, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_FSK_REF_PATTERN_BYTE6_FSK_REF_PATTERN 0x5248, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_FSK_REF_PATTERN_BYTE5_FSK_REF_PATTERN 0x5249, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_FSK_REF_PATTERN_BYTE4_FSK_REF_PATTERN 0x524A, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_FSK_REF_PATTERN_BYTE3_FSK_REF_PATTERN 0x524B, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_FSK_REF_PATTERN_BYTE2_FSK_REF_PATTERN 0x524C, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_FSK_REF_PATTERN_BYTE1_FSK_REF_PATTERN 0x524D, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_FSK_REF_PATTERN_BYTE0_FSK_REF_PATTERN 0x524E, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_DUMMY_GSFK_DUMMY 0x524F, 3, 1, 0, 1
+#define LGW_REGI_TX_TOP_A_TXRX_CFG0_0_MODEM_BW 0x5260, 4, 4, 0, 0
+#define LGW_REGI_TX_TOP_A_TXRX_CFG0_0_MODEM_SF 0x5260, 0, 4, 0, 0
+#define LGW_REGI_TX_TOP_A_TXRX_CFG0_1_PPM_OFFSET_HDR_CTRL 0x5261, 6, 2, 0, 0
+#define LGW_REGI_TX_TOP_A_TXRX_CFG0_1_PPM_OFFSET 0x5261, 4, 2, 0, 0
+#define LGW_REGI_TX_TOP_A_TXRX_CFG0_1_POST_PREAMBLE_GAP_LONG 0x5261, 3, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TXRX_CFG0_1_CODING_RATE 0x5261, 0, 3, 0, 0
+#define LGW_REGI_TX_TOP_A_TXRX_CFG0_2_FINE_SYNCH_EN 0x5262, 7, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TXRX_CFG0_2_MODEM_EN 0x5262, 6, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TXRX_CFG0_2_CADRXTX 0x5262, 4, 2, 0, 0
+#define LGW_REGI_TX_TOP_A_TXRX_CFG0_2_IMPLICIT_HEADER 0x5262, 1, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TXRX_CFG0_2_CRC_EN 0x5262, 0, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TXRX_CFG0_3_PAYLOAD_LENGTH 0x5263, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_TXRX_CFG1_0_INT_STEP_ORIDE_EN 0x5264, 7, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TXRX_CFG1_0_INT_STEP_ORIDE 0x5264, 0, 6, 0, 0
+#define LGW_REGI_TX_TOP_A_TXRX_CFG1_1_MODEM_START 0x5265, 7, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TXRX_CFG1_1_HEADER_DIFF_MODE 0x5265, 6, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TXRX_CFG1_1_ZERO_PAD 0x5265, 0, 6, 0, 0
+#define LGW_REGI_TX_TOP_A_TXRX_CFG1_2_PREAMBLE_SYMB_NB 0x5266, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_TXRX_CFG1_3_PREAMBLE_SYMB_NB 0x5267, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_TXRX_CFG1_4_AUTO_ACK_INT_DELAY 0x5268, 6, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TXRX_CFG1_4_AUTO_ACK_RX 0x5268, 5, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TXRX_CFG1_4_AUTO_ACK_TX 0x5268, 4, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_CFG0_0_CHIRP_LOWPASS 0x5269, 4, 3, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_CFG0_0_PPM_OFFSET_SIG 0x5269, 3, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_CFG0_0_CONTCHIRP 0x5269, 2, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_CFG0_0_CHIRP_INVERT 0x5269, 1, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_CFG0_0_CONTINUOUS 0x5269, 0, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_CFG0_1_POWER_RANGING 0x526A, 0, 6, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_CFG1_0_FRAME_NB 0x526B, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_CFG1_1_HOP_CTRL 0x526C, 5, 2, 0, 0
+#define LGW_REGI_TX_TOP_A_TX_CFG1_1_IFS 0x526C, 0, 5, 0, 0
+#define LGW_REGI_TX_TOP_A_FRAME_SYNCH_0_AUTO_SCALE 0x526D, 7, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_FRAME_SYNCH_0_DROP_ON_SYNCH 0x526D, 6, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_FRAME_SYNCH_0_GAIN 0x526D, 5, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_FRAME_SYNCH_0_PEAK1_POS 0x526D, 0, 5, 1, 0
+#define LGW_REGI_TX_TOP_A_FRAME_SYNCH_1_FINETIME_ON_LAST 0x526E, 7, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_FRAME_SYNCH_1_TIMEOUT_OPT 0x526E, 5, 2, 0, 0
+#define LGW_REGI_TX_TOP_A_FRAME_SYNCH_1_PEAK2_POS 0x526E, 0, 5, 1, 0
+#define LGW_REGI_TX_TOP_A_LORA_TX_STATE_STATUS 0x526F, 0, 4, 0, 1
+#define LGW_REGI_TX_TOP_A_LORA_TX_FLAG_FRAME_DONE 0x5270, 2, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_LORA_TX_FLAG_CONT_DONE 0x5270, 1, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_LORA_TX_FLAG_PLD_DONE 0x5270, 0, 1, 0, 0
+#define LGW_REGI_TX_TOP_A_DUMMY_LORA_DUMMY 0x5271, 3, 1, 0, 1
+#define LGW_REGI_TX_TOP_B_TX_TRIG_TX_FSM_CLR 0x5400, 3, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_TRIG_TX_TRIG_GPS 0x5400, 2, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_TRIG_TX_TRIG_DELAYED 0x5400, 1, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_TRIG_TX_TRIG_IMMEDIATE 0x5400, 0, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TIMER_TRIG_BYTE3_TIMER_DELAYED_TRIG 0x5401, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_TIMER_TRIG_BYTE2_TIMER_DELAYED_TRIG 0x5402, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_TIMER_TRIG_BYTE1_TIMER_DELAYED_TRIG 0x5403, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_TIMER_TRIG_BYTE0_TIMER_DELAYED_TRIG 0x5404, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_START_DELAY_MSB_TX_START_DELAY 0x5405, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_START_DELAY_LSB_TX_START_DELAY 0x5406, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_CTRL_WRITE_BUFFER 0x5407, 0, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_RAMP_DURATION_TX_RAMP_DURATION 0x5408, 0, 3, 0, 0
+#define LGW_REGI_TX_TOP_B_GEN_CFG_0_MODULATION_TYPE 0x5409, 0, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TEST_0_TX_ACTIVE_CTRL 0x540A, 1, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TEST_0_TX_ACTIVE_SEL 0x540A, 0, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_FLAG_TX_TIMEOUT 0x540B, 1, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_FLAG_PKT_DONE 0x540B, 0, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_AGC_TX_BW_AGC_TX_BW 0x540C, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_AGC_TX_PWR_AGC_TX_PWR 0x540D, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_TIMEOUT_CNT_BYTE_2_TIMEOUT_CNT 0x540E, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_TIMEOUT_CNT_BYTE_1_TIMEOUT_CNT 0x540F, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_TIMEOUT_CNT_BYTE_0_TIMEOUT_CNT 0x5410, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_FSM_STATUS_TX_STATUS 0x5411, 0, 8, 0, 1
+#define LGW_REGI_TX_TOP_B_DUMMY_CONTROL_DUMMY 0x5412, 3, 1, 0, 1
+#define LGW_REGI_TX_TOP_B_TX_RFFE_IF_CTRL_PLL_DIV_CTRL 0x5420, 5, 3, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_RFFE_IF_CTRL_TX_CLK_EDGE 0x5420, 4, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_RFFE_IF_CTRL_TX_MODE 0x5420, 3, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_RFFE_IF_CTRL_TX_IF_DST 0x5420, 2, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_RFFE_IF_CTRL_TX_IF_SRC 0x5420, 0, 2, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_RFFE_IF_CTRL2_SX125X_IQ_INVERT 0x5421, 1, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_RFFE_IF_CTRL2_PLL_DIV_CTRL_AGC 0x5421, 0, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_RFFE_IF_IQ_GAIN_IQ_GAIN 0x5422, 0, 2, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_RFFE_IF_I_OFFSET_I_OFFSET 0x5423, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_RFFE_IF_Q_OFFSET_Q_OFFSET 0x5424, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_RFFE_IF_FREQ_RF_H_FREQ_RF 0x5425, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_RFFE_IF_FREQ_RF_M_FREQ_RF 0x5426, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_RFFE_IF_FREQ_RF_L_FREQ_RF 0x5427, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_RFFE_IF_FREQ_DEV_H_FREQ_DEV 0x5428, 0, 4, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_RFFE_IF_FREQ_DEV_L_FREQ_DEV 0x5429, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_RFFE_IF_TEST_MOD_FREQ 0x542A, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_DUMMY_MODULATOR_DUMMY 0x542B, 3, 1, 0, 1
+#define LGW_REGI_TX_TOP_B_FSK_PKT_LEN_PKT_LENGTH 0x5440, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_FSK_CFG_0_TX_CONT 0x5441, 5, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_FSK_CFG_0_CRC_IBM 0x5441, 4, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_FSK_CFG_0_DCFREE_ENC 0x5441, 2, 2, 0, 0
+#define LGW_REGI_TX_TOP_B_FSK_CFG_0_CRC_EN 0x5441, 1, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_FSK_CFG_0_PKT_MODE 0x5441, 0, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_FSK_PREAMBLE_SIZE_MSB_PREAMBLE_SIZE 0x5442, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_FSK_PREAMBLE_SIZE_LSB_PREAMBLE_SIZE 0x5443, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_FSK_BIT_RATE_MSB_BIT_RATE 0x5444, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_FSK_BIT_RATE_LSB_BIT_RATE 0x5445, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_FSK_MOD_FSK_REF_PATTERN_SIZE 0x5446, 5, 3, 0, 0
+#define LGW_REGI_TX_TOP_B_FSK_MOD_FSK_PREAMBLE_SEQ 0x5446, 4, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_FSK_MOD_FSK_REF_PATTERN_EN 0x5446, 3, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_FSK_MOD_FSK_GAUSSIAN_SELECT_BT 0x5446, 1, 2, 0, 0
+#define LGW_REGI_TX_TOP_B_FSK_MOD_FSK_GAUSSIAN_EN 0x5446, 0, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_FSK_REF_PATTERN_BYTE7_FSK_REF_PATTERN 0x5447, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_FSK_REF_PATTERN_BYTE6_FSK_REF_PATTERN 0x5448, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_FSK_REF_PATTERN_BYTE5_FSK_REF_PATTERN 0x5449, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_FSK_REF_PATTERN_BYTE4_FSK_REF_PATTERN 0x544A, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_FSK_REF_PATTERN_BYTE3_FSK_REF_PATTERN 0x544B, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_FSK_REF_PATTERN_BYTE2_FSK_REF_PATTERN 0x544C, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_FSK_REF_PATTERN_BYTE1_FSK_REF_PATTERN 0x544D, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_FSK_REF_PATTERN_BYTE0_FSK_REF_PATTERN 0x544E, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_DUMMY_GSFK_DUMMY 0x544F, 3, 1, 0, 1
+#define LGW_REGI_TX_TOP_B_TXRX_CFG0_0_MODEM_BW 0x5460, 4, 4, 0, 0
+#define LGW_REGI_TX_TOP_B_TXRX_CFG0_0_MODEM_SF 0x5460, 0, 4, 0, 0
+#define LGW_REGI_TX_TOP_B_TXRX_CFG0_1_PPM_OFFSET_HDR_CTRL 0x5461, 6, 2, 0, 0
+#define LGW_REGI_TX_TOP_B_TXRX_CFG0_1_PPM_OFFSET 0x5461, 4, 2, 0, 0
+#define LGW_REGI_TX_TOP_B_TXRX_CFG0_1_POST_PREAMBLE_GAP_LONG 0x5461, 3, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TXRX_CFG0_1_CODING_RATE 0x5461, 0, 3, 0, 0
+#define LGW_REGI_TX_TOP_B_TXRX_CFG0_2_FINE_SYNCH_EN 0x5462, 7, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TXRX_CFG0_2_MODEM_EN 0x5462, 6, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TXRX_CFG0_2_CADRXTX 0x5462, 4, 2, 0, 0
+#define LGW_REGI_TX_TOP_B_TXRX_CFG0_2_IMPLICIT_HEADER 0x5462, 1, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TXRX_CFG0_2_CRC_EN 0x5462, 0, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TXRX_CFG0_3_PAYLOAD_LENGTH 0x5463, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_TXRX_CFG1_0_INT_STEP_ORIDE_EN 0x5464, 7, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TXRX_CFG1_0_INT_STEP_ORIDE 0x5464, 0, 6, 0, 0
+#define LGW_REGI_TX_TOP_B_TXRX_CFG1_1_MODEM_START 0x5465, 7, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TXRX_CFG1_1_HEADER_DIFF_MODE 0x5465, 6, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TXRX_CFG1_1_ZERO_PAD 0x5465, 0, 6, 0, 0
+#define LGW_REGI_TX_TOP_B_TXRX_CFG1_2_PREAMBLE_SYMB_NB 0x5466, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_TXRX_CFG1_3_PREAMBLE_SYMB_NB 0x5467, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_TXRX_CFG1_4_AUTO_ACK_INT_DELAY 0x5468, 6, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TXRX_CFG1_4_AUTO_ACK_RX 0x5468, 5, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TXRX_CFG1_4_AUTO_ACK_TX 0x5468, 4, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_CFG0_0_CHIRP_LOWPASS 0x5469, 4, 3, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_CFG0_0_PPM_OFFSET_SIG 0x5469, 3, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_CFG0_0_CONTCHIRP 0x5469, 2, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_CFG0_0_CHIRP_INVERT 0x5469, 1, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_CFG0_0_CONTINUOUS 0x5469, 0, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_CFG0_1_POWER_RANGING 0x546A, 0, 6, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_CFG1_0_FRAME_NB 0x546B, 0, 8, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_CFG1_1_HOP_CTRL 0x546C, 5, 2, 0, 0
+#define LGW_REGI_TX_TOP_B_TX_CFG1_1_IFS 0x546C, 0, 5, 0, 0
+#define LGW_REGI_TX_TOP_B_FRAME_SYNCH_0_AUTO_SCALE 0x546D, 7, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_FRAME_SYNCH_0_DROP_ON_SYNCH 0x546D, 6, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_FRAME_SYNCH_0_GAIN 0x546D, 5, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_FRAME_SYNCH_0_PEAK1_POS 0x546D, 0, 5, 1, 0
+#define LGW_REGI_TX_TOP_B_FRAME_SYNCH_1_FINETIME_ON_LAST 0x546E, 7, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_FRAME_SYNCH_1_TIMEOUT_OPT 0x546E, 5, 2, 0, 0
+#define LGW_REGI_TX_TOP_B_FRAME_SYNCH_1_PEAK2_POS 0x546E, 0, 5, 1, 0
+#define LGW_REGI_TX_TOP_B_LORA_TX_STATE_STATUS 0x546F, 0, 4, 0, 1
+#define LGW_REGI_TX_TOP_B_LORA_TX_FLAG_FRAME_DONE 0x5470, 2, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_LORA_TX_FLAG_CONT_DONE 0x5470, 1, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_LORA_TX_FLAG_PLD_DONE 0x5470, 0, 1, 0, 0
+#define LGW_REGI_TX_TOP_B_DUMMY_LORA_DUMMY 0x5471, 3, 1, 0, 1
+#define LGW_REGI_GPIO_GPIO_DIR_H_DIRECTION 0x5640, 0, 4, 0, 0
+#define LGW_REGI_GPIO_GPIO_DIR_L_DIRECTION 0x5641, 0, 8, 0, 0
+#define LGW_REGI_GPIO_GPIO_OUT_H_OUT_VALUE 0x5642, 0, 4, 0, 0
+#define LGW_REGI_GPIO_GPIO_OUT_L_OUT_VALUE 0x5643, 0, 8, 0, 0
+#define LGW_REGI_GPIO_GPIO_IN_H_IN_VALUE 0x5644, 0, 4, 0, 1
+#define LGW_REGI_GPIO_GPIO_IN_L_IN_VALUE 0x5645, 0, 8, 0, 1
+#define LGW_REGI_GPIO_GPIO_PD_H_PD_VALUE 0x5646, 0, 4, 0, 0
+#define LGW_REGI_GPIO_GPIO_PD_L_PD_VALUE 0x5647, 0, 8, 0, 0
+#define LGW_REGI_GPIO_GPIO_SEL_0_SELECTION 0x5648, 0, 4, 0, 0
+#define LGW_REGI_GPIO_GPIO_SEL_1_SELECTION 0x5649, 0, 4, 0, 0
+#define LGW_REGI_GPIO_GPIO_SEL_2_SELECTION 0x564A, 0, 4, 0, 0
+#define LGW_REGI_GPIO_GPIO_SEL_3_SELECTION 0x564B, 0, 4, 0, 0
+#define LGW_REGI_GPIO_GPIO_SEL_4_SELECTION 0x564C, 0, 4, 0, 0
+#define LGW_REGI_GPIO_GPIO_SEL_5_SELECTION 0x564D, 0, 4, 0, 0
+#define LGW_REGI_GPIO_GPIO_SEL_6_SELECTION 0x564E, 0, 4, 0, 0
+#define LGW_REGI_GPIO_GPIO_SEL_7_SELECTION 0x564F, 0, 4, 0, 0
+#define LGW_REGI_GPIO_GPIO_SEL_8_11_GPIO_11_9_SEL 0x5650, 1, 4, 0, 0
+#define LGW_REGI_GPIO_GPIO_SEL_8_11_GPIO_8_SEL 0x5650, 0, 1, 0, 0
+#define LGW_REGI_GPIO_HOST_IRQ_TX_TIMEOUT_B 0x5651, 5, 1, 0, 0
+#define LGW_REGI_GPIO_HOST_IRQ_TX_TIMEOUT_A 0x5651, 4, 1, 0, 0
+#define LGW_REGI_GPIO_HOST_IRQ_TX_DONE_B 0x5651, 3, 1, 0, 0
+#define LGW_REGI_GPIO_HOST_IRQ_TX_DONE_A 0x5651, 2, 1, 0, 0
+#define LGW_REGI_GPIO_HOST_IRQ_TIMESTAMP 0x5651, 1, 1, 0, 0
+#define LGW_REGI_GPIO_HOST_IRQ_RX_BUFFER_WATERMARK 0x5651, 0, 1, 0, 0
+#define LGW_REGI_GPIO_HOST_IRQ_EN_TX_TIMEOUT_B 0x5652, 5, 1, 0, 0
+#define LGW_REGI_GPIO_HOST_IRQ_EN_TX_TIMEOUT_A 0x5652, 4, 1, 0, 0
+#define LGW_REGI_GPIO_HOST_IRQ_EN_TX_DONE_B 0x5652, 3, 1, 0, 0
+#define LGW_REGI_GPIO_HOST_IRQ_EN_TX_DONE_A 0x5652, 2, 1, 0, 0
+#define LGW_REGI_GPIO_HOST_IRQ_EN_TIMESTAMP 0x5652, 1, 1, 0, 0
+#define LGW_REGI_GPIO_HOST_IRQ_EN_RX_BUFFER_WATERMARK 0x5652, 0, 1, 0, 0
+#define LGW_REGI_GPIO_DUMMY_DUMMY 0x5653, 0, 1, 0, 1
+#define LGW_REGI_TIMESTAMP_GPS_CTRL_GPS_POL 0x6100, 1, 1, 0, 0
+#define LGW_REGI_TIMESTAMP_GPS_CTRL_GPS_EN 0x6100, 0, 1, 0, 0
+#define LGW_REGI_TIMESTAMP_TIMESTAMP_PPS_MSB2_TIMESTAMP_PPS 0x6101, 0, 8, 0, 1
+#define LGW_REGI_TIMESTAMP_TIMESTAMP_PPS_MSB1_TIMESTAMP_PPS 0x6102, 0, 8, 0, 1
+#define LGW_REGI_TIMESTAMP_TIMESTAMP_PPS_LSB2_TIMESTAMP_PPS 0x6103, 0, 8, 0, 1
+#define LGW_REGI_TIMESTAMP_TIMESTAMP_PPS_LSB1_TIMESTAMP_PPS 0x6104, 0, 8, 0, 1
+#define LGW_REGI_TIMESTAMP_TIMESTAMP_MSB2_TIMESTAMP 0x6105, 0, 8, 0, 1
+#define LGW_REGI_TIMESTAMP_TIMESTAMP_MSB1_TIMESTAMP 0x6106, 0, 8, 0, 1
+#define LGW_REGI_TIMESTAMP_TIMESTAMP_LSB2_TIMESTAMP 0x6107, 0, 8, 0, 1
+#define LGW_REGI_TIMESTAMP_TIMESTAMP_LSB1_TIMESTAMP 0x6108, 0, 8, 0, 1
+#define LGW_REGI_TIMESTAMP_TIMESTAMP_SET3_TIMESTAMP 0x6109, 0, 8, 0, 0
+#define LGW_REGI_TIMESTAMP_TIMESTAMP_SET2_TIMESTAMP 0x610A, 0, 8, 0, 0
+#define LGW_REGI_TIMESTAMP_TIMESTAMP_SET1_TIMESTAMP 0x610B, 0, 8, 0, 0
+#define LGW_REGI_TIMESTAMP_TIMESTAMP_SET0_TIMESTAMP 0x610C, 0, 8, 0, 0
+#define LGW_REGI_TIMESTAMP_TIMESTAMP_IRQ_3_TIMESTAMP 0x610D, 0, 8, 0, 0
+#define LGW_REGI_TIMESTAMP_TIMESTAMP_IRQ_2_TIMESTAMP 0x610E, 0, 8, 0, 0
+#define LGW_REGI_TIMESTAMP_TIMESTAMP_IRQ_1_TIMESTAMP 0x610F, 0, 8, 0, 0
+#define LGW_REGI_TIMESTAMP_TIMESTAMP_IRQ_0_TIMESTAMP 0x6110, 0, 8, 0, 0
+#define LGW_REGI_TIMESTAMP_DUMMY_DUMMY 0x6111, 0, 1, 0, 1
+#define LGW_REGI_RX_TOP_FREQ_0_MSB_IF_FREQ_0 0x5800, 0, 5, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_0_LSB_IF_FREQ_0 0x5801, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_1_MSB_IF_FREQ_1 0x5802, 0, 5, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_1_LSB_IF_FREQ_1 0x5803, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_2_MSB_IF_FREQ_2 0x5804, 0, 5, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_2_LSB_IF_FREQ_2 0x5805, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_3_MSB_IF_FREQ_3 0x5806, 0, 5, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_3_LSB_IF_FREQ_3 0x5807, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_4_MSB_IF_FREQ_4 0x5808, 0, 5, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_4_LSB_IF_FREQ_4 0x5809, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_5_MSB_IF_FREQ_5 0x580A, 0, 5, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_5_LSB_IF_FREQ_5 0x580B, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_6_MSB_IF_FREQ_6 0x580C, 0, 5, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_6_LSB_IF_FREQ_6 0x580D, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_7_MSB_IF_FREQ_7 0x580E, 0, 5, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_7_LSB_IF_FREQ_7 0x580F, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_RADIO_SELECT_RADIO_SELECT 0x5810, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_RSSI_CONTROL_RSSI_FILTER_ALPHA 0x5811, 3, 5, 0, 0
+#define LGW_REGI_RX_TOP_RSSI_CONTROL_SELECT_RSSI 0x5811, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_RSSI_DEF_VALUE_CHAN_RSSI_DEF_VALUE 0x5812, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_CHANN_DAGC_CFG1_CHAN_DAGC_THRESHOLD_HIGH 0x5813, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_CHANN_DAGC_CFG2_CHAN_DAGC_THRESHOLD_LOW 0x5814, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_CHANN_DAGC_CFG3_CHAN_DAGC_MAX_ATTEN 0x5815, 4, 4, 0, 0
+#define LGW_REGI_RX_TOP_CHANN_DAGC_CFG3_CHAN_DAGC_MIN_ATTEN 0x5815, 0, 4, 0, 0
+#define LGW_REGI_RX_TOP_CHANN_DAGC_CFG4_CHAN_DAGC_STEP 0x5816, 0, 4, 0, 0
+#define LGW_REGI_RX_TOP_CHANN_DAGC_CFG5_CHAN_DAGC_MODE 0x5817, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_RSSI_VALUE_CHAN_RSSI 0x5818, 0, 8, 0, 1
+#define LGW_REGI_RX_TOP_GAIN_CONTROL_CHAN_GAIN_VALID 0x5819, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_GAIN_CONTROL_CHAN_GAIN 0x5819, 0, 4, 0, 0
+#define LGW_REGI_RX_TOP_CLK_CONTROL_CHAN_CLK_EN 0x581A, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_DUMMY0_DUMMY0 0x581B, 0, 1, 0, 1
+#define LGW_REGI_RX_TOP_CORR_CLOCK_ENABLE_CLK_EN 0x5820, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_CORRELATOR_EN_CORR_EN 0x5821, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_CORRELATOR_SF_EN_CORR_SF_EN 0x5822, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_CORRELATOR_ENABLE_ONLY_FIRST_DET_EDGE_ENABLE_ONLY_FIRST_DET_EDGE 0x5823, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_CORRELATOR_ENABLE_ACC_CLEAR_ENABLE_CORR_ACC_CLEAR 0x5824, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_SF5_CFG1_ACC_WIN_LEN 0x5825, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF5_CFG1_ACC_PEAK_SUM_EN 0x5825, 5, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF5_CFG1_ACC_PEAK_POS_SEL 0x5825, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF5_CFG1_ACC_COEFF 0x5825, 2, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF5_CFG1_ACC_AUTO_RESCALE 0x5825, 1, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF5_CFG1_ACC_2_SAME_PEAKS 0x5825, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF5_CFG2_ACC_MIN2 0x5826, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF5_CFG2_ACC_PNR 0x5826, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_SF5_CFG3_MIN_SINGLE_PEAK 0x5827, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_SF5_CFG4_MSP_PNR 0x5828, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_SF5_CFG5_MSP2_PNR 0x5829, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_SF5_CFG6_MSP_PEAK_NB 0x582A, 3, 3, 0, 0
+#define LGW_REGI_RX_TOP_SF5_CFG6_MSP_CNT_MODE 0x582A, 1, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF5_CFG6_MSP_POS_SEL 0x582A, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF5_CFG7_MSP2_PEAK_NB 0x582B, 2, 3, 0, 0
+#define LGW_REGI_RX_TOP_SF5_CFG7_NOISE_COEFF 0x582B, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF6_CFG1_ACC_WIN_LEN 0x582C, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF6_CFG1_ACC_PEAK_SUM_EN 0x582C, 5, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF6_CFG1_ACC_PEAK_POS_SEL 0x582C, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF6_CFG1_ACC_COEFF 0x582C, 2, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF6_CFG1_ACC_AUTO_RESCALE 0x582C, 1, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF6_CFG1_ACC_2_SAME_PEAKS 0x582C, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF6_CFG2_ACC_MIN2 0x582D, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF6_CFG2_ACC_PNR 0x582D, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_SF6_CFG3_MIN_SINGLE_PEAK 0x582E, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_SF6_CFG4_MSP_PNR 0x582F, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_SF6_CFG5_MSP2_PNR 0x5830, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_SF6_CFG6_MSP_PEAK_NB 0x5831, 3, 3, 0, 0
+#define LGW_REGI_RX_TOP_SF6_CFG6_MSP_CNT_MODE 0x5831, 1, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF6_CFG6_MSP_POS_SEL 0x5831, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF6_CFG7_MSP2_PEAK_NB 0x5832, 2, 3, 0, 0
+#define LGW_REGI_RX_TOP_SF6_CFG7_NOISE_COEFF 0x5832, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF7_CFG1_ACC_WIN_LEN 0x5833, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF7_CFG1_ACC_PEAK_SUM_EN 0x5833, 5, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF7_CFG1_ACC_PEAK_POS_SEL 0x5833, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF7_CFG1_ACC_COEFF 0x5833, 2, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF7_CFG1_ACC_AUTO_RESCALE 0x5833, 1, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF7_CFG1_ACC_2_SAME_PEAKS 0x5833, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF7_CFG2_ACC_MIN2 0x5834, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF7_CFG2_ACC_PNR 0x5834, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_SF7_CFG3_MIN_SINGLE_PEAK 0x5835, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_SF7_CFG4_MSP_PNR 0x5836, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_SF7_CFG5_MSP2_PNR 0x5837, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_SF7_CFG6_MSP_PEAK_NB 0x5838, 3, 3, 0, 0
+#define LGW_REGI_RX_TOP_SF7_CFG6_MSP_CNT_MODE 0x5838, 1, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF7_CFG6_MSP_POS_SEL 0x5838, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF7_CFG7_MSP2_PEAK_NB 0x5839, 2, 3, 0, 0
+#define LGW_REGI_RX_TOP_SF7_CFG7_NOISE_COEFF 0x5839, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF8_CFG1_ACC_WIN_LEN 0x583A, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF8_CFG1_ACC_PEAK_SUM_EN 0x583A, 5, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF8_CFG1_ACC_PEAK_POS_SEL 0x583A, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF8_CFG1_ACC_COEFF 0x583A, 2, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF8_CFG1_ACC_AUTO_RESCALE 0x583A, 1, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF8_CFG1_ACC_2_SAME_PEAKS 0x583A, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF8_CFG2_ACC_MIN2 0x583B, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF8_CFG2_ACC_PNR 0x583B, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_SF8_CFG3_MIN_SINGLE_PEAK 0x583C, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_SF8_CFG4_MSP_PNR 0x583D, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_SF8_CFG5_MSP2_PNR 0x583E, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_SF8_CFG6_MSP_PEAK_NB 0x583F, 3, 3, 0, 0
+#define LGW_REGI_RX_TOP_SF8_CFG6_MSP_CNT_MODE 0x583F, 1, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF8_CFG6_MSP_POS_SEL 0x583F, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF8_CFG7_MSP2_PEAK_NB 0x5840, 2, 3, 0, 0
+#define LGW_REGI_RX_TOP_SF8_CFG7_NOISE_COEFF 0x5840, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF9_CFG1_ACC_WIN_LEN 0x5841, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF9_CFG1_ACC_PEAK_SUM_EN 0x5841, 5, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF9_CFG1_ACC_PEAK_POS_SEL 0x5841, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF9_CFG1_ACC_COEFF 0x5841, 2, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF9_CFG1_ACC_AUTO_RESCALE 0x5841, 1, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF9_CFG1_ACC_2_SAME_PEAKS 0x5841, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF9_CFG2_ACC_MIN2 0x5842, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF9_CFG2_ACC_PNR 0x5842, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_SF9_CFG3_MIN_SINGLE_PEAK 0x5843, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_SF9_CFG4_MSP_PNR 0x5844, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_SF9_CFG5_MSP2_PNR 0x5845, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_SF9_CFG6_MSP_PEAK_NB 0x5846, 3, 3, 0, 0
+#define LGW_REGI_RX_TOP_SF9_CFG6_MSP_CNT_MODE 0x5846, 1, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF9_CFG6_MSP_POS_SEL 0x5846, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF9_CFG7_MSP2_PEAK_NB 0x5847, 2, 3, 0, 0
+#define LGW_REGI_RX_TOP_SF9_CFG7_NOISE_COEFF 0x5847, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF10_CFG1_ACC_WIN_LEN 0x5848, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF10_CFG1_ACC_PEAK_SUM_EN 0x5848, 5, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF10_CFG1_ACC_PEAK_POS_SEL 0x5848, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF10_CFG1_ACC_COEFF 0x5848, 2, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF10_CFG1_ACC_AUTO_RESCALE 0x5848, 1, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF10_CFG1_ACC_2_SAME_PEAKS 0x5848, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF10_CFG2_ACC_MIN2 0x5849, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF10_CFG2_ACC_PNR 0x5849, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_SF10_CFG3_MIN_SINGLE_PEAK 0x584A, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_SF10_CFG4_MSP_PNR 0x584B, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_SF10_CFG5_MSP2_PNR 0x584C, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_SF10_CFG6_MSP_PEAK_NB 0x584D, 3, 3, 0, 0
+#define LGW_REGI_RX_TOP_SF10_CFG6_MSP_CNT_MODE 0x584D, 1, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF10_CFG6_MSP_POS_SEL 0x584D, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF10_CFG7_MSP2_PEAK_NB 0x584E, 2, 3, 0, 0
+#define LGW_REGI_RX_TOP_SF10_CFG7_NOISE_COEFF 0x584E, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF11_CFG1_ACC_WIN_LEN 0x584F, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF11_CFG1_ACC_PEAK_SUM_EN 0x584F, 5, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF11_CFG1_ACC_PEAK_POS_SEL 0x584F, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF11_CFG1_ACC_COEFF 0x584F, 2, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF11_CFG1_ACC_AUTO_RESCALE 0x584F, 1, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF11_CFG1_ACC_2_SAME_PEAKS 0x584F, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF11_CFG2_ACC_MIN2 0x5850, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF11_CFG2_ACC_PNR 0x5850, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_SF11_CFG3_MIN_SINGLE_PEAK 0x5851, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_SF11_CFG4_MSP_PNR 0x5852, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_SF11_CFG5_MSP2_PNR 0x5853, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_SF11_CFG6_MSP_PEAK_NB 0x5854, 3, 3, 0, 0
+#define LGW_REGI_RX_TOP_SF11_CFG6_MSP_CNT_MODE 0x5854, 1, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF11_CFG6_MSP_POS_SEL 0x5854, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF11_CFG7_MSP2_PEAK_NB 0x5855, 2, 3, 0, 0
+#define LGW_REGI_RX_TOP_SF11_CFG7_NOISE_COEFF 0x5855, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF12_CFG1_ACC_WIN_LEN 0x5856, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF12_CFG1_ACC_PEAK_SUM_EN 0x5856, 5, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF12_CFG1_ACC_PEAK_POS_SEL 0x5856, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF12_CFG1_ACC_COEFF 0x5856, 2, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF12_CFG1_ACC_AUTO_RESCALE 0x5856, 1, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF12_CFG1_ACC_2_SAME_PEAKS 0x5856, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF12_CFG2_ACC_MIN2 0x5857, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF12_CFG2_ACC_PNR 0x5857, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_SF12_CFG3_MIN_SINGLE_PEAK 0x5858, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_SF12_CFG4_MSP_PNR 0x5859, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_SF12_CFG5_MSP2_PNR 0x585A, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_SF12_CFG6_MSP_PEAK_NB 0x585B, 3, 3, 0, 0
+#define LGW_REGI_RX_TOP_SF12_CFG6_MSP_CNT_MODE 0x585B, 1, 2, 0, 0
+#define LGW_REGI_RX_TOP_SF12_CFG6_MSP_POS_SEL 0x585B, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_SF12_CFG7_MSP2_PEAK_NB 0x585C, 2, 3, 0, 0
+#define LGW_REGI_RX_TOP_SF12_CFG7_NOISE_COEFF 0x585C, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_DUMMY1_DUMMY1 0x585D, 0, 1, 0, 1
+#define LGW_REGI_RX_TOP_DC_NOTCH_CFG1_BW_START 0x5860, 4, 3, 0, 0
+#define LGW_REGI_RX_TOP_DC_NOTCH_CFG1_AUTO_BW_RED 0x5860, 3, 1, 0, 0
+#define LGW_REGI_RX_TOP_DC_NOTCH_CFG1_NO_FAST_START 0x5860, 2, 1, 0, 0
+#define LGW_REGI_RX_TOP_DC_NOTCH_CFG1_BYPASS 0x5860, 1, 1, 0, 0
+#define LGW_REGI_RX_TOP_DC_NOTCH_CFG1_ENABLE 0x5860, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_DC_NOTCH_CFG2_BW_LOCKED 0x5861, 3, 3, 0, 0
+#define LGW_REGI_RX_TOP_DC_NOTCH_CFG2_BW 0x5861, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_DC_NOTCH_CFG3_BW_RED 0x5862, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_DC_NOTCH_CFG4_IIR_DCC_TIME 0x5863, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_RX_DFE_FIR1_0_FIR1_COEFF_0 0x5864, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_RX_DFE_FIR1_1_FIR1_COEFF_1 0x5865, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_RX_DFE_FIR1_2_FIR1_COEFF_2 0x5866, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_RX_DFE_FIR1_3_FIR1_COEFF_3 0x5867, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_RX_DFE_FIR1_4_FIR1_COEFF_4 0x5868, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_RX_DFE_FIR1_5_FIR1_COEFF_5 0x5869, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_RX_DFE_FIR1_6_FIR1_COEFF_6 0x586A, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_RX_DFE_FIR1_7_FIR1_COEFF_7 0x586B, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_RX_DFE_FIR2_0_FIR2_COEFF_0 0x586C, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_RX_DFE_FIR2_1_FIR2_COEFF_1 0x586D, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_RX_DFE_FIR2_2_FIR2_COEFF_2 0x586E, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_RX_DFE_FIR2_3_FIR2_COEFF_3 0x586F, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_RX_DFE_FIR2_4_FIR2_COEFF_4 0x5870, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_RX_DFE_FIR2_5_FIR2_COEFF_5 0x5871, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_RX_DFE_FIR2_6_FIR2_COEFF_6 0x5872, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_RX_DFE_FIR2_7_FIR2_COEFF_7 0x5873, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_RX_DFE_AGC0_RADIO_GAIN_RED_SEL 0x5874, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_RX_DFE_AGC0_RADIO_GAIN_RED_DB 0x5874, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_RX_DFE_AGC1_DC_COMP_EN 0x5875, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_RX_DFE_AGC1_FORCE_DEFAULT_FIR 0x5875, 3, 1, 0, 0
+#define LGW_REGI_RX_TOP_RX_DFE_AGC1_RSSI_EARLY_LATCH 0x5875, 2, 1, 0, 0
+#define LGW_REGI_RX_TOP_RX_DFE_AGC1_FREEZE_ON_SYNC 0x5875, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_RX_DFE_AGC2_DAGC_IN_COMP 0x5876, 6, 1, 0, 0
+#define LGW_REGI_RX_TOP_RX_DFE_AGC2_DAGC_FIR_HYST 0x5876, 5, 1, 0, 0
+#define LGW_REGI_RX_TOP_RX_DFE_AGC2_RSSI_MAX_SAMPLE 0x5876, 3, 2, 0, 0
+#define LGW_REGI_RX_TOP_RX_DFE_AGC2_RSSI_MIN_SAMPLE 0x5876, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_RX_DFE_GAIN0_DAGC_FIR_FAST 0x5877, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_RX_DFE_GAIN0_FORCE_GAIN_FIR 0x5877, 6, 1, 0, 0
+#define LGW_REGI_RX_TOP_RX_DFE_GAIN0_GAIN_FIR1 0x5877, 4, 2, 0, 0
+#define LGW_REGI_RX_TOP_RX_DFE_GAIN0_GAIN_FIR2 0x5877, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_DAGC_CFG_TARGET_LVL 0x5878, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_DAGC_CFG_GAIN_INCR_STEP 0x5878, 5, 1, 0, 0
+#define LGW_REGI_RX_TOP_DAGC_CFG_GAIN_DROP_COMP 0x5878, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_DAGC_CFG_COMB_FILTER_EN 0x5878, 3, 1, 0, 0
+#define LGW_REGI_RX_TOP_DAGC_CFG_NO_FREEZE_START 0x5878, 2, 1, 0, 0
+#define LGW_REGI_RX_TOP_DAGC_CFG_FREEZE_ON_SYNC 0x5878, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_DAGC_CNT0_SAMPLE 0x5879, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_DAGC_CNT1_THR_M6 0x587A, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_DAGC_CNT2_THR_M12 0x587B, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_DAGC_CNT3_THR_M18 0x587C, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_DAGC_CNT4_GAIN 0x587D, 4, 4, 0, 0
+#define LGW_REGI_RX_TOP_DAGC_CNT4_FORCE_GAIN 0x587D, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG1_PPM_OFFSET_HDR_CTRL 0x587E, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG1_PPM_OFFSET 0x587E, 4, 2, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG1_MODEM_EN 0x587E, 3, 1, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG1_CODING_RATE 0x587E, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG2_MODEM_START 0x587F, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG2_CADRXTX 0x587F, 2, 2, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG2_IMPLICIT_HEADER 0x587F, 1, 1, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG2_CRC_EN 0x587F, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG3_PAYLOAD_LENGTH 0x5880, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG4_INT_STEP_ORIDE_EN 0x5881, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG4_INT_STEP_ORIDE 0x5881, 0, 6, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG5_HEADER_DIFF_MODE 0x5882, 6, 1, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG5_ZERO_PAD 0x5882, 0, 6, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG6_PREAMBLE_SYMB_NB 0x5883, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG7_PREAMBLE_SYMB_NB 0x5884, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG8_AUTO_ACK_INT_DELAY 0x5885, 3, 1, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG8_AUTO_ACK_RX 0x5885, 2, 1, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG8_AUTO_ACK_TX 0x5885, 1, 1, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG8_POST_PREAMBLE_GAP_LONG 0x5885, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG9_FINE_SYNCH_EN_SF12 0x5886, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG9_FINE_SYNCH_EN_SF11 0x5886, 6, 1, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG9_FINE_SYNCH_EN_SF10 0x5886, 5, 1, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG9_FINE_SYNCH_EN_SF9 0x5886, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG9_FINE_SYNCH_EN_SF8 0x5886, 3, 1, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG9_FINE_SYNCH_EN_SF7 0x5886, 2, 1, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG9_FINE_SYNCH_EN_SF6 0x5886, 1, 1, 0, 0
+#define LGW_REGI_RX_TOP_TXRX_CFG9_FINE_SYNCH_EN_SF5 0x5886, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_RX_CFG0_DFT_PEAK_EN 0x5887, 4, 2, 0, 0
+#define LGW_REGI_RX_TOP_RX_CFG0_CHIRP_INVERT 0x5887, 2, 1, 0, 0
+#define LGW_REGI_RX_TOP_RX_CFG0_SWAP_IQ 0x5887, 1, 1, 0, 0
+#define LGW_REGI_RX_TOP_RX_CFG0_CONTINUOUS 0x5887, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_RX_CFG1_DETECT_TIMEOUT 0x5888, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_RX_CFG2_CLK_EN_RESYNC_DIN 0x5889, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_RX_CFG2_LLR_SCALE 0x5889, 0, 4, 0, 0
+#define LGW_REGI_RX_TOP_FRAME_SYNCH0_SF5_PEAK1_POS_SF5 0x588A, 0, 5, 1, 0
+#define LGW_REGI_RX_TOP_FRAME_SYNCH1_SF5_PEAK2_POS_SF5 0x588B, 0, 5, 1, 0
+#define LGW_REGI_RX_TOP_FRAME_SYNCH0_SF6_PEAK1_POS_SF6 0x588C, 0, 5, 1, 0
+#define LGW_REGI_RX_TOP_FRAME_SYNCH1_SF6_PEAK2_POS_SF6 0x588D, 0, 5, 1, 0
+#define LGW_REGI_RX_TOP_FRAME_SYNCH0_SF7TO12_PEAK1_POS_SF7TO12 0x588E, 0, 5, 1, 0
+#define LGW_REGI_RX_TOP_FRAME_SYNCH1_SF7TO12_PEAK2_POS_SF7TO12 0x588F, 0, 5, 1, 0
+#define LGW_REGI_RX_TOP_FRAME_SYNCH2_FINETIME_ON_LAST 0x5890, 5, 1, 0, 0
+#define LGW_REGI_RX_TOP_FRAME_SYNCH2_AUTO_SCALE 0x5890, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_FRAME_SYNCH2_DROP_ON_SYNCH 0x5890, 3, 1, 0, 0
+#define LGW_REGI_RX_TOP_FRAME_SYNCH2_GAIN 0x5890, 2, 1, 0, 0
+#define LGW_REGI_RX_TOP_FRAME_SYNCH2_TIMEOUT_OPT 0x5890, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_A_0_GAIN_P_HDR_RED 0x5891, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_A_0_ROUNDING 0x5891, 6, 1, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_A_0_POS_LIMIT 0x5891, 4, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_A_0_SUM_SIZE 0x5891, 2, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_A_0_MODE 0x5891, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_A_1_GAIN_P_AUTO 0x5892, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_A_1_GAIN_P_PAYLOAD 0x5892, 3, 3, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_A_1_GAIN_P_PREAMB 0x5892, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_A_2_GAIN_I_AUTO 0x5893, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_A_2_GAIN_I_PAYLOAD 0x5893, 3, 3, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_A_2_GAIN_I_PREAMB 0x5893, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_A_3_FINESYNCH_SUM 0x5894, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_A_3_FINESYNCH_GAIN 0x5894, 4, 3, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_A_4_GAIN_I_EN_SF8 0x5895, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_A_4_GAIN_I_EN_SF7 0x5895, 4, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_A_4_GAIN_I_EN_SF6 0x5895, 2, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_A_4_GAIN_I_EN_SF5 0x5895, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_A_5_GAIN_I_EN_SF12 0x5896, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_A_5_GAIN_I_EN_SF11 0x5896, 4, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_A_5_GAIN_I_EN_SF10 0x5896, 2, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_A_5_GAIN_I_EN_SF9 0x5896, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_A_6_GAIN_P_PREAMB_SF12 0x5897, 4, 3, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_A_6_GAIN_P_PREAMB_SF5_6 0x5897, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_7_GAIN_I_AUTO_MAX 0x5898, 4, 3, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_7_GAIN_P_AUTO_MAX 0x5898, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_B_0_GAIN_P_HDR_RED 0x5899, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_B_0_ROUNDING 0x5899, 6, 1, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_B_0_POS_LIMIT 0x5899, 4, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_B_0_SUM_SIZE 0x5899, 2, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_B_0_MODE 0x5899, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_B_1_GAIN_P_AUTO 0x589A, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_B_1_GAIN_P_PAYLOAD 0x589A, 3, 3, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_B_1_GAIN_P_PREAMB 0x589A, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_B_2_GAIN_I_AUTO 0x589B, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_B_2_GAIN_I_PAYLOAD 0x589B, 3, 3, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_B_2_GAIN_I_PREAMB 0x589B, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_B_3_FINESYNCH_SUM 0x589C, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_B_3_FINESYNCH_GAIN 0x589C, 4, 3, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_B_4_GAIN_I_EN_SF8 0x589D, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_B_4_GAIN_I_EN_SF7 0x589D, 4, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_B_4_GAIN_I_EN_SF6 0x589D, 2, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_B_4_GAIN_I_EN_SF5 0x589D, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_B_5_GAIN_I_EN_SF12 0x589E, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_B_5_GAIN_I_EN_SF11 0x589E, 4, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_B_5_GAIN_I_EN_SF10 0x589E, 2, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_B_5_GAIN_I_EN_SF9 0x589E, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_B_6_GAIN_P_PREAMB_SF12 0x589F, 4, 3, 0, 0
+#define LGW_REGI_RX_TOP_FINE_TIMING_B_6_GAIN_P_PREAMB_SF5_6 0x589F, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TO_TIME0_FREQ_TO_TIME_DRIFT_MANT 0x58A0, 0, 4, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TO_TIME1_FREQ_TO_TIME_DRIFT_MANT 0x58A1, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TO_TIME2_FREQ_TO_TIME_DRIFT_EXP 0x58A2, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TO_TIME3_FREQ_TO_TIME_INVERT_FREQ_DELTA 0x58A3, 5, 1, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TO_TIME3_FREQ_TO_TIME_INVERT_FINE_DELTA 0x58A3, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TO_TIME3_FREQ_TO_TIME_INVERT_FREQ_ERROR 0x58A3, 3, 1, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TO_TIME3_FREQ_TO_TIME_INVERT_TIME_SYMB 0x58A3, 2, 1, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TO_TIME3_FREQ_TO_TIME_INVERT_TIME_OFFSET 0x58A3, 1, 1, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TO_TIME3_FREQ_TO_TIME_INVERT_DETECT 0x58A3, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TO_TIME4_FREQ_TO_TIME_INVERT_RNG 0x58A4, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TRACK_A_0_FREQ_TRACK_EN_SF8 0x58A5, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TRACK_A_0_FREQ_TRACK_EN_SF7 0x58A5, 4, 2, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TRACK_A_0_FREQ_TRACK_EN_SF6 0x58A5, 2, 2, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TRACK_A_0_FREQ_TRACK_EN_SF5 0x58A5, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TRACK_A_1_FREQ_TRACK_EN_SF12 0x58A6, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TRACK_A_1_FREQ_TRACK_EN_SF11 0x58A6, 4, 2, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TRACK_A_1_FREQ_TRACK_EN_SF10 0x58A6, 2, 2, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TRACK_A_1_FREQ_TRACK_EN_SF9 0x58A6, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TRACK_B_0_FREQ_TRACK_EN_SF8 0x58A7, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TRACK_B_0_FREQ_TRACK_EN_SF7 0x58A7, 4, 2, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TRACK_B_0_FREQ_TRACK_EN_SF6 0x58A7, 2, 2, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TRACK_B_0_FREQ_TRACK_EN_SF5 0x58A7, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TRACK_B_1_FREQ_TRACK_EN_SF12 0x58A8, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TRACK_B_1_FREQ_TRACK_EN_SF11 0x58A8, 4, 2, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TRACK_B_1_FREQ_TRACK_EN_SF10 0x58A8, 2, 2, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TRACK_B_1_FREQ_TRACK_EN_SF9 0x58A8, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TRACK2_FREQ_TRACK_FINE 0x58A9, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TRACK2_FREQ_TRACK_HDR_SKIP 0x58A9, 4, 3, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TRACK3_FREQ_SYNCH_GAIN 0x58AA, 4, 3, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TRACK3_FREQ_TRACK_AUTO_THR 0x58AA, 0, 4, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TRACK4_SNR_MIN_WINDOW 0x58AB, 5, 2, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TRACK4_GAIN_AUTO_SNR_MIN 0x58AB, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_FREQ_TRACK4_FREQ_SYNCH_THR 0x58AB, 0, 4, 0, 0
+#define LGW_REGI_RX_TOP_DETECT_MSP0_MSP_PNR 0x58AC, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_DETECT_MSP1_MSP2_PNR 0x58AD, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_DETECT_MSP2_MSP2_PEAK_NB 0x58AE, 4, 3, 0, 0
+#define LGW_REGI_RX_TOP_DETECT_MSP2_MSP_PEAK_NB 0x58AE, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_DETECT_MSP3_ACC_MIN2 0x58AF, 6, 1, 0, 0
+#define LGW_REGI_RX_TOP_DETECT_MSP3_ACC_WIN_LEN 0x58AF, 4, 2, 0, 0
+#define LGW_REGI_RX_TOP_DETECT_MSP3_MSP_POS_SEL 0x58AF, 2, 1, 0, 0
+#define LGW_REGI_RX_TOP_DETECT_MSP3_MSP_CNT_MODE 0x58AF, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_DETECT_ACC1_USE_GAIN_SYMB 0x58B0, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_DETECT_ACC1_ACC_PNR 0x58B0, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_DETECT_ACC2_NOISE_COEFF 0x58B1, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_DETECT_ACC2_ACC_COEFF 0x58B1, 4, 2, 0, 0
+#define LGW_REGI_RX_TOP_DETECT_ACC2_ACC_2_SAME_PEAKS 0x58B1, 3, 1, 0, 0
+#define LGW_REGI_RX_TOP_DETECT_ACC2_ACC_AUTO_RESCALE 0x58B1, 2, 1, 0, 0
+#define LGW_REGI_RX_TOP_DETECT_ACC2_ACC_PEAK_POS_SEL 0x58B1, 1, 1, 0, 0
+#define LGW_REGI_RX_TOP_DETECT_ACC2_ACC_PEAK_SUM_EN 0x58B1, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_DETECT_ACC3_MIN_SINGLE_PEAK 0x58B2, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_TIMESTAMP_SEL_SNR_MIN 0x58B3, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_TIMESTAMP_ENABLE 0x58B3, 3, 1, 0, 0
+#define LGW_REGI_RX_TOP_TIMESTAMP_NB_SYMB 0x58B3, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_MODEM_BUSY_MSB_RX_MODEM_BUSY 0x58B4, 0, 8, 0, 1
+#define LGW_REGI_RX_TOP_MODEM_BUSY_LSB_RX_MODEM_BUSY 0x58B5, 0, 8, 0, 1
+#define LGW_REGI_RX_TOP_MODEM_STATE_RX_MODEM_STS_SPARE 0x58B6, 4, 4, 0, 1
+#define LGW_REGI_RX_TOP_MODEM_STATE_RX_MODEM_STATE 0x58B6, 0, 4, 0, 1
+#define LGW_REGI_RX_TOP_MODEM_SYNC_DELTA_MSB_PEAK_POS_FINE_GAIN_H 0x58B7, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_MODEM_SYNC_DELTA_MSB_PEAK_POS_FINE_GAIN_L 0x58B7, 4, 2, 0, 0
+#define LGW_REGI_RX_TOP_MODEM_SYNC_DELTA_MSB_PEAK_POS_FINE_SIGN 0x58B7, 3, 1, 0, 0
+#define LGW_REGI_RX_TOP_MODEM_SYNC_DELTA_MSB_MODEM_SYNC_DELTA 0x58B7, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_MODEM_SYNC_DELTA_LSB_MODEM_SYNC_DELTA 0x58B8, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_MODEM_PPM_OFFSET1_PPM_OFFSET_SF8 0x58B9, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_MODEM_PPM_OFFSET1_PPM_OFFSET_SF7 0x58B9, 4, 2, 0, 0
+#define LGW_REGI_RX_TOP_MODEM_PPM_OFFSET1_PPM_OFFSET_SF6 0x58B9, 2, 2, 0, 0
+#define LGW_REGI_RX_TOP_MODEM_PPM_OFFSET1_PPM_OFFSET_SF5 0x58B9, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_MODEM_PPM_OFFSET2_PPM_OFFSET_SF12 0x58BA, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_MODEM_PPM_OFFSET2_PPM_OFFSET_SF11 0x58BA, 4, 2, 0, 0
+#define LGW_REGI_RX_TOP_MODEM_PPM_OFFSET2_PPM_OFFSET_SF10 0x58BA, 2, 2, 0, 0
+#define LGW_REGI_RX_TOP_MODEM_PPM_OFFSET2_PPM_OFFSET_SF9 0x58BA, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_MODEM_CLOCK_GATE_OVERRIDE_3_CLK_OVERRIDE 0x58BB, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_MODEM_CLOCK_GATE_OVERRIDE_2_CLK_OVERRIDE 0x58BC, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_MODEM_CLOCK_GATE_OVERRIDE_1_CLK_OVERRIDE 0x58BD, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_MODEM_CLOCK_GATE_OVERRIDE_0_CLK_OVERRIDE 0x58BE, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_DUMMY2_DUMMY2 0x58BF, 0, 1, 0, 1
+#define LGW_REGI_RX_TOP_RX_BUFFER_DEBUG_MODE 0x58C0, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_RX_BUFFER_DIRECT_RAM_IF 0x58C0, 3, 1, 0, 0
+#define LGW_REGI_RX_TOP_RX_BUFFER_LEGACY_TIMESTAMP 0x58C0, 2, 1, 0, 0
+#define LGW_REGI_RX_TOP_RX_BUFFER_STORE_HEADER_ERR_META 0x58C0, 1, 1, 0, 0
+#define LGW_REGI_RX_TOP_RX_BUFFER_STORE_SYNC_FAIL_META 0x58C0, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_RX_BUFFER_TIMESTAMP_CFG_MAX_TS_METRICS 0x58C1, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_RX_BUFFER_IRQ_CTRL_MSB_RX_BUFFER_IRQ_THRESHOLD 0x58C2, 0, 5, 0, 0
+#define LGW_REGI_RX_TOP_RX_BUFFER_IRQ_CTRL_LSB_RX_BUFFER_IRQ_THRESHOLD 0x58C3, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_RX_BUFFER_LAST_ADDR_READ_MSB_LAST_ADDR_READ 0x58C4, 0, 4, 0, 1
+#define LGW_REGI_RX_TOP_RX_BUFFER_LAST_ADDR_READ_LSB_LAST_ADDR_READ 0x58C5, 0, 8, 0, 1
+#define LGW_REGI_RX_TOP_RX_BUFFER_LAST_ADDR_WRITE_MSB_LAST_ADDR_WRITE 0x58C6, 0, 4, 0, 1
+#define LGW_REGI_RX_TOP_RX_BUFFER_LAST_ADDR_WRITE_LSB_LAST_ADDR_WRITE 0x58C7, 0, 8, 0, 1
+#define LGW_REGI_RX_TOP_RX_BUFFER_NB_BYTES_MSB_RX_BUFFER_NB_BYTES 0x58C8, 0, 5, 0, 1
+#define LGW_REGI_RX_TOP_RX_BUFFER_NB_BYTES_LSB_RX_BUFFER_NB_BYTES 0x58C9, 0, 8, 0, 1
+#define LGW_REGI_RX_TOP_MULTI_SF_SYNC_ERR_PKT_CNT_MULTI_SF_SYNC_ERR_PKTS 0x58CA, 0, 8, 0, 1
+#define LGW_REGI_RX_TOP_MULTI_SF_PLD_ERR_PKT_CNT_MULTI_SF_PLD_ERR_PKTS 0x58CB, 0, 8, 0, 1
+#define LGW_REGI_RX_TOP_MULTI_SF_GOOD_PKT_CNT_MULTI_SF_GOOD_PKTS 0x58CC, 0, 8, 0, 1
+#define LGW_REGI_RX_TOP_SERV_MODEM_SYNC_ERR_PKT_CNT_SERV_MODEM_SYNC_ERR_PKTS 0x58CD, 0, 8, 0, 1
+#define LGW_REGI_RX_TOP_SERV_MODEM_PLD_ERR_PKT_CNT_SERV_MODEM_PLD_ERR_PKTS 0x58CE, 0, 8, 0, 1
+#define LGW_REGI_RX_TOP_SERV_MODEM_GOOD_PKT_CNT_SERV_MODEM_GOOD_PKTS 0x58CF, 0, 8, 0, 1
+#define LGW_REGI_RX_TOP_GFSK_MODEM_SYNC_ERR_PKT_CNT_GFSK_MODEM_SYNC_ERR_PKTS 0x58D0, 0, 8, 0, 1
+#define LGW_REGI_RX_TOP_GFSK_MODEM_PLD_ERR_PKT_CNT_GFSK_MODEM_PLD_ERR_PKTS 0x58D1, 0, 8, 0, 1
+#define LGW_REGI_RX_TOP_GFSK_MODEM_GOOD_PKT_CNT_GFSK_MODEM_GOOD_PKTS 0x58D2, 0, 8, 0, 1
+#define LGW_REGI_RX_TOP_BAD_MODEM_ID_WRITE_0_BAD_MODEM_ID_WRITE 0x58D3, 0, 2, 0, 1
+#define LGW_REGI_RX_TOP_BAD_MODEM_ID_WRITE_1_BAD_MODEM_ID_WRITE 0x58D4, 0, 8, 0, 1
+#define LGW_REGI_RX_TOP_BAD_MODEM_ID_WRITE_2_BAD_MODEM_ID_WRITE 0x58D5, 0, 8, 0, 1
+#define LGW_REGI_RX_TOP_BAD_MODEM_ID_READ_0_BAD_MODEM_ID_READ 0x58D6, 0, 2, 0, 1
+#define LGW_REGI_RX_TOP_BAD_MODEM_ID_READ_1_BAD_MODEM_ID_READ 0x58D7, 0, 8, 0, 1
+#define LGW_REGI_RX_TOP_BAD_MODEM_ID_READ_2_BAD_MODEM_ID_READ 0x58D8, 0, 8, 0, 1
+#define LGW_REGI_RX_TOP_CLOCK_GATE_OVERRIDE_0_CLK_OVERRIDE 0x58D9, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_SAMPLE_4_MSPS_LATCHED_125K_SAMPLE_4_MSPS_LATCHED_125K 0x58DA, 0, 8, 0, 1
+#define LGW_REGI_RX_TOP_DUMMY3_DUMMY3 0x58DB, 0, 1, 0, 1
+#define LGW_REGI_ARB_MCU_CTRL_CLK_EN 0x6080, 5, 1, 0, 0
+#define LGW_REGI_ARB_MCU_CTRL_RADIO_RST 0x6080, 4, 1, 0, 0
+#define LGW_REGI_ARB_MCU_CTRL_FORCE_HOST_FE_CTRL 0x6080, 3, 1, 0, 0
+#define LGW_REGI_ARB_MCU_CTRL_MCU_CLEAR 0x6080, 2, 1, 0, 0
+#define LGW_REGI_ARB_MCU_CTRL_HOST_PROG 0x6080, 1, 1, 0, 0
+#define LGW_REGI_ARB_MCU_CTRL_PARITY_ERROR 0x6080, 0, 1, 0, 1
+#define LGW_REGI_ARB_MCU_MCU_ARB_STATUS_MCU_ARB_STATUS 0x6081, 0, 8, 0, 1
+#define LGW_REGI_ARB_MCU_UART_CFG_MSBF 0x6087, 5, 1, 0, 0
+#define LGW_REGI_ARB_MCU_UART_CFG_PAR_EN 0x6087, 4, 1, 0, 0
+#define LGW_REGI_ARB_MCU_UART_CFG_PAR_MODE 0x6087, 3, 1, 0, 0
+#define LGW_REGI_ARB_MCU_UART_CFG_START_LEN 0x6087, 2, 1, 0, 0
+#define LGW_REGI_ARB_MCU_UART_CFG_STOP_LEN 0x6087, 1, 1, 0, 0
+#define LGW_REGI_ARB_MCU_UART_CFG_WORD_LEN 0x6087, 0, 1, 0, 0
+#define LGW_REGI_ARB_MCU_UART_CFG2_BIT_RATE 0x6088, 0, 8, 0, 0
+#define LGW_REGI_ARB_MCU_ARB_DEBUG_CFG_0_ARB_DEBUG_CFG_0 0x6089, 0, 8, 0, 0
+#define LGW_REGI_ARB_MCU_ARB_DEBUG_CFG_1_ARB_DEBUG_CFG_1 0x608A, 0, 8, 0, 0
+#define LGW_REGI_ARB_MCU_ARB_DEBUG_CFG_2_ARB_DEBUG_CFG_2 0x608B, 0, 8, 0, 0
+#define LGW_REGI_ARB_MCU_ARB_DEBUG_CFG_3_ARB_DEBUG_CFG_3 0x608C, 0, 8, 0, 0
+#define LGW_REGI_ARB_MCU_ARB_DEBUG_STS_0_ARB_DEBUG_STS_0 0x608D, 0, 8, 0, 1
+#define LGW_REGI_ARB_MCU_ARB_DEBUG_STS_1_ARB_DEBUG_STS_1 0x608E, 0, 8, 0, 1
+#define LGW_REGI_ARB_MCU_ARB_DEBUG_STS_2_ARB_DEBUG_STS_2 0x608F, 0, 8, 0, 1
+#define LGW_REGI_ARB_MCU_ARB_DEBUG_STS_3_ARB_DEBUG_STS_3 0x6090, 0, 8, 0, 1
+#define LGW_REGI_ARB_MCU_ARB_DEBUG_STS_4_ARB_DEBUG_STS_4 0x6091, 0, 8, 0, 1
+#define LGW_REGI_ARB_MCU_ARB_DEBUG_STS_5_ARB_DEBUG_STS_5 0x6092, 0, 8, 0, 1
+#define LGW_REGI_ARB_MCU_ARB_DEBUG_STS_6_ARB_DEBUG_STS_6 0x6093, 0, 8, 0, 1
+#define LGW_REGI_ARB_MCU_ARB_DEBUG_STS_7_ARB_DEBUG_STS_7 0x6094, 0, 8, 0, 1
+#define LGW_REGI_ARB_MCU_ARB_DEBUG_STS_8_ARB_DEBUG_STS_8 0x6095, 0, 8, 0, 1
+#define LGW_REGI_ARB_MCU_ARB_DEBUG_STS_9_ARB_DEBUG_STS_9 0x6096, 0, 8, 0, 1
+#define LGW_REGI_ARB_MCU_ARB_DEBUG_STS_10_ARB_DEBUG_STS_10 0x6097, 0, 8, 0, 1
+#define LGW_REGI_ARB_MCU_ARB_DEBUG_STS_11_ARB_DEBUG_STS_11 0x6098, 0, 8, 0, 1
+#define LGW_REGI_ARB_MCU_ARB_DEBUG_STS_12_ARB_DEBUG_STS_12 0x6099, 0, 8, 0, 1
+#define LGW_REGI_ARB_MCU_ARB_DEBUG_STS_13_ARB_DEBUG_STS_13 0x609A, 0, 8, 0, 1
+#define LGW_REGI_ARB_MCU_ARB_DEBUG_STS_14_ARB_DEBUG_STS_14 0x609B, 0, 8, 0, 1
+#define LGW_REGI_ARB_MCU_ARB_DEBUG_STS_15_ARB_DEBUG_STS_15 0x609C, 0, 8, 0, 1
+#define LGW_REGI_ARB_MCU_CHANNEL_SYNC_OFFSET_01_CHANNEL_1_OFFSET 0x609D, 4, 4, 0, 0
+#define LGW_REGI_ARB_MCU_CHANNEL_SYNC_OFFSET_01_CHANNEL_0_OFFSET 0x609D, 0, 4, 0, 0
+#define LGW_REGI_ARB_MCU_CHANNEL_SYNC_OFFSET_23_CHANNEL_3_OFFSET 0x609E, 4, 4, 0, 0
+#define LGW_REGI_ARB_MCU_CHANNEL_SYNC_OFFSET_23_CHANNEL_2_OFFSET 0x609E, 0, 4, 0, 0
+#define LGW_REGI_ARB_MCU_CHANNEL_SYNC_OFFSET_45_CHANNEL_5_OFFSET 0x609F, 4, 4, 0, 0
+#define LGW_REGI_ARB_MCU_CHANNEL_SYNC_OFFSET_45_CHANNEL_4_OFFSET 0x609F, 0, 4, 0, 0
+#define LGW_REGI_ARB_MCU_CHANNEL_SYNC_OFFSET_67_CHANNEL_7_OFFSET 0x60A0, 4, 4, 0, 0
+#define LGW_REGI_ARB_MCU_CHANNEL_SYNC_OFFSET_67_CHANNEL_6_OFFSET 0x60A0, 0, 4, 0, 0
+#define LGW_REGI_ARB_MCU_DUMMY_DUMMY3 0x60A1, 0, 1, 0, 1
+#define LGW_REGI_RADIO_FE_GLBL_CTRL_DECIM_B_CLR 0x5700, 1, 1, 0, 0
+#define LGW_REGI_RADIO_FE_GLBL_CTRL_DECIM_A_CLR 0x5700, 0, 1, 0, 0
+#define LGW_REGI_RADIO_FE_CTRL0_RADIO_A_DC_NOTCH_EN 0x5701, 5, 1, 0, 0
+#define LGW_REGI_RADIO_FE_CTRL0_RADIO_A_FORCE_HOST_FILTER_GAIN 0x5701, 4, 1, 0, 0
+#define LGW_REGI_RADIO_FE_CTRL0_RADIO_A_HOST_FILTER_GAIN 0x5701, 0, 4, 0, 0
+#define LGW_REGI_RADIO_FE_RSSI_DB_DEF_RADIO_A_RSSI_DB_DEFAULT_VALUE 0x5702, 0, 8, 0, 0
+#define LGW_REGI_RADIO_FE_RSSI_DEC_DEF_RADIO_A_RSSI_DEC_DEFAULT_VALUE 0x5703, 0, 8, 0, 0
+#define LGW_REGI_RADIO_FE_RSSI_DEC_RD_RADIO_A_RSSI_DEC_OUT 0x5704, 0, 8, 0, 1
+#define LGW_REGI_RADIO_FE_RSSI_BB_RD_RADIO_A_RSSI_BB_OUT 0x5705, 0, 8, 0, 1
+#define LGW_REGI_RADIO_FE_DEC_FILTER_RD_RADIO_A_DEC_FILTER_GAIN 0x5706, 0, 4, 0, 1
+#define LGW_REGI_RADIO_FE_RSSI_BB_FILTER_ALPHA_RADIO_A_RSSI_BB_FILTER_ALPHA 0x5707, 0, 5, 0, 0
+#define LGW_REGI_RADIO_FE_RSSI_DEC_FILTER_ALPHA_RADIO_A_RSSI_DEC_FILTER_ALPHA 0x5708, 0, 5, 0, 0
+#define LGW_REGI_RADIO_FE_IQ_COMP_AMP_COEFF_RADIO_A_AMP_COEFF 0x5709, 0, 6, 0, 0
+#define LGW_REGI_RADIO_FE_IQ_COMP_PHI_COEFF_RADIO_A_PHI_COEFF 0x570A, 0, 6, 0, 0
+#define LGW_REGI_RADIO_FE_RADIO_DIO_TEST_MODE_RADIO_A_DIO_TEST_MODE 0x570B, 0, 6, 0, 0
+#define LGW_REGI_RADIO_FE_RADIO_DIO_TEST_DIR_RADIO_A_DIO_TEST_DIR 0x570C, 0, 6, 0, 0
+#define LGW_REGI_RADIO_FE_RADIO_DIO_DIR_RADIO_A_DIO_DIR 0x570D, 0, 6, 0, 1
+#define LGW_REGI_RADIO_FE_CTRL0_RADIO_B_DC_NOTCH_EN 0x570E, 5, 1, 0, 0
+#define LGW_REGI_RADIO_FE_CTRL0_RADIO_B_FORCE_HOST_FILTER_GAIN 0x570E, 4, 1, 0, 0
+#define LGW_REGI_RADIO_FE_CTRL0_RADIO_B_HOST_FILTER_GAIN 0x570E, 0, 4, 0, 0
+#define LGW_REGI_RADIO_FE_RSSI_DB_DEF_RADIO_B_RSSI_DB_DEFAULT_VALUE 0x570F, 0, 8, 0, 0
+#define LGW_REGI_RADIO_FE_RSSI_DEC_DEF_RADIO_B_RSSI_DEC_DEFAULT_VALUE 0x5710, 0, 8, 0, 0
+#define LGW_REGI_RADIO_FE_RSSI_DEC_RD_RADIO_B_RSSI_DEC_OUT 0x5711, 0, 8, 0, 1
+#define LGW_REGI_RADIO_FE_RSSI_BB_RD_RADIO_B_RSSI_BB_OUT 0x5712, 0, 8, 0, 1
+#define LGW_REGI_RADIO_FE_DEC_FILTER_RD_RADIO_B_DEC_FILTER_GAIN 0x5713, 0, 4, 0, 1
+#define LGW_REGI_RADIO_FE_RSSI_BB_FILTER_ALPHA_RADIO_B_RSSI_BB_FILTER_ALPHA 0x5714, 0, 5, 0, 0
+#define LGW_REGI_RADIO_FE_RSSI_DEC_FILTER_ALPHA_RADIO_B_RSSI_DEC_FILTER_ALPHA 0x5715, 0, 5, 0, 0
+#define LGW_REGI_RADIO_FE_IQ_COMP_AMP_COEFF_RADIO_B_AMP_COEFF 0x5716, 0, 6, 0, 0
+#define LGW_REGI_RADIO_FE_IQ_COMP_PHI_COEFF_RADIO_B_PHI_COEFF 0x5717, 0, 6, 0, 0
+#define LGW_REGI_RADIO_FE_RADIO_DIO_TEST_MODE_RADIO_B_DIO_TEST_MODE 0x5718, 0, 6, 0, 0
+#define LGW_REGI_RADIO_FE_RADIO_DIO_TEST_DIR_RADIO_B_DIO_TEST_DIR 0x5719, 0, 6, 0, 0
+#define LGW_REGI_RADIO_FE_RADIO_DIO_DIR_RADIO_B_DIO_DIR 0x571A, 0, 6, 0, 1
+#define LGW_REGI_RADIO_FE_SIG_ANA_CFG_VALID 0x571B, 7, 1, 0, 1
+#define LGW_REGI_RADIO_FE_SIG_ANA_CFG_BUSY 0x571B, 6, 1, 0, 1
+#define LGW_REGI_RADIO_FE_SIG_ANA_CFG_DURATION 0x571B, 4, 2, 0, 0
+#define LGW_REGI_RADIO_FE_SIG_ANA_CFG_FORCE_HAL_CTRL 0x571B, 3, 1, 0, 0
+#define LGW_REGI_RADIO_FE_SIG_ANA_CFG_START 0x571B, 2, 1, 0, 0
+#define LGW_REGI_RADIO_FE_SIG_ANA_CFG_RADIO_SEL 0x571B, 1, 1, 0, 0
+#define LGW_REGI_RADIO_FE_SIG_ANA_CFG_EN 0x571B, 0, 1, 0, 0
+#define LGW_REGI_RADIO_FE_SIG_ANA_FREQ_FREQ 0x571C, 0, 8, 0, 0
+#define LGW_REGI_RADIO_FE_SIG_ANA_ABS_MSB_CORR_ABS_OUT 0x571D, 0, 8, 0, 1
+#define LGW_REGI_RADIO_FE_SIG_ANA_ABS_LSB_CORR_ABS_OUT 0x571E, 0, 8, 0, 1
+#define LGW_REGI_RADIO_FE_DUMMY_DUMMY 0x571F, 0, 1, 0, 1
+#define LGW_REGI_OTP_BYTE_ADDR_ADDR 0x6180, 0, 8, 0, 0
+#define LGW_REGI_OTP_RD_DATA_RD_DATA 0x6181, 0, 8, 0, 1
+#define LGW_REGI_OTP_STATUS_CHECKSUM_STATUS 0x6182, 4, 4, 0, 1
+#define LGW_REGI_OTP_STATUS_FSM_READY 0x6182, 0, 1, 0, 1
+#define LGW_REGI_OTP_CFG_ACCESS_MODE 0x6183, 0, 2, 0, 0
+#define LGW_REGI_OTP_BIT_POS_POS 0x6184, 0, 3, 0, 0
+#define LGW_REGI_OTP_PIN_CTRL_0_TM 0x6185, 4, 4, 0, 0
+#define LGW_REGI_OTP_PIN_CTRL_0_STROBE 0x6185, 3, 1, 0, 0
+#define LGW_REGI_OTP_PIN_CTRL_0_PGENB 0x6185, 2, 1, 0, 0
+#define LGW_REGI_OTP_PIN_CTRL_0_LOAD 0x6185, 1, 1, 0, 0
+#define LGW_REGI_OTP_PIN_CTRL_0_CSB 0x6185, 0, 1, 0, 0
+#define LGW_REGI_OTP_PIN_CTRL_1_FSCK 0x6186, 2, 1, 0, 0
+#define LGW_REGI_OTP_PIN_CTRL_1_FSI 0x6186, 1, 1, 0, 0
+#define LGW_REGI_OTP_PIN_CTRL_1_FRST 0x6186, 0, 1, 0, 0
+#define LGW_REGI_OTP_PIN_STATUS_FSO 0x6187, 0, 1, 0, 1
+#define LGW_REGI_OTP_MODEM_EN_0_MODEM_EN 0x6188, 0, 8, 0, 0
+#define LGW_REGI_OTP_MODEM_EN_1_MODEM_EN 0x6189, 0, 8, 0, 0
+#define LGW_REGI_OTP_MODEM_SF_EN_SF_EN 0x618A, 0, 8, 0, 0
+#define LGW_REGI_OTP_TIMESTAMP_EN_TIMESTAMP_EN 0x618B, 0, 1, 0, 0
+#define LGW_REGI_OTP_DUMMY_DUMMY 0x618C, 0, 1, 0, 1
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_LORA_SERVICE_FREQ_MSB_IF_FREQ_0 0x5B00, 0, 5, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_LORA_SERVICE_FREQ_LSB_IF_FREQ_0 0x5B01, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_LORA_SERVICE_RADIO_SEL_RADIO_SELECT 0x5B02, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DC_NOTCH_CFG1_BW_START 0x5B03, 4, 3, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DC_NOTCH_CFG1_AUTO_BW_RED 0x5B03, 3, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DC_NOTCH_CFG1_NO_FAST_START 0x5B03, 2, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DC_NOTCH_CFG1_BYPASS 0x5B03, 1, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DC_NOTCH_CFG1_ENABLE 0x5B03, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DC_NOTCH_CFG2_BW_LOCKED 0x5B04, 3, 3, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DC_NOTCH_CFG2_BW 0x5B04, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DC_NOTCH_CFG3_BW_RED 0x5B05, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DC_NOTCH_CFG4_IIR_DCC_TIME 0x5B06, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_FIR1_0_FIR1_COEFF_0 0x5B07, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_FIR1_1_FIR1_COEFF_1 0x5B08, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_FIR1_2_FIR1_COEFF_2 0x5B09, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_FIR1_3_FIR1_COEFF_3 0x5B0A, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_FIR1_4_FIR1_COEFF_4 0x5B0B, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_FIR1_5_FIR1_COEFF_5 0x5B0C, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_FIR1_6_FIR1_COEFF_6 0x5B0D, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_FIR1_7_FIR1_COEFF_7 0x5B0E, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_FIR2_0_FIR2_COEFF_0 0x5B0F, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_FIR2_1_FIR2_COEFF_1 0x5B10, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_FIR2_2_FIR2_COEFF_2 0x5B11, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_FIR2_3_FIR2_COEFF_3 0x5B12, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_FIR2_4_FIR2_COEFF_4 0x5B13, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_FIR2_5_FIR2_COEFF_5 0x5B14, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_FIR2_6_FIR2_COEFF_6 0x5B15, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_FIR2_7_FIR2_COEFF_7 0x5B16, 0, 8, 1, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_AGC0_RADIO_GAIN_RED_SEL 0x5B17, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_AGC0_RADIO_GAIN_RED_DB 0x5B17, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_AGC1_DC_COMP_EN 0x5B18, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_AGC1_FORCE_DEFAULT_FIR 0x5B18, 3, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_AGC1_RSSI_EARLY_LATCH 0x5B18, 2, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_AGC1_FREEZE_ON_SYNC 0x5B18, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_AGC2_DAGC_IN_COMP 0x5B19, 6, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_AGC2_DAGC_FIR_HYST 0x5B19, 5, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_AGC2_RSSI_MAX_SAMPLE 0x5B19, 3, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_AGC2_RSSI_MIN_SAMPLE 0x5B19, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_GAIN0_DAGC_FIR_FAST 0x5B1A, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_GAIN0_FORCE_GAIN_FIR 0x5B1A, 6, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_GAIN0_GAIN_FIR1 0x5B1A, 4, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_DFE_GAIN0_GAIN_FIR2 0x5B1A, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DAGC_CFG_TARGET_LVL 0x5B1B, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DAGC_CFG_GAIN_INCR_STEP 0x5B1B, 5, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DAGC_CFG_GAIN_DROP_COMP 0x5B1B, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DAGC_CFG_COMB_FILTER_EN 0x5B1B, 3, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DAGC_CFG_NO_FREEZE_START 0x5B1B, 2, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DAGC_CFG_FREEZE_ON_SYNC 0x5B1B, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DAGC_CNT0_SAMPLE 0x5B1C, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DAGC_CNT1_THR_M6 0x5B1D, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DAGC_CNT2_THR_M12 0x5B1E, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DAGC_CNT3_THR_M18 0x5B1F, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DAGC_CNT4_GAIN 0x5B20, 4, 4, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DAGC_CNT4_FORCE_GAIN 0x5B20, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_TXRX_CFG0_MODEM_BW 0x5B21, 4, 4, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_TXRX_CFG0_MODEM_SF 0x5B21, 0, 4, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_TXRX_CFG1_PPM_OFFSET_HDR_CTRL 0x5B22, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_TXRX_CFG1_PPM_OFFSET 0x5B22, 4, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_TXRX_CFG1_MODEM_EN 0x5B22, 3, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_TXRX_CFG1_CODING_RATE 0x5B22, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_TXRX_CFG2_FINE_SYNCH_EN 0x5B23, 5, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_TXRX_CFG2_MODEM_START 0x5B23, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_TXRX_CFG2_CADRXTX 0x5B23, 2, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_TXRX_CFG2_IMPLICIT_HEADER 0x5B23, 1, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_TXRX_CFG2_CRC_EN 0x5B23, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_TXRX_CFG3_PAYLOAD_LENGTH 0x5B24, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_TXRX_CFG4_INT_STEP_ORIDE_EN 0x5B25, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_TXRX_CFG4_INT_STEP_ORIDE 0x5B25, 0, 6, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_TXRX_CFG5_HEADER_DIFF_MODE 0x5B26, 6, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_TXRX_CFG5_ZERO_PAD 0x5B26, 0, 6, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_TXRX_CFG6_PREAMBLE_SYMB_NB 0x5B27, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_TXRX_CFG7_PREAMBLE_SYMB_NB 0x5B28, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_TXRX_CFG8_AUTO_ACK_INT_DELAY 0x5B29, 3, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_TXRX_CFG8_AUTO_ACK_RX 0x5B29, 2, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_TXRX_CFG8_AUTO_ACK_TX 0x5B29, 1, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_TXRX_CFG8_POST_PREAMBLE_GAP_LONG 0x5B29, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_CFG0_DFT_PEAK_EN 0x5B2A, 4, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_CFG0_CHIRP_INVERT 0x5B2A, 2, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_CFG0_SWAP_IQ 0x5B2A, 1, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_CFG0_CONTINUOUS 0x5B2A, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_CFG1_DETECT_TIMEOUT 0x5B2B, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_CFG2_AUTO_ACK_RANGE 0x5B2C, 5, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_CFG2_AUTO_ACK_DELAY 0x5B2C, 0, 5, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_CFG3_RESTART_ON_HDR_ERR 0x5B2D, 5, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_CFG3_CLK_EN_RESYNC_DIN 0x5B2D, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_RX_CFG3_LLR_SCALE 0x5B2D, 0, 4, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FRAME_SYNCH0_PEAK1_POS 0x5B2E, 0, 5, 1, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FRAME_SYNCH1_PEAK2_POS 0x5B2F, 0, 5, 1, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FRAME_SYNCH2_FINETIME_ON_LAST 0x5B30, 5, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FRAME_SYNCH2_AUTO_SCALE 0x5B30, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FRAME_SYNCH2_DROP_ON_SYNCH 0x5B30, 3, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FRAME_SYNCH2_GAIN 0x5B30, 2, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FRAME_SYNCH2_TIMEOUT_OPT 0x5B30, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FINE_TIMING0_GAIN_P_HDR_RED 0x5B31, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FINE_TIMING0_ROUNDING 0x5B31, 6, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FINE_TIMING0_POS_LIMIT 0x5B31, 4, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FINE_TIMING0_SUM_SIZE 0x5B31, 2, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FINE_TIMING0_MODE 0x5B31, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FINE_TIMING1_GAIN_P_AUTO 0x5B32, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FINE_TIMING1_GAIN_P_PAYLOAD 0x5B32, 3, 3, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FINE_TIMING1_GAIN_P_PREAMB 0x5B32, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FINE_TIMING2_GAIN_I_EN 0x5B33, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FINE_TIMING2_GAIN_I_PAYLOAD 0x5B33, 3, 3, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FINE_TIMING2_GAIN_I_PREAMB 0x5B33, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FINE_TIMING3_FINESYNCH_SUM 0x5B34, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FINE_TIMING3_FINESYNCH_GAIN 0x5B34, 4, 3, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FINE_TIMING3_GAIN_I_AUTO 0x5B34, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FINE_TIMING4_GAIN_I_AUTO_MAX 0x5B35, 4, 3, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FINE_TIMING4_GAIN_P_AUTO_MAX 0x5B35, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FREQ_TO_TIME0_FREQ_TO_TIME_DRIFT_MANT 0x5B36, 0, 4, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FREQ_TO_TIME1_FREQ_TO_TIME_DRIFT_MANT 0x5B37, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FREQ_TO_TIME2_FREQ_TO_TIME_DRIFT_EXP 0x5B38, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FREQ_TO_TIME3_FREQ_TO_TIME_INVERT_FREQ_DELTA 0x5B39, 5, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FREQ_TO_TIME3_FREQ_TO_TIME_INVERT_FINE_DELTA 0x5B39, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FREQ_TO_TIME3_FREQ_TO_TIME_INVERT_FREQ_ERROR 0x5B39, 3, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FREQ_TO_TIME3_FREQ_TO_TIME_INVERT_TIME_SYMB 0x5B39, 2, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FREQ_TO_TIME3_FREQ_TO_TIME_INVERT_TIME_OFFSET 0x5B39, 1, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FREQ_TO_TIME3_FREQ_TO_TIME_INVERT_DETECT 0x5B39, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FREQ_TO_TIME4_FREQ_TO_TIME_INVERT_RNG 0x5B3A, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FREQ_TRACK0_FREQ_TRACK_FINE 0x5B3B, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FREQ_TRACK0_FREQ_TRACK_HDR_SKIP 0x5B3B, 4, 3, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FREQ_TRACK0_FREQ_TRACK_EN 0x5B3B, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FREQ_TRACK1_FREQ_SYNCH_GAIN 0x5B3C, 4, 3, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FREQ_TRACK1_FREQ_TRACK_AUTO_THR 0x5B3C, 0, 4, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FREQ_TRACK2_SNR_MIN_WINDOW 0x5B3D, 5, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FREQ_TRACK2_GAIN_AUTO_SNR_MIN 0x5B3D, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FREQ_TRACK2_FREQ_SYNCH_THR 0x5B3D, 0, 4, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DETECT_MSP0_MSP_PNR 0x5B3E, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DETECT_MSP1_MSP2_PNR 0x5B3F, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DETECT_MSP2_MSP2_PEAK_NB 0x5B40, 4, 3, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DETECT_MSP2_MSP_PEAK_NB 0x5B40, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DETECT_MSP3_ACC_MIN2 0x5B41, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DETECT_MSP3_ACC_WIN_LEN 0x5B41, 4, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DETECT_MSP3_MSP_POS_SEL 0x5B41, 2, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DETECT_MSP3_MSP_CNT_MODE 0x5B41, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DETECT_ACC1_USE_GAIN_SYMB 0x5B42, 7, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DETECT_ACC1_ACC_PNR 0x5B42, 0, 7, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DETECT_ACC2_NOISE_COEFF 0x5B43, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DETECT_ACC2_ACC_COEFF 0x5B43, 4, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DETECT_ACC2_ACC_2_SAME_PEAKS 0x5B43, 3, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DETECT_ACC2_ACC_AUTO_RESCALE 0x5B43, 2, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DETECT_ACC2_ACC_PEAK_POS_SEL 0x5B43, 1, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DETECT_ACC2_ACC_PEAK_SUM_EN 0x5B43, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DETECT_ACC3_MIN_SINGLE_PEAK 0x5B44, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_TIMESTAMP_SEL_SNR_MIN 0x5B45, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_TIMESTAMP_ENABLE 0x5B45, 3, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_TIMESTAMP_NB_SYMB 0x5B45, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_CLOCK_GATE_OVERRIDE_FSK_TRANSPOSE_CLK_OVERRIDE 0x5B46, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_CLOCK_GATE_OVERRIDE_FSK_MODEM_CLK_OVERRIDE 0x5B46, 4, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_CLOCK_GATE_OVERRIDE_TRANSPOSE_CLK_OVERRIDE 0x5B46, 2, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_CLOCK_GATE_OVERRIDE_MODEM_CLK_OVERRIDE 0x5B46, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DUMMY0_DUMMY0 0x5B47, 0, 1, 0, 1
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_FREQ_MSB_IF_FREQ_0 0x5B50, 0, 5, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_FREQ_LSB_IF_FREQ_0 0x5B51, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_CFG_0_CRC_IBM 0x5B52, 4, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_CFG_0_DCFREE_ENC 0x5B52, 2, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_CFG_0_CRC_EN 0x5B52, 1, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_CFG_0_PKT_MODE 0x5B52, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_CFG_1_ADRS_COMP 0x5B53, 6, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_CFG_1_PSIZE 0x5B53, 3, 3, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_CFG_1_CH_BW_EXPO 0x5B53, 0, 3, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_CFG_3_MODEM_INVERT_IQ 0x5B54, 3, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_CFG_3_AUTO_AFC 0x5B54, 2, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_CFG_3_RADIO_SELECT 0x5B54, 1, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_CFG_3_RX_INVERT 0x5B54, 0, 1, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_CFG_4_RSSI_LENGTH 0x5B55, 5, 3, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_CFG_4_ERROR_OSR_TOL 0x5B55, 0, 5, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_NODE_ADRS_NODE_ADRS 0x5B56, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_BROADCAST_BROADCAST 0x5B57, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_PKT_LENGTH_PKT_LENGTH 0x5B58, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_TIMEOUT_MSB_TIMEOUT 0x5B59, 0, 2, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_TIMEOUT_LSB_TIMEOUT 0x5B5A, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_BIT_RATE_MSB_BIT_RATE 0x5B5B, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_BIT_RATE_LSB_BIT_RATE 0x5B5C, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_REF_PATTERN_BYTE7_FSK_REF_PATTERN 0x5B5D, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_REF_PATTERN_BYTE6_FSK_REF_PATTERN 0x5B5E, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_REF_PATTERN_BYTE5_FSK_REF_PATTERN 0x5B5F, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_REF_PATTERN_BYTE4_FSK_REF_PATTERN 0x5B60, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_REF_PATTERN_BYTE3_FSK_REF_PATTERN 0x5B61, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_REF_PATTERN_BYTE2_FSK_REF_PATTERN 0x5B62, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_REF_PATTERN_BYTE1_FSK_REF_PATTERN 0x5B63, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_REF_PATTERN_BYTE0_FSK_REF_PATTERN 0x5B64, 0, 8, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_FSK_RSSI_FILTER_ALPHA_FSK_RSSI_FILTER_ALPHA 0x5B65, 0, 4, 0, 0
+#define LGW_REGI_RX_TOP_LORA_SERVICE_FSK_DUMMY1_DUMMY1 0x5B66, 0, 1, 0, 1
+#define LGW_REGI_CAPTURE_RAM_CAPTURE_CFG_ENABLE 0x6000, 4, 1, 0, 0
+#define LGW_REGI_CAPTURE_RAM_CAPTURE_CFG_CAPTUREWRAP 0x6000, 3, 1, 0, 0
+#define LGW_REGI_CAPTURE_RAM_CAPTURE_CFG_CAPTUREFORCETRIGGER 0x6000, 2, 1, 0, 0
+#define LGW_REGI_CAPTURE_RAM_CAPTURE_CFG_CAPTURESTART 0x6000, 1, 1, 0, 0
+#define LGW_REGI_CAPTURE_RAM_CAPTURE_CFG_RAMCONFIG 0x6000, 0, 1, 0, 0
+#define LGW_REGI_CAPTURE_RAM_CAPTURE_SOURCE_A_SOURCEMUX 0x6001, 0, 5, 0, 0
+#define LGW_REGI_CAPTURE_RAM_CAPTURE_SOURCE_B_SOURCEMUX 0x6002, 0, 5, 0, 0
+#define LGW_REGI_CAPTURE_RAM_CAPTURE_PERIOD_0_CAPTUREPERIOD 0x6003, 0, 8, 0, 0
+#define LGW_REGI_CAPTURE_RAM_CAPTURE_PERIOD_1_CAPTUREPERIOD 0x6004, 0, 8, 0, 0
+#define LGW_REGI_CAPTURE_RAM_STATUS_CAPCOMPLETE 0x6005, 0, 1, 0, 1
+#define LGW_REGI_CAPTURE_RAM_LAST_RAM_ADDR_0_LASTRAMADDR 0x6006, 0, 8, 0, 1
+#define LGW_REGI_CAPTURE_RAM_LAST_RAM_ADDR_1_LASTRAMADDR 0x6007, 0, 4, 0, 1
+#define LGW_REGI_CAPTURE_RAM_CLOCK_GATE_OVERRIDE_CLK_OVERRIDE 0x6008, 0, 2, 0, 0
+#define LGW_REGI_CAPTURE_RAM_DUMMY0_DUMMY0 0x6009, 0, 1, 0, 1
+
+#endif
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,159 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    Pool of reference counted RX payloads
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+
+/* -------------------------------------------------------------------------- */
+/* --- DEPENDANCIES --------------------------------------------------------- */
+
+#include <stdint.h>     /* C99 types */
+#include <stdbool.h>    /* bool type */
+#include <stddef.h>     /* NULL */
+
+#include "loragw_rxpool.h"
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE TYPES -------------------------------------------------------- */
+
+/* Header of each block of the ring, followed by the payload.
+   Blocks are 8-byte aligned so that a header never wraps around the ring. */
+typedef struct {
+    uint32_t refcnt;    /* 0 once released (or for padding at the end of the ring) */
+    uint16_t len;       /* block length, header included */
+    uint16_t size;      /* payload size */
+} rxpool_block_t;
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE CONSTANTS ---------------------------------------------------- */
+
+#define RXPOOL_ALIGN    8
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE VARIABLES ---------------------------------------------------- */
+
+static uint32_t pool[RX_POOL_SIZE / sizeof(uint32_t)];
+
+/* free running byte offsets: blocks in [tail, head) are allocated or not reclaimed yet */
+static uint32_t pool_head = 0;
+static uint32_t pool_tail = 0;
+
+static uint32_t pool_high_water = 0;
+static uint32_t pool_nb_full = 0;
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE FUNCTIONS DEFINITION ----------------------------------------- */
+
+static rxpool_block_t * rxpool_block_at(uint32_t offset) {
+    return (rxpool_block_t *)((uint8_t *)pool + (offset % RX_POOL_SIZE));
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+/* Move the tail over the blocks released, oldest first */
+static void rxpool_reclaim(void) {
+    rxpool_block_t * blk;
+
+    while (pool_tail != pool_head) {
+        blk = rxpool_block_at(pool_tail);
+        if (__atomic_load_n(&blk->refcnt, __ATOMIC_ACQUIRE) != 0) {
+            break;
+        }
+        pool_tail += blk->len;
+    }
+
+    /* empty: restart from the beginning of the ring, for the largest contiguous space */
+    if (pool_tail == pool_head) {
+        pool_tail = 0;
+        pool_head = 0;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS DEFINITION ------------------------------------------ */
+
+uint8_t * rxpool_alloc(uint16_t size) {
+    uint32_t need, pad, pos, used;
+    rxpool_block_t * blk;
+
+    need = (sizeof(rxpool_block_t) + size + RXPOOL_ALIGN - 1) & ~(uint32_t)(RXPOOL_ALIGN - 1);
+
+    rxpool_reclaim();
+
+    /* a payload is contiguous: skip the end of the ring if it does not fit there */
+    pos = pool_head % RX_POOL_SIZE;
+    pad = ((pos + need) > RX_POOL_SIZE) ? (RX_POOL_SIZE - pos) : 0;
+    if ((pad + need) > (RX_POOL_SIZE - (pool_head - pool_tail))) {
+        pool_nb_full += 1;
+        return NULL;
+    }
+    if (pad > 0) {
+        blk = rxpool_block_at(pool_head);
+        blk->len = (uint16_t)pad;
+        blk->size = 0;
+        __atomic_store_n(&blk->refcnt, 0, __ATOMIC_RELAXED);
+        pool_head += pad;
+    }
+
+    blk = rxpool_block_at(pool_head);
+    blk->len = (uint16_t)need;
+    blk->size = size;
+    __atomic_store_n(&blk->refcnt, 1, __ATOMIC_RELAXED);
+    pool_head += need;
+
+    used = pool_head - pool_tail;
+    if (used > pool_high_water) {
+        pool_high_water = used;
+    }
+
+    return (uint8_t *)(blk + 1);
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+void rxpool_ref(const uint8_t * payload) {
+    rxpool_block_t * blk;
+
+    if (payload == NULL) {
+        return;
+    }
+    blk = (rxpool_block_t *)payload - 1;
+    __atomic_add_fetch(&blk->refcnt, 1, __ATOMIC_RELAXED);
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+void rxpool_unref(const uint8_t * payload) {
+    rxpool_block_t * blk;
+
+    if (payload == NULL) {
+        return;
+    }
+    blk = (rxpool_block_t *)payload - 1;
+    __atomic_sub_fetch(&blk->refcnt, 1, __ATOMIC_RELEASE); /* reads of the payload are done */
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+void rxpool_stats(uint32_t * used, uint32_t * high_water, uint32_t * nb_full) {
+    if (used != NULL) {
+        *used = pool_head - pool_tail;
+    }
+    if (high_water != NULL) {
+        *high_water = pool_high_water;
+    }
+    if (nb_full != NULL) {
+        *nb_full = pool_nb_full;
+    }
+}
+
+/* --- EOF ------------------------------------------------------------------ */
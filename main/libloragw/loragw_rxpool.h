@@ -0,0 +1,71 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    Pool of reference counted RX payloads.
+    Payloads are allocated one after the other in a byte ring, by a single
+    task (the one receiving packets). They can be referenced and released
+    from any task; the space of released payloads is reclaimed in allocation
+    order, by the next allocations.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+
+#ifndef _LORAGW_RXPOOL_H
+#define _LORAGW_RXPOOL_H
+
+/* -------------------------------------------------------------------------- */
+/* --- DEPENDANCIES --------------------------------------------------------- */
+
+#include <stdint.h>     /* C99 types*/
+#include <stdbool.h>    /* bool type */
+
+#include "config.h"     /* library configuration options (dynamically generated) */
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC CONSTANTS ----------------------------------------------------- */
+
+#ifndef RX_POOL_SIZE
+#define RX_POOL_SIZE    4096    /* size of the payload ring, in bytes, must be a power of 2 */
+#endif
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS PROTOTYPES ------------------------------------------ */
+
+/**
+@brief Allocate a payload in the pool, with one reference
+Must always be called from the same task.
+@param size     The payload size, in bytes
+@return A pointer to the payload, NULL if the pool is full
+*/
+uint8_t * rxpool_alloc(uint16_t size);
+
+/**
+@brief Add a reference to a payload allocated by rxpool_alloc()
+@param payload  A pointer to the payload
+*/
+void rxpool_ref(const uint8_t * payload);
+
+/**
+@brief Release a reference to a payload, its space is reclaimed when it was the last one
+@param payload  A pointer to the payload (NULL is ignored)
+*/
+void rxpool_unref(const uint8_t * payload);
+
+/**
+@brief Get the pool occupancy
+@param used         Bytes currently allocated or not reclaimed yet (can be NULL)
+@param high_water   Highest number of bytes used since start (can be NULL)
+@param nb_full      Number of allocations failed because the pool was full (can be NULL)
+*/
+void rxpool_stats(uint32_t * used, uint32_t * high_water, uint32_t * nb_full);
+
+#endif
+
+/* --- EOF ------------------------------------------------------------------ */
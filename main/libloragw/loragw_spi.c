@@ -17,12 +17,15 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 
 
 #include <stdint.h>     /* C99 types */
+#include <stdbool.h>    /* bool type */
 #include <stdio.h>      /* printf fprintf */
 #include <stdlib.h>     /* malloc free */
 #include <unistd.h>     /* lseek, close */
 #include <fcntl.h>      /* open */
 #include <string.h>     /* memset */
 
+#include "esp_heap_caps.h"
+
 #include "loragw_spi.h"
 #include "loragw_aux.h"
 
@@ -62,6 +65,292 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 //#define DEBUG_SPI
 
 
+#define SPI_QUEUE_SIZE  8   /* depth of the driver transaction queue */
+
+/* A run of consecutive register bytes recorded in bulk mode */
+typedef struct spi_bulk_burst_s {
+    uint8_t     mux;    /* SPI mux target */
+    uint16_t    addr;   /* address of the first byte */
+    uint16_t    offset; /* position of the first byte in spi_bulk_data */
+    uint16_t    size;   /* number of bytes */
+} spi_bulk_burst_t;
+
+/* Current burst transfer mode, and DMA-capable buffers used by the queued mode */
+static lgw_spi_xfer_mode_t spi_xfer_mode = LGW_SPI_XFER_QUEUED;
+static uint8_t *spi_dma_buf[LGW_SPI_QUEUE_DEPTH] = {NULL};
+static uint8_t *spi_dma_zero = NULL; /* dummy bytes clocked out during a burst read */
+
+/* Write commands recorded in bulk mode, waiting for lgw_spi_flush() */
+static lgw_com_write_mode_t spi_write_mode = LGW_COM_WRITE_MODE_SINGLE;
+static uint8_t *spi_bulk_data = NULL; /* DMA-capable, bursts start 32-bit aligned */
+static uint16_t spi_bulk_size = 0;
+static spi_bulk_burst_t spi_bulk_burst[LGW_SPI_BULK_BURST_NB];
+static int spi_bulk_burst_nb = 0;
+static int spi_bulk_req_nb = 0; /* write requests recorded in the pending bursts */
+static uint32_t spi_bulk_saved = 0; /* SPI transactions saved by merging, since open */
+
+
+/* Release the DMA buffers of the queued mode */
+static void spi_dma_free(void)
+{
+    int i;
+
+    for(i = 0; i < LGW_SPI_QUEUE_DEPTH; i++) {
+        heap_caps_free(spi_dma_buf[i]);
+        spi_dma_buf[i] = NULL;
+    }
+    heap_caps_free(spi_dma_zero);
+    spi_dma_zero = NULL;
+    heap_caps_free(spi_bulk_data);
+    spi_bulk_data = NULL;
+}
+
+/* Allocate the DMA buffers of the queued mode, one per in-flight chunk */
+static int spi_dma_alloc(void)
+{
+    int i;
+
+    for(i = 0; i < LGW_SPI_QUEUE_DEPTH; i++) {
+        spi_dma_buf[i] = heap_caps_malloc(LGW_BURST_CHUNK, MALLOC_CAP_DMA);
+        if(spi_dma_buf[i] == NULL) {
+            spi_dma_free();
+            return LGW_SPI_ERROR;
+        }
+    }
+    spi_dma_zero = heap_caps_calloc(1, LGW_BURST_CHUNK, MALLOC_CAP_DMA);
+    if(spi_dma_zero == NULL) {
+        spi_dma_free();
+        return LGW_SPI_ERROR;
+    }
+    spi_bulk_data = heap_caps_malloc(LGW_SPI_BULK_SIZE, MALLOC_CAP_DMA);
+    if(spi_bulk_data == NULL) {
+        spi_dma_free();
+        return LGW_SPI_ERROR;
+    }
+
+    return LGW_SPI_SUCCESS;
+}
+
+/* Tell if a burst of the given size has to go through the queued mode */
+static bool spi_use_queued(uint16_t size)
+{
+    return (spi_xfer_mode == LGW_SPI_XFER_QUEUED) && (spi_dma_zero != NULL) && (size >= LGW_SPI_QUEUED_MIN_SIZE);
+}
+
+/*
+ * Queued burst transfer: the burst is split in LGW_BURST_CHUNK chunks sharing the
+ * command/address header of 'et', up to LGW_SPI_QUEUE_DEPTH of them being queued
+ * to the DMA engine at once. The calling task blocks in the driver queue while the
+ * chunks complete, instead of spinning as spi_device_polling_transmit() does.
+ * Exactly one of tx_data/rx_data is expected to be set.
+ * The bus is supposed to be acquired by the caller.
+ */
+static esp_err_t spi_burst_queued(spi_device_handle_t *spi, const spi_transaction_ext_t *et, const uint8_t *tx_data, uint8_t *rx_data, uint16_t size)
+{
+    esp_err_t err = ESP_OK;
+    spi_transaction_ext_t trans[LGW_SPI_QUEUE_DEPTH];
+    spi_transaction_t *done;
+    int nb_chunks = (size + LGW_BURST_CHUNK - 1) / LGW_BURST_CHUNK;
+    int nb_queued = 0;
+    int nb_done = 0;
+    int slot, offset, chunk_size;
+
+    while(nb_done < nb_chunks) {
+        /* keep the DMA engine fed with the next chunks */
+        while((nb_queued < nb_chunks) && ((nb_queued - nb_done) < LGW_SPI_QUEUE_DEPTH)) {
+            slot = nb_queued % LGW_SPI_QUEUE_DEPTH;
+            offset = nb_queued * LGW_BURST_CHUNK;
+            chunk_size = MIN(size - offset, LGW_BURST_CHUNK);
+
+            trans[slot] = *et;
+            trans[slot].base.length = chunk_size * 8;
+            trans[slot].base.user = (void *)(intptr_t)offset;
+            if(tx_data != NULL) {
+                memcpy(spi_dma_buf[slot], tx_data + offset, chunk_size);
+                trans[slot].base.tx_buffer = spi_dma_buf[slot];
+                trans[slot].base.rx_buffer = NULL;
+                trans[slot].base.rxlength = 0;
+            } else {
+                trans[slot].base.tx_buffer = spi_dma_zero;
+                trans[slot].base.rx_buffer = spi_dma_buf[slot];
+                trans[slot].base.rxlength = chunk_size * 8;
+            }
+
+            err = spi_device_queue_trans(*spi, (spi_transaction_t *)&trans[slot], portMAX_DELAY);
+            if(err != ESP_OK)
+                break;
+            nb_queued += 1;
+        }
+        if(err != ESP_OK)
+            break;
+
+        /* sleep until the oldest chunk is done (chunks complete in order) */
+        err = spi_device_get_trans_result(*spi, &done, portMAX_DELAY);
+        if(err != ESP_OK)
+            break;
+        if(rx_data != NULL) {
+            memcpy(rx_data + (intptr_t)done->user, done->rx_buffer, done->length / 8);
+        }
+        nb_done += 1;
+        DEBUG_PRINTF("QUEUED BURST: chunk %d/%d done\n", nb_done, nb_chunks);
+    }
+
+    /* on error, collect the chunks still owned by the driver before returning */
+    while(nb_done < nb_queued) {
+        if(spi_device_get_trans_result(*spi, &done, portMAX_DELAY) != ESP_OK)
+            break;
+        nb_done += 1;
+    }
+
+    return err;
+}
+
+
+/*
+ * Send all the write bursts recorded in bulk mode, in recording order, as one chain
+ * of queued transactions under a single bus acquisition. Bursts of up to 4 bytes
+ * are carried in the transaction itself, longer ones straight from spi_bulk_data.
+ * The pending list is emptied whatever the outcome.
+ */
+static esp_err_t spi_bulk_send(spi_device_handle_t *spi)
+{
+    esp_err_t err;
+    spi_transaction_ext_t trans[SPI_QUEUE_SIZE];
+    spi_transaction_t *done;
+    spi_bulk_burst_t *burst;
+    int nb_queued = 0;
+    int nb_done = 0;
+    int slot;
+
+    if(spi_bulk_burst_nb == 0)
+        return ESP_OK;
+
+    err = spi_device_acquire_bus(*spi, portMAX_DELAY);
+    if(err != ESP_OK)
+        goto reset;
+
+    while(nb_done < spi_bulk_burst_nb) {
+        while((nb_queued < spi_bulk_burst_nb) && ((nb_queued - nb_done) < SPI_QUEUE_SIZE)) {
+            slot = nb_queued % SPI_QUEUE_SIZE;
+            burst = &spi_bulk_burst[nb_queued];
+
+            memset(&trans[slot], 0, sizeof(trans[slot]));
+            trans[slot].command_bits = 8;
+            trans[slot].address_bits = 16;
+            trans[slot].base.cmd = burst->mux;
+            trans[slot].base.addr = WRITE_ACCESS | (burst->addr & ADDR_MASK);
+            trans[slot].base.flags = SPI_TRANS_VARIABLE_CMD | SPI_TRANS_VARIABLE_ADDR;
+            trans[slot].base.length = burst->size * 8;
+            if(burst->size <= sizeof(trans[slot].base.tx_data)) {
+                trans[slot].base.flags |= SPI_TRANS_USE_TXDATA;
+                memcpy(trans[slot].base.tx_data, spi_bulk_data + burst->offset, burst->size);
+            } else {
+                trans[slot].base.tx_buffer = spi_bulk_data + burst->offset;
+            }
+
+            err = spi_device_queue_trans(*spi, (spi_transaction_t *)&trans[slot], portMAX_DELAY);
+            if(err != ESP_OK)
+                break;
+            nb_queued += 1;
+        }
+        if(err != ESP_OK)
+            break;
+
+        err = spi_device_get_trans_result(*spi, &done, portMAX_DELAY);
+        if(err != ESP_OK)
+            break;
+        nb_done += 1;
+    }
+
+    /* on error, collect the transactions still owned by the driver before returning */
+    while(nb_done < nb_queued) {
+        if(spi_device_get_trans_result(*spi, &done, portMAX_DELAY) != ESP_OK)
+            break;
+        nb_done += 1;
+    }
+
+    spi_device_release_bus(*spi);
+
+    if(err == ESP_OK) {
+        spi_bulk_saved += spi_bulk_req_nb - spi_bulk_burst_nb;
+        DEBUG_PRINTF("BULK FLUSH: %d writes sent in %d transactions\n", spi_bulk_req_nb, spi_bulk_burst_nb);
+    }
+
+reset:
+    spi_bulk_size = 0;
+    spi_bulk_burst_nb = 0;
+    spi_bulk_req_nb = 0;
+    return err;
+}
+
+/*
+ * Record a write in bulk mode. It is appended to the last burst when it follows it
+ * in the SX1302 address space (auto-incremented on burst writes), otherwise it
+ * opens a new burst. Pending bursts are sent first when the buffers are full.
+ * The size is expected not to exceed LGW_SPI_BULK_SIZE.
+ */
+static esp_err_t spi_bulk_record(spi_device_handle_t *spi, uint8_t spi_mux_target, uint16_t address, const uint8_t *data, uint16_t size)
+{
+    esp_err_t err;
+    spi_bulk_burst_t *burst = NULL;
+    uint16_t offset;
+
+    if(spi_bulk_burst_nb > 0) {
+        burst = &spi_bulk_burst[spi_bulk_burst_nb - 1];
+        if((spi_mux_target == LGW_SPI_MUX_TARGET_SX1302) && (burst->mux == spi_mux_target) &&
+           (burst->addr + burst->size == address) && (spi_bulk_size + size <= LGW_SPI_BULK_SIZE)) {
+            memcpy(spi_bulk_data + spi_bulk_size, data, size);
+            burst->size += size;
+            spi_bulk_size += size;
+            spi_bulk_req_nb += 1;
+            return ESP_OK;
+        }
+    }
+
+    offset = (spi_bulk_size + 3) & ~3;
+    if((offset + size > LGW_SPI_BULK_SIZE) || (spi_bulk_burst_nb == LGW_SPI_BULK_BURST_NB)) {
+        err = spi_bulk_send(spi);
+        if(err != ESP_OK)
+            return err;
+        offset = 0;
+    }
+
+    burst = &spi_bulk_burst[spi_bulk_burst_nb];
+    burst->mux = spi_mux_target;
+    burst->addr = address;
+    burst->offset = offset;
+    burst->size = size;
+    memcpy(spi_bulk_data + offset, data, size);
+    spi_bulk_size = offset + size;
+    spi_bulk_burst_nb += 1;
+    spi_bulk_req_nb += 1;
+    return ESP_OK;
+}
+
+/* Get the last value recorded for a register byte in bulk mode, if any */
+static bool spi_bulk_lookup(uint8_t spi_mux_target, uint16_t address, uint8_t *data)
+{
+    int i;
+    spi_bulk_burst_t *burst;
+
+    for(i = spi_bulk_burst_nb - 1; i >= 0; i--) {
+        burst = &spi_bulk_burst[i];
+        if((burst->mux == spi_mux_target) && (address >= burst->addr) && (address < burst->addr + burst->size)) {
+            *data = spi_bulk_data[burst->offset + (address - burst->addr)];
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Bulk mode: pending writes must reach the chip before anything else is transferred */
+static esp_err_t spi_bulk_sync(spi_device_handle_t *spi)
+{
+    return (spi_bulk_burst_nb > 0) ? spi_bulk_send(spi) : ESP_OK;
+}
+
+
 /* SPI initialization and configuration */
 int lgw_spi_open(spi_device_handle_t **spi_target)
 {
@@ -80,7 +369,7 @@ int lgw_spi_open(spi_device_handle_t **spi_target)
         .clock_speed_hz = SPI_SPEED,
         .mode = 0,
         .spics_io_num = PIN_NUM_CS,
-        .queue_size = 8,
+        .queue_size = SPI_QUEUE_SIZE,
     };
 
     spi = malloc(sizeof(spi_device_handle_t));
@@ -97,6 +386,11 @@ int lgw_spi_open(spi_device_handle_t **spi_target)
     ret = spi_bus_add_device(SX1302_SPI_HOST, &devcfg, spi);
     ESP_ERROR_CHECK(ret);
 
+    // DMA buffers for queued bursts; fall back to polling bursts if not available
+    if(spi_dma_alloc() != LGW_SPI_SUCCESS) {
+        printf("WARNING: failed to allocate SPI DMA buffers, queued burst mode disabled\n");
+    }
+
     *spi_target = (void *)spi;
     return LGW_SPI_SUCCESS;
 }
@@ -107,6 +401,14 @@ int lgw_spi_close(spi_device_handle_t *spi)
     esp_err_t ret;
 
     CHECK_NULL(spi);
+
+    /* do not leave recorded writes behind */
+    if(spi_bulk_sync(spi) != ESP_OK) {
+        printf("WARNING: failed to send pending SPI bulk writes\n");
+    }
+    spi_write_mode = LGW_COM_WRITE_MODE_SINGLE;
+    spi_bulk_saved = 0;
+
     ret = spi_bus_remove_device(*spi);
     ESP_ERROR_CHECK(ret);
     // printf("ret = %d\n", ret);
@@ -115,6 +417,8 @@ int lgw_spi_close(spi_device_handle_t *spi)
     ESP_ERROR_CHECK(ret);
     // printf("ret = %d\n", ret);
 
+    spi_dma_free();
+
     free(spi);
     spi = NULL;
     return LGW_SPI_SUCCESS;
@@ -125,6 +429,9 @@ int lgw_spi_w(spi_device_handle_t *spi, uint8_t spi_mux_target, uint16_t address
 {
     esp_err_t err;
 
+    if(spi_write_mode == LGW_COM_WRITE_MODE_BULK)
+        return spi_bulk_record(spi, spi_mux_target, address, &data, 1);
+
     err = spi_device_acquire_bus(*spi, portMAX_DELAY);
     if(err != ESP_OK)
         return err;
@@ -144,8 +451,8 @@ int lgw_spi_w(spi_device_handle_t *spi, uint8_t spi_mux_target, uint16_t address
 }
 
 #ifdef USE_SPI_TRANSACTION_EXT
-/* Simple read */
-int lgw_spi_r(spi_device_handle_t *spi, uint8_t spi_mux_target, uint16_t address, uint8_t *data)
+/* Simple read, ignoring the bulk mode */
+static int spi_r(spi_device_handle_t *spi, uint8_t spi_mux_target, uint16_t address, uint8_t *data)
 {
     spi_transaction_ext_t et;
 
@@ -178,8 +485,10 @@ int lgw_spi_rmw(spi_device_handle_t *spi, uint8_t spi_mux_target, uint16_t addre
     int spi_stat = LGW_SPI_SUCCESS;
     uint8_t buf[4] = "\x00\x00\x00\x00";
 
-    /* Read */
-    spi_stat += lgw_spi_r(spi, spi_mux_target, address, &buf[0]);
+    /* Read: in bulk mode, a byte still pending is not written yet on the chip */
+    if((spi_write_mode != LGW_COM_WRITE_MODE_BULK) || (spi_bulk_lookup(spi_mux_target, address, &buf[0]) == false)) {
+        spi_stat += spi_r(spi, spi_mux_target, address, &buf[0]);
+    }
 
     /* Modify */
     buf[1] = ((1 << leng) - 1) << offs; /* bit mask */
@@ -195,7 +504,7 @@ int lgw_spi_rmw(spi_device_handle_t *spi, uint8_t spi_mux_target, uint16_t addre
 
 #else
 
-int lgw_spi_r(spi_device_handle_t *spi, uint8_t spi_mux_target, uint16_t address, uint8_t *data)
+static int spi_r(spi_device_handle_t *spi, uint8_t spi_mux_target, uint16_t address, uint8_t *data)
 {
     uint8_t rbuf[5];
     uint8_t tbuf[5];
@@ -227,6 +536,18 @@ int lgw_spi_r(spi_device_handle_t *spi, uint8_t spi_mux_target, uint16_t address
 }
 #endif
 
+/* Simple read */
+int lgw_spi_r(spi_device_handle_t *spi, uint8_t spi_mux_target, uint16_t address, uint8_t *data)
+{
+    esp_err_t err;
+
+    err = spi_bulk_sync(spi);
+    if(err != ESP_OK)
+        return err;
+
+    return spi_r(spi, spi_mux_target, address, data);
+}
+
 /* Burst (multiple-byte) write */
 int lgw_spi_wb(spi_device_handle_t *spi, uint8_t spi_mux_target, uint16_t address, const uint8_t *data, uint16_t size)
 {
@@ -236,6 +557,14 @@ int lgw_spi_wb(spi_device_handle_t *spi, uint8_t spi_mux_target, uint16_t addres
     int byte_transfered = 0;
     uint8_t rbuf[LGW_BURST_CHUNK] = {0x00};
 
+    if(spi_write_mode == LGW_COM_WRITE_MODE_BULK) {
+        if(size <= LGW_SPI_BULK_SIZE)
+            return spi_bulk_record(spi, spi_mux_target, address, data, size);
+        err = spi_bulk_sync(spi);
+        if(err != ESP_OK)
+            return err;
+    }
+
     err = spi_device_acquire_bus(*spi, portMAX_DELAY);
     if(err != ESP_OK)
         return err;
@@ -246,6 +575,13 @@ int lgw_spi_wb(spi_device_handle_t *spi, uint8_t spi_mux_target, uint16_t addres
     et.base.cmd = spi_mux_target;
     et.base.addr = WRITE_ACCESS | (address & ADDR_MASK);
     et.base.flags = SPI_TRANS_VARIABLE_CMD | SPI_TRANS_VARIABLE_ADDR;
+
+    if(spi_use_queued(size)) {
+        err = spi_burst_queued(spi, &et, data, NULL, size);
+        spi_device_release_bus(*spi);
+        return err;
+    }
+
     et.base.rx_buffer = rbuf;
 
     size_to_do = size;
@@ -257,7 +593,7 @@ int lgw_spi_wb(spi_device_handle_t *spi, uint8_t spi_mux_target, uint16_t addres
         et.base.rxlength = chunk_size * 8;
         err = spi_device_polling_transmit(*spi, (spi_transaction_t *)&et);
         if(err != ESP_OK)
-            return err;
+            break;
 
         byte_transfered += chunk_size;
         DEBUG_PRINTF("BURST WRITE: to trans %d # chunk %d # transferred %d \n", size_to_do, chunk_size, byte_transfered);
@@ -288,6 +624,10 @@ int lgw_spi_rb(spi_device_handle_t *spi, uint8_t spi_mux_target, uint16_t addres
     int byte_transfered = 0;
     uint8_t tbuf[LGW_BURST_CHUNK] = {0x00};
 
+    err = spi_bulk_sync(spi);
+    if(err != ESP_OK)
+        return err;
+
     err = spi_device_acquire_bus(*spi, portMAX_DELAY);
     if(err != ESP_OK)
         return err;
@@ -298,6 +638,13 @@ int lgw_spi_rb(spi_device_handle_t *spi, uint8_t spi_mux_target, uint16_t addres
     et.base.cmd = spi_mux_target;
     et.base.addr = ((READ_ACCESS | (address & ADDR_MASK)) << 8) | 0x00;
     et.base.flags = SPI_TRANS_VARIABLE_CMD | SPI_TRANS_VARIABLE_ADDR;
+
+    if(spi_use_queued(size)) {
+        err = spi_burst_queued(spi, &et, NULL, data, size);
+        spi_device_release_bus(*spi);
+        return err;
+    }
+
     //et.base.tx_data[0] = 0x00;
     et.base.tx_buffer = tbuf;
     //et.base.length = 8;
@@ -311,7 +658,7 @@ int lgw_spi_rb(spi_device_handle_t *spi, uint8_t spi_mux_target, uint16_t addres
         et.base.rxlength = chunk_size * 8;
         err = spi_device_polling_transmit(*spi, (spi_transaction_t *)&et);
         if(err != ESP_OK)
-            return err;
+            break;
 
         byte_transfered += chunk_size;
         DEBUG_PRINTF("BURST WRITE: to trans %d # chunk %d # transferred %d \n", size_to_do, chunk_size, byte_transfered);
@@ -346,6 +693,10 @@ int radio_spi_wb(spi_device_handle_t *spi, uint8_t spi_mux_target, uint8_t op_co
         return LGW_SPI_ERROR;
     }
 
+    err = spi_bulk_sync(spi);
+    if(err != ESP_OK)
+        return err;
+
     err = spi_device_acquire_bus(*spi, portMAX_DELAY);
     if(err != ESP_OK)
         return err;
@@ -382,6 +733,10 @@ int radio_spi_rb(spi_device_handle_t *spi, uint8_t spi_mux_target, uint8_t op_co
         return LGW_SPI_ERROR;
     }
 
+    err = spi_bulk_sync(spi);
+    if(err != ESP_OK)
+        return err;
+
     err = spi_device_acquire_bus(*spi, portMAX_DELAY);
     if(err != ESP_OK)
         return err;
@@ -418,6 +773,10 @@ int sx1261_spi_wb(spi_device_handle_t *spi, uint8_t op_code, const uint8_t *data
         return LGW_SPI_ERROR;
     }
 
+    err = spi_bulk_sync(spi);
+    if(err != ESP_OK)
+        return err;
+
     err = spi_device_acquire_bus(*spi, portMAX_DELAY);
     if(err != ESP_OK)
         return err;
@@ -452,6 +811,10 @@ int sx1261_spi_rb(spi_device_handle_t *spi, uint8_t op_code, uint8_t *data, uint
         return LGW_SPI_ERROR;
     }
 
+    err = spi_bulk_sync(spi);
+    if(err != ESP_OK)
+        return err;
+
     err = spi_device_acquire_bus(*spi, portMAX_DELAY);
     if(err != ESP_OK)
         return err;
@@ -476,3 +839,65 @@ int sx1261_spi_rb(spi_device_handle_t *spi, uint8_t op_code, uint8_t *data, uint
 uint16_t lgw_spi_chunk_size(void) {
     return (uint16_t)LGW_BURST_CHUNK;
 }
+
+int lgw_spi_set_xfer_mode(lgw_spi_xfer_mode_t mode) {
+    if((mode != LGW_SPI_XFER_POLLING) && (mode != LGW_SPI_XFER_QUEUED)) {
+        DEBUG_MSG("ERROR: WRONG SPI TRANSFER MODE\n");
+        return LGW_SPI_ERROR;
+    }
+
+    spi_xfer_mode = mode;
+    return LGW_SPI_SUCCESS;
+}
+
+lgw_spi_xfer_mode_t lgw_spi_get_xfer_mode(void) {
+    return spi_xfer_mode;
+}
+
+int lgw_spi_set_write_mode(spi_device_handle_t *spi, lgw_com_write_mode_t write_mode) {
+    CHECK_NULL(spi);
+
+    if(write_mode >= LGW_COM_WRITE_MODE_UNKNOWN) {
+        DEBUG_PRINTF("ERROR: wrong write mode %d\n", write_mode);
+        return LGW_SPI_ERROR;
+    }
+
+    if((write_mode == LGW_COM_WRITE_MODE_BULK) && (spi_bulk_data == NULL)) {
+        /* no DMA buffer to record into, keep writing straight away */
+        DEBUG_MSG("WARNING: SPI bulk mode not available, staying in single mode\n");
+        return LGW_SPI_SUCCESS;
+    }
+
+    /* leaving bulk mode: what has been recorded goes first */
+    if(write_mode == LGW_COM_WRITE_MODE_SINGLE) {
+        if(spi_bulk_sync(spi) != ESP_OK) {
+            spi_write_mode = write_mode;
+            return LGW_SPI_ERROR;
+        }
+    }
+
+    spi_write_mode = write_mode;
+    return LGW_SPI_SUCCESS;
+}
+
+int lgw_spi_flush(spi_device_handle_t *spi) {
+    esp_err_t err;
+
+    CHECK_NULL(spi);
+
+    if(spi_write_mode != LGW_COM_WRITE_MODE_BULK) {
+        /* nothing recorded in single mode */
+        return LGW_SPI_SUCCESS;
+    }
+
+    err = spi_bulk_send(spi);
+
+    /* back to single mode, as for USB */
+    spi_write_mode = LGW_COM_WRITE_MODE_SINGLE;
+
+    return (err == ESP_OK) ? LGW_SPI_SUCCESS : LGW_SPI_ERROR;
+}
+
+uint32_t lgw_spi_get_bulk_saved(void) {
+    return spi_bulk_saved;
+}
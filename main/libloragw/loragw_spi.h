@@ -23,17 +23,33 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 
 #include "driver/spi_master.h"
 #include "config.h"    /* library configuration options (dynamically generated) */
+#include "loragw_com.h"
 
 
 #define LGW_SPI_SUCCESS     0
 #define LGW_SPI_ERROR       -1
 #define LGW_BURST_CHUNK     1024
 
+#define LGW_SPI_QUEUE_DEPTH     3   /* max number of burst chunks in flight in queued mode */
+#define LGW_SPI_QUEUED_MIN_SIZE 64  /* smaller bursts are always done in polling mode */
+
+#define LGW_SPI_BULK_SIZE       1024    /* bytes recorded in bulk mode before an automatic flush */
+#define LGW_SPI_BULK_BURST_NB   64      /* bursts recorded in bulk mode before an automatic flush */
+
 #define SPI_SPEED           2000000
 #ifndef SX1302_SPI_HOST
 #define SX1302_SPI_HOST     HSPI_HOST
 #endif
 
+/**
+@enum lgw_spi_xfer_mode_t
+@brief How burst transfers are handed to the SPI driver
+*/
+typedef enum spi_xfer_mode_e {
+    LGW_SPI_XFER_POLLING,   /*!> one blocking polling transaction per chunk, CPU busy-waits */
+    LGW_SPI_XFER_QUEUED     /*!> chunks queued to the DMA engine, calling task sleeps */
+} lgw_spi_xfer_mode_t;
+
 
 /**
 @brief LoRa concentrator SPI setup (configure I/O and peripherals)
@@ -118,4 +134,41 @@ int sx1261_spi_rb(spi_device_handle_t *spi, uint8_t op_code, uint8_t *data, uint
 
 uint16_t lgw_spi_chunk_size(void);
 
+/**
+@brief Select how burst transfers are done (queued mode is the default)
+@param mode LGW_SPI_XFER_POLLING or LGW_SPI_XFER_QUEUED
+@return status of operation (LGW_SPI_SUCCESS/LGW_SPI_ERROR)
+*/
+int lgw_spi_set_xfer_mode(lgw_spi_xfer_mode_t mode);
+
+/**
+@brief Get the current burst transfer mode
+@return LGW_SPI_XFER_POLLING or LGW_SPI_XFER_QUEUED
+*/
+lgw_spi_xfer_mode_t lgw_spi_get_xfer_mode(void);
+
+/**
+@brief Select the write mode. In bulk mode, writes are recorded and sent at the next
+lgw_spi_flush(); writes to consecutive addresses are merged in a single burst.
+Any read, and leaving bulk mode, sends the recorded writes first.
+@param spi spi device handle
+@param write_mode LGW_COM_WRITE_MODE_SINGLE or LGW_COM_WRITE_MODE_BULK
+@return status of operation (LGW_SPI_SUCCESS/LGW_SPI_ERROR)
+*/
+int lgw_spi_set_write_mode(spi_device_handle_t *spi, lgw_com_write_mode_t write_mode);
+
+/**
+@brief Send the writes recorded in bulk mode as one chain of DMA transactions, and
+get back to single mode
+@param spi spi device handle
+@return status of operation (LGW_SPI_SUCCESS/LGW_SPI_ERROR)
+*/
+int lgw_spi_flush(spi_device_handle_t *spi);
+
+/**
+@brief Get the number of SPI transactions saved by merging bulk writes since open
+@return number of transactions saved
+*/
+uint32_t lgw_spi_get_bulk_saved(void);
+
 #endif
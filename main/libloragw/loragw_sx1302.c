@@ -24,15 +24,18 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 #include <time.h>
 
 #include "loragw_reg.h"
+#include "loragw_reg_inline.h"
 #include "loragw_aux.h"
 #include "loragw_hal.h"
 #include "loragw_sx1302.h"
 #include "loragw_sx1302_timestamp.h"
 #include "loragw_sx1302_rx.h"
+#include "loragw_rxpool.h"
 #include "loragw_sx1250.h"
 #include "loragw_agc_params.h"
 #include "loragw_cal.h"
 #include "loragw_debug.h"
+#include "crc16.h"
 
 /* -------------------------------------------------------------------------- */
 /* --- PRIVATE MACROS ------------------------------------------------------- */
@@ -145,11 +148,13 @@ extern int32_t lgw_sf_getval(int x);
 extern int32_t lgw_bw_getval(int x);
 
 /**
-@brief TODO
-@param TODO
-@return TODO
+@brief Fill the metadata of a packet popped from the RX buffer
+@param context      Gateway configuration context
+@param pkt          The packet as popped from the RX buffer
+@param p            The structure to get the packet parsed, its payload pointer being set
+@return LGW_REG_SUCCESS if the packet could be parsed, LGW_REG_ERROR otherwise
 */
-void lora_crc16(const char data, int *crc);
+static int sx1302_parse_metadata(lgw_context_t * context, const rx_packet_t * pkt, struct lgw_pkt_rx_desc_s * p);
 
 /* -------------------------------------------------------------------------- */
 /* --- INTERNAL SHARED VARIABLES -------------------------------------------- */
@@ -190,29 +195,6 @@ int calculate_freq_to_time_drift(uint32_t freq_hz, uint8_t bw, uint16_t * mant,
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
-void lora_crc16(const char data, int *crc) {
-    int next = 0;
-    next  =  (((data>>0)&1) ^ ((*crc>>12)&1) ^ ((*crc>> 8)&1)                 )      ;
-    next += ((((data>>1)&1) ^ ((*crc>>13)&1) ^ ((*crc>> 9)&1)                 )<<1 ) ;
-    next += ((((data>>2)&1) ^ ((*crc>>14)&1) ^ ((*crc>>10)&1)                 )<<2 ) ;
-    next += ((((data>>3)&1) ^ ((*crc>>15)&1) ^ ((*crc>>11)&1)                 )<<3 ) ;
-    next += ((((data>>4)&1) ^ ((*crc>>12)&1)                                  )<<4 ) ;
-    next += ((((data>>5)&1) ^ ((*crc>>13)&1) ^ ((*crc>>12)&1) ^ ((*crc>> 8)&1))<<5 ) ;
-    next += ((((data>>6)&1) ^ ((*crc>>14)&1) ^ ((*crc>>13)&1) ^ ((*crc>> 9)&1))<<6 ) ;
-    next += ((((data>>7)&1) ^ ((*crc>>15)&1) ^ ((*crc>>14)&1) ^ ((*crc>>10)&1))<<7 ) ;
-    next += ((((*crc>>0)&1) ^ ((*crc>>15)&1) ^ ((*crc>>11)&1)                 )<<8 ) ;
-    next += ((((*crc>>1)&1) ^ ((*crc>>12)&1)                                  )<<9 ) ;
-    next += ((((*crc>>2)&1) ^ ((*crc>>13)&1)                                  )<<10) ;
-    next += ((((*crc>>3)&1) ^ ((*crc>>14)&1)                                  )<<11) ;
-    next += ((((*crc>>4)&1) ^ ((*crc>>15)&1) ^ ((*crc>>12)&1) ^ ((*crc>> 8)&1))<<12) ;
-    next += ((((*crc>>5)&1) ^ ((*crc>>13)&1) ^ ((*crc>> 9)&1)                 )<<13) ;
-    next += ((((*crc>>6)&1) ^ ((*crc>>14)&1) ^ ((*crc>>10)&1)                 )<<14) ;
-    next += ((((*crc>>7)&1) ^ ((*crc>>15)&1) ^ ((*crc>>11)&1)                 )<<15) ;
-    (*crc) = next;
-}
-
-/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
-
 int sx1302_config_gpio(void) {
     int err;
 
@@ -886,90 +868,91 @@ int sx1302_lora_modem_configure(uint32_t radio_freq_hz) {
     uint8_t exponent = 0;
     int err = LGW_REG_SUCCESS;
 
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_DC_NOTCH_CFG1_ENABLE, 0x00);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_RX_DFE_AGC1_FORCE_DEFAULT_FIR, 0x01);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_DAGC_CFG_GAIN_DROP_COMP, 0x01);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_DAGC_CFG_TARGET_LVL, 0x01);
+    /* Register-heavy sequence: compile-time accessors, fields sharing a byte written at once */
+    err |= LGW_REG_W(RX_TOP_DC_NOTCH_CFG1_ENABLE, 0x00);
+    err |= LGW_REG_W(RX_TOP_RX_DFE_AGC1_FORCE_DEFAULT_FIR, 0x01);
+    err |= LGW_REG_W2(RX_TOP_DAGC_CFG_GAIN_DROP_COMP, 0x01,
+                      RX_TOP_DAGC_CFG_TARGET_LVL, 0x01);
 
     /* Enable full modems */
     DEBUG_MSG("Configuring 8 full-SF modems\n");
-    err |= lgw_reg_w(SX1302_REG_OTP_MODEM_EN_0_MODEM_EN, 0xFF);
+    err |= LGW_REG_W(OTP_MODEM_EN_0_MODEM_EN, 0xFF);
 
     /* Enable limited modems */
     DEBUG_MSG("Configuring 8 limited-SF modems\n");
-    err |= lgw_reg_w(SX1302_REG_OTP_MODEM_EN_1_MODEM_EN, 0xFF);
+    err |= LGW_REG_W(OTP_MODEM_EN_1_MODEM_EN, 0xFF);
 
     /* Configure coarse sync between correlators and modems */
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_MODEM_SYNC_DELTA_MSB_MODEM_SYNC_DELTA, 0);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_MODEM_SYNC_DELTA_LSB_MODEM_SYNC_DELTA, 126);
+    err |= LGW_REG_W(RX_TOP_MODEM_SYNC_DELTA_MSB_MODEM_SYNC_DELTA, 0);
+    err |= LGW_REG_W(RX_TOP_MODEM_SYNC_DELTA_LSB_MODEM_SYNC_DELTA, 126);
 
     /* Configure fine sync offset for each channel */
-    err |= lgw_reg_w(SX1302_REG_ARB_MCU_CHANNEL_SYNC_OFFSET_01_CHANNEL_0_OFFSET, 1);
-    err |= lgw_reg_w(SX1302_REG_ARB_MCU_CHANNEL_SYNC_OFFSET_01_CHANNEL_1_OFFSET, 5);
-    err |= lgw_reg_w(SX1302_REG_ARB_MCU_CHANNEL_SYNC_OFFSET_23_CHANNEL_2_OFFSET, 9);
-    err |= lgw_reg_w(SX1302_REG_ARB_MCU_CHANNEL_SYNC_OFFSET_23_CHANNEL_3_OFFSET, 13);
-    err |= lgw_reg_w(SX1302_REG_ARB_MCU_CHANNEL_SYNC_OFFSET_45_CHANNEL_4_OFFSET, 1);
-    err |= lgw_reg_w(SX1302_REG_ARB_MCU_CHANNEL_SYNC_OFFSET_45_CHANNEL_5_OFFSET, 5);
-    err |= lgw_reg_w(SX1302_REG_ARB_MCU_CHANNEL_SYNC_OFFSET_67_CHANNEL_6_OFFSET, 9);
-    err |= lgw_reg_w(SX1302_REG_ARB_MCU_CHANNEL_SYNC_OFFSET_67_CHANNEL_7_OFFSET, 13);
+    err |= LGW_REG_W2(ARB_MCU_CHANNEL_SYNC_OFFSET_01_CHANNEL_0_OFFSET, 1,
+                      ARB_MCU_CHANNEL_SYNC_OFFSET_01_CHANNEL_1_OFFSET, 5);
+    err |= LGW_REG_W2(ARB_MCU_CHANNEL_SYNC_OFFSET_23_CHANNEL_2_OFFSET, 9,
+                      ARB_MCU_CHANNEL_SYNC_OFFSET_23_CHANNEL_3_OFFSET, 13);
+    err |= LGW_REG_W2(ARB_MCU_CHANNEL_SYNC_OFFSET_45_CHANNEL_4_OFFSET, 1,
+                      ARB_MCU_CHANNEL_SYNC_OFFSET_45_CHANNEL_5_OFFSET, 5);
+    err |= LGW_REG_W2(ARB_MCU_CHANNEL_SYNC_OFFSET_67_CHANNEL_6_OFFSET, 9,
+                      ARB_MCU_CHANNEL_SYNC_OFFSET_67_CHANNEL_7_OFFSET, 13);
 
     /* Configure PPM offset */
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_MODEM_PPM_OFFSET1_PPM_OFFSET_SF5, 0x00);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_MODEM_PPM_OFFSET1_PPM_OFFSET_SF6, 0x00);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_MODEM_PPM_OFFSET1_PPM_OFFSET_SF7, 0x00);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_MODEM_PPM_OFFSET1_PPM_OFFSET_SF8, 0x00);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_MODEM_PPM_OFFSET2_PPM_OFFSET_SF9, 0x00);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_MODEM_PPM_OFFSET2_PPM_OFFSET_SF10, 0x00);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_MODEM_PPM_OFFSET2_PPM_OFFSET_SF11, 0x01);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_MODEM_PPM_OFFSET2_PPM_OFFSET_SF12, 0x01);
+    err |= LGW_REG_W4(RX_TOP_MODEM_PPM_OFFSET1_PPM_OFFSET_SF5, 0x00,
+                      RX_TOP_MODEM_PPM_OFFSET1_PPM_OFFSET_SF6, 0x00,
+                      RX_TOP_MODEM_PPM_OFFSET1_PPM_OFFSET_SF7, 0x00,
+                      RX_TOP_MODEM_PPM_OFFSET1_PPM_OFFSET_SF8, 0x00);
+    err |= LGW_REG_W4(RX_TOP_MODEM_PPM_OFFSET2_PPM_OFFSET_SF9, 0x00,
+                      RX_TOP_MODEM_PPM_OFFSET2_PPM_OFFSET_SF10, 0x00,
+                      RX_TOP_MODEM_PPM_OFFSET2_PPM_OFFSET_SF11, 0x01,
+                      RX_TOP_MODEM_PPM_OFFSET2_PPM_OFFSET_SF12, 0x01);
 
     /* Improve SF5 and SF6 performances */
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FINE_TIMING_A_1_GAIN_P_AUTO, 3); // Default is 1
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FINE_TIMING_A_1_GAIN_P_PAYLOAD, 3); // Default is 2
+    err |= LGW_REG_W2(RX_TOP_FINE_TIMING_A_1_GAIN_P_AUTO, 3, // Default is 1
+                      RX_TOP_FINE_TIMING_A_1_GAIN_P_PAYLOAD, 3); // Default is 2
 
     /* Improve SF11/SF12 performances */
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FINE_TIMING_A_5_GAIN_I_EN_SF11, 1);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FINE_TIMING_A_5_GAIN_I_EN_SF12, 1);
+    err |= LGW_REG_W2(RX_TOP_FINE_TIMING_A_5_GAIN_I_EN_SF11, 1,
+                      RX_TOP_FINE_TIMING_A_5_GAIN_I_EN_SF12, 1);
 
     /* Set threshold for 1bin correction (CAN-314) */
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK4_FREQ_SYNCH_THR, 15);
+    err |= LGW_REG_W(RX_TOP_FREQ_TRACK4_FREQ_SYNCH_THR, 15);
 
     /* Configure modems for best tracking (best demodulation) */
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_A_0_FREQ_TRACK_EN_SF5, RX_FREQ_TRACK_AUTO);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_A_0_FREQ_TRACK_EN_SF6, RX_FREQ_TRACK_AUTO);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_A_0_FREQ_TRACK_EN_SF7, RX_FREQ_TRACK_AUTO);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_A_0_FREQ_TRACK_EN_SF8, RX_FREQ_TRACK_AUTO);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_A_1_FREQ_TRACK_EN_SF9, RX_FREQ_TRACK_AUTO);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_A_1_FREQ_TRACK_EN_SF10, RX_FREQ_TRACK_AUTO);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_A_1_FREQ_TRACK_EN_SF11, RX_FREQ_TRACK_AUTO);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_A_1_FREQ_TRACK_EN_SF12, RX_FREQ_TRACK_AUTO);
+    err |= LGW_REG_W4(RX_TOP_FREQ_TRACK_A_0_FREQ_TRACK_EN_SF5, RX_FREQ_TRACK_AUTO,
+                      RX_TOP_FREQ_TRACK_A_0_FREQ_TRACK_EN_SF6, RX_FREQ_TRACK_AUTO,
+                      RX_TOP_FREQ_TRACK_A_0_FREQ_TRACK_EN_SF7, RX_FREQ_TRACK_AUTO,
+                      RX_TOP_FREQ_TRACK_A_0_FREQ_TRACK_EN_SF8, RX_FREQ_TRACK_AUTO);
+    err |= LGW_REG_W4(RX_TOP_FREQ_TRACK_A_1_FREQ_TRACK_EN_SF9, RX_FREQ_TRACK_AUTO,
+                      RX_TOP_FREQ_TRACK_A_1_FREQ_TRACK_EN_SF10, RX_FREQ_TRACK_AUTO,
+                      RX_TOP_FREQ_TRACK_A_1_FREQ_TRACK_EN_SF11, RX_FREQ_TRACK_AUTO,
+                      RX_TOP_FREQ_TRACK_A_1_FREQ_TRACK_EN_SF12, RX_FREQ_TRACK_AUTO);
 
     /* Configure modems for best timestamping (only valid when double demodulation is enabled) */
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_B_0_FREQ_TRACK_EN_SF5, RX_FREQ_TRACK_OFF);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_B_0_FREQ_TRACK_EN_SF6, RX_FREQ_TRACK_OFF);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_B_0_FREQ_TRACK_EN_SF7, RX_FREQ_TRACK_OFF);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_B_0_FREQ_TRACK_EN_SF8, RX_FREQ_TRACK_OFF);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_B_1_FREQ_TRACK_EN_SF9, RX_FREQ_TRACK_OFF);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_B_1_FREQ_TRACK_EN_SF10, RX_FREQ_TRACK_OFF);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_B_1_FREQ_TRACK_EN_SF11, RX_FREQ_TRACK_OFF);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_B_1_FREQ_TRACK_EN_SF12, RX_FREQ_TRACK_OFF);
+    err |= LGW_REG_W4(RX_TOP_FREQ_TRACK_B_0_FREQ_TRACK_EN_SF5, RX_FREQ_TRACK_OFF,
+                      RX_TOP_FREQ_TRACK_B_0_FREQ_TRACK_EN_SF6, RX_FREQ_TRACK_OFF,
+                      RX_TOP_FREQ_TRACK_B_0_FREQ_TRACK_EN_SF7, RX_FREQ_TRACK_OFF,
+                      RX_TOP_FREQ_TRACK_B_0_FREQ_TRACK_EN_SF8, RX_FREQ_TRACK_OFF);
+    err |= LGW_REG_W4(RX_TOP_FREQ_TRACK_B_1_FREQ_TRACK_EN_SF9, RX_FREQ_TRACK_OFF,
+                      RX_TOP_FREQ_TRACK_B_1_FREQ_TRACK_EN_SF10, RX_FREQ_TRACK_OFF,
+                      RX_TOP_FREQ_TRACK_B_1_FREQ_TRACK_EN_SF11, RX_FREQ_TRACK_OFF,
+                      RX_TOP_FREQ_TRACK_B_1_FREQ_TRACK_EN_SF12, RX_FREQ_TRACK_OFF);
     /* -- */
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FINE_TIMING_B_5_GAIN_I_EN_SF11, 0);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FINE_TIMING_B_5_GAIN_I_EN_SF12, 0);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FINE_TIMING_B_0_ROUNDING, 1);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FINE_TIMING_B_0_MODE, RX_FINE_TIMING_MODE_LINEAR);
+    err |= LGW_REG_W2(RX_TOP_FINE_TIMING_B_5_GAIN_I_EN_SF11, 0,
+                      RX_TOP_FINE_TIMING_B_5_GAIN_I_EN_SF12, 0);
+    err |= LGW_REG_W2(RX_TOP_FINE_TIMING_B_0_ROUNDING, 1,
+                      RX_TOP_FINE_TIMING_B_0_MODE, RX_FINE_TIMING_MODE_LINEAR);
     /* -- */
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FINE_TIMING_B_1_GAIN_P_AUTO, 0);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FINE_TIMING_B_1_GAIN_P_PREAMB, 6);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FINE_TIMING_B_1_GAIN_P_PAYLOAD, 2);
+    err |= LGW_REG_W3(RX_TOP_FINE_TIMING_B_1_GAIN_P_AUTO, 0,
+                      RX_TOP_FINE_TIMING_B_1_GAIN_P_PREAMB, 6,
+                      RX_TOP_FINE_TIMING_B_1_GAIN_P_PAYLOAD, 2);
     /* -- */
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FINE_TIMING_B_2_GAIN_I_AUTO, 0);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FINE_TIMING_B_2_GAIN_I_PREAMB, 1);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FINE_TIMING_B_2_GAIN_I_PAYLOAD, 0);
+    err |= LGW_REG_W3(RX_TOP_FINE_TIMING_B_2_GAIN_I_AUTO, 0,
+                      RX_TOP_FINE_TIMING_B_2_GAIN_I_PREAMB, 1,
+                      RX_TOP_FINE_TIMING_B_2_GAIN_I_PAYLOAD, 0);
 
     /* Set preamble size to 10 (to handle 12 for SF5/SF6 and 8 for SF7->SF12) */
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_TXRX_CFG7_PREAMBLE_SYMB_NB,  0); /* MSB */
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_TXRX_CFG6_PREAMBLE_SYMB_NB, 10); /* LSB */
+    err |= LGW_REG_W(RX_TOP_TXRX_CFG7_PREAMBLE_SYMB_NB,  0); /* MSB */
+    err |= LGW_REG_W(RX_TOP_TXRX_CFG6_PREAMBLE_SYMB_NB, 10); /* LSB */
 
     /* Freq2TimeDrift computation */
     if (calculate_freq_to_time_drift(radio_freq_hz, BW_125KHZ, &mantissa, &exponent) != 0) {
@@ -977,15 +960,15 @@ int sx1302_lora_modem_configure(uint32_t radio_freq_hz) {
         return LGW_REG_ERROR;
     }
     DEBUG_PRINTF("Freq2TimeDrift MultiSF: Mantissa = %d (0x%02X, 0x%02X), Exponent = %d (0x%02X)\n", mantissa, (mantissa >> 8) & 0x00FF, (mantissa) & 0x00FF, exponent, exponent);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TO_TIME0_FREQ_TO_TIME_DRIFT_MANT, (mantissa >> 8) & 0x00FF);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TO_TIME1_FREQ_TO_TIME_DRIFT_MANT, (mantissa) & 0x00FF);
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TO_TIME2_FREQ_TO_TIME_DRIFT_EXP, exponent);
+    err |= LGW_REG_W(RX_TOP_FREQ_TO_TIME0_FREQ_TO_TIME_DRIFT_MANT, (mantissa >> 8) & 0x00FF);
+    err |= LGW_REG_W(RX_TOP_FREQ_TO_TIME1_FREQ_TO_TIME_DRIFT_MANT, (mantissa) & 0x00FF);
+    err |= LGW_REG_W(RX_TOP_FREQ_TO_TIME2_FREQ_TO_TIME_DRIFT_EXP, exponent);
 
     /* Time drift compensation */
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TO_TIME3_FREQ_TO_TIME_INVERT_TIME_SYMB, 1);
+    err |= LGW_REG_W(RX_TOP_FREQ_TO_TIME3_FREQ_TO_TIME_INVERT_TIME_SYMB, 1);
 
     /* DFT peak mode : set to AUTO, check timestamp_counter_correction() if changed */
-    err |= lgw_reg_w(SX1302_REG_RX_TOP_RX_CFG0_DFT_PEAK_EN, RX_DFT_PEAK_MODE_AUTO);
+    err |= LGW_REG_W(RX_TOP_RX_CFG0_DFT_PEAK_EN, RX_DFT_PEAK_MODE_AUTO);
 
     return err;
 }
@@ -1867,14 +1850,7 @@ int sx1302_fetch(uint8_t * nb_pkt) {
 
     /* Fetch packets from sx1302 if no more left in RX buffer */
     if (rx_buffer.buffer_pkt_nb == 0) {
-        /* Initialize RX buffer */
-        err = rx_buffer_new(&rx_buffer);
-        if (err != LGW_REG_SUCCESS) {
-            printf("ERROR: Failed to initialize RX buffer\n");
-            return LGW_REG_ERROR;
-        }
-
-        /* Fetch RX buffer if any data available */
+        /* Fetch RX buffer if any data available, completing a packet partially fetched before */
         err = rx_buffer_fetch(&rx_buffer);
         if (err != LGW_REG_SUCCESS) {
             printf("ERROR: Failed to fetch RX buffer\n");
@@ -1894,7 +1870,8 @@ int sx1302_fetch(uint8_t * nb_pkt) {
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
-int sx1302_parse(lgw_context_t * context, struct lgw_pkt_rx_s * p) {
+/* Fill the packet metadata from the RX buffer packet, its payload being already in place */
+static int sx1302_parse_metadata(lgw_context_t * context, const rx_packet_t * pkt, struct lgw_pkt_rx_desc_s * p) {
     int err;
     int ifmod; /* type of if_chain/modem a packet was received by */
     int32_t if_freq_hz;
@@ -1903,39 +1880,11 @@ int sx1302_parse(lgw_context_t * context, struct lgw_pkt_rx_s * p) {
     uint16_t payload_crc16_calc;
     uint8_t cr;
     int32_t timestamp_correction;
-    rx_packet_t pkt;
-    struct timeval tm;
-
-    /* Record function start time */
-    _meas_time_start(&tm);
 
-    /* Check input params */
-    CHECK_NULL(context);
-    CHECK_NULL(p);
+    p->size = pkt->rxbytenb_modem;
 
-#if 0
-    /* For DEBUG: WARNING: it is quite time consuming in USB mode, due to SPI over USB latency
-        Print statistics of number of detects and modem allocations from ARB for configured SF (see sx1302_arb_start())
-    */
-    sx1302_arb_print_debug_stats();
-#endif
-
-    /* get packet from RX buffer */
-    err = rx_buffer_pop(&rx_buffer, &pkt);
-    if (err == LGW_REG_WARNING) {
-        rx_buffer_del(&rx_buffer); /* clear the buffer */
-        return err;
-    } else if (err == LGW_REG_ERROR) {
-        return err;
-    }
-
-    /* copy payload to result struct */
-    memcpy((void *)p->payload, (void *)(&(pkt.payload)), pkt.rxbytenb_modem);
-    p->size = pkt.rxbytenb_modem;
-
-    /* process metadata */
-    p->modem_id = pkt.modem_id;
-    p->if_chain = pkt.rx_channel_in;
+    p->modem_id = pkt->modem_id;
+    p->if_chain = pkt->rx_channel_in;
     if (p->if_chain >= LGW_IF_CHAIN_NB) {
         DEBUG_PRINTF("WARNING: %u NOT A VALID IF_CHAIN NUMBER, ABORTING\n", p->if_chain);
         return LGW_REG_ERROR;
@@ -1949,8 +1898,8 @@ int sx1302_parse(lgw_context_t * context, struct lgw_pkt_rx_s * p) {
     p->freq_hz = (uint32_t)((int32_t)context->rf_chain_cfg[p->rf_chain].freq_hz + context->if_chain_cfg[p->if_chain].freq_hz);
 
     /* Get signal strength : offset and temperature compensation will be applied later */
-    p->rssic = (float)(pkt.rssi_chan_avg);
-    p->rssis = (float)(pkt.rssi_signal_avg);
+    p->rssic = (float)(pkt->rssi_chan_avg);
+    p->rssis = (float)(pkt->rssi_signal_avg);
 
     /* Get modulation metadata */
     if ((ifmod == IF_LORA_MULTI) || (ifmod == IF_LORA_STD)) {
@@ -1958,9 +1907,9 @@ int sx1302_parse(lgw_context_t * context, struct lgw_pkt_rx_s * p) {
         p->modulation = MOD_LORA;
 
         /* Get CRC status */
-        if (pkt.crc_en || ((ifmod == IF_LORA_STD) && (context->lora_service_cfg.implicit_crc_en == true))) {
+        if (pkt->crc_en || ((ifmod == IF_LORA_STD) && (context->lora_service_cfg.implicit_crc_en == true))) {
             /* CRC enabled */
-            if (pkt.payload_crc_error) {
+            if (pkt->payload_crc_error) {
                 p->status = STAT_CRC_BAD;
             } else {
                 p->status = STAT_CRC_OK;
@@ -1968,15 +1917,15 @@ int sx1302_parse(lgw_context_t * context, struct lgw_pkt_rx_s * p) {
                 /* Sanity check of the payload CRC */
                 if (p->size > 0) {
                     payload_crc16_calc = sx1302_lora_payload_crc(p->payload, p->size);
-                    if (payload_crc16_calc != pkt.rx_crc16_value) {
-                        printf("ERROR: Payload CRC16 check failed (got:0x%04X calc:0x%04X)\n", pkt.rx_crc16_value, payload_crc16_calc);
+                    if (payload_crc16_calc != pkt->rx_crc16_value) {
+                        printf("ERROR: Payload CRC16 check failed (got:0x%04X calc:0x%04X)\n", pkt->rx_crc16_value, payload_crc16_calc);
                         if (log_file != NULL) {
-                            fprintf(log_file, "ERROR: Payload CRC16 check failed (got:0x%04X calc:0x%04X)\n", pkt.rx_crc16_value, payload_crc16_calc);
-                            dbg_log_buffer_to_file(log_file, rx_buffer.buffer, rx_buffer.buffer_size);
+                            fprintf(log_file, "ERROR: Payload CRC16 check failed (got:0x%04X calc:0x%04X)\n", pkt->rx_crc16_value, payload_crc16_calc);
+                            dbg_log_buffer_to_file(log_file, rx_buffer.buffer, sizeof rx_buffer.buffer);
                         }
                         return LGW_REG_ERROR;
                     } else {
-                        DEBUG_PRINTF("Payload CRC check OK (0x%04X)\n", pkt.rx_crc16_value);
+                        DEBUG_PRINTF("Payload CRC check OK (0x%04X)\n", pkt->rx_crc16_value);
                     }
                 }
             }
@@ -1996,12 +1945,12 @@ int sx1302_parse(lgw_context_t * context, struct lgw_pkt_rx_s * p) {
             */
             int res;
             for (i = 0; i < context->debug_cfg.nb_ref_payload; i++) {
-                res = dbg_check_payload(&(context->debug_cfg), log_file, p->payload, p->size, i, pkt.rx_rate_sf);
+                res = dbg_check_payload(&(context->debug_cfg), log_file, p->payload, p->size, i, pkt->rx_rate_sf);
                 if (res == -1) {
                     printf("ERROR: 0x%08X payload error\n", context->debug_cfg.ref_payload[i].id);
                     if (log_file != NULL) {
                         fprintf(log_file, "ERROR: 0x%08X payload error\n", context->debug_cfg.ref_payload[i].id);
-                        dbg_log_buffer_to_file(log_file, rx_buffer.buffer, rx_buffer.buffer_size);
+                        dbg_log_buffer_to_file(log_file, rx_buffer.buffer, sizeof rx_buffer.buffer);
                         dbg_log_payload_diff_to_file(log_file, p->payload, context->debug_cfg.ref_payload[i].payload, p->size);
                     }
                     return LGW_REG_ERROR;
@@ -2015,7 +1964,7 @@ int sx1302_parse(lgw_context_t * context, struct lgw_pkt_rx_s * p) {
 #endif
 
         /* Get SNR - converted from 0.25dB step to dB */
-        p->snr = (float)(pkt.snr_average) / 4;
+        p->snr = (float)(pkt->snr_average) / 4;
 
         /* Get bandwidth */
         if (ifmod == IF_LORA_MULTI) {
@@ -2025,7 +1974,7 @@ int sx1302_parse(lgw_context_t * context, struct lgw_pkt_rx_s * p) {
         }
 
         /* Get datarate */
-        switch (pkt.rx_rate_sf) {
+        switch (pkt->rx_rate_sf) {
             case 5: p->datarate = DR_LORA_SF5; break;
             case 6: p->datarate = DR_LORA_SF6; break;
             case 7: p->datarate = DR_LORA_SF7; break;
@@ -2039,7 +1988,7 @@ int sx1302_parse(lgw_context_t * context, struct lgw_pkt_rx_s * p) {
 
         /* Get coding rate */
         if ((ifmod == IF_LORA_MULTI) || (context->lora_service_cfg.implicit_hdr == false)) {
-            cr = pkt.coding_rate;
+            cr = pkt->coding_rate;
         } else {
             cr = context->lora_service_cfg.implicit_coderate;
         }
@@ -2054,13 +2003,13 @@ int sx1302_parse(lgw_context_t * context, struct lgw_pkt_rx_s * p) {
         /* Get frequency offset in Hz depending on bandwidth */
         switch (p->bandwidth) {
             case BW_125KHZ:
-                p->freq_offset = (int32_t)((float)(pkt.frequency_offset_error) * FREQ_OFFSET_LSB_125KHZ);
+                p->freq_offset = (int32_t)((float)(pkt->frequency_offset_error) * FREQ_OFFSET_LSB_125KHZ);
                 break;
             case BW_250KHZ:
-                p->freq_offset = (int32_t)((float)(pkt.frequency_offset_error) * FREQ_OFFSET_LSB_250KHZ);
+                p->freq_offset = (int32_t)((float)(pkt->frequency_offset_error) * FREQ_OFFSET_LSB_250KHZ);
                 break;
             case BW_500KHZ:
-                p->freq_offset = (int32_t)((float)(pkt.frequency_offset_error) * FREQ_OFFSET_LSB_500KHZ);
+                p->freq_offset = (int32_t)((float)(pkt->frequency_offset_error) * FREQ_OFFSET_LSB_500KHZ);
                 break;
             default:
                 p->freq_offset = 0;
@@ -2083,29 +2032,29 @@ int sx1302_parse(lgw_context_t * context, struct lgw_pkt_rx_s * p) {
         p->freq_offset += if_freq_error;
 
         /* Get timestamp correction to be applied to count_us */
-        timestamp_correction = timestamp_counter_correction(context, p->bandwidth, p->datarate, p->coderate, pkt.crc_en, pkt.rxbytenb_modem, RX_DFT_PEAK_MODE_AUTO);
+        timestamp_correction = timestamp_counter_correction(context, p->bandwidth, p->datarate, p->coderate, pkt->crc_en, pkt->rxbytenb_modem, RX_DFT_PEAK_MODE_AUTO);
 
         /* Compute fine timestamp for packets coming from the modem optimized for fine timestamping, if CRC is OK */
         p->ftime_received = false;
         p->ftime = 0;
-        if ((pkt.num_ts_metrics_stored > 0) && (pkt.timing_set == true) && (p->status == STAT_CRC_OK)) {
+        if ((pkt->num_ts_metrics_stored > 0) && (pkt->timing_set == true) && (p->status == STAT_CRC_OK)) {
             /* The actual packet frequency error compared to the channel frequency, need to compute the ftime */
             pkt_freq_error = ((double)(p->freq_hz + p->freq_offset) / (double)(p->freq_hz)) - 1.0;
 
             /* Compute the fine timestamp */
-            err = precise_timestamp_calculate(pkt.num_ts_metrics_stored, &pkt.timestamp_avg[0], pkt.timestamp_cnt, pkt.rx_rate_sf, context->if_chain_cfg[p->if_chain].freq_hz, pkt_freq_error, &(p->ftime));
+            err = precise_timestamp_calculate(pkt->num_ts_metrics_stored, &pkt->timestamp_avg[0], pkt->timestamp_cnt, pkt->rx_rate_sf, context->if_chain_cfg[p->if_chain].freq_hz, pkt_freq_error, &(p->ftime));
             if (err == 0) {
                 p->ftime_received = true;
             }
         }
     } else if (ifmod == IF_FSK_STD) {
-        DEBUG_PRINTF("Note: FSK packet (modem %u chan %u)\n", pkt.modem_id, p->if_chain);
+        DEBUG_PRINTF("Note: FSK packet (modem %u chan %u)\n", pkt->modem_id, p->if_chain);
         p->modulation = MOD_FSK;
 
         /* Get CRC status */
-        if (pkt.crc_en) {
+        if (pkt->crc_en) {
             /* CRC enabled */
-            if (pkt.payload_crc_error) {
+            if (pkt->payload_crc_error) {
                 printf("FSK: CRC ERR\n");
                 p->status = STAT_CRC_BAD;
             } else {
@@ -2147,7 +2096,7 @@ int sx1302_parse(lgw_context_t * context, struct lgw_pkt_rx_s * p) {
     }
 
     /* Scale 32 MHz packet timestamp to 1 MHz (microseconds) */
-    p->count_us = pkt.timestamp_cnt / 32;
+    p->count_us = pkt->timestamp_cnt / 32;
 
     /* Expand 27-bits counter to 32-bits counter, based on current wrapping status (updated after fetch) */
     p->count_us = timestamp_pkt_expand(&counter_us, p->count_us);
@@ -2163,7 +2112,7 @@ int sx1302_parse(lgw_context_t * context, struct lgw_pkt_rx_s * p) {
 
         printf("XXXXXXXXXXXXXXXX inst - ref=%u wrap=%u\n", counter_us.inst.counter_us_27bits_ref, counter_us.inst.counter_us_27bits_wrap);
         printf("XXXXXXXXXXXXXXXX pps  - ref=%u wrap=%u\n", counter_us.pps.counter_us_27bits_ref, counter_us.pps.counter_us_27bits_wrap);
-        printf("XXXXXXXXXXXXXXXX pkt=%u (%u) last=%u diff=%d\n", p->count_us, pkt.timestamp_cnt / 32, last_us32, diff);
+        printf("XXXXXXXXXXXXXXXX pkt=%u (%u) last=%u diff=%d\n", p->count_us, pkt->timestamp_cnt / 32, last_us32, diff);
         printf("XXXXXXXXXXXXXXXX pkt num=%u\n", pkt_num);
         if (last_valid && (diff > 30000000) && (pkt_num == (last_pkt_num + 1))) {
             printf("XXXXXXXXXXXXXXXX ERROR jump ahead count_us\n");
@@ -2179,7 +2128,66 @@ int sx1302_parse(lgw_context_t * context, struct lgw_pkt_rx_s * p) {
     p->count_us = p->count_us + timestamp_correction;
 
     /* Packet CRC status */
-    p->crc = pkt.rx_crc16_value;
+    p->crc = pkt->rx_crc16_value;
+
+    return LGW_REG_SUCCESS;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+int sx1302_parse(lgw_context_t * context, struct lgw_pkt_rx_s * p) {
+    int err;
+    rx_packet_t pkt;
+    struct lgw_pkt_rx_desc_s d;
+    struct timeval tm;
+
+    /* Record function start time */
+    _meas_time_start(&tm);
+
+    /* Check input params */
+    CHECK_NULL(context);
+    CHECK_NULL(p);
+
+#if 0
+    /* For DEBUG: WARNING: it is quite time consuming in USB mode, due to SPI over USB latency
+        Print statistics of number of detects and modem allocations from ARB for configured SF (see sx1302_arb_start())
+    */
+    sx1302_arb_print_debug_stats();
+#endif
+
+    /* get packet from RX buffer, with its payload copied straight to the result struct,
+       a corrupted packet is dropped and the following ones are kept */
+    err = rx_buffer_pop_to(&rx_buffer, &pkt, p->payload);
+    if (err != LGW_REG_SUCCESS) {
+        return err;
+    }
+
+    /* process metadata */
+    d.payload = p->payload;
+    err = sx1302_parse_metadata(context, &pkt, &d);
+    if (err != LGW_REG_SUCCESS) {
+        return err;
+    }
+    p->freq_hz = d.freq_hz;
+    p->freq_offset = d.freq_offset;
+    p->if_chain = d.if_chain;
+    p->status = d.status;
+    p->count_us = d.count_us;
+    p->rf_chain = d.rf_chain;
+    p->modem_id = d.modem_id;
+    p->modulation = d.modulation;
+    p->bandwidth = d.bandwidth;
+    p->datarate = d.datarate;
+    p->coderate = d.coderate;
+    p->rssic = d.rssic;
+    p->rssis = d.rssis;
+    p->snr = d.snr;
+    p->snr_min = d.snr_min;
+    p->snr_max = d.snr_max;
+    p->crc = d.crc;
+    p->size = d.size;
+    p->ftime_received = d.ftime_received;
+    p->ftime = d.ftime;
 
     _meas_time_stop(2, tm, __FUNCTION__);
 
@@ -2188,16 +2196,54 @@ int sx1302_parse(lgw_context_t * context, struct lgw_pkt_rx_s * p) {
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
-uint16_t sx1302_lora_payload_crc(const uint8_t * data, uint8_t size) {
-    int i;
-    int crc = 0;
+int sx1302_parse_desc(lgw_context_t * context, struct lgw_pkt_rx_desc_s * p) {
+    int err;
+    rx_packet_t pkt;
+    uint8_t * payload;
+    struct timeval tm;
 
-    for (i = 0; i < size; i++) {
-        lora_crc16(data[i], &crc);
+    /* Record function start time */
+    _meas_time_start(&tm);
+
+    /* Check input params */
+    CHECK_NULL(context);
+    CHECK_NULL(p);
+
+    if (rx_buffer.buffer_pkt_nb == 0) {
+        DEBUG_MSG("INFO: No more data to be parsed\n");
+        return LGW_REG_ERROR;
+    }
+
+    /* the payload goes straight from the RX buffer to the pool */
+    payload = rxpool_alloc(rx_buffer_next_size(&rx_buffer));
+    if (payload == NULL) {
+        DEBUG_MSG("WARNING: RX payload pool full, packet left in RX buffer\n");
+        return LGW_REG_WARNING;
+    }
+    err = rx_buffer_pop_to(&rx_buffer, &pkt, payload);
+    if (err != LGW_REG_SUCCESS) {
+        rxpool_unref(payload);
+        return err;
+    }
+
+    /* process metadata */
+    p->payload = payload;
+    err = sx1302_parse_metadata(context, &pkt, p);
+    if (err != LGW_REG_SUCCESS) {
+        rxpool_unref(payload);
+        p->payload = NULL;
+        return err;
     }
 
-    //printf("CRC16: 0x%02X 0x%02X (%X)\n", (uint8_t)(crc >> 8), (uint8_t)crc, crc);
-    return (uint16_t)crc;
+    _meas_time_stop(2, tm, __FUNCTION__);
+
+    return LGW_REG_SUCCESS;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+uint16_t sx1302_lora_payload_crc(const uint8_t * data, uint8_t size) {
+    return crc16_lora_payload(0x0000, data, size);
 }
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
@@ -2326,6 +2372,13 @@ uint8_t sx1302_rx_status(uint8_t rf_chain) {
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
+uint32_t sx1302_rx_resync_bytes(void) {
+    /* updated by the fetching task, read from any: a statistics counter */
+    return __atomic_load_n(&rx_buffer.resync_bytes, __ATOMIC_RELAXED);
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
 int sx1302_tx_abort(uint8_t rf_chain) {
     int err;
     uint8_t tx_status = TX_STATUS_UNKNOWN;
@@ -381,6 +381,14 @@ int sx1302_fetch(uint8_t * nb_pkt);
 */
 int sx1302_parse(lgw_context_t * context, struct lgw_pkt_rx_s * p);
 
+/**
+@brief Parse and return the next packet available in rx_buffer, with its payload allocated in the RX payload pool.
+@param context      Gateway configuration context
+@param p            The descriptor to get the packet parsed
+@return LGW_REG_SUCCESS if a packet could be parsed, LGW_REG_WARNING if it was dropped or the pool is full, LGW_REG_ERROR otherwise
+*/
+int sx1302_parse_desc(lgw_context_t * context, struct lgw_pkt_rx_desc_s * p);
+
 /**
 @brief Configure the delay to be applied by the SX1302 for TX to start
 @param rf_chain      RF chain index to be configured
@@ -416,6 +424,12 @@ uint8_t sx1302_tx_status(uint8_t rf_chain);
 */
 uint8_t sx1302_rx_status(uint8_t rf_chain);
 
+/**
+@brief Get the number of bytes dropped from the RX buffer to re-sync on a packet syncword
+@return the number of bytes dropped since the RX buffer was initialized
+*/
+uint32_t sx1302_rx_resync_bytes(void);
+
 /**
 @brief Abort current transmit
 @param rf_chain the TX chain on which we want to abort transmit
@@ -18,7 +18,7 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 
 #include <stdint.h>     /* C99 types */
 #include <stdio.h>      /* printf fprintf */
-#include <string.h>     /* memset */
+#include <string.h>     /* memcpy */
 #include <assert.h>     /* assert */
 
 #include "loragw_aux.h"
@@ -30,6 +30,8 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 /* --- PRIVATE MACROS ------------------------------------------------------- */
 
 #define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+#define RX_BUFFER_MASK              (RX_BUFFER_SIZE - 1)
+#define RX_BYTE(self, index)        ((self)->buffer[(index) & RX_BUFFER_MASK])
 #if DEBUG_SX1302 == 1
     #define DEBUG_MSG(str)                fprintf(stdout, str)
     #define DEBUG_PRINTF(fmt, args...)    fprintf(stdout, fmt, args)
@@ -40,33 +42,33 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
     #define CHECK_NULL(a)                if(a==NULL){return LGW_REG_ERROR;}
 #endif
 
-#define SX1302_PKT_PAYLOAD_LENGTH(buffer, start_index)          TAKE_N_BITS_FROM(buffer[start_index +  2], 0, 8)
-#define SX1302_PKT_CHANNEL(buffer, start_index)                 TAKE_N_BITS_FROM(buffer[start_index +  3], 0, 8)
-#define SX1302_PKT_CRC_EN(buffer, start_index)                  TAKE_N_BITS_FROM(buffer[start_index +  4], 0, 1)
-#define SX1302_PKT_CODING_RATE(buffer, start_index)             TAKE_N_BITS_FROM(buffer[start_index +  4], 1, 3)
-#define SX1302_PKT_DATARATE(buffer, start_index)                TAKE_N_BITS_FROM(buffer[start_index +  4], 4, 4)
-#define SX1302_PKT_MODEM_ID(buffer, start_index)                TAKE_N_BITS_FROM(buffer[start_index +  5], 0, 8)
-#define SX1302_PKT_FREQ_OFFSET_7_0(buffer, start_index)         TAKE_N_BITS_FROM(buffer[start_index +  6], 0, 8)
-#define SX1302_PKT_FREQ_OFFSET_15_8(buffer, start_index)        TAKE_N_BITS_FROM(buffer[start_index +  7], 0, 8)
-#define SX1302_PKT_FREQ_OFFSET_19_16(buffer, start_index)       TAKE_N_BITS_FROM(buffer[start_index +  8], 0, 4)
-#define SX1302_PKT_CRC_ERROR(buffer, start_index)               TAKE_N_BITS_FROM(buffer[start_index +  9], 0, 1)
-#define SX1302_PKT_SYNC_ERROR(buffer, start_index)              TAKE_N_BITS_FROM(buffer[start_index +  9], 2, 1)
-#define SX1302_PKT_HEADER_ERROR(buffer, start_index)            TAKE_N_BITS_FROM(buffer[start_index +  9], 3, 1)
-#define SX1302_PKT_TIMING_SET(buffer, start_index)              TAKE_N_BITS_FROM(buffer[start_index +  9], 4, 1)
-#define SX1302_PKT_SNR_AVG(buffer, start_index)                 TAKE_N_BITS_FROM(buffer[start_index + 10], 0, 8)
-#define SX1302_PKT_RSSI_CHAN(buffer, start_index)               TAKE_N_BITS_FROM(buffer[start_index + 11], 0, 8)
-#define SX1302_PKT_RSSI_SIG(buffer, start_index)                TAKE_N_BITS_FROM(buffer[start_index + 12], 0, 8)
-#define SX1302_PKT_RSSI_CHAN_MAX_NEG_DELTA(buffer, start_index) TAKE_N_BITS_FROM(buffer[start_index + 13], 0, 4)
-#define SX1302_PKT_RSSI_CHAN_MAX_POS_DELTA(buffer, start_index) TAKE_N_BITS_FROM(buffer[start_index + 13], 4, 4)
-#define SX1302_PKT_RSSI_SIG_MAX_NEG_DELTA(buffer, start_index)  TAKE_N_BITS_FROM(buffer[start_index + 14], 0, 4)
-#define SX1302_PKT_RSSI_SIG_MAX_POS_DELTA(buffer, start_index)  TAKE_N_BITS_FROM(buffer[start_index + 14], 4, 4)
-#define SX1302_PKT_TIMESTAMP_7_0(buffer, start_index)           TAKE_N_BITS_FROM(buffer[start_index + 15], 0, 8)
-#define SX1302_PKT_TIMESTAMP_15_8(buffer, start_index)          TAKE_N_BITS_FROM(buffer[start_index + 16], 0, 8)
-#define SX1302_PKT_TIMESTAMP_23_16(buffer, start_index)         TAKE_N_BITS_FROM(buffer[start_index + 17], 0, 8)
-#define SX1302_PKT_TIMESTAMP_31_24(buffer, start_index)         TAKE_N_BITS_FROM(buffer[start_index + 18], 0, 8)
-#define SX1302_PKT_CRC_PAYLOAD_7_0(buffer, start_index)         TAKE_N_BITS_FROM(buffer[start_index + 19], 0, 8)
-#define SX1302_PKT_CRC_PAYLOAD_15_8(buffer, start_index)        TAKE_N_BITS_FROM(buffer[start_index + 20], 0, 8)
-#define SX1302_PKT_NUM_TS_METRICS(buffer, start_index)          TAKE_N_BITS_FROM(buffer[start_index + 21], 0, 8)
+#define SX1302_PKT_PAYLOAD_LENGTH(buffer, start_index)          TAKE_N_BITS_FROM(buffer[(start_index + 2) & RX_BUFFER_MASK], 0, 8)
+#define SX1302_PKT_CHANNEL(buffer, start_index)                 TAKE_N_BITS_FROM(buffer[(start_index + 3) & RX_BUFFER_MASK], 0, 8)
+#define SX1302_PKT_CRC_EN(buffer, start_index)                  TAKE_N_BITS_FROM(buffer[(start_index + 4) & RX_BUFFER_MASK], 0, 1)
+#define SX1302_PKT_CODING_RATE(buffer, start_index)             TAKE_N_BITS_FROM(buffer[(start_index + 4) & RX_BUFFER_MASK], 1, 3)
+#define SX1302_PKT_DATARATE(buffer, start_index)                TAKE_N_BITS_FROM(buffer[(start_index + 4) & RX_BUFFER_MASK], 4, 4)
+#define SX1302_PKT_MODEM_ID(buffer, start_index)                TAKE_N_BITS_FROM(buffer[(start_index + 5) & RX_BUFFER_MASK], 0, 8)
+#define SX1302_PKT_FREQ_OFFSET_7_0(buffer, start_index)         TAKE_N_BITS_FROM(buffer[(start_index + 6) & RX_BUFFER_MASK], 0, 8)
+#define SX1302_PKT_FREQ_OFFSET_15_8(buffer, start_index)        TAKE_N_BITS_FROM(buffer[(start_index + 7) & RX_BUFFER_MASK], 0, 8)
+#define SX1302_PKT_FREQ_OFFSET_19_16(buffer, start_index)       TAKE_N_BITS_FROM(buffer[(start_index + 8) & RX_BUFFER_MASK], 0, 4)
+#define SX1302_PKT_CRC_ERROR(buffer, start_index)               TAKE_N_BITS_FROM(buffer[(start_index + 9) & RX_BUFFER_MASK], 0, 1)
+#define SX1302_PKT_SYNC_ERROR(buffer, start_index)              TAKE_N_BITS_FROM(buffer[(start_index + 9) & RX_BUFFER_MASK], 2, 1)
+#define SX1302_PKT_HEADER_ERROR(buffer, start_index)            TAKE_N_BITS_FROM(buffer[(start_index + 9) & RX_BUFFER_MASK], 3, 1)
+#define SX1302_PKT_TIMING_SET(buffer, start_index)              TAKE_N_BITS_FROM(buffer[(start_index + 9) & RX_BUFFER_MASK], 4, 1)
+#define SX1302_PKT_SNR_AVG(buffer, start_index)                 TAKE_N_BITS_FROM(buffer[(start_index + 10) & RX_BUFFER_MASK], 0, 8)
+#define SX1302_PKT_RSSI_CHAN(buffer, start_index)               TAKE_N_BITS_FROM(buffer[(start_index + 11) & RX_BUFFER_MASK], 0, 8)
+#define SX1302_PKT_RSSI_SIG(buffer, start_index)                TAKE_N_BITS_FROM(buffer[(start_index + 12) & RX_BUFFER_MASK], 0, 8)
+#define SX1302_PKT_RSSI_CHAN_MAX_NEG_DELTA(buffer, start_index) TAKE_N_BITS_FROM(buffer[(start_index + 13) & RX_BUFFER_MASK], 0, 4)
+#define SX1302_PKT_RSSI_CHAN_MAX_POS_DELTA(buffer, start_index) TAKE_N_BITS_FROM(buffer[(start_index + 13) & RX_BUFFER_MASK], 4, 4)
+#define SX1302_PKT_RSSI_SIG_MAX_NEG_DELTA(buffer, start_index)  TAKE_N_BITS_FROM(buffer[(start_index + 14) & RX_BUFFER_MASK], 0, 4)
+#define SX1302_PKT_RSSI_SIG_MAX_POS_DELTA(buffer, start_index)  TAKE_N_BITS_FROM(buffer[(start_index + 14) & RX_BUFFER_MASK], 4, 4)
+#define SX1302_PKT_TIMESTAMP_7_0(buffer, start_index)           TAKE_N_BITS_FROM(buffer[(start_index + 15) & RX_BUFFER_MASK], 0, 8)
+#define SX1302_PKT_TIMESTAMP_15_8(buffer, start_index)          TAKE_N_BITS_FROM(buffer[(start_index + 16) & RX_BUFFER_MASK], 0, 8)
+#define SX1302_PKT_TIMESTAMP_23_16(buffer, start_index)         TAKE_N_BITS_FROM(buffer[(start_index + 17) & RX_BUFFER_MASK], 0, 8)
+#define SX1302_PKT_TIMESTAMP_31_24(buffer, start_index)         TAKE_N_BITS_FROM(buffer[(start_index + 18) & RX_BUFFER_MASK], 0, 8)
+#define SX1302_PKT_CRC_PAYLOAD_7_0(buffer, start_index)         TAKE_N_BITS_FROM(buffer[(start_index + 19) & RX_BUFFER_MASK], 0, 8)
+#define SX1302_PKT_CRC_PAYLOAD_15_8(buffer, start_index)        TAKE_N_BITS_FROM(buffer[(start_index + 20) & RX_BUFFER_MASK], 0, 8)
+#define SX1302_PKT_NUM_TS_METRICS(buffer, start_index)          TAKE_N_BITS_FROM(buffer[(start_index + 21) & RX_BUFFER_MASK], 0, 8)
 
 /* -------------------------------------------------------------------------- */
 /* --- PRIVATE TYPES -------------------------------------------------------- */
@@ -79,6 +81,7 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 #define SX1302_PKT_SYNCWORD_BYTE_1  0xC0
 #define SX1302_PKT_HEAD_METADATA    9
 #define SX1302_PKT_TAIL_METADATA    14
+#define SX1302_PKT_NUM_TS_OFFSET    21  /* from the end of the payload */
 
 /* modem IDs */
 #define SX1302_LORA_MODEM_ID_MAX    15
@@ -91,9 +94,75 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 /* -------------------------------------------------------------------------- */
 /* --- PRIVATE FUNCTIONS DECLARATION ---------------------------------------- */
 
+static void rx_buffer_scan(rx_buffer_t * self);
+
+static void rx_buffer_copy(const rx_buffer_t * self, uint16_t index, uint8_t * data, uint16_t size);
+
 /* -------------------------------------------------------------------------- */
 /* --- PRIVATE FUNCTIONS DEFINITION ----------------------------------------- */
 
+/* Count the complete packets following the ones already counted. A partial packet at the end is left
+   for the next fetch to complete. Bytes preceding the first syncword are dropped, only if no packet
+   is pending before them. */
+static void rx_buffer_scan(rx_buffer_t * self) {
+    uint16_t idx, avail;
+    uint8_t payload_len;
+    uint16_t pkt_num_bytes;
+
+    while ((self->buffer_size - self->buffer_scan) >= 3) {
+        idx = self->buffer_index + self->buffer_scan;
+        avail = self->buffer_size - self->buffer_scan;
+
+        /* Is there a syncword ? If not, move to the first syncword found */
+        if ((RX_BYTE(self, idx) != SX1302_PKT_SYNCWORD_BYTE_0) || (RX_BYTE(self, idx + 1) != SX1302_PKT_SYNCWORD_BYTE_1)) {
+            if (self->buffer_scan != 0) {
+                break; /* parse pending packets first */
+            }
+            DEBUG_PRINTF("INFO: syncword not found at idx %u\n", idx & RX_BUFFER_MASK);
+            self->buffer_index = (self->buffer_index + 1) & RX_BUFFER_MASK;
+            self->buffer_size -= 1;
+            self->resync_bytes += 1;
+            continue;
+        }
+
+        /* Compute the number of bytes for this packet, if its length fields are already there */
+        payload_len = SX1302_PKT_PAYLOAD_LENGTH(self->buffer, idx);
+        if (avail <= (payload_len + SX1302_PKT_NUM_TS_OFFSET)) {
+            break;
+        }
+        pkt_num_bytes = SX1302_PKT_HEAD_METADATA +
+                        payload_len +
+                        SX1302_PKT_TAIL_METADATA +
+                        (2 * SX1302_PKT_NUM_TS_METRICS(self->buffer, idx + payload_len));
+        if (avail < pkt_num_bytes) {
+            break;
+        }
+
+        /* One complete packet found in the ring */
+        self->buffer_scan += pkt_num_bytes;
+        self->buffer_pkt_nb += 1;
+    }
+
+    if (self->buffer_scan < self->buffer_size) {
+        DEBUG_PRINTF("INFO: %u bytes kept for next fetch\n", self->buffer_size - self->buffer_scan);
+    }
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+static void rx_buffer_copy(const rx_buffer_t * self, uint16_t index, uint8_t * data, uint16_t size) {
+    uint16_t first;
+
+    index &= RX_BUFFER_MASK;
+    first = RX_BUFFER_SIZE - index;
+    if (size <= first) {
+        memcpy(data, &(self->buffer[index]), size);
+    } else {
+        memcpy(data, &(self->buffer[index]), first);
+        memcpy(data + first, self->buffer, size - first);
+    }
+}
+
 /* -------------------------------------------------------------------------- */
 /* --- PUBLIC FUNCTIONS DEFINITION ------------------------------------------ */
 
@@ -102,10 +171,11 @@ int rx_buffer_new(rx_buffer_t * self) {
     CHECK_NULL(self);
 
     /* Initialize members */
-    memset(self->buffer, 0, sizeof self->buffer);
     self->buffer_size = 0;
     self->buffer_index = 0;
+    self->buffer_scan = 0;
     self->buffer_pkt_nb = 0;
+    self->resync_bytes = 0;
 
     return LGW_REG_SUCCESS;
 }
@@ -119,6 +189,7 @@ int rx_buffer_del(rx_buffer_t * self) {
     /* Reset index & size */
     self->buffer_size = 0;
     self->buffer_index = 0;
+    self->buffer_scan = 0;
     self->buffer_pkt_nb = 0;
 
     return LGW_REG_SUCCESS;
@@ -127,12 +198,10 @@ int rx_buffer_del(rx_buffer_t * self) {
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
 int rx_buffer_fetch(rx_buffer_t * self) {
-    int i, res;
+    int res;
     uint8_t buff[2];
-    uint8_t payload_len;
-    uint16_t next_pkt_idx;
-    int idx;
     uint16_t nb_bytes_1, nb_bytes_2;
+    uint16_t nb_bytes, wr_idx, first;
 
     /* Check input params */
     CHECK_NULL(self);
@@ -145,168 +214,173 @@ int rx_buffer_fetch(rx_buffer_t * self) {
     lgw_reg_rb(SX1302_REG_RX_TOP_RX_BUFFER_NB_BYTES_MSB_RX_BUFFER_NB_BYTES, buff, sizeof buff);
     nb_bytes_2 = (buff[0] << 8) | (buff[1] << 0);
 
-    self->buffer_size = (nb_bytes_2 > nb_bytes_1) ? nb_bytes_2 : nb_bytes_1;
+    nb_bytes = (nb_bytes_2 > nb_bytes_1) ? nb_bytes_2 : nb_bytes_1;
+
+    /* Only fetch what fits in the ring, the SX1302 keeps the rest */
+    if (nb_bytes > (RX_BUFFER_SIZE - self->buffer_size)) {
+        nb_bytes = RX_BUFFER_SIZE - self->buffer_size;
+    }
 
-    /* Fetch bytes from fifo if any */
-    if (self->buffer_size > 0) {
+    /* Fetch bytes from fifo if any, after the ones kept from the previous fetch */
+    if (nb_bytes > 0) {
         DEBUG_MSG   ("-----------------\n");
-        DEBUG_PRINTF("%s: nb_bytes to be fetched: %u (%u %u)\n", __FUNCTION__, self->buffer_size, buff[1], buff[0]);
+        DEBUG_PRINTF("%s: nb_bytes to be fetched: %u (%u %u), %u kept\n", __FUNCTION__, nb_bytes, buff[1], buff[0], self->buffer_size);
 
-        memset(self->buffer, 0, sizeof self->buffer);
-        res = lgw_mem_rb(0x4000, self->buffer, self->buffer_size, true);
+        wr_idx = (self->buffer_index + self->buffer_size) & RX_BUFFER_MASK;
+        first = RX_BUFFER_SIZE - wr_idx;
+        if (nb_bytes <= first) {
+            res = lgw_mem_rb(0x4000, &(self->buffer[wr_idx]), nb_bytes, true);
+        } else {
+            res = lgw_mem_rb(0x4000, &(self->buffer[wr_idx]), first, true);
+            if (res == LGW_REG_SUCCESS) {
+                res = lgw_mem_rb(0x4000, self->buffer, nb_bytes - first, true);
+            }
+        }
         if (res != LGW_REG_SUCCESS) {
             printf("ERROR: Failed to read RX buffer, SPI error\n");
             return LGW_REG_ERROR;
         }
+        self->buffer_size += nb_bytes;
+    }
 
-        /* print debug info */
-        DEBUG_MSG("RX_BUFFER: ");
-        for (i = 0; i < self->buffer_size; i++) {
-            DEBUG_PRINTF("%02X ", self->buffer[i]);
-        }
-        DEBUG_MSG("\n");
+    /* Count the packets completed by this fetch */
+    rx_buffer_scan(self);
 
-        /* Sanity check: is there at least 1 complete packet in the buffer */
-        if (self->buffer_size < (SX1302_PKT_HEAD_METADATA + SX1302_PKT_TAIL_METADATA)) {
-            printf("WARNING: not enough data to have a complete packet, discard rx_buffer\n");
-            return rx_buffer_del(self);
-        }
+    return LGW_REG_SUCCESS;
+}
 
-        /* Sanity check: is there a syncword at 0 ? If not, move to the first syncword found */
-        idx = 0;
-        while (idx <= (self->buffer_size - 2)) {
-            if ((self->buffer[idx] == SX1302_PKT_SYNCWORD_BYTE_0) && (self->buffer[idx + 1] == SX1302_PKT_SYNCWORD_BYTE_1)) {
-                DEBUG_PRINTF("INFO: syncword found at idx %d\n", idx);
-                break;
-            } else {
-                printf("INFO: syncword not found at idx %d\n", idx);
-                idx += 1;
-            }
-        }
-        if (idx > self->buffer_size - 2) {
-            printf("WARNING: no syncword found, discard rx_buffer\n");
-            return rx_buffer_del(self);
-        }
-        if (idx != 0) {
-            printf("INFO: re-sync rx_buffer at idx %d\n", idx);
-            memmove((void *)(self->buffer), (void *)(self->buffer + idx), self->buffer_size - idx);
-            self->buffer_size -= idx;
-        }
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
-        /* Rewind and parse buffer to get the number of packet fetched */
-        idx = 0;
-        while (idx < self->buffer_size) {
-            if ((self->buffer[idx] != SX1302_PKT_SYNCWORD_BYTE_0) || (self->buffer[idx + 1] != SX1302_PKT_SYNCWORD_BYTE_1)) {
-                printf("WARNING: syncword not found at idx %d, discard the rx_buffer\n", idx);
-                return rx_buffer_del(self);
-            }
-            /* One packet found in the buffer */
-            self->buffer_pkt_nb += 1;
-
-            /* Compute the number of bytes for this packet */
-            payload_len = SX1302_PKT_PAYLOAD_LENGTH(self->buffer, idx);
-            next_pkt_idx =  SX1302_PKT_HEAD_METADATA +
-                            payload_len +
-                            SX1302_PKT_TAIL_METADATA +
-                            (2 * SX1302_PKT_NUM_TS_METRICS(self->buffer, idx + payload_len));
-
-            /* Move to next packet */
-            idx += (int)next_pkt_idx;
-        }
+uint16_t rx_buffer_feed(rx_buffer_t * self, const uint8_t * data, uint16_t size) {
+    uint16_t wr_idx, first;
+
+    if ((self == NULL) || (data == NULL)) {
+        return 0;
     }
 
-    /* Initialize the current buffer index to iterate on */
-    self->buffer_index = 0;
+    if (size > (RX_BUFFER_SIZE - self->buffer_size)) {
+        size = RX_BUFFER_SIZE - self->buffer_size;
+    }
+    if (size > 0) {
+        wr_idx = (self->buffer_index + self->buffer_size) & RX_BUFFER_MASK;
+        first = RX_BUFFER_SIZE - wr_idx;
+        if (size <= first) {
+            memcpy(&(self->buffer[wr_idx]), data, size);
+        } else {
+            memcpy(&(self->buffer[wr_idx]), data, first);
+            memcpy(self->buffer, data + first, size - first);
+        }
+        self->buffer_size += size;
+        rx_buffer_scan(self);
+    }
 
-    return LGW_REG_SUCCESS;
+    return size;
 }
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
 int rx_buffer_pop(rx_buffer_t * self, rx_packet_t * pkt) {
+    /* Check input params */
+    CHECK_NULL(pkt);
+
+    return rx_buffer_pop_to(self, pkt, pkt->payload);
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+uint8_t rx_buffer_next_size(const rx_buffer_t * self) {
+    if ((self == NULL) || (self->buffer_pkt_nb == 0)) {
+        return 0;
+    }
+
+    return SX1302_PKT_PAYLOAD_LENGTH(self->buffer, self->buffer_index);
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+int rx_buffer_pop_to(rx_buffer_t * self, rx_packet_t * pkt, uint8_t * payload) {
     int i;
     uint8_t checksum_rcv, checksum_calc = 0;
     uint16_t checksum_idx;
     uint16_t pkt_num_bytes;
+    uint16_t idx;
 
     /* Check input params */
     CHECK_NULL(self);
     CHECK_NULL(pkt);
+    CHECK_NULL(payload);
 
-    /* Is there any data to be parsed ? */
-    if (self->buffer_index >= self->buffer_size) {
+    /* Is there any packet to be parsed ? */
+    if (self->buffer_pkt_nb == 0) {
         DEBUG_MSG("INFO: No more data to be parsed\n");
         return LGW_REG_ERROR;
     }
-
-    /* Get pkt sync words */
-    if ((self->buffer[self->buffer_index] != SX1302_PKT_SYNCWORD_BYTE_0) || (self->buffer[self->buffer_index + 1] != SX1302_PKT_SYNCWORD_BYTE_1)) {
-        return LGW_REG_ERROR;
-    }
-    DEBUG_PRINTF("INFO: pkt syncword found at index %u\n", self->buffer_index);
+    idx = self->buffer_index;
+    DEBUG_PRINTF("INFO: pkt syncword found at index %u\n", idx);
 
     /* Get payload length */
-    pkt->rxbytenb_modem = SX1302_PKT_PAYLOAD_LENGTH(self->buffer, self->buffer_index);
+    pkt->rxbytenb_modem = SX1302_PKT_PAYLOAD_LENGTH(self->buffer, idx);
 
     /* Get fine timestamp metrics */
-    pkt->num_ts_metrics_stored = SX1302_PKT_NUM_TS_METRICS(self->buffer, self->buffer_index + pkt->rxbytenb_modem);
+    pkt->num_ts_metrics_stored = SX1302_PKT_NUM_TS_METRICS(self->buffer, idx + pkt->rxbytenb_modem);
 
-    /* Calculate the total number of bytes in the packet */
+    /* Calculate the total number of bytes in the packet (complete, as counted by rx_buffer_scan) */
     pkt_num_bytes = SX1302_PKT_HEAD_METADATA + pkt->rxbytenb_modem + SX1302_PKT_TAIL_METADATA + (2 * pkt->num_ts_metrics_stored);
 
-    /* Check if we have a complete packet in the rx buffer fetched */
-    if((self->buffer_index + pkt_num_bytes) > self->buffer_size) {
-        printf("WARNING: aborting truncated message (size=%u)\n", self->buffer_size);
-        return LGW_REG_WARNING;
-    }
-
     /* Get the checksum as received in the RX buffer */
     checksum_idx = pkt_num_bytes - 1;
-    checksum_rcv = self->buffer[self->buffer_index + pkt_num_bytes - 1];
+    checksum_rcv = RX_BYTE(self, idx + checksum_idx);
 
     /* Calculate the checksum from the actual payload bytes received */
     for (i = 0; i < (int)checksum_idx; i++) {
-        checksum_calc += self->buffer[self->buffer_index + i];
+        checksum_calc += RX_BYTE(self, idx + i);
     }
 
     /* Check if the checksum is correct */
     if (checksum_rcv != checksum_calc) {
         printf("WARNING: checksum failed (got:0x%02X calc:0x%02X)\n", checksum_rcv, checksum_calc);
+        /* The length may be corrupted too: drop the syncword and count packets again from there */
+        self->buffer_index = (idx + 1) & RX_BUFFER_MASK;
+        self->buffer_size -= 1;
+        self->buffer_scan = 0;
+        self->buffer_pkt_nb = 0;
+        self->resync_bytes += 1;
+        rx_buffer_scan(self);
         return LGW_REG_WARNING;
     } else {
         DEBUG_PRINTF("Packet checksum OK (0x%02X)\n", checksum_rcv);
     }
 
     /* Parse packet metadata */
-    pkt->modem_id = SX1302_PKT_MODEM_ID(self->buffer, self->buffer_index);
-    pkt->rx_channel_in = SX1302_PKT_CHANNEL(self->buffer, self->buffer_index);
-    pkt->crc_en = SX1302_PKT_CRC_EN(self->buffer, self->buffer_index);
-    pkt->payload_crc_error = SX1302_PKT_CRC_ERROR(self->buffer, self->buffer_index + pkt->rxbytenb_modem);
-    pkt->sync_error = SX1302_PKT_SYNC_ERROR(self->buffer, self->buffer_index + pkt->rxbytenb_modem);
-    pkt->header_error = SX1302_PKT_HEADER_ERROR(self->buffer, self->buffer_index + pkt->rxbytenb_modem);
-    pkt->timing_set = SX1302_PKT_TIMING_SET(self->buffer, self->buffer_index + pkt->rxbytenb_modem);
-    pkt->coding_rate = SX1302_PKT_CODING_RATE(self->buffer, self->buffer_index);
-    pkt->rx_rate_sf = SX1302_PKT_DATARATE(self->buffer, self->buffer_index);
-    pkt->rssi_chan_avg = SX1302_PKT_RSSI_CHAN(self->buffer, self->buffer_index + pkt->rxbytenb_modem);
-    pkt->rssi_signal_avg = SX1302_PKT_RSSI_SIG(self->buffer, self->buffer_index + pkt->rxbytenb_modem);
-    pkt->rx_crc16_value  = (uint16_t)((SX1302_PKT_CRC_PAYLOAD_7_0(self->buffer, self->buffer_index + pkt->rxbytenb_modem) <<  0) & 0x00FF);
-    pkt->rx_crc16_value |= (uint16_t)((SX1302_PKT_CRC_PAYLOAD_15_8(self->buffer, self->buffer_index + pkt->rxbytenb_modem) <<  8) & 0xFF00);
-    pkt->snr_average = (int8_t)SX1302_PKT_SNR_AVG(self->buffer, self->buffer_index + pkt->rxbytenb_modem);
-
-    pkt->frequency_offset_error = (int32_t)((SX1302_PKT_FREQ_OFFSET_19_16(self->buffer, self->buffer_index) << 16) | (SX1302_PKT_FREQ_OFFSET_15_8(self->buffer, self->buffer_index) << 8) | (SX1302_PKT_FREQ_OFFSET_7_0(self->buffer, self->buffer_index) << 0));
+    pkt->modem_id = SX1302_PKT_MODEM_ID(self->buffer, idx);
+    pkt->rx_channel_in = SX1302_PKT_CHANNEL(self->buffer, idx);
+    pkt->crc_en = SX1302_PKT_CRC_EN(self->buffer, idx);
+    pkt->payload_crc_error = SX1302_PKT_CRC_ERROR(self->buffer, idx + pkt->rxbytenb_modem);
+    pkt->sync_error = SX1302_PKT_SYNC_ERROR(self->buffer, idx + pkt->rxbytenb_modem);
+    pkt->header_error = SX1302_PKT_HEADER_ERROR(self->buffer, idx + pkt->rxbytenb_modem);
+    pkt->timing_set = SX1302_PKT_TIMING_SET(self->buffer, idx + pkt->rxbytenb_modem);
+    pkt->coding_rate = SX1302_PKT_CODING_RATE(self->buffer, idx);
+    pkt->rx_rate_sf = SX1302_PKT_DATARATE(self->buffer, idx);
+    pkt->rssi_chan_avg = SX1302_PKT_RSSI_CHAN(self->buffer, idx + pkt->rxbytenb_modem);
+    pkt->rssi_signal_avg = SX1302_PKT_RSSI_SIG(self->buffer, idx + pkt->rxbytenb_modem);
+    pkt->rx_crc16_value  = (uint16_t)((SX1302_PKT_CRC_PAYLOAD_7_0(self->buffer, idx + pkt->rxbytenb_modem) <<  0) & 0x00FF);
+    pkt->rx_crc16_value |= (uint16_t)((SX1302_PKT_CRC_PAYLOAD_15_8(self->buffer, idx + pkt->rxbytenb_modem) <<  8) & 0xFF00);
+    pkt->snr_average = (int8_t)SX1302_PKT_SNR_AVG(self->buffer, idx + pkt->rxbytenb_modem);
+
+    pkt->frequency_offset_error = (int32_t)((SX1302_PKT_FREQ_OFFSET_19_16(self->buffer, idx) << 16) | (SX1302_PKT_FREQ_OFFSET_15_8(self->buffer, idx) << 8) | (SX1302_PKT_FREQ_OFFSET_7_0(self->buffer, idx) << 0));
     if (pkt->frequency_offset_error >= (1<<19)) { /* Handle signed value on 20bits */
         pkt->frequency_offset_error = (pkt->frequency_offset_error - (1<<20));
     }
 
     /* Packet timestamp (32MHz ) */
-    pkt->timestamp_cnt  = (uint32_t)((SX1302_PKT_TIMESTAMP_7_0(self->buffer, self->buffer_index + pkt->rxbytenb_modem) <<  0) & 0x000000FF);
-    pkt->timestamp_cnt |= (uint32_t)((SX1302_PKT_TIMESTAMP_15_8(self->buffer, self->buffer_index + pkt->rxbytenb_modem) <<  8) & 0x0000FF00);
-    pkt->timestamp_cnt |= (uint32_t)((SX1302_PKT_TIMESTAMP_23_16(self->buffer, self->buffer_index + pkt->rxbytenb_modem) << 16) & 0x00FF0000);
-    pkt->timestamp_cnt |= (uint32_t)((SX1302_PKT_TIMESTAMP_31_24(self->buffer, self->buffer_index + pkt->rxbytenb_modem) << 24) & 0xFF000000);
+    pkt->timestamp_cnt  = (uint32_t)((SX1302_PKT_TIMESTAMP_7_0(self->buffer, idx + pkt->rxbytenb_modem) <<  0) & 0x000000FF);
+    pkt->timestamp_cnt |= (uint32_t)((SX1302_PKT_TIMESTAMP_15_8(self->buffer, idx + pkt->rxbytenb_modem) <<  8) & 0x0000FF00);
+    pkt->timestamp_cnt |= (uint32_t)((SX1302_PKT_TIMESTAMP_23_16(self->buffer, idx + pkt->rxbytenb_modem) << 16) & 0x00FF0000);
+    pkt->timestamp_cnt |= (uint32_t)((SX1302_PKT_TIMESTAMP_31_24(self->buffer, idx + pkt->rxbytenb_modem) << 24) & 0xFF000000);
 
     /* TS metrics: it is expected the nb_symbols parameter is set to 0 here */
     for (i = 0; i < (pkt->num_ts_metrics_stored * 2); i++) {
-        pkt->timestamp_avg[i] = (int8_t)SX1302_PKT_NUM_TS_METRICS(self->buffer, self->buffer_index + pkt->rxbytenb_modem + 1 + i);
+        pkt->timestamp_avg[i] = (int8_t)SX1302_PKT_NUM_TS_METRICS(self->buffer, idx + pkt->rxbytenb_modem + 1 + i);
         pkt->timestamp_stddev[i] = 0; /* no stddev when nb_symbols == 0 */
     }
 
@@ -351,11 +425,13 @@ int rx_buffer_pop(rx_buffer_t * self, rx_packet_t * pkt) {
         }
     }
 
-    /* Parse & copy payload in packet struct */
-    memcpy((void *)pkt->payload, (void *)(&(self->buffer[self->buffer_index + SX1302_PKT_HEAD_METADATA])), pkt->rxbytenb_modem);
+    /* Parse & copy payload to its destination */
+    rx_buffer_copy(self, idx + SX1302_PKT_HEAD_METADATA, payload, pkt->rxbytenb_modem);
 
     /* Move buffer index toward next message */
-    self->buffer_index += (SX1302_PKT_HEAD_METADATA + pkt->rxbytenb_modem + SX1302_PKT_TAIL_METADATA + (2 * pkt->num_ts_metrics_stored));
+    self->buffer_index = (idx + pkt_num_bytes) & RX_BUFFER_MASK;
+    self->buffer_size -= pkt_num_bytes;
+    self->buffer_scan -= pkt_num_bytes;
 
     /* Update the number of packets currently stored in the rx_buffer */
     self->buffer_pkt_nb -= 1;
@@ -26,6 +26,8 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 /* -------------------------------------------------------------------------- */
 /* --- PUBLIC CONSTANTS ----------------------------------------------------- */
 
+#define RX_BUFFER_SIZE  4096    /* size of the rx_buffer ring, must be a power of 2 */
+
 /* -------------------------------------------------------------------------- */
 /* --- PUBLIC MACROS -------------------------------------------------------- */
 
@@ -66,13 +68,16 @@ typedef struct rx_packet_s {
 
 /**
 @struct rx_buffer_s
-@brief buffer to hold the data fetched from the sx1302 RX buffer
+@brief ring to hold the data fetched from the sx1302 RX buffer
+A packet only partially fetched is kept in the ring and completed by the next fetch.
 */
 typedef struct rx_buffer_s {
-    uint8_t buffer[4096];   /*!> byte array to hald the data fetched from the RX buffer */
-    uint16_t buffer_size;   /*!> The number of bytes currently stored in the buffer */
-    int buffer_index;       /*!> Current parsing index in the buffer */
-    uint8_t buffer_pkt_nb;
+    uint8_t buffer[RX_BUFFER_SIZE]; /*!> byte ring to hold the data fetched from the RX buffer */
+    uint16_t buffer_size;   /*!> The number of bytes currently stored in the ring, from buffer_index */
+    uint16_t buffer_index;  /*!> Ring index of the next packet to be parsed */
+    uint16_t buffer_scan;   /*!> The number of bytes from buffer_index holding complete packets */
+    uint8_t buffer_pkt_nb;  /*!> The number of complete packets available */
+    uint32_t resync_bytes;  /*!> The number of bytes dropped to re-sync on a syncword */
 } rx_buffer_t;
 
 /* -------------------------------------------------------------------------- */
@@ -94,19 +99,46 @@ int rx_buffer_del(rx_buffer_t * self);
 
 /**
 @brief Fetch packets from the SX1302 internal RX buffer, and count packets available.
+Bytes which do not fit in the ring are left in the SX1302 for the next fetch.
 @param self     A pointer to a rx_buffer handler
 @return LGW_REG_SUCCESS if success, LGW_REG_ERROR otherwise
 */
 int rx_buffer_fetch(rx_buffer_t * self);
 
+/**
+@brief Append bytes as read from the SX1302 RX buffer, and count packets available.
+Used to replay recorded RX buffer dumps.
+@param self     A pointer to a rx_buffer handler
+@param data     A pointer to the bytes to be appended
+@param size     The number of bytes to be appended
+@return The number of bytes appended, limited by the free space in the ring
+*/
+uint16_t rx_buffer_feed(rx_buffer_t * self, const uint8_t * data, uint16_t size);
+
 /**
 @brief Parse the rx_buffer and return the first packet available in the given structure.
 @param self     A pointer to a rx_buffer handler
 @param pkt      A pointer to the structure to receive the packet parsed
-@return LGW_REG_SUCCESS if success, LGW_REG_ERROR otherwise
+@return LGW_REG_SUCCESS if success, LGW_REG_WARNING if the packet was corrupted and dropped, LGW_REG_ERROR otherwise
 */
 int rx_buffer_pop(rx_buffer_t * self, rx_packet_t * pkt);
 
+/**
+@brief Same as rx_buffer_pop(), with the payload copied to the given location instead of pkt->payload
+@param self     A pointer to a rx_buffer handler
+@param pkt      A pointer to the structure to receive the packet parsed
+@param payload  A pointer to receive the payload, of rx_buffer_next_size() bytes
+@return LGW_REG_SUCCESS if success, LGW_REG_WARNING if the packet was corrupted and dropped, LGW_REG_ERROR otherwise
+*/
+int rx_buffer_pop_to(rx_buffer_t * self, rx_packet_t * pkt, uint8_t * payload);
+
+/**
+@brief Get the payload size of the next packet to be popped
+@param self     A pointer to a rx_buffer handler
+@return The payload size, in bytes, 0 if there is no packet available
+*/
+uint8_t rx_buffer_next_size(const rx_buffer_t * self);
+
 /* -------------------------------------------------------------------------- */
 /* --- DEBUG FUNCTIONS PROTOTYPES ------------------------------------------- */
 
@@ -9,6 +9,12 @@
 Description:
     Base64 encoding & decoding library
 
+    Blocks of 3 bytes are encoded as two 12-bit halves, each looked up in a
+    table of character pairs. Blocks of 4 characters are decoded with one table
+    per character position, giving the code already shifted into place, so
+    that a block is the OR of 4 lookups and an invalid character sets its top
+    bit.
+
 License: Revised BSD License, see LICENSE.TXT file include in the project
 */
 
@@ -19,6 +25,7 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>     /* memcpy */
 
 #include "base64.h"
 
@@ -31,76 +38,155 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 //#define DEBUG(args...)    fprintf(stderr,"debug: " args) /* diagnostic message that is destined to the user */
 #define DEBUG(args...)
 
+/* 32-bit aligned loads & stores in the block loops, Xtensa cores have no unaligned access */
+#ifndef BASE64_ALIGNED_WORDS
+#if defined(__XTENSA__)
+#define BASE64_ALIGNED_WORDS    1
+#else
+#define BASE64_ALIGNED_WORDS    0
+#endif
+#endif
+
+#if BASE64_ALIGNED_WORDS && (__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__)
+#error "BASE64_ALIGNED_WORDS needs a little-endian CPU"
+#endif
+
+/* character of a code in the range 0-63, RFC 1421 standard characters for codes 62 and 63 */
+#define B64_CHAR(x)         (((x) < 26) ? ('A' + (x)) : ((x) < 52) ? ('a' + (x) - 26) : ((x) < 62) ? ('0' + (x) - 52) : ((x) == 62) ? '+' : '/')
+
+/* two characters of a 12-bit value, in memory order */
+#if (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define B64_PAIR(x)         (uint16_t)(B64_CHAR((x) >> 6) | (B64_CHAR((x) & 0x3F) << 8))
+#else
+#define B64_PAIR(x)         (uint16_t)((B64_CHAR((x) >> 6) << 8) | B64_CHAR((x) & 0x3F))
+#endif
+#define B64_PAIR4(x)        B64_PAIR(x), B64_PAIR((x) + 1), B64_PAIR((x) + 2), B64_PAIR((x) + 3)
+#define B64_PAIR16(x)       B64_PAIR4(x), B64_PAIR4((x) + 4), B64_PAIR4((x) + 8), B64_PAIR4((x) + 12)
+#define B64_PAIR64(x)       B64_PAIR16(x), B64_PAIR16((x) + 16), B64_PAIR16((x) + 32), B64_PAIR16((x) + 48)
+#define B64_PAIR256(x)      B64_PAIR64(x), B64_PAIR64((x) + 64), B64_PAIR64((x) + 128), B64_PAIR64((x) + 192)
+#define B64_PAIR1024(x)     B64_PAIR256(x), B64_PAIR256((x) + 256), B64_PAIR256((x) + 512), B64_PAIR256((x) + 768)
+
+/* code of a character shifted into its place in a 24-bit block, B64_BAD if not a base64 character */
+#define B64_BAD             0x80000000
+#define B64_CODE(c)         ((((c) >= 'A') && ((c) <= 'Z')) ? ((c) - 'A') : (((c) >= 'a') && ((c) <= 'z')) ? ((c) - 'a' + 26) : \
+                             (((c) >= '0') && ((c) <= '9')) ? ((c) - '0' + 52) : ((c) == '+') ? 62 : ((c) == '/') ? 63 : -1)
+#define B64_DEC(c, s)       ((B64_CODE(c) < 0) ? B64_BAD : ((uint32_t)B64_CODE(c) << (s)))
+#define B64_DEC4(c, s)      B64_DEC(c, s), B64_DEC((c) + 1, s), B64_DEC((c) + 2, s), B64_DEC((c) + 3, s)
+#define B64_DEC16(c, s)     B64_DEC4(c, s), B64_DEC4((c) + 4, s), B64_DEC4((c) + 8, s), B64_DEC4((c) + 12, s)
+#define B64_DEC64(c, s)     B64_DEC16(c, s), B64_DEC16((c) + 16, s), B64_DEC16((c) + 32, s), B64_DEC16((c) + 48, s)
+#define B64_DEC256(s)       { B64_DEC64(0, s), B64_DEC64(64, s), B64_DEC64(128, s), B64_DEC64(192, s) }
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE TYPES -------------------------------------------------------- */
+
+typedef uint32_t __attribute__((__may_alias__)) b64_word_t;
+
 /* -------------------------------------------------------------------------- */
 /* --- PRIVATE CONSTANTS ---------------------------------------------------- */
 
+/* encoding, characters of each 12-bit half of a 3 bytes block */
+static const uint16_t enc_pair[4096] = {
+    B64_PAIR1024(0), B64_PAIR1024(1024), B64_PAIR1024(2048), B64_PAIR1024(3072)
+};
+
+/* decoding, one table per character position in a 4 characters block */
+static const uint32_t dec_0[256] = B64_DEC256(18);
+static const uint32_t dec_1[256] = B64_DEC256(12);
+static const uint32_t dec_2[256] = B64_DEC256(6);
+static const uint32_t dec_3[256] = B64_DEC256(0);
+
 /* -------------------------------------------------------------------------- */
 /* --- PRIVATE MODULE-WIDE VARIABLES ---------------------------------------- */
 
-static char code_62 = '+';    /* RFC 1421 standard character for code 62 */
-static char code_63 = '/';    /* RFC 1421 standard character for code 63 */
 static char code_pad = '=';    /* RFC 1421 padding character if padding */
 
 /* -------------------------------------------------------------------------- */
-/* --- PRIVATE FUNCTIONS DECLARATION ---------------------------------------- */
+/* --- PRIVATE FUNCTIONS DEFINITION ----------------------------------------- */
 
-/**
-@brief Convert a code in the range 0-63 to an ASCII character
-*/
-char code_to_char(uint8_t x);
+/* Encode 3 bytes into 4 characters */
+static inline void enc_block(const uint8_t * in, char * out) {
+    uint32_t b;
 
-/**
-@brief Convert an ASCII character to a code in the range 0-63
-*/
-uint8_t char_to_code(char x);
+    b = ((uint32_t)in[0] << 16) | ((uint32_t)in[1] << 8) | in[2];
+    memcpy(out, &enc_pair[b >> 12], 2);
+    memcpy(out + 2, &enc_pair[b & 0xFFF], 2);
+}
 
-/* -------------------------------------------------------------------------- */
-/* --- PRIVATE FUNCTIONS DEFINITION ----------------------------------------- */
+/* Decode up to 4 characters into a 24-bit block, B64_BAD set if a character is invalid */
+static inline uint32_t dec_block(const char * in, int nb_chars) {
+    uint32_t b;
+
+    b = dec_0[(uint8_t)in[0]] | dec_1[(uint8_t)in[1]];
+    if (nb_chars > 2) {
+        b |= dec_2[(uint8_t)in[2]];
+    }
+    if (nb_chars > 3) {
+        b |= dec_3[(uint8_t)in[3]];
+    }
+    return b;
+}
+
+#if BASE64_ALIGNED_WORDS
+/* Encode 12 bytes into 16 characters, both 32-bit aligned, returns the number of blocks done */
+static int enc_words(const uint8_t * in, char * out, int full_blocks) {
+    const b64_word_t * w = (const b64_word_t *)in;
+    b64_word_t * o = (b64_word_t *)out;
+    uint32_t w0, w1, w2, b;
+    int i;
 
-char code_to_char(uint8_t x) {
-    if (x <= 25) {
-        return 'A' + x;
-    } else if ((x >= 26) && (x <= 51)) {
-        return 'a' + (x-26);
-    } else if ((x >= 52) && (x <= 61)) {
-        return '0' + (x-52);
-    } else if (x == 62) {
-        return code_62;
-    } else if (x == 63) {
-        return code_63;
-    } else {
-        DEBUG("ERROR: %i IS OUT OF RANGE 0-63 FOR BASE64 ENCODING\n", x);
-        exit(EXIT_FAILURE);
-    } //TODO: improve error management
+    for (i = 0; (i + 4) <= full_blocks; i += 4) {
+        w0 = w[0];
+        w1 = w[1];
+        w2 = w[2];
+        b = ((w0 & 0xFF) << 16) | (w0 & 0xFF00) | ((w0 >> 16) & 0xFF);
+        o[0] = enc_pair[b >> 12] | ((uint32_t)enc_pair[b & 0xFFF] << 16);
+        b = ((w0 >> 24) << 16) | ((w1 & 0xFF) << 8) | ((w1 >> 8) & 0xFF);
+        o[1] = enc_pair[b >> 12] | ((uint32_t)enc_pair[b & 0xFFF] << 16);
+        b = (w1 & 0xFF0000) | ((w1 >> 24) << 8) | (w2 & 0xFF);
+        o[2] = enc_pair[b >> 12] | ((uint32_t)enc_pair[b & 0xFFF] << 16);
+        b = ((w2 << 8) & 0xFF0000) | ((w2 >> 8) & 0xFF00) | (w2 >> 24);
+        o[3] = enc_pair[b >> 12] | ((uint32_t)enc_pair[b & 0xFFF] << 16);
+        w += 3;
+        o += 4;
+    }
+    return i;
 }
 
-uint8_t char_to_code(char x) {
-    if ((x >= 'A') && (x <= 'Z')) {
-        return (uint8_t)x - (uint8_t)'A';
-    } else if ((x >= 'a') && (x <= 'z')) {
-        return (uint8_t)x - (uint8_t)'a' + 26;
-    } else if ((x >= '0') && (x <= '9')) {
-        return (uint8_t)x - (uint8_t)'0' + 52;
-    } else if (x == code_62) {
-        return 62;
-    } else if (x == code_63) {
-        return 63;
-    } else {
-        DEBUG("ERROR: %c (0x%x) IS INVALID CHARACTER FOR BASE64 DECODING\n", x, x);
-        exit(EXIT_FAILURE);
-    } //TODO: improve error management
+/* Decode 16 characters into 12 bytes, both 32-bit aligned, returns the number of blocks done or -1 */
+static int dec_words(const char * in, uint8_t * out, int full_blocks) {
+    const b64_word_t * w = (const b64_word_t *)in;
+    b64_word_t * o = (b64_word_t *)out;
+    uint32_t x0, x1, x2, x3;
+    int i;
+
+    for (i = 0; (i + 4) <= full_blocks; i += 4) {
+        x0 = dec_0[w[0] & 0xFF] | dec_1[(w[0] >> 8) & 0xFF] | dec_2[(w[0] >> 16) & 0xFF] | dec_3[w[0] >> 24];
+        x1 = dec_0[w[1] & 0xFF] | dec_1[(w[1] >> 8) & 0xFF] | dec_2[(w[1] >> 16) & 0xFF] | dec_3[w[1] >> 24];
+        x2 = dec_0[w[2] & 0xFF] | dec_1[(w[2] >> 8) & 0xFF] | dec_2[(w[2] >> 16) & 0xFF] | dec_3[w[2] >> 24];
+        x3 = dec_0[w[3] & 0xFF] | dec_1[(w[3] >> 8) & 0xFF] | dec_2[(w[3] >> 16) & 0xFF] | dec_3[w[3] >> 24];
+        if (((x0 | x1 | x2 | x3) & B64_BAD) != 0) {
+            return -1;
+        }
+        o[0] = ((x0 >> 16) & 0xFF) | (x0 & 0xFF00) | ((x0 & 0xFF) << 16) | (x1 & 0xFF0000) << 8;
+        o[1] = ((x1 >> 8) & 0xFF) | ((x1 & 0xFF) << 8) | (x2 & 0xFF0000) | ((x2 & 0xFF00) << 16);
+        o[2] = (x2 & 0xFF) | ((x3 >> 8) & 0xFF00) | ((x3 & 0xFF00) << 8) | ((x3 & 0xFF) << 24);
+        w += 4;
+        o += 3;
+    }
+    return i;
 }
+#endif
 
 /* -------------------------------------------------------------------------- */
 /* --- PUBLIC FUNCTIONS DEFINITION ------------------------------------------ */
 
 int bin_to_b64_nopad(const uint8_t * in, int size, char * out, int max_len) {
-    int i;
+    int i = 0;
     int result_len; /* size of the result */
     int full_blocks; /* number of 3 unsigned chars / 4 characters blocks */
-    int last_bytes; /* number of unsigned chars <3 in the last block */
     int last_chars; /* number of characters <4 in the last block */
-    uint32_t b;
+    uint8_t last_in[3] = {0, 0, 0};
+    char last_out[4];
 
     /* check input values */
     if ((out == NULL) || (in == NULL)) {
@@ -112,22 +198,9 @@ int bin_to_b64_nopad(const uint8_t * in, int size, char * out, int max_len) {
         return 0;
     }
 
-    /* calculate the number of base64 'blocks' */
+    /* calculate the number of base64 'blocks', a partial block of 1 or 2 bytes gives 2 or 3 chars */
     full_blocks = size / 3;
-    last_bytes = size % 3;
-    switch (last_bytes) {
-        case 0: /* no byte left to encode */
-            last_chars = 0;
-            break;
-        case 1: /* 1 byte left to encode -> +2 chars */
-            last_chars = 2;
-            break;
-        case 2: /* 2 bytes left to encode -> +3 chars */
-            last_chars = 3;
-            break;
-        default:
-            CRIT("switch default that should not be possible");
-    }
+    last_chars = (size % 3 == 0) ? 0 : (size % 3) + 1;
 
     /* check if output buffer is big enough */
     result_len = (4*full_blocks) + last_chars;
@@ -137,45 +210,33 @@ int bin_to_b64_nopad(const uint8_t * in, int size, char * out, int max_len) {
     }
 
     /* process all the full blocks */
-    for (i=0; i < full_blocks; ++i) {
-        b  = (0xFF & in[3*i]    ) << 16;
-        b |= (0xFF & in[3*i + 1]) << 8;
-        b |=  0xFF & in[3*i + 2];
-        out[4*i + 0] = code_to_char((b >> 18) & 0x3F);
-        out[4*i + 1] = code_to_char((b >> 12) & 0x3F);
-        out[4*i + 2] = code_to_char((b >> 6 ) & 0x3F);
-        out[4*i + 3] = code_to_char( b        & 0x3F);
+#if BASE64_ALIGNED_WORDS
+    if ((((uintptr_t)in | (uintptr_t)out) & 3) == 0) {
+        i = enc_words(in, out, full_blocks);
+    }
+#endif
+    for (; i < full_blocks; ++i) {
+        enc_block(&in[3*i], &out[4*i]);
     }
 
-    /* process the last 'partial' block and terminate string */
-    i = full_blocks;
-    if (last_chars == 0) {
-        out[4*i] =  0; /* null character to terminate string */
-    } else if (last_chars == 2) {
-        b  = (0xFF & in[3*i]    ) << 16;
-        out[4*i + 0] = code_to_char((b >> 18) & 0x3F);
-        out[4*i + 1] = code_to_char((b >> 12) & 0x3F);
-        out[4*i + 2] =  0; /* null character to terminate string */
-    } else if (last_chars == 3) {
-        b  = (0xFF & in[3*i]    ) << 16;
-        b |= (0xFF & in[3*i + 1]) << 8;
-        out[4*i + 0] = code_to_char((b >> 18) & 0x3F);
-        out[4*i + 1] = code_to_char((b >> 12) & 0x3F);
-        out[4*i + 2] = code_to_char((b >> 6 ) & 0x3F);
-        out[4*i + 3] = 0; /* null character to terminate string */
+    /* process the last 'partial' block, padded with zeros, and terminate string */
+    if (last_chars != 0) {
+        memcpy(last_in, &in[3*i], last_chars - 1);
+        enc_block(last_in, last_out);
+        memcpy(&out[4*i], last_out, last_chars);
     }
+    out[result_len] = 0; /* null character to terminate string */
 
     return result_len;
 }
 
 int b64_to_bin_nopad(const char * in, int size, uint8_t * out, int max_len) {
-    int i;
+    int i = 0;
     int result_len; /* size of the result */
     int full_blocks; /* number of 3 unsigned chars / 4 characters blocks */
     int last_chars; /* number of characters <4 in the last block */
     int last_bytes; /* number of unsigned chars <3 in the last block */
     uint32_t b;
-    ;
 
     /* check input values */
     if ((out == NULL) || (in == NULL)) {
@@ -189,22 +250,11 @@ int b64_to_bin_nopad(const char * in, int size, uint8_t * out, int max_len) {
     /* calculate the number of base64 'blocks' */
     full_blocks = size / 4;
     last_chars = size % 4;
-    switch (last_chars) {
-        case 0: /* no char left to decode */
-            last_bytes = 0;
-            break;
-        case 1: /* only 1 char left is an error */
-            DEBUG("ERROR: ONLY ONE CHAR LEFT IN B64_TO_BIN\n");
-            return -1;
-        case 2: /* 2 chars left to decode -> +1 byte */
-            last_bytes = 1;
-            break;
-        case 3: /* 3 chars left to decode -> +2 bytes */
-            last_bytes = 2;
-            break;
-        default:
-            CRIT("switch default that should not be possible");
+    if (last_chars == 1) { /* only 1 char left is an error */
+        DEBUG("ERROR: ONLY ONE CHAR LEFT IN B64_TO_BIN\n");
+        return -1;
     }
+    last_bytes = (last_chars == 0) ? 0 : last_chars - 1;
 
     /* check if output buffer is big enough */
     result_len = (3*full_blocks) + last_bytes;
@@ -214,33 +264,36 @@ int b64_to_bin_nopad(const char * in, int size, uint8_t * out, int max_len) {
     }
 
     /* process all the full blocks */
-    for (i=0; i < full_blocks; ++i) {
-        b  = (0x3F & char_to_code(in[4*i]    )) << 18;
-        b |= (0x3F & char_to_code(in[4*i + 1])) << 12;
-        b |= (0x3F & char_to_code(in[4*i + 2])) << 6;
-        b |=  0x3F & char_to_code(in[4*i + 3]);
+#if BASE64_ALIGNED_WORDS
+    if ((((uintptr_t)in | (uintptr_t)out) & 3) == 0) {
+        i = dec_words(in, out, full_blocks);
+        if (i < 0) {
+            DEBUG("ERROR: INVALID CHARACTER FOR BASE64 DECODING\n");
+            return -1;
+        }
+    }
+#endif
+    for (; i < full_blocks; ++i) {
+        b = dec_block(&in[4*i], 4);
+        if ((b & B64_BAD) != 0) {
+            DEBUG("ERROR: INVALID CHARACTER FOR BASE64 DECODING\n");
+            return -1;
+        }
         out[3*i + 0] = (b >> 16) & 0xFF;
         out[3*i + 1] = (b >> 8 ) & 0xFF;
         out[3*i + 2] =  b        & 0xFF;
     }
 
-    /* process the last 'partial' block */
-    i = full_blocks;
-    if (last_bytes == 1) {
-        b  = (0x3F & char_to_code(in[4*i]    )) << 18;
-        b |= (0x3F & char_to_code(in[4*i + 1])) << 12;
-        out[3*i + 0] = (b >> 16) & 0xFF;
-        if (((b >> 12) & 0x0F) != 0) {
-            DEBUG("WARNING: last character contains unusable bits\n");
+    /* process the last 'partial' block, the unusable bits of its last character are ignored */
+    if (last_bytes != 0) {
+        b = dec_block(&in[4*i], last_chars);
+        if ((b & B64_BAD) != 0) {
+            DEBUG("ERROR: INVALID CHARACTER FOR BASE64 DECODING\n");
+            return -1;
         }
-    } else if (last_bytes == 2) {
-        b  = (0x3F & char_to_code(in[4*i]    )) << 18;
-        b |= (0x3F & char_to_code(in[4*i + 1])) << 12;
-        b |= (0x3F & char_to_code(in[4*i + 2])) << 6;
         out[3*i + 0] = (b >> 16) & 0xFF;
-        out[3*i + 1] = (b >> 8 ) & 0xFF;
-        if (((b >> 6) & 0x03) != 0) {
-            DEBUG("WARNING: last character contains unusable bits\n");
+        if (last_bytes == 2) {
+            out[3*i + 1] = (b >> 8 ) & 0xFF;
         }
     }
 
@@ -36,7 +36,7 @@ int bin_to_b64_nopad(const uint8_t * in, int size, char * out, int max_len);
 
 /**
 @brief Decode Base64 string to binary data (no padding)
-@param in string containing only base64 valid characters
+@param in string containing only base64 valid characters, -1 is returned otherwise
 @param size number of characters to be decoded from base64 (w/o null char)
 @param out pointer to a data buffer where the function will output decoded data
 @param out_max_len usable size of the output data buffer
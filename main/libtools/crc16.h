@@ -0,0 +1,47 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2019 Semtech
+
+Description:
+    Table-driven CRC16 (CCITT polynomial 0x1021, MSB first)
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+
+#ifndef _CRC16_H
+#define _CRC16_H
+
+/* -------------------------------------------------------------------------- */
+/* --- DEPENDANCIES --------------------------------------------------------- */
+
+#include <stdint.h>        /* C99 types */
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS PROTOTYPES ------------------------------------------ */
+
+/**
+@brief Compute a CRC16-CCITT over a buffer, data entering the top of the CRC register
+@param crc initial value, or value returned for the previous part of the data
+@param data pointer to the data
+@param size number of bytes of data
+@return the CRC value
+*/
+uint16_t crc16_ccitt(uint16_t crc, const uint8_t * data, unsigned size);
+
+/**
+@brief Compute the CRC16 of a LoRa payload as the SX1302 does, data entering the bottom of the CRC register
+@param crc initial value, or value returned for the previous part of the data
+@param data pointer to the data
+@param size number of bytes of data
+@return the CRC value
+*/
+uint16_t crc16_lora_payload(uint16_t crc, const uint8_t * data, unsigned size);
+
+#endif
+
+/* --- EOF ------------------------------------------------------------------ */
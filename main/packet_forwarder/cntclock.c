@@ -0,0 +1,85 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    LoRa concentrator : concentrator counter extrapolated from the local timer
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+
+#include "cntclock.h"
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE FUNCTIONS DEFINITION ----------------------------------------- */
+
+/* Correction of a duration for the rate difference, rounded to nearest */
+static int64_t drift_us(int64_t duration_us, int32_t drift_ppb) {
+    int64_t x = duration_us * drift_ppb;
+
+    return (x >= 0) ? ((x + 500000000) / 1000000000) : -((-x + 500000000) / 1000000000);
+}
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS DEFINITION ------------------------------------------ */
+
+void cntclock_sync(struct cntclock_s * c, uint32_t count_us, int64_t local_us) {
+    int64_t span_us, error_us;
+    int32_t drift;
+
+    if (c->valid == true) {
+        error_us = (int32_t)(count_us - cntclock_count(c, local_us));
+        if ((error_us > CNTCLOCK_ERROR_MAX_US) || (error_us < -CNTCLOCK_ERROR_MAX_US)) {
+            c->valid = false; /* concentrator restarted, or not read for too long */
+        }
+    }
+    if (c->valid == false) {
+        c->valid = true;
+        c->drift_ppb = 0;
+        c->drift_valid = false;
+        c->span_count_us = count_us;
+        c->span_local_us = local_us;
+    }
+
+    /* rate difference, over a span long enough for the SPI access time not to matter,
+       and short enough for the counter not to wrap */
+    span_us = local_us - c->span_local_us;
+    if (span_us > INT32_MAX) {
+        c->span_count_us = count_us;
+        c->span_local_us = local_us;
+    } else if (span_us >= CNTCLOCK_RATE_SPAN_US) {
+        drift = (int32_t)((((int64_t)(uint32_t)(count_us - c->span_count_us) - span_us) * 1000000000) / span_us);
+        if ((drift <= CNTCLOCK_DRIFT_MAX_PPB) && (drift >= -CNTCLOCK_DRIFT_MAX_PPB)) {
+            c->drift_ppb = (c->drift_valid == true) ? (c->drift_ppb + (drift - c->drift_ppb) / 4) : drift;
+            c->drift_valid = true;
+        }
+        c->span_count_us = count_us;
+        c->span_local_us = local_us;
+    }
+
+    c->count_us = count_us;
+    c->local_us = local_us;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+uint32_t cntclock_count(const struct cntclock_s * c, int64_t local_us) {
+    int64_t dt = local_us - c->local_us;
+
+    return c->count_us + (uint32_t)(dt + drift_us(dt, c->drift_ppb));
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+int64_t cntclock_local(const struct cntclock_s * c, uint32_t count_us) {
+    int64_t dc = (int32_t)(count_us - c->count_us);
+
+    return c->local_us + dc - drift_us(dc, c->drift_ppb);
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,75 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    LoRa concentrator : concentrator counter extrapolated from the local timer,
+    so that the counter does not have to be read over SPI to know when a
+    packet is due
+
+    Each counter read is paired with the esp_timer time it was taken at. The
+    rate difference of both clocks is measured between reads at least
+    CNTCLOCK_RATE_SPAN_US apart, and smoothed. No locking is done here.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+
+#ifndef _LORA_PKTFWD_CNTCLOCK_H
+#define _LORA_PKTFWD_CNTCLOCK_H
+
+
+#include <stdint.h>     /* C99 types */
+#include <stdbool.h>    /* bool type */
+
+
+#define CNTCLOCK_RATE_SPAN_US   10000000    /* min time between the reads a rate is measured on */
+#define CNTCLOCK_DRIFT_MAX_PPB  200000      /* rate difference above which the counter is deemed restarted */
+#define CNTCLOCK_ERROR_MAX_US   10000       /* extrapolation error above which the counter is deemed restarted */
+
+struct cntclock_s {
+    bool        valid;
+    uint32_t    count_us;       /* counter at the latest read */
+    int64_t     local_us;       /* esp_timer time of the latest read */
+    int32_t     drift_ppb;      /* counter rate minus local rate, in parts per billion */
+    bool        drift_valid;    /* drift_ppb was measured at least once */
+    uint32_t    span_count_us;  /* counter at the start of the rate measurement */
+    int64_t     span_local_us;  /* esp_timer time at the start of the rate measurement */
+};
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS PROTOTYPES ------------------------------------------ */
+
+/**
+@brief Take a new counter read as reference.
+
+@param c[in,out] Clock, with valid false before the first read.
+@param count_us[in] Counter read.
+@param local_us[in] esp_timer time of the read, best taken halfway through the SPI access.
+*/
+void cntclock_sync(struct cntclock_s * c, uint32_t count_us, int64_t local_us);
+
+/**
+@brief Extrapolate the counter at a local time.
+
+@param c[in] Clock, valid.
+@param local_us[in] esp_timer time.
+@return Counter value at that time.
+*/
+uint32_t cntclock_count(const struct cntclock_s * c, int64_t local_us);
+
+/**
+@brief Local time at which the counter reaches a value.
+
+@param c[in] Clock, valid.
+@param count_us[in] Counter value, within 35 minutes of the latest read, before or after.
+@return esp_timer time.
+*/
+int64_t cntclock_local(const struct cntclock_s * c, uint32_t count_us);
+
+#endif
+/* --- EOF ------------------------------------------------------------------ */
@@ -13,13 +13,9 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 */
 
 
-#ifndef _GNU_SOURCE
-#define _GNU_SOURCE     /* needed for qsort_r to be defined */
-#endif
-
-#include <stdlib.h>     /* qsort_r */
 #include <stdio.h>      /* printf, fprintf, snprintf, fopen, fputs */
 #include <string.h>     /* memset, memcpy */
+#include <stddef.h>     /* offsetof */
 #include <pthread.h>
 #include <assert.h>
 #include <math.h>
@@ -42,74 +38,166 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 #define BEACON_RESERVED         2120000 /* Time on air of the beacon, with some margin */
 
 
-static SemaphoreHandle_t mx_jit_queue; /* control access to JIT queue */
+/* Unlocked, called with the queue lock held */
+static inline bool jit_queue_is_full(struct jit_queue_s *queue) {
+    return (queue->num_pkt == JIT_QUEUE_MAX)?true:false;
+}
 
-bool jit_queue_is_full(struct jit_queue_s *queue) {
-    bool result;
+/* Unlocked, called with the queue lock held */
+static inline bool jit_queue_is_empty(struct jit_queue_s *queue) {
+    return (queue->num_pkt == 0)?true:false;
+}
 
-    xSemaphoreTake(mx_jit_queue, portMAX_DELAY);
+/* Publish the first packet in time, for jit_queue_head, the queue lock being held */
+static void jit_head_publish(struct jit_queue_s *queue) {
+    stats_begin(&queue->head.seq);
+    queue->head.valid = (queue->num_pkt > 0)?true:false;
+    queue->head.count_us = (queue->num_pkt > 0) ? queue->nodes[queue->heap[0]].pkt.count_us : 0;
+    stats_end(&queue->head.seq);
+}
 
-    result = (queue->num_pkt == JIT_QUEUE_MAX)?true:false;
+void jit_queue_init(struct jit_queue_s *queue) {
+    if (queue->mx == NULL) {
+        queue->mx = xSemaphoreCreateMutex();
+        assert(queue->mx);
+    }
+    xSemaphoreTake(queue->mx, portMAX_DELAY);
 
-    xSemaphoreGive(mx_jit_queue);
+    /* everything but the lock and the head snapshot, which a reader may be copying */
+    memset(&(queue->num_pkt), 0, sizeof(*queue) - offsetof(struct jit_queue_s, num_pkt));
+    jit_head_publish(queue);
 
-    return result;
+    xSemaphoreGive(queue->mx);
 }
 
-bool jit_queue_is_empty(struct jit_queue_s *queue) {
-    bool result;
+/* The functions below, up to jit_enqueue, are called with the queue lock held */
 
-    xSemaphoreTake(mx_jit_queue, portMAX_DELAY);
-
-    result = (queue->num_pkt == 0)?true:false;
+/* Wrap-aware comparison of count_us: the packets in a queue always lie within a few
+   minutes of each other, far less than half the counter range */
+static inline bool jit_before(uint32_t a_count_us, uint32_t b_count_us) {
+    return (int32_t)(a_count_us - b_count_us) < 0;
+}
 
-    xSemaphoreGive(mx_jit_queue);
+static inline uint32_t jit_count(struct jit_queue_s *queue, uint16_t node) {
+    return queue->nodes[node].pkt.count_us;
+}
 
-    return result;
+static void jit_heap_set(struct jit_queue_s *queue, uint16_t pos, uint16_t node) {
+    queue->heap[pos] = node;
+    queue->heap_pos[node] = pos;
 }
 
-void jit_queue_init(struct jit_queue_s *queue) {
-    int i;
+static void jit_heap_sift_up(struct jit_queue_s *queue, uint16_t pos) {
+    uint16_t node = queue->heap[pos];
+    uint16_t parent;
 
-    mx_jit_queue = xSemaphoreCreateMutex();
-    assert(mx_jit_queue);
-    xSemaphoreTake(mx_jit_queue, portMAX_DELAY);
+    while (pos > 0) {
+        parent = (pos - 1) / 2;
+        if (jit_before(jit_count(queue, node), jit_count(queue, queue->heap[parent])) == false) {
+            break;
+        }
+        jit_heap_set(queue, pos, queue->heap[parent]);
+        pos = parent;
+    }
+    jit_heap_set(queue, pos, node);
+}
+
+static void jit_heap_sift_down(struct jit_queue_s *queue, uint16_t pos, uint16_t heap_size) {
+    uint16_t node = queue->heap[pos];
+    uint32_t child; /* may go past 65535 */
 
-    memset(queue, 0, sizeof(*queue));
-    for (i=0; i<JIT_QUEUE_MAX; i++) {
-        queue->nodes[i].pre_delay = 0;
-        queue->nodes[i].post_delay = 0;
+    while ((child = 2 * (uint32_t)pos + 1) < heap_size) {
+        if (((child + 1) < heap_size) && jit_before(jit_count(queue, queue->heap[child + 1]), jit_count(queue, queue->heap[child]))) {
+            child += 1;
+        }
+        if (jit_before(jit_count(queue, queue->heap[child]), jit_count(queue, node)) == false) {
+            break;
+        }
+        jit_heap_set(queue, pos, queue->heap[child]);
+        pos = child;
     }
+    jit_heap_set(queue, pos, node);
+}
+
+/* First position in the order index whose packet is not before count_us */
+static uint16_t jit_order_find(struct jit_queue_s *queue, uint32_t count_us) {
+    uint16_t lo = 0;
+    uint16_t hi = queue->num_pkt;
+    uint16_t mid;
 
-    xSemaphoreGive(mx_jit_queue);
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (jit_before(jit_count(queue, queue->order[mid]), count_us)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
 }
 
-int compare(const void *a, const void *b, void *arg)
-{
-    struct jit_node_s *p = (struct jit_node_s *)a;
-    struct jit_node_s *q = (struct jit_node_s *)b;
-    int *counter = (int *)arg;
-    int p_count, q_count;
+/* Index node num_pkt, just written, then count it in */
+static void jit_node_add(struct jit_queue_s *queue) {
+    uint16_t node = queue->num_pkt;
+    uint16_t pos;
 
-    p_count = p->pkt.count_us;
-    q_count = q->pkt.count_us;
+    pos = jit_order_find(queue, jit_count(queue, node));
+    memmove(&queue->order[pos + 1], &queue->order[pos], (queue->num_pkt - pos) * sizeof queue->order[0]);
+    queue->order[pos] = node;
 
-    if (p_count > q_count)
-        *counter = *counter + 1;
+    queue->heap[queue->num_pkt] = node; /* new leaf */
+    jit_heap_sift_up(queue, queue->num_pkt);
 
-    return p_count - q_count;
+    if (queue->nodes[node].pre_delay > queue->max_pre_delay) {
+        queue->max_pre_delay = queue->nodes[node].pre_delay;
+    }
+    if (queue->nodes[node].post_delay > queue->max_post_delay) {
+        queue->max_post_delay = queue->nodes[node].post_delay;
+    }
+    if (queue->nodes[node].pkt_type == JIT_PKT_TYPE_BEACON) {
+        queue->num_beacon++;
+    }
+    queue->num_pkt++;
+    jit_head_publish(queue);
 }
 
-void jit_sort_queue(struct jit_queue_s *queue) {
-    int counter = 0;
+/* Remove a node from both indexes, the last node taking its place in the array */
+static void jit_node_remove(struct jit_queue_s *queue, uint16_t node) {
+    uint16_t last = queue->num_pkt - 1;
+    uint16_t pos, moved;
+
+    if (queue->nodes[node].pkt_type == JIT_PKT_TYPE_BEACON) {
+        queue->num_beacon--;
+    }
 
-    if (queue->num_pkt == 0) {
-        return;
+    /* order index: count_us are unique, no two packets can be sent at the same time */
+    pos = jit_order_find(queue, jit_count(queue, node));
+    memmove(&queue->order[pos], &queue->order[pos + 1], (last - pos) * sizeof queue->order[0]);
+
+    /* heap: the last leaf fills the hole, then goes up or down */
+    pos = queue->heap_pos[node];
+    if (pos != last) {
+        moved = queue->heap[last];
+        jit_heap_set(queue, pos, moved);
+        jit_heap_sift_down(queue, pos, last);
+        jit_heap_sift_up(queue, queue->heap_pos[moved]);
+    }
+    queue->num_pkt = last;
+
+    /* move the last node in the hole, and repoint its index entries */
+    if (node != last) {
+        pos = jit_order_find(queue, jit_count(queue, last));
+        queue->order[pos] = node;
+        jit_heap_set(queue, queue->heap_pos[last], node);
+        memcpy(&(queue->nodes[node]), &(queue->nodes[last]), sizeof(struct jit_node_s));
     }
+    memset(&(queue->nodes[last]), 0, sizeof(struct jit_node_s));
 
-    MSG_DEBUG(DEBUG_JIT, "sorting queue in ascending order packet timestamp - queue size:%u\n", queue->num_pkt);
-    qsort_r(queue->nodes, queue->num_pkt, sizeof(queue->nodes[0]), compare, &counter);
-    MSG_DEBUG(DEBUG_JIT, "sorting queue done - swapped:%d\n", counter);
+    if (jit_queue_is_empty(queue)) {
+        queue->max_pre_delay = 0;
+        queue->max_post_delay = 0;
+    }
+    jit_head_publish(queue);
 }
 
 bool jit_collision_test(uint32_t p1_count_us, uint32_t p1_pre_delay, uint32_t p1_post_delay, uint32_t p2_count_us, uint32_t p2_pre_delay, uint32_t p2_post_delay) {
@@ -121,11 +209,37 @@ bool jit_collision_test(uint32_t p1_count_us, uint32_t p1_pre_delay, uint32_t p1
     }
 }
 
+/* First packet of the queue, in count_us order, colliding with the given one, -1 if none.
+   Only the packets whose reserved time can reach it are tested. */
+static int jit_collision_find(struct jit_queue_s *queue, uint32_t count_us, uint32_t pre_delay, uint32_t post_delay, bool ignore_beacon_guard) {
+    uint32_t last_count_us;
+    uint32_t target_pre_delay;
+    uint16_t pos, node;
+
+    pos = jit_order_find(queue, count_us - (pre_delay + queue->max_post_delay + TX_MARGIN_DELAY));
+    last_count_us = count_us + post_delay + queue->max_pre_delay + TX_MARGIN_DELAY;
+    for (; pos < queue->num_pkt; pos++) {
+        node = queue->order[pos];
+        if (jit_before(last_count_us, jit_count(queue, node))) {
+            break;
+        }
+        if ((ignore_beacon_guard == true) && (queue->nodes[node].pkt_type == JIT_PKT_TYPE_BEACON)) {
+            target_pre_delay = TX_START_DELAY;
+        } else {
+            target_pre_delay = queue->nodes[node].pre_delay;
+        }
+        if (jit_collision_test(count_us, pre_delay, post_delay, queue->nodes[node].pkt.count_us, target_pre_delay, queue->nodes[node].post_delay) == true) {
+            return node;
+        }
+    }
+    return -1;
+}
+
 enum jit_error_e jit_enqueue(struct jit_queue_s *queue, uint32_t time_us, struct lgw_pkt_tx_s *packet, enum jit_pkt_type_e pkt_type) {
     int i = 0;
+    uint16_t node, next;
     uint32_t packet_post_delay = 0;
     uint32_t packet_pre_delay = 0;
-    uint32_t target_pre_delay = 0;
     enum jit_error_e err_collision;
     uint32_t asap_count_us;
 
@@ -136,11 +250,6 @@ enum jit_error_e jit_enqueue(struct jit_queue_s *queue, uint32_t time_us, struct
         return JIT_ERROR_INVALID;
     }
 
-    if (jit_queue_is_full(queue)) {
-        MSG_DEBUG(DEBUG_JIT_ERROR, "ERROR: cannot enqueue packet, JIT queue is full\n");
-        return JIT_ERROR_FULL;
-    }
-
     /* Compute packet pre/post delays depending on packet's type */
     switch (pkt_type) {
         case JIT_PKT_TYPE_DOWNLINK_CLASS_A:
@@ -158,7 +267,13 @@ enum jit_error_e jit_enqueue(struct jit_queue_s *queue, uint32_t time_us, struct
             break;
     }
 
-    xSemaphoreTake(mx_jit_queue, portMAX_DELAY);
+    xSemaphoreTake(queue->mx, portMAX_DELAY);
+
+    if (jit_queue_is_full(queue)) {
+        xSemaphoreGive(queue->mx);
+        MSG_DEBUG(DEBUG_JIT_ERROR, "ERROR: cannot enqueue packet, JIT queue is full\n");
+        return JIT_ERROR_FULL;
+    }
 
     /* An immediate downlink becomes a timestamped downlink "ASAP" */
     /* Set the packet count_us to the first available slot */
@@ -168,7 +283,7 @@ enum jit_error_e jit_enqueue(struct jit_queue_s *queue, uint32_t time_us, struct
 
         /* Search for the ASAP timestamp to be given to the packet */
         asap_count_us = time_us + 2 * TX_JIT_DELAY; /* margin */
-        if (queue->num_pkt == 0) {
+        if (jit_queue_is_empty(queue)) {
             /* If the jit queue is empty, we can insert this packet */
             MSG_DEBUG(DEBUG_JIT, "DEBUG: insert IMMEDIATE downlink, first in JiT queue (count_us=%u)\n", asap_count_us);
         } else {
@@ -179,26 +294,24 @@ enum jit_error_e jit_enqueue(struct jit_queue_s *queue, uint32_t time_us, struct
             */
 
             /* First, try if the ASAP time collides with an already enqueued downlink */
-            for (i=0; i<queue->num_pkt; i++) {
-                if (jit_collision_test(asap_count_us, packet_pre_delay, packet_post_delay, queue->nodes[i].pkt.count_us, queue->nodes[i].pre_delay, queue->nodes[i].post_delay) == true) {
-                    MSG_DEBUG(DEBUG_JIT, "DEBUG: cannot insert IMMEDIATE downlink at count_us=%u, collides with %u (index=%d)\n", asap_count_us, queue->nodes[i].pkt.count_us, i);
-                    break;
-                }
-            }
-            if (i == queue->num_pkt) {
+            i = jit_collision_find(queue, asap_count_us, packet_pre_delay, packet_post_delay, false);
+            if (i == -1) {
                 /* No collision with ASAP time, we can insert it */
                 MSG_DEBUG(DEBUG_JIT, "DEBUG: insert IMMEDIATE downlink ASAP at %u (no collision)\n", asap_count_us);
             } else {
-                /* Search for the best slot then */
+                MSG_DEBUG(DEBUG_JIT, "DEBUG: cannot insert IMMEDIATE downlink at count_us=%u, collides with %u (index=%d)\n", asap_count_us, queue->nodes[i].pkt.count_us, i);
+                /* Search for the best slot then, from the first packet in time */
                 for (i=0; i<queue->num_pkt; i++) {
-                    asap_count_us = queue->nodes[i].pkt.count_us + queue->nodes[i].post_delay + packet_pre_delay + TX_JIT_DELAY + TX_MARGIN_DELAY;
+                    node = queue->order[i];
+                    asap_count_us = queue->nodes[node].pkt.count_us + queue->nodes[node].post_delay + packet_pre_delay + TX_JIT_DELAY + TX_MARGIN_DELAY;
                     if (i == (queue->num_pkt - 1)) {
-                        /* Last packet index, we can insert after this one */
+                        /* Last packet in time, we can insert after this one */
                         MSG_DEBUG(DEBUG_JIT, "DEBUG: insert IMMEDIATE downlink, last in JiT queue (count_us=%u)\n", asap_count_us);
                     } else {
-                        /* Check if packet can be inserted between this index and the next one */
-                        MSG_DEBUG(DEBUG_JIT, "DEBUG: try to insert IMMEDIATE downlink (count_us=%u) between index %d and index %d?\n", asap_count_us, i, i+1);
-                        if (jit_collision_test(asap_count_us, packet_pre_delay, packet_post_delay, queue->nodes[i+1].pkt.count_us, queue->nodes[i+1].pre_delay, queue->nodes[i+1].post_delay) == true) {
+                        /* Check if packet can be inserted between this packet and the next one */
+                        next = queue->order[i+1];
+                        MSG_DEBUG(DEBUG_JIT, "DEBUG: try to insert IMMEDIATE downlink (count_us=%u) between index %u and index %u?\n", asap_count_us, node, next);
+                        if (jit_collision_test(asap_count_us, packet_pre_delay, packet_post_delay, queue->nodes[next].pkt.count_us, queue->nodes[next].pre_delay, queue->nodes[next].post_delay) == true) {
                             MSG_DEBUG(DEBUG_JIT, "DEBUG: failed to insert IMMEDIATE downlink (count_us=%u), continue...\n", asap_count_us);
                             continue;
                         } else {
@@ -223,7 +336,7 @@ enum jit_error_e jit_enqueue(struct jit_queue_s *queue, uint32_t time_us, struct
      */
     if ((packet->count_us - time_us) <= (TX_START_DELAY + TX_MARGIN_DELAY + TX_JIT_DELAY)) {
         MSG_DEBUG(DEBUG_JIT_ERROR, "ERROR: Packet REJECTED, already too late to send it (current=%u, packet=%u, type=%d)\n", time_us, packet->count_us, pkt_type);
-        xSemaphoreGive(mx_jit_queue);
+        xSemaphoreGive(queue->mx);
         return JIT_ERROR_TOO_LATE;
     }
 
@@ -241,7 +354,7 @@ enum jit_error_e jit_enqueue(struct jit_queue_s *queue, uint32_t time_us, struct
     if ((pkt_type == JIT_PKT_TYPE_DOWNLINK_CLASS_A) || (pkt_type == JIT_PKT_TYPE_DOWNLINK_CLASS_B)) {
         if ((packet->count_us - time_us) > TX_MAX_ADVANCE_DELAY) {
             MSG_DEBUG(DEBUG_JIT_ERROR, "ERROR: Packet REJECTED, timestamp seems wrong, too much in advance (current=%u, packet=%u, type=%d)\n", time_us, packet->count_us, pkt_type);
-            xSemaphoreGive(mx_jit_queue);
+            xSemaphoreGive(queue->mx);
             return JIT_ERROR_TOO_EARLY;
         }
     }
@@ -250,60 +363,48 @@ enum jit_error_e jit_enqueue(struct jit_queue_s *queue, uint32_t time_us, struct
      *  Note: - need to take into account packet's pre_delay and post_delay of each packet
      *        - Valid for both Downlinks and beacon packets
      *        - Beacon guard can be ignored if we try to queue a Class A downlink
+     *
+     *  Check if there is a collision
+     *  Warning: unsigned arithmetic (handle roll-over)
+     *      t_packet_new - pre_delay_packet_new < t_packet_prev + post_delay_packet_prev (OVERLAP on post delay)
+     *      t_packet_new + post_delay_packet_new > t_packet_prev - pre_delay_packet_prev (OVERLAP on pre delay)
      */
-    for (i=0; i<queue->num_pkt; i++) {
-        /* We ignore Beacon Guard for Class A/C downlinks */
-        if (((pkt_type == JIT_PKT_TYPE_DOWNLINK_CLASS_A) || (pkt_type == JIT_PKT_TYPE_DOWNLINK_CLASS_C)) && (queue->nodes[i].pkt_type == JIT_PKT_TYPE_BEACON)) {
-            target_pre_delay = TX_START_DELAY;
-        } else {
-            target_pre_delay = queue->nodes[i].pre_delay;
-        }
-
-        /* Check if there is a collision
-         *  Warning: unsigned arithmetic (handle roll-over)
-         *      t_packet_new - pre_delay_packet_new < t_packet_prev + post_delay_packet_prev (OVERLAP on post delay)
-         *      t_packet_new + post_delay_packet_new > t_packet_prev - pre_delay_packet_prev (OVERLAP on pre delay)
-         */
-        if (jit_collision_test(packet->count_us, packet_pre_delay, packet_post_delay, queue->nodes[i].pkt.count_us, target_pre_delay, queue->nodes[i].post_delay) == true) {
-            switch (queue->nodes[i].pkt_type) {
-                case JIT_PKT_TYPE_DOWNLINK_CLASS_A:
-                case JIT_PKT_TYPE_DOWNLINK_CLASS_B:
-                case JIT_PKT_TYPE_DOWNLINK_CLASS_C:
-                    MSG_DEBUG(DEBUG_JIT_ERROR, "ERROR: Packet (type=%d) REJECTED, collision with packet already programmed at %u (%u)\n", pkt_type, queue->nodes[i].pkt.count_us, packet->count_us);
-                    err_collision = JIT_ERROR_COLLISION_PACKET;
-                    break;
-                case JIT_PKT_TYPE_BEACON:
-                    if (pkt_type != JIT_PKT_TYPE_BEACON) {
-                        /* do not overload logs for beacon/beacon collision, as it is expected to happen with beacon pre-scheduling algorith used */
-                        MSG_DEBUG(DEBUG_JIT_ERROR, "ERROR: Packet (type=%d) REJECTED, collision with beacon already programmed at %u (%u)\n", pkt_type, queue->nodes[i].pkt.count_us, packet->count_us);
-                    }
-                    err_collision = JIT_ERROR_COLLISION_BEACON;
-                    break;
-                default:
-                    MSG("ERROR: Unknown packet type, should not occur, BUG?\n");
-                    assert(0);
-                    break;
-            }
-            xSemaphoreGive(mx_jit_queue);
-            return err_collision;
+    /* We ignore Beacon Guard for Class A/C downlinks */
+    i = jit_collision_find(queue, packet->count_us, packet_pre_delay, packet_post_delay, (pkt_type == JIT_PKT_TYPE_DOWNLINK_CLASS_A) || (pkt_type == JIT_PKT_TYPE_DOWNLINK_CLASS_C));
+    if (i != -1) {
+        switch (queue->nodes[i].pkt_type) {
+            case JIT_PKT_TYPE_DOWNLINK_CLASS_A:
+            case JIT_PKT_TYPE_DOWNLINK_CLASS_B:
+            case JIT_PKT_TYPE_DOWNLINK_CLASS_C:
+                MSG_DEBUG(DEBUG_JIT_ERROR, "ERROR: Packet (type=%d) REJECTED, collision with packet already programmed at %u (%u)\n", pkt_type, queue->nodes[i].pkt.count_us, packet->count_us);
+                err_collision = JIT_ERROR_COLLISION_PACKET;
+                break;
+            case JIT_PKT_TYPE_BEACON:
+                if (pkt_type != JIT_PKT_TYPE_BEACON) {
+                    /* do not overload logs for beacon/beacon collision, as it is expected to happen with beacon pre-scheduling algorith used */
+                    MSG_DEBUG(DEBUG_JIT_ERROR, "ERROR: Packet (type=%d) REJECTED, collision with beacon already programmed at %u (%u)\n", pkt_type, queue->nodes[i].pkt.count_us, packet->count_us);
+                }
+                err_collision = JIT_ERROR_COLLISION_BEACON;
+                break;
+            default:
+                MSG("ERROR: Unknown packet type, should not occur, BUG?\n");
+                assert(0);
+                break;
         }
+        xSemaphoreGive(queue->mx);
+        return err_collision;
     }
 
     /* Finally enqueue it */
-    /* Insert packet at the end of the queue */
+    /* Insert packet at the end of the array, and index it */
     memcpy(&(queue->nodes[queue->num_pkt].pkt), packet, sizeof(struct lgw_pkt_tx_s));
     queue->nodes[queue->num_pkt].pre_delay = packet_pre_delay;
     queue->nodes[queue->num_pkt].post_delay = packet_post_delay;
     queue->nodes[queue->num_pkt].pkt_type = pkt_type;
-    if (pkt_type == JIT_PKT_TYPE_BEACON) {
-        queue->num_beacon++;
-    }
-    queue->num_pkt++;
-    /* Sort the queue in ascending order of packet timestamp */
-    jit_sort_queue(queue);
+    jit_node_add(queue);
 
     /* Done */
-    xSemaphoreGive(mx_jit_queue);
+    xSemaphoreGive(queue->mx);
 
     jit_print_queue(queue, false, DEBUG_JIT);
 
@@ -323,31 +424,32 @@ enum jit_error_e jit_dequeue(struct jit_queue_s *queue, int index, struct lgw_pk
         return JIT_ERROR_INVALID;
     }
 
+    xSemaphoreTake(queue->mx, portMAX_DELAY);
+
     if (jit_queue_is_empty(queue)) {
+        xSemaphoreGive(queue->mx);
         MSG("ERROR: cannot dequeue packet, JIT queue is empty\n");
         return JIT_ERROR_EMPTY;
     }
 
-    xSemaphoreTake(mx_jit_queue, portMAX_DELAY);
+    if (index >= queue->num_pkt) {
+        xSemaphoreGive(queue->mx);
+        MSG("ERROR: invalid parameter\n");
+        return JIT_ERROR_INVALID;
+    }
 
     /* Dequeue requested packet */
     memcpy(packet, &(queue->nodes[index].pkt), sizeof(struct lgw_pkt_tx_s));
-    queue->num_pkt--;
     *pkt_type = queue->nodes[index].pkt_type;
     if (*pkt_type == JIT_PKT_TYPE_BEACON) {
-        queue->num_beacon--;
         MSG_DEBUG(DEBUG_BEACON, "--- Beacon dequeued ---\n");
     }
 
     /* Replace dequeued packet with last packet of the queue */
-    memcpy(&(queue->nodes[index]), &(queue->nodes[queue->num_pkt]), sizeof(struct jit_node_s));
-    memset(&(queue->nodes[queue->num_pkt]), 0, sizeof(struct jit_node_s));
-
-    /* Sort queue in ascending order of packet timestamp */
-    jit_sort_queue(queue);
+    jit_node_remove(queue, index);
 
     /* Done */
-    xSemaphoreGive(mx_jit_queue);
+    xSemaphoreGive(queue->mx);
 
     jit_print_queue(queue, false, DEBUG_JIT);
 
@@ -359,83 +461,82 @@ enum jit_error_e jit_dequeue(struct jit_queue_s *queue, int index, struct lgw_pk
 enum jit_error_e jit_peek(struct jit_queue_s *queue, uint32_t time_us, int *pkt_idx) {
     /* Return index of node containing a packet inline with given time */
     int i = 0;
-    int idx_highest_priority = -1;
     if (pkt_idx == NULL) {
         MSG("ERROR: invalid parameter\n");
         return JIT_ERROR_INVALID;
     }
 
+    xSemaphoreTake(queue->mx, portMAX_DELAY);
+
     if (jit_queue_is_empty(queue)) {
+        xSemaphoreGive(queue->mx);
         return JIT_ERROR_EMPTY;
     }
 
-    xSemaphoreTake(mx_jit_queue, portMAX_DELAY);
-
-    /* Search for highest priority packet to be sent */
-    for (i=0; i<queue->num_pkt; i++) {
-        /* First check if that packet is outdated:
-         *  If a packet seems too much in advance, and was not rejected at enqueue time,
-         *  it means that we missed it for peeking, we need to drop it
-         *
-         *  Warning: unsigned arithmetic
-         *      t_packet > t_current + TX_MAX_ADVANCE_DELAY
-         */
-        if ((queue->nodes[i].pkt.count_us - time_us) >= TX_MAX_ADVANCE_DELAY) {
-            /* We drop the packet to avoid lock-up */
-            queue->num_pkt--;
-            if (queue->nodes[i].pkt_type == JIT_PKT_TYPE_BEACON) {
-                queue->num_beacon--;
-                MSG("WARNING: --- Beacon dropped (current_time=%u, packet_time=%u) ---\n", time_us, queue->nodes[i].pkt.count_us);
-            } else {
-                MSG("WARNING: --- Packet dropped (current_time=%u, packet_time=%u) ---\n", time_us, queue->nodes[i].pkt.count_us);
-            }
-
-            /* Replace dropped packet with last packet of the queue */
-            memcpy(&(queue->nodes[i]), &(queue->nodes[queue->num_pkt]), sizeof(struct jit_node_s));
-            memset(&(queue->nodes[queue->num_pkt]), 0, sizeof(struct jit_node_s));
-
-            /* Sort queue in ascending order of packet timestamp */
-            jit_sort_queue(queue);
-
-            /* restart loop  after purge to find packet to be sent */
-            i = 0;
-            continue;
+    /* First drop the outdated packets:
+     *  If a packet seems too much in advance, and was not rejected at enqueue time,
+     *  it means that we missed it for peeking, we need to drop it
+     *  Those are the first ones in time (missed) or the last ones (too far)
+     *
+     *  Warning: unsigned arithmetic
+     *      t_packet > t_current + TX_MAX_ADVANCE_DELAY
+     */
+    while (queue->num_pkt > 0) {
+        if ((queue->nodes[queue->heap[0]].pkt.count_us - time_us) >= TX_MAX_ADVANCE_DELAY) {
+            i = queue->heap[0];
+        } else if ((queue->nodes[queue->order[queue->num_pkt - 1]].pkt.count_us - time_us) >= TX_MAX_ADVANCE_DELAY) {
+            i = queue->order[queue->num_pkt - 1];
+        } else {
+            break;
         }
 
-        /* Then look for highest priority packet to be sent:
-         *  Warning: unsigned arithmetic (handle roll-over)
-         *      t_packet < t_highest
-         */
-        if ((idx_highest_priority == -1) || (((queue->nodes[i].pkt.count_us - time_us) < (queue->nodes[idx_highest_priority].pkt.count_us - time_us)))) {
-            idx_highest_priority = i;
+        /* We drop the packet to avoid lock-up */
+        if (queue->nodes[i].pkt_type == JIT_PKT_TYPE_BEACON) {
+            MSG("WARNING: --- Beacon dropped (current_time=%u, packet_time=%u) ---\n", time_us, queue->nodes[i].pkt.count_us);
+        } else {
+            MSG("WARNING: --- Packet dropped (current_time=%u, packet_time=%u) ---\n", time_us, queue->nodes[i].pkt.count_us);
         }
+        jit_node_remove(queue, i);
     }
 
-    /* Peek criteria 1: look for a packet to be sent in next TX_JIT_DELAY ms timeframe
+    /* Then the highest priority packet to be sent is the first one in time
+     * Peek criteria 1: look for a packet to be sent in next TX_JIT_DELAY ms timeframe
      *  Warning: unsigned arithmetic (handle roll-over)
      *      t_packet < t_current + TX_JIT_DELAY
      */
-    if ((queue->nodes[idx_highest_priority].pkt.count_us - time_us) < TX_JIT_DELAY) {
-        *pkt_idx = idx_highest_priority;
+    if ((queue->num_pkt > 0) && ((queue->nodes[queue->heap[0]].pkt.count_us - time_us) < TX_JIT_DELAY)) {
+        *pkt_idx = queue->heap[0];
         MSG_DEBUG(DEBUG_JIT, "peek packet with count_us=%u at index %d\n",
-            queue->nodes[idx_highest_priority].pkt.count_us, idx_highest_priority);
+            queue->nodes[*pkt_idx].pkt.count_us, *pkt_idx);
     } else {
         *pkt_idx = -1;
     }
 
-    xSemaphoreGive(mx_jit_queue);
+    xSemaphoreGive(queue->mx);
 
     return JIT_ERROR_OK;
 }
 
+bool jit_queue_head(struct jit_queue_s *queue, uint32_t *count_us) {
+    struct jit_head_s head;
+
+    stats_read(&queue->head, &head, sizeof head);
+    if (head.valid == true) {
+        *count_us = head.count_us;
+    }
+
+    return head.valid;
+}
+
 void jit_print_queue(struct jit_queue_s *queue, bool show_all, int debug_level) {
     int i = 0;
     int loop_end;
 
+    xSemaphoreTake(queue->mx, portMAX_DELAY);
+
     if (jit_queue_is_empty(queue)) {
         MSG_DEBUG(debug_level, "INFO: [jit] queue is empty\n");
     } else {
-        xSemaphoreTake(mx_jit_queue, portMAX_DELAY);
 
         MSG_DEBUG(debug_level, "INFO: [jit] queue contains %d packets:\n", queue->num_pkt);
         MSG_DEBUG(debug_level, "INFO: [jit] queue contains %d beacons:\n", queue->num_beacon);
@@ -446,7 +547,7 @@ void jit_print_queue(struct jit_queue_s *queue, bool show_all, int debug_level)
                         queue->nodes[i].pkt.count_us,
                         queue->nodes[i].pkt_type);
         }
-
-        xSemaphoreGive(mx_jit_queue);
     }
+
+    xSemaphoreGive(queue->mx);
 }
@@ -22,9 +22,15 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 #include <sys/time.h>   /* timeval */
 
 #include "loragw_hal.h"
+#include "stats.h"
 
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 
-#define JIT_QUEUE_MAX           32  /* Maximum number of packets to be stored in JiT queue */
+
+#ifndef JIT_QUEUE_MAX
+#define JIT_QUEUE_MAX           32  /* Maximum number of packets to be stored in JiT queue, up to 65535 */
+#endif
 #define JIT_NUM_BEACON_IN_QUEUE 3   /* Number of beacons to be loaded in JiT queue at any time */
 
 
@@ -59,37 +65,40 @@ struct jit_node_s {
     uint32_t post_delay;            /* Amount of time after packet timestamp to be reserved (time on air) */
 };
 
+/* First packet in time of a queue, written under the queue lock, read without it */
+struct jit_head_s {
+    stats_seq_t seq;                /* Sequence counter, see stats.h */
+    bool valid;                     /* The queue holds a packet */
+    uint32_t count_us;              /* Concentrator time it must be sent at */
+};
+
+/* Packets are kept in nodes[0..num_pkt), in no particular order. Two indexes on
+   their count_us, wrap-aware, give the order: a min-heap for the next packet to be
+   sent, and a sorted array to find the packets a new one may collide with.
+   Each queue has its own lock, so that the RF chains do not wait for each other. */
 struct jit_queue_s {
-    uint8_t num_pkt;                /* Total number of packets in the queue (downlinks, beacons...) */
+    SemaphoreHandle_t mx;           /* Control access to the queue, created by the first jit_queue_init */
+    struct jit_head_s head;         /* Snapshot of the first packet in time */
+    uint16_t num_pkt;               /* Total number of packets in the queue (downlinks, beacons...) */
     uint8_t num_beacon;             /* Number of beacons in the queue */
+    uint32_t max_pre_delay;         /* Largest pre_delay in the queue since it was last empty */
+    uint32_t max_post_delay;        /* Largest post_delay in the queue since it was last empty */
+    uint16_t heap[JIT_QUEUE_MAX];   /* Node indexes, min-heap on count_us */
+    uint16_t heap_pos[JIT_QUEUE_MAX]; /* Position of each node in heap */
+    uint16_t order[JIT_QUEUE_MAX];  /* Node indexes in ascending count_us */
     struct jit_node_s nodes[JIT_QUEUE_MAX]; /* Nodes/packets array in the queue */
 };
 
 /* -------------------------------------------------------------------------- */
 /* --- PUBLIC FUNCTIONS PROTOTYPES ------------------------------------------ */
 
-/**
-@brief Check if a JiT queue is full.
-
-@param queue[in] Just in Time queue to be checked.
-@return true if queue is full, false otherwise.
-*/
-bool jit_queue_is_full(struct jit_queue_s *queue);
-
-/**
-@brief Check if a JiT queue is empty.
-
-@param queue[in] Just in Time queue to be checked.
-@return true if queue is empty, false otherwise.
-*/
-bool jit_queue_is_empty(struct jit_queue_s *queue);
-
 /**
 @brief Initialize a Just in Time queue.
 
-@param queue[in] Just in Time queue to be initialized. Memory should have been allocated already.
+@param queue[in] Just in Time queue to be initialized. Memory should have been allocated already, zeroed.
 
-This function is used to reset every elements in the allocated queue.
+This function is used to reset every elements in the allocated queue. The lock of the
+queue is created the first time, and kept when the queue is initialized again.
 */
 void jit_queue_init(struct jit_queue_s *queue);
 
@@ -112,7 +121,7 @@ enum jit_error_e jit_enqueue(struct jit_queue_s *queue, uint32_t time_us, struct
 @brief Dequeue a packet from a Just-in-Time queue
 
 @param queue[in/out] Just in Time queue from which the packet should be removed
-@param index[in] in the queue where to get the packet to be removed
+@param index[in] node in the queue where to get the packet to be removed
 @param packet[out] that was at index
 @param pkt_type[out] Type of packet dequeued: Downlink, Beacon
 @return success if the function was able to dequeue the packet
@@ -136,6 +145,19 @@ enough the current concentrator time.
 */
 enum jit_error_e jit_peek(struct jit_queue_s *queue, uint32_t time_us, int *pkt_idx);
 
+/**
+@brief Get the time of the next packet to be sent from a JiT queue.
+
+@param queue[in] Just in Time queue
+@param count_us[out] Concentrator time the first packet in time must be sent at
+@return true if the queue holds a packet, false if it is empty
+
+This function is typically used to know when jit_peek will have a packet to be sent.
+The packet may be outdated, jit_peek will then drop it. It does not take the queue
+lock, so that the dispatcher never waits for an enqueue in progress.
+*/
+bool jit_queue_head(struct jit_queue_s *queue, uint32_t *count_us);
+
 /**
 @brief Debug function to print the queue's content on console
 
@@ -45,13 +45,24 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 
 #include "trace.h"
 #include "jitqueue.h"
+#include "rxpk_json.h"
+#include "txpk_json.h"
+#include "push_bin.h"
+#include "spool.h"
+#include "stats.h"
+#include "upfilter.h"
+#include "timecache.h"
+#include "servers.h"
+#include "cntclock.h"
 #include "parson.h"
 #include "base64.h"
+#include "crc16.h"
 #include "loragw_hal.h"
 #include "loragw_aux.h"
 #include "loragw_reg.h"
 #include "loragw_gps.h"
 #include "loragw_gpio.h"
+#include "loragw_rxpool.h"
 
 /// For ESP32
 #include "freertos/FreeRTOS.h"
@@ -68,6 +79,7 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 #include "argtable3/argtable3.h"
 #include "esp_netif.h"
 #include "esp_timer.h"
+#include "esp_heap_caps.h"
 
 #include "lwip/err.h"
 #include "lwip/sys.h"
@@ -106,10 +118,34 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 #define PULL_TIMEOUT_MS     200
 #define GPS_REF_MAX_AGE     30          /* maximum admitted delay in seconds of GPS loss before considering latest GPS sync unusable */
 #define FETCH_SLEEP_MS      10          /* nb of ms waited when a fetch return no packets */
+#define FETCH_WATCHDOG_MS   100         /* nb of ms waited for an RX interrupt before fetching anyway */
+#define LATENCY_SAMPLES_NB  128         /* nb of uplink latency samples kept per statistics interval */
 #define BEACON_POLL_MS      50          /* time in ms between polling of beacon TX status */
+#define JIT_DISPATCH_LEAD_US 30000      /* a packet is taken from the JiT queue this long before its count_us, less than TX_JIT_DELAY */
+#define JIT_CLOCK_MAX_AGE_US 5000000    /* longest time the concentrator counter is extrapolated without being read */
 
 #define PROTOCOL_VERSION    2           /* v1.6 */
-#define PROTOCOL_JSON_RXPK_FRAME_FORMAT 1
+
+#define PUSH_FORMAT_JSON    0           /* PUSH_DATA payload format: JSON object, see PROTOCOL.md */
+#define PUSH_FORMAT_BINARY  1           /* binary records, see PROTOCOL_BINARY.md */
+#define PUSH_FORMAT_AUTO    2           /* binary if the server acknowledges it, JSON otherwise */
+
+#define AGGR_MAX_BYTES      1400        /* default PUSH_DATA size budget, fits a 1500 bytes MTU with IP/UDP headers */
+#define AGGR_MIN_BYTES      256         /* smallest PUSH_DATA size budget accepted */
+
+#define UP_FLUSH_DEADLINE   0           /* PUSH_DATA sent: oldest packet reached aggr_max_latency_ms */
+#define UP_FLUSH_SIZE       1           /* PUSH_DATA sent: next packet would exceed aggr_max_bytes */
+#define UP_FLUSH_URGENT     2           /* PUSH_DATA sent: join-request or confirmed uplink */
+#define UP_FLUSH_REPORT     3           /* PUSH_DATA sent: status report alone */
+#define UP_FLUSH_REPLAY     4           /* PUSH_DATA sent: spooled packets replayed */
+#define UP_FLUSH_NB         5
+
+#define SPOOL_OUTAGE_NB     3           /* default nb of PUSH_DATA not acknowledged in a row before packets are spooled */
+#define SPOOL_REPLAY_RATE   5           /* default max nb of replay PUSH_DATA per second */
+#define SPOOL_PROBE_MS      2000        /* time between single packet replays while the server does not answer */
+#define SPOOL_PATH_SIZE     64
+
+#define LOG_DRAIN_PRIO      1           /* deferred logging drain task, below every forwarder task */
 
 #define XERR_INIT_AVG       16          /* nb of measurements the XTAL correction is averaged on as initial value */
 #define XERR_FILT_COEF      256         /* coefficient for low-pass XTAL error tracking */
@@ -130,6 +166,7 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 
 #define STATUS_SIZE     200
 #define TX_BUFF_SIZE    ((540 * NB_PKT_MAX) + 30 + STATUS_SIZE)
+#define RXPK_BUFF_SIZE  700 /* one serialized rxpk, JSON or binary */
 #define ACK_BUFF_SIZE   64
 
 #define UNIX_GPS_EPOCH_OFFSET 315964800 /* Number of seconds ellapsed between 01.Jan.1970 00:00:00
@@ -178,8 +215,6 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 #define TIME_REFRESH    5  // display the time on screen every 5s
 #define N_CHAR_A_ROW    21  // max chars in a row is 21 in oled display mode=1
 
-#define IP_LEN  32  // a right ip address should be no more than 16 bytes. some extra space for failed solving
-
 
 /* FreeRTOS event group to signal when we are connected*/
 static EventGroupHandle_t s_wifi_event_group;
@@ -211,6 +246,17 @@ typedef struct spectral_scan_s {
     uint32_t pace_s;        /* number of seconds between 2 scans in the thread */
 } spectral_scan_t;
 
+/* PUSH_DATA under construction in buff_up, packets of several fetches can be aggregated in it */
+typedef struct up_dgram_s {
+    bool open;              /* header written, token drawn */
+    bool binary;            /* binary PUSH_DATA, JSON otherwise */
+    int index;              /* bytes used in buff_up */
+    unsigned nb_pkt;        /* nb of rxpk in the datagram */
+    int64_t deadline;       /* time the datagram must be sent, set by its first rxpk */
+    int64_t first_fetch;    /* fetch time of its first rxpk */
+    int64_t fetch_sum;      /* sum of the fetch times of its rxpk */
+} up_dgram_t;
+
 
 /* signal handling variables */
 volatile bool exit_sig = false; /* 1 -> application terminates cleanly (shut down hardware, close open files, etc) */
@@ -221,6 +267,14 @@ static bool fwd_valid_pkt = true; /* packets with PAYLOAD CRC OK are forwarded *
 static bool fwd_error_pkt = false; /* packets with PAYLOAD CRC ERROR are NOT forwarded */
 static bool fwd_nocrc_pkt = false; /* packets with NO PAYLOAD CRC are NOT forwarded */
 
+/* uplink filter on DevAddr and JoinEUI, changed by the uplink_filter command */
+static SemaphoreHandle_t mx_upfilter; /* control access to the uplink filter */
+static struct upfilter_s upfilter; /* filter in use, copied by thread_up when upfilter_gen changes */
+static uint32_t upfilter_gen = 1; /* incremented on each change of the filter */
+
+/* deferred logging, see trace.h */
+static uint32_t log_ring_size = 0; /* size of the log ring, in bytes, 0 for synchronous logging */
+
 /* network configuration variables */
 static uint64_t lgwm = 0; /* Lora gateway MAC address */
 static char serv_addr[64] = STR(DEFAULT_SERVER); /* address of the server (host name or IPv4/IPv6) */
@@ -231,19 +285,43 @@ static int keepalive_time = DEFAULT_KEEPALIVE; /* send a PULL_DATA request every
 /* statistics collection configuration variables */
 static unsigned stat_interval = DEFAULT_STAT; /* time interval (in sec) at which statistics are collected and displayed */
 
+/* packet fetch configuration variables */
+static bool fetch_irq = true; /* wait for the SX1302 RX interrupt instead of polling, when SX1302_RX_IRQ_PIN is wired */
+
 /* gateway <-> MAC protocol variables */
 static uint32_t net_mac_h; /* Most Significant Nibble, network order */
 static uint32_t net_mac_l; /* Least Significant Nibble, network order */
 
-/* network sockets */
-static int sock_up; /* socket for upstream traffic */
-static int sock_down; /* socket for downstream traffic */
-struct sockaddr_in dest_addr;
-struct sockaddr_in source_addr;
+/* servers the uplinks are sent to, the first one being the network server above, each with its own sockets */
+static struct serv_s serv[SERV_MAX];
+static int serv_nb = 1;
 
 /* network protocol variables */
 static struct timeval push_timeout_half = {0, (PUSH_TIMEOUT_MS * 500)}; /* cut in half, critical for throughput */
-static struct timeval pull_timeout = {0, (PULL_TIMEOUT_MS * 1000)}; /* non critical for throughput */
+
+/* PUSH_DATA format, binary being negotiated in auto mode through the protocol version of the PUSH_ACK of an empty binary PUSH_DATA */
+static uint8_t push_format = PUSH_FORMAT_JSON;
+static volatile bool push_binary = false; /* true while binary PUSH_DATA are sent, to every server */
+static uint32_t push_probe_token[SERV_MAX]; /* 1 + token of the last binary probe sent to each server, 0 if none */
+
+/* uplink aggregation across fetch cycles */
+static int aggr_max_bytes = AGGR_MAX_BYTES; /* a PUSH_DATA is sent before the next packet takes it over this size */
+static uint32_t aggr_max_latency_ms = 0; /* max time a packet waits for others, 0 for one PUSH_DATA per fetch */
+static bool aggr_flush_urgent = true; /* join-requests & confirmed uplinks are sent at once */
+
+/* store-and-forward of the packets received while the server does not acknowledge PUSH_DATA */
+static uint32_t spool_ram_size = 0; /* RAM spool, in bytes, 0 to disable spooling */
+static char spool_file_path[SPOOL_PATH_SIZE] = ""; /* overflow of the RAM spool, on a mounted filesystem */
+static uint32_t spool_file_size = 0; /* max size of that file, in bytes */
+static int spool_drop_policy = SPOOL_DROP_OLDEST;
+static uint32_t spool_outage_nb = SPOOL_OUTAGE_NB;
+static uint32_t spool_replay_rate = SPOOL_REPLAY_RATE;
+static bool spool_enabled = false;
+static SemaphoreHandle_t mx_spool; /* control access to the spool */
+static struct spool_s spool;
+
+/* PUSH_DATA acknowledgement, thread_up registers the tokens sent and thread_up_ack matches the PUSH_ACK */
+static SemaphoreHandle_t mx_push_ack; /* control access to the in-flight PUSH_DATA tables of the servers */
 
 /* hardware access control and correction */
 SemaphoreHandle_t mx_concent; /* control access to the concentrator */
@@ -267,34 +345,75 @@ static struct coord_s reference_coord;
 /* Enable faking the GPS coordinates of the gateway */
 static bool gps_fake_enable; /* enable the feature */
 
-/* measurements to establish statistics */
-static SemaphoreHandle_t mx_meas_up; /* control access to the upstream measurements */
-static uint32_t meas_nb_rx_rcv = 0; /* count packets received */
-static uint32_t meas_nb_rx_ok = 0; /* count packets received with PAYLOAD CRC OK */
-static uint32_t meas_nb_rx_bad = 0; /* count packets received with PAYLOAD CRC ERROR */
-static uint32_t meas_nb_rx_nocrc = 0; /* count packets received with NO PAYLOAD CRC */
-static uint32_t meas_up_pkt_fwd = 0; /* number of radio packet forwarded to the server */
-static uint32_t meas_up_network_byte = 0; /* sum of UDP bytes sent for upstream traffic */
-static uint32_t meas_up_payload_byte = 0; /* sum of radio payload bytes sent for upstream traffic */
-static uint32_t meas_up_dgram_sent = 0; /* number of datagrams sent for upstream traffic */
-static uint32_t meas_up_ack_rcv = 0; /* number of datagrams acknowledged for upstream traffic */
-
-static SemaphoreHandle_t mx_meas_dw; /* control access to the downstream measurements */
-static uint32_t meas_dw_pull_sent = 0; /* number of PULL requests sent for downstream traffic */
-static uint32_t meas_dw_ack_rcv = 0; /* number of PULL requests acknowledged for downstream traffic */
-static uint32_t meas_dw_dgram_rcv = 0; /* count PULL response packets received for downstream traffic */
-static uint32_t meas_dw_network_byte = 0; /* sum of UDP bytes sent for upstream traffic */
-static uint32_t meas_dw_payload_byte = 0; /* sum of radio payload bytes sent for upstream traffic */
-static uint32_t meas_nb_tx_ok = 0; /* count packets emitted successfully */
-static uint32_t meas_nb_tx_fail = 0; /* count packets were TX failed for other reasons */
-static uint32_t meas_nb_tx_requested = 0; /* count TX request from server (downlinks) */
-static uint32_t meas_nb_tx_rejected_collision_packet = 0; /* count packets were TX request were rejected due to collision with another packet already programmed */
-static uint32_t meas_nb_tx_rejected_collision_beacon = 0; /* count packets were TX request were rejected due to collision with a beacon already programmed */
-static uint32_t meas_nb_tx_rejected_too_late = 0; /* count packets were TX request were rejected because it is too late to program it */
-static uint32_t meas_nb_tx_rejected_too_early = 0; /* count packets were TX request were rejected because timestamp is too much in advance */
-static uint32_t meas_nb_beacon_queued = 0; /* count beacon inserted in jit queue */
-static uint32_t meas_nb_beacon_sent = 0; /* count beacon actually sent to concentrator */
-static uint32_t meas_nb_beacon_rejected = 0; /* count beacon rejected for queuing */
+/* measurements to establish statistics, each block written by a single task and read without lock (stats.h) */
+struct meas_up_s {
+    stats_seq_t seq;
+    uint32_t rx_rcv; /* count packets received */
+    uint32_t rx_ok; /* count packets received with PAYLOAD CRC OK */
+    uint32_t rx_bad; /* count packets received with PAYLOAD CRC ERROR */
+    uint32_t rx_nocrc; /* count packets received with NO PAYLOAD CRC */
+    uint32_t pkt_fwd; /* number of radio packet forwarded to the server */
+    uint32_t filter_devaddr; /* number of radio packets dropped by the uplink filter on their DevAddr */
+    uint32_t filter_joineui; /* number of radio packets dropped by the uplink filter on their JoinEUI */
+    uint32_t network_byte; /* sum of UDP bytes sent for upstream traffic */
+    uint32_t payload_byte; /* sum of radio payload bytes sent for upstream traffic */
+    uint32_t dgram_sent; /* number of datagrams sent for upstream traffic */
+    uint32_t ack_evicted[SERV_MAX]; /* number of datagrams whose PUSH_ACK was no longer waited for, tracking table full, per server */
+    uint32_t fetch_nb; /* number of fetches (SPI accesses to the RX buffer) */
+    uint32_t fetch_empty; /* number of fetches that returned no packet */
+    uint32_t latency[LATENCY_SAMPLES_NB]; /* latest RX edge (polling: previous fetch) to fetch completion delays, in us */
+    uint32_t latency_nb; /* number of latency measurements, latency[] indexed modulo LATENCY_SAMPLES_NB */
+    uint32_t cycle_nb; /* number of fetches that returned packets */
+    uint64_t cycle_sum; /* sum of times from a fetch that returned packets to the next fetch, in us */
+    stats_max_t cycle_max; /* max of these times, in us */
+    uint32_t aggr_pkt; /* number of packets sent through the aggregation stage */
+    uint64_t aggr_delay_sum; /* sum of the delays from packet fetch to PUSH_DATA send, in us */
+    stats_max_t aggr_delay_max; /* max of these delays, in us */
+    uint32_t flush[UP_FLUSH_NB]; /* number of PUSH_DATA sent, per reason */
+    uint32_t pkt_log[LGW_IF_CHAIN_NB][8]; /* packets forwarded per [CH][SF], FSK in [9][0] */
+    uint32_t pkt_lora; /* number of LoRa packets forwarded */
+    uint32_t pkt_fsk; /* number of FSK packets forwarded */
+};
+static struct meas_up_s meas_up; /* written by thread_up */
+
+struct meas_up_ack_s {
+    stats_seq_t seq;
+    uint32_t ack_rcv; /* number of datagrams acknowledged for upstream traffic */
+    uint32_t ack_timeout; /* number of datagrams not acknowledged within push_timeout_ms */
+    uint64_t ack_rtt_sum; /* sum of PUSH_ACK round trip times, in us */
+    stats_max_t ack_rtt_max; /* max PUSH_ACK round trip time, in us */
+};
+static struct meas_up_ack_s meas_up_ack[SERV_MAX]; /* written by thread_up_ack, per server */
+
+struct meas_dw_s {
+    stats_seq_t seq;
+    uint32_t pull_sent[SERV_MAX]; /* number of PULL requests sent for downstream traffic, per server */
+    uint32_t ack_rcv[SERV_MAX]; /* number of PULL requests acknowledged for downstream traffic, per server */
+    uint32_t dgram_rcv; /* count PULL response packets received for downstream traffic */
+    uint32_t dgram_rejected; /* count datagrams not coming from the server they were received for */
+    uint32_t network_byte; /* sum of UDP bytes sent for upstream traffic */
+    uint32_t payload_byte; /* sum of radio payload bytes sent for upstream traffic */
+    uint32_t tx_requested; /* count TX request from server (downlinks) */
+    uint32_t tx_rejected_collision_packet; /* count packets were TX request were rejected due to collision with another packet already programmed */
+    uint32_t tx_rejected_collision_beacon; /* count packets were TX request were rejected due to collision with a beacon already programmed */
+    uint32_t tx_rejected_too_late; /* count packets were TX request were rejected because it is too late to program it */
+    uint32_t tx_rejected_too_early; /* count packets were TX request were rejected because timestamp is too much in advance */
+    uint32_t beacon_queued; /* count beacon inserted in jit queue */
+    uint32_t beacon_rejected; /* count beacon rejected for queuing */
+};
+static struct meas_dw_s meas_dw; /* written by thread_down */
+
+struct meas_jit_s {
+    stats_seq_t seq;
+    uint32_t tx_ok; /* count packets emitted successfully */
+    uint32_t tx_fail; /* count packets were TX failed for other reasons */
+    uint32_t beacon_sent; /* count beacon actually sent to concentrator */
+    uint32_t cnt_read; /* count concentrator counter reads, over SPI */
+    uint32_t dispatch_nb; /* count packets taken from the JiT queue */
+    uint32_t jitter_sum; /* sum of the lead time errors of the packets taken, in us */
+    stats_max_t jitter_max; /* max lead time error, in us */
+};
+static struct meas_jit_s meas_jit; /* written by thread_jit */
 
 static SemaphoreHandle_t mx_meas_gps; /* control access to the GPS statistics */
 static bool gps_coord_valid; /* could we get valid GPS coordinates ? */
@@ -304,6 +423,7 @@ static struct coord_s meas_gps_err; /* GPS position of the gateway */
 static SemaphoreHandle_t mx_stat_rep; /* control access to the status report */
 static bool report_ready = false; /* true when there is a new report to send to the server */
 static char status_report[STATUS_SIZE]; /* status report as a JSON object */
+static struct push_bin_stat_s status_report_bin; /* same status report, for binary PUSH_DATA */
 
 /* beacon parameters */
 static uint32_t beacon_period = 0; /* set beaconing period, must be a sub-multiple of 86400, the nb of sec in a day */
@@ -330,10 +450,6 @@ static uint32_t tx_freq_min[LGW_RF_CHAIN_NB]; /* lowest frequency supported by T
 static uint32_t tx_freq_max[LGW_RF_CHAIN_NB]; /* highest frequency supported by TX chain */
 static bool tx_enable[LGW_RF_CHAIN_NB] = {false}; /* Is TX enabled for a given RF chain ? */
 
-static uint32_t nb_pkt_log[LGW_IF_CHAIN_NB][8]; /* [CH][SF] */
-static uint32_t nb_pkt_received_lora = 0;
-static uint32_t nb_pkt_received_fsk = 0;
-
 static struct lgw_conf_debug_s debugconf;
 static uint32_t nb_pkt_received_ref[16];
 
@@ -363,18 +479,29 @@ static int parse_gateway_configuration(const char * conf_array);
 
 static int parse_debug_configuration(const char * conf_array);
 
-static uint16_t crc16(const uint8_t * data, unsigned size);
-
 static double difftimespec(struct timespec end, struct timespec beginning);
 
+static bool pull_due(const struct timespec * now);
+
+static int compare_u32(const void *a, const void *b);
+
 static void gps_process_sync(void);
 
 static void gps_process_coords(void);
 
 static int get_tx_gain_lut_index(uint8_t rf_chain, int8_t rf_power, uint8_t * lut_index);
 
+static void print_upfilter(const struct upfilter_s * f);
+
+static void wake_jit(void);
+
+static void jit_timer_cb(void * arg);
+
+static uint32_t jit_read_counter(struct cntclock_s * clock);
+
 /* threads */
 void thread_up(void);
+void thread_up_ack(void);
 void thread_down(void);
 void thread_jit(void);
 void thread_gps(void);
@@ -430,6 +557,7 @@ static int parse_SX130x_configuration(const char * conf_array) {
     JSON_Object *conf_obj = NULL;
     JSON_Object *conf_txgain_obj;
     JSON_Object *conf_ts_obj;
+    JSON_Object *conf_temp_obj;
     JSON_Object *conf_sx1261_obj = NULL;
     JSON_Object *conf_scan_obj = NULL;
     JSON_Object *conf_lbt_obj = NULL;
@@ -443,6 +571,7 @@ static int parse_SX130x_configuration(const char * conf_array) {
     struct lgw_conf_rxif_s ifconf;
     struct lgw_conf_demod_s demodconf;
     struct lgw_conf_ftime_s tsconf;
+    struct lgw_conf_temp_s tempconf;
     struct lgw_conf_sx1261_s sx1261conf;
     uint32_t sf, bw, fdev;
     bool sx1250_tx_lut;
@@ -567,6 +696,42 @@ static int parse_SX130x_configuration(const char * conf_array) {
         }
     }
 
+    /* set temperature sampler configuration */
+    conf_temp_obj = json_object_get_object(conf_obj, "temperature");
+    if (conf_temp_obj == NULL) {
+        MSG("INFO: conf array does not contain a JSON object for temperature, using default sampler settings\n");
+    } else {
+        memset(&tempconf, 0, sizeof tempconf); /* initialize configuration structure */
+        val = json_object_get_value(conf_temp_obj, "enable"); /* fetch value (if possible) */
+        if (json_value_get_type(val) == JSONBoolean) {
+            tempconf.enable = (bool)json_value_get_boolean(val);
+        } else {
+            MSG("WARNING: Data type for temperature.enable seems wrong, please check\n");
+            tempconf.enable = false;
+        }
+        val = json_object_get_value(conf_temp_obj, "period_ms"); /* fetch value (if possible) */
+        if (json_value_get_type(val) == JSONNumber) {
+            tempconf.period_ms = (uint32_t)json_value_get_number(val);
+        } else {
+            MSG("WARNING: Data type for temperature.period_ms seems wrong, please check\n");
+            tempconf.period_ms = 1000;
+        }
+        val = json_object_get_value(conf_temp_obj, "max_age_ms"); /* fetch value (if possible) */
+        if (json_value_get_type(val) == JSONNumber) {
+            tempconf.max_age_ms = (uint32_t)json_value_get_number(val);
+        } else {
+            MSG("WARNING: Data type for temperature.max_age_ms seems wrong, please check\n");
+            tempconf.max_age_ms = 10000;
+        }
+        MSG("INFO: temperature sampler %s, period %u ms, max age %u ms\n", (tempconf.enable == true) ? "enabled" : "disabled", tempconf.period_ms, tempconf.max_age_ms);
+
+        /* all parameters parsed, submitting configuration to the HAL */
+        if (lgw_temp_setconf(&tempconf) != LGW_HAL_SUCCESS) {
+            MSG("ERROR: Failed to configure temperature sampler\n");
+            return -1;
+        }
+    }
+
     /* set SX1261 configuration */
     memset(&sx1261conf, 0, sizeof sx1261conf); /* initialize configuration structure */
     conf_sx1261_obj = json_object_get_object(conf_obj, "sx1261_conf"); /* fetch value (if possible) */
@@ -1119,9 +1284,14 @@ static int parse_gateway_configuration(const char * conf_array) {
     const char conf_obj_name[] = "gateway_conf";
     JSON_Value *root_val;
     JSON_Object *conf_obj = NULL;
+    JSON_Object *filter_obj = NULL;
+    JSON_Array *serv_array = NULL;
+    JSON_Object *serv_obj = NULL;
     JSON_Value *val = NULL; /* needed to detect the absence of some fields */
     const char *str; /* pointer to sub-strings in the JSON data */
     unsigned long long ull = 0;
+    struct serv_s *s;
+    size_t i;
 
     /* try to parse JSON */
     root_val = json_parse_array_with_comments(conf_array);
@@ -1174,6 +1344,40 @@ static int parse_gateway_configuration(const char * conf_array) {
         MSG("INFO: downstream keep-alive interval is configured to %u seconds\n", keepalive_time);
     }
 
+    /* other servers the uplinks are sent to, downlinks being only accepted from the ones with "downlink" (optional) */
+    val = json_object_get_value(conf_obj, "servers");
+    serv_array = json_value_get_array(val);
+    if (serv_array != NULL) {
+        for (i = 0; i < json_array_get_count(serv_array); i++) {
+            serv_obj = json_array_get_object(serv_array, i);
+            str = json_object_get_string(serv_obj, "server_address");
+            if (str == NULL) {
+                MSG("WARNING: servers entry %u has no server_address, please check\n", (unsigned)i);
+                continue;
+            }
+            if (serv_nb >= SERV_MAX) {
+                MSG("WARNING: only %d servers are supported, \"%s\" and the next ones are ignored\n", SERV_MAX, str);
+                break;
+            }
+            s = &serv[serv_nb];
+            memset(s, 0, sizeof *s);
+            strncpy(s->addr, str, sizeof s->addr);
+            s->addr[sizeof s->addr - 1] = '\0'; /* ensure string termination */
+            val = json_object_get_value(serv_obj, "serv_port_up");
+            s->port_up = (json_value_get_type(val) == JSONNumber) ? (uint16_t)json_value_get_number(val) : DEFAULT_PORT_UP;
+            val = json_object_get_value(serv_obj, "serv_port_down");
+            s->port_down = (json_value_get_type(val) == JSONNumber) ? (uint16_t)json_value_get_number(val) : DEFAULT_PORT_DW;
+            val = json_object_get_value(serv_obj, "keepalive_interval");
+            s->keepalive = (json_value_get_type(val) == JSONNumber) ? (int)json_value_get_number(val) : keepalive_time;
+            s->downlink = (json_object_get_boolean(serv_obj, "downlink") == 1);
+            MSG("INFO: server \"%s\", ports %u/%u, is configured for uplinks%s\n", s->addr, s->port_up, s->port_down,
+                (s->downlink == true) ? " and downlinks" : " only");
+            serv_nb += 1;
+        }
+    } else if (val != NULL) {
+        MSG("WARNING: Data type for servers seems wrong, please check\n");
+    }
+
     /* get interval (in seconds) for statistics display (optional) */
     val = json_object_get_value(conf_obj, "stat_interval");
     if (val != NULL) {
@@ -1188,12 +1392,106 @@ static int parse_gateway_configuration(const char * conf_array) {
         MSG("INFO: upstream PUSH_DATA time-out is configured to %u ms\n", (unsigned)(push_timeout_half.tv_usec / 500));
     }
 
+    /* PUSH_DATA payload format (optional) */
+    str = json_object_get_string(conf_obj, "push_data_format");
+    if (str != NULL) {
+        if (strcmp(str, "json") == 0) {
+            push_format = PUSH_FORMAT_JSON;
+        } else if (strcmp(str, "binary") == 0) {
+            push_format = PUSH_FORMAT_BINARY;
+        } else if (strcmp(str, "auto") == 0) {
+            push_format = PUSH_FORMAT_AUTO;
+        } else {
+            MSG("WARNING: invalid push_data_format \"%s\", using JSON\n", str);
+            push_format = PUSH_FORMAT_JSON;
+        }
+        push_binary = (push_format == PUSH_FORMAT_BINARY); /* JSON until the server acknowledges binary in auto mode */
+        MSG("INFO: upstream PUSH_DATA format is %s\n", (push_format == PUSH_FORMAT_JSON) ? "JSON" : ((push_format == PUSH_FORMAT_BINARY) ? "binary" : "binary once acknowledged, JSON until then"));
+    }
+
+    /* uplink aggregation (optional) */
+    val = json_object_get_value(conf_obj, "aggr_max_bytes");
+    if (json_value_get_type(val) == JSONNumber) {
+        aggr_max_bytes = (int)json_value_get_number(val);
+        if (aggr_max_bytes < AGGR_MIN_BYTES) {
+            aggr_max_bytes = AGGR_MIN_BYTES;
+        } else if (aggr_max_bytes > (TX_BUFF_SIZE - STATUS_SIZE - 4)) {
+            aggr_max_bytes = TX_BUFF_SIZE - STATUS_SIZE - 4;
+        }
+    } else if (val != NULL) {
+        MSG("WARNING: Data type for aggr_max_bytes seems wrong, please check\n");
+    }
+    val = json_object_get_value(conf_obj, "aggr_max_latency_ms");
+    if (json_value_get_type(val) == JSONNumber) {
+        aggr_max_latency_ms = (uint32_t)json_value_get_number(val);
+    } else if (val != NULL) {
+        MSG("WARNING: Data type for aggr_max_latency_ms seems wrong, please check\n");
+    }
+    val = json_object_get_value(conf_obj, "aggr_flush_urgent");
+    if (json_value_get_type(val) == JSONBoolean) {
+        aggr_flush_urgent = (bool)json_value_get_boolean(val);
+    } else if (val != NULL) {
+        MSG("WARNING: Data type for aggr_flush_urgent seems wrong, please check\n");
+    }
+    MSG("INFO: PUSH_DATA sent at %d bytes or after %u ms, %s for join-requests & confirmed uplinks\n", aggr_max_bytes, aggr_max_latency_ms, (aggr_flush_urgent == true) ? "at once" : "same");
+
+    /* store-and-forward spool (optional) */
+    val = json_object_get_value(conf_obj, "spool_ram_size");
+    if (json_value_get_type(val) == JSONNumber) {
+        spool_ram_size = (uint32_t)json_value_get_number(val);
+    } else if (val != NULL) {
+        MSG("WARNING: Data type for spool_ram_size seems wrong, please check\n");
+    }
+    str = json_object_get_string(conf_obj, "spool_file");
+    if (str != NULL) {
+        strncpy(spool_file_path, str, sizeof spool_file_path);
+        spool_file_path[sizeof spool_file_path - 1] = '\0'; /* ensure string termination */
+    }
+    val = json_object_get_value(conf_obj, "spool_file_size");
+    if (json_value_get_type(val) == JSONNumber) {
+        spool_file_size = (uint32_t)json_value_get_number(val);
+    } else if (val != NULL) {
+        MSG("WARNING: Data type for spool_file_size seems wrong, please check\n");
+    }
+    str = json_object_get_string(conf_obj, "spool_drop");
+    if (str != NULL) {
+        if (strcmp(str, "oldest") == 0) {
+            spool_drop_policy = SPOOL_DROP_OLDEST;
+        } else if (strcmp(str, "newest") == 0) {
+            spool_drop_policy = SPOOL_DROP_NEWEST;
+        } else {
+            MSG("WARNING: invalid spool_drop \"%s\", dropping the oldest packets\n", str);
+            spool_drop_policy = SPOOL_DROP_OLDEST;
+        }
+    }
+    val = json_object_get_value(conf_obj, "spool_outage_nb");
+    if (json_value_get_type(val) == JSONNumber) {
+        spool_outage_nb = (uint32_t)json_value_get_number(val);
+    } else if (val != NULL) {
+        MSG("WARNING: Data type for spool_outage_nb seems wrong, please check\n");
+    }
+    val = json_object_get_value(conf_obj, "spool_replay_rate");
+    if (json_value_get_type(val) == JSONNumber) {
+        spool_replay_rate = (uint32_t)json_value_get_number(val);
+    } else if (val != NULL) {
+        MSG("WARNING: Data type for spool_replay_rate seems wrong, please check\n");
+    }
+    if (spool_ram_size > 0) {
+        MSG("INFO: packets spooled after %u PUSH_DATA not acknowledged, up to %u bytes in RAM%s%s, dropping the %s, replayed at %u PUSH_DATA/s\n",
+            spool_outage_nb, spool_ram_size, (spool_file_path[0] != '\0') ? " then in " : "", spool_file_path,
+            (spool_drop_policy == SPOOL_DROP_OLDEST) ? "oldest" : "newest", spool_replay_rate);
+    }
+
     /* packet filtering parameters */
     val = json_object_get_value(conf_obj, "forward_crc_valid");
     if (json_value_get_type(val) == JSONBoolean) {
         fwd_valid_pkt = (bool)json_value_get_boolean(val);
     }
     MSG("INFO: packets received with a valid CRC will%s be forwarded\n", (fwd_valid_pkt ? "" : " NOT"));
+    val = json_object_get_value(conf_obj, "fetch_irq");
+    if (json_value_get_type(val) == JSONBoolean) {
+        fetch_irq = (bool)json_value_get_boolean(val);
+    }
     val = json_object_get_value(conf_obj, "forward_crc_error");
     if (json_value_get_type(val) == JSONBoolean) {
         fwd_error_pkt = (bool)json_value_get_boolean(val);
@@ -1205,6 +1503,31 @@ static int parse_gateway_configuration(const char * conf_array) {
     }
     MSG("INFO: packets received with no CRC will%s be forwarded\n", (fwd_nocrc_pkt ? "" : " NOT"));
 
+    /* uplink filter on DevAddr and JoinEUI (optional) */
+    val = json_object_get_value(conf_obj, "uplink_filter");
+    filter_obj = json_value_get_object(val);
+    if (filter_obj != NULL) {
+        if (upfilter_parse(&upfilter, filter_obj, &str) != 0) {
+            MSG("WARNING: uplink_filter entry \"%s\" seems wrong, please check, uplink filter disabled\n", str);
+            upfilter_clear(&upfilter);
+        }
+        print_upfilter(&upfilter);
+    } else if (val != NULL) {
+        MSG("WARNING: Data type for uplink_filter seems wrong, please check\n");
+    }
+
+    /* deferred logging (optional) */
+    val = json_object_get_value(conf_obj, "log_ring_size");
+    if (json_value_get_type(val) == JSONNumber) {
+        log_ring_size = (uint32_t)json_value_get_number(val);
+    } else if (val != NULL) {
+        MSG("WARNING: Data type for log_ring_size seems wrong, please check\n");
+    }
+    str = json_object_get_string(conf_obj, "log_level");
+    if ((str != NULL) && (trace_set_level("all", str) != 0)) {
+        MSG("WARNING: invalid log_level \"%s\", please check\n", str);
+    }
+
     /* GPS module TTY path (optional) */
     str = json_object_get_string(conf_obj, "gps_tty_path");
     if (str != NULL) {
@@ -1375,26 +1698,6 @@ static int parse_debug_configuration(const char * config_array) {
     return 0;
 }
 
-static uint16_t crc16(const uint8_t * data, unsigned size) {
-    const uint16_t crc_poly = 0x1021;
-    const uint16_t init_val = 0x0000;
-    uint16_t x = init_val;
-    unsigned i, j;
-
-    if (data == NULL)  {
-        return 0;
-    }
-
-    for (i=0; i<size; ++i) {
-        x ^= (uint16_t)data[i] << 8;
-        for (j=0; j<8; ++j) {
-            x = (x & 0x8000) ? (x<<1) ^ crc_poly : (x<<1);
-        }
-    }
-
-    return x;
-}
-
 static double difftimespec(struct timespec end, struct timespec beginning) {
     double x;
 
@@ -1404,7 +1707,27 @@ static double difftimespec(struct timespec end, struct timespec beginning) {
     return x;
 }
 
-static int send_tx_ack(uint8_t token_h, uint8_t token_l, enum jit_error_e error, int32_t error_value) {
+/* Check if the keep-alive interval of a server taking downlinks elapsed since its last PULL request */
+static bool pull_due(const struct timespec * now) {
+    int i;
+
+    for (i = 0; i < serv_nb; i++) {
+        if ((serv[i].downlink == true) && ((int)difftimespec(*now, serv[i].pull_time) >= serv[i].keepalive)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int compare_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/* Send a TX_ACK to the address the PULL_RESP came from */
+static int send_tx_ack(int sock, const struct sockaddr_in * to, uint8_t token_h, uint8_t token_l, enum jit_error_e error, int32_t error_value) {
     uint8_t buff_ack[ACK_BUFF_SIZE]; /* buffer to give feedback to server */
     int buff_index;
     int j;
@@ -1444,33 +1767,33 @@ static int send_tx_ack(uint8_t token_h, uint8_t token_l, enum jit_error_e error,
                 memcpy((void *)(buff_ack + buff_index), (void *)"\"COLLISION_PACKET\"", 18);
                 buff_index += 18;
                 /* update stats */
-                xSemaphoreTake(mx_meas_dw, portMAX_DELAY);
-                meas_nb_tx_rejected_collision_packet += 1;
-                xSemaphoreGive(mx_meas_dw);
+                stats_begin(&meas_dw.seq);
+                meas_dw.tx_rejected_collision_packet += 1;
+                stats_end(&meas_dw.seq);
                 break;
             case JIT_ERROR_TOO_LATE:
                 memcpy((void *)(buff_ack + buff_index), (void *)"\"TOO_LATE\"", 10);
                 buff_index += 10;
                 /* update stats */
-                xSemaphoreTake(mx_meas_dw, portMAX_DELAY);
-                meas_nb_tx_rejected_too_late += 1;
-                xSemaphoreGive(mx_meas_dw);
+                stats_begin(&meas_dw.seq);
+                meas_dw.tx_rejected_too_late += 1;
+                stats_end(&meas_dw.seq);
                 break;
             case JIT_ERROR_TOO_EARLY:
                 memcpy((void *)(buff_ack + buff_index), (void *)"\"TOO_EARLY\"", 11);
                 buff_index += 11;
                 /* update stats */
-                xSemaphoreTake(mx_meas_dw, portMAX_DELAY);
-                meas_nb_tx_rejected_too_early += 1;
-                xSemaphoreGive(mx_meas_dw);
+                stats_begin(&meas_dw.seq);
+                meas_dw.tx_rejected_too_early += 1;
+                stats_end(&meas_dw.seq);
                 break;
             case JIT_ERROR_COLLISION_BEACON:
                 memcpy((void *)(buff_ack + buff_index), (void *)"\"COLLISION_BEACON\"", 18);
                 buff_index += 18;
                 /* update stats */
-                xSemaphoreTake(mx_meas_dw, portMAX_DELAY);
-                meas_nb_tx_rejected_collision_beacon += 1;
-                xSemaphoreGive(mx_meas_dw);
+                stats_begin(&meas_dw.seq);
+                meas_dw.tx_rejected_collision_beacon += 1;
+                stats_end(&meas_dw.seq);
                 break;
             case JIT_ERROR_TX_FREQ:
                 memcpy((void *)(buff_ack + buff_index), (void *)"\"TX_FREQ\"", 9);
@@ -1512,27 +1835,7 @@ static int send_tx_ack(uint8_t token_h, uint8_t token_l, enum jit_error_e error,
     buff_ack[buff_index] = 0; /* add string terminator, for safety */
 
     /* send datagram to server */
-    //return send(sock_down, (void *)buff_ack, buff_index, 0);
-    return sendto(sock_down, (void *)buff_ack, buff_index, 0, (struct sockaddr *)&dest_addr, sizeof(dest_addr));
-}
-
-static int dns_loopup(char *hostname, char *ip)
-{
-    struct hostent *he;
-    struct in_addr **addrlist;
-
-    if((he = gethostbyname(hostname)) == NULL){
-        return -1;
-    }
-
-    addrlist = (struct in_addr **) he->h_addr_list;
-    for(int i=0; addrlist[i] != NULL; i++){
-        strncpy(ip, inet_ntoa(*addrlist[i]), IP_LEN);
-        ip[IP_LEN-1] = '\0'; // just to be safe
-        return 0;
-    }
-
-    return -1;
+    return sendto(sock, (void *)buff_ack, buff_index, 0, (const struct sockaddr *)to, sizeof *to);
 }
 
 int pkt_fwd_main(void)
@@ -1547,10 +1850,33 @@ int pkt_fwd_main(void)
     uint32_t cp_nb_rx_bad;
     uint32_t cp_nb_rx_nocrc;
     uint32_t cp_up_pkt_fwd;
+    uint32_t cp_up_filter_devaddr;
+    uint32_t cp_up_filter_joineui;
     uint32_t cp_up_network_byte;
     uint32_t cp_up_payload_byte;
     uint32_t cp_up_dgram_sent;
     uint32_t cp_up_ack_rcv;
+    uint32_t cp_up_fetch_nb;
+    uint32_t cp_up_fetch_empty;
+    uint32_t cp_up_latency[LATENCY_SAMPLES_NB];
+    uint32_t cp_up_latency_nb;
+    uint32_t cp_up_ack_timeout;
+    uint64_t cp_up_ack_rtt_sum;
+    uint32_t cp_up_ack_rtt_max;
+    uint32_t cp_up_cycle_nb;
+    uint64_t cp_up_cycle_sum;
+    uint32_t cp_up_cycle_max;
+    uint32_t cp_up_aggr_pkt;
+    uint64_t cp_up_aggr_delay_sum;
+    uint32_t cp_up_aggr_delay_max;
+    uint32_t cp_up_flush[UP_FLUSH_NB];
+    struct spool_s cp_spool;
+    uint32_t spool_nb, spool_bytes;
+    uint32_t pool_high_water;
+    uint32_t pool_nb_full;
+    uint32_t rx_resync_bytes;
+    uint32_t cp_serv_ack_rcv; /* other servers */
+    uint32_t cp_serv_pull_sent;
     uint32_t cp_dw_pull_sent;
     uint32_t cp_dw_ack_rcv;
     uint32_t cp_dw_dgram_rcv;
@@ -1558,14 +1884,25 @@ int pkt_fwd_main(void)
     uint32_t cp_dw_payload_byte;
     uint32_t cp_nb_tx_ok;
     uint32_t cp_nb_tx_fail;
-    uint32_t cp_nb_tx_requested = 0;
-    uint32_t cp_nb_tx_rejected_collision_packet = 0;
-    uint32_t cp_nb_tx_rejected_collision_beacon = 0;
-    uint32_t cp_nb_tx_rejected_too_late = 0;
-    uint32_t cp_nb_tx_rejected_too_early = 0;
-    uint32_t cp_nb_beacon_queued = 0;
-    uint32_t cp_nb_beacon_sent = 0;
-    uint32_t cp_nb_beacon_rejected = 0;
+    uint32_t cp_jit_dispatch_nb;
+    uint32_t cp_jit_jitter_sum;
+    uint32_t cp_jit_cnt_read;
+    uint32_t cp_nb_tx_requested;
+    uint32_t cp_nb_tx_rejected_collision_packet;
+    uint32_t cp_nb_tx_rejected_collision_beacon;
+    uint32_t cp_nb_tx_rejected_too_late;
+    uint32_t cp_nb_tx_rejected_too_early;
+    uint32_t cp_nb_beacon_queued;
+    uint32_t cp_nb_beacon_sent;
+    uint32_t cp_nb_beacon_rejected;
+    uint32_t cp_pkt_log[8];
+    uint32_t cp_pkt_sum;
+
+    /* copies of the measurement blocks, now and at the previous report */
+    static struct meas_up_s cp_meas_up, last_meas_up;
+    static struct meas_up_ack_s cp_meas_up_ack[SERV_MAX], last_meas_up_ack[SERV_MAX];
+    static struct meas_dw_s cp_meas_dw, last_meas_dw;
+    static struct meas_jit_s cp_meas_jit, last_meas_jit;
 
     /* GPS coordinates variables */
     bool coord_ok = false;
@@ -1592,14 +1929,16 @@ int pkt_fwd_main(void)
     assert(mx_xcorr);
     mx_timeref = xSemaphoreCreateMutex();
     assert(mx_timeref);
-    mx_meas_up = xSemaphoreCreateMutex();
-    assert(mx_meas_up);
-    mx_meas_dw = xSemaphoreCreateMutex();
-    assert(mx_meas_dw);
     mx_meas_gps = xSemaphoreCreateMutex();
     assert(mx_meas_gps);
+    mx_upfilter = xSemaphoreCreateMutex();
+    assert(mx_upfilter);
     mx_stat_rep = xSemaphoreCreateMutex();
     assert(mx_stat_rep);
+    mx_push_ack = xSemaphoreCreateMutex();
+    assert(mx_push_ack);
+    mx_spool = xSemaphoreCreateMutex();
+    assert(mx_spool);
 
 
     /* display version informations */
@@ -1670,6 +2009,13 @@ int pkt_fwd_main(void)
 
     free(conf_array);
 
+    /* from now on, messages are printed by the drain task */
+    if (trace_start(log_ring_size, LOG_DRAIN_PRIO) != 0) {
+        MSG("WARNING: [main] failed to start deferred logging, messages stay synchronous\n");
+    } else if (log_ring_size > 0) {
+        MSG("INFO: [main] deferred logging, %u bytes log ring\n", log_ring_size);
+    }
+
     // TODO
     /* Start GPS a.s.a.p., to allow it to lock */
     gps_enabled = false;
@@ -1721,28 +2067,37 @@ int pkt_fwd_main(void)
     net_mac_l = htonl((uint32_t)(0xFFFFFFFF &  lgwm  ));
 
     // -------------------------------
-    int addr_family = 0;
-    int ip_protocol = 0;
-    char ip[IP_LEN] = { 0 };
-
-    addr_family = AF_INET;
-    ip_protocol = IPPROTO_IP;
-    sock_up = socket(addr_family, SOCK_DGRAM, ip_protocol);
-    if (sock_up < 0) {
-        ESP_LOGE(PKT_TAG, "Unable to create up socket: errno %d", errno);
+    /* network server, both ways on the port of the configuration */
+    strncpy(serv[0].addr, udp_host, sizeof serv[0].addr);
+    serv[0].addr[sizeof serv[0].addr - 1] = '\0'; /* ensure string termination */
+    serv[0].port_up = (uint16_t)udp_port;
+    serv[0].port_down = (uint16_t)udp_port;
+    serv[0].downlink = true;
+    serv[0].keepalive = keepalive_time;
+    i = serv_open(&serv[0]);
+    if (i == -1) {
+        ESP_LOGE(PKT_TAG, "Unable to create sockets: errno %d", errno);
         return -1;
     }
-    sock_down = socket(addr_family, SOCK_DGRAM, ip_protocol);
-    if (sock_down < 0) {
-        ESP_LOGE(PKT_TAG, "Unable to create down socket: errno %d", errno);
-        return -1;
+    if (i != 0) {
+        MSG("WARNING: [main] unable to resolve %s, retried every %u s, nothing is sent to it until then\n", udp_host, stat_interval);
     }
     ESP_LOGI(PKT_TAG, "Socket created, sending to %s:%d", udp_host, udp_port);
 
-    dns_loopup(udp_host, ip);
-    dest_addr.sin_addr.s_addr = inet_addr(ip);
-    dest_addr.sin_family = AF_INET;
-    dest_addr.sin_port = htons(udp_port);
+    /* other servers, the ones without sockets are left out, the ones not resolved are retried */
+    for (i = 1, l = 1; i < serv_nb; i++) {
+        x = serv_open(&serv[i]);
+        if (x == -1) {
+            MSG("WARNING: [main] unable to create the sockets of %s, no uplink is sent to it\n", serv[i].addr);
+            continue;
+        }
+        if (x != 0) {
+            MSG("WARNING: [main] unable to resolve %s, retried every %u s, nothing is sent to it until then\n", serv[i].addr, stat_interval);
+        }
+        MSG("INFO: [main] uplinks also sent to %s:%u%s\n", serv[i].addr, serv[i].port_up, (serv[i].downlink == true) ? ", downlinks accepted" : "");
+        serv[l++] = serv[i];
+    }
+    serv_nb = l;
 
     Init_Led(); // Initialize LED
 
@@ -1768,24 +2123,11 @@ int pkt_fwd_main(void)
     freeaddrinfo(result);
 #endif
 
-    /* set upstream socket RX timeout */
-    i = setsockopt(sock_up, SOL_SOCKET, SO_RCVTIMEO, (void *)&push_timeout_half, sizeof push_timeout_half);
-    if (i != 0) {
-        MSG("ERROR: [up] setsockopt returned %s\n", strerror(errno));
-        exit(EXIT_FAILURE);
-    }
-
     if (com_type == LGW_COM_SPI) {
         /* Board reset */
         lgw_reset();
     }
 
-    for (l = 0; l < LGW_IF_CHAIN_NB; l++) {
-        for (m = 0; m < 8; m++) {
-            nb_pkt_log[l][m] = 0;
-        }
-    }
-
     /* starting the concentrator */
     i = lgw_start();
     if (i == LGW_HAL_SUCCESS) {
@@ -1812,6 +2154,22 @@ int pkt_fwd_main(void)
         printf( "led_flash spawned\n" );
     }
 
+    /* spool for the packets received while the server does not answer, in PSRAM if any */
+    if (spool_ram_size > 0) {
+        uint8_t * spool_ram = heap_caps_malloc(spool_ram_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (spool_ram == NULL) {
+            spool_ram = heap_caps_malloc(spool_ram_size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        }
+        if (spool_ram == NULL) {
+            MSG("WARNING: [main] failed to allocate %u bytes for the spool, packets will not be spooled\n", spool_ram_size);
+        } else {
+            if (spool_init(&spool, spool_ram, spool_ram_size, spool_file_path, spool_file_size, spool_drop_policy, spool_outage_nb, spool_replay_rate, SPOOL_PROBE_MS) != 0) {
+                MSG("WARNING: [main] failed to create spool file %s, spooling in RAM only\n", spool_file_path);
+            }
+            spool_enabled = true;
+        }
+    }
+
     /* JIT queue initialization */
     jit_queue_init(&jit_queue[0]);
     jit_queue_init(&jit_queue[1]);
@@ -1823,13 +2181,19 @@ int pkt_fwd_main(void)
         printf( "Thread_up spawned\n" );
     }
 
+    if( xTaskCreatePinnedToCore(((TaskFunction_t) thread_up_ack), "thread_up_ack", 4096, NULL, 6, NULL, tskNO_AFFINITY) == errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY) {
+        printf( "Failed to spawn thread_up_ack\n");
+    } else {
+        printf( "Thread_up_ack spawned\n" );
+    }
+
     if( xTaskCreatePinnedToCore(((TaskFunction_t) thread_down), "thread_down", 4096*2, NULL, 6, NULL, tskNO_AFFINITY) == errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY) {
         printf( "Failed to spawn thread_down\n");
     } else {
         printf( "Thread_down spawned\n" );
     }
 
-    if( xTaskCreatePinnedToCore(((TaskFunction_t) thread_jit), "thread_jit", 4096*2, (void *)pJit, 6, NULL, tskNO_AFFINITY) == errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY) {
+    if( xTaskCreatePinnedToCore(((TaskFunction_t) thread_jit), "thread_jit", 4096*2, NULL, 6, &pJit, tskNO_AFFINITY) == errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY) {
         printf( "Failed to spawn thread_jit\n");
     } else {
         printf( "Thread_jit spawned\n" );
@@ -1864,6 +2228,13 @@ int pkt_fwd_main(void)
 
     /* main loop task: statistics collection */
     while (!exit_sig && !quit_sig) {
+        /* retry the servers whose address could not be resolved, once per interval as it may block a while */
+        for (l = 0; l < serv_nb; l++) {
+            if ((serv_is_resolved(&serv[l]) == false) && (serv_resolve(&serv[l]) == 0)) {
+                MSG("INFO: [main] %s resolved, datagrams are sent to it\n", serv[l].addr);
+            }
+        }
+
         time_count = 0;
         while(time_count < stat_interval) {
             /* wait for next reporting interval */
@@ -1892,27 +2263,44 @@ int pkt_fwd_main(void)
         }
         strftime(stat_timestamp, sizeof stat_timestamp, "%F %T %Z", gmtime(&t));
 
-        /* access upstream statistics, copy and reset them */
-        xSemaphoreTake(mx_meas_up, portMAX_DELAY);
-        cp_nb_rx_rcv       = meas_nb_rx_rcv;
-        cp_nb_rx_ok        = meas_nb_rx_ok;
-        cp_nb_rx_bad       = meas_nb_rx_bad;
-        cp_nb_rx_nocrc     = meas_nb_rx_nocrc;
-        cp_up_pkt_fwd      = meas_up_pkt_fwd;
-        cp_up_network_byte = meas_up_network_byte;
-        cp_up_payload_byte = meas_up_payload_byte;
-        cp_up_dgram_sent   = meas_up_dgram_sent;
-        cp_up_ack_rcv      = meas_up_ack_rcv;
-        meas_nb_rx_rcv = 0;
-        meas_nb_rx_ok = 0;
-        meas_nb_rx_bad = 0;
-        meas_nb_rx_nocrc = 0;
-        meas_up_pkt_fwd = 0;
-        meas_up_network_byte = 0;
-        meas_up_payload_byte = 0;
-        meas_up_dgram_sent = 0;
-        meas_up_ack_rcv = 0;
-        xSemaphoreGive(mx_meas_up);
+        /* access upstream statistics, copy them and keep what changed since the previous report */
+        stats_read(&meas_up, &cp_meas_up, sizeof cp_meas_up);
+        for (l = 0; l < serv_nb; l++) {
+            stats_read(&meas_up_ack[l], &cp_meas_up_ack[l], sizeof cp_meas_up_ack[l]);
+        }
+        cp_nb_rx_rcv       = cp_meas_up.rx_rcv - last_meas_up.rx_rcv;
+        cp_nb_rx_ok        = cp_meas_up.rx_ok - last_meas_up.rx_ok;
+        cp_nb_rx_bad       = cp_meas_up.rx_bad - last_meas_up.rx_bad;
+        cp_nb_rx_nocrc     = cp_meas_up.rx_nocrc - last_meas_up.rx_nocrc;
+        cp_up_pkt_fwd      = cp_meas_up.pkt_fwd - last_meas_up.pkt_fwd;
+        cp_up_filter_devaddr = cp_meas_up.filter_devaddr - last_meas_up.filter_devaddr;
+        cp_up_filter_joineui = cp_meas_up.filter_joineui - last_meas_up.filter_joineui;
+        cp_up_network_byte = cp_meas_up.network_byte - last_meas_up.network_byte;
+        cp_up_payload_byte = cp_meas_up.payload_byte - last_meas_up.payload_byte;
+        cp_up_dgram_sent   = cp_meas_up.dgram_sent - last_meas_up.dgram_sent;
+        cp_up_ack_rcv      = cp_meas_up_ack[0].ack_rcv - last_meas_up_ack[0].ack_rcv; /* network server, the others are reported apart */
+        cp_up_fetch_nb     = cp_meas_up.fetch_nb - last_meas_up.fetch_nb;
+        cp_up_fetch_empty  = cp_meas_up.fetch_empty - last_meas_up.fetch_empty;
+        cp_up_latency_nb   = cp_meas_up.latency_nb - last_meas_up.latency_nb;
+        if (cp_up_latency_nb > LATENCY_SAMPLES_NB) {
+            cp_up_latency_nb = LATENCY_SAMPLES_NB;
+        }
+        for (l = 0; l < (int)cp_up_latency_nb; l++) {
+            cp_up_latency[l] = cp_meas_up.latency[(cp_meas_up.latency_nb - 1 - l) % LATENCY_SAMPLES_NB];
+        }
+        cp_up_ack_timeout  = (cp_meas_up_ack[0].ack_timeout - last_meas_up_ack[0].ack_timeout) + (cp_meas_up.ack_evicted[0] - last_meas_up.ack_evicted[0]);
+        cp_up_ack_rtt_sum  = cp_meas_up_ack[0].ack_rtt_sum - last_meas_up_ack[0].ack_rtt_sum;
+        cp_up_ack_rtt_max  = stats_max_get(&cp_meas_up_ack[0].ack_rtt_max);
+        cp_up_cycle_nb     = cp_meas_up.cycle_nb - last_meas_up.cycle_nb;
+        cp_up_cycle_sum    = cp_meas_up.cycle_sum - last_meas_up.cycle_sum;
+        cp_up_cycle_max    = stats_max_get(&cp_meas_up.cycle_max);
+        cp_up_aggr_pkt     = cp_meas_up.aggr_pkt - last_meas_up.aggr_pkt;
+        cp_up_aggr_delay_sum = cp_meas_up.aggr_delay_sum - last_meas_up.aggr_delay_sum;
+        cp_up_aggr_delay_max = stats_max_get(&cp_meas_up.aggr_delay_max);
+        for (l = 0; l < UP_FLUSH_NB; l++) {
+            cp_up_flush[l] = cp_meas_up.flush[l] - last_meas_up.flush[l];
+        }
+        qsort(cp_up_latency, cp_up_latency_nb, sizeof cp_up_latency[0], compare_u32);
         if (cp_nb_rx_rcv > 0) {
             rx_ok_ratio = (float)cp_nb_rx_ok / (float)cp_nb_rx_rcv;
             rx_bad_ratio = (float)cp_nb_rx_bad / (float)cp_nb_rx_rcv;
@@ -1928,39 +2316,29 @@ int pkt_fwd_main(void)
             up_ack_ratio = 0.0;
         }
 
-        /* access downstream statistics, copy and reset them */
-        xSemaphoreTake(mx_meas_dw, portMAX_DELAY);
-        cp_dw_pull_sent    =  meas_dw_pull_sent;
-        cp_dw_ack_rcv      =  meas_dw_ack_rcv;
-        cp_dw_dgram_rcv    =  meas_dw_dgram_rcv;
-        cp_dw_network_byte =  meas_dw_network_byte;
-        cp_dw_payload_byte =  meas_dw_payload_byte;
-        cp_nb_tx_ok        =  meas_nb_tx_ok;
-        cp_nb_tx_fail      =  meas_nb_tx_fail;
-        cp_nb_tx_requested                 +=  meas_nb_tx_requested;
-        cp_nb_tx_rejected_collision_packet +=  meas_nb_tx_rejected_collision_packet;
-        cp_nb_tx_rejected_collision_beacon +=  meas_nb_tx_rejected_collision_beacon;
-        cp_nb_tx_rejected_too_late         +=  meas_nb_tx_rejected_too_late;
-        cp_nb_tx_rejected_too_early        +=  meas_nb_tx_rejected_too_early;
-        cp_nb_beacon_queued   +=  meas_nb_beacon_queued;
-        cp_nb_beacon_sent     +=  meas_nb_beacon_sent;
-        cp_nb_beacon_rejected +=  meas_nb_beacon_rejected;
-        meas_dw_pull_sent = 0;
-        meas_dw_ack_rcv = 0;
-        meas_dw_dgram_rcv = 0;
-        meas_dw_network_byte = 0;
-        meas_dw_payload_byte = 0;
-        meas_nb_tx_ok = 0;
-        meas_nb_tx_fail = 0;
-        meas_nb_tx_requested = 0;
-        meas_nb_tx_rejected_collision_packet = 0;
-        meas_nb_tx_rejected_collision_beacon = 0;
-        meas_nb_tx_rejected_too_late = 0;
-        meas_nb_tx_rejected_too_early = 0;
-        meas_nb_beacon_queued = 0;
-        meas_nb_beacon_sent = 0;
-        meas_nb_beacon_rejected = 0;
-        xSemaphoreGive(mx_meas_dw);
+        /* access downstream statistics, copy them and keep what changed since the previous report */
+        stats_read(&meas_dw, &cp_meas_dw, sizeof cp_meas_dw);
+        stats_read(&meas_jit, &cp_meas_jit, sizeof cp_meas_jit);
+        cp_dw_pull_sent    =  cp_meas_dw.pull_sent[0] - last_meas_dw.pull_sent[0];
+        cp_dw_ack_rcv      =  cp_meas_dw.ack_rcv[0] - last_meas_dw.ack_rcv[0];
+        cp_dw_dgram_rcv    =  cp_meas_dw.dgram_rcv - last_meas_dw.dgram_rcv;
+        cp_dw_network_byte =  cp_meas_dw.network_byte - last_meas_dw.network_byte;
+        cp_dw_payload_byte =  cp_meas_dw.payload_byte - last_meas_dw.payload_byte;
+        cp_nb_tx_ok        =  cp_meas_jit.tx_ok - last_meas_jit.tx_ok;
+        cp_nb_tx_fail      =  cp_meas_jit.tx_fail - last_meas_jit.tx_fail;
+        cp_jit_dispatch_nb =  cp_meas_jit.dispatch_nb - last_meas_jit.dispatch_nb;
+        cp_jit_jitter_sum  =  cp_meas_jit.jitter_sum - last_meas_jit.jitter_sum;
+        cp_jit_cnt_read    =  cp_meas_jit.cnt_read - last_meas_jit.cnt_read;
+        /* TX requests, rejections and beacons are reported since start */
+        cp_nb_tx_requested                 =  cp_meas_dw.tx_requested;
+        cp_nb_tx_rejected_collision_packet =  cp_meas_dw.tx_rejected_collision_packet;
+        cp_nb_tx_rejected_collision_beacon =  cp_meas_dw.tx_rejected_collision_beacon;
+        cp_nb_tx_rejected_too_late         =  cp_meas_dw.tx_rejected_too_late;
+        cp_nb_tx_rejected_too_early        =  cp_meas_dw.tx_rejected_too_early;
+        cp_nb_beacon_queued   =  cp_meas_dw.beacon_queued;
+        cp_nb_beacon_sent     =  cp_meas_jit.beacon_sent;
+        cp_nb_beacon_rejected =  cp_meas_dw.beacon_rejected;
+        stats_new_epoch(); /* maximums restart for the next report */
         if (cp_dw_pull_sent > 0) {
             dw_ack_ratio = (float)cp_dw_ack_rcv / (float)cp_dw_pull_sent;
         } else {
@@ -1986,13 +2364,93 @@ int pkt_fwd_main(void)
         printf("# RF packets received by concentrator: %u\n", cp_nb_rx_rcv);
         printf("# CRC_OK: %.2f%%, CRC_FAIL: %.2f%%, NO_CRC: %.2f%%\n", 100.0 * rx_ok_ratio, 100.0 * rx_bad_ratio, 100.0 * rx_nocrc_ratio);
         printf("# RF packets forwarded: %u (%u bytes)\n", cp_up_pkt_fwd, cp_up_payload_byte);
+        if ((cp_up_filter_devaddr + cp_up_filter_joineui) > 0) {
+            printf("# RF packets dropped by the uplink filter: %u on DevAddr, %u on JoinEUI\n", cp_up_filter_devaddr, cp_up_filter_joineui);
+        }
+        for (l = 0; l < LGW_IF_CHAIN_NB; l++) {
+            cp_pkt_sum = 0;
+            for (m = 0; m < 8; m++) {
+                cp_pkt_log[m] = cp_meas_up.pkt_log[l][m] - last_meas_up.pkt_log[l][m];
+                cp_pkt_sum += cp_pkt_log[m];
+            }
+            if (cp_pkt_sum == 0) {
+                continue;
+            }
+            if (l == (LGW_IF_CHAIN_NB - 1)) {
+                printf("#   FSK: %u\n", cp_pkt_log[0]);
+            } else {
+                printf("#   CH%d SF5..SF12: %u %u %u %u %u %u %u %u\n", l, cp_pkt_log[0], cp_pkt_log[1], cp_pkt_log[2], cp_pkt_log[3],
+                        cp_pkt_log[4], cp_pkt_log[5], cp_pkt_log[6], cp_pkt_log[7]);
+            }
+        }
         printf("# PUSH_DATA datagrams sent: %u (%u bytes)\n", cp_up_dgram_sent, cp_up_network_byte);
-        printf("# PUSH_DATA acknowledged: %.2f%%\n", 100.0 * up_ack_ratio);
+        printf("# PUSH_DATA acknowledged: %.2f%% (%s)\n", 100.0 * up_ack_ratio, (push_binary == true) ? "binary" : "JSON");
+        if (cp_up_dgram_sent > 0) {
+            printf("# PUSH_DATA aggregation: %.2f datagrams/s, %.2f packets/datagram, sent on latency %u, size %u, urgent %u, report %u, replay %u\n",
+                    (float)cp_up_dgram_sent / stat_interval, (float)cp_up_aggr_pkt / cp_up_dgram_sent,
+                    cp_up_flush[UP_FLUSH_DEADLINE], cp_up_flush[UP_FLUSH_SIZE], cp_up_flush[UP_FLUSH_URGENT], cp_up_flush[UP_FLUSH_REPORT], cp_up_flush[UP_FLUSH_REPLAY]);
+        }
+        if (cp_up_aggr_pkt > 0) {
+            printf("# Aggregation delay, fetch to PUSH_DATA (ms): avg %.1f, max %.1f\n",
+                    (double)cp_up_aggr_delay_sum / cp_up_aggr_pkt / 1000.0, cp_up_aggr_delay_max / 1000.0);
+        }
+        if (cp_up_ack_rcv > 0) {
+            printf("# PUSH_ACK round trip (ms): avg %.1f, max %.1f, %u not acknowledged in time\n",
+                    (double)cp_up_ack_rtt_sum / cp_up_ack_rcv / 1000.0, cp_up_ack_rtt_max / 1000.0, cp_up_ack_timeout);
+        } else {
+            printf("# PUSH_ACK round trip (ms): no ack, %u not acknowledged in time\n", cp_up_ack_timeout);
+        }
+        for (l = 1; l < serv_nb; l++) {
+            cp_serv_ack_rcv = cp_meas_up_ack[l].ack_rcv - last_meas_up_ack[l].ack_rcv;
+            printf("# Server %s: PUSH_DATA acknowledged %.2f%%, round trip (ms) avg %.1f, max %.1f, %u not acknowledged in time\n", serv[l].addr,
+                    (cp_up_dgram_sent > 0) ? (100.0 * cp_serv_ack_rcv / cp_up_dgram_sent) : 0.0,
+                    (cp_serv_ack_rcv > 0) ? ((double)(cp_meas_up_ack[l].ack_rtt_sum - last_meas_up_ack[l].ack_rtt_sum) / cp_serv_ack_rcv / 1000.0) : 0.0,
+                    (cp_serv_ack_rcv > 0) ? (stats_max_get(&cp_meas_up_ack[l].ack_rtt_max) / 1000.0) : 0.0,
+                    (cp_meas_up_ack[l].ack_timeout - last_meas_up_ack[l].ack_timeout) + (cp_meas_up.ack_evicted[l] - last_meas_up.ack_evicted[l]));
+        }
+        if (cp_up_cycle_nb > 0) {
+            printf("# Uplink cycle, fetch to next fetch (ms): avg %.1f, max %.1f\n",
+                    (double)cp_up_cycle_sum / cp_up_cycle_nb / 1000.0, cp_up_cycle_max / 1000.0);
+        }
+        printf("# RX fetch (%s): %.1f fetches/s, %.1f empty/s\n", lgw_gpio_rx_irq_enabled() ? "interrupt" : "polling",
+                (float)cp_up_fetch_nb / stat_interval, (float)cp_up_fetch_empty / stat_interval);
+        if (cp_up_latency_nb > 0) {
+            printf("# RX latency (us): p50 %u, p90 %u, p99 %u, max %u\n",
+                    cp_up_latency[cp_up_latency_nb * 50 / 100], cp_up_latency[cp_up_latency_nb * 90 / 100],
+                    cp_up_latency[cp_up_latency_nb * 99 / 100], cp_up_latency[cp_up_latency_nb - 1]);
+        }
+        if (spool_enabled == true) {
+            xSemaphoreTake(mx_spool, portMAX_DELAY);
+            cp_spool = spool;
+            xSemaphoreGive(mx_spool);
+            spool_usage(&cp_spool, &spool_nb, &spool_bytes);
+            printf("# Spool (server %s): %u packets, %u bytes (max %u); since start %u spooled, %u replayed, %u dropped, %u lost on file errors\n",
+                    (cp_spool.link_lost == true) ? "lost" : "up", spool_nb, spool_bytes, cp_spool.high_water,
+                    cp_spool.nb_in, cp_spool.nb_out, cp_spool.nb_drop, cp_spool.nb_error);
+        }
+        rxpool_stats(NULL, &pool_high_water, &pool_nb_full);
+        printf("# RX payload pool: %u/%u bytes at most, %u packets deferred (pool full)\n", pool_high_water, RX_POOL_SIZE, pool_nb_full);
+        if ((lgw_get_rx_resync_bytes(&rx_resync_bytes) == LGW_HAL_SUCCESS) && (rx_resync_bytes > 0)) {
+            printf("# RX buffer: %u bytes dropped to re-sync on a packet syncword since start\n", rx_resync_bytes);
+        }
         printf("### [DOWNSTREAM] ###\n");
         printf("# PULL_DATA sent: %u (%.2f%% acknowledged)\n", cp_dw_pull_sent, 100.0 * dw_ack_ratio);
+        for (l = 1; l < serv_nb; l++) {
+            if (serv[l].downlink == true) {
+                cp_serv_pull_sent = cp_meas_dw.pull_sent[l] - last_meas_dw.pull_sent[l];
+                printf("# Server %s: PULL_DATA sent: %u (%.2f%% acknowledged)\n", serv[l].addr, cp_serv_pull_sent,
+                        (cp_serv_pull_sent > 0) ? (100.0 * (cp_meas_dw.ack_rcv[l] - last_meas_dw.ack_rcv[l]) / cp_serv_pull_sent) : 0.0);
+            }
+        }
         printf("# PULL_RESP(onse) datagrams received: %u (%u bytes)\n", cp_dw_dgram_rcv, cp_dw_network_byte);
+        if (cp_meas_dw.dgram_rejected > 0) {
+            printf("# Datagrams rejected, not from the server they were received for: %u since start\n", cp_meas_dw.dgram_rejected);
+        }
         printf("# RF packets sent to concentrator: %u (%u bytes)\n", (cp_nb_tx_ok+cp_nb_tx_fail), cp_dw_payload_byte);
         printf("# TX errors: %u\n", cp_nb_tx_fail);
+        printf("# TX dispatch: %u packets, lead time error avg %.2f ms, max %.2f ms, %u counter reads\n", cp_jit_dispatch_nb,
+                (cp_jit_dispatch_nb > 0) ? ((double)cp_jit_jitter_sum / cp_jit_dispatch_nb / 1000.0) : 0.0,
+                stats_max_get(&cp_meas_jit.jitter_max) / 1000.0, cp_jit_cnt_read);
         if (cp_nb_tx_requested != 0 ) {
             printf("# TX rejected (collision packet): %.2f%% (req:%u, rej:%u)\n", 100.0 * cp_nb_tx_rejected_collision_packet / cp_nb_tx_requested, cp_nb_tx_requested, cp_nb_tx_rejected_collision_packet);
             printf("# TX rejected (collision beacon): %.2f%% (req:%u, rej:%u)\n", 100.0 * cp_nb_tx_rejected_collision_beacon / cp_nb_tx_requested, cp_nb_tx_requested, cp_nb_tx_rejected_collision_beacon);
@@ -2036,9 +2494,13 @@ int pkt_fwd_main(void)
         } else {
             printf("# GPS sync is disabled\n");
         }
-        xSemaphoreTake(mx_concent, portMAX_DELAY);
-        i = lgw_get_temperature(&temperature);
-        xSemaphoreGive(mx_concent);
+        /* same sample as the RSSI compensation, the sensor is only read here when the sampler is not running */
+        i = lgw_get_temperature_cached(&temperature, NULL);
+        if (i != LGW_HAL_SUCCESS) {
+            xSemaphoreTake(mx_concent, portMAX_DELAY);
+            i = lgw_get_temperature(&temperature);
+            xSemaphoreGive(mx_concent);
+        }
         if (i != LGW_HAL_SUCCESS) {
             printf("### Concentrator temperature unknown ###\n");
         } else {
@@ -2050,6 +2512,12 @@ int pkt_fwd_main(void)
         }
         printf("##### END #####\n");
 
+        /* the next report starts from these copies */
+        last_meas_up = cp_meas_up;
+        memcpy(last_meas_up_ack, cp_meas_up_ack, sizeof last_meas_up_ack);
+        last_meas_dw = cp_meas_dw;
+        last_meas_jit = cp_meas_jit;
+
         /* generate a JSON report (will be sent to server by upstream thread) */
         xSemaphoreTake(mx_stat_rep, portMAX_DELAY);
         if (((gps_enabled == true) && (coord_ok == true)) || (gps_fake_enable == true)) {
@@ -2057,6 +2525,18 @@ int pkt_fwd_main(void)
         } else {
             snprintf(status_report, STATUS_SIZE, "\"stat\":{\"time\":\"%s\",\"rxnb\":%u,\"rxok\":%u,\"rxfw\":%u,\"ackr\":%.1f,\"dwnb\":%u,\"txnb\":%u,\"temp\":%.1f}", stat_timestamp, cp_nb_rx_rcv, cp_nb_rx_ok, cp_up_pkt_fwd, 100.0 * up_ack_ratio, cp_dw_dgram_rcv, cp_nb_tx_ok, temperature);
         }
+        status_report_bin.coord = ((gps_enabled == true) && (coord_ok == true)) || (gps_fake_enable == true);
+        status_report_bin.time = (uint32_t)t;
+        status_report_bin.lati = cp_gps_coord.lat;
+        status_report_bin.longi = cp_gps_coord.lon;
+        status_report_bin.alti = cp_gps_coord.alt;
+        status_report_bin.rxnb = cp_nb_rx_rcv;
+        status_report_bin.rxok = cp_nb_rx_ok;
+        status_report_bin.rxfw = cp_up_pkt_fwd;
+        status_report_bin.ackr = 100.0 * up_ack_ratio;
+        status_report_bin.dwnb = cp_dw_dgram_rcv;
+        status_report_bin.txnb = cp_nb_tx_ok;
+        status_report_bin.temp = temperature;
         report_ready = true;
         xSemaphoreGive(mx_stat_rep);
     }
@@ -2097,8 +2577,9 @@ int pkt_fwd_main(void)
     /* if an exit signal was received, try to quit properly */
     if (exit_sig) {
         /* shut down network sockets */
-        shutdown(sock_up, SHUT_RDWR);
-        shutdown(sock_down, SHUT_RDWR);
+        for (l = 0; l < serv_nb; l++) {
+            serv_close(&serv[l]);
+        }
         /* stop the hardware */
         i = lgw_stop();
         if (i == LGW_HAL_SUCCESS) {
@@ -2121,39 +2602,252 @@ int pkt_fwd_main(void)
 
 /* --- THREAD 1: RECEIVING PACKETS AND FORWARDING THEM ---------------------- */
 uint8_t buff_up[TX_BUFF_SIZE]; /* buffer to compose the upstream packet */
-struct lgw_pkt_rx_s rxpkt[NB_PKT_MAX]; /* array containing inbound packets + metadata */
+static uint8_t buff_rxpk[RXPK_BUFF_SIZE]; /* one serialized packet, before it is added to buff_up */
+struct lgw_pkt_rx_desc_s rxpkt[NB_PKT_MAX]; /* array containing inbound packets metadata, payloads being in the HAL RX pool */
+
+/* Start a PUSH_DATA in buff_up: header, its token being set per server when it is sent, then the start of the payload */
+static void up_dgram_open(up_dgram_t * d, bool binary)
+{
+    d->index = 12; /* 12-byte header */
+    if (binary == true) {
+        /* start of binary payload, its header is filled when the datagram is sent */
+        buff_up[0] = PROTOCOL_VERSION_BINARY;
+        d->index += PUSH_BIN_BODY_HEADER;
+    } else {
+        /* start of JSON structure */
+        buff_up[0] = PROTOCOL_VERSION;
+        memcpy((void *)(buff_up + d->index), (void *)"{\"rxpk\":[", 9);
+        d->index += 9;
+    }
+    d->open = true;
+    d->binary = binary;
+    d->nb_pkt = 0;
+    d->deadline = 0;
+    d->first_fetch = 0;
+    d->fetch_sum = 0;
+}
+
+/* Check if a serialized packet of len bytes can be added without going over aggr_max_bytes */
+static bool up_dgram_fits(const up_dgram_t * d, int len)
+{
+    if (d->nb_pkt == 0) {
+        return true; /* a packet is always sent, even alone over the budget */
+    }
+    if (d->binary == true) {
+        return (d->nb_pkt < 255) && ((d->index + len) <= aggr_max_bytes);
+    } else {
+        return (d->index + 1 + len + 2) <= aggr_max_bytes; /* with its separator and "]}" */
+    }
+}
+
+/* Add a packet serialized in the datagram format, fetched at fetch_time */
+static void up_dgram_append(up_dgram_t * d, const uint8_t * rxpk, int len, int64_t fetch_time)
+{
+    if ((d->binary == false) && (d->nb_pkt > 0)) {
+        buff_up[d->index] = ',';
+        d->index += 1;
+    }
+    memcpy(buff_up + d->index, rxpk, len);
+    d->index += len;
+    if (d->nb_pkt == 0) {
+        d->first_fetch = fetch_time;
+        d->deadline = fetch_time + (int64_t)aggr_max_latency_ms * 1000;
+    }
+    d->nb_pkt += 1;
+    d->fetch_sum += fetch_time;
+}
+
+/* Complete the datagram with the status report if one is ready and fits, and send it to every server */
+static void up_dgram_send(up_dgram_t * d, int reason)
+{
+    bool report = false;
+    bool evicted[SERV_MAX];
+    uint16_t token;
+    int i, j;
+    int64_t now;
+    uint32_t delay;
+    int sent_nb = 0;
+
+    xSemaphoreTake(mx_stat_rep, portMAX_DELAY);
+    if (report_ready == true) {
+        j = (d->binary == true) ? PUSH_BIN_STAT_MAX : (STATUS_SIZE + 2);
+        report = (d->nb_pkt == 0) || ((d->index + j) <= aggr_max_bytes);
+    }
+    if ((report == false) && (d->nb_pkt == 0)) {
+        /* nothing to send */
+        xSemaphoreGive(mx_stat_rep);
+        d->open = false;
+        return;
+    }
+    if (d->binary == true) {
+        buff_up[12] = (uint8_t)d->nb_pkt;
+        buff_up[13] = (report == true) ? 1 : 0;
+        if (report == true) {
+            report_ready = false;
+            d->index += push_bin_write_stat(&status_report_bin, buff_up + d->index, TX_BUFF_SIZE - d->index);
+        }
+    } else {
+        if (d->nb_pkt == 0) {
+            /* need to clean up the beginning of the payload */
+            d->index -= 8; /* removes "rxpk":[ */
+        } else {
+            /* end of packet array */
+            buff_up[d->index] = ']';
+            d->index += 1;
+            /* add separator if needed */
+            if (report == true) {
+                buff_up[d->index] = ',';
+                d->index += 1;
+            }
+        }
+        if (report == true) {
+            report_ready = false;
+            j = snprintf((char *)(buff_up + d->index), TX_BUFF_SIZE - d->index, "%s", status_report);
+            if (j > 0) {
+                d->index += j;
+            } else {
+                MSG("ERROR: [up] snprintf failed line %u\n", (__LINE__ - 4));
+                exit(EXIT_FAILURE);
+            }
+        }
+        /* end of JSON datagram payload */
+        buff_up[d->index] = '}';
+        d->index += 1;
+        buff_up[d->index] = 0; /* add string terminator, for safety */
+    }
+    xSemaphoreGive(mx_stat_rep);
+
+    if (d->binary == true) {
+        trace_printf(TRACE_LVL_INFO, TRACE_MOD_UP, "\nBinary up: %u packets%s, %d bytes\n", d->nb_pkt, (report == true) ? " + status" : "", d->index - 12);
+    } else {
+        trace_bin(TRACE_LVL_INFO, TRACE_MOD_UP, "\nJSON up: ", buff_up + 12, d->index - 12, TRACE_BIN_TEXT); /* DEBUG: display JSON payload */
+    }
+
+    /* send the same datagram to each server with a token of its own, registered first as the PUSH_ACK is matched by thread_up_ack */
+    /* the spool follows the network server, only its copy of a replay is tracked as such */
+    now = esp_timer_get_time();
+    for (i = 0; i < serv_nb; i++) {
+        token = serv_push_token(&serv[i], buff_up);
+        xSemaphoreTake(mx_push_ack, portMAX_DELAY);
+        evicted[i] = serv_push_register(&serv[i], token, (i == 0) && (reason == UP_FLUSH_REPLAY), now);
+        xSemaphoreGive(mx_push_ack);
+        if (serv_is_resolved(&serv[i]) == false) {
+            continue; /* expires, as when the server does not answer */
+        }
+        sendto(serv[i].sock_up, (void *)buff_up, d->index, 0, (struct sockaddr *)&serv[i].dest_up, sizeof serv[i].dest_up);
+        sent_nb += 1;
+    }
+    stats_begin(&meas_up.seq);
+    meas_up.dgram_sent += 1;
+    meas_up.network_byte += d->index * sent_nb;
+    for (i = 0; i < serv_nb; i++) {
+        if (evicted[i] == true) {
+            meas_up.ack_evicted[i] += 1;
+        }
+    }
+    meas_up.flush[reason] += 1;
+    if ((d->nb_pkt > 0) && (reason != UP_FLUSH_REPLAY)) {
+        meas_up.aggr_pkt += d->nb_pkt;
+        meas_up.aggr_delay_sum += (uint64_t)(d->nb_pkt * now - d->fetch_sum);
+        delay = (uint32_t)(now - d->first_fetch);
+        stats_max(&meas_up.aggr_delay_max, delay);
+    }
+    stats_end(&meas_up.seq);
+    d->open = false;
+}
+
+/* Send the oldest spooled packets if the replay rate allows it, a single one while the server does not answer */
+static void up_spool_replay(up_dgram_t * d)
+{
+    uint8_t flags;
+    int len;
+    bool probe;
+    int64_t now;
+
+    if ((spool_enabled == false) || (d->open == true)) {
+        return; /* buff_up is busy */
+    }
+    now = esp_timer_get_time();
+    xSemaphoreTake(mx_spool, portMAX_DELAY);
+    if (spool_replay_due(&spool, now) == true) {
+        probe = spool.link_lost;
+        while ((len = spool_next(&spool, &flags)) > 0) {
+            if (d->open == false) {
+                up_dgram_open(d, (flags & SPOOL_REC_BINARY) != 0);
+            } else if ((probe == true) || (d->binary != ((flags & SPOOL_REC_BINARY) != 0)) || (up_dgram_fits(d, len) == false)) {
+                break;
+            }
+            if (spool_peek(&spool, buff_rxpk, RXPK_BUFF_SIZE) != len) {
+                break;
+            }
+            up_dgram_append(d, buff_rxpk, len, now);
+        }
+        spool_replay_sent(&spool, now);
+    }
+    xSemaphoreGive(mx_spool);
+
+    if (d->open == true) {
+        up_dgram_send(d, UP_FLUSH_REPLAY);
+    }
+}
+
+/* Send an empty binary PUSH_DATA to each server, its PUSH_ACK telling if binary PUSH_DATA are supported */
+static void up_binary_probe(void)
+{
+    uint8_t probe[12 + PUSH_BIN_BODY_HEADER];
+    uint16_t token;
+    int i;
+
+    probe[0] = PROTOCOL_VERSION_BINARY;
+    probe[3] = PKT_PUSH_DATA;
+    memcpy(probe + 4, buff_up + 4, 8); /* gateway MAC */
+    probe[12] = 0; /* no rxpk record */
+    probe[13] = 0; /* no stat record */
+    for (i = 0; i < serv_nb; i++) {
+        if (serv_is_resolved(&serv[i]) == false) {
+            continue;
+        }
+        token = serv_push_token(&serv[i], probe); /* from the same sequence, not mistaken for a datagram in flight */
+        __atomic_store_n(&push_probe_token[i], 1 + (uint32_t)token, __ATOMIC_RELEASE);
+        sendto(serv[i].sock_up, (void *)probe, sizeof probe, 0, (struct sockaddr *)&serv[i].dest_up, sizeof serv[i].dest_up);
+    }
+}
+
 void thread_up(void)
 {
     int i, j, k; /* loop variables */
-    unsigned pkt_in_dgram; /* nb on Lora packet in the current datagram */
     char stat_timestamp[24];
     time_t t;
 
     /* allocate memory for packet fetching and processing */
-    struct lgw_pkt_rx_s *p; /* pointer on a RX packet */
+    struct lgw_pkt_rx_desc_s *p; /* pointer on a RX packet */
     int nb_pkt;
+    int64_t rx_edge_time = 0; /* time of the RX interrupt the fetch answers, in polling mode end of the previous fetch, 0 if none */
 
     /* local copy of GPS time reference */
     bool ref_ok = false; /* determine if GPS time reference must be used or not */
     struct tref local_ref; /* time reference used for UTC <-> timestamp conversion */
-
-    /* data buffers */
-    int buff_index;
-    uint8_t buff_ack[32]; /* buffer to receive acknowledges */
-
-    /* protocol variables */
-    uint8_t token_h; /* random token for acknowledgement matching */
-    uint8_t token_l; /* random token for acknowledgement matching */
-
-    /* ping measurement variables */
-    struct timespec send_time;
-    struct timespec recv_time;
+    struct timecache_s time_cache = { .valid = false }; /* conversion factor of local_ref */
+
+    /* datagram being aggregated, kept open across fetches until its deadline */
+    up_dgram_t dgram = { .open = false };
+    bool binary; /* format of the packets serialized in this fetch */
+    bool urgent; /* a packet of this fetch must be sent at once */
+    bool spooled; /* the server does not answer, packet kept for a replay */
+    int64_t now;
+    uint32_t wait_ms;
+    int64_t probe_due = 0; /* next binary probe, in auto mode while JSON is sent */
+
+    /* uplink cycle measurement: time from a fetch returning packets to the next fetch */
+    int64_t fetch_time;
+    int64_t cycle_start = 0;
+    uint32_t cycle;
 
     /* GPS synchronization variables */
     struct timespec pkt_utc_time;
-    struct tm * x; /* broken-up UTC time */
-    struct timespec pkt_gps_time;
     uint64_t pkt_gps_time_ms;
+    const struct timespec * pkt_utc_ptr; /* NULL if the packet has no UTC time */
+    const uint64_t * pkt_gps_ptr; /* NULL if the packet has no GPS time */
 
     /* report management variable */
     bool send_report = false;
@@ -2162,15 +2856,21 @@ void thread_up(void)
     uint32_t mote_addr = 0;
     uint16_t mote_fcnt = 0;
 
-    /* set upstream socket RX timeout */
-    i = setsockopt(sock_up, SOL_SOCKET, SO_RCVTIMEO, (void *)&push_timeout_half, sizeof push_timeout_half);
-    if (i != 0) {
-        MSG("ERROR: [up] setsockopt returned %s\n", strerror(errno));
-        exit(EXIT_FAILURE);
+    /* uplink filter, local copy */
+    static struct upfilter_s filter;
+    uint32_t filter_gen = 0;
+    int filter_res;
+
+    /* wait for the RX interrupt between fetches if possible, poll otherwise */
+    if (fetch_irq == true) {
+        if (lgw_gpio_rx_irq_start(xTaskGetCurrentTaskHandle()) == 0) {
+            MSG("INFO: [up] packet fetch driven by RX interrupt on GPIO%d\n", SX1302_RX_IRQ_PIN);
+        } else {
+            MSG("WARNING: [up] RX interrupt not available, polling every %u ms\n", FETCH_SLEEP_MS);
+        }
     }
 
     /* pre-fill the data buffer with fixed fields */
-    buff_up[0] = PROTOCOL_VERSION;
     buff_up[3] = PKT_PUSH_DATA;
     *(uint32_t *)(buff_up + 4) = net_mac_h;
     *(uint32_t *)(buff_up + 8) = net_mac_l;
@@ -2178,55 +2878,113 @@ void thread_up(void)
     while (!exit_sig && !quit_sig) {
 
         /* fetch packets */
+        if (rx_edge_time == 0) {
+            rx_edge_time = lgw_gpio_rx_irq_time(); /* packets signaled before the fetch are in the buffer */
+        }
+        fetch_time = esp_timer_get_time();
         xSemaphoreTake(mx_concent, portMAX_DELAY);
-        nb_pkt = lgw_receive(NB_PKT_MAX, rxpkt);
+        nb_pkt = lgw_receive_desc(NB_PKT_MAX, rxpkt);
         xSemaphoreGive(mx_concent);
         if (nb_pkt == LGW_HAL_ERROR) {
             MSG("ERROR: [up] failed packet fetch, exiting\n");
             exit(EXIT_FAILURE);
         }
 
+        /* fetch statistics */
+        stats_begin(&meas_up.seq);
+        meas_up.fetch_nb += 1;
+        if (cycle_start != 0) {
+            cycle = (uint32_t)(fetch_time - cycle_start);
+            meas_up.cycle_nb += 1;
+            meas_up.cycle_sum += cycle;
+            stats_max(&meas_up.cycle_max, cycle);
+        }
+        cycle_start = (nb_pkt > 0) ? esp_timer_get_time() : 0;
+        if (nb_pkt == 0) {
+            meas_up.fetch_empty += 1;
+        } else if (rx_edge_time != 0) {
+            meas_up.latency[meas_up.latency_nb % LATENCY_SAMPLES_NB] = (uint32_t)(esp_timer_get_time() - rx_edge_time);
+            meas_up.latency_nb += 1;
+        }
+        stats_end(&meas_up.seq);
+
+        /* an edge seen by a fetch without packets still waits for them; when polling, packets of the
+           next fetch came after this one, so that the latency is at most one polling period too high */
+        if (lgw_gpio_rx_irq_enabled() == false) {
+            rx_edge_time = esp_timer_get_time();
+        } else if (nb_pkt > 0) {
+            rx_edge_time = 0;
+        }
+
+        /* in auto mode, probe the servers every keep-alive interval until they all accept binary PUSH_DATA, packets going as JSON until then */
+        if ((push_format == PUSH_FORMAT_AUTO) && (push_binary == false) && (fetch_time >= probe_due)) {
+            up_binary_probe();
+            probe_due = fetch_time + (int64_t)((serv[0].keepalive > 0) ? serv[0].keepalive : DEFAULT_KEEPALIVE) * 1000000;
+        }
+
         /* check if there are status report to send */
         send_report = report_ready; /* copy the variable so it doesn't change mid-function */
         /* no mutex, we're only reading */
 
-        /* wait a short time if no packets, nor status report */
-        if ((nb_pkt == 0) && (send_report == false)) {
-            //wait_ms(FETCH_SLEEP_MS);
-            vTaskDelay(FETCH_SLEEP_MS / portTICK_PERIOD_MS);
+        if (nb_pkt == 0) {
+            now = esp_timer_get_time();
+            if ((dgram.open == true) && (now >= dgram.deadline)) {
+                /* oldest aggregated packet waited long enough, the report goes with it if ready */
+                up_dgram_send(&dgram, UP_FLUSH_DEADLINE);
+            } else if ((dgram.open == false) && (send_report == true)) {
+                /* status report alone, when no packet is being aggregated */
+                up_dgram_open(&dgram, push_binary);
+                up_dgram_send(&dgram, UP_FLUSH_REPORT);
+            } else {
+                up_spool_replay(&dgram);
+                /* wait for the next packet, not beyond the deadline of the aggregated ones */
+                wait_ms = (lgw_gpio_rx_irq_enabled() == true) ? FETCH_WATCHDOG_MS : FETCH_SLEEP_MS;
+                if ((dgram.open == true) && ((dgram.deadline - now) < ((int64_t)wait_ms * 1000))) {
+                    wait_ms = (uint32_t)((dgram.deadline - now + 999) / 1000);
+                }
+                if (lgw_gpio_rx_irq_enabled() == true) {
+                    /* the watchdog timeout still catches status reports and any missed edge */
+                    lgw_gpio_rx_irq_wait(wait_ms);
+                } else {
+                    //wait_ms(FETCH_SLEEP_MS);
+                    vTaskDelay((wait_ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS);
+                }
+            }
             continue;
         }
-        if (nb_pkt > 0)
-            vUplinkFlash(10);
+        vUplinkFlash(10);
 
         /* get a copy of GPS time reference (avoid 1 mutex per packet) */
-        if ((nb_pkt > 0) && (gps_enabled == true)) {
+        if (gps_enabled == true) {
             xSemaphoreTake(mx_timeref, portMAX_DELAY);
             ref_ok = gps_ref_valid;
             local_ref = time_reference_gps;
             xSemaphoreGive(mx_timeref);
+            if (ref_ok == true) {
+                timecache_set_ref(&time_cache, &local_ref);
+            }
         } else {
             ref_ok = false;
         }
 
+        /* get a copy of the uplink filter when it changed (avoid 1 mutex per packet) */
+        if (__atomic_load_n(&upfilter_gen, __ATOMIC_ACQUIRE) != filter_gen) {
+            xSemaphoreTake(mx_upfilter, portMAX_DELAY);
+            filter = upfilter;
+            filter_gen = upfilter_gen;
+            xSemaphoreGive(mx_upfilter);
+        }
+
         /* get timestamp for statistics */
         t = time(NULL);
         strftime(stat_timestamp, sizeof stat_timestamp, "%F %T %Z", gmtime(&t));
         MSG_DEBUG(DEBUG_PKT_FWD, "\nCurrent time: %s \n", stat_timestamp);
 
-        /* start composing datagram with the header */
-        token_h = (uint8_t)rand(); /* random token */
-        token_l = (uint8_t)rand(); /* random token */
-        buff_up[1] = token_h;
-        buff_up[2] = token_l;
-        buff_index = 12; /* 12-byte header */
-
-        /* start of JSON structure */
-        memcpy((void *)(buff_up + buff_index), (void *)"{\"rxpk\":[", 9);
-        buff_index += 9;
+        /* the format can only change between datagrams */
+        binary = (dgram.open == true) ? dgram.binary : push_binary;
 
         /* serialize Lora packets metadata and payload */
-        pkt_in_dgram = 0;
+        urgent = false;
         for (i = 0; i < nb_pkt; ++i) {
             p = &rxpkt[i];
 
@@ -2246,308 +3004,113 @@ void thread_up(void)
             }
 
             /* basic packet filtering */
-            xSemaphoreTake(mx_meas_up, portMAX_DELAY);
-            meas_nb_rx_rcv += 1;
+            stats_begin(&meas_up.seq);
+            meas_up.rx_rcv += 1;
             switch(p->status) {
                 case STAT_CRC_OK:
-                    meas_nb_rx_ok += 1;
+                    meas_up.rx_ok += 1;
                     if (!fwd_valid_pkt) {
-                        xSemaphoreGive(mx_meas_up);
+                        stats_end(&meas_up.seq);
                         continue; /* skip that packet */
                     }
                     break;
                 case STAT_CRC_BAD:
-                    meas_nb_rx_bad += 1;
+                    meas_up.rx_bad += 1;
                     if (!fwd_error_pkt) {
-                        xSemaphoreGive(mx_meas_up);
+                        stats_end(&meas_up.seq);
                         continue; /* skip that packet */
                     }
                     break;
                 case STAT_NO_CRC:
-                    meas_nb_rx_nocrc += 1;
+                    meas_up.rx_nocrc += 1;
                     if (!fwd_nocrc_pkt) {
-                        xSemaphoreGive(mx_meas_up);
+                        stats_end(&meas_up.seq);
                         continue; /* skip that packet */
                     }
                     break;
                 default:
+                    stats_end(&meas_up.seq);
                     MSG("WARNING: [up] received packet with unknown status %u (size %u, modulation %u, BW %u, DR %u, RSSI %.1f)\n", p->status, p->size, p->modulation, p->bandwidth, p->datarate, p->rssic);
-                    xSemaphoreGive(mx_meas_up);
                     continue; /* skip that packet */
                     // exit(EXIT_FAILURE);
             }
-            meas_up_pkt_fwd += 1;
-            meas_up_payload_byte += p->size;
-            xSemaphoreGive(mx_meas_up);
-            printf( "\nINFO: Received pkt from mote: %08X (fcnt=%u)\n", mote_addr, mote_fcnt );
-
-            /* Start of packet, add inter-packet separator if necessary */
-            if (pkt_in_dgram == 0) {
-                buff_up[buff_index] = '{';
-                ++buff_index;
-            } else {
-                buff_up[buff_index] = ',';
-                buff_up[buff_index+1] = '{';
-                buff_index += 2;
-            }
 
-            /* JSON rxpk frame format version, 8 useful chars */
-            j = snprintf((char *)(buff_up + buff_index), TX_BUFF_SIZE-buff_index, "\"jver\":%d", PROTOCOL_JSON_RXPK_FRAME_FORMAT );
-            if (j > 0) {
-                buff_index += j;
-            } else {
-                MSG("ERROR: [up] snprintf failed line %u\n", (__LINE__ - 4));
-                exit(EXIT_FAILURE);
+            /* uplink filter, before any serialization work, on valid frames only:
+               the header of a corrupted one cannot be trusted, forward_crc_* decide */
+            filter_res = (p->status == STAT_CRC_OK) ? upfilter_check(&filter, p->payload, p->size) : UPFILTER_PASS;
+            if (filter_res != UPFILTER_PASS) {
+                if (filter_res == UPFILTER_DROP_DEVADDR) {
+                    meas_up.filter_devaddr += 1;
+                } else {
+                    meas_up.filter_joineui += 1;
+                }
+                stats_end(&meas_up.seq);
+                continue; /* skip that packet */
             }
-
-            /* RAW timestamp, 8-17 useful chars */
-            j = snprintf((char *)(buff_up + buff_index), TX_BUFF_SIZE-buff_index, ",\"tmst\":%u", p->count_us);
-            if (j > 0) {
-                buff_index += j;
-            } else {
-                MSG("ERROR: [up] snprintf failed line %u\n", (__LINE__ - 4));
-                exit(EXIT_FAILURE);
+            meas_up.pkt_fwd += 1;
+            meas_up.payload_byte += p->size;
+            if (p->modulation == MOD_LORA) {
+                meas_up.pkt_log[p->if_chain][p->datarate - 5] += 1;
+                meas_up.pkt_lora += 1;
+            } else if (p->modulation == MOD_FSK) {
+                meas_up.pkt_log[p->if_chain][0] += 1;
+                meas_up.pkt_fsk += 1;
             }
+            stats_end(&meas_up.seq);
+            trace_printf(TRACE_LVL_INFO, TRACE_MOD_UP, "\nINFO: Received pkt from mote: %08X (fcnt=%u)\n", mote_addr, mote_fcnt);
 
-            /* Packet RX time (GPS based), 37 useful chars */
+            /* Packet RX time (GPS based) */
+            pkt_utc_ptr = NULL;
+            pkt_gps_ptr = NULL;
             if (ref_ok == true) {
-                /* convert packet timestamp to UTC absolute time */
-                j = lgw_cnt2utc(local_ref, p->count_us, &pkt_utc_time);
-                if (j == LGW_GPS_SUCCESS) {
-                    /* split the UNIX timestamp to its calendar components */
-                    x = gmtime(&(pkt_utc_time.tv_sec));
-                    j = snprintf((char *)(buff_up + buff_index), TX_BUFF_SIZE-buff_index, ",\"time\":\"%04i-%02i-%02iT%02i:%02i:%02i.%06liZ\"", (x->tm_year)+1900, (x->tm_mon)+1, x->tm_mday, x->tm_hour, x->tm_min, x->tm_sec, (pkt_utc_time.tv_nsec)/1000); /* ISO 8601 format */
-                    if (j > 0) {
-                        buff_index += j;
-                    } else {
-                        MSG("ERROR: [up] snprintf failed line %u\n", (__LINE__ - 4));
-                        exit(EXIT_FAILURE);
-                    }
-                }
-                /* convert packet timestamp to GPS absolute time */
-                j = lgw_cnt2gps(local_ref, p->count_us, &pkt_gps_time);
-                if (j == LGW_GPS_SUCCESS) {
-                    pkt_gps_time_ms = pkt_gps_time.tv_sec * 1E3 + pkt_gps_time.tv_nsec / 1E6;
-                    j = snprintf((char *)(buff_up + buff_index), TX_BUFF_SIZE-buff_index, ",\"tmms\":%" PRIu64 "", pkt_gps_time_ms); /* GPS time in milliseconds since 06.Jan.1980 */
-                    if (j > 0) {
-                        buff_index += j;
-                    } else {
-                        MSG("ERROR: [up] snprintf failed line %u\n", (__LINE__ - 4));
-                        exit(EXIT_FAILURE);
-                    }
-                }
-            }
-
-            /* Fine timestamp */
-            if (p->ftime_received == true) {
-                j = snprintf((char *)(buff_up + buff_index), TX_BUFF_SIZE-buff_index, ",\"ftime\":%u", p->ftime);
-                if (j > 0) {
-                    buff_index += j;
-                } else {
-                    MSG("ERROR: [up] snprintf failed line %u\n", (__LINE__ - 4));
-                    exit(EXIT_FAILURE);
+                /* convert packet timestamp to UTC absolute time & GPS time in milliseconds since 06.Jan.1980 */
+                if (timecache_convert(&time_cache, p->count_us, &pkt_utc_time, &pkt_gps_time_ms) == 0) {
+                    pkt_utc_ptr = &pkt_utc_time;
+                    pkt_gps_ptr = &pkt_gps_time_ms;
                 }
             }
 
-            /* Packet concentrator channel, RF chain & RX frequency, 34-36 useful chars */
-            j = snprintf((char *)(buff_up + buff_index), TX_BUFF_SIZE-buff_index, ",\"chan\":%1u,\"rfch\":%1u,\"freq\":%.6lf,\"mid\":%2u", p->if_chain, p->rf_chain, ((double)p->freq_hz / 1e6), p->modem_id);
-            if (j > 0) {
-                buff_index += j;
+            if (binary == true) {
+                j = push_bin_write_rxpk(p, pkt_utc_ptr, pkt_gps_ptr, buff_rxpk, RXPK_BUFF_SIZE);
             } else {
-                MSG("ERROR: [up] snprintf failed line %u\n", (__LINE__ - 4));
-                exit(EXIT_FAILURE);
+                j = rxpk_json_write(p, pkt_utc_ptr, pkt_gps_ptr, (char *)buff_rxpk, RXPK_BUFF_SIZE);
             }
-
-            /* Packet status, 9-10 useful chars */
-            switch (p->status) {
-                case STAT_CRC_OK:
-                    memcpy((void *)(buff_up + buff_index), (void *)",\"stat\":1", 9);
-                    buff_index += 9;
-                    break;
-                case STAT_CRC_BAD:
-                    memcpy((void *)(buff_up + buff_index), (void *)",\"stat\":-1", 10);
-                    buff_index += 10;
-                    break;
-                case STAT_NO_CRC:
-                    memcpy((void *)(buff_up + buff_index), (void *)",\"stat\":0", 9);
-                    buff_index += 9;
-                    break;
-                default:
-                    MSG("ERROR: [up] received packet with unknown status 0x%02X\n", p->status);
-                    memcpy((void *)(buff_up + buff_index), (void *)",\"stat\":?", 9);
-                    buff_index += 9;
-                    exit(EXIT_FAILURE);
+            if (j < 0) {
+                MSG("WARNING: [up] packet not serialized (invalid field), dropped\n");
+                continue;
             }
 
-            /* Packet modulation, 13-14 useful chars */
-            if (p->modulation == MOD_LORA) {
-                memcpy((void *)(buff_up + buff_index), (void *)",\"modu\":\"LORA\"", 14);
-                buff_index += 14;
-
-                /* Lora datarate & bandwidth, 16-19 useful chars */
-                switch (p->datarate) {
-                    case DR_LORA_SF5:
-                        memcpy((void *)(buff_up + buff_index), (void *)",\"datr\":\"SF5", 12);
-                        buff_index += 12;
-                        break;
-                    case DR_LORA_SF6:
-                        memcpy((void *)(buff_up + buff_index), (void *)",\"datr\":\"SF6", 12);
-                        buff_index += 12;
-                        break;
-                    case DR_LORA_SF7:
-                        memcpy((void *)(buff_up + buff_index), (void *)",\"datr\":\"SF7", 12);
-                        buff_index += 12;
-                        break;
-                    case DR_LORA_SF8:
-                        memcpy((void *)(buff_up + buff_index), (void *)",\"datr\":\"SF8", 12);
-                        buff_index += 12;
-                        break;
-                    case DR_LORA_SF9:
-                        memcpy((void *)(buff_up + buff_index), (void *)",\"datr\":\"SF9", 12);
-                        buff_index += 12;
-                        break;
-                    case DR_LORA_SF10:
-                        memcpy((void *)(buff_up + buff_index), (void *)",\"datr\":\"SF10", 13);
-                        buff_index += 13;
-                        break;
-                    case DR_LORA_SF11:
-                        memcpy((void *)(buff_up + buff_index), (void *)",\"datr\":\"SF11", 13);
-                        buff_index += 13;
-                        break;
-                    case DR_LORA_SF12:
-                        memcpy((void *)(buff_up + buff_index), (void *)",\"datr\":\"SF12", 13);
-                        buff_index += 13;
-                        break;
-                    default:
-                        MSG("ERROR: [up] lora packet with unknown datarate 0x%02X\n", p->datarate);
-                        memcpy((void *)(buff_up + buff_index), (void *)",\"datr\":\"SF?", 12);
-                        buff_index += 12;
-                        exit(EXIT_FAILURE);
-                }
-                switch (p->bandwidth) {
-                    case BW_125KHZ:
-                        memcpy((void *)(buff_up + buff_index), (void *)"BW125\"", 6);
-                        buff_index += 6;
-                        break;
-                    case BW_250KHZ:
-                        memcpy((void *)(buff_up + buff_index), (void *)"BW250\"", 6);
-                        buff_index += 6;
-                        break;
-                    case BW_500KHZ:
-                        memcpy((void *)(buff_up + buff_index), (void *)"BW500\"", 6);
-                        buff_index += 6;
-                        break;
-                    default:
-                        MSG("ERROR: [up] lora packet with unknown bandwidth 0x%02X\n", p->bandwidth);
-                        memcpy((void *)(buff_up + buff_index), (void *)"BW?\"", 4);
-                        buff_index += 4;
-                        exit(EXIT_FAILURE);
-                }
-
-                /* Packet ECC coding rate, 11-13 useful chars */
-                switch (p->coderate) {
-                    case CR_LORA_4_5:
-                        memcpy((void *)(buff_up + buff_index), (void *)",\"codr\":\"4/5\"", 13);
-                        buff_index += 13;
-                        break;
-                    case CR_LORA_4_6:
-                        memcpy((void *)(buff_up + buff_index), (void *)",\"codr\":\"4/6\"", 13);
-                        buff_index += 13;
-                        break;
-                    case CR_LORA_4_7:
-                        memcpy((void *)(buff_up + buff_index), (void *)",\"codr\":\"4/7\"", 13);
-                        buff_index += 13;
-                        break;
-                    case CR_LORA_4_8:
-                        memcpy((void *)(buff_up + buff_index), (void *)",\"codr\":\"4/8\"", 13);
-                        buff_index += 13;
-                        break;
-                    case 0: /* treat the CR0 case (mostly false sync) */
-                        memcpy((void *)(buff_up + buff_index), (void *)",\"codr\":\"OFF\"", 13);
-                        buff_index += 13;
-                        break;
-                    default:
-                        MSG("ERROR: [up] lora packet with unknown coderate 0x%02X\n", p->coderate);
-                        memcpy((void *)(buff_up + buff_index), (void *)",\"codr\":\"?\"", 11);
-                        buff_index += 11;
-                        exit(EXIT_FAILURE);
-                }
-
-                /* Signal RSSI, payload size */
-                j = snprintf((char *)(buff_up + buff_index), TX_BUFF_SIZE-buff_index, ",\"rssis\":%.0f", roundf(p->rssis));
-                if (j > 0) {
-                    buff_index += j;
-                } else {
-                    MSG("ERROR: [up] snprintf failed line %u\n", (__LINE__ - 4));
-                    exit(EXIT_FAILURE);
+            /* keep the packet for a replay if the server does not answer */
+            spooled = false;
+            if (spool_enabled == true) {
+                xSemaphoreTake(mx_spool, portMAX_DELAY);
+                if (spool.link_lost == true) {
+                    spooled = true;
+                    spool_put(&spool, buff_rxpk, (uint16_t)j, (binary == true) ? SPOOL_REC_BINARY : 0);
                 }
+                xSemaphoreGive(mx_spool);
+            }
 
-                /* Lora SNR */
-                j = snprintf((char *)(buff_up + buff_index), TX_BUFF_SIZE-buff_index, ",\"lsnr\":%.1f", p->snr);
-                if (j > 0) {
-                    buff_index += j;
-                } else {
-                    MSG("ERROR: [up] snprintf failed line %u\n", (__LINE__ - 4));
-                    exit(EXIT_FAILURE);
+            if (spooled == false) {
+                /* send the aggregated packets first if this one would take the datagram over its size budget */
+                if ((dgram.open == true) && (up_dgram_fits(&dgram, j) == false)) {
+                    up_dgram_send(&dgram, UP_FLUSH_SIZE);
                 }
-
-                /* Lora frequency offset */
-                j = snprintf((char *)(buff_up + buff_index), TX_BUFF_SIZE-buff_index, ",\"foff\":%d", p->freq_offset);
-                if (j > 0) {
-                    buff_index += j;
-                } else {
-                    MSG("ERROR: [up] snprintf failed line %u\n", (__LINE__ - 4));
-                    exit(EXIT_FAILURE);
+                if (dgram.open == false) {
+                    up_dgram_open(&dgram, binary);
                 }
-            } else if (p->modulation == MOD_FSK) {
-                memcpy((void *)(buff_up + buff_index), (void *)",\"modu\":\"FSK\"", 13);
-                buff_index += 13;
+                up_dgram_append(&dgram, buff_rxpk, j, fetch_time);
 
-                /* FSK datarate, 11-14 useful chars */
-                j = snprintf((char *)(buff_up + buff_index), TX_BUFF_SIZE-buff_index, ",\"datr\":%u", p->datarate);
-                if (j > 0) {
-                    buff_index += j;
-                } else {
-                    MSG("ERROR: [up] snprintf failed line %u\n", (__LINE__ - 4));
-                    exit(EXIT_FAILURE);
+                /* join-requests (MType 0), confirmed uplinks (4) and rejoin-requests (6) expect a quick answer */
+                if ((aggr_flush_urgent == true) && (p->status == STAT_CRC_OK) && (p->size > 0)) {
+                    k = p->payload[0] >> 5;
+                    if ((k == 0) || (k == 4) || (k == 6)) {
+                        urgent = true;
+                    }
                 }
-            } else {
-                MSG("ERROR: [up] received packet with unknown modulation 0x%02X\n", p->modulation);
-                exit(EXIT_FAILURE);
-            }
-
-            /* Channel RSSI, payload size, 18-23 useful chars */
-            j = snprintf((char *)(buff_up + buff_index), TX_BUFF_SIZE-buff_index, ",\"rssi\":%.0f,\"size\":%u", roundf(p->rssic), p->size);
-            if (j > 0) {
-                buff_index += j;
-            } else {
-                MSG("ERROR: [up] snprintf failed line %u\n", (__LINE__ - 4));
-                exit(EXIT_FAILURE);
             }
 
-            /* Packet base64-encoded payload, 14-350 useful chars */
-            memcpy((void *)(buff_up + buff_index), (void *)",\"data\":\"", 9);
-            buff_index += 9;
-            j = bin_to_b64(p->payload, p->size, (char *)(buff_up + buff_index), 341); /* 255 bytes = 340 chars in b64 + null char */
-            if (j>=0) {
-                buff_index += j;
-            } else {
-                MSG("ERROR: [up] bin_to_b64 failed line %u\n", (__LINE__ - 5));
-                exit(EXIT_FAILURE);
-            }
-            buff_up[buff_index] = '"';
-            ++buff_index;
-
-            /* End of packet serialization */
-            buff_up[buff_index] = '}';
-            ++buff_index;
-            ++pkt_in_dgram;
-
             if (p->modulation == MOD_LORA) {
-                /* Log nb of packets per channel, per SF */
-                nb_pkt_log[p->if_chain][p->datarate - 5] += 1;
-                nb_pkt_received_lora += 1;
-
                 /* Log nb of packets for ref_payload (DEBUG) */
                 for (k = 0; k < debugconf.nb_ref_payload; k++) {
                     if ((p->payload[0] == (uint8_t)(debugconf.ref_payload[k].id >> 24)) &&
@@ -2557,12 +3120,13 @@ void thread_up(void)
                             nb_pkt_received_ref[k] += 1;
                         }
                 }
-            } else if (p->modulation == MOD_FSK) {
-                nb_pkt_log[p->if_chain][0] += 1;
-                nb_pkt_received_fsk += 1;
             }
         }
 
+        /* payloads are serialized, give their space back to the RX pool */
+        for (i = 0; i < nb_pkt; ++i) {
+            lgw_rx_desc_release(&rxpkt[i]);
+        }
 
         /* DEBUG: print the number of packets received per channel and per SF */
         {
@@ -2571,96 +3135,156 @@ void thread_up(void)
             for (l = 0; l < (LGW_IF_CHAIN_NB - 1); l++) {
                 MSG_PRINTF(DEBUG_PKT_FWD, "CH%d: ", l);
                 for (m = 0; m < 8; m++) {
-                    MSG_PRINTF(DEBUG_PKT_FWD, "\t%d", nb_pkt_log[l][m]);
+                    MSG_PRINTF(DEBUG_PKT_FWD, "\t%d", meas_up.pkt_log[l][m]);
                 }
                 MSG_PRINTF(DEBUG_PKT_FWD, "\n");
             }
-            MSG_PRINTF(DEBUG_PKT_FWD, "FSK: \t%d", nb_pkt_log[9][0]);
+            MSG_PRINTF(DEBUG_PKT_FWD, "FSK: \t%d", meas_up.pkt_log[9][0]);
             MSG_PRINTF(DEBUG_PKT_FWD, "\n");
-            MSG_PRINTF(DEBUG_PKT_FWD, "Total number of LoRa packet received: %u\n", nb_pkt_received_lora);
-            MSG_PRINTF(DEBUG_PKT_FWD, "Total number of FSK packet received: %u\n", nb_pkt_received_fsk);
+            MSG_PRINTF(DEBUG_PKT_FWD, "Total number of LoRa packet received: %u\n", meas_up.pkt_lora);
+            MSG_PRINTF(DEBUG_PKT_FWD, "Total number of FSK packet received: %u\n", meas_up.pkt_fsk);
             for (l = 0; l < debugconf.nb_ref_payload; l++) {
                 MSG_PRINTF(DEBUG_PKT_FWD, "Total number of LoRa packet received from 0x%08X: %u\n", debugconf.ref_payload[l].id, nb_pkt_received_ref[l]);
             }
         }
 
-        /* restart fetch sequence without sending empty JSON if all packets have been filtered out */
-        if (pkt_in_dgram == 0) {
-            if (send_report == true) {
-                /* need to clean up the beginning of the payload */
-                buff_index -= 8; /* removes "rxpk":[ */
-            } else {
-                /* all packet have been filtered out and no report, restart loop */
-                continue;
-            }
-        } else {
-            /* end of packet array */
-            buff_up[buff_index] = ']';
-            ++buff_index;
-            /* add separator if needed */
-            if (send_report == true) {
-                buff_up[buff_index] = ',';
-                ++buff_index;
+        /* send the aggregated packets if one of them is urgent or the oldest one waited long enough */
+        if (dgram.open == true) {
+            if (urgent == true) {
+                up_dgram_send(&dgram, UP_FLUSH_URGENT);
+            } else if (esp_timer_get_time() >= dgram.deadline) {
+                up_dgram_send(&dgram, UP_FLUSH_DEADLINE);
             }
         }
-
-        /* add status report if a new one is available */
-        if (send_report == true) {
-            xSemaphoreTake(mx_stat_rep, portMAX_DELAY);
-            report_ready = false;
-            j = snprintf((char *)(buff_up + buff_index), TX_BUFF_SIZE-buff_index, "%s", status_report);
-            xSemaphoreGive(mx_stat_rep);
-            if (j > 0) {
-                buff_index += j;
-            } else {
-                MSG("ERROR: [up] snprintf failed line %u\n", (__LINE__ - 5));
-                exit(EXIT_FAILURE);
-            }
+        /* status report alone if all packets have been filtered out, or did not leave room for it */
+        if ((dgram.open == false) && (report_ready == true)) {
+            up_dgram_open(&dgram, push_binary);
+            up_dgram_send(&dgram, UP_FLUSH_REPORT);
         }
+        up_spool_replay(&dgram);
+    }
 
-        /* end of JSON datagram payload */
-        buff_up[buff_index] = '}';
-        ++buff_index;
-        buff_up[buff_index] = 0; /* add string terminator, for safety */
+    /* do not drop the packets being aggregated, they are sent before their deadline */
+    if (dgram.open == true) {
+        up_dgram_send(&dgram, UP_FLUSH_DEADLINE);
+    }
+    lgw_gpio_rx_irq_stop();
+    MSG("\nINFO: End of upstream thread\n");
+}
 
-        printf("\nJSON up: %s\n", (char *)(buff_up + 12)); /* DEBUG: display JSON payload */
+/* -------------------------------------------------------------------------- */
+/* --- THREAD 1 BIS: RECEIVING PUSH_ACK ------------------------------------- */
 
-        /* send datagram to server */
-        //send(sock_up, (void *)buff_up, buff_index, 0);
-        sendto(sock_up, (void *)buff_up, buff_index, 0, (struct sockaddr *)&dest_addr, sizeof(dest_addr));
-        clock_gettime(CLOCK_MONOTONIC, &send_time);
-        xSemaphoreTake(mx_meas_up, portMAX_DELAY);
-        meas_up_dgram_sent += 1;
-        meas_up_network_byte += buff_index;
-
-        /* wait for acknowledge (in 2 times, to catch extra packets) */
-        socklen_t socklen = sizeof(source_addr);
-        for (i=0; i<2; ++i) {
-            //j = recv(sock_up, (void *)buff_ack, sizeof buff_ack, 0);
-            j = recvfrom(sock_up, (void *)buff_ack, sizeof buff_ack, 0, (struct sockaddr *)&dest_addr, &socklen);
-            clock_gettime(CLOCK_MONOTONIC, &recv_time);
-            if (j == -1) {
-                if (errno == EAGAIN) { /* timeout */
-                    continue;
-                } else { /* server connection error */
-                    break;
+void thread_up_ack(void)
+{
+    int i, j;
+    uint8_t buff_ack[32]; /* buffer to receive acknowledges */
+    struct sockaddr_in ack_addr;
+    socklen_t socklen;
+    int64_t recv_time, rtt, timeout;
+    int ack_serv; /* server the PUSH_ACK came from */
+    int wait_next = 0; /* server checked first for a PUSH_ACK, in turn */
+    uint32_t nb_expired[SERV_MAX];
+    int64_t binary_time = 0; /* binary PUSH_DATA accepted by every server, in auto mode */
+    uint32_t binary_acked = 0; /* servers that acknowledged a probe as binary */
+    uint32_t binary_refused = 0; /* servers that acknowledged a probe as JSON */
+    bool replay_acked, replay_expired[SERV_MAX];
+    bool link_lost;
+
+    /* wake up at least every push_timeout_half to expire the tokens not acknowledged */
+    timeout = 2 * ((int64_t)push_timeout_half.tv_sec * 1000000 + push_timeout_half.tv_usec);
+
+    while (!exit_sig && !quit_sig) {
+        ack_serv = serv_wait(serv, serv_nb, false, (uint32_t)(timeout / 2000), &wait_next);
+        j = -1;
+        if (ack_serv >= 0) {
+            socklen = sizeof ack_addr;
+            j = recvfrom(serv[ack_serv].sock_up, (void *)buff_ack, sizeof buff_ack, 0, (struct sockaddr *)&ack_addr, &socklen);
+        }
+        recv_time = esp_timer_get_time();
+        rtt = -1;
+        replay_acked = false;
+        if (j == -1) {
+            if ((ack_serv >= 0) && (errno != EAGAIN)) { /* server connection error */
+                vTaskDelay(PUSH_TIMEOUT_MS / portTICK_PERIOD_MS);
+            }
+        } else if ((j < 4) || ((buff_ack[0] != PROTOCOL_VERSION) && (buff_ack[0] != PROTOCOL_VERSION_BINARY)) || (buff_ack[3] != PKT_PUSH_ACK)) {
+            MSG("WARNING: [up] ignored invalid non-ACL packet\n");
+        } else if (serv_is_source(&serv[ack_serv], &ack_addr) == false) {
+            MSG("WARNING: [up] ignored ACK packet from %s, not from server %s\n", inet_ntoa(ack_addr.sin_addr), serv[ack_serv].addr);
+        } else if ((1 + (((uint32_t)buff_ack[1] << 8) | buff_ack[2])) == __atomic_load_n(&push_probe_token[ack_serv], __ATOMIC_ACQUIRE)) {
+            /* binary probe, the server acknowledges it with its own protocol version; the same datagram going
+               to every server, binary PUSH_DATA are only sent once they all accept them */
+            __atomic_store_n(&push_probe_token[ack_serv], 0, __ATOMIC_RELAXED);
+            if ((push_format == PUSH_FORMAT_AUTO) && (buff_ack[0] == PROTOCOL_VERSION_BINARY)) {
+                binary_acked |= (1u << ack_serv);
+                binary_refused &= ~(1u << ack_serv);
+                if ((push_binary == false) && (binary_acked == ((1u << serv_nb) - 1))) {
+                    push_binary = true;
+                    binary_time = recv_time;
+                    MSG("INFO: [up] every server acknowledges binary PUSH_DATA\n");
                 }
-            } else if ((j < 4) || (buff_ack[0] != PROTOCOL_VERSION) || (buff_ack[3] != PKT_PUSH_ACK)) {
-                MSG("WARNING: [up] ignored invalid non-ACL packet\n");
-                continue;
-            } else if ((buff_ack[1] != token_h) || (buff_ack[2] != token_l)) {
+            } else if ((binary_refused & (1u << ack_serv)) == 0) {
+                binary_acked &= ~(1u << ack_serv);
+                binary_refused |= (1u << ack_serv);
+                MSG("INFO: [up] server %s does not acknowledge binary PUSH_DATA, sending JSON\n", serv[ack_serv].addr);
+            }
+        } else {
+            xSemaphoreTake(mx_push_ack, portMAX_DELAY);
+            rtt = serv_push_ack(&serv[ack_serv], ((uint16_t)buff_ack[1] << 8) | buff_ack[2], recv_time, timeout, &replay_acked);
+            xSemaphoreGive(mx_push_ack);
+            if (rtt < 0) {
                 MSG("WARNING: [up] ignored out-of sync ACK packet\n");
-                continue;
             } else {
-                MSG("INFO: [up] PUSH_ACK received in %i ms\n", (int)(1000 * difftimespec(recv_time, send_time)));
-                meas_up_ack_rcv += 1;
+                MSG("INFO: [up] PUSH_ACK received in %i ms from %s\n", (int)(rtt / 1000), serv[ack_serv].addr);
                 vBackhaulFlash( 10 );
-                break;
             }
         }
-        xSemaphoreGive(mx_meas_up);
+        xSemaphoreTake(mx_push_ack, portMAX_DELAY);
+        for (i = 0; i < serv_nb; i++) {
+            nb_expired[i] = serv_push_expire(&serv[i], recv_time, timeout, &replay_expired[i]);
+        }
+        xSemaphoreGive(mx_push_ack);
+
+        /* the spool follows the link state of the network server, and the replayed packets leave it when acknowledged */
+        if ((spool_enabled == true) && (((rtt >= 0) && (ack_serv == 0)) || (nb_expired[0] > 0))) {
+            xSemaphoreTake(mx_spool, portMAX_DELAY);
+            link_lost = spool.link_lost;
+            if ((rtt >= 0) && (ack_serv == 0)) {
+                spool_ack(&spool, replay_acked);
+            }
+            if (nb_expired[0] > 0) {
+                spool_expired(&spool, nb_expired[0], replay_expired[0]);
+            }
+            if (spool.link_lost != link_lost) {
+                MSG("%s: [up] server %s, packets are %s\n", (link_lost == true) ? "INFO" : "WARNING", (link_lost == true) ? "answers again" : "does not answer",
+                    (link_lost == true) ? "sent and spooled ones replayed" : "spooled");
+            }
+            xSemaphoreGive(mx_spool);
+        }
+
+        /* a JSON PUSH_ACK once the JSON PUSH_DATA sent before the switch have expired: a server no longer takes binary, probe them again */
+        if ((push_format == PUSH_FORMAT_AUTO) && (push_binary == true) && (rtt >= 0) &&
+            (buff_ack[0] != PROTOCOL_VERSION_BINARY) && ((recv_time - binary_time) > timeout)) {
+            push_binary = false;
+            binary_acked &= ~(1u << ack_serv);
+            MSG("WARNING: [up] server %s acknowledges binary PUSH_DATA no more, sending JSON\n", serv[ack_serv].addr);
+        }
+
+        for (i = 0; i < serv_nb; i++) {
+            if (((rtt >= 0) && (ack_serv == i)) || (nb_expired[i] > 0)) {
+                stats_begin(&meas_up_ack[i].seq);
+                if ((rtt >= 0) && (ack_serv == i)) {
+                    meas_up_ack[i].ack_rcv += 1;
+                    meas_up_ack[i].ack_rtt_sum += (uint64_t)rtt;
+                    stats_max(&meas_up_ack[i].ack_rtt_max, (uint32_t)rtt);
+                }
+                meas_up_ack[i].ack_timeout += nb_expired[i];
+                stats_end(&meas_up_ack[i].seq);
+            }
+        }
     }
-    MSG("\nINFO: End of upstream thread\n");
+    MSG("\nINFO: End of upstream ACK thread\n");
 }
 
 /* -------------------------------------------------------------------------- */
@@ -2716,22 +3340,22 @@ void thread_down(void)
     bool sent_immediate = false; /* option to sent the packet immediately */
 
     /* local timekeeping variables */
-    struct timespec send_time; /* time of the pull request */
+    struct timespec send_time; /* time of the pull requests */
     struct timespec recv_time; /* time of return from recv socket call */
 
     /* data buffers */
     uint8_t buff_req[12]; /* buffer to compose pull requests */
     int msg_len;
 
-    /* protocol variables */
-    uint8_t token_h; /* random token for acknowledgement matching */
-    uint8_t token_l; /* random token for acknowledgement matching */
-    bool req_ack = false; /* keep track of whether PULL_DATA was acknowledged or not */
+    /* servers taking downlinks, each with its own PULL_DATA token and keep-alive */
+    struct serv_s *s = NULL; /* server the datagram came from */
+    int down_serv;
+    int wait_next = 0; /* server checked first for a datagram, in turn */
+    struct sockaddr_in source_addr;
+    socklen_t socklen;
 
     /* JSON parsing variables */
-    JSON_Value *root_val = NULL;
-    JSON_Object *txpk_obj = NULL;
-    JSON_Value *val = NULL; /* needed to detect the absence of some fields */
+    static struct txpk_json_s txpk; /* fields of the txpk object, kept off the stack */
     const char *str; /* pointer to sub-strings in the JSON data */
     short x0, x1;
     uint64_t x2;
@@ -2759,7 +3383,7 @@ void thread_down(void)
     uint16_t field_crc1, field_crc2;
 
     /* auto-quit variable */
-    uint32_t autoquit_cnt = 0; /* count the number of PULL_DATA sent since the latest PULL_ACK */
+    int autoquit_nb; /* number of servers whose last autoquit_threshold PULL_DATA were not acknowledged */
 
     /* Just In Time downlink */
     uint32_t current_concentrator_time;
@@ -2769,13 +3393,6 @@ void thread_down(void)
     int32_t warning_value = 0;
     uint8_t tx_lut_idx = 0;
 
-    /* set downstream socket RX timeout */
-    i = setsockopt(sock_down, SOL_SOCKET, SO_RCVTIMEO, (void *)&pull_timeout, sizeof pull_timeout);
-    if (i != 0) {
-        MSG("ERROR: [down] setsockopt returned %s\n", strerror(errno));
-        exit(EXIT_FAILURE);
-    }
-
     /* pre-fill the pull request buffer with fixed fields */
     buff_req[0] = PROTOCOL_VERSION;
     buff_req[3] = PKT_PULL_DATA;
@@ -2874,7 +3491,7 @@ void thread_down(void)
     }
 
     /* CRC of the beacon gateway specific part fields */
-    field_crc2 = crc16((beacon_pkt.payload + 6 + beacon_RFU1_size), 7 + beacon_RFU2_size);
+    field_crc2 = crc16_ccitt(0x0000, (beacon_pkt.payload + 6 + beacon_RFU1_size), 7 + beacon_RFU2_size);
     beacon_pkt.payload[beacon_pyld_idx++] = 0xFF &  field_crc2;
     beacon_pkt.payload[beacon_pyld_idx++] = 0xFF & (field_crc2 >> 8);
 
@@ -2882,39 +3499,64 @@ void thread_down(void)
     jit_queue_init(&jit_queue[0]);
     jit_queue_init(&jit_queue[1]);
 
+    /* first PULL requests due at once */
+    clock_gettime(CLOCK_MONOTONIC, &send_time);
+    for (i = 0; i < serv_nb; i++) {
+        serv[i].pull_time.tv_sec = send_time.tv_sec - serv[i].keepalive;
+        serv[i].pull_time.tv_nsec = send_time.tv_nsec;
+    }
+
     while (!exit_sig && !quit_sig) {
 
-        /* auto-quit if the threshold is crossed */
-        if ((autoquit_threshold > 0) && (autoquit_cnt >= autoquit_threshold)) {
-            exit_sig = true;
-            MSG("INFO: [down] the last %u PULL_DATA were not ACKed, exiting application\n", autoquit_threshold);
-            break;
+        /* auto-quit if the threshold is crossed for all the servers taking downlinks */
+        if (autoquit_threshold > 0) {
+            autoquit_nb = 0;
+            for (i = 0; i < serv_nb; i++) {
+                if ((serv[i].downlink == false) || (serv[i].pull_unacked_nb >= autoquit_threshold)) {
+                    autoquit_nb += 1;
+                }
+            }
+            if (autoquit_nb == serv_nb) {
+                exit_sig = true;
+                MSG("INFO: [down] the last %u PULL_DATA were not ACKed, exiting application\n", autoquit_threshold);
+                break;
+            }
         }
 
-        /* generate random token for request */
-        token_h = (uint8_t)rand(); /* random token */
-        token_l = (uint8_t)rand(); /* random token */
-        buff_req[1] = token_h;
-        buff_req[2] = token_l;
-
-        /* send PULL request and record time */
-        //send(sock_down, (void *)buff_req, sizeof buff_req, 0);
-        sendto(sock_down, (void *)buff_req, sizeof buff_req, 0, (struct sockaddr *)&dest_addr, sizeof(dest_addr));
+        /* send a PULL request with a new random token to the servers whose keep-alive interval elapsed, and record time */
         clock_gettime(CLOCK_MONOTONIC, &send_time);
-        xSemaphoreTake(mx_meas_dw, portMAX_DELAY);
-        meas_dw_pull_sent += 1;
-        xSemaphoreGive(mx_meas_dw);
-        req_ack = false;
-        autoquit_cnt++;
+        for (i = 0; i < serv_nb; i++) {
+            s = &serv[i];
+            if ((s->downlink == false) || ((int)difftimespec(send_time, s->pull_time) < s->keepalive)) {
+                continue;
+            }
+            s->pull_token[0] = (uint8_t)rand(); /* random token */
+            s->pull_token[1] = (uint8_t)rand(); /* random token */
+            buff_req[1] = s->pull_token[0];
+            buff_req[2] = s->pull_token[1];
+            if (serv_is_resolved(s) == true) { /* counted as not acknowledged otherwise */
+                sendto(s->sock_down, (void *)buff_req, sizeof buff_req, 0, (struct sockaddr *)&s->dest_down, sizeof s->dest_down);
+            }
+            s->pull_time = send_time;
+            s->pull_acked = false;
+            s->pull_unacked_nb += 1;
+            stats_begin(&meas_dw.seq);
+            meas_dw.pull_sent[i] += 1;
+            stats_end(&meas_dw.seq);
+        }
 
         /* listen to packets and process them until a new PULL request must be sent */
         recv_time = send_time;
-        socklen_t socklen = sizeof(source_addr);
-        while (((int)difftimespec(recv_time, send_time) < keepalive_time) && !exit_sig && !quit_sig) {
-
-            /* try to receive a datagram */
-            //msg_len = recv(sock_down, (void *)buff_down, (sizeof buff_down)-1, 0);
-            msg_len = recvfrom(sock_down, (void *)buff_down, (sizeof buff_down)-1, 0, (struct sockaddr *)&dest_addr, &socklen);
+        while ((pull_due(&recv_time) == false) && !exit_sig && !quit_sig) {
+
+            /* try to receive a datagram from the servers taking downlinks */
+            msg_len = -1;
+            down_serv = serv_wait(serv, serv_nb, true, PULL_TIMEOUT_MS, &wait_next);
+            if (down_serv >= 0) {
+                s = &serv[down_serv];
+                socklen = sizeof source_addr;
+                msg_len = recvfrom(s->sock_down, (void *)buff_down, (sizeof buff_down)-1, 0, (struct sockaddr *)&source_addr, &socklen);
+            }
             clock_gettime(CLOCK_MONOTONIC, &recv_time);
 
             /* Pre-allocate beacon slots in JiT queue, to check downlink collisions */
@@ -2975,7 +3617,7 @@ void thread_down(void)
                     beacon_pkt.payload[beacon_pyld_idx++] = 0xFF & (next_beacon_gps_time.tv_sec >> 24);
 
                     /* calculate CRC */
-                    field_crc1 = crc16(beacon_pkt.payload, 4 + beacon_RFU1_size); /* CRC for the network common part */
+                    field_crc1 = crc16_ccitt(0x0000, beacon_pkt.payload, 4 + beacon_RFU1_size); /* CRC for the network common part */
                     beacon_pkt.payload[beacon_pyld_idx++] = 0xFF & field_crc1;
                     beacon_pkt.payload[beacon_pyld_idx++] = 0xFF & (field_crc1 >> 8);
 
@@ -2985,10 +3627,12 @@ void thread_down(void)
                     xSemaphoreGive(mx_concent);
                     jit_result = jit_enqueue(&jit_queue[0], current_concentrator_time, &beacon_pkt, JIT_PKT_TYPE_BEACON);
                     if (jit_result == JIT_ERROR_OK) {
+                        wake_jit();
+
                         /* update stats */
-                        xSemaphoreTake(mx_meas_dw, portMAX_DELAY);
-                        meas_nb_beacon_queued += 1;
-                        xSemaphoreGive(mx_meas_dw);
+                        stats_begin(&meas_dw.seq);
+                        meas_dw.beacon_queued += 1;
+                        stats_end(&meas_dw.seq);
 
                         /* One more beacon in the queue */
                         beacon_loop--;
@@ -2997,19 +3641,15 @@ void thread_down(void)
 
                         /* display beacon payload */
                         MSG("INFO: Beacon queued (count_us=%u, freq_hz=%u, size=%u):\n", beacon_pkt.count_us, beacon_pkt.freq_hz, beacon_pkt.size);
-                        printf( "   => " );
-                        for (i = 0; i < beacon_pkt.size; ++i) {
-                            MSG("%02X ", beacon_pkt.payload[i]);
-                        }
-                        MSG("\n");
+                        trace_bin(TRACE_LVL_INFO, TRACE_MOD_DOWN, "   => ", beacon_pkt.payload, beacon_pkt.size, TRACE_BIN_HEX);
                     } else {
                         MSG_DEBUG(DEBUG_BEACON, "--> beacon queuing failed with %d\n", jit_result);
                         /* update stats */
-                        xSemaphoreTake(mx_meas_dw, portMAX_DELAY);
+                        stats_begin(&meas_dw.seq);
                         if (jit_result != JIT_ERROR_COLLISION_BEACON) {
-                            meas_nb_beacon_rejected += 1;
+                            meas_dw.beacon_rejected += 1;
                         }
-                        xSemaphoreGive(mx_meas_dw);
+                        stats_end(&meas_dw.seq);
                         /* In case previous enqueue failed, we retry one period later until it succeeds */
                         /* Note: In case the GPS has been unlocked for a while, there can be lots of retries */
                         /*       to be done from last beacon time to a new valid one */
@@ -3028,6 +3668,15 @@ void thread_down(void)
                 continue;
             }
 
+            /* only the server the PULL_DATA was sent to may answer */
+            if (serv_is_source(s, &source_addr) == false) {
+                MSG("WARNING: [down] ignoring datagram from %s, not from server %s\n", inet_ntoa(source_addr.sin_addr), s->addr);
+                stats_begin(&meas_dw.seq);
+                meas_dw.dgram_rejected += 1;
+                stats_end(&meas_dw.seq);
+                continue;
+            }
+
             /* program coming here means a datagram received */
             vBackhaulFlash( 10 );
 
@@ -3040,16 +3689,16 @@ void thread_down(void)
 
             /* if the datagram is an ACK, check token */
             if (buff_down[3] == PKT_PULL_ACK) {
-                if ((buff_down[1] == token_h) && (buff_down[2] == token_l)) {
-                    if (req_ack) {
+                if ((buff_down[1] == s->pull_token[0]) && (buff_down[2] == s->pull_token[1])) {
+                    if (s->pull_acked) {
                         MSG("INFO: [down] duplicate ACK received :)\n");
                     } else { /* if that packet was not already acknowledged */
-                        req_ack = true;
-                        autoquit_cnt = 0;
-                        xSemaphoreTake(mx_meas_dw, portMAX_DELAY);
-                        meas_dw_ack_rcv += 1;
-                        xSemaphoreGive(mx_meas_dw);
-                        MSG("INFO: [down] PULL_ACK received in %i ms\n", (int)(1000 * difftimespec(recv_time, send_time)));
+                        s->pull_acked = true;
+                        s->pull_unacked_nb = 0;
+                        stats_begin(&meas_dw.seq);
+                        meas_dw.ack_rcv[down_serv] += 1;
+                        stats_end(&meas_dw.seq);
+                        MSG("INFO: [down] PULL_ACK received in %i ms from %s\n", (int)(1000 * difftimespec(recv_time, s->pull_time)), s->addr);
                     }
                 } else { /* out-of-sync token */
                     MSG("INFO: [down] received out-of-sync ACK\n");
@@ -3060,26 +3709,21 @@ void thread_down(void)
             /* the datagram is a PULL_RESP */
             buff_down[msg_len] = 0; /* add string terminator, just to be safe */
             MSG("INFO: [down] PULL_RESP received  - token[%d:%d] :)\n", buff_down[1], buff_down[2]); /* very verbose */
-            printf("\nJSON down: %s\n", (char *)(buff_down + 4)); /* DEBUG: display JSON payload */
+            trace_bin(TRACE_LVL_INFO, TRACE_MOD_DOWN, "\nJSON down: ", buff_down + 4, msg_len - 4, TRACE_BIN_TEXT); /* DEBUG: display JSON payload */
 
             /* initialize TX struct and try to parse JSON */
             memset(&txpkt, 0, sizeof txpkt);
-            root_val = json_parse_string_with_comments((const char *)(buff_down + 4)); /* JSON offset */
-            if (root_val == NULL) {
-                MSG("WARNING: [down] invalid JSON, TX aborted\n");
-                continue;
-            }
-
-            /* look for JSON sub-object 'txpk' */
-            txpk_obj = json_object_get_object(json_value_get_object(root_val), "txpk");
-            if (txpk_obj == NULL) {
+            i = txpk_json_parse((char *)(buff_down + 4), &txpk); /* JSON offset, parsed in place */
+            if (i == TXPK_JSON_NO_TXPK) {
                 MSG("WARNING: [down] no \"txpk\" object in JSON, TX aborted\n");
-                json_value_free(root_val);
+                continue;
+            } else if (i != TXPK_JSON_OK) {
+                MSG("WARNING: [down] invalid JSON, TX aborted\n");
                 continue;
             }
 
             /* Parse "immediate" tag, or target timestamp, or UTC time to be converted by GPS (mandatory) */
-            i = json_object_get_boolean(txpk_obj,"imme"); /* can be 1 if true, 0 if false, or -1 if not a JSON boolean */
+            i = txpk_json_boolean(&txpk, TXPK_IMME); /* can be 1 if true, 0 if false, or -1 if not a JSON boolean */
             if (i == 1) {
                 /* TX procedure: send immediately */
                 sent_immediate = true;
@@ -3087,19 +3731,16 @@ void thread_down(void)
                 MSG("INFO: [down] a packet will be sent in \"immediate\" mode\n");
             } else {
                 sent_immediate = false;
-                val = json_object_get_value(txpk_obj,"tmst");
-                if (val != NULL) {
+                if (txpk_json_has(&txpk, TXPK_TMST) == true) {
                     /* TX procedure: send on timestamp value */
-                    txpkt.count_us = (uint32_t)json_value_get_number(val);
+                    txpkt.count_us = (uint32_t)txpk_json_number(&txpk, TXPK_TMST);
 
                     /* Concentrator timestamp is given, we consider it is a Class A downlink */
                     downlink_type = JIT_PKT_TYPE_DOWNLINK_CLASS_A;
                 } else {
                     /* TX procedure: send on GPS time (converted to timestamp value) */
-                    val = json_object_get_value(txpk_obj, "tmms");
-                    if (val == NULL) {
+                    if (txpk_json_has(&txpk, TXPK_TMMS) == false) {
                         MSG("WARNING: [down] no mandatory \"txpk.tmst\" or \"txpk.tmms\" objects in JSON, TX aborted\n");
-                        json_value_free(root_val);
                         continue;
                     }
                     if (gps_enabled == true) {
@@ -3110,23 +3751,21 @@ void thread_down(void)
                         } else {
                             xSemaphoreGive(mx_timeref);
                             MSG("WARNING: [down] no valid GPS time reference yet, impossible to send packet on specific GPS time, TX aborted\n");
-                            json_value_free(root_val);
 
                             /* send acknoledge datagram to server */
-                            send_tx_ack(buff_down[1], buff_down[2], JIT_ERROR_GPS_UNLOCKED, 0);
+                            send_tx_ack(s->sock_down, &source_addr, buff_down[1], buff_down[2], JIT_ERROR_GPS_UNLOCKED, 0);
                             continue;
                         }
                     } else {
                         MSG("WARNING: [down] GPS disabled, impossible to send packet on specific GPS time, TX aborted\n");
-                        json_value_free(root_val);
 
                         /* send acknoledge datagram to server */
-                        send_tx_ack(buff_down[1], buff_down[2], JIT_ERROR_GPS_UNLOCKED, 0);
+                        send_tx_ack(s->sock_down, &source_addr, buff_down[1], buff_down[2], JIT_ERROR_GPS_UNLOCKED, 0);
                         continue;
                     }
 
                     /* Get GPS time from JSON */
-                    x2 = (uint64_t)json_value_get_number(val);
+                    x2 = (uint64_t)txpk_json_number(&txpk, TXPK_TMMS);
 
                     /* Convert GPS time from milliseconds to timespec */
                     x3 = modf((double)x2/1E3, &x4);
@@ -3137,7 +3776,6 @@ void thread_down(void)
                     i = lgw_gps2cnt(local_ref, gps_tx, &(txpkt.count_us));
                     if (i != LGW_GPS_SUCCESS) {
                         MSG("WARNING: [down] could not convert GPS time to timestamp, TX aborted\n");
-                        json_value_free(root_val);
                         continue;
                     } else {
                         MSG("INFO: [down] a packet will be sent on timestamp value %u (calculated from GPS time)\n", txpkt.count_us);
@@ -3149,51 +3787,42 @@ void thread_down(void)
             }
 
             /* Parse "No CRC" flag (optional field) */
-            val = json_object_get_value(txpk_obj,"ncrc");
-            if (val != NULL) {
-                txpkt.no_crc = (bool)json_value_get_boolean(val);
+            if (txpk_json_has(&txpk, TXPK_NCRC) == true) {
+                txpkt.no_crc = (bool)txpk_json_boolean(&txpk, TXPK_NCRC);
             }
 
             /* Parse "No header" flag (optional field) */
-            val = json_object_get_value(txpk_obj, "nhdr");
-            if (val != NULL) {
-                txpkt.no_header = (bool)json_value_get_boolean(val);
+            if (txpk_json_has(&txpk, TXPK_NHDR) == true) {
+                txpkt.no_header = (bool)txpk_json_boolean(&txpk, TXPK_NHDR);
             }
 
             /* parse target frequency (mandatory) */
-            val = json_object_get_value(txpk_obj,"freq");
-            if (val == NULL) {
+            if (txpk_json_has(&txpk, TXPK_FREQ) == false) {
                 MSG("WARNING: [down] no mandatory \"txpk.freq\" object in JSON, TX aborted\n");
-                json_value_free(root_val);
                 continue;
             }
-            txpkt.freq_hz = (uint32_t)((double)(1.0e6) * json_value_get_number(val));
+            txpkt.freq_hz = (uint32_t)((double)(1.0e6) * txpk_json_number(&txpk, TXPK_FREQ));
 
             /* parse RF chain used for TX (mandatory) */
-            val = json_object_get_value(txpk_obj,"rfch");
-            if (val == NULL) {
+            if (txpk_json_has(&txpk, TXPK_RFCH) == false) {
                 MSG("WARNING: [down] no mandatory \"txpk.rfch\" object in JSON, TX aborted\n");
-                json_value_free(root_val);
                 continue;
             }
-            txpkt.rf_chain = (uint8_t)json_value_get_number(val);
+            txpkt.rf_chain = (uint8_t)txpk_json_number(&txpk, TXPK_RFCH);
             if (tx_enable[txpkt.rf_chain] == false) {
                 MSG("WARNING: [down] TX is not enabled on RF chain %u, TX aborted\n", txpkt.rf_chain);
-                json_value_free(root_val);
                 continue;
             }
 
             /* parse TX power (optional field) */
-            val = json_object_get_value(txpk_obj,"powe");
-            if (val != NULL) {
-                txpkt.rf_power = (int8_t)json_value_get_number(val) - antenna_gain;
+            if (txpk_json_has(&txpk, TXPK_POWE) == true) {
+                txpkt.rf_power = (int8_t)txpk_json_number(&txpk, TXPK_POWE) - antenna_gain;
             }
 
             /* Parse modulation (mandatory) */
-            str = json_object_get_string(txpk_obj, "modu");
+            str = txpk_json_string(&txpk, TXPK_MODU);
             if (str == NULL) {
                 MSG("WARNING: [down] no mandatory \"txpk.modu\" object in JSON, TX aborted\n");
-                json_value_free(root_val);
                 continue;
             }
             if (strcmp(str, "LORA") == 0) {
@@ -3201,16 +3830,14 @@ void thread_down(void)
                 txpkt.modulation = MOD_LORA;
 
                 /* Parse Lora spreading-factor and modulation bandwidth (mandatory) */
-                str = json_object_get_string(txpk_obj, "datr");
+                str = txpk_json_string(&txpk, TXPK_DATR);
                 if (str == NULL) {
                     MSG("WARNING: [down] no mandatory \"txpk.datr\" object in JSON, TX aborted\n");
-                    json_value_free(root_val);
                     continue;
                 }
                 i = sscanf(str, "SF%2hdBW%3hd", &x0, &x1);
                 if (i != 2) {
                     MSG("WARNING: [down] format error in \"txpk.datr\", TX aborted\n");
-                    json_value_free(root_val);
                     continue;
                 }
                 switch (x0) {
@@ -3224,7 +3851,6 @@ void thread_down(void)
                     case 12: txpkt.datarate = DR_LORA_SF12; break;
                     default:
                         MSG("WARNING: [down] format error in \"txpk.datr\", invalid SF, TX aborted\n");
-                        json_value_free(root_val);
                         continue;
                 }
                 switch (x1) {
@@ -3233,15 +3859,13 @@ void thread_down(void)
                     case 500: txpkt.bandwidth = BW_500KHZ; break;
                     default:
                         MSG("WARNING: [down] format error in \"txpk.datr\", invalid BW, TX aborted\n");
-                        json_value_free(root_val);
                         continue;
                 }
 
                 /* Parse ECC coding rate (optional field) */
-                str = json_object_get_string(txpk_obj, "codr");
+                str = txpk_json_string(&txpk, TXPK_CODR);
                 if (str == NULL) {
                     MSG("WARNING: [down] no mandatory \"txpk.codr\" object in json, TX aborted\n");
-                    json_value_free(root_val);
                     continue;
                 }
                 if      (strcmp(str, "4/5") == 0) txpkt.coderate = CR_LORA_4_5;
@@ -3252,20 +3876,17 @@ void thread_down(void)
                 else if (strcmp(str, "1/2") == 0) txpkt.coderate = CR_LORA_4_8;
                 else {
                     MSG("WARNING: [down] format error in \"txpk.codr\", TX aborted\n");
-                    json_value_free(root_val);
                     continue;
                 }
 
                 /* Parse signal polarity switch (optional field) */
-                val = json_object_get_value(txpk_obj,"ipol");
-                if (val != NULL) {
-                    txpkt.invert_pol = (bool)json_value_get_boolean(val);
+                if (txpk_json_has(&txpk, TXPK_IPOL) == true) {
+                    txpkt.invert_pol = (bool)txpk_json_boolean(&txpk, TXPK_IPOL);
                 }
 
                 /* parse Lora preamble length (optional field, optimum min value enforced) */
-                val = json_object_get_value(txpk_obj,"prea");
-                if (val != NULL) {
-                    i = (int)json_value_get_number(val);
+                if (txpk_json_has(&txpk, TXPK_PREA) == true) {
+                    i = (int)txpk_json_number(&txpk, TXPK_PREA);
                     if (i >= MIN_LORA_PREAMB) {
                         txpkt.preamble = (uint16_t)i;
                     } else {
@@ -3280,27 +3901,22 @@ void thread_down(void)
                 txpkt.modulation = MOD_FSK;
 
                 /* parse FSK bitrate (mandatory) */
-                val = json_object_get_value(txpk_obj,"datr");
-                if (val == NULL) {
+                if (txpk_json_has(&txpk, TXPK_DATR) == false) {
                     MSG("WARNING: [down] no mandatory \"txpk.datr\" object in JSON, TX aborted\n");
-                    json_value_free(root_val);
                     continue;
                 }
-                txpkt.datarate = (uint32_t)(json_value_get_number(val));
+                txpkt.datarate = (uint32_t)(txpk_json_number(&txpk, TXPK_DATR));
 
                 /* parse frequency deviation (mandatory) */
-                val = json_object_get_value(txpk_obj,"fdev");
-                if (val == NULL) {
+                if (txpk_json_has(&txpk, TXPK_FDEV) == false) {
                     MSG("WARNING: [down] no mandatory \"txpk.fdev\" object in JSON, TX aborted\n");
-                    json_value_free(root_val);
                     continue;
                 }
-                txpkt.f_dev = (uint8_t)(json_value_get_number(val) / 1000.0); /* JSON value in Hz, txpkt.f_dev in kHz */
+                txpkt.f_dev = (uint8_t)(txpk_json_number(&txpk, TXPK_FDEV) / 1000.0); /* JSON value in Hz, txpkt.f_dev in kHz */
 
                 /* parse FSK preamble length (optional field, optimum min value enforced) */
-                val = json_object_get_value(txpk_obj,"prea");
-                if (val != NULL) {
-                    i = (int)json_value_get_number(val);
+                if (txpk_json_has(&txpk, TXPK_PREA) == true) {
+                    i = (int)txpk_json_number(&txpk, TXPK_PREA);
                     if (i >= MIN_FSK_PREAMB) {
                         txpkt.preamble = (uint16_t)i;
                     } else {
@@ -3312,24 +3928,20 @@ void thread_down(void)
 
             } else {
                 MSG("WARNING: [down] invalid modulation in \"txpk.modu\", TX aborted\n");
-                json_value_free(root_val);
                 continue;
             }
 
             /* Parse payload length (mandatory) */
-            val = json_object_get_value(txpk_obj,"size");
-            if (val == NULL) {
+            if (txpk_json_has(&txpk, TXPK_SIZE) == false) {
                 MSG("WARNING: [down] no mandatory \"txpk.size\" object in JSON, TX aborted\n");
-                json_value_free(root_val);
                 continue;
             }
-            txpkt.size = (uint16_t)json_value_get_number(val);
+            txpkt.size = (uint16_t)txpk_json_number(&txpk, TXPK_SIZE);
 
             /* Parse payload data (mandatory) */
-            str = json_object_get_string(txpk_obj, "data");
+            str = txpk_json_string(&txpk, TXPK_DATA);
             if (str == NULL) {
                 MSG("WARNING: [down] no mandatory \"txpk.data\" object in JSON, TX aborted\n");
-                json_value_free(root_val);
                 continue;
             }
             i = b64_to_bin(str, strlen(str), txpkt.payload, sizeof txpkt.payload);
@@ -3337,9 +3949,6 @@ void thread_down(void)
                 MSG("WARNING: [down] mismatch between .size and .data size once converter to binary\n");
             }
 
-            /* free the JSON parse tree from memory */
-            json_value_free(root_val);
-
             /* select TX mode */
             if (sent_immediate) {
                 txpkt.tx_mode = IMMEDIATE;
@@ -3348,11 +3957,11 @@ void thread_down(void)
             }
 
             /* record measurement data */
-            xSemaphoreTake(mx_meas_dw, portMAX_DELAY);
-            meas_dw_dgram_rcv += 1; /* count only datagrams with no JSON errors */
-            meas_dw_network_byte += msg_len; /* meas_dw_network_byte */
-            meas_dw_payload_byte += txpkt.size;
-            xSemaphoreGive(mx_meas_dw);
+            stats_begin(&meas_dw.seq);
+            meas_dw.dgram_rcv += 1; /* count only datagrams with no JSON errors */
+            meas_dw.network_byte += msg_len; /* meas_dw.network_byte */
+            meas_dw.payload_byte += txpkt.size;
+            stats_end(&meas_dw.seq);
 
             /* reset error/warning results */
             jit_result = warning_result = JIT_ERROR_OK;
@@ -3385,18 +3994,20 @@ void thread_down(void)
                 if (jit_result != JIT_ERROR_OK) {
                     printf("ERROR: Packet REJECTED (jit error=%d)\n", jit_result);
                 } else {
+                    wake_jit();
                     /* In case of a warning having been raised before, we notify it */
                     jit_result = warning_result;
                 }
-                xSemaphoreTake(mx_meas_dw, portMAX_DELAY);
-                meas_nb_tx_requested += 1;
-                xSemaphoreGive(mx_meas_dw);
+                stats_begin(&meas_dw.seq);
+                meas_dw.tx_requested += 1;
+                stats_end(&meas_dw.seq);
             }
 
             /* Send acknoledge datagram to server */
-            send_tx_ack(buff_down[1], buff_down[2], jit_result, warning_value);
+            send_tx_ack(s->sock_down, &source_addr, buff_down[1], buff_down[2], jit_result, warning_value);
         }
     }
+    wake_jit(); /* for it to see the exit */
     MSG("\nINFO: End of downstream thread\n");
 }
 
@@ -3425,6 +4036,38 @@ void print_tx_status(uint8_t tx_status)
 /* -------------------------------------------------------------------------- */
 /* --- THREAD 3: CHECKING PACKETS TO BE SENT FROM JIT QUEUE AND SEND THEM --- */
 
+/* Wake thread_jit up, for it to look again at the JiT queues */
+static void wake_jit(void) {
+    if (pJit != NULL) {
+        xTaskNotifyGive(pJit);
+    }
+}
+
+static void jit_timer_cb(void * arg) {
+    xTaskNotifyGive((TaskHandle_t)arg);
+}
+
+/* Read the concentrator counter, and take it as reference of the extrapolated one */
+static uint32_t jit_read_counter(struct cntclock_s * clock) {
+    uint32_t count_us;
+    int64_t t0;
+
+    xSemaphoreTake(mx_concent, portMAX_DELAY);
+    t0 = esp_timer_get_time();
+    lgw_get_instcnt(&count_us);
+    cntclock_sync(clock, count_us, (t0 + esp_timer_get_time()) / 2);
+    xSemaphoreGive(mx_concent);
+    stats_begin(&meas_jit.seq);
+    meas_jit.cnt_read += 1;
+    stats_end(&meas_jit.seq);
+
+    return count_us;
+}
+
+/* The first packet in time of both queues sets a timer, JIT_DISPATCH_LEAD_US before
+   it is due on the counter extrapolated from esp_timer. The thread sleeps until the
+   timer fires, or until thread_down enqueues a packet which may come first. With
+   both queues empty, it sleeps until a packet is enqueued. */
 void thread_jit(void)
 {
     int result = LGW_HAL_SUCCESS;
@@ -3435,21 +4078,69 @@ void thread_jit(void)
     enum jit_pkt_type_e pkt_type;
     uint8_t tx_status;
     int i;
+    struct cntclock_s clock = { .valid = false };
+    const esp_timer_create_args_t timer_args = {
+            .callback = &jit_timer_cb,
+            .arg = xTaskGetCurrentTaskHandle(),
+            .name = "jit"
+    };
+    esp_timer_handle_t timer;
+    bool head_found;
+    uint32_t head_count_us, count_us, jitter;
+    int64_t now, wake_time;
+
+    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &timer));
 
     while (!exit_sig && !quit_sig) {
-        //wait_ms(10);
-        vTaskDelay(10 / portTICK_PERIOD_MS);
+        /* first packet in time, on any RF chain */
+        head_found = false;
+        for (i = 0; i < LGW_RF_CHAIN_NB; i++) {
+            if ((jit_queue_head(&jit_queue[i], &count_us) == true) && ((head_found == false) || ((int32_t)(count_us - head_count_us) < 0))) {
+                head_count_us = count_us;
+                head_found = true;
+            }
+        }
+        if (head_found == false) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        /* sleep until it is due, the counter being read again once in a while */
+        now = esp_timer_get_time();
+        if ((clock.valid == false) || ((now - clock.local_us) > JIT_CLOCK_MAX_AGE_US)) {
+            jit_read_counter(&clock);
+            now = esp_timer_get_time();
+        }
+        wake_time = cntclock_local(&clock, head_count_us - JIT_DISPATCH_LEAD_US);
+        if (wake_time > (clock.local_us + JIT_CLOCK_MAX_AGE_US)) {
+            wake_time = clock.local_us + JIT_CLOCK_MAX_AGE_US;
+        }
+        if (wake_time > now) {
+            esp_timer_start_once(timer, wake_time - now);
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            esp_timer_stop(timer); /* in case a packet was enqueued first */
+            continue;
+        }
 
         for (i = 0; i < LGW_RF_CHAIN_NB; i++) {
             /* transfer data and metadata to the concentrator, and schedule TX */
-            xSemaphoreTake(mx_concent, portMAX_DELAY);
-            lgw_get_instcnt(&current_concentrator_time);
-            xSemaphoreGive(mx_concent);
+            if (jit_queue_head(&jit_queue[i], &count_us) == false) {
+                continue; /* no need to read the counter for an empty queue */
+            }
+            current_concentrator_time = jit_read_counter(&clock);
             jit_result = jit_peek(&jit_queue[i], current_concentrator_time, &pkt_index);
             if (jit_result == JIT_ERROR_OK) {
                 if (pkt_index > -1) {
                     jit_result = jit_dequeue(&jit_queue[i], pkt_index, &pkt, &pkt_type);
                     if (jit_result == JIT_ERROR_OK) {
+                        /* lead time error, timer and task switch latency */
+                        jitter = abs((int32_t)(pkt.count_us - current_concentrator_time) - JIT_DISPATCH_LEAD_US);
+                        stats_begin(&meas_jit.seq);
+                        meas_jit.dispatch_nb += 1;
+                        meas_jit.jitter_sum += jitter;
+                        stats_max(&meas_jit.jitter_max, jitter);
+                        stats_end(&meas_jit.seq);
+
                         /* update beacon stats */
                         if (pkt_type == JIT_PKT_TYPE_BEACON) {
                             /* Compensate breacon frequency with xtal error */
@@ -3459,9 +4150,9 @@ void thread_jit(void)
                             xSemaphoreGive(mx_xcorr);
 
                             /* Update statistics */
-                            xSemaphoreTake(mx_meas_dw, portMAX_DELAY);
-                            meas_nb_beacon_sent += 1;
-                            xSemaphoreGive(mx_meas_dw);
+                            stats_begin(&meas_jit.seq);
+                            meas_jit.beacon_sent += 1;
+                            stats_end(&meas_jit.seq);
                             MSG("INFO: Beacon dequeued (count_us=%u)\n", pkt.count_us);
                         }
 
@@ -3495,15 +4186,15 @@ void thread_jit(void)
                         result = lgw_send(&pkt);
                         xSemaphoreGive(mx_concent); /* free concentrator ASAP */
                         if (result != LGW_HAL_SUCCESS) {
-                            xSemaphoreTake(mx_meas_dw, portMAX_DELAY);
-                            meas_nb_tx_fail += 1;
-                            xSemaphoreGive(mx_meas_dw);
+                            stats_begin(&meas_jit.seq);
+                            meas_jit.tx_fail += 1;
+                            stats_end(&meas_jit.seq);
                             MSG("WARNING: [jit] lgw_send failed on rf_chain %d\n", i);
                             continue;
                         } else {
-                            xSemaphoreTake(mx_meas_dw, portMAX_DELAY);
-                            meas_nb_tx_ok += 1;
-                            xSemaphoreGive(mx_meas_dw);
+                            stats_begin(&meas_jit.seq);
+                            meas_jit.tx_ok += 1;
+                            stats_end(&meas_jit.seq);
                             MSG_DEBUG(DEBUG_PKT_FWD, "lgw_send done on rf_chain %d: count_us=%u\n", i, pkt.count_us);
                             vDownlinkFlash( 10 );
                         }
@@ -3518,6 +4209,8 @@ void thread_jit(void)
             }
         }
     }
+    esp_timer_stop(timer);
+    esp_timer_delete(timer);
     vTaskDelete( pJit );
     MSG("\nINFO: End of JIT thread\n");
 }
@@ -4115,6 +4808,129 @@ void read_config_from_nvs(void)
 }
 
 
+static const char * upfilter_mode_str(int mode) {
+    return (mode == UPFILTER_ALLOW) ? "allow" : ((mode == UPFILTER_DENY) ? "deny" : "off");
+}
+
+static void print_upfilter(const struct upfilter_s * f) {
+    int i;
+
+    MSG("INFO: uplink filter on DevAddr: %s, %d range(s)\n", upfilter_mode_str(f->devaddr_mode), f->range_nb);
+    for (i = 0; i < f->range_nb; i++) {
+        MSG("INFO:     %08X-%08X\n", f->range[i].first, f->range[i].last);
+    }
+    MSG("INFO: uplink filter on JoinEUI: %s, %d EUI(s)\n", upfilter_mode_str(f->joineui_mode), f->eui_nb);
+    for (i = 0; i < f->eui_nb; i++) {
+        MSG("INFO:     %016llX\n", (unsigned long long)f->eui[i]);
+    }
+}
+
+static struct {
+    struct arg_lit *clear;
+    struct arg_str *devaddr_mode;
+    struct arg_str *netid;
+    struct arg_str *devaddr;
+    struct arg_str *joineui_mode;
+    struct arg_str *joineui;
+    struct arg_end *end;
+} upfilter_args;
+
+/* Change the uplink filter of the running packet forwarder, the configuration file is not modified */
+static int do_upfilter_cmd(int argc, char **argv)
+{
+    static struct upfilter_s f; /* new filter, built off the one in use */
+    const char *err = NULL;
+    int nerrors;
+    int i;
+
+    nerrors = arg_parse(argc, argv, (void **)&upfilter_args);
+    if (nerrors != 0) {
+        arg_print_errors(stderr, upfilter_args.end, argv[0]);
+        return 1;
+    }
+    if (mx_upfilter == NULL) {
+        printf("packet forwarder not started\n");
+        return 1;
+    }
+
+    xSemaphoreTake(mx_upfilter, portMAX_DELAY);
+    f = upfilter;
+    xSemaphoreGive(mx_upfilter);
+
+    if (upfilter_args.clear->count > 0) {
+        upfilter_clear(&f);
+    }
+    if ((upfilter_args.devaddr_mode->count > 0) && (upfilter_set_mode(&f.devaddr_mode, upfilter_args.devaddr_mode->sval[0]) != 0)) {
+        err = upfilter_args.devaddr_mode->sval[0];
+    }
+    if ((upfilter_args.joineui_mode->count > 0) && (upfilter_set_mode(&f.joineui_mode, upfilter_args.joineui_mode->sval[0]) != 0)) {
+        err = upfilter_args.joineui_mode->sval[0];
+    }
+    for (i = 0; (i < upfilter_args.netid->count) && (err == NULL); i++) {
+        if (upfilter_add_netid(&f, upfilter_args.netid->sval[i]) != 0) {
+            err = upfilter_args.netid->sval[i];
+        }
+    }
+    for (i = 0; (i < upfilter_args.devaddr->count) && (err == NULL); i++) {
+        if (upfilter_add_devaddr(&f, upfilter_args.devaddr->sval[i]) != 0) {
+            err = upfilter_args.devaddr->sval[i];
+        }
+    }
+    for (i = 0; (i < upfilter_args.joineui->count) && (err == NULL); i++) {
+        if (upfilter_add_joineui(&f, upfilter_args.joineui->sval[i]) != 0) {
+            err = upfilter_args.joineui->sval[i];
+        }
+    }
+    if (err != NULL) {
+        printf("invalid value or list full: \"%s\", uplink filter not changed\n", err);
+        return 1;
+    }
+
+    /* thread_up takes its copy on its next fetch */
+    xSemaphoreTake(mx_upfilter, portMAX_DELAY);
+    upfilter = f;
+    __atomic_store_n(&upfilter_gen, upfilter_gen + 1, __ATOMIC_RELEASE);
+    xSemaphoreGive(mx_upfilter);
+    print_upfilter(&f);
+
+    return 0;
+}
+
+static struct {
+    struct arg_str *module;
+    struct arg_str *level;
+    struct arg_end *end;
+} log_level_args;
+
+/* Change the log level of a module, or show the levels and the messages dropped */
+static int do_log_level_cmd(int argc, char **argv)
+{
+    const char *name, *level;
+    uint32_t dropped;
+    int nerrors;
+    int i;
+
+    nerrors = arg_parse(argc, argv, (void **)&log_level_args);
+    if (nerrors != 0) {
+        arg_print_errors(stderr, log_level_args.end, argv[0]);
+        return 1;
+    }
+
+    if (log_level_args.level->count > 0) {
+        name = (log_level_args.module->count > 0) ? log_level_args.module->sval[0] : "all";
+        if (trace_set_level(name, log_level_args.level->sval[0]) != 0) {
+            printf("invalid module \"%s\" or level \"%s\"\n", name, log_level_args.level->sval[0]);
+            return 1;
+        }
+    }
+    for (i = 0; i < TRACE_MOD_NB; i++) {
+        dropped = trace_get_module(i, &name, &level);
+        printf("%-5s %-8s %u dropped\n", name, level, dropped);
+    }
+
+    return 0;
+}
+
 static struct {
     struct arg_lit *help;
     struct arg_str *wifi_ssid;
@@ -4238,6 +5054,36 @@ static void register_config(void)
         .argtable = &net_conf_args
     };
     ESP_ERROR_CHECK(esp_console_cmd_register(&hal_conf_cmd));
+
+    upfilter_args.clear        = arg_lit0("c", "clear", "remove all the rules first");
+    upfilter_args.devaddr_mode = arg_str0(NULL, "devaddr_mode", "<off|allow|deny>", "use of the DevAddr list");
+    upfilter_args.netid        = arg_strn(NULL, "netid", "<NetID>", 0, UPFILTER_RANGE_MAX, "add the DevAddr range of a NetID (hex)");
+    upfilter_args.devaddr      = arg_strn(NULL, "devaddr", "<first-last>", 0, UPFILTER_RANGE_MAX, "add a DevAddr range (hex)");
+    upfilter_args.joineui_mode = arg_str0(NULL, "joineui_mode", "<off|allow|deny>", "use of the JoinEUI list");
+    upfilter_args.joineui      = arg_strn(NULL, "joineui", "<JoinEUI>", 0, UPFILTER_EUI_MAX, "add a JoinEUI (hex)");
+    upfilter_args.end = arg_end(4);
+
+    const esp_console_cmd_t upfilter_cmd = {
+        .command = "uplink_filter",
+        .help = "Show or change the uplink filter on DevAddr and JoinEUI, until the next restart",
+        .hint = NULL,
+        .func = &do_upfilter_cmd,
+        .argtable = &upfilter_args
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&upfilter_cmd));
+
+    log_level_args.module = arg_str0("m", "module", "<main|up|down|jit|gps|all>", "module, all by default");
+    log_level_args.level  = arg_str0("l", "level", "<error|warning|info|debug>", "messages above this level are not logged");
+    log_level_args.end = arg_end(2);
+
+    const esp_console_cmd_t log_level_cmd = {
+        .command = "log_level",
+        .help = "Show or change the log level of the packet forwarder modules",
+        .hint = NULL,
+        .func = &do_log_level_cmd,
+        .argtable = &log_level_args
+    };
+    ESP_ERROR_CHECK(esp_console_cmd_register(&log_level_cmd));
 }
 
 void app_main(void)
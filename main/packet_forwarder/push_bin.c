@@ -0,0 +1,310 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    LoRa concentrator : binary PUSH_DATA encoding (protocol version 3)
+    All fields are little endian, values are rounded as in the JSON objects.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+
+#include <string.h>     /* memcpy, memset */
+#include <math.h>       /* roundf, lrint */
+
+#include "push_bin.h"
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE FUNCTIONS DEFINITION ----------------------------------------- */
+
+static inline void put_u16(uint8_t * b, uint16_t v) {
+    b[0] = (uint8_t)v;
+    b[1] = (uint8_t)(v >> 8);
+}
+
+static inline void put_u32(uint8_t * b, uint32_t v) {
+    b[0] = (uint8_t)v;
+    b[1] = (uint8_t)(v >> 8);
+    b[2] = (uint8_t)(v >> 16);
+    b[3] = (uint8_t)(v >> 24);
+}
+
+static inline void put_u64(uint8_t * b, uint64_t v) {
+    put_u32(b, (uint32_t)v);
+    put_u32(b + 4, (uint32_t)(v >> 32));
+}
+
+static inline uint16_t get_u16(const uint8_t * b) {
+    return (uint16_t)(b[0] | (b[1] << 8));
+}
+
+static inline uint32_t get_u32(const uint8_t * b) {
+    return (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+}
+
+static inline uint64_t get_u64(const uint8_t * b) {
+    return (uint64_t)get_u32(b) | ((uint64_t)get_u32(b + 4) << 32);
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+/* Saturate to the int16 range, v being already rounded */
+static int16_t to_i16(double v) {
+    if (v > INT16_MAX) {
+        return INT16_MAX;
+    } else if (v < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)v;
+}
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS DEFINITION ------------------------------------------ */
+
+int push_bin_write_rxpk(const struct lgw_pkt_rx_desc_s * p, const struct timespec * utc_time, const uint64_t * gps_time_ms, uint8_t * buf, int size) {
+    uint8_t flags = 0;
+    int len = PUSH_BIN_RXPK_FIXED;
+
+    if (utc_time != NULL) {
+        flags |= PUSH_BIN_RXPK_TIME;
+        len += 8;
+    }
+    if (gps_time_ms != NULL) {
+        flags |= PUSH_BIN_RXPK_TMMS;
+        len += 8;
+    }
+    if (p->ftime_received == true) {
+        flags |= PUSH_BIN_RXPK_FTIME;
+        len += 4;
+    }
+    len += p->size;
+    if ((len > size) || (p->size > 255)) {
+        return -1;
+    }
+
+    buf[1] = p->if_chain;
+    buf[2] = p->rf_chain;
+    buf[3] = p->modem_id;
+    switch (p->status) {
+        case STAT_CRC_OK:
+            buf[4] = 1;
+            break;
+        case STAT_CRC_BAD:
+            buf[4] = (uint8_t)-1;
+            break;
+        case STAT_NO_CRC:
+            buf[4] = 0;
+            break;
+        default:
+            return -1;
+    }
+    put_u32(buf + 8, p->count_us);
+    put_u32(buf + 12, p->freq_hz);
+    put_u16(buf + 20, (uint16_t)to_i16(roundf(p->rssic)));
+
+    if (p->modulation == MOD_LORA) {
+        if ((p->datarate < DR_LORA_SF5) || (p->datarate > DR_LORA_SF12) || (p->coderate > CR_LORA_4_8)) {
+            return -1;
+        }
+        buf[5] = (uint8_t)p->datarate;
+        switch (p->bandwidth) {
+            case BW_125KHZ:
+                buf[6] = 1;
+                break;
+            case BW_250KHZ:
+                buf[6] = 2;
+                break;
+            case BW_500KHZ:
+                buf[6] = 3;
+                break;
+            default:
+                return -1;
+        }
+        buf[7] = p->coderate;
+        put_u32(buf + 16, (uint32_t)p->freq_offset);
+        put_u16(buf + 22, (uint16_t)to_i16(roundf(p->rssis)));
+        put_u16(buf + 24, (uint16_t)to_i16(rint((double)p->snr * 10))); /* exact product, ties to even as "%.1f" */
+    } else if (p->modulation == MOD_FSK) {
+        flags |= PUSH_BIN_RXPK_FSK;
+        buf[5] = 0;
+        buf[6] = 0;
+        buf[7] = 0;
+        put_u32(buf + 16, p->datarate);
+        put_u16(buf + 22, 0);
+        put_u16(buf + 24, 0);
+    } else {
+        return -1;
+    }
+    buf[0] = flags;
+    buf[26] = (uint8_t)p->size;
+
+    len = PUSH_BIN_RXPK_FIXED;
+    if (utc_time != NULL) {
+        put_u64(buf + len, (uint64_t)utc_time->tv_sec * 1000000 + utc_time->tv_nsec / 1000);
+        len += 8;
+    }
+    if (gps_time_ms != NULL) {
+        put_u64(buf + len, *gps_time_ms);
+        len += 8;
+    }
+    if (p->ftime_received == true) {
+        put_u32(buf + len, p->ftime);
+        len += 4;
+    }
+    memcpy(buf + len, p->payload, p->size);
+    len += p->size;
+
+    return len;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+int push_bin_write_stat(const struct push_bin_stat_s * s, uint8_t * buf, int size) {
+    int len = (s->coord == true) ? PUSH_BIN_STAT_MAX : (PUSH_BIN_STAT_MAX - 12);
+
+    if (len > size) {
+        return -1;
+    }
+    buf[0] = (s->coord == true) ? PUSH_BIN_STAT_COORD : 0;
+    put_u32(buf + 1, s->time);
+    put_u32(buf + 5, s->rxnb);
+    put_u32(buf + 9, s->rxok);
+    put_u32(buf + 13, s->rxfw);
+    put_u16(buf + 17, (uint16_t)lrint((double)s->ackr * 10));
+    put_u32(buf + 19, s->dwnb);
+    put_u32(buf + 23, s->txnb);
+    put_u16(buf + 27, (uint16_t)to_i16(rint((double)s->temp * 10)));
+    if (s->coord == true) {
+        put_u32(buf + 29, (uint32_t)(int32_t)lrint(s->lati * 1e5));
+        put_u32(buf + 33, (uint32_t)(int32_t)lrint(s->longi * 1e5));
+        put_u32(buf + 37, (uint32_t)s->alti);
+    }
+
+    return len;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+int push_bin_read_rxpk(const uint8_t * buf, int size, struct push_bin_rxpk_s * r) {
+    struct lgw_pkt_rx_desc_s * p = &r->pkt;
+    uint8_t flags;
+    uint64_t us;
+    int len = PUSH_BIN_RXPK_FIXED;
+
+    if (size < PUSH_BIN_RXPK_FIXED) {
+        return -1;
+    }
+    flags = buf[0];
+    len += ((flags & PUSH_BIN_RXPK_TIME) ? 8 : 0) + ((flags & PUSH_BIN_RXPK_TMMS) ? 8 : 0) + ((flags & PUSH_BIN_RXPK_FTIME) ? 4 : 0);
+    if ((len + buf[26]) > size) {
+        return -1;
+    }
+
+    memset(r, 0, sizeof *r);
+    p->if_chain = buf[1];
+    p->rf_chain = buf[2];
+    p->modem_id = buf[3];
+    switch ((int8_t)buf[4]) {
+        case 1:
+            p->status = STAT_CRC_OK;
+            break;
+        case -1:
+            p->status = STAT_CRC_BAD;
+            break;
+        case 0:
+            p->status = STAT_NO_CRC;
+            break;
+        default:
+            return -1;
+    }
+    p->count_us = get_u32(buf + 8);
+    p->freq_hz = get_u32(buf + 12);
+    p->rssic = (int16_t)get_u16(buf + 20);
+    if (flags & PUSH_BIN_RXPK_FSK) {
+        p->modulation = MOD_FSK;
+        p->datarate = get_u32(buf + 16);
+    } else {
+        p->modulation = MOD_LORA;
+        p->datarate = buf[5];
+        switch (buf[6]) {
+            case 1:
+                p->bandwidth = BW_125KHZ;
+                break;
+            case 2:
+                p->bandwidth = BW_250KHZ;
+                break;
+            case 3:
+                p->bandwidth = BW_500KHZ;
+                break;
+            default:
+                return -1;
+        }
+        p->coderate = buf[7];
+        p->freq_offset = (int32_t)get_u32(buf + 16);
+        p->rssis = (int16_t)get_u16(buf + 22);
+        p->snr = (float)(int16_t)get_u16(buf + 24) / 10;
+    }
+    p->size = buf[26];
+
+    len = PUSH_BIN_RXPK_FIXED;
+    if (flags & PUSH_BIN_RXPK_TIME) {
+        us = get_u64(buf + len);
+        r->utc_valid = true;
+        r->utc_time.tv_sec = (time_t)(us / 1000000);
+        r->utc_time.tv_nsec = (long)(us % 1000000) * 1000;
+        len += 8;
+    }
+    if (flags & PUSH_BIN_RXPK_TMMS) {
+        r->gps_valid = true;
+        r->gps_time_ms = get_u64(buf + len);
+        len += 8;
+    }
+    if (flags & PUSH_BIN_RXPK_FTIME) {
+        p->ftime_received = true;
+        p->ftime = get_u32(buf + len);
+        len += 4;
+    }
+    p->payload = (uint8_t *)(buf + len);
+    len += p->size;
+
+    return len;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+int push_bin_read_stat(const uint8_t * buf, int size, struct push_bin_stat_s * s) {
+    int len;
+
+    if (size < 1) {
+        return -1;
+    }
+    len = (buf[0] & PUSH_BIN_STAT_COORD) ? PUSH_BIN_STAT_MAX : (PUSH_BIN_STAT_MAX - 12);
+    if (len > size) {
+        return -1;
+    }
+
+    memset(s, 0, sizeof *s);
+    s->time = get_u32(buf + 1);
+    s->rxnb = get_u32(buf + 5);
+    s->rxok = get_u32(buf + 9);
+    s->rxfw = get_u32(buf + 13);
+    s->ackr = (float)get_u16(buf + 17) / 10;
+    s->dwnb = get_u32(buf + 19);
+    s->txnb = get_u32(buf + 23);
+    s->temp = (float)(int16_t)get_u16(buf + 27) / 10;
+    if (buf[0] & PUSH_BIN_STAT_COORD) {
+        s->coord = true;
+        s->lati = (int32_t)get_u32(buf + 29) / 1e5;
+        s->longi = (int32_t)get_u32(buf + 33) / 1e5;
+        s->alti = (int32_t)get_u32(buf + 37);
+    }
+
+    return len;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,115 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    LoRa concentrator : binary PUSH_DATA encoding (protocol version 3),
+    see PROTOCOL_BINARY.md for the layout
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+
+#ifndef _LORA_PKTFWD_PUSH_BIN_H
+#define _LORA_PKTFWD_PUSH_BIN_H
+
+
+#include <stdint.h>     /* C99 types */
+#include <stdbool.h>    /* bool type */
+#include <time.h>       /* timespec */
+
+#include "loragw_hal.h"
+
+
+#define PROTOCOL_VERSION_BINARY 3   /* PUSH_DATA with a binary payload, PUSH_ACK acknowledging it */
+
+#define PUSH_BIN_BODY_HEADER    2   /* number of rxpk records, stat record present */
+#define PUSH_BIN_RXPK_FIXED     27  /* rxpk record without the optional fields and the payload */
+#define PUSH_BIN_RXPK_MAX       (PUSH_BIN_RXPK_FIXED + 8 + 8 + 4 + 255)
+#define PUSH_BIN_STAT_MAX       41  /* stat record with the coordinates */
+
+/* rxpk record flags */
+#define PUSH_BIN_RXPK_TIME      0x01    /* "time" field present */
+#define PUSH_BIN_RXPK_TMMS      0x02    /* "tmms" field present */
+#define PUSH_BIN_RXPK_FTIME     0x04    /* "ftime" field present */
+#define PUSH_BIN_RXPK_FSK       0x08    /* FSK packet, LoRa otherwise */
+
+/* stat record flags */
+#define PUSH_BIN_STAT_COORD     0x01    /* "lati", "long" & "alti" fields present */
+
+/* Status report, as sent in the JSON "stat" object */
+struct push_bin_stat_s {
+    bool        coord;      /* coordinates valid */
+    uint32_t    time;       /* UNIX time of the report, UTC */
+    double      lati;       /* latitude, in degrees */
+    double      longi;      /* longitude, in degrees */
+    int32_t     alti;       /* altitude, in meters */
+    uint32_t    rxnb;       /* RF packets received */
+    uint32_t    rxok;       /* RF packets received with a valid CRC */
+    uint32_t    rxfw;       /* RF packets forwarded */
+    float       ackr;       /* upstream datagrams acknowledged, in % */
+    uint32_t    dwnb;       /* downlink datagrams received */
+    uint32_t    txnb;       /* packets emitted */
+    float       temp;       /* concentrator temperature, in C */
+};
+
+/* Decoded rxpk record, fields have the precision of the JSON ones */
+struct push_bin_rxpk_s {
+    struct lgw_pkt_rx_desc_s pkt;   /* payload points into the datagram */
+    bool        utc_valid;
+    struct timespec utc_time;
+    bool        gps_valid;
+    uint64_t    gps_time_ms;
+};
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS PROTOTYPES ------------------------------------------ */
+
+/**
+@brief Encode a received packet as a binary rxpk record.
+
+@param p[in] Packet to be encoded.
+@param utc_time[in] UTC time of the packet, NULL if unknown.
+@param gps_time_ms[in] GPS time of the packet in ms since 06.Jan.1980, NULL if unknown.
+@param buf[out] Where the record is written.
+@param size[in] Room available in buf, in bytes.
+@return Number of bytes written, -1 if the packet has an invalid field or does not fit in buf.
+*/
+int push_bin_write_rxpk(const struct lgw_pkt_rx_desc_s * p, const struct timespec * utc_time, const uint64_t * gps_time_ms, uint8_t * buf, int size);
+
+/**
+@brief Encode a status report as a binary stat record.
+
+@param s[in] Status report to be encoded.
+@param buf[out] Where the record is written.
+@param size[in] Room available in buf, in bytes.
+@return Number of bytes written, -1 if it does not fit in buf.
+*/
+int push_bin_write_stat(const struct push_bin_stat_s * s, uint8_t * buf, int size);
+
+/**
+@brief Decode a binary rxpk record.
+
+@param buf[in] Record to be decoded.
+@param size[in] Bytes available from buf.
+@param r[out] Decoded packet.
+@return Number of bytes of the record, -1 if it is invalid or truncated.
+*/
+int push_bin_read_rxpk(const uint8_t * buf, int size, struct push_bin_rxpk_s * r);
+
+/**
+@brief Decode a binary stat record.
+
+@param buf[in] Record to be decoded.
+@param size[in] Bytes available from buf.
+@param s[out] Decoded status report.
+@return Number of bytes of the record, -1 if it is truncated.
+*/
+int push_bin_read_stat(const uint8_t * buf, int size, struct push_bin_stat_s * s);
+
+#endif
+/* --- EOF ------------------------------------------------------------------ */
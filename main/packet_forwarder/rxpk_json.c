@@ -0,0 +1,440 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    LoRa concentrator : JSON serialization of the received packets (rxpk)
+    Fields are written with precomputed literals and integer-only number
+    formatting, rounding the floats exactly as printf() does, so that the
+    output is the one of the former snprintf() chain.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+
+#include <stdio.h>      /* snprintf */
+#include <string.h>     /* memcpy */
+#include <math.h>       /* roundf */
+
+#include "rxpk_json.h"
+#include "base64.h"
+
+
+#define STR_HELPER(x)   #x
+#define STR(x)          STR_HELPER(x)
+
+#define B64_MAX_LEN     341     /* 255 bytes = 340 chars in b64 + null char */
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE TYPES -------------------------------------------------------- */
+
+/* Write cursor, once a field did not fit nothing more is written */
+typedef struct {
+    char * pos;
+    char * end;
+    bool error;
+} rxpk_cursor_t;
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE VARIABLES ---------------------------------------------------- */
+
+static const char digits_lut[200] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/* datarate fields, indexed by spreading factor, bandwidth appended */
+static const char * const lora_datr[13] = {
+    NULL, NULL, NULL, NULL, NULL,
+    ",\"datr\":\"SF5", ",\"datr\":\"SF6", ",\"datr\":\"SF7", ",\"datr\":\"SF8",
+    ",\"datr\":\"SF9", ",\"datr\":\"SF10", ",\"datr\":\"SF11", ",\"datr\":\"SF12"
+};
+
+/* coding rate fields, indexed by coding rate, CR 0 is mostly false sync */
+static const char * const lora_codr[5] = {
+    ",\"codr\":\"OFF\"", ",\"codr\":\"4/5\"", ",\"codr\":\"4/6\"", ",\"codr\":\"4/7\"", ",\"codr\":\"4/8\""
+};
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE FUNCTIONS DEFINITION ----------------------------------------- */
+
+static inline void put_fail(rxpk_cursor_t * c) {
+    c->error = true;
+    c->end = c->pos;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+static inline void put_mem(rxpk_cursor_t * c, const char * s, int n) {
+    if ((c->end - c->pos) < n) {
+        put_fail(c);
+        return;
+    }
+    memcpy(c->pos, s, n);
+    c->pos += n;
+}
+
+#define PUT_LIT(c, s)   put_mem((c), (s), sizeof(s) - 1)
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+static inline void put_char(rxpk_cursor_t * c, char ch) {
+    if (c->pos >= c->end) {
+        put_fail(c);
+        return;
+    }
+    *(c->pos++) = ch;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+/* Write n in decimal at the end of tmp, padded with zeros to min_digits, return the first char */
+static char * fmt_u64(char * tmp_end, uint64_t n, int min_digits) {
+    char * s = tmp_end;
+    uint32_t r;
+
+    while (n >= 100) {
+        r = (uint32_t)(n % 100);
+        n /= 100;
+        s -= 2;
+        memcpy(s, &digits_lut[2 * r], 2);
+    }
+    if (n >= 10) {
+        s -= 2;
+        memcpy(s, &digits_lut[2 * n], 2);
+    } else {
+        *(--s) = (char)('0' + n);
+    }
+    while ((tmp_end - s) < min_digits) {
+        *(--s) = '0';
+    }
+
+    return s;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+static inline void put_u64(rxpk_cursor_t * c, uint64_t n, int min_digits) {
+    char tmp[24];
+    char * s;
+
+    s = fmt_u64(tmp + sizeof tmp, n, min_digits);
+    put_mem(c, s, (int)(tmp + sizeof tmp - s));
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+static inline void put_i32(rxpk_cursor_t * c, int32_t n) {
+    if (n < 0) {
+        put_char(c, '-');
+        put_u64(c, (uint64_t)(-(int64_t)n), 1);
+    } else {
+        put_u64(c, (uint64_t)n, 1);
+    }
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+/* |f| x mult rounded to the nearest integer, ties to even as printf() or away from zero as roundf().
+   Returns false if f is not finite or the result does not fit in 32 bits. */
+static bool float_to_fixed(float f, uint32_t mult, bool ties_even, uint32_t * n, bool * neg) {
+    union { float f; uint32_t u; } bits = { .f = f };
+    uint32_t exp, mant;
+    uint64_t x, q, rem, half;
+    int e;
+
+    *neg = (bits.u >> 31) != 0;
+    exp = (bits.u >> 23) & 0xFF;
+    mant = bits.u & 0x7FFFFF;
+    if (exp == 0xFF) {
+        return false;
+    }
+    if (exp == 0) {
+        e = -149; /* subnormal */
+    } else {
+        mant |= 0x800000;
+        e = (int)exp - 150;
+    }
+
+    /* |f| = mant x 2^e, exact in 28 bits once multiplied by up to 10 */
+    x = (uint64_t)mant * mult;
+    if (e >= 0) {
+        if ((e > 31) || (x > (UINT32_MAX >> e))) {
+            return false;
+        }
+        *n = (uint32_t)(x << e);
+        return true;
+    }
+    e = -e;
+    if (e > 40) {
+        *n = 0; /* below half of the last digit */
+        return true;
+    }
+    q = x >> e;
+    rem = x & ((1ULL << e) - 1);
+    half = 1ULL << (e - 1);
+    if ((rem > half) || ((rem == half) && ((ties_even == false) || ((q & 1) != 0)))) {
+        q += 1;
+    }
+    if (q > UINT32_MAX) {
+        return false;
+    }
+    *n = (uint32_t)q;
+    return true;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+/* printf("%.0f", roundf(f)) */
+static void put_rounded(rxpk_cursor_t * c, float f) {
+    char tmp[48];
+    uint32_t n;
+    bool neg;
+    int j;
+
+    if (float_to_fixed(f, 1, false, &n, &neg) == false) {
+        j = snprintf(tmp, sizeof tmp, "%.0f", roundf(f));
+        if ((j > 0) && (j < (int)sizeof tmp)) {
+            put_mem(c, tmp, j);
+        } else {
+            put_fail(c);
+        }
+        return;
+    }
+    if (neg == true) {
+        put_char(c, '-');
+    }
+    put_u64(c, n, 1);
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+/* printf("%.1f", f) */
+static void put_decimal1(rxpk_cursor_t * c, float f) {
+    char tmp[48];
+    uint32_t n;
+    bool neg;
+    int j;
+
+    if (float_to_fixed(f, 10, true, &n, &neg) == false) {
+        j = snprintf(tmp, sizeof tmp, "%.1f", f);
+        if ((j > 0) && (j < (int)sizeof tmp)) {
+            put_mem(c, tmp, j);
+        } else {
+            put_fail(c);
+        }
+        return;
+    }
+    if (neg == true) {
+        put_char(c, '-');
+    }
+    put_u64(c, n / 10, 1);
+    put_char(c, '.');
+    put_char(c, (char)('0' + n % 10));
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+/* ,"time":"YYYY-MM-DDThh:mm:ss.uuuuuuZ", ISO 8601 */
+static void put_utc_time(rxpk_cursor_t * c, const struct timespec * t) {
+    /* field of the last second written, the packets of a batch mostly share it */
+    static time_t last_sec;
+    static char last_field[37] = "";
+    char tmp[64];
+    char * s;
+    int64_t days, sod;
+    int64_t era, doe, yoe, doy, mp, y, m, d;
+    struct tm * x;
+    int j;
+
+    if ((t->tv_sec == last_sec) && (last_field[0] != '\0') && (t->tv_nsec >= 0) && (t->tv_nsec < 1000000000)) {
+        memcpy(tmp, last_field, 37);
+        fmt_u64(tmp + 35, (uint64_t)(t->tv_nsec / 1000), 6);
+        put_mem(c, tmp, 37);
+        return;
+    }
+
+    days = (int64_t)t->tv_sec / 86400;
+    sod = (int64_t)t->tv_sec % 86400;
+    if (sod < 0) {
+        sod += 86400;
+        days -= 1;
+    }
+
+    /* civil date of a day count from 1970-01-01 (proleptic Gregorian calendar) */
+    days += 719468;
+    era = ((days >= 0) ? days : (days - 146096)) / 146097;
+    doe = days - era * 146097;
+    yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = (mp < 10) ? (mp + 3) : (mp - 9);
+    y = yoe + era * 400 + ((m <= 2) ? 1 : 0);
+
+    if ((y < 0) || (y > 9999) || (t->tv_nsec < 0) || (t->tv_nsec >= 1000000000)) {
+        /* out of the fixed width format, let the C library do it */
+        x = gmtime(&(t->tv_sec));
+        if (x == NULL) {
+            put_fail(c);
+            return;
+        }
+        j = snprintf(tmp, sizeof tmp, ",\"time\":\"%04i-%02i-%02iT%02i:%02i:%02i.%06liZ\"", (x->tm_year)+1900, (x->tm_mon)+1, x->tm_mday, x->tm_hour, x->tm_min, x->tm_sec, (long)((t->tv_nsec)/1000));
+        if ((j > 0) && (j < (int)sizeof tmp)) {
+            put_mem(c, tmp, j);
+        } else {
+            put_fail(c);
+        }
+        return;
+    }
+
+    memcpy(tmp, ",\"time\":\"YYYY-MM-DDThh:mm:ss.uuuuuuZ\"", 37);
+    s = tmp + 9;
+    fmt_u64(s + 4, (uint64_t)y, 4);
+    memcpy(s + 5, &digits_lut[2 * m], 2);
+    memcpy(s + 8, &digits_lut[2 * d], 2);
+    memcpy(s + 11, &digits_lut[2 * (sod / 3600)], 2);
+    memcpy(s + 14, &digits_lut[2 * ((sod / 60) % 60)], 2);
+    memcpy(s + 17, &digits_lut[2 * (sod % 60)], 2);
+    fmt_u64(s + 26, (uint64_t)(t->tv_nsec / 1000), 6);
+    put_mem(c, tmp, 37);
+    memcpy(last_field, tmp, 37);
+    last_sec = t->tv_sec;
+}
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS DEFINITION ------------------------------------------ */
+
+int rxpk_json_write(const struct lgw_pkt_rx_desc_s * p, const struct timespec * utc_time, const uint64_t * gps_time_ms, char * buf, int size) {
+    rxpk_cursor_t cur = { .pos = buf, .end = buf + size, .error = false };
+    rxpk_cursor_t * c = &cur;
+    const char * datr;
+    int j;
+
+    /* JSON rxpk frame format version & RAW timestamp */
+    PUT_LIT(c, "{\"jver\":" STR(PROTOCOL_JSON_RXPK_FRAME_FORMAT) ",\"tmst\":");
+    put_u64(c, p->count_us, 1);
+
+    /* Packet RX time (GPS based) */
+    if (utc_time != NULL) {
+        put_utc_time(c, utc_time);
+    }
+    if (gps_time_ms != NULL) {
+        PUT_LIT(c, ",\"tmms\":");
+        put_u64(c, *gps_time_ms, 1);
+    }
+
+    /* Fine timestamp */
+    if (p->ftime_received == true) {
+        PUT_LIT(c, ",\"ftime\":");
+        put_u64(c, p->ftime, 1);
+    }
+
+    /* Packet concentrator channel, RF chain & RX frequency (MHz, 6 decimals: exact in Hz) */
+    PUT_LIT(c, ",\"chan\":");
+    put_u64(c, p->if_chain, 1);
+    PUT_LIT(c, ",\"rfch\":");
+    put_u64(c, p->rf_chain, 1);
+    PUT_LIT(c, ",\"freq\":");
+    put_u64(c, p->freq_hz / 1000000, 1);
+    put_char(c, '.');
+    put_u64(c, p->freq_hz % 1000000, 6);
+    PUT_LIT(c, ",\"mid\":");
+    if (p->modem_id < 10) {
+        put_char(c, ' '); /* %2u */
+    }
+    put_u64(c, p->modem_id, 1);
+
+    /* Packet status */
+    switch (p->status) {
+        case STAT_CRC_OK:
+            PUT_LIT(c, ",\"stat\":1");
+            break;
+        case STAT_CRC_BAD:
+            PUT_LIT(c, ",\"stat\":-1");
+            break;
+        case STAT_NO_CRC:
+            PUT_LIT(c, ",\"stat\":0");
+            break;
+        default:
+            return -1;
+    }
+
+    /* Packet modulation */
+    if (p->modulation == MOD_LORA) {
+        PUT_LIT(c, ",\"modu\":\"LORA\"");
+
+        /* Lora datarate & bandwidth */
+        datr = (p->datarate < 13) ? lora_datr[p->datarate] : NULL;
+        if (datr == NULL) {
+            return -1;
+        }
+        put_mem(c, datr, strlen(datr));
+        switch (p->bandwidth) {
+            case BW_125KHZ:
+                PUT_LIT(c, "BW125\"");
+                break;
+            case BW_250KHZ:
+                PUT_LIT(c, "BW250\"");
+                break;
+            case BW_500KHZ:
+                PUT_LIT(c, "BW500\"");
+                break;
+            default:
+                return -1;
+        }
+
+        /* Packet ECC coding rate */
+        if (p->coderate > CR_LORA_4_8) {
+            return -1;
+        }
+        put_mem(c, lora_codr[p->coderate], 13);
+
+        /* Signal RSSI, SNR, frequency offset */
+        PUT_LIT(c, ",\"rssis\":");
+        put_rounded(c, p->rssis);
+        PUT_LIT(c, ",\"lsnr\":");
+        put_decimal1(c, p->snr);
+        PUT_LIT(c, ",\"foff\":");
+        put_i32(c, p->freq_offset);
+    } else if (p->modulation == MOD_FSK) {
+        PUT_LIT(c, ",\"modu\":\"FSK\",\"datr\":");
+        put_u64(c, p->datarate, 1);
+    } else {
+        return -1;
+    }
+
+    /* Channel RSSI, payload size */
+    PUT_LIT(c, ",\"rssi\":");
+    put_rounded(c, p->rssic);
+    PUT_LIT(c, ",\"size\":");
+    put_u64(c, p->size, 1);
+
+    /* Packet base64-encoded payload */
+    PUT_LIT(c, ",\"data\":\"");
+    if (cur.error == true) {
+        return -1;
+    }
+    j = (int)(cur.end - cur.pos);
+    j = bin_to_b64(p->payload, p->size, cur.pos, (j < B64_MAX_LEN) ? j : B64_MAX_LEN);
+    if (j < 0) {
+        return -1;
+    }
+    cur.pos += j;
+    PUT_LIT(c, "\"}");
+
+    return (cur.error == true) ? -1 : (int)(cur.pos - buf);
+}
+
+/* --- EOF ------------------------------------------------------------------ */
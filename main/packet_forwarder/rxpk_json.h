@@ -0,0 +1,50 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    LoRa concentrator : JSON serialization of the received packets (rxpk)
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+
+#ifndef _LORA_PKTFWD_RXPK_JSON_H
+#define _LORA_PKTFWD_RXPK_JSON_H
+
+
+#include <stdint.h>     /* C99 types */
+#include <stdbool.h>    /* bool type */
+#include <time.h>       /* timespec */
+
+#include "loragw_hal.h"
+
+
+#define PROTOCOL_JSON_RXPK_FRAME_FORMAT 1
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS PROTOTYPES ------------------------------------------ */
+
+/**
+@brief Serialize a received packet as a JSON rxpk object, from '{' to '}'.
+
+The output is the one of the former snprintf() based serializer of thread_up,
+byte for byte, see PROTOCOL.md for the fields. Not reentrant: the calendar
+part of the "time" field of the last second written is kept for the next
+packets.
+
+@param p[in] Packet to be serialized.
+@param utc_time[in] UTC time of the packet, NULL if unknown ("time" field omitted).
+@param gps_time_ms[in] GPS time of the packet in ms since 06.Jan.1980, NULL if unknown ("tmms" field omitted).
+@param buf[out] Where the object is written, no null char is added.
+@param size[in] Room available in buf, in bytes.
+@return Number of bytes written, -1 if the packet has an invalid field or does not fit in buf.
+*/
+int rxpk_json_write(const struct lgw_pkt_rx_desc_s * p, const struct timespec * utc_time, const uint64_t * gps_time_ms, char * buf, int size);
+
+#endif
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,224 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    LoRa concentrator : servers the uplinks are sent to, each with its own
+    sockets, PUSH_DATA tokens and PUSH_ACK tracking
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+
+#include <stdlib.h>         /* rand */
+#include <string.h>         /* memset */
+#include <unistd.h>         /* close, usleep */
+#include <sys/select.h>     /* select, fd_set */
+#include <sys/time.h>       /* timeval */
+#include <arpa/inet.h>      /* IP address conversion stuff */
+#include <netdb.h>          /* gethostbyname */
+
+#include "servers.h"
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE FUNCTIONS DEFINITION ----------------------------------------- */
+
+/* First IPv4 address of a host name, or of an address in dotted notation */
+static int resolve(const char * host, struct in_addr * ip) {
+    struct hostent *he;
+
+    if (inet_aton(host, ip) != 0) {
+        return 0;
+    }
+    he = gethostbyname(host);
+    if ((he == NULL) || (he->h_addrtype != AF_INET) || (he->h_addr_list[0] == NULL)) {
+        return -1;
+    }
+    memcpy(ip, he->h_addr_list[0], sizeof *ip);
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS DEFINITION ------------------------------------------ */
+
+int serv_open(struct serv_s * s) {
+    s->resolved = false;
+    s->sock_up = -1;
+    s->sock_down = -1;
+    memset(s->inflight, 0, sizeof s->inflight);
+    s->push_token = (uint16_t)rand(); /* sequence starting at random, unique per server */
+    s->pull_acked = false;
+    s->pull_unacked_nb = 0;
+
+    s->sock_up = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+    if (s->sock_up < 0) {
+        return -1;
+    }
+    if (s->downlink == true) {
+        s->sock_down = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+        if (s->sock_down < 0) {
+            serv_close(s);
+            return -1;
+        }
+    }
+    return (serv_resolve(s) == 0) ? 0 : -2;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+int serv_resolve(struct serv_s * s) {
+    struct in_addr ip;
+
+    if (serv_is_resolved(s) == true) {
+        return 0;
+    }
+    if (resolve(s->addr, &ip) != 0) {
+        return -1;
+    }
+    memset(&s->dest_up, 0, sizeof s->dest_up);
+    s->dest_up.sin_family = AF_INET;
+    s->dest_up.sin_addr = ip;
+    s->dest_up.sin_port = htons(s->port_up);
+    s->dest_down = s->dest_up;
+    s->dest_down.sin_port = htons(s->port_down);
+    /* the other threads only read the addresses once they see the flag set */
+    __atomic_store_n(&s->resolved, true, __ATOMIC_RELEASE);
+    return 0;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+bool serv_is_resolved(const struct serv_s * s) {
+    return __atomic_load_n(&s->resolved, __ATOMIC_ACQUIRE);
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+void serv_close(struct serv_s * s) {
+    if (s->sock_up >= 0) {
+        close(s->sock_up);
+        s->sock_up = -1;
+    }
+    if (s->sock_down >= 0) {
+        close(s->sock_down);
+        s->sock_down = -1;
+    }
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+int serv_wait(const struct serv_s * serv, int nb, bool down, uint32_t timeout_ms, int * next) {
+    fd_set fds;
+    struct timeval tv;
+    int i, k, sock, max_sock = -1;
+
+    FD_ZERO(&fds);
+    for (i = 0; i < nb; i++) {
+        sock = (down == true) ? serv[i].sock_down : serv[i].sock_up;
+        if (sock >= 0) {
+            FD_SET(sock, &fds);
+            if (sock > max_sock) {
+                max_sock = sock;
+            }
+        }
+    }
+    tv.tv_sec = timeout_ms / 1000;
+    tv.tv_usec = (timeout_ms % 1000) * 1000;
+    if (max_sock < 0) {
+        usleep(timeout_ms * 1000); /* no socket to wait on, just wait */
+        return -1;
+    }
+    if (select(max_sock + 1, &fds, NULL, NULL, &tv) <= 0) {
+        return -1;
+    }
+    /* starting after the server returned last, so that a busy one cannot starve the others */
+    for (k = 0; k < nb; k++) {
+        i = (*next + k) % nb;
+        sock = (down == true) ? serv[i].sock_down : serv[i].sock_up;
+        if ((sock >= 0) && FD_ISSET(sock, &fds)) {
+            *next = (i + 1) % nb;
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+bool serv_is_source(const struct serv_s * s, const struct sockaddr_in * from) {
+    return (from->sin_family == AF_INET) && (from->sin_addr.s_addr == s->dest_up.sin_addr.s_addr);
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+uint16_t serv_push_token(struct serv_s * s, uint8_t * dgram) {
+    s->push_token += 1;
+    dgram[1] = (uint8_t)(s->push_token >> 8);
+    dgram[2] = (uint8_t)s->push_token;
+    return s->push_token;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+bool serv_push_register(struct serv_s * s, uint16_t token, bool replay, int64_t send_time_us) {
+    struct serv_inflight_s * f = s->inflight;
+    int i, slot = -1;
+    bool evicted;
+
+    for (i = 0; i < SERV_INFLIGHT_NB; i++) {
+        if (f[i].used == false) {
+            slot = i;
+            break;
+        } else if ((f[i].replay == false) && ((slot < 0) || (f[i].send_time_us < f[slot].send_time_us))) {
+            slot = i;
+        }
+    }
+    evicted = f[slot].used;
+    f[slot].used = true;
+    f[slot].replay = replay;
+    f[slot].token = token;
+    f[slot].send_time_us = send_time_us;
+
+    return evicted;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+int64_t serv_push_ack(struct serv_s * s, uint16_t token, int64_t recv_time_us, int64_t timeout_us, bool * replay) {
+    struct serv_inflight_s * f = s->inflight;
+    int i;
+
+    *replay = false;
+    for (i = 0; i < SERV_INFLIGHT_NB; i++) {
+        if ((f[i].used == true) && (f[i].token == token) && ((recv_time_us - f[i].send_time_us) <= timeout_us)) {
+            *replay = f[i].replay;
+            f[i].used = false;
+            return recv_time_us - f[i].send_time_us;
+        }
+    }
+    return -1;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+uint32_t serv_push_expire(struct serv_s * s, int64_t now_us, int64_t timeout_us, bool * replay) {
+    struct serv_inflight_s * f = s->inflight;
+    int i;
+    uint32_t nb_expired = 0;
+
+    *replay = false;
+    for (i = 0; i < SERV_INFLIGHT_NB; i++) {
+        if ((f[i].used == true) && ((now_us - f[i].send_time_us) > timeout_us)) {
+            *replay |= f[i].replay;
+            f[i].used = false;
+            nb_expired += 1;
+        }
+    }
+    return nb_expired;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
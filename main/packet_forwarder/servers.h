@@ -0,0 +1,174 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    LoRa concentrator : servers the uplinks are sent to, each with its own
+    sockets, PUSH_DATA tokens and PUSH_ACK tracking
+
+    The same PUSH_DATA datagram is sent to every server, only its token being
+    written again for each of them. PULL_DATA are only sent to the servers
+    marked for downlinks, the others do not even get a downstream socket, so
+    no PULL_RESP can be taken from them. No locking is done here.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+
+#ifndef _LORA_PKTFWD_SERVERS_H
+#define _LORA_PKTFWD_SERVERS_H
+
+
+#include <stdint.h>     /* C99 types */
+#include <stdbool.h>    /* bool type */
+#include <time.h>       /* timespec */
+#include <sys/socket.h> /* socket specific definitions */
+#include <netinet/in.h> /* sockaddr_in */
+
+
+#define SERV_MAX            4       /* servers, the first one being the network server */
+#define SERV_ADDR_SIZE      64      /* host name or IPv4 address, with its terminator */
+#define SERV_INFLIGHT_NB    16      /* PUSH_DATA awaiting their PUSH_ACK, per server */
+
+/* PUSH_DATA datagram awaiting its PUSH_ACK */
+struct serv_inflight_s {
+    bool        used;
+    bool        replay;         /* PUSH_DATA replaying spooled packets */
+    uint16_t    token;
+    int64_t     send_time_us;   /* esp_timer time of the sendto */
+};
+
+struct serv_s {
+    /* configuration */
+    char        addr[SERV_ADDR_SIZE]; /* host name or IPv4 address */
+    uint16_t    port_up;        /* port for PUSH_DATA */
+    uint16_t    port_down;      /* port for PULL_DATA */
+    bool        downlink;       /* PULL_DATA sent, PULL_RESP accepted */
+    int         keepalive;      /* PULL_DATA interval, in seconds */
+
+    /* network, set by serv_open(), the addresses once resolved */
+    bool        resolved;       /* dest_up and dest_down are set */
+    int         sock_up;        /* socket for upstream traffic */
+    int         sock_down;      /* socket for downstream traffic, -1 without downlinks */
+    struct sockaddr_in dest_up;
+    struct sockaddr_in dest_down;
+
+    /* upstream, PUSH_DATA token sequence and the ones awaiting their PUSH_ACK */
+    uint16_t    push_token;
+    struct serv_inflight_s inflight[SERV_INFLIGHT_NB];
+
+    /* downstream, latest PULL_DATA */
+    uint8_t     pull_token[2];
+    struct timespec pull_time;  /* CLOCK_MONOTONIC time it was sent */
+    bool        pull_acked;
+    uint32_t    pull_unacked_nb; /* PULL_DATA sent since the latest PULL_ACK */
+};
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS PROTOTYPES ------------------------------------------ */
+
+/**
+@brief Create the sockets of a configured server and resolve its address.
+
+@param s[in,out] Server, its configuration being set.
+@return 0 if successful, -1 if a socket could not be created, -2 if only the address could not be resolved.
+*/
+int serv_open(struct serv_s * s);
+
+/**
+@brief Resolve the address of a server opened without it, nothing being sent to it until then.
+
+Called by one thread, the others reading the addresses only once serv_is_resolved() is true.
+
+@param s[in,out] Server.
+@return 0 if the address is resolved, -1 otherwise.
+*/
+int serv_resolve(struct serv_s * s);
+
+/**
+@brief Tell whether datagrams can be sent to a server.
+
+@param s[in] Server.
+@return true once its address is resolved.
+*/
+bool serv_is_resolved(const struct serv_s * s);
+
+/**
+@brief Close the sockets of a server.
+
+@param s[in,out] Server.
+*/
+void serv_close(struct serv_s * s);
+
+/**
+@brief Wait for a datagram from any of the servers.
+
+@param serv[in] Servers.
+@param nb[in] Number of servers.
+@param down[in] Wait on the downstream sockets, upstream ones otherwise.
+@param timeout_ms[in] Max time to wait.
+@param next[in,out] Server checked first, then the one after the server returned.
+@return Index of a server with a datagram waiting, -1 if none came in time or on error.
+*/
+int serv_wait(const struct serv_s * serv, int nb, bool down, uint32_t timeout_ms, int * next);
+
+/**
+@brief Check that a datagram comes from a server.
+
+@param s[in] Server.
+@param from[in] Source address of the datagram.
+@return true if it has the IP address of the server.
+*/
+bool serv_is_source(const struct serv_s * s, const struct sockaddr_in * from);
+
+/**
+@brief Take the token of the next PUSH_DATA to a server and write it in the datagram header.
+
+@param s[in,out] Server.
+@param dgram[in,out] PUSH_DATA datagram, its bytes 1 and 2 are set.
+@return Token.
+*/
+uint16_t serv_push_token(struct serv_s * s, uint8_t * dgram);
+
+/**
+@brief Record a PUSH_DATA sent to a server, the oldest one still waiting is evicted if the table is full.
+
+The pending replay, one at most, is never evicted: its packets must be handed out again when it expires.
+
+@param s[in,out] Server.
+@param token[in] Token of the PUSH_DATA.
+@param replay[in] The PUSH_DATA replays spooled packets.
+@param send_time_us[in] Time of the send, in us.
+@return true if a PUSH_DATA had to be evicted for it.
+*/
+bool serv_push_register(struct serv_s * s, uint16_t token, bool replay, int64_t send_time_us);
+
+/**
+@brief Match a PUSH_ACK with the PUSH_DATA it acknowledges.
+
+@param s[in,out] Server the PUSH_ACK came from.
+@param token[in] Token of the PUSH_ACK.
+@param recv_time_us[in] Time it was received, in us.
+@param timeout_us[in] Max round trip time.
+@param replay[out] The PUSH_DATA acknowledged replays spooled packets.
+@return Round trip time in us, -1 if no PUSH_DATA matches.
+*/
+int64_t serv_push_ack(struct serv_s * s, uint16_t token, int64_t recv_time_us, int64_t timeout_us, bool * replay);
+
+/**
+@brief Forget the PUSH_DATA not acknowledged in time.
+
+@param s[in,out] Server.
+@param now_us[in] Current time, in us.
+@param timeout_us[in] Max round trip time.
+@param replay[out] The pending replay is one of them.
+@return Number of PUSH_DATA expired.
+*/
+uint32_t serv_push_expire(struct serv_s * s, int64_t now_us, int64_t timeout_us, bool * replay);
+
+#endif
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,347 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    LoRa concentrator : store-and-forward spool of the serialized rxpk records
+
+    The records form a single queue, the oldest ones in the file ring and the
+    newest ones in the RAM ring. A record enters the RAM ring, and the oldest
+    records of the RAM ring move to the file ring when room is needed. The
+    records handed out for a replay are the first peek_nb ones of the queue.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+
+#include <string.h>     /* memcpy, memset */
+
+#include "spool.h"
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE MACROS ------------------------------------------------------- */
+
+#define SPOOL_COPY_CHUNK    128 /* bytes moved at once from the RAM ring to the file ring */
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE FUNCTIONS DEFINITION ----------------------------------------- */
+
+/* Read n bytes at offset off from the head of the ring */
+static int ring_read(const struct spool_ring_s * r, uint32_t off, uint8_t * buf, uint32_t n) {
+    uint32_t pos = (r->head + off) % r->size;
+    uint32_t first = (n < (r->size - pos)) ? n : (r->size - pos);
+
+    if (r->ram != NULL) {
+        memcpy(buf, r->ram + pos, first);
+        memcpy(buf + first, r->ram, n - first);
+        return 0;
+    }
+    if ((fseek(r->file, (long)pos, SEEK_SET) != 0) || (fread(buf, 1, first, r->file) != first)) {
+        return -1;
+    }
+    if ((n > first) && ((fseek(r->file, 0, SEEK_SET) != 0) || (fread(buf + first, 1, n - first, r->file) != (n - first)))) {
+        return -1;
+    }
+    return 0;
+}
+
+/* Write n bytes at the tail of the ring, room being checked by the caller */
+static int ring_write(struct spool_ring_s * r, const uint8_t * buf, uint32_t n) {
+    uint32_t pos = (r->head + r->used) % r->size;
+    uint32_t first = (n < (r->size - pos)) ? n : (r->size - pos);
+
+    if (r->ram != NULL) {
+        memcpy(r->ram + pos, buf, first);
+        memcpy(r->ram, buf + first, n - first);
+    } else {
+        if ((fseek(r->file, (long)pos, SEEK_SET) != 0) || (fwrite(buf, 1, first, r->file) != first)) {
+            return -1;
+        }
+        if ((n > first) && ((fseek(r->file, 0, SEEK_SET) != 0) || (fwrite(buf + first, 1, n - first, r->file) != (n - first)))) {
+            return -1;
+        }
+    }
+    r->used += n;
+    return 0;
+}
+
+/* Length of the record at offset off, header included, 0 on a read error */
+static uint32_t ring_rec_size(const struct spool_ring_s * r, uint32_t off) {
+    uint8_t h[SPOOL_REC_HEADER];
+
+    if (ring_read(r, off, h, SPOOL_REC_HEADER) != 0) {
+        return 0;
+    }
+    return SPOOL_REC_HEADER + (uint32_t)(h[0] | (h[1] << 8));
+}
+
+/* Remove the oldest record of the ring, of n bytes */
+static void ring_pop(struct spool_ring_s * r, uint32_t n) {
+    r->head = (r->head + n) % r->size;
+    r->used -= n;
+    r->nb -= 1;
+    if (r->used == 0) {
+        r->head = 0;
+    }
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+/* The records removed from the front of the queue are no longer handed out */
+static void front_removed(struct spool_s * s, uint32_t nb, uint32_t bytes) {
+    if (s->peek_bytes >= bytes) {
+        s->peek_nb -= nb;
+        s->peek_bytes -= bytes;
+    } else {
+        s->peek_nb = 0;
+        s->peek_bytes = 0;
+    }
+}
+
+/* Give up the file ring after an I/O error, its records are lost */
+static void file_fail(struct spool_s * s) {
+    front_removed(s, s->file.nb, s->file.used);
+    s->nb_error += s->file.nb;
+    fclose(s->file.file);
+    memset(&s->file, 0, sizeof s->file);
+}
+
+/* Remove the oldest record of the queue, false if there is none */
+static bool drop_oldest(struct spool_s * s) {
+    struct spool_ring_s * r = (s->file.nb > 0) ? &s->file : &s->ram;
+    uint32_t n;
+
+    if (r->nb == 0) {
+        return false;
+    }
+    n = ring_rec_size(r, 0);
+    if (n == 0) {
+        file_fail(s); /* only the file ring can fail */
+        return true;
+    }
+    ring_pop(r, n);
+    front_removed(s, 1, n);
+    s->nb_drop += 1;
+    return true;
+}
+
+/* Move the oldest record of the RAM ring to the file ring, false if the file ring has no room */
+static bool spill_oldest(struct spool_s * s) {
+    uint8_t chunk[SPOOL_COPY_CHUNK];
+    uint32_t n, off, k;
+    uint32_t used = s->file.used;
+
+    n = ring_rec_size(&s->ram, 0);
+    if ((s->file.size - s->file.used) < n) {
+        return false;
+    }
+    for (off = 0; off < n; off += k) {
+        k = ((n - off) < SPOOL_COPY_CHUNK) ? (n - off) : SPOOL_COPY_CHUNK;
+        ring_read(&s->ram, off, chunk, k);
+        if (ring_write(&s->file, chunk, k) != 0) {
+            /* the record stays in RAM, the partial copy is discarded with the file */
+            s->file.used = used;
+            file_fail(s);
+            return true;
+        }
+    }
+    s->file.nb += 1;
+    ring_pop(&s->ram, n);
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS DEFINITION ------------------------------------------ */
+
+int spool_init(struct spool_s * s, uint8_t * ram, uint32_t ram_size, const char * file_path, uint32_t file_size, int drop_policy, uint32_t outage_nb, uint32_t replay_rate, uint32_t probe_ms) {
+    memset(s, 0, sizeof *s);
+    s->ram.ram = ram;
+    s->ram.size = ram_size;
+    s->drop_policy = drop_policy;
+    s->outage_nb = (outage_nb > 0) ? outage_nb : 1;
+    s->replay_interval_us = (replay_rate > 0) ? (1000000 / replay_rate) : 0;
+    s->probe_interval_us = (int64_t)probe_ms * 1000;
+
+    if ((file_path != NULL) && (file_path[0] != '\0') && (file_size > SPOOL_REC_HEADER)) {
+        s->file.file = fopen(file_path, "w+b");
+        if (s->file.file == NULL) {
+            return -1;
+        }
+        s->file.size = file_size;
+    }
+    return 0;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+int spool_put(struct spool_s * s, const uint8_t * rec, uint16_t len, uint8_t flags) {
+    uint8_t h[SPOOL_REC_HEADER];
+    uint32_t n = SPOOL_REC_HEADER + len;
+    uint32_t used;
+    int dropped = 0;
+
+    if ((len == 0) || (n > s->ram.size)) {
+        return -1;
+    }
+
+    /* make room in the RAM ring: move the oldest records to the file ring, or drop records */
+    while ((s->ram.size - s->ram.used) < n) {
+        if ((s->file.file != NULL) && (spill_oldest(s) == true)) {
+            continue;
+        }
+        if (s->drop_policy == SPOOL_DROP_NEWEST) {
+            s->nb_drop += 1;
+            return 1;
+        }
+        drop_oldest(s);
+        dropped += 1;
+    }
+
+    h[0] = (uint8_t)len;
+    h[1] = (uint8_t)(len >> 8);
+    h[2] = flags;
+    ring_write(&s->ram, h, SPOOL_REC_HEADER);
+    ring_write(&s->ram, rec, len);
+    s->ram.nb += 1;
+    s->nb_in += 1;
+
+    used = s->ram.used + s->file.used;
+    if (used > s->high_water) {
+        s->high_water = used;
+    }
+    return dropped;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+int spool_next(const struct spool_s * s, uint8_t * flags) {
+    const struct spool_ring_s * r = &s->ram;
+    uint32_t off = s->peek_bytes;
+    uint8_t h[SPOOL_REC_HEADER];
+
+    if (s->peek_nb >= (s->file.nb + s->ram.nb)) {
+        return 0;
+    }
+    if (off < s->file.used) {
+        r = &s->file;
+    } else {
+        off -= s->file.used;
+    }
+    if (ring_read(r, off, h, SPOOL_REC_HEADER) != 0) {
+        return 0;
+    }
+    if (flags != NULL) {
+        *flags = h[2];
+    }
+    return h[0] | (h[1] << 8);
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+int spool_peek(struct spool_s * s, uint8_t * buf, int size) {
+    struct spool_ring_s * r = &s->ram;
+    uint32_t off = s->peek_bytes;
+    int len;
+
+    len = spool_next(s, NULL);
+    if (len == 0) {
+        if ((s->file.file != NULL) && (s->peek_bytes < s->file.used)) {
+            file_fail(s); /* header read error */
+        }
+        return 0;
+    }
+    if (len > size) {
+        return -1;
+    }
+    if (off < s->file.used) {
+        r = &s->file;
+    } else {
+        off -= s->file.used;
+    }
+    if (ring_read(r, off + SPOOL_REC_HEADER, buf, (uint32_t)len) != 0) {
+        file_fail(s);
+        return 0;
+    }
+    s->peek_nb += 1;
+    s->peek_bytes += SPOOL_REC_HEADER + len;
+    return len;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+bool spool_replay_due(const struct spool_s * s, int64_t now_us) {
+    int64_t interval = (s->link_lost == true) ? s->probe_interval_us : s->replay_interval_us;
+
+    if (((s->file.nb + s->ram.nb) == 0) || (s->replay_pending == true)) {
+        return false;
+    }
+    return (now_us - s->replay_last_us) >= interval;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+void spool_replay_sent(struct spool_s * s, int64_t now_us) {
+    s->replay_pending = (s->peek_nb > 0);
+    s->replay_last_us = now_us;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+void spool_ack(struct spool_s * s, bool replay) {
+    struct spool_ring_s * r;
+    uint32_t n;
+
+    s->link_lost = false;
+    s->expired_nb = 0;
+    if ((replay == false) || (s->replay_pending == false)) {
+        return;
+    }
+
+    /* the acknowledged records leave the spool */
+    s->replay_pending = false;
+    while (s->peek_nb > 0) {
+        r = (s->file.nb > 0) ? &s->file : &s->ram;
+        n = ring_rec_size(r, 0);
+        if (n == 0) {
+            file_fail(s);
+            continue;
+        }
+        ring_pop(r, n);
+        s->peek_nb -= 1;
+        s->peek_bytes -= n;
+        s->nb_out += 1;
+    }
+    s->peek_bytes = 0;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+void spool_expired(struct spool_s * s, uint32_t nb, bool replay) {
+    s->expired_nb += nb;
+    if (s->expired_nb >= s->outage_nb) {
+        s->link_lost = true;
+    }
+    if ((replay == true) && (s->replay_pending == true)) {
+        /* hand the records out again for the next replay */
+        s->replay_pending = false;
+        s->peek_nb = 0;
+        s->peek_bytes = 0;
+    }
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+void spool_usage(const struct spool_s * s, uint32_t * nb, uint32_t * bytes) {
+    if (nb != NULL) {
+        *nb = s->file.nb + s->ram.nb;
+    }
+    if (bytes != NULL) {
+        *bytes = s->file.used + s->ram.used;
+    }
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,165 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    LoRa concentrator : store-and-forward spool of the serialized rxpk records
+    received while the server does not acknowledge PUSH_DATA, and their replay
+
+    Records are kept in order in a RAM ring, with an optional file ring for the
+    oldest ones when the RAM ring is full. Replayed records are only removed
+    when the PUSH_DATA carrying them is acknowledged. No locking is done here.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+
+#ifndef _LORA_PKTFWD_SPOOL_H
+#define _LORA_PKTFWD_SPOOL_H
+
+
+#include <stdint.h>     /* C99 types */
+#include <stdbool.h>    /* bool type */
+#include <stdio.h>      /* FILE */
+
+
+#define SPOOL_REC_HEADER    3       /* record length (2 bytes) and flags */
+#define SPOOL_REC_BINARY    0x01    /* record is a binary rxpk, JSON otherwise */
+
+#define SPOOL_DROP_OLDEST   0       /* spool full: oldest records are dropped for the new one */
+#define SPOOL_DROP_NEWEST   1       /* spool full: the new record is dropped */
+
+/* Byte ring, in RAM or in a file */
+struct spool_ring_s {
+    uint8_t *   ram;        /* RAM storage, NULL for a file ring */
+    FILE *      file;       /* file storage, NULL if none */
+    uint32_t    size;       /* capacity, in bytes */
+    uint32_t    head;       /* offset of the oldest record */
+    uint32_t    used;       /* bytes used */
+    uint32_t    nb;         /* records stored */
+};
+
+struct spool_s {
+    struct spool_ring_s file;   /* oldest records, when the RAM ring overflowed */
+    struct spool_ring_s ram;    /* newest records */
+    int         drop_policy;    /* SPOOL_DROP_OLDEST or SPOOL_DROP_NEWEST */
+
+    /* replay of the records, the oldest first */
+    uint32_t    peek_nb;        /* records handed out for the pending replay */
+    uint32_t    peek_bytes;     /* their size, with the record headers */
+    bool        replay_pending; /* a replay PUSH_DATA awaits its PUSH_ACK */
+    int64_t     replay_last_us; /* time of the last replay PUSH_DATA */
+    int64_t     replay_interval_us; /* min time between replay PUSH_DATA, link up */
+    int64_t     probe_interval_us;  /* min time between replay PUSH_DATA, link lost */
+
+    /* link state, from the PUSH_ACK */
+    bool        link_lost;      /* records are spooled instead of being sent */
+    uint32_t    outage_nb;      /* PUSH_DATA expired in a row before the link is lost */
+    uint32_t    expired_nb;     /* PUSH_DATA expired since the last PUSH_ACK */
+
+    /* statistics, never reset here */
+    uint32_t    nb_in;          /* records spooled */
+    uint32_t    nb_out;         /* records replayed and acknowledged */
+    uint32_t    nb_drop;        /* records dropped, spool full */
+    uint32_t    nb_error;       /* records lost on a file error */
+    uint32_t    high_water;     /* max bytes used, RAM and file */
+};
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS PROTOTYPES ------------------------------------------ */
+
+/**
+@brief Initialize a spool.
+
+@param s[out] Spool to initialize.
+@param ram[in] RAM storage, PSRAM if available.
+@param ram_size[in] Size of the RAM storage, in bytes.
+@param file_path[in] File for the overflow of the RAM storage, truncated, NULL for none.
+@param file_size[in] Max size of that file, in bytes.
+@param drop_policy[in] SPOOL_DROP_OLDEST or SPOOL_DROP_NEWEST.
+@param outage_nb[in] PUSH_DATA expired in a row before the link is considered lost.
+@param replay_rate[in] Max replay PUSH_DATA per second when the link is up.
+@param probe_ms[in] Time between replay PUSH_DATA, carrying a single record, when the link is lost.
+@return 0 if successful, -1 if the file could not be created (the spool works in RAM only).
+*/
+int spool_init(struct spool_s * s, uint8_t * ram, uint32_t ram_size, const char * file_path, uint32_t file_size, int drop_policy, uint32_t outage_nb, uint32_t replay_rate, uint32_t probe_ms);
+
+/**
+@brief Add a record at the end of the spool, applying the drop policy if it is full.
+
+@param s[in,out] Spool.
+@param rec[in] Serialized rxpk.
+@param len[in] Its length, in bytes.
+@param flags[in] SPOOL_REC_BINARY for a binary rxpk.
+@return Number of records dropped for it (or 1 if it was dropped itself), -1 if it is empty or can never fit.
+*/
+int spool_put(struct spool_s * s, const uint8_t * rec, uint16_t len, uint8_t flags);
+
+/**
+@brief Get the length of the next record to be replayed.
+
+@param s[in] Spool.
+@param flags[out] Flags of the record.
+@return Its length in bytes, 0 if all records are handed out.
+*/
+int spool_next(const struct spool_s * s, uint8_t * flags);
+
+/**
+@brief Copy the next record to be replayed, it stays in the spool until spool_ack().
+
+@param s[in,out] Spool.
+@param buf[out] Where the record is copied.
+@param size[in] Room available in buf, in bytes.
+@return Its length in bytes, 0 if all records are handed out, -1 if it does not fit in buf.
+*/
+int spool_peek(struct spool_s * s, uint8_t * buf, int size);
+
+/**
+@brief Check if a replay PUSH_DATA can be sent.
+
+@param s[in] Spool.
+@param now_us[in] Current time, in us.
+@return true if records are waiting, no replay is pending and the replay rate allows it.
+*/
+bool spool_replay_due(const struct spool_s * s, int64_t now_us);
+
+/**
+@brief Mark the records handed out by spool_peek() as sent in a replay PUSH_DATA.
+
+@param s[in,out] Spool.
+@param now_us[in] Time of the send, in us.
+*/
+void spool_replay_sent(struct spool_s * s, int64_t now_us);
+
+/**
+@brief Report a PUSH_ACK: the link is up, and the replayed records are removed if it acknowledges them.
+
+@param s[in,out] Spool.
+@param replay[in] The PUSH_DATA acknowledged is the pending replay.
+*/
+void spool_ack(struct spool_s * s, bool replay);
+
+/**
+@brief Report PUSH_DATA not acknowledged in time: the link is lost after outage_nb in a row, and the replayed records are handed out again if the replay is one of them.
+
+@param s[in,out] Spool.
+@param nb[in] Number of PUSH_DATA expired.
+@param replay[in] The pending replay is one of them.
+*/
+void spool_expired(struct spool_s * s, uint32_t nb, bool replay);
+
+/**
+@brief Get the number of records and bytes in the spool.
+
+@param s[in] Spool.
+@param nb[out] Records stored, NULL if not needed.
+@param bytes[out] Bytes used in RAM and file, NULL if not needed.
+*/
+void spool_usage(const struct spool_s * s, uint32_t * nb, uint32_t * bytes);
+
+#endif
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,73 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    LoRa concentrator : statistics counters without locks
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+
+#include <string.h>     /* memcpy */
+
+#include "stats.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE MACROS ------------------------------------------------------- */
+
+#define STATS_SPIN_NB   8   /* tries before yielding to a writer preempted in the middle of a block */
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC VARIABLES ----------------------------------------------------- */
+
+volatile uint32_t stats_epoch = 0;
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE FUNCTIONS DEFINITION ----------------------------------------- */
+
+/* Wait for the writer, letting it run if it has a lower priority or shares the core */
+static void stats_relax(unsigned * tries) {
+    *tries += 1;
+    if (*tries >= STATS_SPIN_NB) {
+        vTaskDelay(1);
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS DEFINITION ------------------------------------------ */
+
+void stats_read(const void * block, void * copy, size_t size) {
+    const stats_seq_t * s = block;
+    unsigned tries = 0;
+    uint32_t seq;
+
+    while (1) {
+        seq = __atomic_load_n(&s->seq, __ATOMIC_ACQUIRE);
+        if ((seq & 1) != 0) {
+            stats_relax(&tries);
+            continue;
+        }
+        memcpy(copy, block, size);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE); /* copy done before the sequence is checked again */
+        if (__atomic_load_n(&s->seq, __ATOMIC_RELAXED) == seq) {
+            return;
+        }
+        stats_relax(&tries);
+    }
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+void stats_new_epoch(void) {
+    __atomic_store_n(&stats_epoch, stats_epoch + 1, __ATOMIC_RELAXED);
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,107 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    LoRa concentrator : statistics counters without locks
+
+    Each block of counters is written by a single task, between stats_begin()
+    and stats_end(), and is never reset. The statistics task copies it with
+    stats_read(), which retries until it gets a copy not torn by a write, and
+    computes the values of an interval from the difference of two copies.
+    Maximums are kept per interval: the statistics task starts a new interval
+    with stats_new_epoch() and a writer restarts its maximums when it sees it.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+
+#ifndef _LORA_PKTFWD_STATS_H
+#define _LORA_PKTFWD_STATS_H
+
+
+#include <stdint.h>     /* C99 types */
+#include <stddef.h>     /* size_t */
+
+
+/* Sequence counter, first member of a block of counters */
+typedef struct stats_seq_s {
+    volatile uint32_t seq;  /* odd while the block is being written */
+} stats_seq_t;
+
+/* Maximum over an interval */
+typedef struct stats_max_s {
+    uint32_t    val;        /* max value */
+    uint32_t    epoch;      /* interval it belongs to */
+} stats_max_t;
+
+/* Current statistics interval, only changed by stats_new_epoch() */
+extern volatile uint32_t stats_epoch;
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS PROTOTYPES ------------------------------------------ */
+
+/**
+@brief Start writing a block of counters, only one task writes a given block.
+
+@param s[in,out] Sequence counter of the block.
+*/
+static inline void stats_begin(stats_seq_t * s) {
+    __atomic_store_n(&s->seq, s->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE); /* odd sequence visible before the counters change */
+}
+
+/**
+@brief End writing a block of counters.
+
+@param s[in,out] Sequence counter of the block.
+*/
+static inline void stats_end(stats_seq_t * s) {
+    __atomic_store_n(&s->seq, s->seq + 1, __ATOMIC_RELEASE);
+}
+
+/**
+@brief Update a maximum, between stats_begin() and stats_end().
+
+@param m[in,out] Maximum, restarted if it belongs to a previous interval.
+@param val[in] New value.
+*/
+static inline void stats_max(stats_max_t * m, uint32_t val) {
+    uint32_t epoch = __atomic_load_n(&stats_epoch, __ATOMIC_RELAXED);
+
+    if ((m->epoch != epoch) || (val > m->val)) {
+        m->val = val;
+        m->epoch = epoch;
+    }
+}
+
+/**
+@brief Get the maximum of the current interval from a copy of a block.
+
+@param m[in] Maximum, in the copy.
+@return Its value, 0 if it belongs to a previous interval.
+*/
+static inline uint32_t stats_max_get(const stats_max_t * m) {
+    return (m->epoch == stats_epoch) ? m->val : 0;
+}
+
+/**
+@brief Copy a block of counters consistently, without blocking its writer.
+
+@param block[in] Block, starting with its stats_seq_t.
+@param copy[out] Where the block is copied.
+@param size[in] Size of the block, in bytes.
+*/
+void stats_read(const void * block, void * copy, size_t size);
+
+/**
+@brief Start a new interval for the maximums, after the blocks are read.
+*/
+void stats_new_epoch(void);
+
+#endif
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,105 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    LoRa concentrator : UTC and GPS time of the received packets, without the
+    double precision math of lgw_cnt2utc() and lgw_cnt2gps()
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+
+#include <string.h>     /* memcmp */
+
+#include "timecache.h"
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE MACROS ------------------------------------------------------- */
+
+#define NS_PER_SEC          1000000000
+#define NS_PER_MS           1000000
+#define NS_PER_US           1000
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE FUNCTIONS DEFINITION ----------------------------------------- */
+
+/* Add a delta to a reference time, nanoseconds below 1 second */
+static void add_delta(const struct timespec * ref, uint32_t sec, uint32_t ns, struct timespec * t) {
+    t->tv_sec = ref->tv_sec + sec;
+    t->tv_nsec = ref->tv_nsec + ns;
+    if (t->tv_nsec >= NS_PER_SEC) {
+        t->tv_sec += 1;
+        t->tv_nsec -= NS_PER_SEC;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS DEFINITION ------------------------------------------ */
+
+void timecache_set_ref(struct timecache_s * c, const struct tref * ref) {
+    struct timespec t;
+    double f;
+
+    if ((c->valid == true) && (memcmp(&c->ref, ref, sizeof c->ref) == 0)) {
+        return;
+    }
+    c->ref = *ref;
+
+    /* the library checks the reference */
+    c->valid = (lgw_cnt2utc(*ref, ref->count_us, &t) == LGW_GPS_SUCCESS);
+    if (c->valid == false) {
+        return;
+    }
+
+    /* nanoseconds per counter tick, as lgw_cnt2utc() divides by 1E6 * xtal_err ticks per second */
+    f = 1E9 / (1E6 * ref->xtal_err);
+    c->ns_int = (uint32_t)f;
+    f = (f - c->ns_int) * 4294967296.0 + 0.5;
+    if (f >= 4294967296.0) {
+        c->ns_int += 1;
+        c->ns_frac = 0;
+    } else {
+        c->ns_frac = (uint32_t)f;
+    }
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+int timecache_convert(struct timecache_s * c, uint32_t count_us, struct timespec * utc, uint64_t * gps_ms) {
+    struct timespec gps;
+    uint32_t d, sec, ns, ns_ms;
+    uint64_t delta;
+
+    if (c->valid == false) {
+        return -1;
+    }
+
+    /* time since the reference, within 1 ns of the library */
+    d = count_us - c->ref.count_us;
+    delta = (uint64_t)d * c->ns_int + (((uint64_t)d * c->ns_frac) >> 32);
+    sec = (uint32_t)(delta / NS_PER_SEC);
+    ns = (uint32_t)(delta - (uint64_t)sec * NS_PER_SEC);
+    add_delta(&c->ref.utc, sec, ns, utc);
+    add_delta(&c->ref.gps, sec, ns, &gps);
+
+    /* 1 ns more or less would change the microsecond or the millisecond, let the library decide */
+    ns = utc->tv_nsec % NS_PER_US;
+    ns_ms = gps.tv_nsec % NS_PER_MS;
+    if ((ns == 0) || (ns == (NS_PER_US - 1)) || (ns_ms == 0) || (ns_ms >= (NS_PER_MS - NS_PER_US))) {
+        c->fallback_nb += 1;
+        lgw_cnt2utc(c->ref, count_us, utc);
+        lgw_cnt2gps(c->ref, count_us, &gps);
+        *gps_ms = gps.tv_sec * 1E3 + gps.tv_nsec / 1E6; /* rounded as thread_up did, 1 ms more within 122 ns of the next ms */
+        return 0;
+    }
+
+    *gps_ms = (uint64_t)gps.tv_sec * 1000 + (uint32_t)gps.tv_nsec / NS_PER_MS;
+    return 0;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
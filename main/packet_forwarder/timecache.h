@@ -0,0 +1,65 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    LoRa concentrator : UTC and GPS time of the received packets, without the
+    double precision math of lgw_cnt2utc() and lgw_cnt2gps()
+
+    The nanoseconds per counter tick are computed once per time reference, as
+    a 32.32 fixed point number, then each packet only needs integer math. The
+    result is the one of the library to within 1 ns, so the packets whose time
+    falls within 1 ns of a microsecond (UTC) or millisecond (GPS) boundary are
+    converted by the library, keeping the "time" and "tmms" fields identical.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+
+#ifndef _LORA_PKTFWD_TIMECACHE_H
+#define _LORA_PKTFWD_TIMECACHE_H
+
+
+#include <stdint.h>     /* C99 types */
+#include <stdbool.h>    /* bool type */
+#include <time.h>       /* timespec */
+
+#include "loragw_gps.h"
+
+
+struct timecache_s {
+    struct tref ref;        /* reference the factor was computed for */
+    bool        valid;      /* reference usable, as checked by the library */
+    uint32_t    ns_int;     /* nanoseconds per counter tick, integer part */
+    uint32_t    ns_frac;    /* and fractional part, 1/2^32 ns */
+    uint32_t    fallback_nb; /* packets converted by the library, near a rounding boundary */
+};
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS PROTOTYPES ------------------------------------------ */
+
+/**
+@brief Set the time reference of a batch of packets, the factor is only computed again if it changed.
+
+@param c[in,out] Cache.
+@param ref[in] Time reference, as used by lgw_cnt2utc().
+*/
+void timecache_set_ref(struct timecache_s * c, const struct tref * ref);
+
+/**
+@brief Convert a packet timestamp, as lgw_cnt2utc() and lgw_cnt2gps() do.
+
+@param c[in,out] Cache.
+@param count_us[in] Packet timestamp.
+@param utc[out] UTC time of the packet.
+@param gps_ms[out] GPS time of the packet, in ms since 06.Jan.1980.
+@return 0 if successful, -1 if the reference is not usable.
+*/
+int timecache_convert(struct timecache_s * c, uint32_t count_us, struct timespec * utc, uint64_t * gps_ms);
+
+#endif
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,374 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    LoRa concentrator : Packet Forwarder deferred logging
+
+    The ring holds records one after the other, each starting with a header
+    and padded to 8 bytes. A producer reserves its record by moving ring_head
+    with a compare-and-swap, fills it, then marks it ready. Records that would
+    cross the end of the ring start at its beginning, the end being reserved
+    as a padding record. The drain task prints the ready records in order from
+    ring_tail and gives their room back by moving ring_tail.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+
+#include <stdio.h>      /* vsnprintf, fwrite */
+#include <stdarg.h>     /* va_list */
+#include <stdlib.h>     /* calloc */
+#include <string.h>     /* memcpy, strcmp */
+#include <stdbool.h>    /* bool type */
+
+#include "trace.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE MACROS ------------------------------------------------------- */
+
+#define TRACE_LINE_MAX      256     /* longest message, truncated beyond */
+#define TRACE_RING_MIN      1024    /* smallest ring, in bytes */
+#define TRACE_DRAIN_MS      10      /* drain task sleep when the ring is empty */
+#define TRACE_DRAIN_STACK   3072    /* drain task stack, in bytes */
+#define TRACE_HEX_CHUNK     32      /* bytes of a binary record formatted at once */
+
+#define TRACE_REC_READY     0x01    /* record filled, set last */
+#define TRACE_REC_PAD       0x02    /* end of the ring, skipped */
+#define TRACE_REC_BIN       0x04    /* binary record, the prefix pointer follows the header */
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE TYPES -------------------------------------------------------- */
+
+struct trace_rec_s {
+    uint16_t            size;   /* bytes used in the ring, header included, multiple of 8 */
+    uint16_t            len;    /* bytes of text or data */
+    uint8_t             module; /* TRACE_MOD_xxx */
+    uint8_t             format; /* TRACE_BIN_xxx, binary records only */
+    uint8_t             rfu;
+    volatile uint8_t    flags;  /* TRACE_REC_xxx */
+};
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE VARIABLES ---------------------------------------------------- */
+
+static const char * const module_name[TRACE_MOD_NB] = {"main", "up", "down", "jit", "gps"};
+static const char * const level_name[] = {"error", "warning", "info", "debug"};
+
+static volatile uint8_t module_level[TRACE_MOD_NB] = {TRACE_LVL_INFO, TRACE_LVL_INFO, TRACE_LVL_INFO, TRACE_LVL_INFO, TRACE_LVL_INFO};
+static uint32_t module_dropped[TRACE_MOD_NB]; /* messages dropped, ring full */
+static uint32_t dropped_reported = 0; /* drops already reported by the drain task */
+
+static uint8_t * ring = NULL;
+static volatile uint32_t ring_size = 0; /* 0 until the drain task runs: synchronous logging */
+static volatile uint32_t ring_head = 0; /* bytes reserved since start */
+static volatile uint32_t ring_tail = 0; /* bytes consumed since start */
+
+static void out_stdout(const char * text, size_t len);
+static void (*output)(const char * text, size_t len) = out_stdout;
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE FUNCTIONS DEFINITION ----------------------------------------- */
+
+static void out_stdout(const char * text, size_t len) {
+    fwrite(text, 1, len, stdout);
+}
+
+/* Level and module of a MSG() from its prefix, "INFO: [up] ..." */
+static void msg_class(const char * fmt, int * level, int * module) {
+    int i;
+    size_t n;
+
+    *level = TRACE_LVL_INFO;
+    *module = TRACE_MOD_MAIN;
+    while (*fmt == '\n') {
+        fmt++;
+    }
+    if (strncmp(fmt, "ERROR", 5) == 0) {
+        *level = TRACE_LVL_ERROR;
+        fmt += 5;
+    } else if (strncmp(fmt, "WARNING", 7) == 0) {
+        *level = TRACE_LVL_WARNING;
+        fmt += 7;
+    } else if (strncmp(fmt, "INFO", 4) == 0) {
+        fmt += 4;
+    } else {
+        return;
+    }
+    while ((*fmt == ':') || (*fmt == ' ')) {
+        fmt++;
+    }
+    if (*fmt != '[') {
+        return;
+    }
+    for (i = 0; i < TRACE_MOD_NB; i++) {
+        n = strlen(module_name[i]);
+        if ((strncmp(fmt + 1, module_name[i], n) == 0) && (fmt[n + 1] == ']')) {
+            *module = i;
+            return;
+        }
+    }
+}
+
+/* Reserve a record of len bytes after the header and extra bytes, NULL if the ring is full */
+static struct trace_rec_s * rec_reserve(int module, uint32_t len) {
+    struct trace_rec_s * r;
+    uint32_t need = (sizeof *r + len + 7) & ~7u;
+    uint32_t head, tail, off, pad;
+
+    head = __atomic_load_n(&ring_head, __ATOMIC_RELAXED);
+    do {
+        tail = __atomic_load_n(&ring_tail, __ATOMIC_ACQUIRE);
+        off = head & (ring_size - 1);
+        pad = ((ring_size - off) < need) ? (ring_size - off) : 0;
+        if ((head + pad + need - tail) > ring_size) {
+            __atomic_fetch_add(&module_dropped[module], 1, __ATOMIC_RELAXED);
+            return NULL;
+        }
+    } while (__atomic_compare_exchange_n(&ring_head, &head, head + pad + need, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED) == false);
+
+    if (pad > 0) {
+        r = (struct trace_rec_s *)(ring + off);
+        r->size = (uint16_t)pad;
+        __atomic_store_n(&r->flags, TRACE_REC_READY | TRACE_REC_PAD, __ATOMIC_RELEASE);
+        off = 0;
+    }
+    r = (struct trace_rec_s *)(ring + off);
+    r->size = (uint16_t)need;
+    r->len = (uint16_t)len;
+    r->module = (uint8_t)module;
+    return r;
+}
+
+static void rec_commit(struct trace_rec_s * r, uint8_t flags) {
+    __atomic_store_n(&r->flags, flags | TRACE_REC_READY, __ATOMIC_RELEASE);
+}
+
+/* Print a binary record */
+static void bin_print(const char * prefix, const uint8_t * data, uint16_t size, int format) {
+    char hex[3 * TRACE_HEX_CHUNK + 1]; /* snprintf() null char */
+    int i, n;
+
+    output(prefix, strlen(prefix));
+    if (format == TRACE_BIN_TEXT) {
+        output((const char *)data, size);
+    } else {
+        for (i = 0; i < size; i += n) {
+            for (n = 0; (n < TRACE_HEX_CHUNK) && ((i + n) < size); n++) {
+                snprintf(&hex[3 * n], 4, "%02X ", data[i + n]);
+            }
+            output(hex, 3 * n);
+        }
+    }
+    output("\n", 1);
+}
+
+/* Format a message, synchronously or into the ring */
+static void msg_log(int module, const char * fmt, va_list ap) {
+    char line[TRACE_LINE_MAX];
+    struct trace_rec_s * r;
+    int len;
+
+    len = vsnprintf(line, sizeof line, fmt, ap);
+    if (len <= 0) {
+        return;
+    }
+    if (len >= (int)sizeof line) {
+        len = sizeof line - 1;
+        line[len - 1] = '\n'; /* truncated */
+    }
+    if (__atomic_load_n(&ring_size, __ATOMIC_ACQUIRE) == 0) {
+        output(line, len);
+        return;
+    }
+    r = rec_reserve(module, len);
+    if (r != NULL) {
+        memcpy(r + 1, line, len);
+        rec_commit(r, 0);
+    }
+}
+
+static void trace_drain(void * arg) {
+    (void)arg;
+
+    while (1) {
+        if (trace_flush() == 0) {
+            vTaskDelay(pdMS_TO_TICKS(TRACE_DRAIN_MS));
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS DEFINITION ------------------------------------------ */
+
+void trace_msg(const char * fmt, ...) {
+    va_list ap;
+    int level, module;
+
+    msg_class(fmt, &level, &module);
+    if (level > module_level[module]) {
+        return;
+    }
+    va_start(ap, fmt);
+    msg_log(module, fmt, ap);
+    va_end(ap);
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+void trace_printf(int level, int module, const char * fmt, ...) {
+    va_list ap;
+
+    if (level > module_level[module]) {
+        return;
+    }
+    va_start(ap, fmt);
+    msg_log(module, fmt, ap);
+    va_end(ap);
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+void trace_bin(int level, int module, const char * prefix, const void * data, uint16_t size, int format) {
+    struct trace_rec_s * r;
+
+    if (level > module_level[module]) {
+        return;
+    }
+    if (__atomic_load_n(&ring_size, __ATOMIC_ACQUIRE) == 0) {
+        bin_print(prefix, data, size, format);
+        return;
+    }
+    r = rec_reserve(module, sizeof prefix + size);
+    if (r != NULL) {
+        r->len = size;
+        r->format = (uint8_t)format;
+        memcpy(r + 1, &prefix, sizeof prefix);
+        memcpy((uint8_t *)(r + 1) + sizeof prefix, data, size);
+        rec_commit(r, TRACE_REC_BIN);
+    }
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+int trace_start(uint32_t size, unsigned priority) {
+    uint32_t pow2 = TRACE_RING_MIN;
+
+    if ((size == 0) || (ring != NULL)) {
+        return 0;
+    }
+    while ((pow2 * 2) <= size) {
+        pow2 *= 2;
+    }
+    if (pow2 > 0x8000) {
+        pow2 = 0x8000; /* record sizes are 16-bit */
+    }
+    ring = calloc(pow2, 1);
+    if (ring == NULL) {
+        return -1;
+    }
+
+    /* the ring is used once its size is published */
+    __atomic_store_n(&ring_size, pow2, __ATOMIC_RELEASE);
+    if (xTaskCreatePinnedToCore(trace_drain, "trace_drain", TRACE_DRAIN_STACK, NULL, priority, NULL, tskNO_AFFINITY) != pdPASS) {
+        __atomic_store_n(&ring_size, 0, __ATOMIC_RELEASE);
+        return -1; /* the ring is kept, producers may still hold records in it */
+    }
+    return 0;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+int trace_flush(void) {
+    struct trace_rec_s * r;
+    const char * prefix;
+    uint32_t tail = ring_tail;
+    uint32_t dropped = 0;
+    uint16_t size;
+    uint8_t flags;
+    char line[64];
+    int nb = 0;
+    int i;
+
+    while (tail != __atomic_load_n(&ring_head, __ATOMIC_ACQUIRE)) {
+        r = (struct trace_rec_s *)(ring + (tail & (ring_size - 1)));
+        flags = __atomic_load_n(&r->flags, __ATOMIC_ACQUIRE);
+        if ((flags & TRACE_REC_READY) == 0) {
+            break; /* still being written */
+        }
+        if ((flags & TRACE_REC_BIN) != 0) {
+            memcpy(&prefix, r + 1, sizeof prefix);
+            bin_print(prefix, (uint8_t *)(r + 1) + sizeof prefix, r->len, r->format);
+        } else if ((flags & TRACE_REC_PAD) == 0) {
+            output((const char *)(r + 1), r->len);
+        }
+        /* the whole record is cleared: a later header may land on any of its
+           8-byte slots, and must not be taken as ready before it is */
+        size = r->size;
+        memset(r, 0, size);
+        tail += size;
+        __atomic_store_n(&ring_tail, tail, __ATOMIC_RELEASE);
+        nb += 1;
+    }
+
+    for (i = 0; i < TRACE_MOD_NB; i++) {
+        dropped += __atomic_load_n(&module_dropped[i], __ATOMIC_RELAXED);
+    }
+    if (dropped != dropped_reported) {
+        i = snprintf(line, sizeof line, "WARNING: %u log messages dropped, log ring full\n", dropped - dropped_reported);
+        output(line, i);
+        dropped_reported = dropped;
+    }
+    return nb;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+void trace_set_output(void (*out)(const char * text, size_t len)) {
+    output = (out != NULL) ? out : out_stdout;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+int trace_set_level(const char * module, const char * level) {
+    int i, l;
+
+    for (l = 0; l <= TRACE_LVL_DEBUG; l++) {
+        if (strcmp(level, level_name[l]) == 0) {
+            break;
+        }
+    }
+    if (l > TRACE_LVL_DEBUG) {
+        return -1;
+    }
+    for (i = 0; i < TRACE_MOD_NB; i++) {
+        if ((strcmp(module, "all") == 0) || (strcmp(module, module_name[i]) == 0)) {
+            module_level[i] = (uint8_t)l;
+            if (strcmp(module, "all") != 0) {
+                return 0;
+            }
+        }
+    }
+    return (strcmp(module, "all") == 0) ? 0 : -1;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+uint32_t trace_get_module(int module, const char ** name, const char ** level) {
+    if (name != NULL) {
+        *name = module_name[module];
+    }
+    if (level != NULL) {
+        *level = level_name[module_level[module]];
+    }
+    return __atomic_load_n(&module_dropped[module], __ATOMIC_RELAXED);
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -9,6 +9,12 @@
 Description:
     LoRa concentrator : Packet Forwarder trace helpers
 
+    Messages are printed synchronously until trace_start() is called. After it,
+    they are formatted into a ring of records shared by all tasks without lock
+    and printed by a low priority drain task, so that the RX/TX tasks never
+    wait for the console. A message that does not fit in the ring is dropped
+    and counted. Levels are set per module and apply in both modes.
+
 License: Revised BSD License, see LICENSE.TXT file include in the project
 */
 
@@ -16,6 +22,9 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 #ifndef _LORA_PKTFWD_TRACE_H
 #define _LORA_PKTFWD_TRACE_H
 
+#include <stdint.h>     /* C99 types */
+#include <stddef.h>     /* size_t */
+
 #define DEBUG_PKT_FWD   0
 #define DEBUG_JIT       0
 #define DEBUG_JIT_ERROR 1
@@ -23,17 +32,109 @@ License: Revised BSD License, see LICENSE.TXT file include in the project
 #define DEBUG_BEACON    0
 #define DEBUG_LOG       1
 
-#define MSG(args...) printf(args) /* message that is destined to the user */
+/* Log levels, the level of a MSG() is taken from its "ERROR:", "WARNING:" or "INFO:" prefix */
+#define TRACE_LVL_ERROR     0
+#define TRACE_LVL_WARNING   1
+#define TRACE_LVL_INFO      2
+#define TRACE_LVL_DEBUG     3
+
+/* Log modules, the module of a MSG() is taken from the "[up]" like tag after its prefix */
+#define TRACE_MOD_MAIN      0   /* untagged and [main] messages */
+#define TRACE_MOD_UP        1
+#define TRACE_MOD_DOWN      2
+#define TRACE_MOD_JIT       3
+#define TRACE_MOD_GPS       4
+#define TRACE_MOD_NB        5
+
+/* Formats of the binary records, turned into text by the drain task */
+#define TRACE_BIN_TEXT      0   /* data printed as a string */
+#define TRACE_BIN_HEX       1   /* data printed as hex bytes */
+
+#define MSG(args...) trace_msg(args) /* message that is destined to the user */
+/* compile time debug messages, logged at the info level of the main module */
 #define MSG_DEBUG(FLAG, fmt, ...)                                                                         \
             do  {                                                                                         \
                 if (FLAG)                                                                                 \
-                    fprintf(stdout, "%s:%d:%s(): " fmt, __FILE__, __LINE__, __FUNCTION__, ##__VA_ARGS__); \
+                    trace_printf(TRACE_LVL_INFO, TRACE_MOD_MAIN, "%s:%d:%s(): " fmt, __FILE__, __LINE__, __FUNCTION__, ##__VA_ARGS__); \
             } while (0)
 #define MSG_PRINTF(FLAG, fmt, ...)                                                                         \
             do  {                                                                                         \
                 if (FLAG)                                                                                 \
-                    fprintf(stdout, fmt, ##__VA_ARGS__); \
+                    trace_printf(TRACE_LVL_INFO, TRACE_MOD_MAIN, fmt, ##__VA_ARGS__); \
             } while (0)
 
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS PROTOTYPES ------------------------------------------ */
+
+/**
+@brief Log a message, its level and module are taken from its prefix.
+
+@param fmt[in] printf format, starting with "ERROR:", "WARNING:" or "INFO:" and an optional "[module]" tag.
+*/
+void trace_msg(const char * fmt, ...) __attribute__ ((format (printf, 1, 2)));
+
+/**
+@brief Log a message with an explicit level and module.
+
+@param level[in] TRACE_LVL_xxx.
+@param module[in] TRACE_MOD_xxx.
+@param fmt[in] printf format.
+*/
+void trace_printf(int level, int module, const char * fmt, ...) __attribute__ ((format (printf, 3, 4)));
+
+/**
+@brief Log a block of data, copied as is in the ring and formatted by the drain task.
+
+@param level[in] TRACE_LVL_xxx.
+@param module[in] TRACE_MOD_xxx.
+@param prefix[in] Text printed before the data, must be a string constant.
+@param data[in] Data.
+@param size[in] Its size, in bytes.
+@param format[in] TRACE_BIN_TEXT or TRACE_BIN_HEX.
+*/
+void trace_bin(int level, int module, const char * prefix, const void * data, uint16_t size, int format);
+
+/**
+@brief Switch to deferred logging, with its drain task.
+
+@param ring_size[in] Size of the ring, in bytes, rounded down to a power of 2 (0: logging stays synchronous).
+@param priority[in] Priority of the drain task.
+@return 0 if successful, -1 if the ring or the task could not be created.
+*/
+int trace_start(uint32_t ring_size, unsigned priority);
+
+/**
+@brief Print the messages in the ring, called by the drain task.
+
+@return Number of records consumed.
+*/
+int trace_flush(void);
+
+/**
+@brief Set the output of the messages, stdout by default.
+
+@param out[in] Function writing len bytes of text, NULL for stdout.
+*/
+void trace_set_output(void (*out)(const char * text, size_t len));
+
+/**
+@brief Set the level of a module, or of all of them.
+
+@param module[in] Module name ("main", "up", "down", "jit", "gps") or "all".
+@param level[in] Level name ("error", "warning", "info", "debug").
+@return 0 if successful, -1 if a name is unknown.
+*/
+int trace_set_level(const char * module, const char * level);
+
+/**
+@brief Get the level and drop counter of a module.
+
+@param module[in] TRACE_MOD_xxx.
+@param name[out] Module name, NULL if not needed.
+@param level[out] Level name, NULL if not needed.
+@return Number of messages of the module dropped since start, ring full.
+*/
+uint32_t trace_get_module(int module, const char ** name, const char ** level);
+
 #endif
 /* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,508 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    LoRa concentrator : JSON parsing of the downlinks (txpk), without allocation
+    The grammar is the one of the parser of parson (libtools/parson.c), step by
+    step, quirks included: the first char of a key is skipped whatever it is,
+    numbers are what strtod() takes but hexadecimal and leading zeros, "\u0000"
+    ends a string, duplicate keys are refused, and so on. Only the values of
+    the txpk fields are kept, no tree is built.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+
+#include <stdlib.h>     /* strtod */
+#include <string.h>     /* strcmp, strncmp, strstr */
+#include <ctype.h>      /* isspace, isxdigit */
+
+#include "txpk_json.h"
+
+
+#define MAX_NESTING         19      /* as parson */
+#define OBJECT_MAX_KEYS     960     /* OBJECT_MAX_CAPACITY of parson */
+#define ARRAY_MAX_VALUES    122880  /* ARRAY_MAX_CAPACITY of parson */
+
+#define SKIP_WHITESPACES(p) while (isspace(*(p))) { (p)++; }
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE TYPES -------------------------------------------------------- */
+
+/* What an object is to the PULL_RESP */
+enum obj_role_e {
+    OBJ_ROOT,
+    OBJ_TXPK,
+    OBJ_OTHER
+};
+
+typedef struct {
+    char * json;
+    char * pos;
+    struct txpk_json_s * txpk;
+    int key_nb;         /* in txpk->key */
+    bool too_big;
+    bool txpk_found;
+} txpk_parser_t;
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE VARIABLES ---------------------------------------------------- */
+
+static const char * const field_name[TXPK_FIELD_NB] = {
+    [TXPK_IMME] = "imme",
+    [TXPK_TMST] = "tmst",
+    [TXPK_TMMS] = "tmms",
+    [TXPK_FREQ] = "freq",
+    [TXPK_RFCH] = "rfch",
+    [TXPK_POWE] = "powe",
+    [TXPK_MODU] = "modu",
+    [TXPK_DATR] = "datr",
+    [TXPK_CODR] = "codr",
+    [TXPK_FDEV] = "fdev",
+    [TXPK_IPOL] = "ipol",
+    [TXPK_PREA] = "prea",
+    [TXPK_SIZE] = "size",
+    [TXPK_DATA] = "data",
+    [TXPK_NCRC] = "ncrc",
+    [TXPK_NHDR] = "nhdr"
+};
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE FUNCTIONS DECLARATION ---------------------------------------- */
+
+static bool parse_value(txpk_parser_t * ps, size_t nesting, enum obj_role_e role, struct txpk_json_val_s * val);
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE FUNCTIONS DEFINITION ----------------------------------------- */
+
+/* Blank comments out, as parson does on its copy of the JSON */
+static void remove_comments(char * s, const char * start_token, const char * end_token) {
+    bool in_string = false, escaped = false;
+    size_t start_len = strlen(start_token);
+    size_t end_len = strlen(end_token);
+    char * end;
+
+    for (; *s != '\0'; s++) {
+        if ((*s == '\\') && (escaped == false)) {
+            escaped = true;
+            continue;
+        } else if ((*s == '"') && (escaped == false)) {
+            in_string = !in_string;
+        } else if ((in_string == false) && (*s == *start_token) && (strncmp(s, start_token, start_len) == 0)) {
+            memset(s, ' ', start_len);
+            s += start_len;
+            end = strstr(s, end_token);
+            if (end == NULL) {
+                return; /* the rest of the comment is left */
+            }
+            memset(s, ' ', (end - s) + end_len);
+            s = end + end_len - 1;
+        }
+        escaped = false;
+    }
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+static inline bool is_utf16_hex(const char * s) {
+    return isxdigit((unsigned char)s[0]) && isxdigit((unsigned char)s[1]) && isxdigit((unsigned char)s[2]) && isxdigit((unsigned char)s[3]);
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+static unsigned hex4(const char * s) {
+    unsigned v = 0;
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        v = (v << 4) | (unsigned)(isdigit((unsigned char)s[i]) ? (s[i] - '0') : ((s[i] | 0x20) - 'a' + 10));
+    }
+    return v;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+/* Decode \uXXXX (or a surrogate pair) as UTF-8, *in at the 'u', *out where the
+   first byte goes; both are left on the last char read and written */
+static bool parse_utf16(const char ** in, char ** out) {
+    const char * p = *in + 1;
+    char * o = *out;
+    unsigned cp, lead, trail;
+
+    if (is_utf16_hex(p) == false) {
+        return false;
+    }
+    cp = hex4(p);
+    if (cp < 0x80) {
+        *o = cp;
+    } else if (cp < 0x800) {
+        *o++ = ((cp >> 6) & 0x1F) | 0xC0;
+        *o   = ((cp     ) & 0x3F) | 0x80;
+    } else if ((cp < 0xD800) || (cp > 0xDFFF)) {
+        *o++ = ((cp >> 12) & 0x0F) | 0xE0;
+        *o++ = ((cp >> 6)  & 0x3F) | 0x80;
+        *o   = ((cp     )  & 0x3F) | 0x80;
+    } else if (cp <= 0xDBFF) {
+        lead = cp;
+        p += 4;
+        if ((*p++ != '\\') || (*p++ != 'u') || (is_utf16_hex(p) == false)) {
+            return false;
+        }
+        trail = hex4(p);
+        if ((trail < 0xDC00) || (trail > 0xDFFF)) {
+            return false;
+        }
+        cp = ((((lead - 0xD800) & 0x3FF) << 10) | ((trail - 0xDC00) & 0x3FF)) + 0x010000;
+        *o++ = ((cp >> 18) & 0x07) | 0xF0;
+        *o++ = ((cp >> 12) & 0x3F) | 0x80;
+        *o++ = ((cp >> 6)  & 0x3F) | 0x80;
+        *o   = ((cp     )  & 0x3F) | 0x80;
+    } else {
+        return false; /* trail surrogate first */
+    }
+    *in = p + 3;
+    *out = o;
+    return true;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+/* Parse a string, unescaped in place: the decoded string is never longer than
+   the escaped one. The first char is taken as the opening quote, whatever it is.
+   Return the null-terminated string, NULL if invalid. */
+static char * parse_string(txpk_parser_t * ps) {
+    char * start = ps->pos;
+    const char * in;
+    char * out;
+    char * end;
+
+    /* skip to the closing quote */
+    ps->pos++;
+    while (*ps->pos != '"') {
+        if (*ps->pos == '\0') {
+            return NULL;
+        }
+        if (*ps->pos == '\\') {
+            ps->pos++;
+            if (*ps->pos == '\0') {
+                return NULL;
+            }
+        }
+        ps->pos++;
+    }
+    end = ps->pos;
+    ps->pos++;
+    if (*ps->pos == '\0') {
+        return NULL;
+    }
+
+    /* unescape */
+    for (in = out = start + 1; (*in != '\0') && (in < end); in++, out++) {
+        if (*in == '\\') {
+            in++;
+            switch (*in) {
+                case '"':  *out = '"';  break;
+                case '\\': *out = '\\'; break;
+                case '/':  *out = '/';  break;
+                case 'b':  *out = '\b'; break;
+                case 'f':  *out = '\f'; break;
+                case 'n':  *out = '\n'; break;
+                case 'r':  *out = '\r'; break;
+                case 't':  *out = '\t'; break;
+                case 'u':
+                    if (parse_utf16(&in, &out) == false) {
+                        return NULL;
+                    }
+                    break;
+                default:
+                    return NULL;
+            }
+        } else if ((unsigned char)*in < 0x20) {
+            return NULL;
+        } else {
+            *out = *in;
+        }
+    }
+    *out = '\0';
+
+    return start + 1;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+static bool is_decimal(const char * s, size_t len) {
+    if ((len > 1) && (s[0] == '0') && (s[1] != '.')) {
+        return false;
+    }
+    if ((len > 2) && (strncmp(s, "-0", 2) == 0) && (s[2] != '.')) {
+        return false;
+    }
+    while (len--) {
+        if ((s[len] == 'x') || (s[len] == 'X')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+static struct txpk_json_val_s * txpk_field(struct txpk_json_s * txpk, const char * key) {
+    int i;
+
+    /* all names are 4 chars long */
+    if ((key[0] == '\0') || (key[1] == '\0') || (key[2] == '\0') || (key[3] == '\0') || (key[4] != '\0')) {
+        return NULL;
+    }
+    for (i = 0; i < TXPK_FIELD_NB; i++) {
+        if (memcmp(key, field_name[i], 4) == 0) {
+            return &(txpk->field[i]);
+        }
+    }
+    return NULL;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+static bool parse_object(txpk_parser_t * ps, size_t nesting, enum obj_role_e role) {
+    int key_first = ps->key_nb; /* keys of this object, above those of the enclosing ones */
+    enum obj_role_e child;
+    struct txpk_json_val_s * val;
+    char * key;
+    int i;
+
+    ps->pos++;
+    SKIP_WHITESPACES(ps->pos);
+    if (*ps->pos == '}') {
+        ps->pos++;
+        if (role == OBJ_TXPK) {
+            ps->txpk_found = true;
+        }
+        return true;
+    }
+    while (*ps->pos != '\0') {
+        key = parse_string(ps);
+        SKIP_WHITESPACES(ps->pos);
+        if ((key == NULL) || (*ps->pos != ':')) {
+            return false;
+        }
+        ps->pos++;
+
+        child = OBJ_OTHER;
+        val = NULL;
+        if ((role == OBJ_ROOT) && (strcmp(key, "txpk") == 0)) {
+            child = OBJ_TXPK;
+        } else if (role == OBJ_TXPK) {
+            val = txpk_field(ps->txpk, key);
+        }
+        if (parse_value(ps, nesting, child, val) == false) {
+            return false;
+        }
+
+        /* json_object_add(): no more than its capacity, no duplicate */
+        if ((ps->key_nb - key_first) >= OBJECT_MAX_KEYS) {
+            return false;
+        }
+        for (i = key_first; i < ps->key_nb; i++) {
+            if (strcmp(ps->json + ps->txpk->key[i], key) == 0) {
+                return false;
+            }
+        }
+        if (ps->key_nb == TXPK_JSON_KEY_MAX) {
+            ps->too_big = true;
+            return false;
+        }
+        ps->txpk->key[ps->key_nb++] = (uint16_t)(key - ps->json);
+
+        SKIP_WHITESPACES(ps->pos);
+        if (*ps->pos != ',') {
+            break;
+        }
+        ps->pos++;
+        SKIP_WHITESPACES(ps->pos);
+    }
+    SKIP_WHITESPACES(ps->pos);
+    if (*ps->pos != '}') {
+        return false;
+    }
+    ps->pos++;
+    ps->key_nb = key_first;
+    if (role == OBJ_TXPK) {
+        ps->txpk_found = true;
+    }
+
+    return true;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+static bool parse_array(txpk_parser_t * ps, size_t nesting) {
+    uint32_t count = 0;
+
+    ps->pos++;
+    SKIP_WHITESPACES(ps->pos);
+    if (*ps->pos == ']') {
+        ps->pos++;
+        return true;
+    }
+    while (*ps->pos != '\0') {
+        if (parse_value(ps, nesting, OBJ_OTHER, NULL) == false) {
+            return false;
+        }
+        if (count >= ARRAY_MAX_VALUES) {
+            return false;
+        }
+        count += 1;
+        SKIP_WHITESPACES(ps->pos);
+        if (*ps->pos != ',') {
+            break;
+        }
+        ps->pos++;
+        SKIP_WHITESPACES(ps->pos);
+    }
+    SKIP_WHITESPACES(ps->pos);
+    if (*ps->pos != ']') {
+        return false;
+    }
+    ps->pos++;
+
+    return true;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+/* Parse a value, kept in val if not NULL */
+static bool parse_value(txpk_parser_t * ps, size_t nesting, enum obj_role_e role, struct txpk_json_val_s * val) {
+    struct txpk_json_val_s v;
+    char * end;
+
+    if (nesting > MAX_NESTING) {
+        return false;
+    }
+    SKIP_WHITESPACES(ps->pos);
+    switch (*ps->pos) {
+        case '{':
+            if (parse_object(ps, nesting + 1, role) == false) {
+                return false;
+            }
+            v.type = TXPK_JSON_OBJECT;
+            break;
+        case '[':
+            if (parse_array(ps, nesting + 1) == false) {
+                return false;
+            }
+            v.type = TXPK_JSON_ARRAY;
+            break;
+        case '"':
+            v.u.string = parse_string(ps);
+            if (v.u.string == NULL) {
+                return false;
+            }
+            v.type = TXPK_JSON_STRING;
+            break;
+        case 'f':
+        case 't':
+            if (strncmp("true", ps->pos, 4) == 0) {
+                ps->pos += 4;
+                v.u.boolean = 1;
+            } else if (strncmp("false", ps->pos, 5) == 0) {
+                ps->pos += 5;
+                v.u.boolean = 0;
+            } else {
+                return false;
+            }
+            v.type = TXPK_JSON_BOOLEAN;
+            break;
+        case '-':
+        case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9':
+            v.u.number = strtod(ps->pos, &end);
+            if (is_decimal(ps->pos, end - ps->pos) == false) {
+                return false;
+            }
+            ps->pos = end;
+            v.type = TXPK_JSON_NUMBER;
+            break;
+        case 'n':
+            if (strncmp("null", ps->pos, 4) != 0) {
+                return false;
+            }
+            ps->pos += 4;
+            v.type = TXPK_JSON_NULL;
+            break;
+        default:
+            return false;
+    }
+    if (val != NULL) {
+        *val = v;
+    }
+
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS DEFINITION ------------------------------------------ */
+
+enum txpk_json_error_e txpk_json_parse(char * json, struct txpk_json_s * txpk) {
+    txpk_parser_t ps = {
+        .json = json,
+        .pos = json,
+        .txpk = txpk,
+        .key_nb = 0,
+        .too_big = false,
+        .txpk_found = false
+    };
+    int i;
+
+    for (i = 0; i < TXPK_FIELD_NB; i++) {
+        txpk->field[i].type = TXPK_JSON_ABSENT;
+    }
+
+    /* a pass does nothing without its start token, which is seldom there */
+    if (strstr(json, "/*") != NULL) {
+        remove_comments(json, "/*", "*/");
+    }
+    if (strstr(json, "//") != NULL) {
+        remove_comments(json, "//", "\n");
+    }
+    SKIP_WHITESPACES(ps.pos);
+    if ((*ps.pos != '{') && (*ps.pos != '[')) {
+        return TXPK_JSON_INVALID;
+    }
+    if (parse_value(&ps, 0, OBJ_ROOT, NULL) == false) {
+        return (ps.too_big == true) ? TXPK_JSON_TOO_BIG : TXPK_JSON_INVALID;
+    }
+
+    return (ps.txpk_found == true) ? TXPK_JSON_OK : TXPK_JSON_NO_TXPK;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+bool txpk_json_has(const struct txpk_json_s * txpk, enum txpk_json_field_e f) {
+    return txpk->field[f].type != TXPK_JSON_ABSENT;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+double txpk_json_number(const struct txpk_json_s * txpk, enum txpk_json_field_e f) {
+    return (txpk->field[f].type == TXPK_JSON_NUMBER) ? txpk->field[f].u.number : 0;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+int txpk_json_boolean(const struct txpk_json_s * txpk, enum txpk_json_field_e f) {
+    return (txpk->field[f].type == TXPK_JSON_BOOLEAN) ? txpk->field[f].u.boolean : -1;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+const char * txpk_json_string(const struct txpk_json_s * txpk, enum txpk_json_field_e f) {
+    return (txpk->field[f].type == TXPK_JSON_STRING) ? txpk->field[f].u.string : NULL;
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,122 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    LoRa concentrator : JSON parsing of the downlinks (txpk), without allocation
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+
+#ifndef _LORA_PKTFWD_TXPK_JSON_H
+#define _LORA_PKTFWD_TXPK_JSON_H
+
+
+#include <stdint.h>     /* C99 types */
+#include <stdbool.h>    /* bool type */
+
+
+/* keys of the objects being parsed at once, a key taking at least 4 chars of
+   JSON ("":0) that is enough for any PULL_RESP of up to 1 kB */
+#define TXPK_JSON_KEY_MAX   256
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC TYPES --------------------------------------------------------- */
+
+/* fields of the txpk object, see PROTOCOL.md */
+enum txpk_json_field_e {
+    TXPK_IMME,
+    TXPK_TMST,
+    TXPK_TMMS,
+    TXPK_FREQ,
+    TXPK_RFCH,
+    TXPK_POWE,
+    TXPK_MODU,
+    TXPK_DATR,
+    TXPK_CODR,
+    TXPK_FDEV,
+    TXPK_IPOL,
+    TXPK_PREA,
+    TXPK_SIZE,
+    TXPK_DATA,
+    TXPK_NCRC,
+    TXPK_NHDR,
+    TXPK_FIELD_NB
+};
+
+/* JSON types, as parson has them, TXPK_JSON_ABSENT for a field not in the object */
+enum txpk_json_type_e {
+    TXPK_JSON_ABSENT = 0,
+    TXPK_JSON_NULL,
+    TXPK_JSON_STRING,
+    TXPK_JSON_NUMBER,
+    TXPK_JSON_OBJECT,
+    TXPK_JSON_ARRAY,
+    TXPK_JSON_BOOLEAN
+};
+
+enum txpk_json_error_e {
+    TXPK_JSON_OK = 0,
+    TXPK_JSON_INVALID,      /* not JSON */
+    TXPK_JSON_NO_TXPK,      /* no "txpk" object in the root object */
+    TXPK_JSON_TOO_BIG       /* more than TXPK_JSON_KEY_MAX keys */
+};
+
+struct txpk_json_val_s {
+    enum txpk_json_type_e type;
+    union {
+        double number;
+        int boolean;
+        const char * string; /* in the parsed JSON */
+    } u;
+};
+
+struct txpk_json_s {
+    struct txpk_json_val_s field[TXPK_FIELD_NB];
+    uint16_t key[TXPK_JSON_KEY_MAX]; /* keys of the objects being parsed, offsets in the JSON */
+};
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS PROTOTYPES ------------------------------------------ */
+
+/**
+@brief Parse a PULL_RESP JSON payload, keeping the fields of its txpk object.
+
+The documents accepted are those of json_parse_string_with_comments() of
+parson, with its quirks, and the fields get the types and values parson would
+give them. Nothing is allocated: comments are blanked out and strings unescaped
+in place, so the JSON is modified and the strings of the fields point in it.
+
+@param json[in,out] Null-terminated JSON, starting after the PULL_RESP header.
+@param txpk[out] Fields of the txpk object.
+@return TXPK_JSON_OK if the txpk object was found, an error otherwise.
+*/
+enum txpk_json_error_e txpk_json_parse(char * json, struct txpk_json_s * txpk);
+
+/**
+@brief Tell whether a field is in the txpk object, as json_object_get_value() != NULL.
+*/
+bool txpk_json_has(const struct txpk_json_s * txpk, enum txpk_json_field_e f);
+
+/**
+@brief Number of a field, 0 if not a number, as json_value_get_number().
+*/
+double txpk_json_number(const struct txpk_json_s * txpk, enum txpk_json_field_e f);
+
+/**
+@brief Boolean of a field, -1 if not a boolean, as json_value_get_boolean().
+*/
+int txpk_json_boolean(const struct txpk_json_s * txpk, enum txpk_json_field_e f);
+
+/**
+@brief String of a field, NULL if not a string, as json_value_get_string().
+*/
+const char * txpk_json_string(const struct txpk_json_s * txpk, enum txpk_json_field_e f);
+
+#endif
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,338 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    LoRa concentrator : uplink filter on DevAddr and JoinEUI
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+
+#include <string.h>     /* memset, strcmp */
+
+#include "upfilter.h"
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE MACROS ------------------------------------------------------- */
+
+#define MTYPE_JOIN_REQUEST  0
+#define MTYPE_UNCONF_UP     2
+#define MTYPE_CONF_UP       4
+#define MTYPE_REJOIN        6
+
+#define DATA_UP_MIN_SIZE    12  /* MHDR, FHDR without FOpts, MIC */
+#define JOIN_REQ_SIZE       23  /* MHDR, JoinEUI, DevEUI, DevNonce, MIC */
+#define REJOIN_1_SIZE       24  /* MHDR, type, JoinEUI, DevEUI, RJcount1, MIC */
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE CONSTANTS ---------------------------------------------------- */
+
+/* NwkID size of each NetID type, in bits (LoRaWAN Backend Interfaces, DevAddr assignment) */
+static const uint8_t nwkid_bits[8] = {6, 6, 9, 11, 12, 13, 15, 17};
+
+/* -------------------------------------------------------------------------- */
+/* --- PRIVATE FUNCTIONS DEFINITION ----------------------------------------- */
+
+/* Parse 1 to max_digits hex digits, with an optional 0x, up to a '\0' or a '-' */
+static const char * parse_hex(const char * str, int max_digits, uint64_t * val) {
+    int n = 0;
+    int d;
+
+    if ((str[0] == '0') && ((str[1] == 'x') || (str[1] == 'X'))) {
+        str += 2;
+    }
+    *val = 0;
+    for (; (*str != '\0') && (*str != '-'); str++, n++) {
+        if ((*str >= '0') && (*str <= '9')) {
+            d = *str - '0';
+        } else if ((*str >= 'a') && (*str <= 'f')) {
+            d = *str - 'a' + 10;
+        } else if ((*str >= 'A') && (*str <= 'F')) {
+            d = *str - 'A' + 10;
+        } else {
+            return NULL;
+        }
+        *val = (*val << 4) | (uint64_t)d;
+    }
+    return ((n > 0) && (n <= max_digits)) ? str : NULL;
+}
+
+/* Add a range, merged with those it overlaps or touches */
+static int range_add(struct upfilter_s * f, uint32_t first, uint32_t last) {
+    struct upfilter_range_s r[UPFILTER_RANGE_MAX + 1];
+    int i, n = 0;
+
+    /* copy the ranges before it, the merge of those touching it, then those after it */
+    for (i = 0; (i < f->range_nb) && (f->range[i].last < first) && ((first - f->range[i].last) > 1); i++) {
+        r[n++] = f->range[i];
+    }
+    for (; (i < f->range_nb) && ((f->range[i].first <= last) || ((f->range[i].first - last) == 1)); i++) {
+        first = (f->range[i].first < first) ? f->range[i].first : first;
+        last = (f->range[i].last > last) ? f->range[i].last : last;
+    }
+    r[n++] = (struct upfilter_range_s){first, last};
+    for (; i < f->range_nb; i++) {
+        r[n++] = f->range[i];
+    }
+    if (n > UPFILTER_RANGE_MAX) {
+        return -1;
+    }
+    memcpy(f->range, r, n * sizeof r[0]);
+    f->range_nb = n;
+    return 0;
+}
+
+/* Is the DevAddr in one of the ranges */
+static bool range_match(const struct upfilter_s * f, uint32_t addr) {
+    int lo = 0;
+    int hi = f->range_nb - 1;
+    int mid;
+
+    while (lo <= hi) {
+        mid = (lo + hi) / 2;
+        if (addr < f->range[mid].first) {
+            hi = mid - 1;
+        } else if (addr > f->range[mid].last) {
+            lo = mid + 1;
+        } else {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Hash of an EUI for the Bloom filter, 3 positions are taken from it */
+static uint64_t eui_hash(uint64_t eui) {
+    eui ^= eui >> 33;
+    eui *= 0xFF51AFD7ED558CCDULL;
+    eui ^= eui >> 33;
+    eui *= 0xC4CEB9FE1A85EC53ULL;
+    eui ^= eui >> 33;
+    return eui;
+}
+
+static bool eui_match(const struct upfilter_s * f, uint64_t eui) {
+    uint64_t h = eui_hash(eui);
+    uint32_t b;
+    int k, lo, hi, mid;
+
+    /* Bloom filter first, most EUIs of a deny list setup end here */
+    for (k = 0; k < 3; k++, h >>= 21) {
+        b = (uint32_t)h & (UPFILTER_BLOOM_BITS - 1);
+        if ((f->bloom[b / 32] & (1u << (b % 32))) == 0) {
+            return false;
+        }
+    }
+
+    /* exact search, the Bloom filter has false positives */
+    lo = 0;
+    hi = f->eui_nb - 1;
+    while (lo <= hi) {
+        mid = (lo + hi) / 2;
+        if (eui < f->eui[mid]) {
+            hi = mid - 1;
+        } else if (eui > f->eui[mid]) {
+            lo = mid + 1;
+        } else {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Little endian fields of the frames */
+static uint32_t get_le32(const uint8_t * b) {
+    return (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+}
+
+static uint64_t get_le64(const uint8_t * b) {
+    return (uint64_t)get_le32(b) | ((uint64_t)get_le32(b + 4) << 32);
+}
+
+/* Add the strings of a JSON array with one of the upfilter_add functions */
+static int parse_list(struct upfilter_s * f, const JSON_Object * conf, const char * name, int (*add)(struct upfilter_s *, const char *), const char ** err) {
+    JSON_Array * arr;
+    const char * str;
+    size_t i;
+
+    if (json_object_get_value(conf, name) == NULL) {
+        return 0;
+    }
+    arr = json_object_get_array(conf, name);
+    if (arr == NULL) {
+        *err = name;
+        return -1;
+    }
+    for (i = 0; i < json_array_get_count(arr); i++) {
+        str = json_array_get_string(arr, i);
+        if ((str == NULL) || (add(f, str) != 0)) {
+            *err = (str != NULL) ? str : name;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS DEFINITION ------------------------------------------ */
+
+void upfilter_clear(struct upfilter_s * f) {
+    memset(f, 0, sizeof *f);
+    f->devaddr_mode = UPFILTER_OFF;
+    f->joineui_mode = UPFILTER_OFF;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+int upfilter_set_mode(int * mode, const char * str) {
+    if (strcmp(str, "off") == 0) {
+        *mode = UPFILTER_OFF;
+    } else if (strcmp(str, "allow") == 0) {
+        *mode = UPFILTER_ALLOW;
+    } else if (strcmp(str, "deny") == 0) {
+        *mode = UPFILTER_DENY;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+int upfilter_add_netid(struct upfilter_s * f, const char * str) {
+    uint64_t netid;
+    const char * end;
+    int type, prefix_bits, addr_bits;
+    uint32_t first;
+
+    end = parse_hex(str, 6, &netid);
+    if ((end == NULL) || (*end != '\0')) {
+        return -1;
+    }
+
+    /* DevAddr: type+1 bits of prefix (type ones then a zero), the NwkID, then the NwkAddr */
+    type = (int)(netid >> 21);
+    prefix_bits = type + 1;
+    addr_bits = 32 - prefix_bits - nwkid_bits[type];
+    first = (uint32_t)(((1u << type) - 1) << 1) << (32 - prefix_bits);
+    first |= ((uint32_t)netid & ((1u << nwkid_bits[type]) - 1)) << addr_bits;
+    return range_add(f, first, first | ((1u << addr_bits) - 1));
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+int upfilter_add_devaddr(struct upfilter_s * f, const char * str) {
+    uint64_t first, last;
+    const char * end;
+
+    end = parse_hex(str, 8, &first);
+    if (end == NULL) {
+        return -1;
+    }
+    last = first;
+    if (*end == '-') {
+        end = parse_hex(end + 1, 8, &last);
+        if ((end == NULL) || (*end != '\0') || (last < first)) {
+            return -1;
+        }
+    }
+    return range_add(f, (uint32_t)first, (uint32_t)last);
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+int upfilter_add_joineui(struct upfilter_s * f, const char * str) {
+    uint64_t eui, h;
+    const char * end;
+    uint32_t b;
+    int i, k;
+
+    end = parse_hex(str, 16, &eui);
+    if ((end == NULL) || (*end != '\0')) {
+        return -1;
+    }
+
+    /* sorted insertion, duplicates ignored */
+    for (i = 0; (i < f->eui_nb) && (f->eui[i] < eui); i++);
+    if ((i < f->eui_nb) && (f->eui[i] == eui)) {
+        return 0;
+    }
+    if (f->eui_nb >= UPFILTER_EUI_MAX) {
+        return -1;
+    }
+    memmove(&f->eui[i + 1], &f->eui[i], (f->eui_nb - i) * sizeof f->eui[0]);
+    f->eui[i] = eui;
+    f->eui_nb += 1;
+
+    h = eui_hash(eui);
+    for (k = 0; k < 3; k++, h >>= 21) {
+        b = (uint32_t)h & (UPFILTER_BLOOM_BITS - 1);
+        f->bloom[b / 32] |= 1u << (b % 32);
+    }
+    return 0;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+int upfilter_parse(struct upfilter_s * f, const JSON_Object * conf, const char ** err) {
+    const char * str;
+
+    upfilter_clear(f);
+    str = json_object_get_string(conf, "devaddr_mode");
+    if ((str != NULL) && (upfilter_set_mode(&f->devaddr_mode, str) != 0)) {
+        *err = str;
+        return -1;
+    }
+    str = json_object_get_string(conf, "joineui_mode");
+    if ((str != NULL) && (upfilter_set_mode(&f->joineui_mode, str) != 0)) {
+        *err = str;
+        return -1;
+    }
+    if ((parse_list(f, conf, "netid", upfilter_add_netid, err) != 0) ||
+        (parse_list(f, conf, "devaddr", upfilter_add_devaddr, err) != 0) ||
+        (parse_list(f, conf, "joineui", upfilter_add_joineui, err) != 0)) {
+        return -1;
+    }
+    return 0;
+}
+
+/* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+int upfilter_check(const struct upfilter_s * f, const uint8_t * payload, uint16_t size) {
+    bool match;
+
+    if (size == 0) {
+        return UPFILTER_PASS;
+    }
+    switch (payload[0] >> 5) {
+        case MTYPE_UNCONF_UP:
+        case MTYPE_CONF_UP:
+            if ((f->devaddr_mode == UPFILTER_OFF) || (size < DATA_UP_MIN_SIZE)) {
+                return UPFILTER_PASS;
+            }
+            match = range_match(f, get_le32(&payload[1]));
+            return (match == (f->devaddr_mode == UPFILTER_ALLOW)) ? UPFILTER_PASS : UPFILTER_DROP_DEVADDR;
+        case MTYPE_JOIN_REQUEST:
+            if ((f->joineui_mode == UPFILTER_OFF) || (size != JOIN_REQ_SIZE)) {
+                return UPFILTER_PASS;
+            }
+            match = eui_match(f, get_le64(&payload[1]));
+            return (match == (f->joineui_mode == UPFILTER_ALLOW)) ? UPFILTER_PASS : UPFILTER_DROP_JOINEUI;
+        case MTYPE_REJOIN:
+            /* only the type 1 rejoin request carries the JoinEUI */
+            if ((f->joineui_mode == UPFILTER_OFF) || (size != REJOIN_1_SIZE) || (payload[1] != 1)) {
+                return UPFILTER_PASS;
+            }
+            match = eui_match(f, get_le64(&payload[2]));
+            return (match == (f->joineui_mode == UPFILTER_ALLOW)) ? UPFILTER_PASS : UPFILTER_DROP_JOINEUI;
+        default:
+            return UPFILTER_PASS;
+    }
+}
+
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,132 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    LoRa concentrator : uplink filter, run on the received packets before they
+    are serialized
+
+    Data uplinks are matched on their DevAddr against a table of ranges, built
+    from NetIDs (the DevAddr prefix of their NwkID) and explicit DevAddr ranges.
+    Join requests (and type 1 rejoin requests) are matched on their JoinEUI
+    against a set, a Bloom filter rejecting most EUIs before an exact search.
+    Each list is either disabled, an allow list or a deny list. Other frames
+    always pass. No locking is done here.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+
+#ifndef _LORA_PKTFWD_UPFILTER_H
+#define _LORA_PKTFWD_UPFILTER_H
+
+
+#include <stdint.h>     /* C99 types */
+#include <stdbool.h>    /* bool type */
+
+#include "parson.h"
+
+
+#define UPFILTER_RANGE_MAX  32      /* DevAddr ranges, after merging the overlapping ones */
+#define UPFILTER_EUI_MAX    32      /* JoinEUIs */
+#define UPFILTER_BLOOM_BITS 512     /* Bloom filter of the JoinEUIs, power of 2 */
+
+#define UPFILTER_OFF        0       /* list not used */
+#define UPFILTER_ALLOW      1       /* only the frames matching the list pass */
+#define UPFILTER_DENY       2       /* the frames matching the list are dropped */
+
+#define UPFILTER_PASS           0   /* frame to be forwarded */
+#define UPFILTER_DROP_DEVADDR   1   /* data frame dropped on its DevAddr */
+#define UPFILTER_DROP_JOINEUI   2   /* join request dropped on its JoinEUI */
+
+struct upfilter_range_s {
+    uint32_t    first;
+    uint32_t    last;
+};
+
+struct upfilter_s {
+    int         devaddr_mode;   /* UPFILTER_OFF, UPFILTER_ALLOW or UPFILTER_DENY */
+    int         range_nb;
+    struct upfilter_range_s range[UPFILTER_RANGE_MAX]; /* sorted, not overlapping */
+
+    int         joineui_mode;   /* UPFILTER_OFF, UPFILTER_ALLOW or UPFILTER_DENY */
+    int         eui_nb;
+    uint64_t    eui[UPFILTER_EUI_MAX]; /* sorted */
+    uint32_t    bloom[UPFILTER_BLOOM_BITS / 32];
+};
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS PROTOTYPES ------------------------------------------ */
+
+/**
+@brief Empty a filter, both lists disabled.
+
+@param f[out] Filter.
+*/
+void upfilter_clear(struct upfilter_s * f);
+
+/**
+@brief Set the mode of the DevAddr list or of the JoinEUI list.
+
+@param mode[out] f->devaddr_mode or f->joineui_mode.
+@param str[in] "off", "allow" or "deny".
+@return 0 if successful, -1 if str is not a mode.
+*/
+int upfilter_set_mode(int * mode, const char * str);
+
+/**
+@brief Add the DevAddr range of a NetID to the DevAddr list.
+
+@param f[in,out] Filter.
+@param str[in] NetID, 6 hex digits.
+@return 0 if successful, -1 if str is not a NetID or the list is full.
+*/
+int upfilter_add_netid(struct upfilter_s * f, const char * str);
+
+/**
+@brief Add a DevAddr range to the DevAddr list.
+
+@param f[in,out] Filter.
+@param str[in] "first-last" or a single DevAddr, 8 hex digits each.
+@return 0 if successful, -1 if str is not a range or the list is full.
+*/
+int upfilter_add_devaddr(struct upfilter_s * f, const char * str);
+
+/**
+@brief Add a JoinEUI to the JoinEUI list.
+
+@param f[in,out] Filter.
+@param str[in] JoinEUI, 16 hex digits.
+@return 0 if successful, -1 if str is not an EUI or the list is full.
+*/
+int upfilter_add_joineui(struct upfilter_s * f, const char * str);
+
+/**
+@brief Build a filter from its JSON configuration.
+
+@param f[out] Filter.
+@param conf[in] Object with the optional "devaddr_mode", "netid", "devaddr", "joineui_mode" and "joineui" fields.
+@param err[out] Value or field name that could not be used, on error.
+@return 0 if successful, -1 on the first error.
+*/
+int upfilter_parse(struct upfilter_s * f, const JSON_Object * conf, const char ** err);
+
+/**
+@brief Check if a received frame is to be forwarded.
+
+Only meant for frames received with a valid CRC, the others being forwarded or
+not as configured by forward_crc_error and forward_crc_disabled.
+
+@param f[in] Filter.
+@param payload[in] PHYPayload of the frame.
+@param size[in] Its size, in bytes.
+@return UPFILTER_PASS, or the reason why it is dropped.
+*/
+int upfilter_check(const struct upfilter_s * f, const uint8_t * payload, uint16_t size);
+
+#endif
+/* --- EOF ------------------------------------------------------------------ */
@@ -0,0 +1,350 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    Check the base64 codec against the byte-at-a-time reference it replaces:
+    every 3 bytes block at every position of the word loops, all payload sizes
+    and buffer alignments, invalid characters and buffer sizes. Then compare
+    their speed over payload sizes 1 to 255.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "base64.h"
+
+
+#define SIZE_MAX_TEST   255     /* largest LoRa payload */
+#define B64_LEN_MAX     341     /* 255 bytes = 340 chars + null char */
+#define BENCH_NB        200     /* runs per size */
+
+
+/* -------------------------------------------------------------------------- */
+/* --- REFERENCE, BYTE-AT-A-TIME CODEC -------------------------------------- */
+
+static char ref_code_to_char(uint8_t x)
+{
+    if (x <= 25) {
+        return 'A' + x;
+    } else if (x <= 51) {
+        return 'a' + (x-26);
+    } else if (x <= 61) {
+        return '0' + (x-52);
+    } else if (x == 62) {
+        return '+';
+    } else {
+        return '/';
+    }
+}
+
+static uint8_t ref_char_to_code(char x)
+{
+    if ((x >= 'A') && (x <= 'Z')) {
+        return (uint8_t)x - (uint8_t)'A';
+    } else if ((x >= 'a') && (x <= 'z')) {
+        return (uint8_t)x - (uint8_t)'a' + 26;
+    } else if ((x >= '0') && (x <= '9')) {
+        return (uint8_t)x - (uint8_t)'0' + 52;
+    } else if (x == '+') {
+        return 62;
+    } else if (x == '/') {
+        return 63;
+    } else {
+        return 0xFF;
+    }
+}
+
+/* bin_to_b64_nopad() as it was, output buffer assumed big enough */
+static int ref_encode(const uint8_t * in, int size, char * out)
+{
+    int i;
+    int full_blocks = size / 3;
+    int last_bytes = size % 3;
+    int last_chars = (last_bytes == 0) ? 0 : last_bytes + 1;
+    uint32_t b;
+
+    for (i=0; i < full_blocks; ++i) {
+        b  = (0xFF & in[3*i]    ) << 16;
+        b |= (0xFF & in[3*i + 1]) << 8;
+        b |=  0xFF & in[3*i + 2];
+        out[4*i + 0] = ref_code_to_char((b >> 18) & 0x3F);
+        out[4*i + 1] = ref_code_to_char((b >> 12) & 0x3F);
+        out[4*i + 2] = ref_code_to_char((b >> 6 ) & 0x3F);
+        out[4*i + 3] = ref_code_to_char( b        & 0x3F);
+    }
+    i = full_blocks;
+    if (last_chars == 0) {
+        out[4*i] =  0;
+    } else if (last_chars == 2) {
+        b  = (0xFF & in[3*i]    ) << 16;
+        out[4*i + 0] = ref_code_to_char((b >> 18) & 0x3F);
+        out[4*i + 1] = ref_code_to_char((b >> 12) & 0x3F);
+        out[4*i + 2] =  0;
+    } else if (last_chars == 3) {
+        b  = (0xFF & in[3*i]    ) << 16;
+        b |= (0xFF & in[3*i + 1]) << 8;
+        out[4*i + 0] = ref_code_to_char((b >> 18) & 0x3F);
+        out[4*i + 1] = ref_code_to_char((b >> 12) & 0x3F);
+        out[4*i + 2] = ref_code_to_char((b >> 6 ) & 0x3F);
+        out[4*i + 3] = 0;
+    }
+    return (4*full_blocks) + last_chars;
+}
+
+/* b64_to_bin_nopad() as it was, returning -1 on an invalid character instead of exiting */
+static int ref_decode(const char * in, int size, uint8_t * out)
+{
+    int i, j;
+    int full_blocks = size / 4;
+    int last_chars = size % 4;
+    int last_bytes = (last_chars == 0) ? 0 : last_chars - 1;
+    uint8_t c[4];
+    uint32_t b;
+
+    if (last_chars == 1) {
+        return -1;
+    }
+    for (i = 0; i < size; i++) {
+        if (ref_char_to_code(in[i]) == 0xFF) {
+            return -1;
+        }
+    }
+    for (i=0; i < full_blocks; ++i) {
+        for (j = 0; j < 4; j++) {
+            c[j] = ref_char_to_code(in[4*i + j]);
+        }
+        b  = (0x3F & c[0]) << 18;
+        b |= (0x3F & c[1]) << 12;
+        b |= (0x3F & c[2]) << 6;
+        b |=  0x3F & c[3];
+        out[3*i + 0] = (b >> 16) & 0xFF;
+        out[3*i + 1] = (b >> 8 ) & 0xFF;
+        out[3*i + 2] =  b        & 0xFF;
+    }
+    i = full_blocks;
+    if (last_bytes == 1) {
+        b  = (0x3F & ref_char_to_code(in[4*i]    )) << 18;
+        b |= (0x3F & ref_char_to_code(in[4*i + 1])) << 12;
+        out[3*i + 0] = (b >> 16) & 0xFF;
+    } else if (last_bytes == 2) {
+        b  = (0x3F & ref_char_to_code(in[4*i]    )) << 18;
+        b |= (0x3F & ref_char_to_code(in[4*i + 1])) << 12;
+        b |= (0x3F & ref_char_to_code(in[4*i + 2])) << 6;
+        out[3*i + 0] = (b >> 16) & 0xFF;
+        out[3*i + 1] = (b >> 8 ) & 0xFF;
+    }
+    return (3*full_blocks) + last_bytes;
+}
+
+/* -------------------------------------------------------------------------- */
+/* --- CHECKS --------------------------------------------------------------- */
+
+static uint32_t seed = 1;
+
+static uint8_t rand8(void)
+{
+    seed = seed * 1103515245 + 12345;
+    return seed >> 16;
+}
+
+/* all 3 bytes blocks, at the 4 positions of a 12 bytes word group */
+static bool check_blocks(void)
+{
+    static uint8_t bin[16] __attribute__((aligned(4)));
+    static uint8_t dec[16] __attribute__((aligned(4)));
+    static char b64[20] __attribute__((aligned(4)));
+    char ref[20];
+    uint32_t v, w[4];
+    int k;
+
+    for (v = 0; v < 0x1000000; v++) {
+        w[0] = v;
+        w[1] = (v + 0x555555) & 0xFFFFFF;
+        w[2] = ~v & 0xFFFFFF;
+        w[3] = (v * 0x9E3779) & 0xFFFFFF; /* odd multiplier: all values too */
+        for (k = 0; k < 4; k++) {
+            bin[3*k] = w[k] >> 16;
+            bin[3*k + 1] = w[k] >> 8;
+            bin[3*k + 2] = w[k];
+        }
+        ref_encode(bin, 12, ref);
+        if ((bin_to_b64_nopad(bin, 12, b64, sizeof b64) != 16) || (memcmp(b64, ref, 17) != 0)) {
+            printf("ERROR: block %06X encoded as \"%s\" instead of \"%s\"\n", v, b64, ref);
+            return false;
+        }
+        if ((b64_to_bin_nopad(b64, 16, dec, sizeof dec) != 12) || (memcmp(dec, bin, 12) != 0)) {
+            printf("ERROR: block %06X not decoded back from \"%s\"\n", v, b64);
+            return false;
+        }
+        if ((v & 0xFFFFF) == 0xFFFFF) {
+            vTaskDelay(1); /* feed the watchdog */
+        }
+    }
+    return true;
+}
+
+/* all sizes and alignments, with and without padding */
+static bool check_sizes(void)
+{
+    static uint8_t bin[SIZE_MAX_TEST + 4] __attribute__((aligned(4)));
+    static uint8_t dec[SIZE_MAX_TEST + 4] __attribute__((aligned(4)));
+    static char b64[B64_LEN_MAX + 8] __attribute__((aligned(4)));
+    char ref[B64_LEN_MAX + 4];
+    uint8_t ref_dec[SIZE_MAX_TEST + 4];
+    int size, a_in, a_out, i, len, pad_len;
+
+    for (size = 0; size <= SIZE_MAX_TEST; size++) {
+        for (a_in = 0; a_in < 4; a_in++) {
+            for (a_out = 0; a_out < 4; a_out++) {
+                for (i = 0; i < size; i++) {
+                    bin[a_in + i] = rand8();
+                }
+                len = ref_encode(bin + a_in, size, ref);
+                if ((bin_to_b64_nopad(bin + a_in, size, b64 + a_out, B64_LEN_MAX) != len) || (strcmp(b64 + a_out, ref) != 0)) {
+                    printf("ERROR: size %d (align %d/%d) encoded as \"%s\" instead of \"%s\"\n", size, a_in, a_out, b64 + a_out, ref);
+                    return false;
+                }
+                if ((b64_to_bin_nopad(b64 + a_out, len, dec + a_in, SIZE_MAX_TEST) != size) || (memcmp(dec + a_in, bin + a_in, size) != 0)) {
+                    printf("ERROR: size %d (align %d/%d) not decoded back\n", size, a_in, a_out);
+                    return false;
+                }
+                if ((ref_decode(b64 + a_out, len, ref_dec) != size) || (memcmp(ref_dec, bin + a_in, size) != 0)) {
+                    printf("ERROR: size %d not decoded back by the reference\n", size);
+                    return false;
+                }
+
+                /* padded */
+                pad_len = (len + 3) & ~3;
+                while (len < pad_len) {
+                    ref[len++] = '=';
+                }
+                ref[len] = 0;
+                if ((bin_to_b64(bin + a_in, size, b64 + a_out, B64_LEN_MAX + 2) != len) || (strcmp(b64 + a_out, ref) != 0)) {
+                    printf("ERROR: size %d (align %d/%d) padded as \"%s\" instead of \"%s\"\n", size, a_in, a_out, b64 + a_out, ref);
+                    return false;
+                }
+                if ((b64_to_bin(b64 + a_out, len, dec + a_out, SIZE_MAX_TEST) != size) || (memcmp(dec + a_out, bin + a_in, size) != 0)) {
+                    printf("ERROR: size %d (align %d/%d) not decoded back with padding\n", size, a_in, a_out);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/* invalid characters, at every position of a block and of a word group, and buffer sizes */
+static bool check_errors(void)
+{
+    static char b64[20] __attribute__((aligned(4)));
+    static uint8_t dec[16] __attribute__((aligned(4)));
+    int c, pos, len, ret;
+    bool valid;
+
+    for (c = 0; c < 256; c++) {
+        valid = (ref_char_to_code((char)c) != 0xFF);
+        for (len = 2; len <= 16; len++) {
+            if ((len % 4) == 1) {
+                continue;
+            }
+            for (pos = 0; pos < len; pos++) {
+                memcpy(b64, "QUJDREVGR0hJSktM", 16);
+                b64[pos] = (char)c;
+                ret = b64_to_bin_nopad(b64, len, dec, sizeof dec);
+                if ((ret < 0) == valid) {
+                    printf("ERROR: character 0x%02X at %d of %d decoded to %d\n", c, pos, len, ret);
+                    return false;
+                }
+            }
+        }
+    }
+    if ((b64_to_bin_nopad("QUJDR", 5, dec, sizeof dec) != -1) || (b64_to_bin_nopad("QUJD", 4, dec, 2) != -1) ||
+        (bin_to_b64_nopad((const uint8_t *)"ABC", 3, b64, 4) != -1) || (bin_to_b64((const uint8_t *)"AB", 2, b64, 4) != -1) ||
+        (b64_to_bin("QUI=", 4, dec, sizeof dec) != 2) || (b64_to_bin("QQ==", 4, dec, sizeof dec) != 1)) {
+        printf("ERROR: wrong result on buffer size or padding\n");
+        return false;
+    }
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+/* --- BENCHMARK ------------------------------------------------------------ */
+
+static void bench(void)
+{
+    static uint8_t bin[SIZE_MAX_TEST] __attribute__((aligned(4)));
+    static uint8_t dec[SIZE_MAX_TEST] __attribute__((aligned(4)));
+    static char b64[B64_LEN_MAX] __attribute__((aligned(4)));
+    int64_t t0, t_enc, t_dec, t_ref_enc, t_ref_dec;
+    int64_t sum_enc = 0, sum_dec = 0, sum_ref_enc = 0, sum_ref_dec = 0;
+    int size, i, len;
+
+    for (i = 0; i < SIZE_MAX_TEST; i++) {
+        bin[i] = rand8();
+    }
+    printf("size  encode ref/new (us)   decode ref/new (us)\n");
+    for (size = 1; size <= SIZE_MAX_TEST; size++) {
+        t0 = esp_timer_get_time();
+        for (i = 0; i < BENCH_NB; i++) {
+            ref_encode(bin, size, b64);
+        }
+        t_ref_enc = esp_timer_get_time() - t0;
+        t0 = esp_timer_get_time();
+        for (i = 0; i < BENCH_NB; i++) {
+            len = bin_to_b64_nopad(bin, size, b64, sizeof b64);
+        }
+        t_enc = esp_timer_get_time() - t0;
+        t0 = esp_timer_get_time();
+        for (i = 0; i < BENCH_NB; i++) {
+            ref_decode(b64, len, dec);
+        }
+        t_ref_dec = esp_timer_get_time() - t0;
+        t0 = esp_timer_get_time();
+        for (i = 0; i < BENCH_NB; i++) {
+            b64_to_bin_nopad(b64, len, dec, sizeof dec);
+        }
+        t_dec = esp_timer_get_time() - t0;
+
+        sum_enc += t_enc;
+        sum_dec += t_dec;
+        sum_ref_enc += t_ref_enc;
+        sum_ref_dec += t_ref_dec;
+        if ((size == 1) || (size == 16) || (size == 51) || (size == 128) || (size == SIZE_MAX_TEST)) {
+            printf("%4d  %8.3f %8.3f      %8.3f %8.3f\n", size,
+                    (double)t_ref_enc / BENCH_NB, (double)t_enc / BENCH_NB,
+                    (double)t_ref_dec / BENCH_NB, (double)t_dec / BENCH_NB);
+        }
+    }
+    printf("sizes 1-%d: encode %.2fx, decode %.2fx faster\n", SIZE_MAX_TEST,
+            (double)sum_ref_enc / sum_enc, (double)sum_ref_dec / sum_dec);
+}
+
+void app_main(void)
+{
+    bool ok = true;
+
+    printf("Beginning of base64 test\n");
+
+    ok = ok && check_errors();
+    ok = ok && check_sizes();
+    ok = ok && check_blocks();
+    bench();
+
+    printf("End of base64 test: %s\n", (ok == true) ? "SUCCESS" : "FAILURE");
+
+    while (1) {
+        vTaskDelay(8000 / portTICK_PERIOD_MS);
+    }
+}
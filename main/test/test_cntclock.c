@@ -0,0 +1,121 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    Check the extrapolated concentrator counter of cntclock.c on a simulated
+    concentrator: its clock runs off the local one by up to 100 ppm, and each
+    read takes a varying SPI access time. Reads come every 0.5 to 5 s, as
+    thread_jit does while packets are queued, across a counter wrap, and the
+    counter restarts once. The extrapolation error must stay within what
+    thread_jit allows between JIT_DISPATCH_LEAD_US and TX_JIT_DELAY.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "cntclock.h"
+
+
+#define READ_NB         20000       /* per drift */
+#define READ_SPI_MAX_US 200         /* SPI access time, mutex wait included */
+#define ERROR_MAX_US    1000        /* extrapolation error allowed, 5 s after a read */
+#define SETTLE_NB       10          /* reads before the drift is measured */
+
+static const int32_t drifts_ppb[] = {-100000, -37000, 0, 12500, 60000, 100000};
+
+static uint32_t seed = 1;
+
+static uint32_t rand32(void)
+{
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) | ((seed * 1103515245 + 12345) & 0xFFFF0000);
+}
+
+/* concentrator counter at a local time */
+static uint32_t counter(uint32_t origin, int32_t drift_ppb, int64_t local_us)
+{
+    return origin + (uint32_t)(local_us + local_us * drift_ppb / 1000000000);
+}
+
+static bool check_drift(int32_t drift_ppb, uint32_t * err_max)
+{
+    struct cntclock_s c = { .valid = false };
+    uint32_t origin = 0xFFFFFFFF - 60000000 - rand32() % 1000000; /* wraps after a minute */
+    int64_t local_us = 1000000;
+    int64_t t_read, spi_us, t;
+    uint32_t count_us;
+    int32_t err;
+    int i, j;
+
+    for (i = 0; i < READ_NB; i++) {
+        /* the counter restarts halfway */
+        if (i == (READ_NB / 2)) {
+            origin = rand32();
+        }
+
+        /* read, the counter being latched somewhere during the SPI access */
+        spi_us = rand32() % READ_SPI_MAX_US;
+        t_read = local_us + rand32() % (spi_us + 1);
+        cntclock_sync(&c, counter(origin, drift_ppb, t_read), local_us + spi_us / 2);
+
+        /* then extrapolate, until the next read */
+        local_us += spi_us + 500000 + rand32() % 4500000;
+        if ((i % (READ_NB / 2)) < SETTLE_NB) {
+            continue;
+        }
+        for (j = 0; j < 8; j++) {
+            t = c.local_us + rand32() % (uint32_t)(local_us - c.local_us);
+            count_us = counter(origin, drift_ppb, t);
+            err = (int32_t)(cntclock_count(&c, t) - count_us);
+            if ((uint32_t)abs(err) > *err_max) {
+                *err_max = abs(err);
+            }
+            if (abs(err) > ERROR_MAX_US) {
+                printf("ERROR: drift %d ppb, read %d: counter %u extrapolated with %d us error\n", drift_ppb, i, count_us, err);
+                return false;
+            }
+            if (llabs(cntclock_local(&c, cntclock_count(&c, t)) - t) > 1) {
+                printf("ERROR: drift %d ppb, read %d: local time %lld back as %lld\n", drift_ppb, i, (long long)t, (long long)cntclock_local(&c, cntclock_count(&c, t)));
+                return false;
+            }
+        }
+    }
+    if (abs(c.drift_ppb - drift_ppb) > 20000) {
+        printf("ERROR: drift %d ppb measured as %d ppb\n", drift_ppb, c.drift_ppb);
+        return false;
+    }
+    printf("drift %d ppb measured as %d ppb\n", drift_ppb, c.drift_ppb);
+    return true;
+}
+
+void app_main(void)
+{
+    bool ok = true;
+    uint32_t err_max = 0;
+    unsigned i;
+
+    printf("Beginning of counter clock test\n");
+
+    for (i = 0; (i < sizeof drifts_ppb / sizeof drifts_ppb[0]) && (ok == true); i++) {
+        ok = check_drift(drifts_ppb[i], &err_max);
+        vTaskDelay(1);
+    }
+    printf("max extrapolation error: %u us\n", err_max);
+
+    printf("End of counter clock test: %s\n", (ok == true) ? "SUCCESS" : "FAILURE");
+
+    while (1) {
+        vTaskDelay(8000 / portTICK_PERIOD_MS);
+    }
+}
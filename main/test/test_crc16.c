@@ -0,0 +1,152 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    Equivalence test and benchmark of the table-driven CRC16 (crc16.c)
+    against the bit-wise implementations it replaces: lora_crc16() of
+    loragw_sx1302.c and the beacon crc16() of lora_pkt_fwd.c.
+    Every (CRC register, input byte) pair is checked, which covers any
+    input sequence since a CRC only depends on its register and the next
+    byte. The benchmark reports CPU cycles per byte on 255-byte payloads.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "hal/cpu_hal.h"
+
+#include "crc16.h"
+
+
+#define BENCH_SIZE      255
+#define BENCH_LOOP_NB   1000
+
+/* reference: former lora_crc16() of loragw_sx1302.c */
+static void ref_lora_crc16(const char data, int *crc) {
+    int next = 0;
+    next  =  (((data>>0)&1) ^ ((*crc>>12)&1) ^ ((*crc>> 8)&1)                 )      ;
+    next += ((((data>>1)&1) ^ ((*crc>>13)&1) ^ ((*crc>> 9)&1)                 )<<1 ) ;
+    next += ((((data>>2)&1) ^ ((*crc>>14)&1) ^ ((*crc>>10)&1)                 )<<2 ) ;
+    next += ((((data>>3)&1) ^ ((*crc>>15)&1) ^ ((*crc>>11)&1)                 )<<3 ) ;
+    next += ((((data>>4)&1) ^ ((*crc>>12)&1)                                  )<<4 ) ;
+    next += ((((data>>5)&1) ^ ((*crc>>13)&1) ^ ((*crc>>12)&1) ^ ((*crc>> 8)&1))<<5 ) ;
+    next += ((((data>>6)&1) ^ ((*crc>>14)&1) ^ ((*crc>>13)&1) ^ ((*crc>> 9)&1))<<6 ) ;
+    next += ((((data>>7)&1) ^ ((*crc>>15)&1) ^ ((*crc>>14)&1) ^ ((*crc>>10)&1))<<7 ) ;
+    next += ((((*crc>>0)&1) ^ ((*crc>>15)&1) ^ ((*crc>>11)&1)                 )<<8 ) ;
+    next += ((((*crc>>1)&1) ^ ((*crc>>12)&1)                                  )<<9 ) ;
+    next += ((((*crc>>2)&1) ^ ((*crc>>13)&1)                                  )<<10) ;
+    next += ((((*crc>>3)&1) ^ ((*crc>>14)&1)                                  )<<11) ;
+    next += ((((*crc>>4)&1) ^ ((*crc>>15)&1) ^ ((*crc>>12)&1) ^ ((*crc>> 8)&1))<<12) ;
+    next += ((((*crc>>5)&1) ^ ((*crc>>13)&1) ^ ((*crc>> 9)&1)                 )<<13) ;
+    next += ((((*crc>>6)&1) ^ ((*crc>>14)&1) ^ ((*crc>>10)&1)                 )<<14) ;
+    next += ((((*crc>>7)&1) ^ ((*crc>>15)&1) ^ ((*crc>>11)&1)                 )<<15) ;
+    (*crc) = next;
+}
+
+static uint16_t ref_lora_payload_crc(const uint8_t * data, unsigned size) {
+    unsigned i;
+    int crc = 0;
+
+    for (i = 0; i < size; i++) {
+        ref_lora_crc16(data[i], &crc);
+    }
+    return (uint16_t)crc;
+}
+
+/* reference: former crc16() of lora_pkt_fwd.c, with a configurable initial value */
+static uint16_t ref_beacon_crc16(uint16_t x, const uint8_t * data, unsigned size) {
+    const uint16_t crc_poly = 0x1021;
+    unsigned i, j;
+
+    for (i=0; i<size; ++i) {
+        x ^= (uint16_t)data[i] << 8;
+        for (j=0; j<8; ++j) {
+            x = (x & 0x8000) ? (x<<1) ^ crc_poly : (x<<1);
+        }
+    }
+    return x;
+}
+
+static uint8_t payload[BENCH_SIZE];
+
+static double bench(uint16_t (*crc)(const uint8_t *, unsigned))
+{
+    int i;
+    uint32_t c0, cycles = 0;
+    volatile uint16_t sink = 0;
+
+    for (i = 0; i < BENCH_LOOP_NB; i++) {
+        c0 = cpu_hal_get_cycle_count();
+        sink ^= crc(payload, BENCH_SIZE);
+        cycles += cpu_hal_get_cycle_count() - c0;
+    }
+    (void)sink;
+
+    return (double)cycles / ((double)BENCH_LOOP_NB * BENCH_SIZE);
+}
+
+static uint16_t lora_ref(const uint8_t * data, unsigned size) { return ref_lora_payload_crc(data, size); }
+static uint16_t lora_tab(const uint8_t * data, unsigned size) { return crc16_lora_payload(0x0000, data, size); }
+static uint16_t ccitt_ref(const uint8_t * data, unsigned size) { return ref_beacon_crc16(0x0000, data, size); }
+static uint16_t ccitt_tab(const uint8_t * data, unsigned size) { return crc16_ccitt(0x0000, data, size); }
+
+void app_main(void)
+{
+    int reg, byte, crc;
+    uint8_t b;
+    uint32_t err_lora = 0, err_ccitt = 0;
+
+    printf("Beginning of CRC16 test\n");
+
+    /* exhaustive: one step from every register value with every byte */
+    for (reg = 0; reg < 0x10000; reg++) {
+        for (byte = 0; byte < 0x100; byte++) {
+            b = (uint8_t)byte;
+            crc = reg;
+            ref_lora_crc16((char)b, &crc);
+            if ((uint16_t)crc != crc16_lora_payload((uint16_t)reg, &b, 1)) {
+                err_lora++;
+            }
+            if (ref_beacon_crc16((uint16_t)reg, &b, 1) != crc16_ccitt((uint16_t)reg, &b, 1)) {
+                err_ccitt++;
+            }
+        }
+        if ((reg & 0x0FFF) == 0) {
+            vTaskDelay(1); /* let the idle task feed the watchdog */
+        }
+    }
+    printf("LoRa payload CRC: %u mismatches over 2^24 steps\n", err_lora);
+    printf("CCITT CRC:        %u mismatches over 2^24 steps\n", err_ccitt);
+
+    /* whole payloads, the way the callers use them */
+    for (byte = 0; byte < BENCH_SIZE; byte++) {
+        payload[byte] = (uint8_t)rand();
+    }
+    for (byte = 0; byte <= BENCH_SIZE; byte++) {
+        if (lora_ref(payload, byte) != lora_tab(payload, byte)) {
+            err_lora++;
+        }
+        if (ccitt_ref(payload, byte) != ccitt_tab(payload, byte)) {
+            err_ccitt++;
+        }
+    }
+
+    printf("LoRa payload CRC: bit-wise %.1f cycles/byte, table %.1f cycles/byte\n", bench(lora_ref), bench(lora_tab));
+    printf("CCITT CRC:        bit-wise %.1f cycles/byte, table %.1f cycles/byte\n", bench(ccitt_ref), bench(ccitt_tab));
+
+    printf("End of CRC16 test: %s\n", ((err_lora == 0) && (err_ccitt == 0)) ? "SUCCESS" : "FAILURE");
+
+    while (true) {
+        vTaskDelay(8000 / portTICK_PERIOD_MS);
+    }
+}
@@ -0,0 +1,500 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    Check the JiT queue (jitqueue.c) against the flat array it used to be,
+    sorted again after every change and scanned for every peek and collision
+    test. Random Class A/B/C downlinks and beacons are enqueued, then peeked and
+    dequeued as thread_jit does, with a few time jumps making packets missed.
+    Both queues must give the same results all along, with the concentrator
+    counter starting before 0x80000000 and 0xFFFFFFFF to wrap.
+    The reference orders packets with the same wrap-aware comparison, and drops
+    all the outdated packets when peeking.
+    Then compare the cost of a queue kept full, JIT_QUEUE_MAX packets, which can
+    be raised at build time to bench Class C bursts.
+    Last, a task enqueues Class C downlinks on RF chain 0 as fast as it can,
+    while another one dispatches packets on RF chain 1 as thread_jit does. The
+    dispatch time is measured with both queues sharing one lock, as they did
+    before, then with a lock each.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+
+#include "loragw_hal.h"
+#include "jitqueue.h"
+
+
+/* as in jitqueue.c */
+#define TX_START_DELAY          1500
+#define TX_MARGIN_DELAY         1000
+#define TX_JIT_DELAY            40000
+#define TX_MAX_ADVANCE_DELAY    ((JIT_NUM_BEACON_IN_QUEUE + 1) * 128 * 1E6)
+#define BEACON_GUARD            3000000
+#define BEACON_RESERVED         2120000
+
+#define STEP_NB                 200000  /* per counter origin */
+#define BENCH_NB                2000
+#define BENCH_SPACING           100000  /* between packets of the full queue, in us */
+#define CONTENTION_MS           2000    /* per contention run */
+
+struct ref_queue_s {
+    int num_pkt;
+    int num_beacon;
+    struct jit_node_s nodes[JIT_QUEUE_MAX];
+};
+
+static struct jit_queue_s queue;
+static struct ref_queue_s ref;
+static uint32_t seed = 1;
+
+/* contention */
+static struct jit_queue_s chain_queue[LGW_RF_CHAIN_NB];
+static volatile bool contention_run = false;
+static volatile int contention_done = 0;
+static volatile uint32_t contention_enqueue_nb = 0;
+static volatile uint32_t contention_dispatch_nb = 0;
+static volatile int64_t contention_dispatch_sum = 0;
+static volatile int64_t contention_dispatch_max = 0;
+
+static uint32_t rand32(void)
+{
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) | ((seed * 1103515245 + 12345) & 0xFFFF0000);
+}
+
+/* -------------------------------------------------------------------------- */
+/* --- REFERENCE: FLAT ARRAY, SORTED AFTER EVERY CHANGE --------------------- */
+
+static int ref_compare(const void *a, const void *b)
+{
+    uint32_t p = ((const struct jit_node_s *)a)->pkt.count_us;
+    uint32_t q = ((const struct jit_node_s *)b)->pkt.count_us;
+
+    return (p == q) ? 0 : (((int32_t)(p - q) < 0) ? -1 : 1);
+}
+
+static bool ref_collision_test(uint32_t p1, uint32_t p1_pre, uint32_t p1_post, uint32_t p2, uint32_t p2_pre, uint32_t p2_post)
+{
+    return ((p1 - p2) <= (p1_pre + p2_post + TX_MARGIN_DELAY)) || ((p2 - p1) <= (p2_pre + p1_post + TX_MARGIN_DELAY));
+}
+
+static enum jit_error_e ref_enqueue(struct ref_queue_s *q, uint32_t time_us, struct lgw_pkt_tx_s *packet, enum jit_pkt_type_e pkt_type)
+{
+    uint32_t pre, post, target_pre, asap;
+    int i;
+
+    if (q->num_pkt == JIT_QUEUE_MAX) {
+        return JIT_ERROR_FULL;
+    }
+    if (pkt_type == JIT_PKT_TYPE_BEACON) {
+        pre = TX_START_DELAY + BEACON_GUARD + TX_JIT_DELAY;
+        post = BEACON_RESERVED;
+    } else {
+        pre = TX_START_DELAY + TX_JIT_DELAY;
+        post = lgw_time_on_air(packet) * 1000UL;
+    }
+
+    if (pkt_type == JIT_PKT_TYPE_DOWNLINK_CLASS_C) {
+        packet->tx_mode = TIMESTAMPED;
+        asap = time_us + 2 * TX_JIT_DELAY;
+        if (q->num_pkt > 0) {
+            for (i = 0; i < q->num_pkt; i++) {
+                if (ref_collision_test(asap, pre, post, q->nodes[i].pkt.count_us, q->nodes[i].pre_delay, q->nodes[i].post_delay)) {
+                    break;
+                }
+            }
+            if (i < q->num_pkt) {
+                for (i = 0; i < q->num_pkt; i++) {
+                    asap = q->nodes[i].pkt.count_us + q->nodes[i].post_delay + pre + TX_JIT_DELAY + TX_MARGIN_DELAY;
+                    if ((i < (q->num_pkt - 1)) && ref_collision_test(asap, pre, post, q->nodes[i+1].pkt.count_us, q->nodes[i+1].pre_delay, q->nodes[i+1].post_delay)) {
+                        continue;
+                    }
+                    break;
+                }
+            }
+        }
+        packet->count_us = asap;
+    }
+
+    if ((packet->count_us - time_us) <= (TX_START_DELAY + TX_MARGIN_DELAY + TX_JIT_DELAY)) {
+        return JIT_ERROR_TOO_LATE;
+    }
+    if ((pkt_type == JIT_PKT_TYPE_DOWNLINK_CLASS_A) || (pkt_type == JIT_PKT_TYPE_DOWNLINK_CLASS_B)) {
+        if ((packet->count_us - time_us) > TX_MAX_ADVANCE_DELAY) {
+            return JIT_ERROR_TOO_EARLY;
+        }
+    }
+    for (i = 0; i < q->num_pkt; i++) {
+        if (((pkt_type == JIT_PKT_TYPE_DOWNLINK_CLASS_A) || (pkt_type == JIT_PKT_TYPE_DOWNLINK_CLASS_C)) && (q->nodes[i].pkt_type == JIT_PKT_TYPE_BEACON)) {
+            target_pre = TX_START_DELAY;
+        } else {
+            target_pre = q->nodes[i].pre_delay;
+        }
+        if (ref_collision_test(packet->count_us, pre, post, q->nodes[i].pkt.count_us, target_pre, q->nodes[i].post_delay)) {
+            return (q->nodes[i].pkt_type == JIT_PKT_TYPE_BEACON) ? JIT_ERROR_COLLISION_BEACON : JIT_ERROR_COLLISION_PACKET;
+        }
+    }
+
+    q->nodes[q->num_pkt].pkt = *packet;
+    q->nodes[q->num_pkt].pre_delay = pre;
+    q->nodes[q->num_pkt].post_delay = post;
+    q->nodes[q->num_pkt].pkt_type = pkt_type;
+    if (pkt_type == JIT_PKT_TYPE_BEACON) {
+        q->num_beacon++;
+    }
+    q->num_pkt++;
+    qsort(q->nodes, q->num_pkt, sizeof q->nodes[0], ref_compare);
+    return JIT_ERROR_OK;
+}
+
+static void ref_remove(struct ref_queue_s *q, int i)
+{
+    q->num_pkt--;
+    if (q->nodes[i].pkt_type == JIT_PKT_TYPE_BEACON) {
+        q->num_beacon--;
+    }
+    q->nodes[i] = q->nodes[q->num_pkt];
+    qsort(q->nodes, q->num_pkt, sizeof q->nodes[0], ref_compare);
+}
+
+static int ref_peek(struct ref_queue_s *q, uint32_t time_us)
+{
+    int i, idx = -1;
+
+    for (i = 0; i < q->num_pkt; ) {
+        if ((q->nodes[i].pkt.count_us - time_us) >= TX_MAX_ADVANCE_DELAY) {
+            ref_remove(q, i);
+            i = 0;
+            continue;
+        }
+        if ((idx == -1) || ((q->nodes[i].pkt.count_us - time_us) < (q->nodes[idx].pkt.count_us - time_us))) {
+            idx = i;
+        }
+        i++;
+    }
+    if ((idx != -1) && ((q->nodes[idx].pkt.count_us - time_us) < TX_JIT_DELAY)) {
+        return idx;
+    }
+    return -1;
+}
+
+/* -------------------------------------------------------------------------- */
+/* --- EQUIVALENCE ---------------------------------------------------------- */
+
+static void random_packet(struct lgw_pkt_tx_s *pkt)
+{
+    memset(pkt, 0, sizeof *pkt);
+    pkt->freq_hz = 869525000;
+    pkt->tx_mode = TIMESTAMPED;
+    pkt->rf_power = 14;
+    pkt->modulation = MOD_LORA;
+    pkt->bandwidth = BW_125KHZ;
+    pkt->datarate = DR_LORA_SF7 + rand32() % 6;
+    pkt->coderate = CR_LORA_4_5;
+    pkt->invert_pol = true;
+    pkt->preamble = 8;
+    pkt->size = 1 + rand32() % 64;
+}
+
+/* SF7, a few bytes */
+static void short_packet(struct lgw_pkt_tx_s *pkt)
+{
+    memset(pkt, 0, sizeof *pkt);
+    pkt->freq_hz = 869525000;
+    pkt->tx_mode = TIMESTAMPED;
+    pkt->rf_power = 14;
+    pkt->modulation = MOD_LORA;
+    pkt->bandwidth = BW_125KHZ;
+    pkt->datarate = DR_LORA_SF7;
+    pkt->coderate = CR_LORA_4_5;
+    pkt->invert_pol = true;
+    pkt->preamble = 8;
+    pkt->size = 12;
+}
+
+/* the indexes must list every packet, in time order */
+static bool check_indexes(void)
+{
+    bool seen[JIT_QUEUE_MAX] = { false };
+    int i, j;
+
+    for (i = 0; i < queue.num_pkt; i++) {
+        if ((queue.order[i] >= queue.num_pkt) || (seen[queue.order[i]] == true) || (queue.heap_pos[queue.heap[i]] != i)) {
+            return false;
+        }
+        seen[queue.order[i]] = true;
+        if ((i > 0) && ((int32_t)(queue.nodes[queue.order[i]].pkt.count_us - queue.nodes[queue.order[i-1]].pkt.count_us) <= 0)) {
+            return false;
+        }
+        j = (i - 1) / 2;
+        if ((i > 0) && ((int32_t)(queue.nodes[queue.heap[i]].pkt.count_us - queue.nodes[queue.heap[j]].pkt.count_us) < 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool run(uint32_t origin, uint32_t *enqueued_nb, uint32_t *sent_nb)
+{
+    struct lgw_pkt_tx_s pkt, pkt_ref, out, out_ref;
+    enum jit_pkt_type_e type, type_ref;
+    enum jit_error_e err, err_ref;
+    uint32_t now = origin;
+    int step, idx, idx_ref;
+
+    jit_queue_init(&queue);
+    memset(&ref, 0, sizeof ref);
+
+    for (step = 0; step < STEP_NB; step++) {
+        /* a downlink or a beacon now and then */
+        if ((rand32() % 4) == 0) {
+            random_packet(&pkt);
+            switch (rand32() % 10) {
+                case 0: case 1: case 2: case 3:
+                    type = JIT_PKT_TYPE_DOWNLINK_CLASS_A;
+                    pkt.count_us = now + rand32() % 3000000;
+                    break;
+                case 4:
+                    type = JIT_PKT_TYPE_DOWNLINK_CLASS_B;
+                    pkt.count_us = now + rand32() % 520000000;
+                    break;
+                case 5: case 6: case 7:
+                    type = JIT_PKT_TYPE_DOWNLINK_CLASS_C;
+                    pkt.tx_mode = IMMEDIATE;
+                    pkt.count_us = 0;
+                    break;
+                default:
+                    type = JIT_PKT_TYPE_BEACON;
+                    pkt.count_us = now + rand32() % 400000000;
+                    break;
+            }
+            pkt_ref = pkt;
+            err = jit_enqueue(&queue, now, &pkt, type);
+            err_ref = ref_enqueue(&ref, now, &pkt_ref, type);
+            if ((err != err_ref) || (pkt.count_us != pkt_ref.count_us)) {
+                printf("ERROR: step %d, enqueue type %d at %u: error %d, count_us %u instead of %d, %u\n", step, type, now, err, pkt.count_us, err_ref, pkt_ref.count_us);
+                return false;
+            }
+            *enqueued_nb += (err == JIT_ERROR_OK) ? 1 : 0;
+        }
+
+        /* thread_jit, every 10 ms or so, late at times */
+        now += ((rand32() % 2000) == 0) ? (rand32() % 600000000) : (rand32() % 20000);
+        if (jit_peek(&queue, now, &idx) != JIT_ERROR_OK) {
+            idx = -1;
+        }
+        idx_ref = ref_peek(&ref, now);
+        if ((idx == -1) != (idx_ref == -1)) {
+            printf("ERROR: step %d, peek at %u: %d instead of %d\n", step, now, idx, idx_ref);
+            return false;
+        }
+        if (idx != -1) {
+            if (jit_dequeue(&queue, idx, &out, &type) != JIT_ERROR_OK) {
+                printf("ERROR: step %d, dequeue failed\n", step);
+                return false;
+            }
+            out_ref = ref.nodes[idx_ref].pkt;
+            type_ref = ref.nodes[idx_ref].pkt_type;
+            ref_remove(&ref, idx_ref);
+            if ((type != type_ref) || (out.count_us != out_ref.count_us) || (out.size != out_ref.size) || (out.datarate != out_ref.datarate)) {
+                printf("ERROR: step %d, dequeued type %d at %u instead of type %d at %u\n", step, type, out.count_us, type_ref, out_ref.count_us);
+                return false;
+            }
+            *sent_nb += 1;
+        }
+
+        if ((queue.num_pkt != ref.num_pkt) || (queue.num_beacon != ref.num_beacon) || (check_indexes() == false)) {
+            printf("ERROR: step %d, %u packets (%u beacons) instead of %d (%d), or indexes broken\n", step, queue.num_pkt, queue.num_beacon, ref.num_pkt, ref.num_beacon);
+            return false;
+        }
+    }
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+/* --- BENCHMARK ------------------------------------------------------------ */
+
+/* A full queue, one packet sent and a new one enqueued last, over and over */
+static void bench(void)
+{
+    struct lgw_pkt_tx_s pkt, out;
+    enum jit_pkt_type_e type;
+    uint32_t now = 0xFFFFFFFF - 10000000;
+    uint32_t last;
+    int64_t t0, t_ref, t_jit;
+    int i, idx;
+
+    short_packet(&pkt);
+
+    jit_queue_init(&queue);
+    memset(&ref, 0, sizeof ref);
+    for (i = 0, last = now + 1000000; i < JIT_QUEUE_MAX; i++, last += BENCH_SPACING) {
+        pkt.count_us = last;
+        jit_enqueue(&queue, now, &pkt, JIT_PKT_TYPE_DOWNLINK_CLASS_A);
+        ref_enqueue(&ref, now, &pkt, JIT_PKT_TYPE_DOWNLINK_CLASS_A);
+    }
+
+    t0 = esp_timer_get_time();
+    for (i = 0; i < BENCH_NB; i++) {
+        idx = ref_peek(&ref, now + 1000000 + i * BENCH_SPACING - 10000);
+        ref_remove(&ref, idx);
+        pkt.count_us = last + i * BENCH_SPACING;
+        ref_enqueue(&ref, now + 1000000 + i * BENCH_SPACING - 10000, &pkt, JIT_PKT_TYPE_DOWNLINK_CLASS_A);
+    }
+    t_ref = esp_timer_get_time() - t0;
+
+    t0 = esp_timer_get_time();
+    for (i = 0; i < BENCH_NB; i++) {
+        jit_peek(&queue, now + 1000000 + i * BENCH_SPACING - 10000, &idx);
+        jit_dequeue(&queue, idx, &out, &type);
+        pkt.count_us = last + i * BENCH_SPACING;
+        jit_enqueue(&queue, now + 1000000 + i * BENCH_SPACING - 10000, &pkt, JIT_PKT_TYPE_DOWNLINK_CLASS_A);
+    }
+    t_jit = esp_timer_get_time() - t0;
+
+    printf("%d packets queued, peek + dequeue + enqueue: %.2f us sorted array, %.2f us heap and index\n",
+            JIT_QUEUE_MAX, (double)t_ref / BENCH_NB, (double)t_jit / BENCH_NB);
+}
+
+/* thread_down in a Class C burst on RF chain 0, as fast as it can: the queue is
+   kept full, each ASAP slot search going through the whole of it */
+static void enqueuer(void *arg)
+{
+    struct jit_queue_s *q = &chain_queue[0];
+    struct lgw_pkt_tx_s pkt, out;
+    enum jit_pkt_type_e type;
+    uint32_t now = 0xFFFFFFFF - 1000000;
+    uint32_t count_us;
+    int idx;
+
+    (void)arg;
+    while (contention_run == true) {
+        short_packet(&pkt);
+        pkt.tx_mode = IMMEDIATE;
+        if (jit_enqueue(q, now, &pkt, JIT_PKT_TYPE_DOWNLINK_CLASS_C) == JIT_ERROR_OK) {
+            contention_enqueue_nb += 1;
+        } else if (jit_queue_head(q, &count_us) == true) {
+            /* full, make room */
+            now = count_us - 10000;
+            if ((jit_peek(q, now, &idx) == JIT_ERROR_OK) && (idx >= 0)) {
+                jit_dequeue(q, idx, &out, &type);
+            }
+        }
+    }
+    __atomic_add_fetch(&contention_done, 1, __ATOMIC_RELEASE);
+    vTaskDelete(NULL);
+}
+
+/* thread_jit on RF chain 1, the head of the queue always due, sent packets enqueued
+   again after the last one */
+static void dispatcher(void *arg)
+{
+    struct jit_queue_s *q = &chain_queue[1];
+    struct lgw_pkt_tx_s pkt;
+    enum jit_pkt_type_e type;
+    uint32_t count_us, tail;
+    int64_t t0, t;
+    int idx;
+
+    (void)arg;
+    short_packet(&pkt);
+    for (tail = 1000000; ; tail += BENCH_SPACING) {
+        pkt.count_us = tail;
+        if (jit_enqueue(q, 0, &pkt, JIT_PKT_TYPE_DOWNLINK_CLASS_A) == JIT_ERROR_FULL) {
+            break;
+        }
+    }
+    while (contention_run == true) {
+        if (jit_queue_head(q, &count_us) == false) {
+            continue;
+        }
+        t0 = esp_timer_get_time();
+        if ((jit_peek(q, count_us - 10000, &idx) == JIT_ERROR_OK) && (idx >= 0)) {
+            jit_dequeue(q, idx, &pkt, &type);
+        }
+        t = esp_timer_get_time() - t0;
+        contention_dispatch_nb += 1;
+        contention_dispatch_sum += t;
+        if (t > contention_dispatch_max) {
+            contention_dispatch_max = t;
+        }
+        pkt.count_us = tail;
+        tail += BENCH_SPACING;
+        jit_enqueue(q, count_us - 10000, &pkt, JIT_PKT_TYPE_DOWNLINK_CLASS_A);
+    }
+    __atomic_add_fetch(&contention_done, 1, __ATOMIC_RELEASE);
+    vTaskDelete(NULL);
+}
+
+static void contention(const char * name, bool shared_lock)
+{
+    SemaphoreHandle_t mx = chain_queue[1].mx;
+    int i;
+
+    for (i = 0; i < LGW_RF_CHAIN_NB; i++) {
+        jit_queue_init(&chain_queue[i]);
+    }
+    if (shared_lock == true) {
+        chain_queue[1].mx = chain_queue[0].mx;
+    }
+    contention_enqueue_nb = 0;
+    contention_dispatch_nb = 0;
+    contention_dispatch_sum = 0;
+    contention_dispatch_max = 0;
+    contention_done = 0;
+    contention_run = true;
+
+    xTaskCreatePinnedToCore(enqueuer, "enqueuer", 3072, NULL, uxTaskPriorityGet(NULL), NULL, tskNO_AFFINITY);
+    xTaskCreatePinnedToCore(dispatcher, "dispatcher", 3072, NULL, uxTaskPriorityGet(NULL), NULL, tskNO_AFFINITY);
+    vTaskDelay(CONTENTION_MS / portTICK_PERIOD_MS);
+    contention_run = false;
+    while (__atomic_load_n(&contention_done, __ATOMIC_ACQUIRE) < 2) {
+        vTaskDelay(1);
+    }
+    chain_queue[1].mx = mx;
+
+    printf("%s: %u Class C enqueues/s, %u dispatches/s, dispatch avg %.2f us, max %lld us\n", name,
+            (unsigned)(contention_enqueue_nb * 1000ULL / CONTENTION_MS), (unsigned)(contention_dispatch_nb * 1000ULL / CONTENTION_MS),
+            (contention_dispatch_nb > 0) ? ((double)contention_dispatch_sum / contention_dispatch_nb) : 0.0, (long long)contention_dispatch_max);
+}
+
+void app_main(void)
+{
+    static const uint32_t origins[] = {0, 0x7FFFFFFF - 30000000, 0xFFFFFFFF - 30000000};
+    uint32_t enqueued_nb = 0, sent_nb = 0;
+    bool ok = true;
+    unsigned i;
+
+    printf("Beginning of JiT queue test\n");
+
+    for (i = 0; (i < sizeof origins / sizeof origins[0]) && (ok == true); i++) {
+        ok = run(origins[i], &enqueued_nb, &sent_nb);
+        vTaskDelay(1);
+    }
+    printf("%u packets enqueued, %u dequeued\n", enqueued_nb, sent_nb);
+
+    bench();
+    contention("one lock for both queues", true);
+    contention("one lock per queue", false);
+
+    printf("End of JiT queue test: %s\n", (ok == true) ? "SUCCESS" : "FAILURE");
+
+    while (1) {
+        vTaskDelay(8000 / portTICK_PERIOD_MS);
+    }
+}
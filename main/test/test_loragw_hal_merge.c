@@ -0,0 +1,195 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    Equivalence test and benchmark of lgw_merge_packets() (loragw_hal.c), the
+    removal of duplicates generated by double demodulation when fine
+    timestamping is enabled, against the former pairwise search that
+    restarted after each removal and sorted with qsort_r().
+    Batches of 24 packets are built with a growing share of duplicates
+    (one copy with a fine timestamp, one without, up to 24us apart).
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+#define _GNU_SOURCE     /* needed for qsort_r to be defined */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+
+#include "loragw_hal.h"
+#include "loragw_hal_merge.h"
+
+
+#define BATCH_SIZE      24
+#define BATCH_NB        20000
+
+static struct lgw_pkt_rx_s batch[BATCH_SIZE];
+static struct lgw_pkt_rx_s ref[BATCH_SIZE];
+static struct lgw_pkt_rx_s res[BATCH_SIZE];
+
+/* reference: former merge_packets() and its helpers */
+static bool ref_is_same_pkt(struct lgw_pkt_rx_s *p1, struct lgw_pkt_rx_s *p2) {
+    return ((abs(p1->count_us - p2->count_us) <= 24) && (p1->if_chain == p2->if_chain) &&
+            (p1->datarate == p2->datarate) && (p1->size == p2->size) &&
+            (memcmp(p1->payload, p2->payload, p1->size) == 0));
+}
+
+static int ref_compare_pkt_tmst(const void *a, const void *b, void *arg) {
+    int p_count = ((struct lgw_pkt_rx_s *)a)->count_us;
+    int q_count = ((struct lgw_pkt_rx_s *)b)->count_us;
+
+    (void)arg;
+    return (p_count - q_count);
+}
+
+static int ref_merge_packets(struct lgw_pkt_rx_s * p, uint8_t * nb_pkt) {
+    uint8_t cpt = *nb_pkt;
+    int j = 0, k, pkt_dup_idx;
+    bool dup_restart = false;
+    int counter_qsort_swap = 0;
+
+    while (j < cpt) {
+        for (k = (j+1); k < cpt; k++) {
+            if (ref_is_same_pkt(&p[j], &p[k])) {
+                if ((p[j].status == STAT_CRC_OK) && (p[k].status == STAT_CRC_BAD)) {
+                    pkt_dup_idx = k;
+                } else if ((p[j].status == STAT_CRC_BAD) && (p[k].status == STAT_CRC_OK)) {
+                    pkt_dup_idx = j;
+                } else {
+                    pkt_dup_idx = (p[j].ftime_received == true) ? k : j;
+                }
+                if (pkt_dup_idx != (cpt - 1)) {
+                    memcpy(p + pkt_dup_idx, p + cpt - 1, sizeof(struct lgw_pkt_rx_s));
+                }
+                cpt -= 1;
+                dup_restart = true;
+                break;
+            }
+        }
+        if (dup_restart == true) {
+            j = 0;
+            dup_restart = false;
+        } else {
+            j += 1;
+        }
+    }
+    qsort_r(p, cpt, sizeof(p[0]), ref_compare_pkt_tmst, &counter_qsort_swap);
+    *nb_pkt = cpt;
+
+    return 0;
+}
+
+/* a batch in RX buffer order, dup_pct% of the packets having a duplicate */
+static void build_batch(int dup_pct)
+{
+    int i, j;
+    struct lgw_pkt_rx_s tmp;
+    uint32_t t = (uint32_t)rand();
+
+    for (i = 0; i < BATCH_SIZE; i++) {
+        memset(&batch[i], 0, sizeof batch[i]);
+        if ((i > 0) && ((rand() % 100) < dup_pct) && (batch[i - 1].ftime_received == true)) {
+            batch[i] = batch[i - 1];
+            batch[i].count_us += rand() % 25;
+            batch[i].ftime_received = false;
+            batch[i].rssis -= 1.0;
+            continue;
+        }
+        t += 10 + rand() % 200; /* dense: packets on all channels/SF at once */
+        batch[i].count_us = t;
+        batch[i].if_chain = rand() % 8;
+        batch[i].datarate = 7 + rand() % 6;
+        batch[i].status = ((rand() % 10) == 0) ? STAT_CRC_BAD : STAT_CRC_OK;
+        batch[i].size = 10 + rand() % 40;
+        for (j = 0; j < batch[i].size; j++) {
+            batch[i].payload[j] = (uint8_t)rand();
+        }
+        batch[i].ftime_received = true;
+        batch[i].ftime = rand();
+    }
+
+    /* packets from different modems may come out of order */
+    for (i = 0; i < (rand() % 4); i++) {
+        j = rand() % BATCH_SIZE;
+        tmp = batch[j];
+        batch[j] = batch[BATCH_SIZE - 1 - j];
+        batch[BATCH_SIZE - 1 - j] = tmp;
+    }
+}
+
+static bool same_result(int nb_ref, int nb_res)
+{
+    int i;
+
+    if (nb_ref != nb_res) {
+        return false;
+    }
+    for (i = 0; i < nb_ref; i++) {
+        if ((ref[i].count_us != res[i].count_us) || (ref[i].ftime_received != res[i].ftime_received) ||
+            (ref[i].size != res[i].size) || (memcmp(ref[i].payload, res[i].payload, ref[i].size) != 0)) {
+            return false;
+        }
+        if ((i > 0) && ((int32_t)(res[i].count_us - res[i - 1].count_us) < 0)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void app_main(void)
+{
+    int i, pct, errors = 0;
+    uint8_t nb_ref, nb_res;
+    int64_t t0, t_ref, t_res;
+    long removed;
+
+    printf("Beginning of merge_packets test\n");
+    srand(1302);
+
+    for (pct = 0; pct <= 100; pct += 25) {
+        t_ref = 0;
+        t_res = 0;
+        removed = 0;
+        for (i = 0; i < BATCH_NB; i++) {
+            build_batch(pct);
+
+            memcpy(ref, batch, sizeof batch);
+            nb_ref = BATCH_SIZE;
+            t0 = esp_timer_get_time();
+            ref_merge_packets(ref, &nb_ref);
+            t_ref += esp_timer_get_time() - t0;
+
+            memcpy(res, batch, sizeof batch);
+            nb_res = BATCH_SIZE;
+            t0 = esp_timer_get_time();
+            lgw_merge_packets(res, &nb_res);
+            t_res += esp_timer_get_time() - t0;
+
+            if (same_result(nb_ref, nb_res) == false) {
+                errors++;
+            }
+            removed += BATCH_SIZE - nb_res;
+        }
+        printf("%3d%% duplicates: %5.1f removed/batch, former %6.2f us/batch, new %6.2f us/batch\n", pct,
+                (double)removed / BATCH_NB, (double)t_ref / BATCH_NB, (double)t_res / BATCH_NB);
+        vTaskDelay(1);
+    }
+
+    printf("End of merge_packets test: %s (%d mismatches)\n", (errors == 0) ? "SUCCESS" : "FAILURE", errors);
+
+    while (true) {
+        vTaskDelay(8000 / portTICK_PERIOD_MS);
+    }
+}
@@ -0,0 +1,163 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    Benchmark of the compile-time register accessors (loragw_reg_inline.h)
+    against the register table lookup of lgw_reg_w().
+    The 16 FREQ_TRACK fields of sx1302_lora_modem_configure() are written
+    by ID, by name one field at a time, and by name 4 fields at a time.
+    Each sequence runs in single mode (SPI cost included) and in bulk mode
+    (writes only recorded: host CPU cost), then the whole
+    sx1302_lora_modem_configure() is timed.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+
+#include "loragw_com.h"
+#include "loragw_gpio.h"
+#include "loragw_hal.h"
+#include "loragw_reg.h"
+#include "loragw_reg_inline.h"
+#include "loragw_sx1302.h"
+
+
+#define LOOP_NB     200
+#define TRACK       RX_FREQ_TRACK_AUTO
+
+
+static int seq_by_id(void)
+{
+    int err = LGW_REG_SUCCESS;
+
+    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_A_0_FREQ_TRACK_EN_SF5, TRACK);
+    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_A_0_FREQ_TRACK_EN_SF6, TRACK);
+    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_A_0_FREQ_TRACK_EN_SF7, TRACK);
+    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_A_0_FREQ_TRACK_EN_SF8, TRACK);
+    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_A_1_FREQ_TRACK_EN_SF9, TRACK);
+    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_A_1_FREQ_TRACK_EN_SF10, TRACK);
+    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_A_1_FREQ_TRACK_EN_SF11, TRACK);
+    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_A_1_FREQ_TRACK_EN_SF12, TRACK);
+    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_B_0_FREQ_TRACK_EN_SF5, TRACK);
+    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_B_0_FREQ_TRACK_EN_SF6, TRACK);
+    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_B_0_FREQ_TRACK_EN_SF7, TRACK);
+    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_B_0_FREQ_TRACK_EN_SF8, TRACK);
+    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_B_1_FREQ_TRACK_EN_SF9, TRACK);
+    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_B_1_FREQ_TRACK_EN_SF10, TRACK);
+    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_B_1_FREQ_TRACK_EN_SF11, TRACK);
+    err |= lgw_reg_w(SX1302_REG_RX_TOP_FREQ_TRACK_B_1_FREQ_TRACK_EN_SF12, TRACK);
+
+    return err;
+}
+
+static int seq_by_name(void)
+{
+    int err = LGW_REG_SUCCESS;
+
+    err |= LGW_REG_W(RX_TOP_FREQ_TRACK_A_0_FREQ_TRACK_EN_SF5, TRACK);
+    err |= LGW_REG_W(RX_TOP_FREQ_TRACK_A_0_FREQ_TRACK_EN_SF6, TRACK);
+    err |= LGW_REG_W(RX_TOP_FREQ_TRACK_A_0_FREQ_TRACK_EN_SF7, TRACK);
+    err |= LGW_REG_W(RX_TOP_FREQ_TRACK_A_0_FREQ_TRACK_EN_SF8, TRACK);
+    err |= LGW_REG_W(RX_TOP_FREQ_TRACK_A_1_FREQ_TRACK_EN_SF9, TRACK);
+    err |= LGW_REG_W(RX_TOP_FREQ_TRACK_A_1_FREQ_TRACK_EN_SF10, TRACK);
+    err |= LGW_REG_W(RX_TOP_FREQ_TRACK_A_1_FREQ_TRACK_EN_SF11, TRACK);
+    err |= LGW_REG_W(RX_TOP_FREQ_TRACK_A_1_FREQ_TRACK_EN_SF12, TRACK);
+    err |= LGW_REG_W(RX_TOP_FREQ_TRACK_B_0_FREQ_TRACK_EN_SF5, TRACK);
+    err |= LGW_REG_W(RX_TOP_FREQ_TRACK_B_0_FREQ_TRACK_EN_SF6, TRACK);
+    err |= LGW_REG_W(RX_TOP_FREQ_TRACK_B_0_FREQ_TRACK_EN_SF7, TRACK);
+    err |= LGW_REG_W(RX_TOP_FREQ_TRACK_B_0_FREQ_TRACK_EN_SF8, TRACK);
+    err |= LGW_REG_W(RX_TOP_FREQ_TRACK_B_1_FREQ_TRACK_EN_SF9, TRACK);
+    err |= LGW_REG_W(RX_TOP_FREQ_TRACK_B_1_FREQ_TRACK_EN_SF10, TRACK);
+    err |= LGW_REG_W(RX_TOP_FREQ_TRACK_B_1_FREQ_TRACK_EN_SF11, TRACK);
+    err |= LGW_REG_W(RX_TOP_FREQ_TRACK_B_1_FREQ_TRACK_EN_SF12, TRACK);
+
+    return err;
+}
+
+static int seq_grouped(void)
+{
+    int err = LGW_REG_SUCCESS;
+
+    err |= LGW_REG_W4(RX_TOP_FREQ_TRACK_A_0_FREQ_TRACK_EN_SF5, TRACK, RX_TOP_FREQ_TRACK_A_0_FREQ_TRACK_EN_SF6, TRACK,
+                      RX_TOP_FREQ_TRACK_A_0_FREQ_TRACK_EN_SF7, TRACK, RX_TOP_FREQ_TRACK_A_0_FREQ_TRACK_EN_SF8, TRACK);
+    err |= LGW_REG_W4(RX_TOP_FREQ_TRACK_A_1_FREQ_TRACK_EN_SF9, TRACK, RX_TOP_FREQ_TRACK_A_1_FREQ_TRACK_EN_SF10, TRACK,
+                      RX_TOP_FREQ_TRACK_A_1_FREQ_TRACK_EN_SF11, TRACK, RX_TOP_FREQ_TRACK_A_1_FREQ_TRACK_EN_SF12, TRACK);
+    err |= LGW_REG_W4(RX_TOP_FREQ_TRACK_B_0_FREQ_TRACK_EN_SF5, TRACK, RX_TOP_FREQ_TRACK_B_0_FREQ_TRACK_EN_SF6, TRACK,
+                      RX_TOP_FREQ_TRACK_B_0_FREQ_TRACK_EN_SF7, TRACK, RX_TOP_FREQ_TRACK_B_0_FREQ_TRACK_EN_SF8, TRACK);
+    err |= LGW_REG_W4(RX_TOP_FREQ_TRACK_B_1_FREQ_TRACK_EN_SF9, TRACK, RX_TOP_FREQ_TRACK_B_1_FREQ_TRACK_EN_SF10, TRACK,
+                      RX_TOP_FREQ_TRACK_B_1_FREQ_TRACK_EN_SF11, TRACK, RX_TOP_FREQ_TRACK_B_1_FREQ_TRACK_EN_SF12, TRACK);
+
+    return err;
+}
+
+static void bench(const char *name, int (*seq)(void), bool bulk)
+{
+    int i;
+    int err = LGW_REG_SUCCESS;
+    int64_t t0, t_total = 0;
+
+    for (i = 0; i < LOOP_NB; i++) {
+        if (bulk == true) {
+            lgw_com_set_write_mode(LGW_COM_WRITE_MODE_BULK);
+        }
+        t0 = esp_timer_get_time();
+        err |= seq();
+        t_total += esp_timer_get_time() - t0;
+        if (bulk == true) {
+            lgw_com_flush(); /* not timed */
+        }
+    }
+
+    printf("%-22s %-6s: %7.1f us/sequence%s\n", name, (bulk == true) ? "bulk" : "single",
+            (double)t_total / LOOP_NB, (err == LGW_REG_SUCCESS) ? "" : " (ERRORS)");
+}
+
+static int seq_modem_configure(void)
+{
+    return sx1302_lora_modem_configure(868100000);
+}
+
+void app_main(void)
+{
+    int x;
+
+    printf("Beginning of register accessors benchmark\n");
+
+    lgw_reset();
+    x = lgw_connect(LGW_COM_SPI, "");
+    if (x != LGW_REG_SUCCESS) {
+        printf("ERROR: failed to connect\n");
+        return;
+    }
+
+    /* prime the register shadow so that all runs see the same cache state */
+    seq_by_id();
+
+    bench("16 fields by id", seq_by_id, false);
+    bench("16 fields by name", seq_by_name, false);
+    bench("16 fields, 4 per write", seq_grouped, false);
+    bench("16 fields by id", seq_by_id, true);
+    bench("16 fields by name", seq_by_name, true);
+    bench("16 fields, 4 per write", seq_grouped, true);
+    bench("lora_modem_configure", seq_modem_configure, false);
+    bench("lora_modem_configure", seq_modem_configure, true);
+
+    lgw_disconnect();
+    printf("End of register accessors benchmark\n");
+
+    while (true) {
+        vTaskDelay(8000 / portTICK_PERIOD_MS);
+    }
+}
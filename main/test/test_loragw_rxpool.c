@@ -0,0 +1,218 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    Test and benchmark of the RX payload pool (loragw_rxpool.c).
+    Payloads are allocated with random sizes and released in random order,
+    with extra references, and checked not to overlap. The pool must give
+    all its space back once everything is released.
+    The benchmark compares the copy cost per packet of the former parse path
+    (RX buffer to rx_packet_t, then to struct lgw_pkt_rx_s) with the pool
+    path (RX buffer to the pool), and the DRAM taken by a fetch array of
+    each kind.
+    It is an app_main() program, run on the target: the cycle counts and
+    the sizes printed are those of the chip it runs on.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "hal/cpu_hal.h"
+
+#include "loragw_reg.h"
+#include "loragw_hal.h"
+#include "loragw_sx1302_rx.h"
+#include "loragw_rxpool.h"
+
+
+#define HELD_MAX        64
+#define ROUND_NB        200000
+#define NB_PKT_MAX      24      /* as lora_pkt_fwd.c */
+#define BENCH_PKT_NB    16
+
+typedef struct {
+    uint8_t * payload;
+    uint16_t size;
+    uint8_t seed;
+    uint8_t refs;
+} held_t;
+
+static held_t held[HELD_MAX];
+static rx_buffer_t rx;
+static rx_packet_t pkt;
+static struct lgw_pkt_rx_s legacy;
+static uint8_t dump[BENCH_PKT_NB * 300];
+
+static bool check_payload(const held_t * h)
+{
+    int i;
+
+    for (i = 0; i < h->size; i++) {
+        if (h->payload[i] != (uint8_t)(h->seed + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* random allocations and releases, payloads must never overlap */
+static int stress(void)
+{
+    int i, k, nb_held = 0, errors = 0;
+    uint32_t used, high_water, nb_full;
+    held_t * h;
+
+    for (i = 0; i < ROUND_NB; i++) {
+        if ((nb_held < HELD_MAX) && ((rand() % 2) == 0)) {
+            h = &held[nb_held];
+            h->size = ((rand() % 8) == 0) ? (rand() % 256) : (10 + rand() % 50);
+            h->payload = rxpool_alloc(h->size);
+            if (h->payload == NULL) {
+                continue; /* full, release some */
+            }
+            h->seed = (uint8_t)rand();
+            h->refs = 1 + rand() % 3;
+            for (k = 1; k < h->refs; k++) {
+                rxpool_ref(h->payload);
+            }
+            for (k = 0; k < h->size; k++) {
+                h->payload[k] = (uint8_t)(h->seed + k);
+            }
+            nb_held += 1;
+        } else if (nb_held > 0) {
+            k = rand() % nb_held;
+            h = &held[k];
+            if (check_payload(h) == false) {
+                printf("ERROR: payload overwritten (round %d)\n", i);
+                errors += 1;
+            }
+            rxpool_unref(h->payload);
+            h->refs -= 1;
+            if (h->refs == 0) {
+                held[k] = held[nb_held - 1];
+                nb_held -= 1;
+            }
+        }
+    }
+    while (nb_held > 0) {
+        h = &held[nb_held - 1];
+        if (check_payload(h) == false) {
+            errors += 1;
+        }
+        while (h->refs-- > 0) {
+            rxpool_unref(h->payload);
+        }
+        nb_held -= 1;
+    }
+
+    /* everything released: the next allocation reclaims the whole pool */
+    rxpool_unref(rxpool_alloc(0));
+    rxpool_stats(&used, &high_water, &nb_full);
+    printf("stress: high water %u/%u bytes, %u allocations deferred (pool full)\n", high_water, RX_POOL_SIZE, nb_full);
+    h = &held[0];
+    h->payload = rxpool_alloc(RX_POOL_SIZE - 8 - 8);
+    if (h->payload == NULL) {
+        printf("ERROR: space not reclaimed\n");
+        errors += 1;
+    }
+    rxpool_unref(h->payload);
+
+    return errors;
+}
+
+/* same layout as the SX1302 RX buffer, see test_loragw_sx1302_rx_replay.c */
+static int dump_build(int size)
+{
+    int i, j, len, pos = 0;
+    uint8_t checksum, *p;
+
+    for (i = 0; i < BENCH_PKT_NB; i++) {
+        p = &dump[pos];
+        len = 9 + size + 14;
+        memset(p, 0, len);
+        p[0] = 0xA5;
+        p[1] = 0xC0;
+        p[2] = size;
+        p[3] = i % 8;
+        p[4] = 0x01 | (1 << 1) | (7 << 4);
+        for (j = 0; j < size; j++) {
+            p[9 + j] = (uint8_t)(i + j);
+        }
+        for (checksum = 0, j = 0; j < len - 1; j++) {
+            checksum += p[j];
+        }
+        p[len - 1] = checksum;
+        pos += len;
+    }
+
+    return pos;
+}
+
+static void bench(int size)
+{
+    int i, n, dump_size;
+    uint32_t c0, c_legacy = 0, c_pool = 0;
+    uint8_t * payload;
+    const int loop_nb = 2000;
+
+    dump_size = dump_build(size);
+    for (n = 0; n < loop_nb; n++) {
+        rx_buffer_new(&rx);
+        rx_buffer_feed(&rx, dump, dump_size);
+        c0 = cpu_hal_get_cycle_count();
+        for (i = 0; i < BENCH_PKT_NB; i++) {
+            rx_buffer_pop(&rx, &pkt);
+            memcpy(legacy.payload, pkt.payload, pkt.rxbytenb_modem); /* former sx1302_parse() */
+            legacy.size = pkt.rxbytenb_modem;
+        }
+        c_legacy += cpu_hal_get_cycle_count() - c0;
+
+        rx_buffer_new(&rx);
+        rx_buffer_feed(&rx, dump, dump_size);
+        c0 = cpu_hal_get_cycle_count();
+        for (i = 0; i < BENCH_PKT_NB; i++) {
+            payload = rxpool_alloc(rx_buffer_next_size(&rx));
+            rx_buffer_pop_to(&rx, &pkt, payload);
+            rxpool_unref(payload);
+        }
+        c_pool += cpu_hal_get_cycle_count() - c0;
+    }
+
+    printf("%3d-byte payloads: former %6.0f cycles/packet, pool %6.0f cycles/packet\n", size,
+            (double)c_legacy / (loop_nb * BENCH_PKT_NB), (double)c_pool / (loop_nb * BENCH_PKT_NB));
+}
+
+void app_main(void)
+{
+    int errors;
+
+    printf("Beginning of RX payload pool test\n");
+    srand(1302);
+
+    errors = stress();
+
+    printf("fetch array of %d packets: struct lgw_pkt_rx_s %u bytes, struct lgw_pkt_rx_desc_s %u bytes + pool %u bytes\n",
+            NB_PKT_MAX, (unsigned)(NB_PKT_MAX * sizeof(struct lgw_pkt_rx_s)),
+            (unsigned)(NB_PKT_MAX * sizeof(struct lgw_pkt_rx_desc_s)), RX_POOL_SIZE);
+    printf("sx1302_parse() stack: rx_packet_t %u bytes\n", (unsigned)sizeof(rx_packet_t));
+    bench(23);
+    bench(51);
+    bench(255);
+
+    printf("End of RX payload pool test: %s\n", (errors == 0) ? "SUCCESS" : "FAILURE");
+
+    while (true) {
+        vTaskDelay(8000 / portTICK_PERIOD_MS);
+    }
+}
@@ -0,0 +1,105 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    Benchmark of the SPI burst read in polling and queued (DMA) modes.
+    For each mode, report the throughput and the CPU time used per 4KB fetch.
+    CPU time is derived from a low priority task counting loops on the same
+    core: whatever it could not count during a fetch was used by the fetch.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "loragw_com.h"
+#include "loragw_spi.h"
+
+
+#define FETCH_SIZE          4096
+#define FETCH_NB            50
+#define CALIB_MS            1000
+
+#define SX1302_AGC_MCU_MEM  0x0000
+#define SX1302_REG_AGC_MCU  0x5780
+
+
+static uint8_t read_buff[FETCH_SIZE];
+static volatile uint32_t idle_loops = 0;
+
+/* idle priority task, counting loops whenever the CPU is free */
+static void idle_counter(void *arg)
+{
+    while(true){
+        idle_loops++;
+    }
+}
+
+static void bench(spi_device_handle_t *spi, lgw_spi_xfer_mode_t mode, double loops_per_us)
+{
+    int i;
+    int64_t t0, t_total = 0;
+    uint32_t loops, loops_total = 0;
+    double cpu_us;
+
+    lgw_spi_set_xfer_mode(mode);
+
+    for(i = 0; i < FETCH_NB; i++){
+        loops = idle_loops;
+        t0 = esp_timer_get_time();
+        lgw_spi_rb(spi, LGW_SPI_MUX_TARGET_SX1302, SX1302_AGC_MCU_MEM, read_buff, FETCH_SIZE);
+        t_total += esp_timer_get_time() - t0;
+        loops_total += idle_loops - loops;
+    }
+
+    cpu_us = ((double)t_total - (loops_total / loops_per_us)) / FETCH_NB;
+    printf("%-8s: %6lld us/fetch, %7.0f bytes/s, CPU %6.0f us/fetch (%.0f%%)\n",
+            (mode == LGW_SPI_XFER_QUEUED) ? "queued" : "polling",
+            (long long)(t_total / FETCH_NB),
+            (double)FETCH_SIZE * FETCH_NB * 1e6 / t_total,
+            cpu_us, 100.0 * cpu_us * FETCH_NB / t_total);
+}
+
+void app_main(void)
+{
+    int i;
+    uint32_t loops;
+    double loops_per_us;
+    spi_device_handle_t *spi = NULL;
+
+    printf("Beginning of SPI queued mode benchmark\n");
+
+    i = lgw_spi_open(&spi);
+    if (i != 0) {
+        printf("ERROR: failed to open SPI device\n");
+        return;
+    }
+    lgw_spi_w(spi, LGW_SPI_MUX_TARGET_SX1302, SX1302_REG_AGC_MCU + 0, 0x06); /* mcu_clear, host_prog */
+
+    /* run the counter on the same core as this task, calibrate it while we sleep */
+    xTaskCreatePinnedToCore(idle_counter, "idle_counter", 2048, NULL, tskIDLE_PRIORITY, NULL, xPortGetCoreID());
+    loops = idle_loops;
+    vTaskDelay(CALIB_MS / portTICK_PERIOD_MS);
+    loops_per_us = (double)(idle_loops - loops) / (CALIB_MS * 1000);
+    printf("idle counter: %.2f loops/us\n", loops_per_us);
+
+    bench(spi, LGW_SPI_XFER_POLLING, loops_per_us);
+    bench(spi, LGW_SPI_XFER_QUEUED, loops_per_us);
+
+    lgw_spi_close(spi);
+    printf("End of SPI queued mode benchmark\n");
+
+    while(true){
+        vTaskDelay(8000 / portTICK_PERIOD_MS);
+    }
+}
@@ -0,0 +1,216 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    Replay of SX1302 RX buffer dumps through the rx_buffer ring.
+    A dump holding a burst of packets (as laid out by the SX1302 RX buffer)
+    is fed in random slices, as successive fetches would see it, so that
+    packets are cut at every possible position. Every packet must come out
+    once, in order, with its metadata and payload intact. A dump with a
+    corrupted packet and leading garbage must only lose the corrupted one.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "loragw_reg.h"
+#include "loragw_sx1302_rx.h"
+
+
+#define PKT_NB_MAX      200
+#define DUMP_SIZE_MAX   (PKT_NB_MAX * 800)
+#define REPLAY_NB       200
+
+typedef struct {
+    uint8_t  size;
+    uint8_t  sf;
+    uint8_t  num_ts;
+    uint32_t timestamp;
+    uint16_t offset;    /* position in the dump */
+    bool     corrupted;
+} ref_pkt_t;
+
+static uint8_t dump[DUMP_SIZE_MAX];
+static ref_pkt_t ref[PKT_NB_MAX];
+static rx_buffer_t rx;
+static rx_packet_t pkt;
+
+/* append one packet to the dump, in the SX1302 RX buffer layout */
+static int dump_add_packet(int dump_size, ref_pkt_t * r, int seed)
+{
+    int i;
+    uint8_t *p = &dump[dump_size];
+    int len = 9 + r->size + 14 + 2 * r->num_ts;
+    uint8_t checksum = 0;
+
+    memset(p, 0, len);
+    p[0] = 0xA5;
+    p[1] = 0xC0;
+    p[2] = r->size;
+    p[3] = seed % 8;                        /* channel */
+    p[4] = 0x01 | (1 << 1) | (r->sf << 4);  /* crc_en, coding rate, SF */
+    p[5] = seed % 16;                       /* modem id */
+    for (i = 0; i < r->size; i++) {
+        p[9 + i] = (uint8_t)(seed + i);
+    }
+    p[9 + r->size + 2] = 0x55;              /* rssi */
+    p[9 + r->size + 6] = (uint8_t)(r->timestamp >> 0);
+    p[9 + r->size + 7] = (uint8_t)(r->timestamp >> 8);
+    p[9 + r->size + 8] = (uint8_t)(r->timestamp >> 16);
+    p[9 + r->size + 9] = (uint8_t)(r->timestamp >> 24);
+    p[9 + r->size + 12] = r->num_ts;
+    for (i = 0; i < 2 * r->num_ts; i++) {
+        p[9 + r->size + 13 + i] = (uint8_t)(i - r->num_ts);
+    }
+    for (i = 0; i < len - 1; i++) {
+        checksum += p[i];
+    }
+    p[len - 1] = r->corrupted ? (uint8_t)(checksum + 1) : checksum;
+    r->offset = dump_size;
+
+    return dump_size + len;
+}
+
+static int dump_build(int pkt_nb, int garbage, bool corrupt)
+{
+    int i, size = 0;
+
+    for (i = 0; i < garbage; i++) {
+        dump[size++] = (uint8_t)rand();
+        if (dump[size - 1] == 0xA5) {
+            dump[size - 1] = 0x00;
+        }
+    }
+    for (i = 0; i < pkt_nb; i++) {
+        ref[i].size = rand() % 256;
+        ref[i].sf = 5 + rand() % 8;
+        ref[i].num_ts = ((rand() % 4) == 0) ? (rand() % 128) : 0; /* timestamp_avg[] holds up to 254 metrics */
+        ref[i].timestamp = (uint32_t)rand() * 2654435761u;
+        ref[i].corrupted = corrupt && ((i % 17) == 5);
+        size = dump_add_packet(size, &ref[i], i);
+    }
+
+    return size;
+}
+
+static bool check_packet(const ref_pkt_t * r, int seed)
+{
+    int i;
+
+    if ((pkt.rxbytenb_modem != r->size) || (pkt.rx_rate_sf != r->sf) || (pkt.num_ts_metrics_stored != r->num_ts) ||
+        (pkt.timestamp_cnt != r->timestamp) || (pkt.rx_channel_in != seed % 8) || (pkt.modem_id != seed % 16)) {
+        return false;
+    }
+    for (i = 0; i < r->size; i++) {
+        if (pkt.payload[i] != (uint8_t)(seed + i)) {
+            return false;
+        }
+    }
+    for (i = 0; i < 2 * r->num_ts; i++) {
+        if (pkt.timestamp_avg[i] != (int8_t)(i - r->num_ts)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* feed the dump by random slices, pop whatever is complete after each slice, as lgw_receive() does */
+static int replay(int dump_size, int pkt_nb, int max_slice, int *nb_dropped)
+{
+    int res, pos = 0, slice, next = 0, nb_ok = 0;
+
+    rx_buffer_new(&rx);
+    *nb_dropped = 0;
+    while ((pos < dump_size) || (rx.buffer_pkt_nb > 0)) {
+        if (rx.buffer_pkt_nb == 0) {
+            slice = 1 + rand() % max_slice;
+            if (slice > dump_size - pos) {
+                slice = dump_size - pos;
+            }
+            pos += rx_buffer_feed(&rx, &dump[pos], slice);
+        }
+        while (rx.buffer_pkt_nb > 0) {
+            res = rx_buffer_pop(&rx, &pkt);
+            if (res == LGW_REG_WARNING) {
+                *nb_dropped += 1;
+                continue;
+            } else if (res != LGW_REG_SUCCESS) {
+                printf("ERROR: pop failed on packet %d\n", next);
+                return -1;
+            }
+            while ((next < pkt_nb) && (ref[next].corrupted == true)) {
+                next++;
+            }
+            if ((next >= pkt_nb) || (check_packet(&ref[next], next) == false)) {
+                printf("ERROR: packet %d mismatch\n", next);
+                return -1;
+            }
+            next++;
+            nb_ok++;
+        }
+    }
+    if ((rx.buffer_size != 0) && (*nb_dropped == 0)) {
+        printf("ERROR: %u bytes left in the ring\n", rx.buffer_size);
+        return -1;
+    }
+
+    return nb_ok;
+}
+
+void app_main(void)
+{
+    int i, n, size, nb_ok, nb_dropped, nb_corrupted;
+    int pkt_nb, slice;
+    int errors = 0;
+
+    printf("Beginning of RX buffer replay test\n");
+    srand(1302);
+
+    /* clean bursts: zero loss */
+    for (i = 0; i < REPLAY_NB; i++) {
+        pkt_nb = 1 + rand() % PKT_NB_MAX;
+        slice = 1 + rand() % RX_BUFFER_SIZE;
+        size = dump_build(pkt_nb, 0, false);
+        nb_ok = replay(size, pkt_nb, slice, &nb_dropped);
+        if ((nb_ok != pkt_nb) || (nb_dropped != 0)) {
+            printf("ERROR: clean replay %d: %d/%d packets, %d dropped (slices up to %d bytes)\n", i, nb_ok, pkt_nb, nb_dropped, slice);
+            errors++;
+        }
+    }
+    printf("clean replays:     %d/%d passed\n", REPLAY_NB - errors, REPLAY_NB);
+
+    /* garbage before the first syncword, and corrupted packets: only those are lost */
+    for (i = 0; i < REPLAY_NB; i++) {
+        pkt_nb = 1 + rand() % PKT_NB_MAX;
+        slice = 1 + rand() % RX_BUFFER_SIZE;
+        size = dump_build(pkt_nb, rand() % 64, true);
+        for (nb_corrupted = 0, n = 0; n < pkt_nb; n++) {
+            nb_corrupted += ref[n].corrupted ? 1 : 0;
+        }
+        nb_ok = replay(size, pkt_nb, slice, &nb_dropped);
+        if (nb_ok != (pkt_nb - nb_corrupted)) {
+            printf("ERROR: corrupted replay %d: %d/%d packets (slices up to %d bytes)\n", i, nb_ok, pkt_nb - nb_corrupted, slice);
+            errors++;
+        }
+    }
+    printf("corrupted replays: %s\n", (errors == 0) ? "passed" : "FAILED");
+
+    printf("End of RX buffer replay test: %s\n", (errors == 0) ? "SUCCESS" : "FAILURE");
+
+    while (true) {
+        vTaskDelay(8000 / portTICK_PERIOD_MS);
+    }
+}
@@ -0,0 +1,205 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    Test and benchmark of the binary PUSH_DATA encoding (push_bin.c).
+    Randomized packets are encoded and decoded, and the JSON rxpk object of
+    the decoded packet must be the one of the original packet: both formats
+    carry the same fields with the same precision. Status reports are
+    checked the same way, and truncated records must be rejected.
+    The benchmark compares the bytes and the cycles per packet of the binary
+    and JSON encodings.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "hal/cpu_hal.h"
+
+#include "loragw_hal.h"
+#include "rxpk_json.h"
+#include "push_bin.h"
+
+
+#define ROUND_NB        100000
+#define BENCH_PKT_NB    1000
+#define BUFF_SIZE       1024
+
+static uint8_t payloads[BENCH_PKT_NB][256];
+static struct lgw_pkt_rx_desc_s pkts[BENCH_PKT_NB];
+static struct timespec utc[BENCH_PKT_NB];
+static uint64_t gps_ms[BENCH_PKT_NB];
+static uint8_t bin[BUFF_SIZE];
+static char json_ref[BUFF_SIZE];
+static char json_dec[BUFF_SIZE];
+
+/* negative zeros have no integer encoding, keep them out */
+static float rand_float(float min, float max, float scale)
+{
+    float f = min + (max - min) * ((float)rand() / RAND_MAX);
+
+    if ((rand() % 4) == 0) {
+        f = (float)(rand() % 2000 - 1000) / 4; /* SX1302 steps */
+    }
+    if (rint((double)f * scale) == 0) {
+        f = 0.0f;
+    }
+    return f;
+}
+
+static void rand_packet(int n)
+{
+    static const uint8_t status[] = { STAT_CRC_OK, STAT_CRC_BAD, STAT_NO_CRC };
+    static const uint8_t bandwidth[] = { BW_125KHZ, BW_250KHZ, BW_500KHZ };
+    struct lgw_pkt_rx_desc_s * p = &pkts[n];
+    int i;
+
+    memset(p, 0, sizeof *p);
+    p->freq_hz = 863000000 + (uint32_t)(rand() % 5000000);
+    p->freq_offset = rand() % 20000 - 10000;
+    p->if_chain = rand() % 10;
+    p->status = status[rand() % 3];
+    p->count_us = (uint32_t)rand() * 2 + (rand() & 1);
+    p->rf_chain = rand() % 2;
+    p->modem_id = rand() % 16;
+    p->modulation = ((rand() % 8) == 0) ? MOD_FSK : MOD_LORA;
+    p->bandwidth = bandwidth[rand() % 3];
+    p->datarate = (p->modulation == MOD_LORA) ? (5 + rand() % 8) : (uint32_t)(rand() % 300000);
+    p->coderate = rand() % 5;
+    p->rssic = rand_float(-140.0f, 10.0f, 1);
+    p->rssis = rand_float(-140.0f, 10.0f, 1);
+    p->snr = rand_float(-30.0f, 20.0f, 10);
+    p->ftime_received = (rand() % 2) == 0;
+    p->ftime = (uint32_t)rand() % 1000000000;
+    p->size = rand() % 256;
+    p->payload = payloads[n];
+    for (i = 0; i < p->size; i++) {
+        p->payload[i] = (uint8_t)rand();
+    }
+    utc[n].tv_sec = (time_t)((uint32_t)rand() * 2 + (rand() & 1));
+    utc[n].tv_nsec = rand() % 1000000000;
+    gps_ms[n] = ((uint64_t)rand() << 20) ^ (uint64_t)rand();
+}
+
+static int round_trip(void)
+{
+    int i, len, len_ref, len_dec, errors = 0;
+    const struct timespec * t;
+    const uint64_t * g;
+    struct push_bin_rxpk_s r;
+
+    for (i = 0; i < ROUND_NB; i++) {
+        rand_packet(0);
+        t = ((rand() % 4) != 0) ? &utc[0] : NULL;
+        g = ((rand() % 4) != 0) ? &gps_ms[0] : NULL;
+        len = push_bin_write_rxpk(&pkts[0], t, g, bin, BUFF_SIZE);
+        if ((len < 0) || (push_bin_read_rxpk(bin, len, &r) != len) || (push_bin_read_rxpk(bin, len - 1, &r) != -1)) {
+            printf("ERROR: encoding failed (round %d)\n", i);
+            errors += 1;
+            continue;
+        }
+        push_bin_read_rxpk(bin, len, &r);
+        len_ref = rxpk_json_write(&pkts[0], t, g, json_ref, BUFF_SIZE);
+        len_dec = rxpk_json_write(&r.pkt, (r.utc_valid == true) ? &r.utc_time : NULL, (r.gps_valid == true) ? &r.gps_time_ms : NULL, json_dec, BUFF_SIZE);
+        if ((len_ref != len_dec) || (memcmp(json_ref, json_dec, len_ref) != 0)) {
+            if (errors < 10) {
+                printf("ERROR: mismatch (round %d)\n  %.*s\n  %.*s\n", i, len_ref, json_ref, len_dec, json_dec);
+            }
+            errors += 1;
+        }
+    }
+
+    printf("round trip: %d packets, %d errors\n", ROUND_NB, errors);
+
+    return errors;
+}
+
+static int stat_round_trip(void)
+{
+    struct push_bin_stat_s s = { true, 1700000000, 46.12345, -1.54321, 123, 1000, 990, 980, 97.5f, 12, 11, 41.3f };
+    struct push_bin_stat_s d;
+    int len, errors = 0;
+
+    len = push_bin_write_stat(&s, bin, BUFF_SIZE);
+    if ((len != PUSH_BIN_STAT_MAX) || (push_bin_read_stat(bin, len, &d) != len) || (push_bin_read_stat(bin, len - 1, &d) != -1)) {
+        errors += 1;
+    }
+    push_bin_read_stat(bin, len, &d);
+    if ((d.coord != true) || (d.time != s.time) || (fabs(d.lati - s.lati) > 1e-6) || (fabs(d.longi - s.longi) > 1e-6) ||
+        (d.alti != s.alti) || (d.rxnb != s.rxnb) || (d.rxok != s.rxok) || (d.rxfw != s.rxfw) || (d.ackr != 97.5f) ||
+        (d.dwnb != s.dwnb) || (d.txnb != s.txnb) || (d.temp != 41.3f)) {
+        errors += 1;
+    }
+    s.coord = false;
+    if ((push_bin_write_stat(&s, bin, BUFF_SIZE) != (PUSH_BIN_STAT_MAX - 12)) || (push_bin_read_stat(bin, PUSH_BIN_STAT_MAX - 12, &d) != (PUSH_BIN_STAT_MAX - 12)) || (d.coord != false)) {
+        errors += 1;
+    }
+
+    printf("stat: %d errors\n", errors);
+
+    return errors;
+}
+
+static void bench(int size)
+{
+    int i, n;
+    uint32_t c0, c_json = 0, c_bin = 0;
+    uint64_t b_json = 0, b_bin = 0;
+    const int loop_nb = 10;
+
+    for (i = 0; i < BENCH_PKT_NB; i++) {
+        rand_packet(i);
+        pkts[i].size = size;
+    }
+    for (n = 0; n < loop_nb; n++) {
+        c0 = cpu_hal_get_cycle_count();
+        for (i = 0; i < BENCH_PKT_NB; i++) {
+            b_json += rxpk_json_write(&pkts[i], &utc[i], &gps_ms[i], json_ref, BUFF_SIZE) + 1; /* with separator */
+        }
+        c_json += cpu_hal_get_cycle_count() - c0;
+
+        c0 = cpu_hal_get_cycle_count();
+        for (i = 0; i < BENCH_PKT_NB; i++) {
+            b_bin += push_bin_write_rxpk(&pkts[i], &utc[i], &gps_ms[i], bin, BUFF_SIZE);
+        }
+        c_bin += cpu_hal_get_cycle_count() - c0;
+    }
+
+    printf("%3d-byte payloads: JSON %5.1f bytes %6.0f cycles/packet, binary %5.1f bytes %6.0f cycles/packet\n", size,
+            (double)b_json / (loop_nb * BENCH_PKT_NB), (double)c_json / (loop_nb * BENCH_PKT_NB),
+            (double)b_bin / (loop_nb * BENCH_PKT_NB), (double)c_bin / (loop_nb * BENCH_PKT_NB));
+}
+
+void app_main(void)
+{
+    int errors;
+
+    printf("Beginning of binary PUSH_DATA test\n");
+    srand(1302);
+
+    errors = round_trip();
+    errors += stat_round_trip();
+    bench(12);
+    bench(23);
+    bench(51);
+    bench(222);
+
+    printf("End of binary PUSH_DATA test: %s\n", (errors == 0) ? "SUCCESS" : "FAILURE");
+
+    while (true) {
+        vTaskDelay(8000 / portTICK_PERIOD_MS);
+    }
+}
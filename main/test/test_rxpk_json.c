@@ -0,0 +1,291 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    Golden output test and benchmark of the rxpk JSON serializer (rxpk_json.c).
+    Randomized packets are serialized by rxpk_json_write() and by the former
+    snprintf() chain of thread_up (copied below as the reference), and both
+    outputs must be identical, byte for byte. Floats cover rounding ties,
+    negative zeros and the SNR steps of the SX1302 (0.25 dB).
+    The benchmark compares the cycles per packet of both serializers.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <math.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "hal/cpu_hal.h"
+
+#include "loragw_hal.h"
+#include "base64.h"
+#include "rxpk_json.h"
+
+
+#define ROUND_NB        200000
+#define BENCH_PKT_NB    1000
+#define BUFF_SIZE       1024
+
+static uint8_t payloads[BENCH_PKT_NB][256];
+static struct lgw_pkt_rx_desc_s pkts[BENCH_PKT_NB];
+static struct timespec utc[BENCH_PKT_NB];
+static uint64_t gps_ms[BENCH_PKT_NB];
+static char out_ref[BUFF_SIZE];
+static char out_new[BUFF_SIZE];
+
+/* former serializer of thread_up, from '{' to '}', -1 where it used to exit */
+static int rxpk_json_write_ref(const struct lgw_pkt_rx_desc_s * p, const struct timespec * pkt_utc_time, const uint64_t * pkt_gps_time_ms, char * buff_up, int size)
+{
+    int j, buff_index = 0;
+    struct tm * x;
+
+    buff_up[buff_index] = '{';
+    ++buff_index;
+    j = snprintf((char *)(buff_up + buff_index), size-buff_index, "\"jver\":%d", PROTOCOL_JSON_RXPK_FRAME_FORMAT );
+    buff_index += j;
+    j = snprintf((char *)(buff_up + buff_index), size-buff_index, ",\"tmst\":%u", p->count_us);
+    buff_index += j;
+    if (pkt_utc_time != NULL) {
+        x = gmtime(&(pkt_utc_time->tv_sec));
+        j = snprintf((char *)(buff_up + buff_index), size-buff_index, ",\"time\":\"%04i-%02i-%02iT%02i:%02i:%02i.%06liZ\"", (x->tm_year)+1900, (x->tm_mon)+1, x->tm_mday, x->tm_hour, x->tm_min, x->tm_sec, (pkt_utc_time->tv_nsec)/1000); /* ISO 8601 format */
+        buff_index += j;
+    }
+    if (pkt_gps_time_ms != NULL) {
+        j = snprintf((char *)(buff_up + buff_index), size-buff_index, ",\"tmms\":%" PRIu64 "", *pkt_gps_time_ms); /* GPS time in milliseconds since 06.Jan.1980 */
+        buff_index += j;
+    }
+    if (p->ftime_received == true) {
+        j = snprintf((char *)(buff_up + buff_index), size-buff_index, ",\"ftime\":%u", p->ftime);
+        buff_index += j;
+    }
+    j = snprintf((char *)(buff_up + buff_index), size-buff_index, ",\"chan\":%1u,\"rfch\":%1u,\"freq\":%.6lf,\"mid\":%2u", p->if_chain, p->rf_chain, ((double)p->freq_hz / 1e6), p->modem_id);
+    buff_index += j;
+    switch (p->status) {
+        case STAT_CRC_OK:
+            memcpy((void *)(buff_up + buff_index), (void *)",\"stat\":1", 9);
+            buff_index += 9;
+            break;
+        case STAT_CRC_BAD:
+            memcpy((void *)(buff_up + buff_index), (void *)",\"stat\":-1", 10);
+            buff_index += 10;
+            break;
+        case STAT_NO_CRC:
+            memcpy((void *)(buff_up + buff_index), (void *)",\"stat\":0", 9);
+            buff_index += 9;
+            break;
+        default:
+            return -1;
+    }
+    if (p->modulation == MOD_LORA) {
+        memcpy((void *)(buff_up + buff_index), (void *)",\"modu\":\"LORA\"", 14);
+        buff_index += 14;
+        switch (p->datarate) {
+            case DR_LORA_SF5: memcpy((void *)(buff_up + buff_index), (void *)",\"datr\":\"SF5", 12); buff_index += 12; break;
+            case DR_LORA_SF6: memcpy((void *)(buff_up + buff_index), (void *)",\"datr\":\"SF6", 12); buff_index += 12; break;
+            case DR_LORA_SF7: memcpy((void *)(buff_up + buff_index), (void *)",\"datr\":\"SF7", 12); buff_index += 12; break;
+            case DR_LORA_SF8: memcpy((void *)(buff_up + buff_index), (void *)",\"datr\":\"SF8", 12); buff_index += 12; break;
+            case DR_LORA_SF9: memcpy((void *)(buff_up + buff_index), (void *)",\"datr\":\"SF9", 12); buff_index += 12; break;
+            case DR_LORA_SF10: memcpy((void *)(buff_up + buff_index), (void *)",\"datr\":\"SF10", 13); buff_index += 13; break;
+            case DR_LORA_SF11: memcpy((void *)(buff_up + buff_index), (void *)",\"datr\":\"SF11", 13); buff_index += 13; break;
+            case DR_LORA_SF12: memcpy((void *)(buff_up + buff_index), (void *)",\"datr\":\"SF12", 13); buff_index += 13; break;
+            default: return -1;
+        }
+        switch (p->bandwidth) {
+            case BW_125KHZ: memcpy((void *)(buff_up + buff_index), (void *)"BW125\"", 6); buff_index += 6; break;
+            case BW_250KHZ: memcpy((void *)(buff_up + buff_index), (void *)"BW250\"", 6); buff_index += 6; break;
+            case BW_500KHZ: memcpy((void *)(buff_up + buff_index), (void *)"BW500\"", 6); buff_index += 6; break;
+            default: return -1;
+        }
+        switch (p->coderate) {
+            case CR_LORA_4_5: memcpy((void *)(buff_up + buff_index), (void *)",\"codr\":\"4/5\"", 13); buff_index += 13; break;
+            case CR_LORA_4_6: memcpy((void *)(buff_up + buff_index), (void *)",\"codr\":\"4/6\"", 13); buff_index += 13; break;
+            case CR_LORA_4_7: memcpy((void *)(buff_up + buff_index), (void *)",\"codr\":\"4/7\"", 13); buff_index += 13; break;
+            case CR_LORA_4_8: memcpy((void *)(buff_up + buff_index), (void *)",\"codr\":\"4/8\"", 13); buff_index += 13; break;
+            case 0: memcpy((void *)(buff_up + buff_index), (void *)",\"codr\":\"OFF\"", 13); buff_index += 13; break;
+            default: return -1;
+        }
+        j = snprintf((char *)(buff_up + buff_index), size-buff_index, ",\"rssis\":%.0f", roundf(p->rssis));
+        buff_index += j;
+        j = snprintf((char *)(buff_up + buff_index), size-buff_index, ",\"lsnr\":%.1f", p->snr);
+        buff_index += j;
+        j = snprintf((char *)(buff_up + buff_index), size-buff_index, ",\"foff\":%d", p->freq_offset);
+        buff_index += j;
+    } else if (p->modulation == MOD_FSK) {
+        memcpy((void *)(buff_up + buff_index), (void *)",\"modu\":\"FSK\"", 13);
+        buff_index += 13;
+        j = snprintf((char *)(buff_up + buff_index), size-buff_index, ",\"datr\":%u", p->datarate);
+        buff_index += j;
+    } else {
+        return -1;
+    }
+    j = snprintf((char *)(buff_up + buff_index), size-buff_index, ",\"rssi\":%.0f,\"size\":%u", roundf(p->rssic), p->size);
+    buff_index += j;
+    memcpy((void *)(buff_up + buff_index), (void *)",\"data\":\"", 9);
+    buff_index += 9;
+    j = bin_to_b64(p->payload, p->size, (char *)(buff_up + buff_index), 341); /* 255 bytes = 340 chars in b64 + null char */
+    if (j < 0) {
+        return -1;
+    }
+    buff_index += j;
+    buff_up[buff_index] = '"';
+    ++buff_index;
+    buff_up[buff_index] = '}';
+    ++buff_index;
+
+    return buff_index;
+}
+
+static float rand_float(float min, float max)
+{
+    static const float specials[] = { 0.0f, -0.0f, -0.5f, 0.5f, -0.05f, 0.05f, -0.25f, -0.75f, 2.5f, -2.5f, -0.49999997f, 127.45f, -139.55f };
+
+    switch (rand() % 4) {
+        case 0:
+            return specials[rand() % (sizeof specials / sizeof specials[0])];
+        case 1:
+            return (float)(rand() % 1024 - 512) / 4; /* SX1302 steps */
+        case 2:
+            return (float)(rand() % 20000 - 10000) / 20; /* ties on the last digit */
+        default:
+            return min + (max - min) * ((float)rand() / RAND_MAX);
+    }
+}
+
+static void rand_packet(int n)
+{
+    static const uint8_t status[] = { STAT_CRC_OK, STAT_CRC_BAD, STAT_NO_CRC };
+    static const uint8_t bandwidth[] = { BW_125KHZ, BW_250KHZ, BW_500KHZ };
+    struct lgw_pkt_rx_desc_s * p = &pkts[n];
+    int i;
+
+    memset(p, 0, sizeof *p);
+    p->freq_hz = ((rand() % 4) == 0) ? (uint32_t)rand() * 2 + (rand() & 1) : 863000000 + (rand() % 65) * 100000;
+    p->freq_offset = ((rand() % 2) == 0) ? (rand() % 20000 - 10000) : (int32_t)((uint32_t)rand() * 2);
+    p->if_chain = rand() % 10;
+    p->status = status[rand() % 3];
+    p->count_us = (uint32_t)rand() * 2 + (rand() & 1);
+    p->rf_chain = rand() % 2;
+    p->modem_id = rand() % 20;
+    p->modulation = ((rand() % 8) == 0) ? MOD_FSK : MOD_LORA;
+    p->bandwidth = bandwidth[rand() % 3];
+    p->datarate = (p->modulation == MOD_LORA) ? (5 + rand() % 8) : (uint32_t)(rand() % 300000);
+    p->coderate = rand() % 5;
+    p->rssic = rand_float(-140.0f, 10.0f);
+    p->rssis = rand_float(-140.0f, 10.0f);
+    p->snr = rand_float(-30.0f, 20.0f);
+    p->ftime_received = (rand() % 2) == 0;
+    p->ftime = (uint32_t)rand() % 1000000000;
+    p->size = rand() % 256;
+    p->payload = payloads[n];
+    for (i = 0; i < p->size; i++) {
+        p->payload[i] = (uint8_t)rand();
+    }
+
+    /* from 1970 to 2106, around day/year boundaries once in a while */
+    utc[n].tv_sec = (time_t)((uint32_t)rand() * 2 + (rand() & 1));
+    if ((rand() % 4) == 0) {
+        utc[n].tv_sec -= utc[n].tv_sec % 86400 - (rand() % 3) + 1;
+    }
+    utc[n].tv_nsec = rand() % 1000000000;
+    gps_ms[n] = ((uint64_t)rand() << 20) ^ (uint64_t)rand();
+}
+
+static int golden(void)
+{
+    int i, n, len_ref, len_new, errors = 0;
+    const struct timespec * t;
+    const uint64_t * g;
+
+    for (i = 0; i < ROUND_NB; i++) {
+        n = i % BENCH_PKT_NB;
+        rand_packet(n);
+        t = ((rand() % 4) != 0) ? &utc[n] : NULL;
+        g = ((rand() % 4) != 0) ? &gps_ms[n] : NULL;
+        len_ref = rxpk_json_write_ref(&pkts[n], t, g, out_ref, BUFF_SIZE);
+        len_new = rxpk_json_write(&pkts[n], t, g, out_new, BUFF_SIZE);
+        if ((len_ref != len_new) || (memcmp(out_ref, out_new, len_ref) != 0)) {
+            if (errors < 10) {
+                printf("ERROR: mismatch (round %d)\n  %.*s\n  %.*s\n", i, len_ref, out_ref, len_new, out_new);
+            }
+            errors += 1;
+            continue;
+        }
+
+        /* too small a buffer must be reported, never overflowed */
+        out_new[len_new - 1] = 'X';
+        if ((rxpk_json_write(&pkts[n], t, g, out_new, len_new - 1) != -1) || (out_new[len_new - 1] != 'X')) {
+            printf("ERROR: buffer overflow not detected (round %d)\n", i);
+            errors += 1;
+        }
+    }
+
+    /* invalid fields are reported */
+    rand_packet(0);
+    pkts[0].modulation = MOD_LORA;
+    pkts[0].datarate = 13;
+    if (rxpk_json_write(&pkts[0], NULL, NULL, out_new, BUFF_SIZE) != -1) {
+        printf("ERROR: invalid datarate not detected\n");
+        errors += 1;
+    }
+
+    printf("golden: %d packets, %d mismatches\n", ROUND_NB, errors);
+
+    return errors;
+}
+
+static void bench(void)
+{
+    int i, n;
+    uint32_t c0, c_ref = 0, c_new = 0;
+    const int loop_nb = 10;
+
+    for (i = 0; i < BENCH_PKT_NB; i++) {
+        rand_packet(i);
+        pkts[i].size = 20 + rand() % 32; /* typical uplinks */
+    }
+    for (n = 0; n < loop_nb; n++) {
+        c0 = cpu_hal_get_cycle_count();
+        for (i = 0; i < BENCH_PKT_NB; i++) {
+            rxpk_json_write_ref(&pkts[i], &utc[i], &gps_ms[i], out_ref, BUFF_SIZE);
+        }
+        c_ref += cpu_hal_get_cycle_count() - c0;
+
+        c0 = cpu_hal_get_cycle_count();
+        for (i = 0; i < BENCH_PKT_NB; i++) {
+            rxpk_json_write(&pkts[i], &utc[i], &gps_ms[i], out_new, BUFF_SIZE);
+        }
+        c_new += cpu_hal_get_cycle_count() - c0;
+    }
+
+    printf("bench: snprintf chain %6.0f cycles/packet, rxpk_json_write %6.0f cycles/packet\n",
+            (double)c_ref / (loop_nb * BENCH_PKT_NB), (double)c_new / (loop_nb * BENCH_PKT_NB));
+}
+
+void app_main(void)
+{
+    int errors;
+
+    printf("Beginning of rxpk JSON serializer test\n");
+    srand(1302);
+
+    errors = golden();
+    bench();
+
+    printf("End of rxpk JSON serializer test: %s\n", (errors == 0) ? "SUCCESS" : "FAILURE");
+
+    while (true) {
+        vTaskDelay(8000 / portTICK_PERIOD_MS);
+    }
+}
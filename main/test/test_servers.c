@@ -0,0 +1,344 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    Test of the uplink fan-out (servers.c) against UDP stand-in servers on the
+    loopback interface: a network server, a second one taking downlinks too,
+    and a collector taking uplinks only. The gateway side sends each PUSH_DATA
+    to all of them as thread_up does, and matches the PUSH_ACK as thread_up_ack
+    does. The second server only acknowledges half of them, the collector also
+    sends PUSH_ACK with tokens of the network server. Each server must get the
+    same datagrams with its own token sequence, and the PUSH_ACK must only be
+    counted for the server that sent them. PULL_DATA must only be sent to the
+    servers taking downlinks, and the collector must not be able to reach the
+    gateway with a PULL_RESP. With datagrams waiting from every server, they
+    must be returned in turn, and a server whose name does not resolve must
+    be opened anyway, then resolved later.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+
+#include "servers.h"
+
+
+#define SRV_NB          3
+#define PORT_BASE       17800       /* stand-in servers ports: up, down, then the next server */
+#define DGRAM_NB        64
+#define DGRAM_SIZE      400
+#define ACK_TIMEOUT_US  200000
+#define WAIT_MS         50
+#define BENCH_NB        2000
+
+static struct serv_s serv[SRV_NB];
+static int srv_up[SRV_NB];          /* stand-in servers sockets */
+static int srv_down[SRV_NB];
+static uint8_t dgram[DGRAM_SIZE];
+static uint8_t buff[DGRAM_SIZE + 16];
+static uint16_t first_token[SRV_NB];
+static int wait_next = 0; /* serv_wait() rotation */
+static bool ok = true;
+
+static int srv_socket(uint16_t port)
+{
+    struct sockaddr_in addr;
+    struct timeval tv = {0, WAIT_MS * 1000};
+    int sock;
+
+    sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+    memset(&addr, 0, sizeof addr);
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if ((sock < 0) || (bind(sock, (struct sockaddr *)&addr, sizeof addr) != 0)) {
+        printf("ERROR: cannot bind stand-in server port %u\n", port);
+        return -1;
+    }
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof tv);
+    return sock;
+}
+
+static bool check(bool cond, const char * what)
+{
+    if (cond == false) {
+        printf("ERROR: %s\n", what);
+        ok = false;
+    }
+    return cond;
+}
+
+/* gateway side, as thread_up_ack: match the PUSH_ACK waiting, then expire the others */
+static void collect_ack(uint32_t * ack_nb, uint32_t * expired_nb, int64_t now_offset)
+{
+    uint8_t ack[16];
+    struct sockaddr_in from;
+    socklen_t len;
+    bool replay;
+    int i, j;
+
+    while ((i = serv_wait(serv, SRV_NB, false, WAIT_MS, &wait_next)) >= 0) {
+        len = sizeof from;
+        j = recvfrom(serv[i].sock_up, ack, sizeof ack, 0, (struct sockaddr *)&from, &len);
+        if ((j == 4) && (serv_is_source(&serv[i], &from) == true) &&
+            (serv_push_ack(&serv[i], ((uint16_t)ack[1] << 8) | ack[2], esp_timer_get_time(), ACK_TIMEOUT_US, &replay) >= 0)) {
+            ack_nb[i] += 1;
+        }
+    }
+    for (i = 0; i < SRV_NB; i++) {
+        expired_nb[i] += serv_push_expire(&serv[i], esp_timer_get_time() + now_offset, ACK_TIMEOUT_US, &replay);
+    }
+}
+
+static void test_fan_out(void)
+{
+    struct sockaddr_in from;
+    socklen_t len;
+    uint16_t token;
+    uint32_t rcv_nb[SRV_NB] = {0}, ack_nb[SRV_NB] = {0}, expired_nb[SRV_NB] = {0};
+    uint32_t evicted_nb = 0;
+    uint8_t ack[4];
+    int64_t now;
+    int i, j, k;
+
+    for (k = 0; k < DGRAM_NB; k++) {
+        /* gateway side, as up_dgram_send */
+        dgram[12] = (uint8_t)k;
+        now = esp_timer_get_time();
+        for (i = 0; i < SRV_NB; i++) {
+            token = serv_push_token(&serv[i], dgram);
+            if (k == 0) {
+                first_token[i] = token;
+            }
+            evicted_nb += serv_push_register(&serv[i], token, false, now) ? 1 : 0;
+            sendto(serv[i].sock_up, dgram, sizeof dgram, 0, (struct sockaddr *)&serv[i].dest_up, sizeof serv[i].dest_up);
+        }
+
+        /* stand-in servers: same datagram, own token sequence */
+        for (i = 0; i < SRV_NB; i++) {
+            len = sizeof from;
+            j = recvfrom(srv_up[i], buff, sizeof buff, 0, (struct sockaddr *)&from, &len);
+            if (check(j == (int)sizeof dgram, "datagram lost or truncated") == false) {
+                continue;
+            }
+            rcv_nb[i] += 1;
+            token = ((uint16_t)buff[1] << 8) | buff[2];
+            check((token == (uint16_t)(first_token[i] + k)) && (memcmp(buff + 3, dgram + 3, sizeof dgram - 3) == 0) && (buff[0] == dgram[0]),
+                  "datagram differs from the one sent, or token out of sequence");
+            memcpy(ack, buff, 3);
+            ack[3] = 0x01; /* PUSH_ACK */
+            if ((i != 1) || ((k % 2) == 1)) {
+                sendto(srv_up[i], ack, sizeof ack, 0, (struct sockaddr *)&from, len);
+            }
+            if (i == 2) {
+                /* collector acknowledging with a token of the network server, on its own socket */
+                ack[1] = (uint8_t)((first_token[0] + k + 1) >> 8);
+                ack[2] = (uint8_t)(first_token[0] + k + 1);
+                sendto(srv_up[i], ack, sizeof ack, 0, (struct sockaddr *)&from, len);
+            }
+        }
+        collect_ack(ack_nb, expired_nb, 0);
+    }
+    collect_ack(ack_nb, expired_nb, 2 * ACK_TIMEOUT_US);
+
+    for (i = 0; i < SRV_NB; i++) {
+        printf("server %d: %u PUSH_DATA received, %u acknowledged, %u expired\n", i, rcv_nb[i], ack_nb[i], expired_nb[i]);
+    }
+    check((rcv_nb[0] == DGRAM_NB) && (rcv_nb[1] == DGRAM_NB) && (rcv_nb[2] == DGRAM_NB), "PUSH_DATA not received by every server");
+    check((ack_nb[0] == DGRAM_NB) && (expired_nb[0] == 0), "network server PUSH_ACK accounting");
+    check((ack_nb[1] == DGRAM_NB / 2) && (expired_nb[1] == DGRAM_NB / 2), "second server PUSH_ACK accounting");
+    check((ack_nb[2] == DGRAM_NB) && (expired_nb[2] == 0), "collector PUSH_ACK accounting");
+    check(evicted_nb == 0, "PUSH_DATA evicted");
+}
+
+static void test_downlink(void)
+{
+    struct sockaddr_in from, foreign;
+    socklen_t len;
+    uint8_t req[12], resp[8];
+    bool pulled[SRV_NB] = {false};
+    int i, j;
+
+    /* gateway side, as thread_down: PULL_DATA to the servers taking downlinks */
+    memset(req, 0, sizeof req);
+    req[0] = 0x02;
+    req[3] = 0x02; /* PULL_DATA */
+    for (i = 0; i < SRV_NB; i++) {
+        check((serv[i].downlink == true) == (serv[i].sock_down >= 0), "downstream socket without downlinks, or missing");
+        if (serv[i].sock_down >= 0) {
+            req[1] = (uint8_t)i;
+            sendto(serv[i].sock_down, req, sizeof req, 0, (struct sockaddr *)&serv[i].dest_down, sizeof serv[i].dest_down);
+        }
+    }
+
+    /* stand-in servers answer to the PULL_DATA they got, the collector tries all the ports it knows */
+    for (i = 0; i < SRV_NB; i++) {
+        len = sizeof from;
+        j = recvfrom(srv_down[i], req, sizeof req, 0, (struct sockaddr *)&from, &len);
+        if (j > 0) {
+            pulled[i] = true;
+            memcpy(resp, req, 3);
+            resp[3] = 0x04; /* PULL_ACK */
+            sendto(srv_down[i], resp, 4, 0, (struct sockaddr *)&from, len);
+        }
+    }
+    check(pulled[0] && pulled[1] && !pulled[2], "PULL_DATA not sent to the servers taking downlinks only");
+    resp[3] = 0x03; /* PULL_RESP */
+    len = sizeof from;
+    getsockname(serv[2].sock_up, (struct sockaddr *)&from, &len);
+    sendto(srv_up[2], resp, 4, 0, (struct sockaddr *)&from, len);
+
+    /* gateway side: a PULL_ACK from each server taking downlinks, nothing else */
+    memset(pulled, 0, sizeof pulled);
+    while ((i = serv_wait(serv, SRV_NB, true, WAIT_MS, &wait_next)) >= 0) {
+        len = sizeof from;
+        j = recvfrom(serv[i].sock_down, resp, sizeof resp, 0, (struct sockaddr *)&from, &len);
+        check((j == 4) && (resp[3] == 0x04) && (resp[1] == i) && serv_is_source(&serv[i], &from), "unexpected downstream datagram");
+        pulled[i] = true;
+    }
+    check(pulled[0] && pulled[1] && !pulled[2], "PULL_ACK not received from the servers taking downlinks only");
+
+    /* the PULL_RESP of the collector stays on its upstream socket, ignored by thread_up_ack */
+    len = sizeof from;
+    j = (serv_wait(serv, SRV_NB, false, WAIT_MS, &wait_next) == 2) ? recvfrom(serv[2].sock_up, resp, sizeof resp, 0, (struct sockaddr *)&from, &len) : -1;
+    check((j == 4) && (resp[3] == 0x03), "collector PULL_RESP not on its upstream socket");
+
+    /* any other source is rejected */
+    memset(&foreign, 0, sizeof foreign);
+    foreign.sin_family = AF_INET;
+    foreign.sin_addr.s_addr = inet_addr("10.1.2.3");
+    foreign.sin_port = serv[0].dest_down.sin_port;
+    check(serv_is_source(&serv[0], &foreign) == false, "datagram from another host accepted");
+}
+
+static void test_rotation(void)
+{
+    struct sockaddr_in to;
+    socklen_t len;
+    uint8_t ack[4] = {0x02, 0, 0, 0x01};
+    int seen[SRV_NB] = {0};
+    int i, k;
+
+    /* two datagrams waiting from each server: none must wait for the other ones to be drained */
+    for (k = 0; k < 2; k++) {
+        for (i = 0; i < SRV_NB; i++) {
+            len = sizeof to;
+            getsockname(serv[i].sock_up, (struct sockaddr *)&to, &len);
+            sendto(srv_up[i], ack, sizeof ack, 0, (struct sockaddr *)&to, len);
+        }
+    }
+    vTaskDelay(10 / portTICK_PERIOD_MS);
+    for (k = 0; k < 2 * SRV_NB; k++) {
+        i = serv_wait(serv, SRV_NB, false, WAIT_MS, &wait_next);
+        if (check(i >= 0, "datagram not waiting") == false) {
+            break;
+        }
+        recvfrom(serv[i].sock_up, buff, sizeof buff, 0, NULL, NULL);
+        check(seen[i] == k / SRV_NB, "servers not served in turn"); /* each one once in every SRV_NB datagrams */
+        seen[i] += 1;
+    }
+    check(serv_wait(serv, SRV_NB, false, WAIT_MS, &wait_next) < 0, "datagram left waiting");
+}
+
+static void test_unresolved(void)
+{
+    struct serv_s s;
+
+    memset(&s, 0, sizeof s);
+    strcpy(s.addr, "unresolved.invalid");
+    s.port_up = PORT_BASE;
+    s.port_down = PORT_BASE + 1;
+    s.downlink = true;
+    check(serv_open(&s) == -2, "unresolved server not opened, or not reported");
+    check((s.sock_up >= 0) && (s.sock_down >= 0) && (serv_is_resolved(&s) == false), "unresolved server state");
+    check(serv_resolve(&s) == -1, "resolution of an invalid name succeeded");
+    strcpy(s.addr, "127.0.0.1");
+    check((serv_resolve(&s) == 0) && (serv_is_resolved(&s) == true) && (ntohs(s.dest_down.sin_port) == PORT_BASE + 1),
+          "server not resolved on retry");
+    serv_close(&s);
+}
+
+static void bench(void)
+{
+    int64_t t0, t_one, t_all;
+    uint16_t token;
+    int i, k;
+
+    t0 = esp_timer_get_time();
+    for (k = 0; k < BENCH_NB; k++) {
+        token = serv_push_token(&serv[0], dgram);
+        serv_push_register(&serv[0], token, false, t0);
+        sendto(serv[0].sock_up, dgram, sizeof dgram, 0, (struct sockaddr *)&serv[0].dest_up, sizeof serv[0].dest_up);
+    }
+    t_one = esp_timer_get_time() - t0;
+    t0 = esp_timer_get_time();
+    for (k = 0; k < BENCH_NB; k++) {
+        for (i = 0; i < SRV_NB; i++) {
+            token = serv_push_token(&serv[i], dgram);
+            serv_push_register(&serv[i], token, false, t0);
+            sendto(serv[i].sock_up, dgram, sizeof dgram, 0, (struct sockaddr *)&serv[i].dest_up, sizeof serv[i].dest_up);
+        }
+    }
+    t_all = esp_timer_get_time() - t0;
+    printf("PUSH_DATA of %d bytes: %.1f us to one server, %.1f us to %d servers\n", DGRAM_SIZE,
+            (double)t_one / BENCH_NB, (double)t_all / BENCH_NB, SRV_NB);
+}
+
+void app_main(void)
+{
+    int i;
+
+    printf("Beginning of servers test\n");
+
+    srand(1);
+    for (i = 0; i < SRV_NB; i++) {
+        strcpy(serv[i].addr, (i == 2) ? "localhost" : "127.0.0.1");
+        serv[i].port_up = PORT_BASE + 2 * i;
+        serv[i].port_down = PORT_BASE + 2 * i + 1;
+        serv[i].downlink = (i < 2);
+        serv[i].keepalive = 10;
+        srv_up[i] = srv_socket(serv[i].port_up);
+        srv_down[i] = srv_socket(serv[i].port_down);
+        ok &= (srv_up[i] >= 0) && (srv_down[i] >= 0);
+        ok &= check(serv_open(&serv[i]) == 0, "serv_open failed");
+    }
+    memset(dgram, 0xA5, sizeof dgram);
+    dgram[0] = 0x02;
+    dgram[3] = 0x00; /* PUSH_DATA */
+
+    if (ok == true) {
+        test_fan_out();
+        test_downlink();
+        test_rotation();
+        test_unresolved();
+        bench();
+    }
+
+    for (i = 0; i < SRV_NB; i++) {
+        serv_close(&serv[i]);
+        close(srv_up[i]);
+        close(srv_down[i]);
+    }
+
+    printf("End of servers test: %s\n", (ok == true) ? "SUCCESS" : "FAILURE");
+
+    while (1) {
+        vTaskDelay(8000 / portTICK_PERIOD_MS);
+    }
+}
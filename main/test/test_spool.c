@@ -0,0 +1,426 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    Test of the store-and-forward spool (spool.c) against a UDP stand-in
+    server on the loopback interface, which stops answering for a while and
+    then recovers. The gateway side uses the spool as thread_up and
+    thread_up_ack do, on a simulated clock: one packet every 100 ms, one
+    PUSH_DATA per packet while the server answers.
+    The server checks that every packet arrives with its original "tmst" and
+    "time", that spooled packets arrive in order, and the replay rate. The
+    memory caps are checked with each drop policy, and with a file overflow.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "loragw_hal.h"
+#include "parson.h"
+#include "rxpk_json.h"
+#include "spool.h"
+
+
+#define SPOOL_TEST_FILE     "spool_test.bin"
+#define SIM_STEP_US         10000       /* simulated clock step */
+#define SIM_DURATION_US     90000000    /* test duration */
+#define PKT_PERIOD_US       100000      /* one packet every 100 ms */
+#define ACK_TIMEOUT_US      200000      /* PUSH_DATA expiry */
+#define OUTAGE_NB           3
+#define REPLAY_RATE         5
+#define PROBE_MS            2000
+#define DGRAM_MAX           1400
+#define INFLIGHT_NB         16
+#define PKT_NB_MAX          (SIM_DURATION_US / PKT_PERIOD_US)
+#define UTC_BASE            1700000000  /* UTC time of tmst 0 */
+
+struct scenario_s {
+    const char * name;
+    uint32_t ram_size;
+    const char * file_path;
+    uint32_t file_size;
+    int drop_policy;
+    int64_t silent[2][2];   /* server silent in [silent[i][0], silent[i][1][ */
+};
+
+struct inflight_s {
+    bool used;
+    bool replay;
+    uint16_t token;
+    int64_t send_time;
+};
+
+static int sock_gw, sock_srv;
+static struct sockaddr_in addr_srv;
+static struct spool_s spool;
+static struct inflight_s inflight[INFLIGHT_NB];
+static uint8_t spool_ram[65536];
+static uint8_t dgram[DGRAM_MAX + 64];
+static uint8_t rxpk[512];
+
+/* server side record */
+static int rcv_count[PKT_NB_MAX]; /* times each packet arrived */
+static bool spooled[PKT_NB_MAX]; /* packet went through the spool */
+static uint32_t rcv_last_replayed;  /* last replayed packet, to check the order */
+static int order_errors, time_errors;
+static int replay_per_s[SIM_DURATION_US / 1000000];
+
+/* -------------------------------------------------------------------------- */
+/* --- GATEWAY SIDE --------------------------------------------------------- */
+
+static int make_rxpk(uint32_t n, uint8_t * buf, int size)
+{
+    static uint8_t payload[20];
+    struct lgw_pkt_rx_desc_s p;
+    struct timespec utc;
+
+    memset(&p, 0, sizeof p);
+    p.freq_hz = 868100000;
+    p.status = STAT_CRC_OK;
+    p.count_us = n * PKT_PERIOD_US; /* packet index is tmst / PKT_PERIOD_US */
+    p.modulation = MOD_LORA;
+    p.bandwidth = BW_125KHZ;
+    p.datarate = DR_LORA_SF7;
+    p.coderate = CR_LORA_4_5;
+    p.rssic = -60;
+    p.rssis = -61;
+    p.snr = 9.5;
+    p.size = sizeof payload;
+    p.payload = payload;
+    utc.tv_sec = UTC_BASE + p.count_us / 1000000;
+    utc.tv_nsec = (p.count_us % 1000000) * 1000;
+    return rxpk_json_write(&p, &utc, NULL, (char *)buf, size);
+}
+
+static void gw_send(const uint8_t * recs[], const int lens[], int nb, bool replay, int64_t now)
+{
+    static uint16_t token = 0;
+    int i, len = 12, slot = -1;
+
+    token += 1;
+    dgram[0] = 2;
+    dgram[1] = (uint8_t)(token >> 8);
+    dgram[2] = (uint8_t)token;
+    dgram[3] = 0;
+    memset(dgram + 4, 0xAA, 8);
+    memcpy(dgram + len, "{\"rxpk\":[", 9);
+    len += 9;
+    for (i = 0; i < nb; i++) {
+        if (i > 0) {
+            dgram[len++] = ',';
+        }
+        memcpy(dgram + len, recs[i], lens[i]);
+        len += lens[i];
+    }
+    dgram[len++] = ']';
+    dgram[len++] = '}';
+    sendto(sock_gw, dgram, len, 0, (struct sockaddr *)&addr_srv, sizeof addr_srv);
+
+    /* as push_ack_register, the replay is never evicted */
+    for (i = 0; i < INFLIGHT_NB; i++) {
+        if (inflight[i].used == false) {
+            slot = i;
+            break;
+        } else if ((inflight[i].replay == false) && ((slot < 0) || (inflight[i].send_time < inflight[slot].send_time))) {
+            slot = i;
+        }
+    }
+    inflight[slot].used = true;
+    inflight[slot].replay = replay;
+    inflight[slot].token = token;
+    inflight[slot].send_time = now;
+    if (replay == true) {
+        replay_per_s[now / 1000000] += 1;
+    }
+}
+
+/* as up_spool_replay */
+static void gw_replay(int64_t now)
+{
+    static uint8_t recs_buf[DGRAM_MAX];
+    const uint8_t * recs[DGRAM_MAX / 16];
+    int lens[DGRAM_MAX / 16];
+    int nb = 0, off = 0, len;
+    uint8_t flags;
+
+    if (spool_replay_due(&spool, now) == false) {
+        return;
+    }
+    /* header, "{"rxpk":[" and "]}", a separator before each record but the first */
+    while ((len = spool_next(&spool, &flags)) > 0) {
+        if ((nb > 0) && ((spool.link_lost == true) || ((12 + 9 + off + nb + len + 2) > DGRAM_MAX))) {
+            break;
+        }
+        if (spool_peek(&spool, recs_buf + off, sizeof recs_buf - off) != len) {
+            break;
+        }
+        recs[nb] = recs_buf + off;
+        lens[nb] = len;
+        off += len;
+        nb += 1;
+    }
+    spool_replay_sent(&spool, now);
+    if (nb > 0) {
+        gw_send(recs, lens, nb, true, now);
+    }
+}
+
+/* as thread_up_ack */
+static void gw_receive_acks(int64_t now)
+{
+    uint8_t ack[4];
+    uint16_t token;
+    uint32_t nb_expired = 0;
+    bool replay = false;
+    int i;
+
+    while (recv(sock_gw, ack, sizeof ack, MSG_DONTWAIT) == 4) {
+        token = ((uint16_t)ack[1] << 8) | ack[2];
+        for (i = 0; i < INFLIGHT_NB; i++) {
+            if ((inflight[i].used == true) && (inflight[i].token == token)) {
+                inflight[i].used = false;
+                spool_ack(&spool, inflight[i].replay);
+                break;
+            }
+        }
+    }
+    for (i = 0; i < INFLIGHT_NB; i++) {
+        if ((inflight[i].used == true) && ((now - inflight[i].send_time) > ACK_TIMEOUT_US)) {
+            inflight[i].used = false;
+            replay |= inflight[i].replay;
+            nb_expired += 1;
+        }
+    }
+    if (nb_expired > 0) {
+        spool_expired(&spool, nb_expired, replay);
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* --- STAND-IN SERVER ------------------------------------------------------ */
+
+static void srv_receive(bool silent)
+{
+    static char buf[DGRAM_MAX + 64];
+    char expected[32];
+    struct sockaddr_in from;
+    socklen_t fromlen = sizeof from;
+    JSON_Value * root;
+    JSON_Array * arr;
+    JSON_Object * pkt;
+    const char * t;
+    uint32_t n, tmst;
+    time_t sec;
+    size_t i;
+    int len;
+
+    while ((len = recvfrom(sock_srv, buf, sizeof buf - 1, MSG_DONTWAIT, (struct sockaddr *)&from, &fromlen)) >= 12) {
+        if (silent == true) {
+            continue; /* backhaul down: the datagram is lost */
+        }
+        buf[len] = 0;
+        root = json_parse_string(buf + 12);
+        arr = json_object_get_array(json_value_get_object(root), "rxpk");
+        for (i = 0; i < json_array_get_count(arr); i++) {
+            pkt = json_array_get_object(arr, i);
+            tmst = (uint32_t)json_object_get_number(pkt, "tmst");
+            n = tmst / PKT_PERIOD_US;
+            if ((n >= PKT_NB_MAX) || ((tmst % PKT_PERIOD_US) != 0)) {
+                time_errors += 1;
+                continue;
+            }
+            /* "time" must be the one of the reception, not of the replay */
+            sec = UTC_BASE + tmst / 1000000;
+            strftime(expected, sizeof expected, "%Y-%m-%dT%H:%M:%S", gmtime(&sec));
+            snprintf(expected + 19, sizeof expected - 19, ".%06uZ", tmst % 1000000);
+            t = json_object_get_string(pkt, "time");
+            if ((t == NULL) || (strcmp(t, expected) != 0)) {
+                time_errors += 1;
+            }
+            if ((spooled[n] == true) && (rcv_count[n] == 0)) {
+                if ((rcv_last_replayed != UINT32_MAX) && (n < rcv_last_replayed)) {
+                    order_errors += 1;
+                }
+                rcv_last_replayed = n;
+            }
+            rcv_count[n] += 1;
+        }
+        json_value_free(root);
+        buf[3] = 1; /* PUSH_ACK */
+        sendto(sock_srv, buf, 4, 0, (struct sockaddr *)&from, fromlen);
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* --- SCENARIOS ------------------------------------------------------------ */
+
+static int run(const struct scenario_s * sc)
+{
+    int64_t now;
+    uint32_t n = 0, i, nb, bytes;
+    uint32_t nb_lost = 0, nb_spooled = 0, nb_missing = 0, nb_dup = 0;
+    bool silent;
+    uint32_t first_missing = UINT32_MAX, last_missing = 0;
+    int errors = 0, max_replay = 0, len;
+    const uint8_t * rec[1];
+
+    memset(inflight, 0, sizeof inflight);
+    memset(rcv_count, 0, sizeof rcv_count);
+    memset(spooled, 0, sizeof spooled);
+    memset(replay_per_s, 0, sizeof replay_per_s);
+    rcv_last_replayed = UINT32_MAX;
+    order_errors = 0;
+    time_errors = 0;
+    if (spool_init(&spool, spool_ram, sc->ram_size, sc->file_path, sc->file_size, sc->drop_policy, OUTAGE_NB, REPLAY_RATE, PROBE_MS) != 0) {
+        printf("%-24s skipped, %s cannot be created\n", sc->name, sc->file_path);
+        return 0;
+    }
+
+    for (now = 0; now < SIM_DURATION_US; now += SIM_STEP_US) {
+        /* packets stop 20 s before the end, for the spool to drain */
+        if (((now % PKT_PERIOD_US) == 0) && (now < (SIM_DURATION_US - 20000000))) {
+            len = make_rxpk(n, rxpk, sizeof rxpk);
+            if (spool.link_lost == true) {
+                spooled[n] = true;
+                spool_put(&spool, rxpk, (uint16_t)len, 0);
+            } else {
+                rec[0] = rxpk;
+                gw_send(rec, &len, 1, false, now);
+            }
+            n += 1;
+        }
+        gw_replay(now);
+        silent = ((now >= sc->silent[0][0]) && (now < sc->silent[0][1])) || ((now >= sc->silent[1][0]) && (now < sc->silent[1][1]));
+        srv_receive(silent);
+        gw_receive_acks(now);
+    }
+
+    for (i = 0; i < n; i++) {
+        if (rcv_count[i] > 1) {
+            nb_dup += 1;
+        }
+        if (spooled[i] == true) {
+            nb_spooled += 1;
+            if (rcv_count[i] == 0) {
+                nb_missing += 1;
+                first_missing = (i < first_missing) ? i : first_missing;
+                last_missing = i;
+            }
+        } else if (rcv_count[i] == 0) {
+            nb_lost += 1; /* sent before the outage was detected, these datagrams are not kept */
+        }
+    }
+    for (i = 0; i < (SIM_DURATION_US / 1000000); i++) {
+        max_replay = (replay_per_s[i] > max_replay) ? replay_per_s[i] : max_replay;
+    }
+    spool_usage(&spool, &nb, &bytes);
+
+    printf("%-24s %u packets, %u lost before detection, %u spooled, %u dropped, %u missing, %u duplicates, high water %u bytes, max %d replays/s\n",
+            sc->name, n, nb_lost, nb_spooled, spool.nb_drop, nb_missing, nb_dup, spool.high_water, max_replay);
+
+    /* checks common to all scenarios */
+    if ((nb_lost > (2 * (OUTAGE_NB + ACK_TIMEOUT_US / PKT_PERIOD_US))) || (nb_spooled == 0) || (nb != 0) || (order_errors != 0) || (time_errors != 0) || (max_replay > REPLAY_RATE) || (spool.nb_error != 0)) {
+        errors += 1;
+    }
+    if (spool.high_water > (sc->ram_size + sc->file_size)) {
+        errors += 1;
+    }
+    /* drop policy: nothing missing if the spool is large enough, else the oldest or the newest ones */
+    if (nb_missing != spool.nb_drop) {
+        errors += 1;
+    }
+    if (nb_missing > 0) {
+        for (i = first_missing; i <= last_missing; i++) {
+            if ((spooled[i] == true) && (rcv_count[i] != 0)) {
+                errors += 1; /* dropped packets are not contiguous */
+                break;
+            }
+        }
+        for (i = 0; i < n; i++) {
+            if (spooled[i] == true) {
+                break;
+            }
+        }
+        if ((sc->drop_policy == SPOOL_DROP_OLDEST) && (first_missing != i)) {
+            errors += 1;
+        }
+        for (i = n; i > 0; i--) {
+            if (spooled[i - 1] == true) {
+                break;
+            }
+        }
+        if ((sc->drop_policy == SPOOL_DROP_NEWEST) && (last_missing != (i - 1))) {
+            errors += 1;
+        }
+    }
+    if (errors > 0) {
+        printf("ERROR: %s failed (order %d, time %d)\n", sc->name, order_errors, time_errors);
+    }
+    if (spool.file.file != NULL) {
+        fclose(spool.file.file);
+        remove(sc->file_path);
+    }
+
+    return errors;
+}
+
+void app_main(void)
+{
+    static const struct scenario_s scenarios[] = {
+        /* 20 s outage, about 200 records of 250 bytes: everything fits */
+        { "RAM, no drop",           65536, NULL, 0, SPOOL_DROP_OLDEST, { { 10000000, 30000000 }, { 0, 0 } } },
+        /* 8 kB of RAM only: the oldest or the newest records are dropped */
+        { "RAM, drop oldest",       8192, NULL, 0, SPOOL_DROP_OLDEST, { { 10000000, 30000000 }, { 0, 0 } } },
+        { "RAM, drop newest",       8192, NULL, 0, SPOOL_DROP_NEWEST, { { 10000000, 30000000 }, { 0, 0 } } },
+        /* 8 kB of RAM and a file for the overflow: everything fits */
+        { "RAM + file, no drop",    8192, SPOOL_TEST_FILE, 65536, SPOOL_DROP_OLDEST, { { 10000000, 30000000 }, { 0, 0 } } },
+        /* RAM and file full */
+        { "RAM + file, drop oldest", 8192, SPOOL_TEST_FILE, 16384, SPOOL_DROP_OLDEST, { { 10000000, 30000000 }, { 0, 0 } } },
+        /* second outage while the first one is being replayed */
+        { "outage during replay",   65536, NULL, 0, SPOOL_DROP_OLDEST, { { 10000000, 30000000 }, { 33000000, 40000000 } } },
+    };
+    socklen_t addrlen = sizeof addr_srv;
+    int i, errors = 0;
+
+    printf("Beginning of spool test\n");
+
+    sock_srv = socket(AF_INET, SOCK_DGRAM, 0);
+    sock_gw = socket(AF_INET, SOCK_DGRAM, 0);
+    memset(&addr_srv, 0, sizeof addr_srv);
+    addr_srv.sin_family = AF_INET;
+    addr_srv.sin_addr.s_addr = inet_addr("127.0.0.1");
+    addr_srv.sin_port = 0;
+    if ((sock_srv < 0) || (sock_gw < 0) || (bind(sock_srv, (struct sockaddr *)&addr_srv, sizeof addr_srv) != 0) ||
+        (getsockname(sock_srv, (struct sockaddr *)&addr_srv, &addrlen) != 0)) {
+        printf("ERROR: failed to create the loopback sockets (%s)\n", strerror(errno));
+        errors += 1;
+    } else {
+        for (i = 0; i < (int)(sizeof scenarios / sizeof scenarios[0]); i++) {
+            errors += run(&scenarios[i]);
+        }
+    }
+
+    printf("End of spool test: %s\n", (errors == 0) ? "SUCCESS" : "FAILURE");
+
+    while (true) {
+        vTaskDelay(8000 / portTICK_PERIOD_MS);
+    }
+}
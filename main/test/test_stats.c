@@ -0,0 +1,160 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    Check the statistics blocks copied without lock while a task writes them:
+    every copy must be consistent and the maximums must restart on a new epoch.
+    Also compare the cost of an update with the mutex it replaces.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "stats.h"
+
+
+#define READ_NB     200000  /* copies checked while the writer runs */
+#define EPOCH_NB    1000    /* copies between two epochs */
+#define BENCH_NB    100000  /* updates timed */
+#define WORD_NB     32      /* words rewritten on each update, to widen the torn copy window */
+
+
+struct test_block_s {
+    stats_seq_t seq;
+    uint32_t    nb;             /* updates done */
+    uint32_t    word[WORD_NB];  /* all equal to nb */
+    uint64_t    sum;            /* 1 + 2 + ... + nb */
+    stats_max_t max;            /* max of nb in the epoch */
+};
+
+static struct test_block_s block;
+static volatile bool writer_stop = false;
+static volatile bool writer_done = false;
+
+/* single writer of the block, as a forwarder task */
+static void writer(void *arg)
+{
+    int i;
+
+    while (writer_stop == false) {
+        stats_begin(&block.seq);
+        block.nb += 1;
+        for (i = 0; i < WORD_NB; i++) {
+            block.word[i] = block.nb;
+        }
+        block.sum += block.nb;
+        stats_max(&block.max, block.nb);
+        stats_end(&block.seq);
+    }
+    writer_done = true;
+    vTaskDelete(NULL);
+}
+
+/* consistency of a copy, and progress since the previous one */
+static bool check(const struct test_block_s * c, uint32_t last_nb)
+{
+    int i;
+
+    if ((c->seq.seq & 1) != 0) {
+        printf("ERROR: copy taken during a write (seq %u)\n", c->seq.seq);
+        return false;
+    }
+    for (i = 0; i < WORD_NB; i++) {
+        if (c->word[i] != c->nb) {
+            printf("ERROR: torn copy, word %d is %u for nb %u\n", i, c->word[i], c->nb);
+            return false;
+        }
+    }
+    if (c->sum != ((uint64_t)c->nb * (c->nb + 1) / 2)) {
+        printf("ERROR: torn copy, sum %llu for nb %u\n", (unsigned long long)c->sum, c->nb);
+        return false;
+    }
+    if (c->nb < last_nb) {
+        printf("ERROR: counter went back from %u to %u\n", last_nb, c->nb);
+        return false;
+    }
+    if (stats_max_get(&c->max) > c->nb) {
+        printf("ERROR: max %u above nb %u\n", stats_max_get(&c->max), c->nb);
+        return false;
+    }
+    return true;
+}
+
+void app_main(void)
+{
+    int i;
+    bool ok = true;
+    struct test_block_s c;
+    uint32_t last_nb = 0;
+    uint32_t epoch_nb = 0;
+    int64_t t0, t_seq, t_mutex;
+    SemaphoreHandle_t mx;
+
+    printf("Beginning of statistics test\n");
+
+    /* the writer runs on the other core if there is one, preempted by this task otherwise */
+    xTaskCreatePinnedToCore(writer, "writer", 2048, NULL, uxTaskPriorityGet(NULL), NULL, portNUM_PROCESSORS - 1);
+
+    for (i = 0; (i < READ_NB) && (ok == true); i++) {
+        stats_read(&block, &c, sizeof c);
+        ok = check(&c, last_nb);
+        last_nb = c.nb;
+        if ((i % EPOCH_NB) == (EPOCH_NB - 1)) {
+            stats_new_epoch();
+            stats_read(&block, &c, sizeof c);
+            if ((stats_max_get(&c.max) != 0) && (c.max.val != c.nb)) {
+                /* written after the new epoch: it only saw later values */
+                ok = false;
+                printf("ERROR: max %u of the new epoch is not the latest value %u\n", c.max.val, c.nb);
+            }
+            epoch_nb += 1;
+        }
+    }
+    writer_stop = true;
+    while (writer_done == false) {
+        vTaskDelay(1);
+    }
+    printf("%d copies checked, %u updates, %u epochs\n", i, last_nb, epoch_nb);
+    if (last_nb == 0) {
+        printf("ERROR: the writer did not run\n");
+        ok = false;
+    }
+
+    /* cost of one update: sequence counter vs mutex */
+    t0 = esp_timer_get_time();
+    for (i = 0; i < BENCH_NB; i++) {
+        stats_begin(&block.seq);
+        block.nb += 1;
+        stats_end(&block.seq);
+    }
+    t_seq = esp_timer_get_time() - t0;
+    mx = xSemaphoreCreateMutex();
+    t0 = esp_timer_get_time();
+    for (i = 0; i < BENCH_NB; i++) {
+        xSemaphoreTake(mx, portMAX_DELAY);
+        block.nb += 1;
+        xSemaphoreGive(mx);
+    }
+    t_mutex = esp_timer_get_time() - t0;
+    printf("update: %.3f us with the sequence counter, %.3f us with a mutex\n",
+            (double)t_seq / BENCH_NB, (double)t_mutex / BENCH_NB);
+
+    printf("End of statistics test: %s\n", (ok == true) ? "SUCCESS" : "FAILURE");
+
+    while (1) {
+        vTaskDelay(8000 / portTICK_PERIOD_MS);
+    }
+}
@@ -0,0 +1,230 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    Check the packet time conversion of timecache.c against the one thread_up
+    used to do: lgw_cnt2utc() and gmtime() for the "time" field, lgw_cnt2gps()
+    and a double for the "tmms" field. Time references are taken across second,
+    day, year, leap day and leap second boundaries, with the extreme XTAL
+    errors, and the counter wraps. Then compare the cost of both conversions.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+
+#include "loragw_hal.h"
+#include "loragw_gps.h"
+#include "rxpk_json.h"
+#include "timecache.h"
+
+
+#define GPS_EPOCH       315964800   /* 06.Jan.1980 in UNIX time */
+#define SAMPLE_NB       20000       /* packets per reference */
+#define BENCH_NB        10000
+#define BUFF_SIZE       512
+
+struct ref_case_s {
+    const char *    name;
+    time_t          utc_sec;    /* reference UTC time */
+    long            utc_nsec;
+    int             leap_sec;   /* GPS - UTC */
+};
+
+static const struct ref_case_s ref_cases[] = {
+    {"second",              1686830399,  999999000, 18}, /* 2023-06-15T11:59:59.999999 */
+    {"day & year",          1703980790,  250000000, 18}, /* 2023-12-31T23:59:50.25 */
+    {"leap day",            1709164795,  123456789, 18}, /* 2024-02-28T23:59:55 */
+    {"leap day, year 2000", 951782390,   1,         13}, /* 2000-02-28T23:59:50 */
+    {"leap second, before", 1483228790,  500000000, 17}, /* 2016-12-31T23:59:50 */
+    {"leap second, after",  1483228810,  500000000, 18}, /* 2017-01-01T00:00:10 */
+};
+
+static const double xtal_errs[] = {0.99999, 0.9999973, 1.0, 1.0000061, 1.00001};
+
+static struct lgw_pkt_rx_desc_s pkt;
+static uint8_t payload[1];
+static char out[BUFF_SIZE];
+static uint32_t seed = 1;
+
+static uint32_t rand32(void)
+{
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) | ((seed * 1103515245 + 12345) & 0xFFFF0000);
+}
+
+/* "time" field as written by the serializer */
+static bool time_field(const struct timespec * utc, char * field)
+{
+    char * s;
+    int j;
+
+    j = rxpk_json_write(&pkt, utc, NULL, out, sizeof out - 1);
+    if (j < 0) {
+        return false;
+    }
+    out[j] = '\0';
+    s = strstr(out, ",\"time\":\"");
+    if ((s == NULL) || (strchr(s + 9, '"') == NULL)) {
+        return false;
+    }
+    j = strchr(s + 9, '"') - s + 1;
+    memcpy(field, s, j);
+    field[j] = '\0';
+    return true;
+}
+
+/* one packet, both ways */
+static bool check_count(struct timecache_s * c, const struct tref * ref, uint32_t count_us)
+{
+    struct timespec utc_ref, gps_ref, utc;
+    uint64_t ms_ref, ms;
+    char field_ref[80], field[80];
+    struct tm * x;
+
+    if ((lgw_cnt2utc(*ref, count_us, &utc_ref) != LGW_GPS_SUCCESS) || (lgw_cnt2gps(*ref, count_us, &gps_ref) != LGW_GPS_SUCCESS)) {
+        printf("ERROR: reference conversion failed\n");
+        return false;
+    }
+    ms_ref = gps_ref.tv_sec * 1E3 + gps_ref.tv_nsec / 1E6;
+    x = gmtime(&(utc_ref.tv_sec));
+    snprintf(field_ref, sizeof field_ref, ",\"time\":\"%04i-%02i-%02iT%02i:%02i:%02i.%06liZ\"", (x->tm_year)+1900, (x->tm_mon)+1, x->tm_mday, x->tm_hour, x->tm_min, x->tm_sec, (long)((utc_ref.tv_nsec)/1000));
+
+    if (timecache_convert(c, count_us, &utc, &ms) != 0) {
+        printf("ERROR: conversion failed\n");
+        return false;
+    }
+    if ((utc.tv_sec != utc_ref.tv_sec) || ((utc.tv_nsec / 1000) != (utc_ref.tv_nsec / 1000)) || (ms != ms_ref)) {
+        printf("ERROR: count %u: UTC %lld.%09ld, GPS %llu ms instead of %lld.%09ld, %llu ms\n", count_us,
+                (long long)utc.tv_sec, utc.tv_nsec, (unsigned long long)ms,
+                (long long)utc_ref.tv_sec, utc_ref.tv_nsec, (unsigned long long)ms_ref);
+        return false;
+    }
+    if ((time_field(&utc, field) == false) || (strcmp(field, field_ref) != 0)) {
+        printf("ERROR: count %u: %s instead of %s\n", count_us, field, field_ref);
+        return false;
+    }
+    return true;
+}
+
+static bool check_ref(const struct ref_case_s * rc, double xtal_err, uint32_t * fallback_nb)
+{
+    struct timecache_s c = { .valid = false };
+    struct tref ref;
+    struct timespec utc;
+    uint64_t ms;
+    uint32_t count, step;
+    int i;
+
+    memset(&ref, 0, sizeof ref);
+    ref.systime = time(NULL) + 1;
+    ref.count_us = rand32();
+    ref.utc.tv_sec = rc->utc_sec;
+    ref.utc.tv_nsec = rc->utc_nsec;
+    ref.gps.tv_sec = rc->utc_sec - GPS_EPOCH + rc->leap_sec;
+    ref.gps.tv_nsec = rc->utc_nsec;
+    ref.xtal_err = xtal_err;
+    timecache_set_ref(&c, &ref);
+
+    /* GPS - UTC offset of the reference, through the cache */
+    if ((timecache_convert(&c, ref.count_us, &utc, &ms) != 0) || ((int64_t)(ms / 1000) - (utc.tv_sec - GPS_EPOCH) != rc->leap_sec)) {
+        printf("ERROR: %s: GPS - UTC is not %d s\n", rc->name, rc->leap_sec);
+        return false;
+    }
+
+    /* a batch every ~10 ms across the next seconds, then anywhere in the counter range, wrapping */
+    count = ref.count_us;
+    for (i = 0; i < SAMPLE_NB; i++) {
+        step = (i < (SAMPLE_NB / 2)) ? (rand32() % 20000) : rand32();
+        count += step;
+        if (check_count(&c, &ref, count) == false) {
+            printf("ERROR: %s, XTAL error %.7f, reference count %u\n", rc->name, xtal_err, ref.count_us);
+            return false;
+        }
+    }
+    *fallback_nb += c.fallback_nb;
+    return true;
+}
+
+static void bench(void)
+{
+    struct timecache_s c = { .valid = false };
+    struct tref ref;
+    struct timespec utc, gps;
+    uint64_t ms;
+    int64_t t0, t_lib, t_cache;
+    volatile uint64_t sink = 0;
+    int i;
+
+    memset(&ref, 0, sizeof ref);
+    ref.systime = time(NULL) + 1;
+    ref.count_us = 1000;
+    ref.utc.tv_sec = ref_cases[0].utc_sec;
+    ref.gps.tv_sec = ref_cases[0].utc_sec - GPS_EPOCH + 18;
+    ref.xtal_err = xtal_errs[3];
+
+    t0 = esp_timer_get_time();
+    for (i = 0; i < BENCH_NB; i++) {
+        lgw_cnt2utc(ref, ref.count_us + i * 1013, &utc);
+        lgw_cnt2gps(ref, ref.count_us + i * 1013, &gps);
+        ms = gps.tv_sec * 1E3 + gps.tv_nsec / 1E6;
+        sink += ms + utc.tv_nsec;
+    }
+    t_lib = esp_timer_get_time() - t0;
+    t0 = esp_timer_get_time();
+    for (i = 0; i < BENCH_NB; i++) {
+        timecache_set_ref(&c, &ref); /* once per batch in thread_up, the worst case here */
+        timecache_convert(&c, ref.count_us + i * 1013, &utc, &ms);
+        sink += ms + utc.tv_nsec;
+    }
+    t_cache = esp_timer_get_time() - t0;
+    printf("conversion per packet: %.3f us with the library, %.3f us with the cache\n",
+            (double)t_lib / BENCH_NB, (double)t_cache / BENCH_NB);
+}
+
+void app_main(void)
+{
+    bool ok = true;
+    uint32_t fallback_nb = 0;
+    unsigned i, j;
+
+    printf("Beginning of time cache test\n");
+
+    pkt.modulation = MOD_LORA;
+    pkt.datarate = DR_LORA_SF7;
+    pkt.bandwidth = BW_125KHZ;
+    pkt.coderate = CR_LORA_4_5;
+    pkt.status = STAT_CRC_OK;
+    pkt.size = sizeof payload;
+    pkt.payload = payload;
+
+    for (i = 0; (i < sizeof ref_cases / sizeof ref_cases[0]) && (ok == true); i++) {
+        for (j = 0; (j < sizeof xtal_errs / sizeof xtal_errs[0]) && (ok == true); j++) {
+            ok = check_ref(&ref_cases[i], xtal_errs[j], &fallback_nb);
+        }
+        vTaskDelay(1);
+    }
+    printf("%u packets checked, %u converted by the library (rounding boundary)\n",
+            i * j * SAMPLE_NB, fallback_nb);
+
+    bench();
+
+    printf("End of time cache test: %s\n", (ok == true) ? "SUCCESS" : "FAILURE");
+
+    while (1) {
+        vTaskDelay(8000 / portTICK_PERIOD_MS);
+    }
+}
@@ -0,0 +1,365 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    Check the deferred logging: levels per module, binary records, messages
+    of several tasks written into the ring at once and drop counting while the
+    drain task is stalled. Then tasks log records of sizes that are not
+    multiples of each other as fast as they can, wrapping the ring many times
+    with headers landing on former payload bytes: each line printed must be a
+    whole committed record. Also measure the time a simulated fetch loop
+    spends logging, with synchronous and with deferred logging.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "trace.h"
+
+
+#define RING_SIZE   8192    /* log ring */
+#define PROD_NB     4       /* tasks logging at once */
+#define MSG_NB      5000    /* messages per task */
+#define PAD_MOD     60      /* messages padded with seq % PAD_MOD characters */
+#define STALL_NB    1000    /* messages written while the drain task is stalled */
+#define FETCH_NB    100     /* simulated fetch cycles */
+#define FETCH_MS    50      /* their period */
+#define WAIT_US     10000000 /* longest wait for the drain task */
+#define WRAP_NB     20000   /* messages per task, wrapping the ring */
+#define WRAP_MOD    53      /* their padding: (seq * 7 + id * 13) % WRAP_MOD characters */
+
+
+static char line[512];      /* line being received */
+static int line_len = 0;
+static char last_line[512]; /* last line that is not from the checks below */
+static volatile uint32_t line_nb = 0; /* lines of the producers received and valid */
+static volatile uint32_t stall_nb = 0; /* lines of the stall check received */
+static volatile uint32_t drop_reported = 0; /* sum of the drop warnings of the drain task */
+static volatile bool stall = false; /* output blocked while true */
+static volatile bool stalled = false;
+static volatile bool ok = true;
+static volatile bool strict = false; /* any other line is an error */
+static uint32_t next_seq[PROD_NB];
+static volatile int prod_done = 0;
+
+static const char json[] = "{\"rxpk\":[{\"tmst\":3512348611,\"chan\":2,\"rfch\":0,\"freq\":866.349812,\"stat\":1,\"modu\":\"LORA\","
+                           "\"datr\":\"SF7BW125\",\"codr\":\"4/6\",\"rssi\":-35,\"lsnr\":5.1,\"size\":32,"
+                           "\"data\":\"-DS4CGaDCdG+48eJNM3Vai-zDpsR71Pn9CPA9uCON84\"}]}";
+
+static bool pad_ok(const char * pad, uint32_t seq)
+{
+    uint32_t i;
+
+    for (i = 0; i < (seq % PAD_MOD); i++) {
+        if (pad[i] != (char)('a' + (seq % 26))) {
+            return false;
+        }
+    }
+    return (pad[i] == '\0');
+}
+
+static void pad_make(char * pad, uint32_t seq)
+{
+    memset(pad, 'a' + (seq % 26), seq % PAD_MOD);
+    pad[seq % PAD_MOD] = '\0';
+}
+
+static int wrap_len(int id, uint32_t seq)
+{
+    return (seq * 7 + id * 13) % WRAP_MOD;
+}
+
+static bool wrap_ok(const char * pad, int id, uint32_t seq)
+{
+    int i;
+
+    for (i = 0; i < wrap_len(id, seq); i++) {
+        if (pad[i] != (char)('A' + (seq % 26))) {
+            return false;
+        }
+    }
+    return (pad[i] == '\0');
+}
+
+static void check_line(const char * l)
+{
+    unsigned id, seq, n;
+    int pos = 0;
+
+    if (l[0] == '\0') {
+        return;
+    }
+    if (sscanf(l, "WARNING: %u log messages dropped", &n) == 1) {
+        drop_reported += n;
+    } else if ((sscanf(l, "P%u %u %n", &id, &seq, &pos) == 2) || (sscanf(l, "B %u %u %n", &id, &seq, &pos) == 2)) {
+        if ((id >= PROD_NB) || (seq < next_seq[id]) || (pad_ok(l + pos, seq) == false)) {
+            printf("ERROR: unexpected line \"%s\"\n", l);
+            ok = false;
+            return;
+        }
+        next_seq[id] = seq + 1;
+        line_nb += 1;
+    } else if ((sscanf(l, "W%u %u %n", &id, &seq, &pos) == 2) || (sscanf(l, "V %u %u %n", &id, &seq, &pos) == 2)) {
+        if ((id >= PROD_NB) || (seq < next_seq[id]) || (wrap_ok(l + pos, id, seq) == false)) {
+            printf("ERROR: unexpected line \"%s\"\n", l);
+            ok = false;
+            return;
+        }
+        next_seq[id] = seq + 1;
+        line_nb += 1;
+    } else if (l[0] == 'S') {
+        stall_nb += 1;
+    } else if (strict == true) {
+        printf("ERROR: unexpected line \"%s\"\n", l);
+        ok = false;
+    } else {
+        strcpy(last_line, l);
+    }
+}
+
+/* output of the messages, splitting them into lines */
+static void collect(const char * text, size_t len)
+{
+    size_t i;
+
+    while (stall == true) {
+        stalled = true;
+        vTaskDelay(1);
+    }
+    for (i = 0; i < len; i++) {
+        if (text[i] == '\n') {
+            line[line_len] = '\0';
+            check_line(line);
+            line_len = 0;
+        } else if (line_len < (int)(sizeof line - 1)) {
+            line[line_len++] = text[i];
+        }
+    }
+}
+
+static uint32_t dropped_nb(void)
+{
+    uint32_t nb = 0;
+    int i;
+
+    for (i = 0; i < TRACE_MOD_NB; i++) {
+        nb += trace_get_module(i, NULL, NULL);
+    }
+    return nb;
+}
+
+static bool wait_for(volatile uint32_t * nb, uint32_t expected)
+{
+    int64_t t0 = esp_timer_get_time();
+
+    while ((*nb < expected) && ((esp_timer_get_time() - t0) < WAIT_US)) {
+        vTaskDelay(10 / portTICK_PERIOD_MS);
+    }
+    return (*nb == expected);
+}
+
+static void producer(void *arg)
+{
+    int id = (int)(intptr_t)arg;
+    char pad[PAD_MOD];
+    char data[96];
+    uint32_t seq;
+    int len;
+
+    for (seq = 0; seq < MSG_NB; seq++) {
+        pad_make(pad, seq);
+        if ((seq % 5) == 4) {
+            len = snprintf(data, sizeof data, "%d %u %s", id, seq, pad);
+            trace_bin(TRACE_LVL_INFO, TRACE_MOD_UP, "B ", data, len, TRACE_BIN_TEXT);
+        } else {
+            trace_printf(TRACE_LVL_INFO, TRACE_MOD_DOWN, "P%d %u %s\n", id, seq, pad);
+        }
+        if ((seq % 32) == 31) {
+            vTaskDelay(1); /* let the drain task run */
+        }
+    }
+    __atomic_fetch_add(&prod_done, 1, __ATOMIC_RELEASE);
+    vTaskDelete(NULL);
+}
+
+/* records of varying sizes, as fast as possible */
+static void wrapper(void *arg)
+{
+    int id = (int)(intptr_t)arg;
+    char pad[WRAP_MOD];
+    char data[96];
+    uint32_t seq;
+    int len;
+
+    for (seq = 0; seq < WRAP_NB; seq++) {
+        memset(pad, 'A' + (seq % 26), wrap_len(id, seq));
+        pad[wrap_len(id, seq)] = '\0';
+        if ((seq % 3) == 2) {
+            len = snprintf(data, sizeof data, "%d %u %s", id, seq, pad);
+            trace_bin(TRACE_LVL_INFO, TRACE_MOD_UP, "V ", data, len, TRACE_BIN_TEXT);
+        } else {
+            trace_printf(TRACE_LVL_INFO, TRACE_MOD_DOWN, "W%d %u %s\n", id, seq, pad);
+        }
+        if ((seq % 256) == 255) {
+            vTaskDelay(1);
+        }
+    }
+    __atomic_fetch_add(&prod_done, 1, __ATOMIC_RELEASE);
+    vTaskDelete(NULL);
+}
+
+/* time spent logging per cycle of a fetch loop, on the real output */
+static void fetch_loop(const char * mode)
+{
+    int64_t t0, t, t_sum = 0, t_max = 0;
+    uint32_t dropped = dropped_nb();
+    int i;
+
+    for (i = 0; i < FETCH_NB; i++) {
+        t0 = esp_timer_get_time();
+        trace_printf(TRACE_LVL_INFO, TRACE_MOD_UP, "\nINFO: Received pkt from mote: %08X (fcnt=%u)\n", 0x260B1234, i);
+        trace_bin(TRACE_LVL_INFO, TRACE_MOD_UP, "\nJSON up: ", json, sizeof json - 1, TRACE_BIN_TEXT);
+        t = esp_timer_get_time() - t0;
+        t_sum += t;
+        if (t > t_max) {
+            t_max = t;
+        }
+        vTaskDelay(FETCH_MS / portTICK_PERIOD_MS);
+    }
+    printf("fetch loop, %s logging: %.1f us avg, %lld us max per cycle, %u messages dropped\n",
+            mode, (double)t_sum / FETCH_NB, (long long)t_max, dropped_nb() - dropped);
+}
+
+void app_main(void)
+{
+    static const uint8_t bin[3] = {0x01, 0xAB, 0x00};
+    uint8_t hex[77]; /* more than 2 formatting chunks */
+    char expected[3 * sizeof hex + 8];
+    char pad[PAD_MOD];
+    char big[400];
+    uint32_t dropped;
+    int i;
+
+    printf("Beginning of trace test\n");
+
+    /* synchronous: levels and formats */
+    trace_set_output(collect);
+    MSG("INFO: [up] shown %d\n", 1);
+    ok &= (strcmp(last_line, "INFO: [up] shown 1") == 0);
+    ok &= (trace_set_level("up", "warning") == 0);
+    MSG("INFO: [up] hidden\n");
+    ok &= (strcmp(last_line, "INFO: [up] shown 1") == 0);
+    MSG("\nWARNING: [up] shown %d\n", 2);
+    ok &= (strcmp(last_line, "WARNING: [up] shown 2") == 0);
+    MSG("INFO: [down] shown %d\n", 3);
+    ok &= (strcmp(last_line, "INFO: [down] shown 3") == 0);
+    trace_printf(TRACE_LVL_INFO, TRACE_MOD_UP, "hidden\n");
+    ok &= (strcmp(last_line, "INFO: [down] shown 3") == 0);
+    ok &= (trace_set_level("all", "info") == 0);
+    ok &= (trace_set_level("nope", "info") == -1);
+    ok &= (trace_set_level("up", "loud") == -1);
+    trace_bin(TRACE_LVL_INFO, TRACE_MOD_DOWN, "   => ", bin, sizeof bin, TRACE_BIN_HEX);
+    ok &= (strcmp(last_line, "   => 01 AB 00 ") == 0);
+    strcpy(expected, "=> ");
+    for (i = 0; i < (int)sizeof hex; i++) {
+        hex[i] = (uint8_t)(i * 37);
+        sprintf(expected + 3 + 3 * i, "%02X ", hex[i]);
+    }
+    trace_bin(TRACE_LVL_INFO, TRACE_MOD_DOWN, "=> ", hex, sizeof hex, TRACE_BIN_HEX);
+    ok &= (strcmp(last_line, expected) == 0);
+    memset(big, 'x', sizeof big - 1);
+    big[sizeof big - 1] = '\0';
+    MSG("INFO: %s\n", big);
+    ok &= (strlen(last_line) == 254);
+    if (ok == false) {
+        printf("ERROR: synchronous logging, last line \"%s\"\n", last_line);
+    }
+
+    /* fetch loop timing, printing on the console */
+    trace_set_output(NULL);
+    fetch_loop("synchronous");
+    if (trace_start(RING_SIZE, 1) != 0) {
+        printf("ERROR: failed to start deferred logging\n");
+        ok = false;
+    }
+    fetch_loop("deferred");
+    vTaskDelay(1000 / portTICK_PERIOD_MS);
+    trace_set_output(collect);
+
+    /* drain task stalled: the ring fills up, then the messages are dropped and counted */
+    dropped = dropped_nb();
+    drop_reported = 0;
+    stall = true;
+    MSG("S\n");
+    for (i = 0; (i < (WAIT_US / 1000)) && (stalled == false); i++) {
+        vTaskDelay(1);
+    }
+    pad_make(pad, PAD_MOD - 1);
+    for (i = 0; i < STALL_NB; i++) {
+        MSG("S %d %s%s\n", i, pad, pad);
+    }
+    dropped = dropped_nb() - dropped;
+    stall = false;
+    if ((stalled == false) || (dropped == 0) || (dropped == STALL_NB)) {
+        printf("ERROR: %u messages of %u dropped while the drain task is stalled\n", dropped, STALL_NB);
+        ok = false;
+    } else if ((wait_for(&stall_nb, 1 + STALL_NB - dropped) == false) || (wait_for(&drop_reported, dropped) == false)) {
+        printf("ERROR: %u messages printed, %u drops reported, for %u dropped\n", stall_nb, drop_reported, dropped);
+        ok = false;
+    }
+    printf("drain task stalled: %u messages logged, %u dropped\n", stall_nb, dropped);
+
+    /* several tasks logging at once */
+    dropped = dropped_nb();
+    for (i = 0; i < PROD_NB; i++) {
+        xTaskCreatePinnedToCore(producer, "producer", 3072, (void *)(intptr_t)i, uxTaskPriorityGet(NULL), NULL, tskNO_AFFINITY);
+    }
+    while (__atomic_load_n(&prod_done, __ATOMIC_ACQUIRE) < PROD_NB) {
+        vTaskDelay(10 / portTICK_PERIOD_MS);
+    }
+    dropped = dropped_nb() - dropped;
+    if (wait_for(&line_nb, (PROD_NB * MSG_NB) - dropped) == false) {
+        printf("ERROR: %u messages printed, %u dropped, for %u logged\n", line_nb, dropped, PROD_NB * MSG_NB);
+        ok = false;
+    }
+    printf("%d tasks logging at once: %u messages printed, %u dropped\n", PROD_NB, line_nb, dropped);
+
+    /* the ring wrapped many times, records of sizes not multiple of each other */
+    strict = true;
+    line_nb = 0;
+    prod_done = 0;
+    memset(next_seq, 0, sizeof next_seq);
+    dropped = dropped_nb();
+    for (i = 0; i < PROD_NB; i++) {
+        xTaskCreatePinnedToCore(wrapper, "wrapper", 3072, (void *)(intptr_t)i, uxTaskPriorityGet(NULL), NULL, tskNO_AFFINITY);
+    }
+    while (__atomic_load_n(&prod_done, __ATOMIC_ACQUIRE) < PROD_NB) {
+        vTaskDelay(10 / portTICK_PERIOD_MS);
+    }
+    dropped = dropped_nb() - dropped;
+    if (wait_for(&line_nb, (PROD_NB * WRAP_NB) - dropped) == false) {
+        printf("ERROR: %u messages printed, %u dropped, for %u logged\n", line_nb, dropped, PROD_NB * WRAP_NB);
+        ok = false;
+    }
+    vTaskDelay(100 / portTICK_PERIOD_MS); /* for the drop warnings */
+    strict = false;
+    printf("ring wrapped: %u messages printed, %u dropped\n", line_nb, dropped);
+
+    printf("End of trace test: %s\n", (ok == true) ? "SUCCESS" : "FAILURE");
+
+    while (1) {
+        vTaskDelay(8000 / portTICK_PERIOD_MS);
+    }
+}
@@ -0,0 +1,403 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    Equivalence test and benchmark of the txpk JSON parser (txpk_json.c) against
+    json_parse_string_with_comments() of parson, the former PULL_RESP parser.
+    Both must accept the same documents and give the txpk fields the same
+    types and values, on a corpus of PULL_RESP payloads as network servers send
+    them, on hand-written corner cases of parson's grammar, and on the corpus
+    randomly mutated (chars replaced, inserted, deleted, truncated).
+    The benchmark compares the cycles per PULL_RESP of both parsers, fields
+    lookup included, and the heap they use: parson allocations are counted
+    through json_set_allocation_functions().
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "hal/cpu_hal.h"
+
+#include "parson.h"
+#include "txpk_json.h"
+
+
+#define ROUND_NB        200000
+#define BENCH_ROUND_NB  2000
+#define BUFF_SIZE       1000    /* as buff_down of thread_down */
+
+/* PULL_RESP payloads, in the shapes network servers send them */
+static const char * const corpus[] = {
+    /* PROTOCOL.md examples */
+    "{\"txpk\":{\n\t\"imme\":true,\n\t\"freq\":864.123456,\n\t\"rfch\":0,\n\t\"powe\":14,\n\t\"modu\":\"LORA\",\n\t\"datr\":\"SF11BW125\",\n\t\"codr\":\"4/6\",\n\t\"ipol\":false,\n\t\"size\":32,\n\t\"data\":\"H3P3N2i9qc4yt7rK7ldqoeCVJGBybzPY5h1Dd7P7p8v\"\n}}",
+    "{\"txpk\":{\n\t\"imme\":true,\n\t\"freq\":861.3,\n\t\"rfch\":0,\n\t\"powe\":12,\n\t\"modu\":\"FSK\",\n\t\"datr\":50000,\n\t\"fdev\":3000,\n\t\"size\":32,\n\t\"data\":\"H3P3N2i9qc4yt7rK7ldqoeCVJGBybzPY5h1Dd7P7p8v\"\n}}",
+    /* Class A, RX1 then RX2 */
+    "{\"txpk\":{\"imme\":false,\"rfch\":0,\"powe\":14,\"ant\":0,\"brd\":0,\"tmst\":3843412020,\"freq\":868.1,\"modu\":\"LORA\",\"datr\":\"SF7BW125\",\"codr\":\"4/5\",\"ipol\":true,\"size\":33,\"data\":\"YHBhYUoAAwABcAMBEAP/AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA==\"}}",
+    "{\"txpk\":{\"imme\":false,\"rfch\":0,\"powe\":27,\"ant\":0,\"brd\":0,\"tmst\":1066581,\"freq\":869.525,\"modu\":\"LORA\",\"datr\":\"SF12BW125\",\"codr\":\"4/5\",\"ipol\":true,\"size\":12,\"ncrc\":true,\"data\":\"YHBhYUoAAAAOTgHc\"}}",
+    "{\"txpk\":{\"imme\":false,\"tmst\":2129104563,\"freq\":923.3,\"rfch\":0,\"powe\":20,\"modu\":\"LORA\",\"datr\":\"SF10BW500\",\"codr\":\"4/5\",\"ipol\":true,\"size\":17,\"ncrc\":true,\"data\":\"IIE3xhKqa6hVxbCgNHcOqYA=\"}}",
+    /* Join Accept */
+    "{\"txpk\":{\"imme\":false,\"tmst\":502139860,\"freq\":868.3,\"rfch\":0,\"powe\":14,\"modu\":\"LORA\",\"datr\":\"SF9BW125\",\"codr\":\"4/5\",\"ipol\":true,\"size\":33,\"ncrc\":true,\"data\":\"IIjRjTnmbEp5QVr8FAb5/E6hEFqiIfnhBdxUjA2ANSB7\"}}",
+    /* Class B ping slot, on GPS time */
+    "{\"txpk\":{\"imme\":false,\"tmms\":1381156524004,\"freq\":869.525,\"rfch\":0,\"powe\":14,\"modu\":\"LORA\",\"datr\":\"SF9BW125\",\"codr\":\"4/5\",\"ipol\":true,\"size\":13,\"ncrc\":true,\"data\":\"YAQDAiEBAAEBrC8AfA==\"}}",
+    /* Class C */
+    "{\"txpk\":{\"imme\":true,\"freq\":869.525,\"rfch\":0,\"powe\":14,\"modu\":\"LORA\",\"datr\":\"SF9BW125\",\"codr\":\"4/5\",\"ipol\":true,\"prea\":8,\"size\":64,\"data\":\"YAQDAiEAAAAC3NYtOCsAtqeMgDjvSHtw/P9Az+fXfuUzq97VAPvDwGKKaC8KuvWJT9C4VVHaY5LY+xKiHGRpNeALwQ==\"}}",
+    /* FSK, on timestamp */
+    "{\"txpk\":{\"imme\":false,\"tmst\":40000000,\"freq\":868.8,\"rfch\":0,\"powe\":14,\"modu\":\"FSK\",\"datr\":50000,\"fdev\":25000,\"prea\":5,\"size\":16,\"ncrc\":false,\"data\":\"YDFBRQIAAwABcAMBEAP/AA\"}}",
+    /* LoRa, no header, pretty-printed with a comment */
+    "{\n  // ping of the test bench\n  \"txpk\": {\n    \"imme\": false,\n    \"tmst\": 4294967000,\n    \"freq\": 867.5,\n    \"rfch\": 1,\n    \"powe\": 0,\n    \"modu\": \"LORA\",\n    \"datr\": \"SF6BW250\",\n    \"codr\": \"4/8\",\n    \"ipol\": false,\n    \"nhdr\": true,\n    \"ncrc\": true,\n    \"size\": 4,\n    \"data\": \"3q2+7w==\"\n  }\n}\n",
+    /* the largest payload of EU868 DR5 */
+    "{\"txpk\":{\"imme\":false,\"rfch\":0,\"powe\":14,\"tmst\":1337,\"freq\":868.5,\"modu\":\"LORA\",\"datr\":\"SF7BW125\",\"codr\":\"4/5\",\"ipol\":true,\"size\":242,\"data\":\"YAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrC8AfAQDAiEBAAEBrA==\"}}",
+    /* extra objects around */
+    "{\"txpk\":{\"imme\":false,\"tmst\":123456789,\"freq\":868.1,\"rfch\":0,\"powe\":14,\"modu\":\"LORA\",\"datr\":\"SF8BW125\",\"codr\":\"4/5\",\"ipol\":true,\"size\":5,\"data\":\"AQIDBAU=\",\"meta\":{\"gateway\":\"0016c001ff10a235\",\"trace\":[1,2.5,null,true,\"x\"]}},\"token\":\"a1b2\"}",
+};
+
+/* corner cases of parson's grammar */
+static const char * const corner[] = {
+    "{\"txpk\":{}}",
+    "[{\"txpk\":{}}]",
+    "{\"txpk\":[]}",
+    "{\"txpk\":null}",
+    "{\"x\":{\"txpk\":{}}}",
+    "  \n{\"txpk\":{\"freq\":868.1}}  trailing garbage",
+    "\"txpk\"",
+    "{\"txpk\":{\"freq\":868.1,}}",
+    "{\"txpk\":{\"freq\":868.1,\"freq\":868.3}}",
+    "{\"txpk\":{\"freq\":868.1},\"txpk\":{}}",
+    "{\"txpk\":{\"a\":{\"b\":1,\"b\":2}}}",
+    "{\"txpk\":{\"a\":{\"b\":1},\"c\":{\"b\":2}}}",
+    "{\"txpk\":{\"a\":{\"a\":{\"a\":1}}}}",
+    "{xtxpk\":{?freq\":868.1}}",
+    "{\"txpk\":{x\":1}}",
+    "{\"txpk\":{\"modu\":\"LORA\\u0000FSK\",\"datr\":\"SF7\\u0042W125\",\"codr\":\"4\\/5\"}}",
+    "{\"txpk\":{\"modu\":\"\\u00e9\\u20ac\\ud83d\\ude00\"}}",
+    "{\"txpk\":{\"modu\":\"\\ud83d\"}}",
+    "{\"txpk\":{\"modu\":\"\\ude00\"}}",
+    "{\"txpk\":{\"modu\":\"\\uD83D\\u0041\"}}",
+    "{\"txpk\":{\"modu\":\"\\u12\"}}",
+    "{\"txpk\":{\"modu\":\"\\a\"}}",
+    "{\"txpk\":{\"modu\":\"tab\there\"}}",
+    "{\"txpk\":{\"fr\\u0065q\":868.1,\"freq\\u0000x\":1}}",
+    "{\"txpk\":{\"freq\":01}}",
+    "{\"txpk\":{\"freq\":-01}}",
+    "{\"txpk\":{\"freq\":0.5,\"size\":-0.0,\"rfch\":-0}}",
+    "{\"txpk\":{\"freq\":0x10}}",
+    "{\"txpk\":{\"freq\":1e3,\"size\":1E-2,\"powe\":-inf,\"prea\":-nan}}",
+    "{\"txpk\":{\"freq\":1e999,\"size\":1.}}",
+    "{\"txpk\":{\"freq\":-}}",
+    "{\"txpk\":{\"freq\":- 1}}",
+    "{\"txpk\":{\"imme\":truex}}",
+    "{\"txpk\":{\"imme\":tru}}",
+    "{\"txpk\":{\"imme\":\"true\",\"ncrc\":null,\"ipol\":1,\"nhdr\":false}}",
+    "{\"txpk\":{\"freq\":868.1 /* comment */,\"rfch\":/**/0}}",
+    "{\"txpk\":{\"freq\":868/* split */1}}",
+    "{\"txpk\":{\"modu\":\"LO/*RA*/\"}}",
+    "{\"txpk\":{\"modu\":\"LO//RA\"}}",
+    "{\"txpk\":{\"freq\":868.1} // no new line",
+    "{\"txpk\":{\"freq\":868.1} /* not closed",
+    "{\"txpk\":{\"freq\":868.1,// no new line\n\"rfch\":0}}",
+    "{\"txpk\":{\"modu\":\"a\\\"b\",\"datr\":\"\\\\\"}} /* \\\" */",
+    "\\\"{\"txpk\":{}}",
+    "{\"txpk\":{\"modu\":\"x\"}}\"",
+    "{\"txpk\":{\"modu\":\"x",
+    "{\"txpk\":{\"data\":\"\"}}",
+    "{\"txpk\":{\"\":1,\"\":2}}",
+    "{}",
+    "[]",
+    "",
+    "{\"a\":[[[[[[[[[[[[[[[[[[[]]]]]]]]]]]]]]]]]],\"txpk\":{}}",
+    "{\"a\":[[[[[[[[[[[[[[[[[[[1]]]]]]]]]]]]]]]]]],\"txpk\":{}}",
+    "{\"a\":[[[[[[[[[[[[[[[[[[[[]]]]]]]]]]]]]]]]]]]],\"txpk\":{}}",
+    "{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{}}}}}}}}}}}}}}}}}}}},\"txpk\":{}}",
+    "{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":{\"a\":1}}}}}}}}}}}}}}}}}}}},\"txpk\":{}}",
+    "\x0b\x0c{\"txpk\":{\"modu\":\"\xc3\xa9\xff\"}}",
+};
+
+static const char * const field_name[TXPK_FIELD_NB] = {
+    "imme", "tmst", "tmms", "freq", "rfch", "powe", "modu", "datr",
+    "codr", "fdev", "ipol", "prea", "size", "data", "ncrc", "nhdr"
+};
+
+/* what the mutations put in */
+static const char alphabet[] = "{}[]\":,\\/*\n tfn0123456789.eE-+xuAbd";
+
+static char json_ref[BUFF_SIZE];
+static char json_new[BUFF_SIZE];
+static struct txpk_json_s txpk;
+
+/* parson heap use */
+static size_t heap_cur, heap_max;
+static uint32_t malloc_nb;
+
+static void * count_malloc(size_t size)
+{
+    size_t * p = malloc(size + sizeof(size_t) * 2); /* keeps the alignment */
+
+    if (p == NULL) {
+        return NULL;
+    }
+    p[0] = size;
+    heap_cur += size;
+    if (heap_cur > heap_max) {
+        heap_max = heap_cur;
+    }
+    malloc_nb += 1;
+    return p + 2;
+}
+
+static void count_free(void * ptr)
+{
+    size_t * p = ptr;
+
+    if (p == NULL) {
+        return;
+    }
+    heap_cur -= p[-2];
+    free(p - 2);
+}
+
+static bool same_number(double a, double b)
+{
+    return (memcmp(&a, &b, sizeof a) == 0) || (isnan(a) && isnan(b));
+}
+
+/* parse with both, return false on a difference */
+static bool compare(const char * json, int * result)
+{
+    JSON_Value *root_val;
+    JSON_Object *txpk_obj = NULL;
+    JSON_Value *val;
+    int res_ref, res_new, i;
+    const char *str;
+
+    strncpy(json_ref, json, BUFF_SIZE - 1);
+    strncpy(json_new, json, BUFF_SIZE - 1);
+
+    root_val = json_parse_string_with_comments(json_ref);
+    if (root_val == NULL) {
+        res_ref = TXPK_JSON_INVALID;
+    } else {
+        txpk_obj = json_object_get_object(json_value_get_object(root_val), "txpk");
+        res_ref = (txpk_obj == NULL) ? TXPK_JSON_NO_TXPK : TXPK_JSON_OK;
+    }
+    res_new = txpk_json_parse(json_new, &txpk);
+    *result = res_ref;
+
+    if (res_new != res_ref) {
+        printf("ERROR: parson %d, txpk_json %d on: %s\n", res_ref, res_new, json);
+        json_value_free(root_val);
+        return false;
+    }
+    for (i = 0; (res_ref == TXPK_JSON_OK) && (i < TXPK_FIELD_NB); i++) {
+        val = json_object_get_value(txpk_obj, field_name[i]);
+        if (((val == NULL) && (txpk_json_has(&txpk, i) == true)) || ((val != NULL) && ((int)json_value_get_type(val) != (int)txpk.field[i].type))) {
+            printf("ERROR: \"%s\" type %d, %d on: %s\n", field_name[i], (int)json_value_get_type(val), (int)txpk.field[i].type, json);
+            break;
+        }
+        if (same_number(json_value_get_number(val), txpk_json_number(&txpk, i)) == false) {
+            printf("ERROR: \"%s\" number %.17g, %.17g on: %s\n", field_name[i], json_value_get_number(val), txpk_json_number(&txpk, i), json);
+            break;
+        }
+        if (json_value_get_boolean(val) != txpk_json_boolean(&txpk, i)) {
+            printf("ERROR: \"%s\" boolean %d, %d on: %s\n", field_name[i], json_value_get_boolean(val), txpk_json_boolean(&txpk, i), json);
+            break;
+        }
+        str = json_value_get_string(val);
+        if ((str == NULL) != (txpk_json_string(&txpk, i) == NULL) || ((str != NULL) && (strcmp(str, txpk_json_string(&txpk, i)) != 0))) {
+            printf("ERROR: \"%s\" string \"%s\", \"%s\" on: %s\n", field_name[i], (str != NULL) ? str : "(null)", (txpk_json_string(&txpk, i) != NULL) ? txpk_json_string(&txpk, i) : "(null)", json);
+            break;
+        }
+    }
+    json_value_free(root_val);
+
+    return (res_ref != TXPK_JSON_OK) || (i == TXPK_FIELD_NB);
+}
+
+static int check_corner(void)
+{
+    int i, result, errors = 0;
+    int nb[3] = {0, 0, 0};
+
+    for (i = 0; i < (int)(sizeof corpus / sizeof corpus[0]); i++) {
+        if ((compare(corpus[i], &result) == false) || (result != TXPK_JSON_OK)) {
+            printf("ERROR: corpus %d not parsed\n", i);
+            errors++;
+        }
+    }
+    for (i = 0; i < (int)(sizeof corner / sizeof corner[0]); i++) {
+        if (compare(corner[i], &result) == false) {
+            errors++;
+        }
+        nb[result] += 1;
+    }
+    printf("corner cases: %d ok, %d invalid, %d without txpk, %d mismatches\n", nb[TXPK_JSON_OK], nb[TXPK_JSON_INVALID], nb[TXPK_JSON_NO_TXPK], errors);
+
+    return errors;
+}
+
+static void mutate(char * json)
+{
+    int len = strlen(json);
+    int n = 1 + rand() % 3;
+    int pos;
+
+    while ((n-- > 0) && (len > 0)) {
+        pos = rand() % len;
+        switch (rand() % 5) {
+            case 0: /* replace */
+                json[pos] = alphabet[rand() % (sizeof alphabet - 1)];
+                break;
+            case 1: /* insert */
+                if (len < (BUFF_SIZE - 2)) {
+                    memmove(json + pos + 1, json + pos, len - pos + 1);
+                    json[pos] = alphabet[rand() % (sizeof alphabet - 1)];
+                    len++;
+                }
+                break;
+            case 2: /* delete */
+                memmove(json + pos, json + pos + 1, len - pos);
+                len--;
+                break;
+            case 3: /* truncate */
+                json[pos] = '\0';
+                len = pos;
+                break;
+            default: /* any byte */
+                json[pos] = (char)(1 + rand() % 255);
+                break;
+        }
+    }
+}
+
+static int check_mutated(void)
+{
+    static char json[BUFF_SIZE];
+    int i, result, errors = 0;
+    int nb[3] = {0, 0, 0};
+
+    for (i = 0; (i < ROUND_NB) && (errors < 10); i++) {
+        if ((i % 2) == 0) {
+            strcpy(json, corpus[rand() % (sizeof corpus / sizeof corpus[0])]);
+        } else {
+            strcpy(json, corner[rand() % (sizeof corner / sizeof corner[0])]);
+        }
+        mutate(json);
+        if (compare(json, &result) == false) {
+            errors++;
+        }
+        nb[result] += 1;
+        if ((i % 10000) == 0) {
+            vTaskDelay(1);
+        }
+    }
+    printf("mutated: %d documents, %d ok, %d invalid, %d without txpk, %d mismatches\n", i, nb[TXPK_JSON_OK], nb[TXPK_JSON_INVALID], nb[TXPK_JSON_NO_TXPK], errors);
+
+    return errors;
+}
+
+/* the lookups thread_down makes, all fields of the LoRa or FSK path */
+static uint32_t lookup_ref(JSON_Object * txpk_obj)
+{
+    uint32_t sum = 0;
+    int i;
+
+    for (i = 0; i < TXPK_FIELD_NB; i++) {
+        sum += (json_object_get_value(txpk_obj, field_name[i]) != NULL);
+    }
+    sum += (uint32_t)json_object_get_number(txpk_obj, "freq");
+    sum += strlen(json_object_get_string(txpk_obj, "data"));
+    return sum;
+}
+
+static uint32_t lookup_new(const struct txpk_json_s * t)
+{
+    uint32_t sum = 0;
+    int i;
+
+    for (i = 0; i < TXPK_FIELD_NB; i++) {
+        sum += txpk_json_has(t, i);
+    }
+    sum += (uint32_t)txpk_json_number(t, TXPK_FREQ);
+    sum += strlen(txpk_json_string(t, TXPK_DATA));
+    return sum;
+}
+
+static void bench(void)
+{
+    JSON_Value *root_val;
+    uint32_t c0, c_ref = 0, c_new = 0, sum = 0;
+    size_t heap_doc_max = 0;
+    uint32_t malloc_doc_max = 0;
+    int i, n, len;
+
+    json_set_allocation_functions(count_malloc, count_free);
+    for (i = 0; i < BENCH_ROUND_NB; i++) {
+        for (n = 0; n < (int)(sizeof corpus / sizeof corpus[0]); n++) {
+            len = strlen(corpus[n]);
+            memcpy(json_ref, corpus[n], len + 1);
+            heap_cur = heap_max = 0;
+            malloc_nb = 0;
+            c0 = cpu_hal_get_cycle_count();
+            root_val = json_parse_string_with_comments(json_ref);
+            sum += lookup_ref(json_object_get_object(json_value_get_object(root_val), "txpk"));
+            json_value_free(root_val);
+            c_ref += cpu_hal_get_cycle_count() - c0;
+            if (heap_max > heap_doc_max) {
+                heap_doc_max = heap_max;
+            }
+            if (malloc_nb > malloc_doc_max) {
+                malloc_doc_max = malloc_nb;
+            }
+
+            /* in place, as in buff_down */
+            memcpy(json_new, corpus[n], len + 1);
+            heap_cur = heap_max = 0;
+            malloc_nb = 0;
+            c0 = cpu_hal_get_cycle_count();
+            txpk_json_parse(json_new, &txpk);
+            sum -= lookup_new(&txpk);
+            c_new += cpu_hal_get_cycle_count() - c0;
+            if (malloc_nb != 0) {
+                printf("ERROR: txpk_json allocated\n");
+            }
+        }
+        if ((i % 100) == 0) {
+            vTaskDelay(1);
+        }
+    }
+    json_set_allocation_functions(malloc, free);
+
+    n = BENCH_ROUND_NB * (sizeof corpus / sizeof corpus[0]);
+    printf("bench: parson %6.0f cycles/PULL_RESP, txpk_json %6.0f cycles/PULL_RESP%s\n",
+            (double)c_ref / n, (double)c_new / n, (sum == 0) ? "" : " (results differ)");
+    printf("heap: parson up to %u bytes in %u allocations per PULL_RESP, txpk_json none (%u bytes static)\n",
+            (unsigned)heap_doc_max, (unsigned)malloc_doc_max, (unsigned)sizeof(struct txpk_json_s));
+}
+
+void app_main(void)
+{
+    int errors;
+
+    printf("Beginning of txpk JSON parser test\n");
+
+    errors = check_corner();
+    errors += check_mutated();
+    bench();
+
+    printf("End of txpk JSON parser test: %s\n", (errors == 0) ? "SUCCESS" : "FAILURE");
+
+    while (1) {
+        vTaskDelay(8000 / portTICK_PERIOD_MS);
+    }
+}
@@ -0,0 +1,307 @@
+/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \____ \| ___ |    (_   _) ___ |/ ___)  _ \
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \__)_____)\____)_| |_|
+  (C)2023 Semtech
+
+Description:
+    Test and benchmark of the uplink filter (upfilter.c).
+    NetIDs must give the DevAddr range of their NwkID, DevAddr ranges must be
+    merged, and the verdicts on random frames must be the ones of a linear
+    search of the rules. The benchmark gives the time per frame checked.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+
+#include "parson.h"
+#include "upfilter.h"
+
+
+#define ROUND_NB        200
+#define FRAME_NB        1000
+#define BENCH_NB        100000
+
+static struct upfilter_s f;
+
+/* frames as received, little endian fields */
+static void make_data_up(uint8_t * frame, uint32_t devaddr)
+{
+    memset(frame, 0, 12);
+    frame[0] = 0x40; /* unconfirmed data up */
+    frame[1] = (uint8_t)devaddr;
+    frame[2] = (uint8_t)(devaddr >> 8);
+    frame[3] = (uint8_t)(devaddr >> 16);
+    frame[4] = (uint8_t)(devaddr >> 24);
+}
+
+static void make_join(uint8_t * frame, uint64_t joineui)
+{
+    int i;
+
+    memset(frame, 0, 23);
+    frame[0] = 0x00; /* join request */
+    for (i = 0; i < 8; i++) {
+        frame[1 + i] = (uint8_t)(joineui >> (8 * i));
+    }
+}
+
+static uint64_t rand64(void)
+{
+    return ((uint64_t)rand() << 40) ^ ((uint64_t)rand() << 20) ^ (uint64_t)rand();
+}
+
+static int netid(void)
+{
+    static const struct {
+        const char * netid;
+        uint32_t first;
+        uint32_t last;
+    } ref[] = {
+        {"000013", 0x26000000, 0x27FFFFFF}, /* type 0 */
+        {"200005", 0x85000000, 0x85FFFFFF}, /* type 1 */
+        {"400100", 0xC0000000 | (0x100 << 20), 0xC0000000 | (0x100 << 20) | 0xFFFFF}, /* type 2 */
+        {"600008", 0xE0100000, 0xE011FFFF}, /* type 3 */
+        {"C00053", 0xFC014C00, 0xFC014FFF}, /* type 6 */
+        {"E00001", 0xFE000080, 0xFE0000FF}  /* type 7 */
+    };
+    int i;
+    int errors = 0;
+
+    for (i = 0; i < (int)(sizeof ref / sizeof ref[0]); i++) {
+        upfilter_clear(&f);
+        if ((upfilter_add_netid(&f, ref[i].netid) != 0) || (f.range_nb != 1) ||
+            (f.range[0].first != ref[i].first) || (f.range[0].last != ref[i].last)) {
+            printf("ERROR: NetID %s gives %08X-%08X instead of %08X-%08X\n", ref[i].netid,
+                    f.range[0].first, f.range[0].last, ref[i].first, ref[i].last);
+            errors += 1;
+        }
+    }
+    if ((upfilter_add_netid(&f, "1000000") == 0) || (upfilter_add_netid(&f, "00001G") == 0) ||
+        (upfilter_add_devaddr(&f, "30-20") == 0) || (upfilter_add_joineui(&f, "") == 0)) {
+        printf("ERROR: invalid rules accepted\n");
+        errors += 1;
+    }
+    return errors;
+}
+
+static int merge(void)
+{
+    char str[32];
+    int i;
+    int errors = 0;
+
+    upfilter_clear(&f);
+    upfilter_add_devaddr(&f, "10-1F");
+    upfilter_add_devaddr(&f, "30-3F");
+    upfilter_add_devaddr(&f, "20-2F"); /* touches both */
+    upfilter_add_devaddr(&f, "5");
+    upfilter_add_devaddr(&f, "0x38-50"); /* overlaps the end */
+    if ((f.range_nb != 2) || (f.range[0].first != 0x5) || (f.range[0].last != 0x5) ||
+        (f.range[1].first != 0x10) || (f.range[1].last != 0x50)) {
+        printf("ERROR: ranges not merged, %d ranges\n", f.range_nb);
+        errors += 1;
+    }
+    upfilter_add_devaddr(&f, "00000000-FFFFFFFF");
+    if ((f.range_nb != 1) || (f.range[0].first != 0) || (f.range[0].last != 0xFFFFFFFF)) {
+        printf("ERROR: full range not merged, %d ranges\n", f.range_nb);
+        errors += 1;
+    }
+
+    /* full list: the rule is refused and the list unchanged */
+    upfilter_clear(&f);
+    for (i = 0; i < UPFILTER_RANGE_MAX; i++) {
+        snprintf(str, sizeof str, "%X-%X", 0x100 * i, 0x100 * i + 0x10);
+        upfilter_add_devaddr(&f, str);
+    }
+    if ((upfilter_add_devaddr(&f, "FFFF0000") == 0) || (f.range_nb != UPFILTER_RANGE_MAX) ||
+        (upfilter_add_devaddr(&f, "8-108") != 0) || (f.range_nb != (UPFILTER_RANGE_MAX - 1))) {
+        printf("ERROR: full list not handled, %d ranges\n", f.range_nb);
+        errors += 1;
+    }
+    return errors;
+}
+
+/* random rules in a small space, checked against a linear search */
+static int random_rules(void)
+{
+    uint32_t first[UPFILTER_RANGE_MAX], last[UPFILTER_RANGE_MAX];
+    uint64_t eui[UPFILTER_EUI_MAX];
+    uint8_t frame[23];
+    char str[40];
+    int round, i, k, nb_range, nb_eui;
+    uint32_t addr;
+    uint64_t e;
+    bool match;
+    int expect, res;
+    int errors = 0;
+
+    for (round = 0; (round < ROUND_NB) && (errors == 0); round++) {
+        upfilter_clear(&f);
+        f.devaddr_mode = (round % 2) ? UPFILTER_ALLOW : UPFILTER_DENY;
+        f.joineui_mode = (round % 3) ? UPFILTER_DENY : UPFILTER_ALLOW;
+        nb_range = rand() % 12;
+        for (i = 0; i < nb_range; i++) {
+            first[i] = 0x26000000 + (rand() % 0x1000);
+            last[i] = first[i] + (rand() % 0x100);
+            snprintf(str, sizeof str, "%08X-%08X", first[i], last[i]);
+            if (upfilter_add_devaddr(&f, str) != 0) {
+                printf("ERROR: range %s refused\n", str);
+                errors += 1;
+            }
+        }
+        nb_eui = rand() % (UPFILTER_EUI_MAX + 1);
+        for (i = 0; i < nb_eui; i++) {
+            eui[i] = rand64();
+            snprintf(str, sizeof str, "%016llX", (unsigned long long)eui[i]);
+            if (upfilter_add_joineui(&f, str) != 0) {
+                printf("ERROR: JoinEUI %s refused\n", str);
+                errors += 1;
+            }
+        }
+
+        for (k = 0; k < FRAME_NB; k++) {
+            addr = 0x26000000 + (rand() % 0x1200) - 0x100;
+            make_data_up(frame, addr);
+            for (i = 0, match = false; i < nb_range; i++) {
+                match |= (addr >= first[i]) && (addr <= last[i]);
+            }
+            expect = (match == (f.devaddr_mode == UPFILTER_ALLOW)) ? UPFILTER_PASS : UPFILTER_DROP_DEVADDR;
+            res = upfilter_check(&f, frame, 12);
+            if (res != expect) {
+                printf("ERROR: DevAddr %08X gives %d instead of %d\n", addr, res, expect);
+                errors += 1;
+            }
+
+            e = ((nb_eui > 0) && (rand() % 2)) ? eui[rand() % nb_eui] : rand64();
+            make_join(frame, e);
+            for (i = 0, match = false; i < nb_eui; i++) {
+                match |= (e == eui[i]);
+            }
+            expect = (match == (f.joineui_mode == UPFILTER_ALLOW)) ? UPFILTER_PASS : UPFILTER_DROP_JOINEUI;
+            res = upfilter_check(&f, frame, 23);
+            if (res != expect) {
+                printf("ERROR: JoinEUI %016llX gives %d instead of %d\n", (unsigned long long)e, res, expect);
+                errors += 1;
+            }
+        }
+    }
+    return errors;
+}
+
+/* frames the filter does not look at */
+static int other_frames(void)
+{
+    uint8_t frame[24] = {0};
+    int errors = 0;
+
+    upfilter_clear(&f);
+    f.devaddr_mode = UPFILTER_ALLOW;
+    f.joineui_mode = UPFILTER_ALLOW;
+    make_data_up(frame, 0x26000000);
+    errors += (upfilter_check(&f, frame, 12) != UPFILTER_DROP_DEVADDR);
+    errors += (upfilter_check(&f, frame, 11) != UPFILTER_PASS); /* too short */
+    frame[0] = 0xE0; /* proprietary */
+    errors += (upfilter_check(&f, frame, 12) != UPFILTER_PASS);
+    frame[0] = 0xC0; /* rejoin type 1 */
+    frame[1] = 1;
+    errors += (upfilter_check(&f, frame, 24) != UPFILTER_DROP_JOINEUI);
+    frame[1] = 0; /* rejoin type 0, no JoinEUI */
+    errors += (upfilter_check(&f, frame, 19) != UPFILTER_PASS);
+    errors += (upfilter_check(&f, frame, 0) != UPFILTER_PASS);
+    if (errors != 0) {
+        printf("ERROR: %d verdicts wrong on frames not filtered\n", errors);
+    }
+    return errors;
+}
+
+static int parse(void)
+{
+    const char * conf = "{\"devaddr_mode\": \"allow\", \"netid\": [\"000013\"], \"devaddr\": [\"FC00AC00-FC00AFFF\"],"
+                        " \"joineui_mode\": \"deny\", \"joineui\": [\"70B3D57ED0000000\"]}";
+    const char * bad = "{\"devaddr_mode\": \"allow\", \"devaddr\": [\"26000000\", \"2600000G\"]}";
+    JSON_Value * root;
+    const char * err = NULL;
+    int errors = 0;
+
+    root = json_parse_string(conf);
+    if ((upfilter_parse(&f, json_value_get_object(root), &err) != 0) || (f.devaddr_mode != UPFILTER_ALLOW) ||
+        (f.range_nb != 2) || (f.joineui_mode != UPFILTER_DENY) || (f.eui_nb != 1) || (f.eui[0] != 0x70B3D57ED0000000ULL)) {
+        printf("ERROR: configuration not parsed\n");
+        errors += 1;
+    }
+    json_value_free(root);
+
+    root = json_parse_string(bad);
+    if ((upfilter_parse(&f, json_value_get_object(root), &err) == 0) || (strcmp(err, "2600000G") != 0)) {
+        printf("ERROR: wrong configuration not reported\n");
+        errors += 1;
+    }
+    json_value_free(root);
+    return errors;
+}
+
+static void bench(void)
+{
+    static uint8_t frames[FRAME_NB][23];
+    char str[40];
+    int64_t t0;
+    int i, nb_pass = 0;
+
+    upfilter_clear(&f);
+    f.devaddr_mode = UPFILTER_ALLOW;
+    f.joineui_mode = UPFILTER_DENY;
+    for (i = 0; i < UPFILTER_RANGE_MAX; i++) {
+        snprintf(str, sizeof str, "%08X-%08X", 0x26000000 + 0x10000 * i, 0x26000000 + 0x10000 * i + 0x7FFF);
+        upfilter_add_devaddr(&f, str);
+    }
+    for (i = 0; i < UPFILTER_EUI_MAX; i++) {
+        snprintf(str, sizeof str, "%016llX", (unsigned long long)rand64());
+        upfilter_add_joineui(&f, str);
+    }
+    for (i = 0; i < FRAME_NB; i++) {
+        if (i % 4) {
+            make_data_up(frames[i], 0x26000000 + (rand() % 0x200000));
+        } else {
+            make_join(frames[i], rand64());
+        }
+    }
+
+    t0 = esp_timer_get_time();
+    for (i = 0; i < BENCH_NB; i++) {
+        nb_pass += (upfilter_check(&f, frames[i % FRAME_NB], (i % 4) ? 12 : 23) == UPFILTER_PASS);
+    }
+    printf("%d ranges, %d JoinEUIs: %.3f us/frame, %d%% passed\n", f.range_nb, f.eui_nb,
+            (double)(esp_timer_get_time() - t0) / BENCH_NB, 100 * nb_pass / BENCH_NB);
+}
+
+void app_main(void)
+{
+    int errors;
+
+    printf("Beginning of uplink filter test\n");
+    srand(1302);
+
+    errors = netid();
+    errors += merge();
+    errors += random_rules();
+    errors += other_frames();
+    errors += parse();
+    bench();
+
+    printf("End of uplink filter test: %s\n", (errors == 0) ? "SUCCESS" : "FAILURE");
+
+    while (true) {
+        vTaskDelay(8000 / portTICK_PERIOD_MS);
+    }
+}
@@ -0,0 +1,172 @@
+#!/usr/bin/python3
+
+# Generate loragw_reg_inline.h from the loregs[] table of loragw_reg.c
+#
+# Each register gets a descriptor macro (address, offset, length, sign,
+# read-only) so that LGW_REG_W()/LGW_REG_R() resolve everything at compile
+# time. Run again whenever loragw_reg.c changes:
+#
+#   python3 scripts/gen_reg_inline.py main/libloragw/loragw_reg.c main/libloragw/loragw_reg_inline.h
+#
+# License: Revised BSD License, see LICENSE.TXT file including in the project
+#
+
+import re
+import sys
+
+
+HEADER = """/*
+ / _____)             _              | |
+( (____  _____ ____ _| |_ _____  ____| |__
+ \\____ \\| ___ |    (_   _) ___ |/ ___)  _ \\
+ _____) ) ____| | | || |_| ____( (___| | | |
+(______/|_____)_|_|_| \\__)_____)\\____)_| |_|
+  (C)2019 Semtech
+
+Description:
+    Compile-time register accessors, generated from loragw_reg.c by
+    scripts/gen_reg_inline.py. DO NOT EDIT.
+
+    LGW_REG_W(reg, value) / LGW_REG_R(reg, &value) take a register name
+    without its SX1302_REG_ prefix. Address, mask and sign are constants,
+    so the choice between a direct write and a masked write is made by the
+    compiler. LGW_REG_W2/3/4() write fields sharing one byte at once.
+
+License: Revised BSD License, see LICENSE.TXT file include in the project
+*/
+
+
+#ifndef _LORAGW_REG_INLINE_H
+#define _LORAGW_REG_INLINE_H
+
+/* -------------------------------------------------------------------------- */
+/* --- DEPENDANCIES --------------------------------------------------------- */
+
+#include <stdint.h>     /* C99 types */
+#include <stdbool.h>    /* bool type */
+
+#include "loragw_reg.h"
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC MACROS -------------------------------------------------------- */
+
+/* descriptor fields: address, offset, length, sign, read-only */
+#define LGW_REGI_ADDR(reg)          LGW_REGI_ADDR_(LGW_REGI_##reg)
+#define LGW_REGI_OFFS(reg)          LGW_REGI_OFFS_(LGW_REGI_##reg)
+#define LGW_REGI_LENG(reg)          LGW_REGI_LENG_(LGW_REGI_##reg)
+#define LGW_REGI_RDON(reg)          LGW_REGI_RDON_(LGW_REGI_##reg)
+#define LGW_REGI_MASK(reg)          ((uint8_t)(((1 << LGW_REGI_LENG(reg)) - 1) << LGW_REGI_OFFS(reg)))
+#define LGW_REGI_FIELD(reg, val)    ((uint8_t)(((uint8_t)(val) << LGW_REGI_OFFS(reg)) & LGW_REGI_MASK(reg)))
+
+#define LGW_REGI_ADDR_(...)         LGW_REGI_ADDR__(__VA_ARGS__)
+#define LGW_REGI_OFFS_(...)         LGW_REGI_OFFS__(__VA_ARGS__)
+#define LGW_REGI_LENG_(...)         LGW_REGI_LENG__(__VA_ARGS__)
+#define LGW_REGI_RDON_(...)         LGW_REGI_RDON__(__VA_ARGS__)
+#define LGW_REGI_ADDR__(a, o, l, s, r)  (a)
+#define LGW_REGI_OFFS__(a, o, l, s, r)  (o)
+#define LGW_REGI_LENG__(a, o, l, s, r)  (l)
+#define LGW_REGI_RDON__(a, o, l, s, r)  (r)
+
+/* compilation fails on a write to a read-only register, or on grouped fields not sharing a byte */
+#define LGW_REGI_WRITABLE(reg)      ((void)sizeof(char[LGW_REGI_RDON(reg) ? -1 : 1]))
+#define LGW_REGI_SAME_BYTE(r1, r2)  ((void)sizeof(char[(LGW_REGI_ADDR(r1) == LGW_REGI_ADDR(r2)) ? 1 : -1]))
+
+/* write/read a register */
+#define LGW_REG_W(reg, val) \\
+    (LGW_REGI_WRITABLE(reg), lgw_reg_wi(LGW_REGI_ADDR(reg), LGW_REGI_MASK(reg), LGW_REGI_FIELD(reg, val)))
+#define LGW_REG_R(reg, val) \\
+    lgw_reg_ri(LGW_REGI_##reg, val)
+
+/* write 2 to 4 fields sharing the same byte, as a single register access */
+#define LGW_REG_W2(r1, v1, r2, v2) \\
+    (LGW_REGI_WRITABLE(r1), LGW_REGI_WRITABLE(r2), LGW_REGI_SAME_BYTE(r1, r2), \\
+     lgw_reg_wi(LGW_REGI_ADDR(r1), LGW_REGI_MASK(r1) | LGW_REGI_MASK(r2), \\
+                LGW_REGI_FIELD(r1, v1) | LGW_REGI_FIELD(r2, v2)))
+#define LGW_REG_W3(r1, v1, r2, v2, r3, v3) \\
+    (LGW_REGI_WRITABLE(r1), LGW_REGI_WRITABLE(r2), LGW_REGI_WRITABLE(r3), \\
+     LGW_REGI_SAME_BYTE(r1, r2), LGW_REGI_SAME_BYTE(r1, r3), \\
+     lgw_reg_wi(LGW_REGI_ADDR(r1), LGW_REGI_MASK(r1) | LGW_REGI_MASK(r2) | LGW_REGI_MASK(r3), \\
+                LGW_REGI_FIELD(r1, v1) | LGW_REGI_FIELD(r2, v2) | LGW_REGI_FIELD(r3, v3)))
+#define LGW_REG_W4(r1, v1, r2, v2, r3, v3, r4, v4) \\
+    (LGW_REGI_WRITABLE(r1), LGW_REGI_WRITABLE(r2), LGW_REGI_WRITABLE(r3), LGW_REGI_WRITABLE(r4), \\
+     LGW_REGI_SAME_BYTE(r1, r2), LGW_REGI_SAME_BYTE(r1, r3), LGW_REGI_SAME_BYTE(r1, r4), \\
+     lgw_reg_wi(LGW_REGI_ADDR(r1), LGW_REGI_MASK(r1) | LGW_REGI_MASK(r2) | LGW_REGI_MASK(r3) | LGW_REGI_MASK(r4), \\
+                LGW_REGI_FIELD(r1, v1) | LGW_REGI_FIELD(r2, v2) | LGW_REGI_FIELD(r3, v3) | LGW_REGI_FIELD(r4, v4)))
+
+/* -------------------------------------------------------------------------- */
+/* --- PUBLIC FUNCTIONS ----------------------------------------------------- */
+
+static inline int lgw_reg_wi(uint16_t addr, uint8_t mask, uint8_t bits) {
+    if (mask == 0xFF) {
+        return lgw_reg_w_byte(addr, bits);
+    } else {
+        return lgw_reg_w_bits(addr, mask, bits);
+    }
+}
+
+static inline int lgw_reg_ri(uint16_t addr, uint8_t offs, uint8_t leng, bool sign, bool rdon, int32_t *reg_value) {
+    int err;
+    uint8_t u = 0;
+
+    (void)rdon;
+    err = lgw_reg_r_byte(addr, &u);
+    if (sign == true) {
+        *reg_value = (int32_t)((int8_t)(u << (8 - leng - offs)) >> (8 - leng));
+    } else {
+        *reg_value = (int32_t)((u >> offs) & ((1 << leng) - 1));
+    }
+    return err;
+}
+
+/* -------------------------------------------------------------------------- */
+/* --- REGISTER DESCRIPTORS ------------------------------------------------- */
+
+"""
+
+FOOTER = """
+#endif
+
+/* --- EOF ------------------------------------------------------------------ */
+"""
+
+
+def parse(file_from: str) -> list:
+    """
+    Returns the list of (name, address, offset, length, sign, read-only)
+    described by the loregs[] table.
+    """
+    base = {}
+    regs = []
+    re_base = re.compile(r'#define (SX1302_REG_\w+_BASE_ADDR) (0x[0-9a-fA-F]+)')
+    re_reg = re.compile(r'\s*\{(-?\d+),(\w+)\+(\d+),(\d+),(\d+),(\d+),(\d+),(\d+),(-?\d+)\}, // (\w+)')
+
+    with open(file_from) as f:
+        for line in f:
+            m = re_base.match(line)
+            if m:
+                base[m.group(1)] = int(m.group(2), 16)
+                continue
+            m = re_reg.match(line)
+            if m:
+                regs.append((m.group(10), base[m.group(2)] + int(m.group(3)),
+                             int(m.group(4)), int(m.group(6)), int(m.group(5)), int(m.group(7))))
+    return regs
+
+
+def generate(file_from: str, file_to: str):
+    regs = parse(file_from)
+    result = HEADER
+    for (name, addr, offs, leng, sign, rdon) in regs:
+        result += f"#define LGW_REGI_{name} 0x{addr:04X}, {offs}, {leng}, {sign}, {rdon}\n"
+    result += FOOTER
+
+    with open(file_to, "w") as f:
+        f.write(result)
+    print(f"{len(regs)} registers written to {file_to}")
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 3:
+        print("Usage: gen_reg_inline.py loragw_reg.c loragw_reg_inline.h")
+        sys.exit(1)
+    generate(sys.argv[1], sys.argv[2])
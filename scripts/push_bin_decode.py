@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+#
+# Reference decoder of the binary PUSH_DATA (protocol version 3), see
+# main/packet_forwarder/PROTOCOL_BINARY.md.
+#
+# Usage: push_bin_decode.py [port]
+#   Listens for PUSH_DATA datagrams (default port 1680), acknowledges them with
+#   the protocol version they use, and prints their content as the equivalent
+#   JSON object of PROTOCOL.md.
+#
+# License: Revised BSD License, see LICENSE.TXT file including in the project
+#
+
+import base64
+import datetime
+import json
+import socket
+import struct
+import sys
+
+PROTOCOL_VERSION = 2
+PROTOCOL_VERSION_BINARY = 3
+PKT_PUSH_DATA = 0
+PKT_PUSH_ACK = 1
+
+RXPK_TIME = 0x01
+RXPK_TMMS = 0x02
+RXPK_FTIME = 0x04
+RXPK_FSK = 0x08
+STAT_COORD = 0x01
+
+RXPK_FIXED = struct.Struct('<BBBBbBBBIIihhhB')
+STAT_FIXED = struct.Struct('<BIIIIHIIh')
+STAT_COORD_FIELDS = struct.Struct('<iii')
+
+BANDWIDTHS = {1: 'BW125', 2: 'BW250', 3: 'BW500'}
+CODERATES = {0: 'OFF', 1: '4/5', 2: '4/6', 3: '4/7', 4: '4/8'}
+
+
+def decode_rxpk(buf, pos):
+    """Decode the rxpk record at pos, return it as a dict and the position of the next one."""
+    (flags, chan, rfch, mid, stat, sf, bw, cr, tmst, freq, foff, rssi, rssis,
+     lsnr, size) = RXPK_FIXED.unpack_from(buf, pos)
+    pos += RXPK_FIXED.size
+    pkt = {'jver': 1, 'tmst': tmst}
+    if flags & RXPK_TIME:
+        (us,) = struct.unpack_from('<Q', buf, pos)
+        pos += 8
+        t = datetime.datetime(1970, 1, 1) + datetime.timedelta(microseconds=us)
+        pkt['time'] = t.strftime('%Y-%m-%dT%H:%M:%S.%fZ')
+    if flags & RXPK_TMMS:
+        (pkt['tmms'],) = struct.unpack_from('<Q', buf, pos)
+        pos += 8
+    if flags & RXPK_FTIME:
+        (pkt['ftime'],) = struct.unpack_from('<I', buf, pos)
+        pos += 4
+    pkt['chan'] = chan
+    pkt['rfch'] = rfch
+    pkt['freq'] = round(freq / 1e6, 6)
+    pkt['mid'] = mid
+    pkt['stat'] = stat
+    if flags & RXPK_FSK:
+        pkt['modu'] = 'FSK'
+        pkt['datr'] = foff & 0xFFFFFFFF
+    else:
+        pkt['modu'] = 'LORA'
+        pkt['datr'] = 'SF%d%s' % (sf, BANDWIDTHS[bw])
+        pkt['codr'] = CODERATES[cr]
+        pkt['rssis'] = rssis
+        pkt['lsnr'] = lsnr / 10.0
+        pkt['foff'] = foff
+    pkt['rssi'] = rssi
+    pkt['size'] = size
+    payload = buf[pos:pos + size]
+    if len(payload) != size:
+        raise ValueError('truncated rxpk record')
+    pkt['data'] = base64.b64encode(payload).decode('ascii')
+    return pkt, pos + size
+
+
+def decode_stat(buf, pos):
+    """Decode the stat record at pos, return it as a dict and the position after it."""
+    (flags, t, rxnb, rxok, rxfw, ackr, dwnb, txnb, temp) = STAT_FIXED.unpack_from(buf, pos)
+    pos += STAT_FIXED.size
+    t = datetime.datetime(1970, 1, 1) + datetime.timedelta(seconds=t)
+    stat = {'time': t.strftime('%Y-%m-%d %H:%M:%S UTC')}
+    if flags & STAT_COORD:
+        (lati, longi, alti) = STAT_COORD_FIELDS.unpack_from(buf, pos)
+        pos += STAT_COORD_FIELDS.size
+        stat['lati'] = lati / 1e5
+        stat['long'] = longi / 1e5
+        stat['alti'] = alti
+    stat.update({'rxnb': rxnb, 'rxok': rxok, 'rxfw': rxfw, 'ackr': ackr / 10.0,
+                 'dwnb': dwnb, 'txnb': txnb, 'temp': temp / 10.0})
+    return stat, pos
+
+
+def decode_push_data(dgram):
+    """Decode a PUSH_DATA datagram, either version, return (token, MAC, JSON-like dict)."""
+    if len(dgram) < 12 or dgram[3] != PKT_PUSH_DATA:
+        raise ValueError('not a PUSH_DATA datagram')
+    token = dgram[1:3]
+    mac = dgram[4:12].hex().upper()
+    if dgram[0] == PROTOCOL_VERSION:
+        return token, mac, json.loads(dgram[12:].decode('utf-8'))
+    if dgram[0] != PROTOCOL_VERSION_BINARY:
+        raise ValueError('unknown protocol version %d' % dgram[0])
+    if len(dgram) < 14:
+        raise ValueError('truncated binary PUSH_DATA')
+    nb_rxpk, has_stat = dgram[12], dgram[13]
+    pos = 14
+    obj = {}
+    if nb_rxpk > 0:
+        obj['rxpk'] = []
+        for _ in range(nb_rxpk):
+            pkt, pos = decode_rxpk(dgram, pos)
+            obj['rxpk'].append(pkt)
+    if has_stat:
+        obj['stat'], pos = decode_stat(dgram, pos)
+    if pos != len(dgram):
+        raise ValueError('%d trailing bytes' % (len(dgram) - pos))
+    return token, mac, obj
+
+
+def main():
+    port = int(sys.argv[1]) if len(sys.argv) > 1 else 1680
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind(('0.0.0.0', port))
+    print('Listening on 0.0.0.0:%d' % port)
+
+    while True:
+        dgram, addr = sock.recvfrom(65535)
+        try:
+            token, mac, obj = decode_push_data(dgram)
+        except (ValueError, struct.error) as e:
+            print('Ignored datagram from %s: %s' % (str(addr), e))
+            continue
+        sock.sendto(bytes([dgram[0]]) + token + bytes([PKT_PUSH_ACK]), addr)
+        print('PUSH_DATA v%d from %s (%d bytes):' % (dgram[0], mac, len(dgram)))
+        print(json.dumps(obj, indent=1))
+
+
+if __name__ == '__main__':
+    main()